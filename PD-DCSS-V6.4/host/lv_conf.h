@@ -0,0 +1,55 @@
+/**
+ * @file lv_conf.h
+ * @brief 主机构建使用的LVGL 8.3配置
+ * @details
+ * 只列出与固件相关、或与LVGL默认值不同的选项，其余使用 lv_conf_internal.h 的默认值。
+ * 颜色格式、绘制缓冲和快照功能与固件保持一致，保证渲染结果可以和基准图逐像素比较。
+ */
+
+#if 1 /*Set it to "1" to enable content*/
+
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#include <stdint.h>
+
+/* 颜色：RGB565，不交换字节（字节序由 my_disp_flush 的 pushColors 处理） */
+#define LV_COLOR_DEPTH 16
+#define LV_COLOR_16_SWAP 0
+#define LV_COLOR_SCREEN_TRANSP 0
+#define LV_COLOR_CHROMA_KEY lv_color_hex(0x00ff00)
+
+/* 内存：LVGL内置分配器 */
+#define LV_MEM_CUSTOM 0
+#define LV_MEM_SIZE (128U * 1024U)
+
+/* 刷新周期与时间源：使用虚拟时钟，渲染结果与主机速度无关 */
+#define LV_DISP_DEF_REFR_PERIOD 30
+#define LV_INDEV_DEF_READ_PERIOD 30
+#define LV_TICK_CUSTOM 1
+#define LV_TICK_CUSTOM_INCLUDE "host_time.h"
+#define LV_TICK_CUSTOM_SYS_TIME_EXPR (host_millis())
+
+#define LV_DPI_DEF 130
+
+/* 绘制 */
+#define LV_DRAW_COMPLEX 1
+#define LV_USE_GPU_SDL 0
+
+/* 日志和监视器关闭，避免输出影响计时 */
+#define LV_USE_LOG 0
+#define LV_USE_PERF_MONITOR 0
+#define LV_USE_MEM_MONITOR 0
+#define LV_USE_ASSERT_NULL 1
+#define LV_USE_ASSERT_MALLOC 1
+
+/* 字体：生成代码使用自带字体，这里只保留默认字体 */
+#define LV_FONT_MONTSERRAT_14 1
+#define LV_FONT_DEFAULT &lv_font_montserrat_14
+
+/* 其他功能 */
+#define LV_USE_SNAPSHOT 1  // myBackdrop 需要
+
+#endif /*LV_CONF_H*/
+
+#endif /*End of "Content enable"*/
@@ -0,0 +1,191 @@
+/**
+ * @file backlight_check.cpp
+ * @brief 屏幕背光（lib/myBacklight）的检查：空闲变暗、输出关闭时熄屏、暂停渲染和点亮
+ * @details
+ * 按UI任务的方式每33ms运行一帧：先处理输入（activity()），允许渲染时“渲染”
+ * （推进虚拟时钟4ms并 recordRender()，相当于 handle_lvgl_tasks），否则 recordSkippedRender()，
+ * 最后 update()。依次检查：
+ * - 输出打开时空闲30秒变暗，之后一直不熄屏；变暗时有操作在下一帧恢复亮度；
+ * - 输出关闭时空闲120秒熄屏：熄屏期间没有任何渲染，PWM占空比为0且不再写入；
+ * - 熄屏时有操作：同一帧恢复渲染，渲染之后才打开背光，从操作到点亮不超过一帧；
+ * - 熄屏中输出被打开时自行点亮；
+ * - 超时为0时不变暗、不熄屏；亮度按平方关系换算占空比，变暗亮度不超过亮度；
+ * - 各状态累计时间之和等于经过的时间，占空比积分与逐帧计算一致。
+ *
+ * 返回值见 check_util.h。
+ */
+
+#include <stdio.h>
+#include <math.h>
+
+#include "myBacklight.h"
+#include "myHAL.h"
+#include "host_stubs.h"
+#include "check_util.h"
+
+#define CHECK_PIN 4
+#define CHECK_FRAME_US 33000
+#define CHECK_RENDER_US 4000
+
+// 逐帧记录，用来和库的统计比较
+static uint32_t s_renders = 0;
+static uint32_t s_litRenders = 0;        // 渲染时背光已经打开的帧
+static uint64_t s_dutyUs = 0;            // 逐帧的占空比 x 微秒
+
+// 运行一帧；input 为true时这一帧开始时有操作，返回 activity() 的结果
+static bool frame(bool outputEnabled, bool input) {
+    uint64_t t0 = host_micros();
+    uint32_t duty = host_pwm_duty(BACKLIGHT_PWM_CHANNEL);
+    bool woke = input && backlight.activity();
+    if (backlight.renderAllowed()) {
+        s_renders++;
+        if (host_pwm_duty(BACKLIGHT_PWM_CHANNEL) != 0) {
+            s_litRenders++;
+        }
+        host_advance_us(CHECK_RENDER_US);
+        backlight.recordRender(CHECK_RENDER_US);
+    } else {
+        backlight.recordSkippedRender();
+    }
+    // 占空比在 update() 中改变，之前这一段按原来的占空比计
+    s_dutyUs += (uint64_t)duty * (host_micros() - t0);
+    uint64_t t1 = host_micros();
+    backlight.update(outputEnabled);
+    host_advance_us(CHECK_FRAME_US - (t1 - t0));
+    s_dutyUs += (uint64_t)host_pwm_duty(BACKLIGHT_PWM_CHANNEL) * (host_micros() - t1);
+    return woke;
+}
+
+// 运行若干毫秒（整帧）
+static void run(uint32_t ms, bool outputEnabled) {
+    uint64_t end = host_micros() + (uint64_t)ms * 1000;
+    while (host_micros() < end) {
+        frame(outputEnabled, false);
+    }
+}
+
+static void checkDuty() {
+    printf("亮度换算\n");
+    check(MyBacklight::dutyFor(100) == BACKLIGHT_DUTY_MAX && MyBacklight::dutyFor(0) == 0, "0%和100%对应占空比0和满");
+    check(MyBacklight::dutyFor(50) == (BACKLIGHT_DUTY_MAX + 2) / 4, "50%对应四分之一占空比（平方关系）");
+    check(host_pwm_duty(BACKLIGHT_PWM_CHANNEL) == BACKLIGHT_DUTY_MAX && backlight.state() == BACKLIGHT_ON,
+          "启动后以100%亮度点亮");
+}
+
+static void checkDimWhileOn() {
+    printf("输出打开\n");
+    uint64_t t0 = host_micros();
+    run(BACKLIGHT_DIM_MS - 100, true);
+    check(backlight.state() == BACKLIGHT_ON, "空闲不到30秒保持亮");
+    run(200, true);
+    check(backlight.state() == BACKLIGHT_DIM &&
+          host_pwm_duty(BACKLIGHT_PWM_CHANNEL) == MyBacklight::dutyFor(BACKLIGHT_DEFAULT_DIM),
+          "空闲30秒后变暗");
+    uint32_t writes = host_pwm_write_count(BACKLIGHT_PWM_CHANNEL);
+    uint32_t renders = s_renders;
+    run(600000, true);
+    check(backlight.state() == BACKLIGHT_DIM, "输出打开时空闲10分钟也不熄屏");
+    check(host_pwm_write_count(BACKLIGHT_PWM_CHANNEL) == writes, "状态不变时不写占空比");
+    check(s_renders - renders > 18000, "变暗时照常渲染");
+    bool woke = frame(true, true);
+    check(!woke && backlight.state() == BACKLIGHT_ON && host_pwm_duty(BACKLIGHT_PWM_CHANNEL) == BACKLIGHT_DUTY_MAX,
+          "变暗时有操作，这一帧恢复亮度（操作照常执行）");
+    printf("    用时 %.0fs\n", (host_micros() - t0) / 1e6);
+}
+
+static void checkBlankWhileOff() {
+    printf("输出关闭\n");
+    frame(false, true);
+    run(BACKLIGHT_BLANK_MS - 100, false);
+    check(backlight.state() == BACKLIGHT_DIM, "空闲不到120秒只变暗");
+    run(200, false);
+    check(backlight.state() == BACKLIGHT_BLANK && !backlight.renderAllowed() &&
+          host_pwm_duty(BACKLIGHT_PWM_CHANNEL) == 0, "空闲120秒后熄屏");
+
+    BacklightStats before;
+    backlight.stats(before);
+    uint32_t renders = s_renders;
+    uint32_t writes = host_pwm_write_count(BACKLIGHT_PWM_CHANNEL);
+    run(3600000, false);
+    BacklightStats after;
+    backlight.stats(after);
+    printf("    熄屏1小时：跳过 %lu 次渲染\n", (unsigned long)(after.skippedRenders - before.skippedRenders));
+    check(s_renders == renders && after.renders == before.renders, "熄屏期间没有任何渲染");
+    check(after.skippedRenders - before.skippedRenders >= 3600000 / 33, "每一帧都跳过");
+    check(host_pwm_write_count(BACKLIGHT_PWM_CHANNEL) == writes, "熄屏期间不写占空比");
+}
+
+static void checkWake() {
+    printf("点亮\n");
+    uint32_t renders = s_renders;
+    uint32_t lit = s_litRenders;
+    bool woke = frame(false, true);
+    check(woke, "熄屏时的操作只用于点亮（activity() 返回true）");
+    check(s_renders == renders + 1 && s_litRenders == lit, "同一帧恢复渲染，渲染时背光还没打开");
+    check(backlight.state() == BACKLIGHT_ON && host_pwm_duty(BACKLIGHT_PWM_CHANNEL) == BACKLIGHT_DUTY_MAX,
+          "渲染之后打开背光");
+    BacklightStats st;
+    backlight.stats(st);
+    printf("    从操作到点亮 %.1fms\n", st.lastWakeUs / 1000.0f);
+    check(st.wakes == 1 && st.lastWakeUs <= CHECK_FRAME_US, "从操作到点亮不超过一帧");
+
+    // 熄屏中输出被打开（例如按了状态按钮但没有经过UI任务）
+    run(BACKLIGHT_BLANK_MS + 100, false);
+    check(backlight.state() == BACKLIGHT_BLANK, "再次熄屏");
+    frame(true, false);
+    frame(true, false);
+    check(backlight.state() == BACKLIGHT_ON && host_pwm_duty(BACKLIGHT_PWM_CHANNEL) == BACKLIGHT_DUTY_MAX,
+          "熄屏中输出被打开，两帧内自行点亮");
+}
+
+static void checkSettings() {
+    printf("设置\n");
+    backlight.setTimeouts(0, 0);
+    run(600000, false);
+    check(backlight.state() == BACKLIGHT_ON, "超时为0时不变暗、不熄屏");
+
+    backlight.setBrightness(50);
+    frame(false, false);
+    check(host_pwm_duty(BACKLIGHT_PWM_CHANNEL) == MyBacklight::dutyFor(50), "改变亮度下一帧生效");
+    backlight.setDimLevel(80);
+    backlight.setTimeouts(1000, 0);
+    run(1100, false);
+    check(backlight.state() == BACKLIGHT_DIM && host_pwm_duty(BACKLIGHT_PWM_CHANNEL) == MyBacklight::dutyFor(50),
+          "变暗亮度不超过亮度");
+    backlight.setBrightness(0);
+    check(backlight.brightness() == 1, "亮度至少1%");
+}
+
+static void checkAccounting(uint64_t startUs) {
+    printf("统计\n");
+    BacklightStats st;
+    backlight.stats(st);
+    uint64_t totalMs = 0;
+    for (int i = 0; i < BACKLIGHT_STATE_COUNT; i++) {
+        totalMs += st.stateMs[i];
+    }
+    // 库在 update() 中累计，最后一帧 update() 之后的一段还没有记入
+    uint64_t elapsedMs = (host_micros() - startUs) / 1000;
+    check(elapsedMs - totalMs <= CHECK_FRAME_US / 1000 + 1, "各状态累计时间之和等于经过的时间");
+    double lib = (double)st.dutyMs;
+    double ref = s_dutyUs / 1000.0;
+    printf("    占空比积分 %.0f，逐帧计算 %.0f\n", lib, ref);
+    check(fabs(lib - ref) <= ref * 0.001 + (double)BACKLIGHT_DUTY_MAX * CHECK_FRAME_US / 1000, "占空比积分与逐帧计算一致");
+    backlight.printReport();
+}
+
+int main() {
+    if (!backlight.begin(CHECK_PIN)) {
+        printf("失败\n");
+        return CHECK_EXIT_FAIL;
+    }
+    uint64_t startUs = host_micros();
+    checkDuty();
+    checkDimWhileOn();
+    checkBlankWhileOff();
+    checkWake();
+    checkSettings();
+    checkAccounting(startUs);
+
+    return checkResult();
+}
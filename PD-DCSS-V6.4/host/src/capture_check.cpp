@@ -0,0 +1,195 @@
+/**
+ * @file capture_check.cpp
+ * @brief 波形捕获（lib/myCapture）与降压变换器模型闭环的检查
+ * @details
+ * 模型的DAC直接给定4V，电阻负载。捕获任务由协作式调度器运行，HAL的连续采样按虚拟时钟
+ * 逐个样本推进模型。依次检查：
+ * - I_OUT上升沿触发负载阶跃（4Ω -> 2Ω）：触发时刻紧跟阶跃，触发点之前的电流都低于电平，
+ *   U_OUT出现跌落；抽取的每列最小、最大值与逐帧计算一致；二进制导出的头部、样本和CRC正确；
+ * - 单通道、预触发为0的下降沿触发；
+ * - 电平达不到时按 autoMs 强制触发；
+ * - 无效配置被拒绝，取消后可以重新开始。
+ *
+ * 返回值见 check_util.h。
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "myCapture.h"
+#include "myTaskTable.h"
+#include "host_plant.h"
+#include "host_stubs.h"
+#include "check_util.h"
+
+static const TaskSpec TASKS[] = {
+    {"Capture", NULL, 3072, TASK_CLASS_CONTROL, TASK_CORE_CONTROL, TASK_STACK_INTERNAL, NULL},
+};
+
+static size_t collect(const uint8_t *data, size_t len, void *ctx) {
+    std::vector<uint8_t> *out = static_cast<std::vector<uint8_t> *>(ctx);
+    out->insert(out->end(), data, data + len);
+    return len;
+}
+
+static uint32_t getU32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void checkStep(HostPlant &plant) {
+    printf("负载阶跃，I_OUT上升沿触发\n");
+    CaptureConfig cfg = captureDefaultConfig();
+    cfg.level = 1.5f;
+    cfg.hysteresis = 0.05f;
+    // 阶跃在预触发缓冲区（1024帧，25.6ms）写满之后
+    uint64_t stepUs = host_micros() + 40000;
+    plant.scheduleLoad(stepUs, PLANT_LOAD_RESISTIVE, 2.0f);
+    float voutBefore = plant.state().vout;
+    check(capture.arm(cfg), "arm");
+    host_run_tasks(300);
+
+    CaptureInfo ci;
+    check(capture.info(ci), "捕获完成");
+    if (!capture.info(ci)) {
+        return;
+    }
+    int64_t delayUs = ci.triggerUs - (int64_t)stepUs;
+    printf("    触发延迟 %lldus  U_OUT %.3fV\n", (long long)delayUs, voutBefore);
+    check(ci.triggered && ci.triggerFrame == cfg.preTrigger && ci.frames == cfg.depth, "由触发条件触发，触发点在预触发深度处");
+    check(delayUs >= 0 && delayUs <= 2 * 1000000 / (int64_t)cfg.sampleHz, "触发时刻紧跟负载阶跃（两个采样周期内）");
+
+    bool before = true;
+    for (uint32_t f = 0; f < ci.triggerFrame; f++) {
+        before = before && capture.sample(f, CAPTURE_I_OUT) < cfg.level;
+    }
+    check(before && capture.sample(ci.triggerFrame, CAPTURE_I_OUT) >= cfg.level, "触发点之前低于电平，触发点达到电平");
+
+    float vmin = 10.0f;
+    for (uint32_t f = ci.triggerFrame; f < ci.frames; f++) {
+        float v = capture.sample(f, CAPTURE_U_OUT);
+        vmin = v < vmin ? v : vmin;
+    }
+    printf("    阶跃后U_OUT最低 %.3fV  末尾I_OUT %.3fA\n", vmin, capture.sample(ci.frames - 1, CAPTURE_I_OUT));
+    check(vmin < capture.sample(0, CAPTURE_U_OUT), "U_OUT出现跌落");
+
+    // 抽取：240列，每列与逐帧计算比较
+    const uint16_t columns = 240;
+    float mins[columns];
+    float maxs[columns];
+    bool same = capture.decimate(CAPTURE_U_OUT, 0, ci.frames, columns, mins, maxs);
+    for (uint16_t c = 0; c < columns && same; c++) {
+        uint32_t b = (uint32_t)((uint64_t)c * ci.frames / columns);
+        uint32_t e = (uint32_t)((uint64_t)(c + 1) * ci.frames / columns);
+        float lo = 1e9f;
+        float hi = -1e9f;
+        for (uint32_t f = b; f < e; f++) {
+            float v = capture.sample(f, CAPTURE_U_OUT);
+            lo = v < lo ? v : lo;
+            hi = v > hi ? v : hi;
+        }
+        same = mins[c] == lo && maxs[c] == hi;
+    }
+    check(same, "抽取的每列最小、最大值与逐帧计算一致");
+
+    // 导出
+    std::vector<uint8_t> out;
+    size_t n = capture.exportBinary(collect, &out);
+    size_t headerLen = 20 + 4 * ci.channels;
+    bool ok = n == out.size() && out.size() == headerLen + 2u * ci.channels * ci.frames + 2 &&
+              memcmp(out.data(), "PDCP", 4) == 0 && out[4] == CAPTURE_FORMAT_VERSION && out[5] == ci.channels &&
+              out[6] == ci.channelMask && out[7] == 1 && getU32(&out[8]) == ci.sampleHz &&
+              getU32(&out[12]) == ci.frames && getU32(&out[16]) == ci.triggerFrame;
+    if (ok) {
+        uint16_t crc = MyCapture::crc16(0xffff, out.data(), out.size() - 2);
+        ok = (out[out.size() - 2] | (out[out.size() - 1] << 8)) == crc;
+        const uint8_t *samples = &out[headerLen];
+        for (uint32_t f = 0; f < ci.frames && ok; f += 97) {
+            ok = (samples[f * 4] | (samples[f * 4 + 1] << 8)) == capture.sampleMv(f, CAPTURE_U_OUT) &&
+                 (samples[f * 4 + 2] | (samples[f * 4 + 3] << 8)) == capture.sampleMv(f, CAPTURE_I_OUT);
+        }
+    }
+    printf("    导出 %zu字节\n", out.size());
+    check(ok, "二进制导出的头部、样本和CRC正确");
+}
+
+static void checkFalling(HostPlant &plant) {
+    printf("单通道，预触发为0，I_OUT下降沿触发\n");
+    CaptureConfig cfg = captureDefaultConfig();
+    cfg.channelMask = CAPTURE_MASK(CAPTURE_I_OUT);
+    cfg.sampleHz = 80000;
+    cfg.depth = 1000;
+    cfg.preTrigger = 0;
+    cfg.edge = CAPTURE_TRIG_FALLING;
+    cfg.level = 1.5f;
+    plant.scheduleLoad(host_micros() + 10000, PLANT_LOAD_RESISTIVE, 4.0f);
+    check(capture.arm(cfg), "arm");
+    host_run_tasks(100);
+    CaptureInfo ci;
+    bool done = capture.info(ci);
+    check(done && ci.triggered && ci.channels == 1 && capture.sample(0, CAPTURE_I_OUT) <= cfg.level,
+          "第0帧即触发点，且已低于电平");
+    check(done && capture.sampleMv(0, CAPTURE_U_OUT) == 0, "未采集的通道读数为0");
+}
+
+static void checkAuto() {
+    printf("电平达不到时强制触发\n");
+    CaptureConfig cfg = captureDefaultConfig();
+    cfg.level = 10.0f;
+    cfg.autoMs = 50;
+    cfg.depth = 2000;
+    cfg.preTrigger = 500;
+    check(capture.arm(cfg), "arm");
+    host_run_tasks(40);
+    check(capture.state() == CAPTURE_ARMED, "50ms之内仍在等待触发");
+    host_run_tasks(100);
+    CaptureInfo ci;
+    check(capture.info(ci) && !ci.triggered, "强制触发完成");
+}
+
+static void checkConfigAndCancel() {
+    printf("配置检查和取消\n");
+    CaptureConfig cfg = captureDefaultConfig();
+    cfg.channelMask = CAPTURE_MASK(CAPTURE_U_OUT);
+    check(!capture.arm(cfg), "触发通道不在采集通道中时拒绝");
+    cfg = captureDefaultConfig();
+    cfg.depth = CAPTURE_MAX_SAMPLES;
+    check(!capture.arm(cfg), "超出缓冲区时拒绝");
+    cfg = captureDefaultConfig();
+    cfg.sampleHz = 50000;
+    check(!capture.arm(cfg), "合计采样率超出上限时拒绝");
+
+    cfg = captureDefaultConfig();
+    cfg.level = 10.0f;
+    uint32_t gen = capture.generation();
+    check(capture.arm(cfg), "arm");
+    host_run_tasks(20);
+    capture.cancel();
+    host_run_tasks(20);
+    check(capture.state() == CAPTURE_IDLE && capture.generation() == gen, "取消后空闲，没有新的捕获");
+    cfg.edge = CAPTURE_TRIG_NONE;
+    check(capture.arm(cfg), "再次arm");
+    host_run_tasks(200);
+    check(capture.state() == CAPTURE_DONE && capture.generation() == gen + 1, "立即触发完成");
+}
+
+int main() {
+    taskTableInstall(TASKS, sizeof(TASKS) / sizeof(TASKS[0]));
+
+    HostPlant plant(plantDefaultParams());
+    plant.overrideDac(4.0f);
+    plant.setLoad(PLANT_LOAD_RESISTIVE, 4.0f);
+    plant.attachToClock();
+    host_run_tasks(50);
+
+    if (!capture.begin()) {
+        printf("失败\n");
+        return CHECK_EXIT_FAIL;
+    }
+    checkStep(plant);
+    checkFalling(plant);
+    checkAuto();
+    checkConfigAndCancel();
+
+    return checkResult();
+}
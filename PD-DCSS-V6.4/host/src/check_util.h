@@ -0,0 +1,67 @@
+/**
+ * @file check_util.h
+ * @brief 主机检查程序的公共部分：退出码、检查结果计数、确定性的伪随机数和设置存储的默认记录
+ * @details
+ * 每个检查程序只有一个源文件，这里的变量和函数都是inline定义，包含一次即可。
+ * - check()：打印一项检查的结果并计数失败，checkResult() 打印总结果并返回退出码；
+ * - checkSeed()/checkNoise()/checkUniform()：线性同余的伪随机数，同一种子每次运行的序列相同；
+ * - checkDefaultSettings()：在 mySettings.h 之后包含时提供，设置存储和预设检查使用同一组默认值。
+ *
+ * 检查程序的返回值：CHECK_EXIT_OK(0) 通过；CHECK_EXIT_FAIL(1) 检查失败；CHECK_EXIT_USAGE(2) 参数错误。
+ */
+
+#ifndef CHECK_UTIL_H
+#define CHECK_UTIL_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define CHECK_EXIT_OK 0
+#define CHECK_EXIT_FAIL 1
+#define CHECK_EXIT_USAGE 2
+
+inline int s_failures = 0;
+inline uint32_t s_checkSeed = 2025;
+
+inline void check(bool ok, const char *what) {
+    printf("%s %s\n", ok ? "  通过" : "  失败", what);
+    if (!ok) {
+        s_failures++;
+    }
+}
+
+// 打印总结果，返回退出码
+inline int checkResult() {
+    printf("%s\n", s_failures == 0 ? "通过" : "失败");
+    return s_failures == 0 ? CHECK_EXIT_OK : CHECK_EXIT_FAIL;
+}
+
+// 确定性的伪随机数
+inline void checkSeed(uint32_t seed) {
+    s_checkSeed = seed;
+}
+
+inline int32_t checkNext() {
+    s_checkSeed = s_checkSeed * 1664525u + 1013904223u;
+    return (int32_t)s_checkSeed;
+}
+
+// [-1, 1)，单精度
+inline float checkNoise() {
+    return checkNext() / 2147483648.0f;
+}
+
+// [-1, 1)，双精度
+inline double checkUniform() {
+    return checkNext() / 2147483648.0;
+}
+
+#ifdef MY_SETTINGS_H
+// 设置存储的默认记录：5.00V（1.50-15.00V）、2.00A（0.10-5.00A），细调，校准系数为1，没有预设
+inline Settings checkDefaultSettings() {
+    Settings s = {5.00f, 1.50f, 15.00f, 2.00f, 0.10f, 5.00f, true, {1.0f, 1.0f, 1.0f, 1.0f}, {}};
+    return s;
+}
+#endif
+
+#endif // CHECK_UTIL_H
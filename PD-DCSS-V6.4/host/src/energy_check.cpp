@@ -0,0 +1,99 @@
+/**
+ * @file energy_check.cpp
+ * @brief 能量累计（lib/myEnergy）的长时间精度检查
+ * @details
+ * 按2ms±0.3ms的间隔（模拟任务调度抖动）喂入若干天的采集帧，输出电压、电流带噪声，
+ * 中间插入输出关闭的间隔。用 long double 按同样的梯形法和同样的毫瓦/毫安取整独立积分，
+ * 要求定点累计与之完全一致（相对误差 < 1e-12）；同时与不取整的积分比较，
+ * 要求相对误差 < 1e-5（取整误差是无偏的）。作为对照打印单精度浮点累加的误差。
+ *   energy_check [--days N]   默认3天
+ *
+ * 返回值：0 通过；1 超出误差；2 参数错误。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+
+#include "myEnergy.h"
+#include "check_util.h"
+
+#define CHECK_PERIOD_US 2000
+#define CHECK_JITTER_US 300
+#define CHECK_OFF_EVERY_FRAMES 1000000   // 每隔这么多帧关闭输出一次
+#define CHECK_OFF_US 5000000             // 关闭5秒（超过 ENERGY_MAX_GAP_US，不积分）
+
+static long double milli(float v) {
+    return v > 0.0f ? (long double)lroundf(v * 1000.0f) : 0.0L;
+}
+
+int main(int argc, char **argv) {
+    checkSeed(12345);
+    double days = 3.0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--days") == 0 && i + 1 < argc) {
+            days = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "用法: %s [--days N]\n", argv[0]);
+            return CHECK_EXIT_USAGE;
+        }
+    }
+
+    MyEnergy acc;
+    acc.reset();
+    uint64_t frames = (uint64_t)(days * 86400.0 * 1e6 / CHECK_PERIOD_US);
+
+    long double refQuantWh2 = 0.0L;   // 与定点累计相同的取整，单位 mW·us 的2倍
+    long double refExactJ = 0.0L;     // 不取整
+    float naiveWh = 0.0f;             // 单精度浮点累加（对照）
+
+    int64_t t = 1000;
+    bool havePrev = false;
+    AdcFrame prev = {};
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t n = 0; n < frames; n++) {
+        if (n > 0 && n % CHECK_OFF_EVERY_FRAMES == 0) {
+            t += CHECK_OFF_US;
+            havePrev = false;
+        } else {
+            t += CHECK_PERIOD_US + (int64_t)(checkNoise() * CHECK_JITTER_US);
+        }
+        AdcFrame f;
+        f.timeUs = t;
+        f.uOut = 5.0f + 0.02f * checkNoise();
+        f.iOut = 1.2345f + 0.01f * checkNoise();
+        f.uIn = 12.0f + 0.05f * checkNoise();
+        f.iIn = 0.55f + 0.01f * checkNoise();
+        acc.accumulate(f);
+
+        if (havePrev) {
+            long double dt = (long double)(f.timeUs - prev.timeUs);
+            refQuantWh2 += (milli(prev.uOut * prev.iOut) + milli(f.uOut * f.iOut)) * dt;
+            refExactJ += ((long double)prev.uOut * prev.iOut + (long double)f.uOut * f.iOut) / 2.0L * dt * 1e-6L;
+            naiveWh += (prev.uOut * prev.iOut + f.uOut * f.iOut) / 2.0f * (float)dt * 1e-6f / 3600.0f;
+        }
+        havePrev = true;
+        prev = f;
+    }
+    double hostMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    EnergyReading r;
+    acc.read(r);
+    long double quantWh = refQuantWh2 / (2e9L * 3600.0L);
+    long double exactWh = refExactJ / 3600.0L;
+    double errQuant = fabs((double)((r.outWh - quantWh) / quantWh));
+    double errExact = fabs((double)((r.outWh - exactWh) / exactWh));
+    double errNaive = fabs((double)((naiveWh - exactWh) / exactWh));
+
+    printf("%.1f天  %llu帧  运行时间 %.0fs  主机耗时 %.0fms\n", days, (unsigned long long)frames, r.runtimeS, hostMs);
+    printf("输出能量 %.6fWh  参考(同样取整) %.6fWh  参考(不取整) %.6fWh\n",
+           r.outWh, (double)quantWh, (double)exactWh);
+    printf("相对误差: 与同样取整的参考 %.2e  与不取整的参考 %.2e  单精度浮点累加 %.2e（对照）\n",
+           errQuant, errExact, errNaive);
+
+    bool ok = errQuant < 1e-12 && errExact < 1e-5;
+    printf("%s\n", ok ? "通过" : "失败");
+    return ok ? CHECK_EXIT_OK : CHECK_EXIT_FAIL;
+}
@@ -0,0 +1,221 @@
+/**
+ * @file fft_bench.cpp
+ * @brief FFT内核和纹波频谱分析（lib/mySpectrum）的精度检查和耗时基准
+ * @details
+ * 精度：
+ * - 复数FFT、实数FFT与双精度直接DFT比较，最大误差相对频谱峰值 < 2e-5；
+ * - 合成信号（4V直流 + 开关频率基波和二次谐波 + 白噪声），开关频率高于奈奎斯特频率且
+ *   折叠后不落在频点上：Hann窗和平顶窗、1024/2048/4096点下，各谐波有效值误差 < 1%，
+ *   交流有效值误差 < 0.5%，扣除谐波后的噪声误差 < 5%，最大分量落在基波折叠后的频率上。
+ * 耗时：各点数下实数FFT（含加窗）的平均耗时，主机上使用标量实现。
+ *   fft_bench [--repeat N] [--budget-us N]   budget-us 为4096点实数FFT的耗时上限，0表示不检查
+ *
+ * 返回值：0 通过；1 精度不满足或超出耗时上限；2 参数错误。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include "myFFT.h"
+#include "mySpectrum.h"
+#include "check_util.h"
+
+#define BENCH_DFT_TOLERANCE 2e-5
+#define BENCH_TONE_TOLERANCE 0.01
+#define BENCH_AC_TOLERANCE 0.005
+#define BENCH_NOISE_TOLERANCE 0.05
+
+// 近似高斯分布的白噪声（12个均匀分布之和），标准差为 sigma
+static double gaussian(double sigma) {
+    double s = 0.0;
+    for (int i = 0; i < 12; i++) {
+        s += checkUniform() * 0.5;   // [-0.5, 0.5)
+    }
+    return s * sigma;
+}
+
+// 直接DFT，返回 max|FFT - DFT| / max|DFT|
+static double compareDft(const std::vector<double> &re, const std::vector<double> &im,
+                         const float *fft, uint32_t bins, bool packedReal) {
+    uint32_t n = re.size();
+    double maxMag = 0.0;
+    double maxErr = 0.0;
+    for (uint32_t k = 0; k < bins; k++) {
+        double xr = 0.0;
+        double xi = 0.0;
+        for (uint32_t t = 0; t < n; t++) {
+            double a = -2.0 * M_PI * (double)k * t / n;
+            xr += re[t] * cos(a) - im[t] * sin(a);
+            xi += re[t] * sin(a) + im[t] * cos(a);
+        }
+        double fr = fft[2 * k];
+        double fi = fft[2 * k + 1];
+        if (packedReal && k == 0) {
+            fi = 0.0;   // data[1] 是奈奎斯特频点
+        }
+        maxMag = fmax(maxMag, hypot(xr, xi));
+        maxErr = fmax(maxErr, hypot(fr - xr, fi - xi));
+    }
+    return maxErr / maxMag;
+}
+
+static void checkKernel() {
+    printf("FFT内核与直接DFT比较（%s）\n", fftBackendName());
+    const uint16_t sizes[] = {16, 256, 1024};
+    for (uint16_t n : sizes) {
+        std::vector<double> re(n);
+        std::vector<double> im(n);
+        std::vector<float> data(2 * n);
+        for (uint16_t i = 0; i < n; i++) {
+            re[i] = checkUniform();
+            im[i] = checkUniform();
+            data[2 * i] = (float)re[i];
+            data[2 * i + 1] = (float)im[i];
+        }
+        bool ok = fftComplex(data.data(), n);
+        double err = compareDft(re, im, data.data(), n, false);
+        char what[64];
+        snprintf(what, sizeof(what), "%u点复数FFT 相对误差 %.2e", n, err);
+        check(ok && err < BENCH_DFT_TOLERANCE, what);
+
+        // 实数FFT：同样的实部，压缩的半频谱
+        std::vector<double> zero(n, 0.0);
+        std::vector<float> real(n);
+        for (uint16_t i = 0; i < n; i++) {
+            real[i] = (float)re[i];
+        }
+        ok = fftReal(real.data(), n);
+        err = compareDft(re, zero, real.data(), n / 2, true);
+        // 奈奎斯特频点单独比较
+        double nyq = 0.0;
+        for (uint16_t i = 0; i < n; i++) {
+            nyq += (i & 1) ? -re[i] : re[i];
+        }
+        ok = ok && fabs(real[1] - nyq) < 1e-3;
+        snprintf(what, sizeof(what), "%u点实数FFT 相对误差 %.2e", n, err);
+        check(ok && err < BENCH_DFT_TOLERANCE, what);
+    }
+    float dummy[4] = {0};
+    check(!fftReal(dummy, 12) && !fftReal(dummy, 8192) && !fftComplex(dummy, 3), "拒绝非2的幂和超出范围的点数");
+}
+
+static void checkTones() {
+    printf("合成纹波：开关频率高于奈奎斯特频率，折叠后不在频点上\n");
+    const double fsw = 152300.0;       // 80kHz采样时基波折叠到7.7kHz，二次谐波折叠到15.4kHz
+    const double a1 = 0.020;           // 基波幅值20mV
+    const double a2 = 0.006;           // 二次谐波6mV
+    const double sigma = 0.0004;       // 白噪声0.4mV（主瓣内的噪声约为二次谐波的1%）
+    const uint16_t sizes[] = {1024, 2048, 4096};
+    const uint8_t windows[] = {FFT_WINDOW_HANN, FFT_WINDOW_FLATTOP};
+
+    for (uint8_t w : windows) {
+        for (uint16_t n : sizes) {
+            SpectrumConfig cfg = spectrumDefaultConfig();
+            cfg.points = n;
+            cfg.switchingHz = (float)fsw;
+            cfg.harmonics = 2;
+            cfg.window = w;
+            std::vector<float> x(n);
+            double noiseSq = 0.0;
+            for (uint16_t i = 0; i < n; i++) {
+                double t = (double)i / cfg.sampleHz;
+                double e = gaussian(sigma);
+                noiseSq += e * e;
+                x[i] = (float)(4.0 + a1 * sin(2 * M_PI * fsw * t + 0.3) + a2 * sin(2 * M_PI * 2 * fsw * t + 1.1) + e);
+            }
+            double noise = sqrt(noiseSq / n);   // 实际生成的噪声有效值
+            SpectrumResult r;
+            bool ok = spectrum.analyze(x.data(), cfg, r);
+            double ac = sqrt(a1 * a1 / 2 + a2 * a2 / 2 + noise * noise);
+            // 频带从100Hz到奈奎斯特频率，白噪声在带外的部分可以忽略
+            double e1 = fabs(r.tones[0].rms / (a1 / sqrt(2.0)) - 1.0);
+            double e2 = fabs(r.tones[1].rms / (a2 / sqrt(2.0)) - 1.0);
+            double eAc = fabs(r.acRms / ac - 1.0);
+            double eNoise = fabs(r.noiseRms / noise - 1.0);
+            bool peakOk = fabs(r.peakHz - r.tones[0].aliasHz) <= r.binHz;
+            char what[160];
+            snprintf(what, sizeof(what),
+                     "%s窗 %u点: 基波 %.3fmV(%.2f%%) 二次 %.3fmV(%.2f%%) 交流 %.2f%% 噪声 %.3fmV(%.1f%%) 最大 %.0fHz",
+                     w == FFT_WINDOW_HANN ? "Hann" : "平顶", n, r.tones[0].rms * 1000, e1 * 100,
+                     r.tones[1].rms * 1000, e2 * 100, eAc * 100, r.noiseRms * 1000, eNoise * 100, r.peakHz);
+            check(ok && e1 < BENCH_TONE_TOLERANCE && e2 < BENCH_TONE_TOLERANCE && eAc < BENCH_AC_TOLERANCE &&
+                  eNoise < BENCH_NOISE_TOLERANCE && peakOk && fabs(r.dc - 4.0f) < 1e-3f, what);
+        }
+    }
+
+    printf("默认配置：150kHz开关频率，80kHz采样\n");
+    SpectrumConfig cfg = spectrumDefaultConfig();
+    std::vector<float> x(FFT_MAX_POINTS);
+    for (uint16_t i = 0; i < cfg.points; i++) {
+        x[i] = (float)(5.0 + 0.01 * sin(2 * M_PI * cfg.switchingHz * i / cfg.sampleHz));
+    }
+    SpectrumResult r;
+    const float aliases[SPECTRUM_MAX_HARMONICS] = {10000, 20000, 30000, 40000, 30000};
+    bool ok = spectrum.analyze(x.data(), cfg, r) && r.toneCount == SPECTRUM_MAX_HARMONICS;
+    for (uint8_t h = 0; ok && h < r.toneCount; h++) {
+        ok = fabsf(r.tones[h].aliasHz - aliases[h]) < 1.0f;
+    }
+    check(ok, "各次谐波折叠到 10/20/30/40/30kHz");
+    check(ok && fabs(r.tones[0].rms / (0.01 / sqrt(2.0)) - 1.0) < BENCH_TONE_TOLERANCE, "基波有效值");
+    cfg.points = 1000;
+    check(!spectrum.analyze(x.data(), cfg, r), "拒绝无效点数");
+}
+
+static void bench(int repeat, double budgetUs, bool *ok) {
+    printf("实数FFT耗时（含加窗，%s，重复%d次）\n", fftBackendName(), repeat);
+    printf("   点数      每次(us)   每点(ns)   ns/(N·log2N)\n");
+    std::vector<float> window(FFT_MAX_POINTS);
+    std::vector<float> src(FFT_MAX_POINTS);
+    std::vector<float> buf(FFT_MAX_POINTS);
+    for (uint32_t i = 0; i < FFT_MAX_POINTS; i++) {
+        src[i] = (float)checkUniform();
+    }
+    for (uint32_t n = 64; n <= FFT_MAX_POINTS; n <<= 1) {
+        fftWindowFill(window.data(), n, FFT_WINDOW_HANN);
+        volatile float sink = 0.0f;
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeat; r++) {
+            for (uint32_t i = 0; i < n; i++) {
+                buf[i] = src[i] * window[i];
+            }
+            fftReal(buf.data(), n);
+            sink = sink + buf[2];
+        }
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeat;
+        printf("  %5u  %10.2f  %9.2f  %9.3f\n", n, us, us * 1000.0 / n, us * 1000.0 / (n * log2((double)n)));
+        if (n == FFT_MAX_POINTS && budgetUs > 0.0 && us > budgetUs) {
+            printf("超出耗时上限 %.1fus\n", budgetUs);
+            *ok = false;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    checkSeed(2025);
+    int repeat = 200;
+    double budgetUs = 0.0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--budget-us") == 0 && i + 1 < argc) {
+            budgetUs = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "用法: %s [--repeat N] [--budget-us N]\n", argv[0]);
+            return CHECK_EXIT_USAGE;
+        }
+    }
+    if (repeat <= 0 || !fftInit()) {
+        return CHECK_EXIT_USAGE;
+    }
+
+    checkKernel();
+    checkTones();
+    bool ok = s_failures == 0;
+    bench(repeat, budgetUs, &ok);
+    printf("%s\n", ok ? "通过" : "失败");
+    return ok ? CHECK_EXIT_OK : CHECK_EXIT_FAIL;
+}
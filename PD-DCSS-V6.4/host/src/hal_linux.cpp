@@ -0,0 +1,467 @@
+/**
+ * @file hal_linux.cpp
+ * @brief 硬件抽象层的主机实现：引脚电平、ADC读数和SPI输出都保存在内存中
+ * @details
+ * - GPIO：测试脚本用 host_set_gpio() 设置输入电平，电平变化且符合登记的边沿时
+ *   在调用者的上下文中立即执行中断函数（相当于中断打断了脚本）；
+ * - ADC：host_set_adc_mv() 设置各通道读数，原始值与毫伏值一一对应；
+ *   连续采样按虚拟时钟产生样本：读取时逐个推进时钟到每个样本的时刻再取读数
+ *   （挂在时钟上的仿真模型随之积分），读完一批后让出CPU，相当于等待下一次DMA中断；
+ * - SPI：记录最后发送的16位数据和发送次数；
+ * - PWM：记录各通道的引脚、分辨率、当前占空比和设置次数；
+ * - 睡眠：轻睡眠只挂起调用的任务，按1ms间隔检查唤醒引脚，达到唤醒电平后返回
+ *   （目标板上整个芯片都会暂停，这里其他任务继续运行）；
+ * - 计时：基于虚拟时钟，halDelayUs 直接推进时钟；
+ * - 电源管理：默认不支持（与没有启用电源管理的Arduino构建相同），只记录手动设置的CPU频率；
+ *   host_set_pm_support() 打开后记录配置和各类锁的持有次数；
+ * - 非易失存储：保存在进程内存中，host_nvs_clear() 相当于擦除整个NVS分区，
+ *   读写次数可用 host_nvs_read_count()、host_nvs_write_count() 检查。
+ */
+
+#include <stdarg.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Arduino.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "myHAL.h"
+#include "host_stubs.h"
+
+#define HOST_GPIO_COUNT 64
+#define HOST_ADC_CHANNELS 10
+#define HOST_ADC_STREAM_POOL 1024   // 连续采样的驱动缓冲区（样本数），与固件的4096字节一致
+
+/* GPIO */
+
+struct HostPin {
+    int level;
+    HalPinMode mode;
+    HalIsr isr;
+    HalEdge edge;
+};
+
+static HostPin s_pins[HOST_GPIO_COUNT];
+
+void halGpioMode(uint8_t pin, HalPinMode mode) {
+    if (pin >= HOST_GPIO_COUNT) {
+        return;
+    }
+    s_pins[pin].mode = mode;
+    // 上拉输入在没有外部驱动时读到高电平
+    if (mode == HAL_PIN_INPUT_PULLUP) {
+        s_pins[pin].level = HIGH;
+    }
+}
+
+int halGpioRead(uint8_t pin) {
+    return pin < HOST_GPIO_COUNT ? s_pins[pin].level : LOW;
+}
+
+static void setLevel(uint8_t pin, int level) {
+    if (pin >= HOST_GPIO_COUNT) {
+        return;
+    }
+    HostPin &p = s_pins[pin];
+    level = level ? HIGH : LOW;
+    if (p.level == level) {
+        return;
+    }
+    p.level = level;
+    if (p.isr == NULL) {
+        return;
+    }
+    bool fire = p.edge == HAL_EDGE_CHANGE ||
+                (p.edge == HAL_EDGE_RISING && level == HIGH) ||
+                (p.edge == HAL_EDGE_FALLING && level == LOW);
+    if (fire) {
+        p.isr();
+    }
+}
+
+void halGpioWrite(uint8_t pin, int level) {
+    setLevel(pin, level);
+}
+
+void halGpioAttachIsr(uint8_t pin, HalIsr isr, HalEdge edge) {
+    if (pin < HOST_GPIO_COUNT) {
+        s_pins[pin].isr = isr;
+        s_pins[pin].edge = edge;
+    }
+}
+
+void halGpioDetachIsr(uint8_t pin) {
+    if (pin < HOST_GPIO_COUNT) {
+        s_pins[pin].isr = NULL;
+    }
+}
+
+void host_set_gpio(uint8_t pin, int level) {
+    setLevel(pin, level);
+}
+
+/* ADC */
+
+static uint32_t s_adcMv[HOST_ADC_CHANNELS];
+static uint32_t s_adcLast[HOST_ADC_CHANNELS];   // 各通道最近一次单次读数
+
+void host_set_adc_mv(int channel, uint32_t mv) {
+    if (channel >= 0 && channel < HOST_ADC_CHANNELS) {
+        s_adcMv[channel] = mv;
+    }
+}
+
+void halAdcInit(const uint8_t *channels, size_t count) {
+    (void)channels;
+    (void)count;
+}
+
+static bool adcLive(uint8_t channel);
+
+uint32_t halAdcReadRaw(uint8_t channel) {
+    if (channel >= HOST_ADC_CHANNELS) {
+        return 0;
+    }
+    // 与ESP32相同：连续采样期间不在采样序列中的通道保持开始前的读数
+    if (!adcLive(channel)) {
+        return s_adcLast[channel];
+    }
+    s_adcLast[channel] = s_adcMv[channel];
+    return s_adcMv[channel];
+}
+
+uint32_t halAdcRawToMv(uint32_t raw) {
+    return raw;
+}
+
+static struct {
+    bool running;
+    uint8_t channels[HAL_ADC_STREAM_MAX_CHANNELS];
+    size_t count;
+    uint32_t totalHz;
+    uint64_t startUs;
+    uint64_t index;      // 下一个样本的序号
+} s_stream;
+
+// 单次读数是否为当前值：没有连续采样，或通道在采样序列中
+static bool adcLive(uint8_t channel) {
+    if (!s_stream.running) {
+        return true;
+    }
+    for (size_t i = 0; i < s_stream.count; i++) {
+        if (s_stream.channels[i] == channel) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint64_t streamSampleUs(uint64_t index) {
+    return s_stream.startUs + index * 1000000ull / s_stream.totalHz;
+}
+
+bool halAdcStreamStart(const uint8_t *channels, size_t count, uint32_t totalHz) {
+    if (s_stream.running || count == 0 || count > HAL_ADC_STREAM_MAX_CHANNELS ||
+        totalHz < HAL_ADC_STREAM_MIN_HZ || totalHz > HAL_ADC_STREAM_MAX_HZ) {
+        return false;
+    }
+    memcpy(s_stream.channels, channels, count);
+    s_stream.count = count;
+    s_stream.totalHz = totalHz;
+    s_stream.startUs = host_micros();
+    s_stream.index = 0;
+    s_stream.running = true;
+    return true;
+}
+
+size_t halAdcStreamRead(HalAdcSample *out, size_t maxSamples, uint32_t timeoutMs, bool *overrun) {
+    (void)timeoutMs;
+    if (overrun != NULL) {
+        *overrun = false;
+    }
+    if (!s_stream.running) {
+        return 0;
+    }
+    // 很久没有读取：驱动缓冲区只保留最近的样本（已经到期的样本取当前读数）
+    uint64_t now = host_micros();
+    uint64_t due = (now - s_stream.startUs) * s_stream.totalHz / 1000000ull + 1;
+    if (due > s_stream.index + HOST_ADC_STREAM_POOL) {
+        s_stream.index = due - HOST_ADC_STREAM_POOL;
+        if (overrun != NULL) {
+            *overrun = true;
+        }
+    }
+    for (size_t i = 0; i < maxSamples; i++) {
+        uint64_t at = streamSampleUs(s_stream.index);
+        if (at > host_micros()) {
+            host_advance_us(at - host_micros());
+        }
+        uint8_t channel = s_stream.channels[s_stream.index % s_stream.count];
+        out[i].channel = channel;
+        out[i].raw = (uint16_t)halAdcReadRaw(channel);
+        s_stream.index++;
+    }
+    if (host_in_task()) {
+        vTaskDelay(0);
+    }
+    return maxSamples;
+}
+
+void halAdcStreamStop() {
+    s_stream.running = false;
+}
+
+/* SPI */
+
+struct HalSpi {
+    uint8_t csPin;
+};
+
+static uint16_t s_spiLastWord = 0;
+static uint32_t s_spiWrites = 0;
+
+HalSpi *halSpiOpen(uint8_t sckPin, uint8_t mosiPin, uint8_t csPin, uint32_t clockHz) {
+    (void)sckPin;
+    (void)mosiPin;
+    (void)clockHz;
+    HalSpi *spi = new HalSpi;
+    spi->csPin = csPin;
+    halGpioMode(csPin, HAL_PIN_OUTPUT);
+    halGpioWrite(csPin, HIGH);
+    return spi;
+}
+
+void halSpiWrite16(HalSpi *spi, uint16_t data) {
+    if (spi == NULL) {
+        return;
+    }
+    halGpioWrite(spi->csPin, LOW);
+    s_spiLastWord = data;
+    s_spiWrites++;
+    halGpioWrite(spi->csPin, HIGH);
+}
+
+uint16_t host_spi_last_word() { return s_spiLastWord; }
+uint32_t host_spi_write_count() { return s_spiWrites; }
+
+/* PWM */
+
+#define HOST_PWM_CHANNELS 8
+
+struct HostPwm {
+    int pin;
+    uint8_t bits;
+    uint32_t duty;
+    uint32_t writes;
+};
+
+static HostPwm s_pwm[HOST_PWM_CHANNELS] = {};
+
+bool halPwmInit(uint8_t pin, uint8_t channel, uint32_t freqHz, uint8_t bits) {
+    (void)freqHz;
+    if (channel >= HOST_PWM_CHANNELS || bits == 0 || bits > 14) {
+        return false;
+    }
+    s_pwm[channel].pin = pin;
+    s_pwm[channel].bits = bits;
+    s_pwm[channel].duty = 0;
+    s_pwm[channel].writes = 0;
+    return true;
+}
+
+void halPwmWrite(uint8_t channel, uint32_t duty) {
+    if (channel >= HOST_PWM_CHANNELS) {
+        return;
+    }
+    s_pwm[channel].duty = duty;
+    s_pwm[channel].writes++;
+}
+
+uint32_t host_pwm_duty(uint8_t channel) {
+    return channel < HOST_PWM_CHANNELS ? s_pwm[channel].duty : 0;
+}
+
+uint32_t host_pwm_write_count(uint8_t channel) {
+    return channel < HOST_PWM_CHANNELS ? s_pwm[channel].writes : 0;
+}
+
+/* 计时 */
+
+uint32_t halMillis() { return host_millis(); }
+uint64_t halMicros() { return host_micros(); }
+void halDelayUs(uint32_t us) { host_advance_us(us); }
+
+/* 睡眠和复位 */
+
+static uint32_t s_sleepCount = 0;
+static int s_wakePin = -1;
+static int s_wakeLevel = HIGH;
+
+void halSleepInit() {}
+
+void halSleepEnableGpioWakeup(uint8_t pin, int level) {
+    s_wakePin = pin;
+    s_wakeLevel = level ? HIGH : LOW;
+}
+
+HalWakeCause halSleepLight() {
+    s_sleepCount++;
+    if (s_wakePin < 0) {
+        return HAL_WAKE_OTHER;
+    }
+    // 主上下文中无法等待脚本输入，直接视为已唤醒
+    while (host_in_task() && halGpioRead((uint8_t)s_wakePin) != s_wakeLevel) {
+        vTaskDelay(1);
+    }
+    return HAL_WAKE_GPIO;
+}
+
+void halSleepDisableWakeup() {
+    s_wakePin = -1;
+}
+
+int halResetReason() { return 1; } // ESP_RST_POWERON
+
+uint32_t host_sleep_count() { return s_sleepCount; }
+
+/* 电源管理 */
+
+struct HalPmLock {
+    HalPmLockType type;
+};
+
+static bool s_pmDfs = false;
+static bool s_pmSleep = false;
+static bool s_pmConfigured = false;
+static bool s_pmLightSleep = false;
+static int s_pmHeld[HAL_PM_NO_SLEEP + 1] = {};
+static uint32_t s_cpuMhz = 240;
+static uint32_t s_cpuSwitches = 0;
+static uint64_t s_wakeMask = 0;
+static uint64_t s_wakeChangeMask = 0;
+static uint64_t s_wakeChangeLevels = 0;   // 唤醒电平为高的引脚
+
+void host_set_pm_support(bool dfs, bool lightSleep) {
+    s_pmDfs = dfs;
+    s_pmSleep = dfs && lightSleep;
+    s_pmConfigured = false;
+    s_pmLightSleep = false;
+}
+
+bool halPmConfigure(uint32_t maxMhz, uint32_t minMhz, bool lightSleep) {
+    if (!s_pmDfs || (lightSleep && !s_pmSleep) || minMhz > maxMhz) {
+        return false;
+    }
+    s_pmConfigured = true;
+    s_pmLightSleep = lightSleep;
+    return true;
+}
+
+HalPmLock *halPmLockCreate(HalPmLockType type, const char *name) {
+    (void)name;
+    if (!s_pmDfs) {
+        return NULL;
+    }
+    HalPmLock *lock = new HalPmLock;
+    lock->type = type;
+    return lock;
+}
+
+void halPmLockAcquire(HalPmLock *lock) {
+    if (lock != NULL) {
+        s_pmHeld[lock->type]++;
+    }
+}
+
+void halPmLockRelease(HalPmLock *lock) {
+    if (lock != NULL && s_pmHeld[lock->type] > 0) {
+        s_pmHeld[lock->type]--;
+    }
+}
+
+bool halCpuSetMhz(uint32_t mhz) {
+    if (mhz != 80 && mhz != 160 && mhz != 240) {
+        return false;
+    }
+    if (mhz != s_cpuMhz) {
+        s_cpuSwitches++;
+    }
+    s_cpuMhz = mhz;
+    return true;
+}
+
+uint32_t halCpuMhz() { return s_cpuMhz; }
+
+void halPmWakeOnHigh(const uint8_t *pins, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        s_wakeMask |= 1ULL << pins[i];
+    }
+}
+
+void halPmWakeOnChange(const uint8_t *pins, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        uint64_t bit = 1ULL << pins[i];
+        s_wakeChangeMask |= bit;
+        if (halGpioRead(pins[i])) {
+            s_wakeChangeLevels &= ~bit;
+        } else {
+            s_wakeChangeLevels |= bit;
+        }
+    }
+}
+
+int host_pm_lock_held(int type) { return type >= 0 && type <= HAL_PM_NO_SLEEP ? s_pmHeld[type] : 0; }
+bool host_pm_light_sleep() { return s_pmConfigured && s_pmLightSleep; }
+uint32_t host_cpu_switch_count() { return s_cpuSwitches; }
+uint64_t host_pm_wake_mask() { return s_wakeMask; }
+uint64_t host_pm_wake_change_mask() { return s_wakeChangeMask; }
+uint64_t host_pm_wake_change_levels() { return s_wakeChangeLevels; }
+
+/* 非易失存储 */
+
+static std::map<std::string, std::vector<uint8_t> > s_nvs;   // "命名空间/键" -> 记录
+static uint32_t s_nvsReads = 0;
+static uint32_t s_nvsWrites = 0;
+
+static std::string nvsKey(const char *ns, const char *key) {
+    return std::string(ns) + "/" + key;
+}
+
+bool halNvsLoad(const char *ns, const char *key, void *data, size_t size) {
+    s_nvsReads++;
+    std::map<std::string, std::vector<uint8_t> >::const_iterator it = s_nvs.find(nvsKey(ns, key));
+    if (it == s_nvs.end() || it->second.size() != size) {
+        return false;
+    }
+    memcpy(data, it->second.data(), size);
+    return true;
+}
+
+bool halNvsSave(const char *ns, const char *key, const void *data, size_t size) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    s_nvsWrites++;
+    s_nvs[nvsKey(ns, key)].assign(bytes, bytes + size);
+    return true;
+}
+
+bool halNvsErase(const char *ns, const char *key) {
+    s_nvs.erase(nvsKey(ns, key));
+    return true;
+}
+
+void host_nvs_clear() { s_nvs.clear(); }
+uint32_t host_nvs_read_count() { return s_nvsReads; }
+uint32_t host_nvs_write_count() { return s_nvsWrites; }
+
+/* 日志 */
+
+void halLog(const char *fmt, ...) {
+    char buf[256];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    Serial.print(buf);
+}
@@ -0,0 +1,223 @@
+/**
+ * @file history_check.cpp
+ * @brief 多分辨率历史记录（lib/myHistory）的正确性检查和每帧耗时
+ * @details
+ * 按2ms±0.3ms的间隔喂入若干小时的采集帧（U_OUT缓慢正弦加噪声，I_OUT方波），结束前有一段
+ * 输出关闭（没有采集帧）。对每一档用 std::map 按桶序号独立统计每个桶的最小、最大、平均值，
+ * 要求环形记录中可读范围内的每个点与之一致（最小、最大完全相同，平均值误差 < 1e-5），
+ * 没有数据的桶必须读为空点；columns() 的每列与逐点计算一致；最后停止喂帧，
+ * flush() 推进时间后空档出现在末尾；reset() 之后没有可读的点。
+ *   history_check [--hours N]   默认26小时（超过最长一档的24小时，覆盖回绕）
+ *
+ * 返回值：0 通过；1 检查失败；2 参数错误。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <map>
+
+#include "myHistory.h"
+#include "check_util.h"
+
+#define CHECK_PERIOD_US 2000
+#define CHECK_JITTER_US 300
+#define CHECK_START_US 1234567LL          // 第一帧的时间，不与桶的边界对齐
+#define CHECK_OFF_BEFORE_END_S 1800       // 结束前30分钟到20分钟之间输出关闭（在1小时档和24小时档中）
+#define CHECK_OFF_LENGTH_S 600
+#define CHECK_COLUMNS 240
+
+struct Ref {
+    float min[HISTORY_CHANNELS];
+    float max[HISTORY_CHANNELS];
+    double sum[HISTORY_CHANNELS];
+    uint32_t count;
+};
+
+static std::map<uint32_t, Ref> s_ref[HISTORY_TIERS];
+static std::map<uint32_t, Ref>::iterator s_last[HISTORY_TIERS];
+
+static void addRef(uint8_t tier, uint32_t seq, const float *v) {
+    auto it = s_last[tier];
+    if (s_ref[tier].empty() || it->first != seq) {
+        it = s_ref[tier].find(seq);
+    }
+    if (it == s_ref[tier].end()) {
+        Ref r;
+        for (int ch = 0; ch < HISTORY_CHANNELS; ch++) {
+            r.min[ch] = v[ch];
+            r.max[ch] = v[ch];
+            r.sum[ch] = 0.0;
+        }
+        r.count = 0;
+        it = s_ref[tier].emplace(seq, r).first;
+    }
+    s_last[tier] = it;
+    Ref &r = it->second;
+    for (int ch = 0; ch < HISTORY_CHANNELS; ch++) {
+        r.min[ch] = fminf(r.min[ch], v[ch]);
+        r.max[ch] = fmaxf(r.max[ch], v[ch]);
+        r.sum[ch] += v[ch];
+    }
+    r.count++;
+}
+
+// 可读范围内的每个点与独立统计比较
+static bool comparePoints(const MyHistory &h, uint8_t tier, uint32_t *points, uint32_t *gaps) {
+    bool ok = true;
+    uint32_t head = h.head(tier);
+    *points = 0;
+    *gaps = 0;
+    for (uint32_t seq = head - h.length(tier); seq != head; seq++) {
+        HistoryPoint p;
+        bool found = h.read(tier, seq, p);
+        auto it = s_ref[tier].find(seq);
+        if (it == s_ref[tier].end()) {
+            ok = ok && !found;
+            (*gaps)++;
+            continue;
+        }
+        (*points)++;
+        const Ref &r = it->second;
+        ok = ok && found && p.seq == seq;
+        for (int ch = 0; ok && ch < HISTORY_CHANNELS; ch++) {
+            ok = p.min[ch] == r.min[ch] && p.max[ch] == r.max[ch] && fabs(p.mean[ch] - r.sum[ch] / r.count) < 1e-5;
+        }
+        if (!ok) {
+            printf("    第%u档 序号%lu 不一致\n", tier, (unsigned long)seq);
+            return false;
+        }
+    }
+    return ok;
+}
+
+static bool compareColumns(const MyHistory &h, uint8_t tier, uint8_t channel) {
+    static float mins[CHECK_COLUMNS];
+    static float maxs[CHECK_COLUMNS];
+    static float means[CHECK_COLUMNS];
+    static bool valid[CHECK_COLUMNS];
+    if (!h.columns(tier, channel, CHECK_COLUMNS, mins, maxs, means, valid)) {
+        return false;
+    }
+    const uint32_t len = h.length(tier);
+    const uint32_t first = h.head(tier) - len;
+    for (uint32_t c = 0; c < CHECK_COLUMNS; c++) {
+        float lo = INFINITY;
+        float hi = -INFINITY;
+        double sum = 0.0;
+        uint32_t n = 0;
+        for (uint32_t k = c * len / CHECK_COLUMNS; k < (c + 1) * len / CHECK_COLUMNS; k++) {
+            HistoryPoint p;
+            if (h.read(tier, first + k, p)) {
+                lo = fminf(lo, p.min[channel]);
+                hi = fmaxf(hi, p.max[channel]);
+                sum += p.mean[channel];
+                n++;
+            }
+        }
+        if (valid[c] != (n > 0) || (n > 0 && (mins[c] != lo || maxs[c] != hi || fabs(means[c] - sum / n) > 1e-5))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    checkSeed(4242);
+    double hours = 26.0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--hours") == 0 && i + 1 < argc) {
+            hours = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "用法: %s [--hours N]\n", argv[0]);
+            return CHECK_EXIT_USAGE;
+        }
+    }
+
+    MyHistory h;
+    if (!h.begin()) {
+        return CHECK_EXIT_FAIL;
+    }
+    const int64_t endUs = CHECK_START_US + (int64_t)(hours * 3600e6);
+    const uint32_t offFromS = (uint32_t)(endUs / 1000000) - CHECK_OFF_BEFORE_END_S;
+    const uint32_t offToS = offFromS + CHECK_OFF_LENGTH_S;
+    printf("喂入 %.1f 小时的采集帧（%lu ~ %lu 秒输出关闭）\n", hours, (unsigned long)offFromS, (unsigned long)offToS);
+    int64_t t = CHECK_START_US;
+    uint64_t frames = 0;
+    double spentNs = 0.0;
+    while (t < endUs) {
+        double s = t / 1e6;
+        if (s >= offFromS && s < offToS) {
+            t = (int64_t)offToS * 1000000 + 731;
+            continue;
+        }
+        AdcFrame f;
+        f.timeUs = t;
+        f.uIn = 20.0f;
+        f.iIn = 0.3f;
+        f.uOut = 5.0f + 0.1f * sinf((float)(2 * M_PI * s / 37.0)) + 0.003f * checkNoise();
+        f.iOut = fmod(s, 20.0) < 10.0 ? 1.5f : 0.5f;
+        auto start = std::chrono::steady_clock::now();
+        h.addFrame(f);
+        spentNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        const float v[HISTORY_CHANNELS] = {f.uOut, f.iOut, f.uOut * f.iOut};
+        uint64_t sec = (uint64_t)t / 1000000u;
+        for (uint8_t k = 0; k < HISTORY_TIERS; k++) {
+            addRef(k, (uint32_t)(sec / h.periodS(k)), v);
+        }
+        frames++;
+        t += CHECK_PERIOD_US + (int64_t)(checkNoise() * CHECK_JITTER_US);
+    }
+    printf("    %llu帧，每帧平均 %.1fns\n", (unsigned long long)frames, spentNs / frames);
+
+    // 停止喂帧之前，最后一个桶还没有写入；推进30秒后写入，之后都是空点
+    uint32_t headBefore = h.head(0);
+    h.flush(t + 30000000);
+    check(h.head(0) == (uint32_t)(t / 1000000) + 30, "flush() 按当前时间推进第0档");
+    HistoryPoint p;
+    check(h.read(0, headBefore, p) && !h.read(0, h.head(0) - 1, p), "flush() 写入最后一个有数据的桶，之后为空点");
+
+    for (uint8_t k = 0; k < HISTORY_TIERS; k++) {
+        // 未写入的当前桶不参与比较
+        s_ref[k].erase(h.head(k));
+        uint32_t points = 0;
+        uint32_t gaps = 0;
+        bool ok = comparePoints(h, k, &points, &gaps);
+        char what[96];
+        snprintf(what, sizeof(what), "第%u档（%lus/点）：%lu个点与独立统计一致，%lu个空点", k,
+                 (unsigned long)h.periodS(k), (unsigned long)points, (unsigned long)gaps);
+        check(ok && points > 0, what);
+    }
+    // 关闭期间完整的桶是空点，之前的桶有数据
+    bool gapOk = h.read(1, offFromS / 10 - 1, p) && h.read(2, offFromS / 60 - 1, p);
+    for (uint32_t seq = offFromS / 10 + 1; seq < offToS / 10; seq++) {
+        gapOk = gapOk && !h.read(1, seq, p);
+    }
+    for (uint32_t seq = offFromS / 60 + 1; seq < offToS / 60; seq++) {
+        gapOk = gapOk && !h.read(2, seq, p);
+    }
+    check(gapOk, "输出关闭期间没有点");
+
+    bool columnsOk = true;
+    for (uint8_t k = 0; k < HISTORY_TIERS; k++) {
+        for (uint8_t ch = 0; ch < HISTORY_CHANNELS; ch++) {
+            columnsOk = columnsOk && compareColumns(h, k, ch);
+        }
+    }
+    check(columnsOk, "columns() 的每列与逐点计算一致");
+
+    uint32_t generation = h.generation();
+    h.reset();
+    bool empty = h.generation() == generation + 1;
+    for (uint8_t k = 0; k < HISTORY_TIERS; k++) {
+        for (uint32_t seq = h.head(k) - h.length(k); seq != h.head(k); seq++) {
+            empty = empty && !h.read(k, seq, p);
+        }
+    }
+    check(empty, "reset() 之后没有可读的点");
+
+    return checkResult();
+}
@@ -0,0 +1,63 @@
+/**
+ * @file host_frame_placeholder.c
+ * @brief _UI_frame_alpha_256x242 的占位图片
+ * @details
+ * 仓库中没有GUI Guider导出的边框图片源文件（images/_UI_frame_alpha_256x242.c），
+ * 主机构建在找不到它时编译本文件：一张同尺寸、带alpha通道的图片，
+ * 只画出圆角边框轮廓，内部透明。这样界面布局和alpha混合路径与固件一致。
+ * 一旦真实图片加入仓库，CMake会自动改用真实图片，基准图需要重新生成。
+ */
+
+#include "lvgl.h"
+
+#define FRAME_W 256
+#define FRAME_H 242
+#define FRAME_RADIUS 16
+#define FRAME_BORDER 3
+#define FRAME_COLOR 0x8c9bb5
+
+/* LV_IMG_CF_TRUE_COLOR_ALPHA，RGB565：每像素 2字节颜色 + 1字节alpha */
+static uint8_t frame_map[FRAME_W * FRAME_H * LV_IMG_PX_SIZE_ALPHA_BYTE];
+
+const lv_img_dsc_t _UI_frame_alpha_256x242 = {
+    .header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA,
+    .header.always_zero = 0,
+    .header.reserved = 0,
+    .header.w = FRAME_W,
+    .header.h = FRAME_H,
+    .data_size = sizeof(frame_map),
+    .data = frame_map,
+};
+
+/* 点到圆角矩形边界的距离（矩形内部为负） */
+static int32_t frame_dist(int32_t x, int32_t y)
+{
+    int32_t cx = LV_CLAMP(FRAME_RADIUS, x, FRAME_W - 1 - FRAME_RADIUS);
+    int32_t cy = LV_CLAMP(FRAME_RADIUS, y, FRAME_H - 1 - FRAME_RADIUS);
+    int32_t dx = x - cx;
+    int32_t dy = y - cy;
+    uint32_t d2 = (uint32_t)(dx * dx + dy * dy);
+    if (dx == 0 && dy == 0) {
+        /* 直边区域：到最近边的距离 */
+        int32_t m = LV_MIN(LV_MIN(x, FRAME_W - 1 - x), LV_MIN(y, FRAME_H - 1 - y));
+        return -m;
+    }
+    lv_sqrt_res_t r;
+    lv_sqrt(d2, &r, 0x8000);
+    return (int32_t)r.i - FRAME_RADIUS;
+}
+
+__attribute__((constructor)) static void frame_placeholder_init(void)
+{
+    lv_color_t c = lv_color_hex(FRAME_COLOR);
+    for (int32_t y = 0; y < FRAME_H; y++) {
+        for (int32_t x = 0; x < FRAME_W; x++) {
+            uint8_t *px = &frame_map[(y * FRAME_W + x) * LV_IMG_PX_SIZE_ALPHA_BYTE];
+            int32_t d = frame_dist(x, y);
+            uint8_t a = (d <= 0 && d > -FRAME_BORDER) ? 0xff : 0x00;
+            px[0] = (uint8_t)(c.full & 0xff);
+            px[1] = (uint8_t)(c.full >> 8);
+            px[2] = a;
+        }
+    }
+}
@@ -0,0 +1,309 @@
+/**
+ * @file host_plant.cpp
+ * @brief 降压变换器的离散时间仿真模型
+ */
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#include "host_plant.h"
+#include "host_stubs.h"
+
+// 与 lib/myDAC 和 lib/myADC 一致
+#define PLANT_DAC_MAX_VALUE 1023
+#define PLANT_DAC_MAX_VOLTAGE 4.096f
+#define PLANT_ADC_U_IN 0
+#define PLANT_ADC_I_IN 1
+#define PLANT_ADC_U_OUT 2
+#define PLANT_ADC_I_OUT 3
+
+#define PLANT_CC_KNEE_V 0.2f   // 恒流负载在输出电压低于此值时按比例减小，避免把输出拉成负压
+
+static HostPlant *s_attached = NULL;
+
+PlantParams plantDefaultParams() {
+    PlantParams p;
+    p.vinOpen = 12.0f;
+    p.sourceResistance = 0.05f;
+    p.inductance = 22e-6f;
+    p.inductorResistance = 0.03f;
+    p.capacitance = 220e-6f;
+    p.dutyMax = 0.95f;
+    p.diodeRectifier = true;
+    p.refGain = 1.0f;
+    p.refTauS = 1e-3f;
+    // 外环穿越频率约5kHz（电流环的1/4）：kp = 2π·fc·C，积分零点在 fc/5
+    p.voltageKp = 6.9f;
+    p.voltageKi = 43000.0f;
+    p.currentLoopHz = 20000.0f;
+    p.currentLimit = 5.0f;
+    p.switchingLossW = 0.15f;
+    p.quiescentCurrent = 0.005f;
+    for (int i = 0; i < 4; i++) {
+        p.adcMvPerUnit[i] = 1000.0f;
+    }
+    p.stepUs = 1;
+    return p;
+}
+
+HostPlant::HostPlant(const PlantParams &params) :
+    _p(params),
+    _loadKind(PLANT_LOAD_RESISTIVE),
+    _loadValue(0.0f),
+    _sagV(0.0f),
+    _sagEndUs(0),
+    _dacOverride(-1.0f),
+    _integrator(0.0f),
+    _marked(false),
+    _markUs(0),
+    _target(0.0f),
+    _band(0.0f),
+    _peak(0.0f),
+    _trough(0.0f),
+    _lastOutsideUs(0),
+    _everInside(false),
+    _energyIn(0.0),
+    _energyOut(0.0),
+    _tailPos(0),
+    _trace(NULL),
+    _traceDecimationUs(0),
+    _nextTraceUs(0)
+{
+    if (_p.stepUs == 0) {
+        _p.stepUs = 1;
+    }
+    memset(&_s, 0, sizeof(_s));
+    _s.timeUs = host_micros();
+    _s.vin = _p.vinOpen;
+    _tail.assign(std::max<uint32_t>(1, PLANT_RIPPLE_WINDOW_US / _p.stepUs), 0.0f);
+}
+
+HostPlant::~HostPlant() {
+    detachFromClock();
+    openTrace(NULL, 0);
+}
+
+void HostPlant::setLoad(PlantLoadKind kind, float value) {
+    _loadKind = kind;
+    _loadValue = value;
+}
+
+void HostPlant::scheduleLoad(uint64_t atUs, PlantLoadKind kind, float value) {
+    Event e = {atUs, false, kind, value, 0};
+    _events.push_back(e);
+}
+
+void HostPlant::scheduleSag(uint64_t atUs, uint32_t durationUs, float dropV) {
+    Event e = {atUs, true, PLANT_LOAD_RESISTIVE, dropV, durationUs};
+    _events.push_back(e);
+}
+
+void HostPlant::overrideDac(float volts) {
+    _dacOverride = volts;
+}
+
+float HostPlant::dacVoltage() const {
+    if (_dacOverride >= 0.0f) {
+        return _dacOverride;
+    }
+    // TLC5615：10位数据左移2位发送
+    uint16_t code = (host_spi_last_word() >> 2) & PLANT_DAC_MAX_VALUE;
+    return code * PLANT_DAC_MAX_VOLTAGE / PLANT_DAC_MAX_VALUE;
+}
+
+float HostPlant::loadCurrent(float vout) const {
+    if (vout <= 0.0f) {
+        return 0.0f;
+    }
+    if (_loadKind == PLANT_LOAD_RESISTIVE) {
+        return _loadValue > 0.0f ? vout / _loadValue : 0.0f;
+    }
+    return _loadValue * std::min(1.0f, vout / PLANT_CC_KNEE_V);
+}
+
+void HostPlant::applyEvents() {
+    for (size_t i = 0; i < _events.size();) {
+        const Event &e = _events[i];
+        if (e.atUs > _s.timeUs) {
+            i++;
+            continue;
+        }
+        if (e.isSag) {
+            _sagV = e.value;
+            _sagEndUs = e.atUs + e.durationUs;
+        } else {
+            _loadKind = e.kind;
+            _loadValue = e.value;
+        }
+        _events.erase(_events.begin() + i);
+    }
+    if (_sagV != 0.0f && _s.timeUs >= _sagEndUs) {
+        _sagV = 0.0f;
+    }
+}
+
+void HostPlant::step(float dt) {
+    const PlantParams &p = _p;
+
+    // 基准RC滤波
+    float vrefTarget = dacVoltage() * p.refGain;
+    float a = p.refTauS > 0.0f ? std::min(1.0f, dt / p.refTauS) : 1.0f;
+    _s.vref += (vrefTarget - _s.vref) * a;
+
+    // 外环：电压误差 -> 电流指令
+    float err = _s.vref - _s.vout;
+    float icmdRaw = p.voltageKp * err + _integrator;
+    float icmd = std::max(0.0f, std::min(p.currentLimit, icmdRaw));
+
+    // 内环：求出让电感电流以给定带宽跟踪指令所需的开关节点电压
+    float wi = 2.0f * (float)M_PI * p.currentLoopHz;
+    float vswRaw = _s.vout + _s.il * p.inductorResistance + p.inductance * wi * (icmd - _s.il);
+    float vswMax = p.dutyMax * std::max(0.0f, _s.vin);
+    float vsw = std::max(0.0f, std::min(vswMax, vswRaw));
+    _s.duty = _s.vin > 0.0f ? vsw / _s.vin : 0.0f;
+
+    // 积分抗饱和：限流或占空比达到上限时不再朝饱和方向累积（压降恢复时不会过冲）
+    bool saturatedHigh = icmdRaw >= p.currentLimit || vswRaw >= vswMax;
+    bool saturatedLow = icmdRaw <= 0.0f;
+    if (!(saturatedHigh && err > 0.0f) && !(saturatedLow && err < 0.0f)) {
+        _integrator += p.voltageKi * err * dt;
+        _integrator = std::max(0.0f, std::min(p.currentLimit, _integrator));
+    }
+
+    // 功率级
+    _s.il += dt / p.inductance * (vsw - _s.vout - _s.il * p.inductorResistance);
+    if (p.diodeRectifier && _s.il < 0.0f) {
+        _s.il = 0.0f;
+    }
+    _s.iload = loadCurrent(_s.vout);
+    _s.vout += dt / p.capacitance * (_s.il - _s.iload);
+    if (_s.vout < 0.0f && p.diodeRectifier) {
+        _s.vout = 0.0f;
+    }
+
+    // 输入侧：按功率守恒求输入电流，用上一步的输入电压避免代数环
+    float pin = vsw * _s.il + (_s.il > 0.01f ? p.switchingLossW : 0.0f);
+    float vinPrev = std::max(0.1f, _s.vin);
+    _s.iin = std::max(0.0f, pin / vinPrev) + p.quiescentCurrent;
+    _s.vin = p.vinOpen - _sagV - _s.iin * p.sourceResistance;
+
+    if (_marked) {
+        _energyIn += (double)_s.vin * _s.iin * dt;
+        _energyOut += (double)_s.vout * _s.iload * dt;
+        _peak = std::max(_peak, _s.vout);
+        _trough = std::min(_trough, _s.vout);
+        if (fabsf(_s.vout - _target) > _band) {
+            _lastOutsideUs = _s.timeUs;
+        } else {
+            _everInside = true;
+        }
+    }
+    _tail[_tailPos] = _s.vout;
+    _tailPos = (_tailPos + 1) % _tail.size();
+}
+
+void HostPlant::advanceTo(uint64_t toUs) {
+    float dt = _p.stepUs * 1e-6f;
+    while (_s.timeUs + _p.stepUs <= toUs) {
+        applyEvents();
+        step(dt);
+        _s.timeUs += _p.stepUs;
+        record();
+    }
+    publishAdc();
+}
+
+static void publishChannel(int channel, float value, float mvPerUnit) {
+    float mv = value * mvPerUnit;
+    host_set_adc_mv(channel, mv > 0.0f ? (uint32_t)lroundf(mv) : 0);
+}
+
+void HostPlant::publishAdc() {
+    publishChannel(PLANT_ADC_U_IN, _s.vin, _p.adcMvPerUnit[PLANT_ADC_U_IN]);
+    publishChannel(PLANT_ADC_I_IN, _s.iin, _p.adcMvPerUnit[PLANT_ADC_I_IN]);
+    publishChannel(PLANT_ADC_U_OUT, _s.vout, _p.adcMvPerUnit[PLANT_ADC_U_OUT]);
+    publishChannel(PLANT_ADC_I_OUT, _s.iload, _p.adcMvPerUnit[PLANT_ADC_I_OUT]);
+}
+
+void HostPlant::mark(float target, float settleBandPct) {
+    _marked = true;
+    _markUs = _s.timeUs;
+    _target = target;
+    _band = fabsf(target) * settleBandPct / 100.0f;
+    _peak = _s.vout;
+    _trough = _s.vout;
+    _lastOutsideUs = _s.timeUs;
+    _everInside = false;
+    _energyIn = 0.0;
+    _energyOut = 0.0;
+}
+
+PlantMetrics HostPlant::metrics() const {
+    PlantMetrics m;
+    m.target = _target;
+    m.finalVout = _s.vout;
+    m.peakVout = _peak;
+    m.minVout = _trough;
+    m.overshootPct = (_target > 0.0f && _peak > _target) ? (_peak - _target) / _target * 100.0f : 0.0f;
+    bool settled = _marked && _everInside && fabsf(_s.vout - _target) <= _band;
+    m.settleMs = settled ? (_lastOutsideUs - _markUs) / 1000.0f : -1.0f;
+    m.efficiency = _energyIn > 0.0 ? (float)(_energyOut / _energyIn) : 0.0f;
+    float lo = _tail[0];
+    float hi = _tail[0];
+    for (float v : _tail) {
+        lo = std::min(lo, v);
+        hi = std::max(hi, v);
+    }
+    m.rippleV = hi - lo;
+    return m;
+}
+
+bool HostPlant::openTrace(const char *path, uint32_t decimationUs) {
+    if (_trace) {
+        fclose(_trace);
+        _trace = NULL;
+    }
+    if (path == NULL) {
+        return true;
+    }
+    _trace = fopen(path, "w");
+    if (_trace == NULL) {
+        return false;
+    }
+    _traceDecimationUs = decimationUs > 0 ? decimationUs : _p.stepUs;
+    _nextTraceUs = _s.timeUs;
+    fprintf(_trace, "t_ms,vref,vout,il,iload,vin,iin,duty\n");
+    record();
+    return true;
+}
+
+void HostPlant::record() {
+    if (_trace == NULL || _s.timeUs < _nextTraceUs) {
+        return;
+    }
+    _nextTraceUs = _s.timeUs + _traceDecimationUs;
+    fprintf(_trace, "%.3f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n", _s.timeUs / 1000.0, _s.vref, _s.vout,
+            _s.il, _s.iload, _s.vin, _s.iin, _s.duty);
+}
+
+static void clockHook(uint64_t fromUs, uint64_t toUs) {
+    (void)fromUs;
+    if (s_attached) {
+        s_attached->advanceTo(toUs);
+    }
+}
+
+void HostPlant::attachToClock() {
+    _s.timeUs = host_micros();
+    s_attached = this;
+    host_set_clock_hook(clockHook);
+    publishAdc();
+}
+
+void HostPlant::detachFromClock() {
+    if (s_attached == this) {
+        s_attached = NULL;
+        host_set_clock_hook(NULL);
+    }
+}
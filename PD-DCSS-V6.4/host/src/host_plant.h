@@ -0,0 +1,176 @@
+/**
+ * @file host_plant.h
+ * @brief 降压变换器的离散时间仿真模型，用于在主机上测试稳压、软启动和保护逻辑
+ * @details
+ * 平均值模型（不模拟开关纹波），按固定步长积分：
+ * - 基准：DAC输出（由SPI最后发送的TLC5615数据解码）乘以 refGain，经RC滤波（软启动）；
+ * - 控制器：平均电流模式。外环PI把输出电压误差换算为电感电流指令，
+ *   内环让电感电流以 currentLoopHz 的带宽跟踪指令，限流 currentLimit；
+ *   开关节点电压受 dutyMax * Vin 限制，输入电压过低时进入压降状态；
+ * - 功率级：LC滤波器，电感带直流电阻；非同步整流时电感电流不小于0；
+ * - 负载：电阻、恒流，可按时间安排阶跃；
+ * - 输入源：空载电压、源内阻，以及按时间安排的跌落。
+ * 每次推进结束后把 U_IN/I_IN/U_OUT/I_OUT 写入HAL的ADC通道（毫伏），
+ * 比例与固件校准系数为1时一致（1V对应1000mV）。
+ *
+ * 模型可以单独运行（plant_sim 扫描大量场景），也可以挂到虚拟时钟上与固件任务一起运行
+ * （host_runner 的 plant 命令）。步长默认1us，1秒仿真在主机上约几十毫秒。
+ */
+
+#ifndef HOST_PLANT_H
+#define HOST_PLANT_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+#define PLANT_RIPPLE_WINDOW_US 1000   // 纹波统计窗口
+
+struct PlantParams {
+    // 输入源
+    float vinOpen;            // 空载输入电压(V)
+    float sourceResistance;   // 源内阻(Ω)
+
+    // 功率级
+    float inductance;         // 电感(H)
+    float inductorResistance; // 电感直流电阻(Ω)
+    float capacitance;        // 输出电容(F)
+    float dutyMax;            // 最大占空比
+    bool diodeRectifier;      // 非同步整流：电感电流不能为负
+
+    // 控制器
+    float refGain;            // 输出电压基准 = DAC电压 * refGain
+    float refTauS;            // 基准RC滤波时间常数(s)，即软启动
+    float voltageKp;          // 外环比例系数(A/V)
+    float voltageKi;          // 外环积分系数(A/(V·s))
+    float currentLoopHz;      // 内环带宽(Hz)
+    float currentLimit;       // 电感电流限值(A)
+
+    // 损耗
+    float switchingLossW;     // 开关损耗(W)，有输出电流时计入
+    float quiescentCurrent;   // 静态电流(A)
+
+    // 采样
+    float adcMvPerUnit[4];    // U_IN/I_IN/U_OUT/I_OUT 每伏（或每安）对应的ADC毫伏数
+    uint32_t stepUs;          // 积分步长(us)
+};
+
+// 默认参数：12V输入，22uH/220uF，电流环20kHz、电压环约5kHz
+PlantParams plantDefaultParams();
+
+enum PlantLoadKind {
+    PLANT_LOAD_RESISTIVE = 0,   // 值为电阻(Ω)，<=0表示开路
+    PLANT_LOAD_CONSTANT_CURRENT, // 值为电流(A)
+};
+
+// 某一时刻的模型状态
+struct PlantState {
+    uint64_t timeUs;
+    float vref;      // 滤波后的输出电压基准(V)
+    float vout;      // 输出电压(V)
+    float il;        // 电感电流(A)
+    float iload;     // 负载电流(A)
+    float vin;       // 输入端电压(V)
+    float iin;       // 输入电流(A)
+    float duty;      // 占空比
+};
+
+// 测量窗口内的指标（从 mark() 开始统计）
+struct PlantMetrics {
+    float target;          // 目标电压(V)
+    float finalVout;       // 当前输出电压(V)
+    float peakVout;        // 最高输出电压(V)
+    float minVout;         // 最低输出电压(V)
+    float overshootPct;    // 超调量（相对目标，%），未超过目标为0
+    float settleMs;        // 最后一次进入并保持在目标±settleBand内的时刻（相对mark），未稳定为-1
+    float efficiency;      // 窗口内输出能量/输入能量
+    float rippleV;         // 最近 PLANT_RIPPLE_WINDOW_US 内输出电压的峰峰值(V)（平均值模型中只有低频波动）
+};
+
+class HostPlant {
+public:
+    explicit HostPlant(const PlantParams &params);
+    ~HostPlant();
+
+    const PlantParams &params() const { return _p; }
+    const PlantState &state() const { return _s; }
+
+    // 负载和输入源，立即生效或在指定时刻生效
+    void setLoad(PlantLoadKind kind, float value);
+    void scheduleLoad(uint64_t atUs, PlantLoadKind kind, float value);
+    void scheduleSag(uint64_t atUs, uint32_t durationUs, float dropV);
+
+    /**
+     * @brief 直接给定DAC电压，不再从SPI解码（单独运行模型时使用）
+     * @param volts DAC输出电压，小于0时恢复从SPI解码
+     */
+    void overrideDac(float volts);
+
+    /**
+     * @brief 从当前时间积分到 toUs，然后更新ADC通道
+     */
+    void advanceTo(uint64_t toUs);
+
+    /**
+     * @brief 开始一个测量窗口，此后的超调、稳定时间和效率相对 target 统计
+     * @param settleBandPct 稳定带宽（相对目标的百分比）
+     */
+    void mark(float target, float settleBandPct = 2.0f);
+    PlantMetrics metrics() const;
+
+    /**
+     * @brief 输出CSV波形，每 decimationUs 记录一行；path为NULL时关闭
+     * @return 文件打开成功返回true
+     */
+    bool openTrace(const char *path, uint32_t decimationUs);
+
+    // 挂到虚拟时钟：时钟前进时自动积分（同一时间只能挂一个模型）
+    void attachToClock();
+    void detachFromClock();
+
+private:
+    struct Event {
+        uint64_t atUs;
+        bool isSag;
+        PlantLoadKind kind;
+        float value;         // 负载值或跌落电压
+        uint32_t durationUs; // 跌落持续时间
+    };
+
+    PlantParams _p;
+    PlantState _s;
+    PlantLoadKind _loadKind;
+    float _loadValue;
+    float _sagV;
+    uint64_t _sagEndUs;
+    float _dacOverride;
+    float _integrator;
+    std::vector<Event> _events;
+
+    // 测量窗口
+    bool _marked;
+    uint64_t _markUs;
+    float _target;
+    float _band;
+    float _peak;
+    float _trough;
+    uint64_t _lastOutsideUs;
+    bool _everInside;
+    double _energyIn;
+    double _energyOut;
+    std::vector<float> _tail;   // 最近的输出电压（每步一个，环形），用于纹波
+    size_t _tailPos;
+
+    FILE *_trace;
+    uint32_t _traceDecimationUs;
+    uint64_t _nextTraceUs;
+
+    float dacVoltage() const;
+    float loadCurrent(float vout) const;
+    void applyEvents();
+    void step(float dt);
+    void record();
+    void publishAdc();
+};
+
+#endif // HOST_PLANT_H
@@ -0,0 +1,240 @@
+/**
+ * @file host_png.c
+ * @brief 最小PNG读写
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_png.h"
+
+#define PNG_STORED_MAX 65535
+
+static uint32_t s_crcTable[256];
+static int s_crcReady = 0;
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t *buf, size_t len) {
+    if (!s_crcReady) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            s_crcTable[n] = c;
+        }
+        s_crcReady = 1;
+    }
+    for (size_t i = 0; i < len; i++) {
+        crc = s_crcTable[(crc ^ buf[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static uint32_t get32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static int writeChunk(FILE *f, const char *type, const uint8_t *data, uint32_t len) {
+    uint8_t hdr[8];
+    uint8_t tail[4];
+    put32(hdr, len);
+    memcpy(hdr + 4, type, 4);
+    uint32_t crc = crc32Update(0xffffffffu, hdr + 4, 4);
+    crc = crc32Update(crc, data, len) ^ 0xffffffffu;
+    put32(tail, crc);
+    if (fwrite(hdr, 1, 8, f) != 8) return -1;
+    if (len > 0 && fwrite(data, 1, len, f) != len) return -1;
+    if (fwrite(tail, 1, 4, f) != 4) return -1;
+    return 0;
+}
+
+void host_rgb565_to_rgb888(const uint16_t *pixels, uint8_t *rgb, int count) {
+    for (int i = 0; i < count; i++) {
+        uint16_t c = pixels[i];
+        uint8_t r = (uint8_t)((c >> 11) & 0x1f);
+        uint8_t g = (uint8_t)((c >> 5) & 0x3f);
+        uint8_t b = (uint8_t)(c & 0x1f);
+        rgb[i * 3 + 0] = (uint8_t)((r << 3) | (r >> 2));
+        rgb[i * 3 + 1] = (uint8_t)((g << 2) | (g >> 4));
+        rgb[i * 3 + 2] = (uint8_t)((b << 3) | (b >> 2));
+    }
+}
+
+int host_png_write_rgb888(const char *path, const uint8_t *rgb, int w, int h) {
+    static const uint8_t sig[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    size_t rowBytes = (size_t)w * 3 + 1;
+    size_t rawLen = rowBytes * h;
+    size_t blocks = (rawLen + PNG_STORED_MAX - 1) / PNG_STORED_MAX;
+    size_t zlen = 2 + blocks * 5 + rawLen + 4;
+
+    uint8_t *z = (uint8_t *)malloc(zlen);
+    if (z == NULL) {
+        return -1;
+    }
+
+    // zlib头 + stored块；扫描行前加过滤类型0
+    size_t pos = 0;
+    z[pos++] = 0x78;
+    z[pos++] = 0x01;
+    uint32_t s1 = 1, s2 = 0;
+    size_t rawPos = 0;
+    size_t blockLeft = 0;
+    for (int y = 0; y < h; y++) {
+        for (size_t i = 0; i < rowBytes; i++) {
+            if (blockLeft == 0) {
+                size_t n = rawLen - rawPos;
+                if (n > PNG_STORED_MAX) n = PNG_STORED_MAX;
+                z[pos++] = (rawPos + n == rawLen) ? 1 : 0;
+                z[pos++] = (uint8_t)n;
+                z[pos++] = (uint8_t)(n >> 8);
+                z[pos++] = (uint8_t)~n;
+                z[pos++] = (uint8_t)(~n >> 8);
+                blockLeft = n;
+            }
+            uint8_t byte = (i == 0) ? 0 : rgb[((size_t)y * w) * 3 + (i - 1)];
+            z[pos++] = byte;
+            s1 = (s1 + byte) % 65521;
+            s2 = (s2 + s1) % 65521;
+            rawPos++;
+            blockLeft--;
+        }
+    }
+    put32(z + pos, (s2 << 16) | s1);
+    pos += 4;
+
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        free(z);
+        return -1;
+    }
+
+    uint8_t ihdr[13];
+    put32(ihdr, (uint32_t)w);
+    put32(ihdr + 4, (uint32_t)h);
+    ihdr[8] = 8;  // 位深
+    ihdr[9] = 2;  // RGB
+    ihdr[10] = 0;
+    ihdr[11] = 0;
+    ihdr[12] = 0;
+
+    int err = 0;
+    if (fwrite(sig, 1, 8, f) != 8) err = -1;
+    if (!err) err = writeChunk(f, "IHDR", ihdr, 13);
+    if (!err) err = writeChunk(f, "IDAT", z, (uint32_t)pos);
+    if (!err) err = writeChunk(f, "IEND", NULL, 0);
+
+    fclose(f);
+    free(z);
+    return err;
+}
+
+int host_png_write_rgb565(const char *path, const uint16_t *pixels, int w, int h) {
+    uint8_t *rgb = (uint8_t *)malloc((size_t)w * h * 3);
+    if (rgb == NULL) {
+        return -1;
+    }
+    host_rgb565_to_rgb888(pixels, rgb, w * h);
+    int err = host_png_write_rgb888(path, rgb, w, h);
+    free(rgb);
+    return err;
+}
+
+int host_png_read_rgb888(const char *path, uint8_t **rgb, int *w, int *h) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return -1;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *file = (uint8_t *)malloc((size_t)size);
+    if (file == NULL || fread(file, 1, (size_t)size, f) != (size_t)size) {
+        fclose(f);
+        free(file);
+        return -1;
+    }
+    fclose(f);
+
+    int err = -1;
+    uint8_t *z = NULL;
+    size_t zlen = 0;
+    uint8_t *out = NULL;
+    int width = 0, height = 0;
+
+    // 收集所有IDAT数据
+    long pos = 8;
+    while (pos + 12 <= size) {
+        uint32_t len = get32(file + pos);
+        const uint8_t *type = file + pos + 4;
+        const uint8_t *data = file + pos + 8;
+        if (pos + 12 + (long)len > size) break;
+        if (memcmp(type, "IHDR", 4) == 0) {
+            width = (int)get32(data);
+            height = (int)get32(data + 4);
+            if (data[8] != 8 || data[9] != 2 || data[12] != 0) goto done;
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            uint8_t *nz = (uint8_t *)realloc(z, zlen + len);
+            if (nz == NULL) goto done;
+            z = nz;
+            memcpy(z + zlen, data, len);
+            zlen += len;
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        pos += 12 + (long)len;
+    }
+    if (width <= 0 || height <= 0 || zlen < 2) goto done;
+
+    // 解析stored块，还原扫描行
+    {
+        size_t rowBytes = (size_t)width * 3 + 1;
+        size_t rawLen = rowBytes * height;
+        uint8_t *raw = (uint8_t *)malloc(rawLen);
+        if (raw == NULL) goto done;
+        size_t zp = 2, rp = 0;
+        int last = 0;
+        while (!last && zp + 5 <= zlen) {
+            uint8_t bh = z[zp];
+            if ((bh & 0x06) != 0) break;  // 不是stored块
+            last = bh & 1;
+            size_t n = z[zp + 1] | ((size_t)z[zp + 2] << 8);
+            zp += 5;
+            if (zp + n > zlen || rp + n > rawLen) break;
+            memcpy(raw + rp, z + zp, n);
+            zp += n;
+            rp += n;
+        }
+        if (rp == rawLen) {
+            out = (uint8_t *)malloc((size_t)width * height * 3);
+            if (out != NULL) {
+                int ok = 1;
+                for (int y = 0; y < height; y++) {
+                    if (raw[y * rowBytes] != 0) { ok = 0; break; }
+                    memcpy(out + (size_t)y * width * 3, raw + y * rowBytes + 1, (size_t)width * 3);
+                }
+                if (ok) {
+                    *rgb = out;
+                    *w = width;
+                    *h = height;
+                    out = NULL;
+                    err = 0;
+                }
+            }
+        }
+        free(raw);
+    }
+
+done:
+    free(out);
+    free(z);
+    free(file);
+    return err;
+}
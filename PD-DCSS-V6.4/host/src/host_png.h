@@ -0,0 +1,33 @@
+/**
+ * @file host_png.h
+ * @brief 最小PNG读写，用于保存渲染帧和比较基准图
+ * @details 只使用未压缩（stored）的deflate块，不依赖zlib。
+ * 读取函数只支持本模块写出的格式（8位RGB、无隔行）。
+ */
+
+#ifndef HOST_PNG_H
+#define HOST_PNG_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 把RGB565帧缓冲保存为8位RGB的PNG，成功返回0
+int host_png_write_rgb565(const char *path, const uint16_t *pixels, int w, int h);
+
+// 保存8位RGB数据，成功返回0
+int host_png_write_rgb888(const char *path, const uint8_t *rgb, int w, int h);
+
+// 读取PNG为8位RGB数据（调用者负责free），成功返回0
+int host_png_read_rgb888(const char *path, uint8_t **rgb, int *w, int *h);
+
+// RGB565展开为8位RGB（高位复制到低位，与LVGL的 lv_color_to32 一致）
+void host_rgb565_to_rgb888(const uint16_t *pixels, uint8_t *rgb, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_PNG_H
@@ -0,0 +1,664 @@
+/**
+ * @file host_runner.cpp
+ * @brief 主机UI场景运行器：按脚本驱动固件UI，保存帧并与基准图比较
+ * @details
+ * 运行固件的 setup()（创建的任务先不运行），然后逐行执行场景脚本：
+ *   adc <U_IN> <I_IN> <U_OUT> <I_OUT>   设置ADC读数(V/A)，执行一次采样和 updateDisplay()
+ *   uset <V> [unconfirmed] [coarse]     调用 updateUSetDisplay()
+ *   state on|off                         调用 updateButtonState()
+ *   step <ms>                            推进虚拟时间，期间按固件节奏调用 handle_lvgl_tasks()
+ *   frame <name>                         渲染并保存一帧，与基准图比较
+ * 以下命令运行固件的完整任务图（main.cpp 和各库创建的任务，以及调用 loop() 的 loopTask），
+ * 由主机调度器按优先级在虚拟时钟上确定性地执行：
+ *   run <ms>                             运行全部任务 ms 毫秒
+ *   gpio <pin> 0|1                       设置引脚电平，触发已登记的中断
+ *   encoder <steps>                      按正交序列转动编码器，负数反向，每格之后运行任务
+ *   press state|confirm|step [ms]        按下按钮保持 ms 毫秒（默认100）后松开，期间运行任务
+ *                                        （step 保持800ms以上为长按，切换编辑U_SET/I_SET）
+ *   expect uset|dac <V>                  检查系统状态中的设定值或DAC目标电压（误差0.005V）
+ *   expect iset <A>                      检查系统状态中的限流设定值（误差0.005A）
+ *   expect mode cv|cc                    检查限流回路的工作模式
+ *   expect output on|off                 检查系统状态中的输出开关
+ *   expect spi <word>                    检查SPI最后发送的16位数据（可用0x前缀）
+ * 以下命令把降压变换器模型（host_plant.h）挂到虚拟时钟上，由DAC的SPI输出驱动，
+ * 模型的输入/输出电压和电流写入ADC通道（代替 adc 命令），形成闭环：
+ *   plant start [Vin]                    创建模型（默认12V输入）并开始跟随虚拟时钟
+ *   plant load res|cc <value>            立即切换负载：电阻(Ω，0为开路)或恒流(A)
+ *   plant sag <V> <ms>                   输入电压立即跌落V伏，持续ms毫秒
+ *   plant mark <V> [band%]               以V为目标开始统计超调、稳定时间和效率
+ *   plant trace <file> [us]              输出CSV波形，每us微秒一行（默认100）
+ *   expect vout <V>                      检查模型输出电压（误差0.02V）
+ *   expect overshoot|settle <max>        检查 mark 以来的超调(%)或稳定时间(ms)不超过max
+ * 输出保护（myProtection.h）：
+ *   protect ovp|ocp|uvlo|opp <value>     修改一个保护阈值(V/A/V/W)
+ *   expect alarm none|ovp|ocp|uvlo|opp   检查系统状态中锁存的告警
+ *   expect trip <us>                     检查最近一次触发的延迟（采样到DAC写0）不超过us
+ * 波形捕获（myCapture.h）：
+ *   capture arm uout|iout rise|fall|any|step|none <level>   按默认深度和采样率开始一次捕获
+ *   capture scope                        切换示波器屏幕（下一次UI刷新时生效）
+ *   expect capture idle|armed|done|failed   检查捕获状态
+ * 每帧报告增量渲染耗时、刷屏像素数和整屏重绘的平均耗时（主机真实时间）。
+ *
+ * 返回值：0 全部通过；1 有帧与基准图不一致、缺少基准图、超出耗时预算或检查失败；
+ *         2 参数或脚本错误。
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <chrono>
+
+#include <Arduino.h>
+#include "myTFT.h"
+#include "myADC.h"
+#include "myEncoder.h"
+#include "myEncoderUI.h"
+#include "mySystemState.h"
+#include "myProtection.h"
+#include "myCapture.h"
+#include "myScreens.h"
+#include "host_stubs.h"
+#include "host_png.h"
+#include "host_plant.h"
+
+#define RUNNER_EXIT_OK 0
+#define RUNNER_EXIT_FAIL 1
+#define RUNNER_EXIT_USAGE 2
+
+#define RUNNER_LINE_MAX 256
+#define RUNNER_PATH_MAX 512
+
+// 与 src/main.cpp 中的引脚定义一致
+#define RUNNER_BUTTON_STATE_PIN 19
+#define RUNNER_ENCODER_PIN_A 16
+#define RUNNER_ENCODER_PIN_B 17
+#define RUNNER_CONFIRM_BUTTON_PIN 21
+#define RUNNER_STEP_SWITCH_PIN 45
+
+#define RUNNER_ENCODER_EDGE_MS 1      // 正交信号相邻边沿的间隔
+#define RUNNER_ENCODER_DETENT_MS 20   // 每转一格之后运行任务的时间
+#define RUNNER_PRESS_MS 100           // 按钮默认按住时间
+#define RUNNER_EXPECT_TOLERANCE 0.005f
+#define RUNNER_VOUT_TOLERANCE 0.02f
+#define RUNNER_TRACE_US 100
+
+// 定义在 src/main.cpp
+void setup();
+void loop();
+void updateDisplay();
+void updateButtonState(bool is_on);
+extern MyADC *adc;
+extern myEncoder encoder;
+
+struct RunnerOptions {
+    const char *script;
+    const char *goldenDir;
+    const char *outDir;
+    const char *timingCsv;
+    bool updateGolden;
+    bool verbose;
+    int tolerance;       // 每通道允许的差值
+    int repeat;          // 整屏重绘计时次数
+    double budgetMs;     // 整屏重绘平均耗时上限，0表示不检查
+};
+
+struct RunnerResult {
+    int frames;
+    int failed;
+    int missing;
+    int checks;
+    int checksFailed;
+};
+
+static int64_t nowUs() {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static int makeDirs(const char *path) {
+    char buf[RUNNER_PATH_MAX];
+    snprintf(buf, sizeof(buf), "%s", path);
+    for (char *p = buf + 1; *p; p++) {
+        if (*p == '/') {
+            *p = 0;
+            if (mkdir(buf, 0755) != 0 && errno != EEXIST) return -1;
+            *p = '/';
+        }
+    }
+    if (mkdir(buf, 0755) != 0 && errno != EEXIST) return -1;
+    return 0;
+}
+
+static HostPlant *s_plant = NULL;
+
+// 在虚拟时间内按UI任务的节奏运行LVGL
+static void runFor(uint32_t ms) {
+    uint32_t end = millis() + ms;
+    while ((int32_t)(end - millis()) > 0) {
+        handle_lvgl_tasks();
+    }
+}
+
+// Arduino核心的loopTask：反复调用 loop()
+static void loopTaskEntry(void *) {
+    while (true) {
+        loop();
+    }
+}
+
+// 运行固件任务图；第一次运行时创建loopTask（优先级1，与Arduino-ESP32一致）
+static void runTasks(uint32_t ms) {
+    static bool loopTaskCreated = false;
+    if (!loopTaskCreated) {
+        xTaskCreate(loopTaskEntry, "loopTask", 8192, NULL, 1, NULL);
+        loopTaskCreated = true;
+    }
+    host_run_tasks(ms);
+}
+
+// 转动编码器一格：A、B两相各翻转两次；正向时B相先变，与固件的状态表一致
+static void turnEncoder(bool forward) {
+    uint8_t first = forward ? RUNNER_ENCODER_PIN_B : RUNNER_ENCODER_PIN_A;
+    uint8_t second = forward ? RUNNER_ENCODER_PIN_A : RUNNER_ENCODER_PIN_B;
+    uint8_t order[4] = {first, second, first, second};
+    for (int i = 0; i < 4; i++) {
+        host_set_gpio(order[i], !digitalRead(order[i]));
+        runTasks(RUNNER_ENCODER_EDGE_MS);
+    }
+}
+
+static void reportCheck(RunnerResult *res, bool ok, const char *what, const char *expected, const char *actual) {
+    res->checks++;
+    if (!ok) {
+        res->checksFailed++;
+    }
+    printf("expect %-14s %-10s actual %-10s %s\n", what, expected, actual, ok ? "ok" : "FAIL");
+}
+
+static bool runExpect(const RunnerOptions &opt, int lineNo, char **argv, int argc, RunnerResult *res) {
+    SystemState s;
+    systemState.snapshot(s);
+    char actual[32];
+
+    if ((strcmp(argv[1], "uset") == 0 || strcmp(argv[1], "dac") == 0) && argc == 3) {
+        float expected = (float)atof(argv[2]);
+        float value = strcmp(argv[1], "uset") == 0 ? s.uSet : s.dacVoltage;
+        snprintf(actual, sizeof(actual), "%.3f", value);
+        reportCheck(res, fabsf(value - expected) <= RUNNER_EXPECT_TOLERANCE, argv[1], argv[2], actual);
+        return true;
+    }
+    if (strcmp(argv[1], "iset") == 0 && argc == 3) {
+        float expected = (float)atof(argv[2]);
+        snprintf(actual, sizeof(actual), "%.3f", s.iSet);
+        reportCheck(res, fabsf(s.iSet - expected) <= RUNNER_EXPECT_TOLERANCE, argv[1], argv[2], actual);
+        return true;
+    }
+    if (strcmp(argv[1], "mode") == 0 && argc == 3) {
+        const char *mode = s.mode == SYS_MODE_CC ? "cc" : "cv";
+        snprintf(actual, sizeof(actual), "%s", mode);
+        reportCheck(res, strcmp(mode, argv[2]) == 0, argv[1], argv[2], actual);
+        return true;
+    }
+    if (strcmp(argv[1], "alarm") == 0 && argc == 3) {
+        uint32_t alarms = s.alarms & PROT_ALARM_MASK;
+        char name[8];
+        snprintf(name, sizeof(name), "%s", alarms ? MyProtection::alarmName(alarms) : "none");
+        for (char *p = name; *p; p++) {
+            *p = (char)tolower(*p);
+        }
+        snprintf(actual, sizeof(actual), "%s", name);
+        reportCheck(res, strcmp(name, argv[2]) == 0, argv[1], argv[2], actual);
+        return true;
+    }
+    if (strcmp(argv[1], "trip") == 0 && argc == 3) {
+        uint32_t maxUs = (uint32_t)atoi(argv[2]);
+        snprintf(actual, sizeof(actual), "%uus", protection.getLastLatencyUs());
+        reportCheck(res, protection.getTripCount() > 0 && protection.getLastLatencyUs() <= maxUs, argv[1], argv[2], actual);
+        return true;
+    }
+    if (strcmp(argv[1], "output") == 0 && argc == 3) {
+        bool expected = strcmp(argv[2], "on") == 0;
+        snprintf(actual, sizeof(actual), "%s", s.outputEnabled ? "on" : "off");
+        reportCheck(res, s.outputEnabled == expected, argv[1], argv[2], actual);
+        return true;
+    }
+    if (strcmp(argv[1], "spi") == 0 && argc == 3) {
+        uint16_t expected = (uint16_t)strtoul(argv[2], NULL, 0);
+        uint16_t word = host_spi_last_word();
+        snprintf(actual, sizeof(actual), "0x%04x", word);
+        reportCheck(res, word == expected, argv[1], argv[2], actual);
+        return true;
+    }
+    bool plantCheck = strcmp(argv[1], "vout") == 0 || strcmp(argv[1], "overshoot") == 0 ||
+                      strcmp(argv[1], "settle") == 0;
+    if (plantCheck && argc == 3) {
+        if (s_plant == NULL) {
+            fprintf(stderr, "%s:%d: 需要先执行 plant start\n", opt.script, lineNo);
+            return false;
+        }
+        float expected = (float)atof(argv[2]);
+        PlantMetrics m = s_plant->metrics();
+        bool ok;
+        if (strcmp(argv[1], "vout") == 0) {
+            snprintf(actual, sizeof(actual), "%.3f", m.finalVout);
+            ok = fabsf(m.finalVout - expected) <= RUNNER_VOUT_TOLERANCE;
+        } else if (strcmp(argv[1], "overshoot") == 0) {
+            snprintf(actual, sizeof(actual), "%.2f%%", m.overshootPct);
+            ok = m.overshootPct <= expected;
+        } else {
+            snprintf(actual, sizeof(actual), "%.2fms", m.settleMs);
+            ok = m.settleMs >= 0.0f && m.settleMs <= expected;
+        }
+        reportCheck(res, ok, argv[1], argv[2], actual);
+        return true;
+    }
+
+    if (strcmp(argv[1], "capture") == 0 && argc == 3) {
+        static const char *const STATES[] = {"idle", "armed", "done", "failed"};
+        snprintf(actual, sizeof(actual), "%s", STATES[capture.state() & 3]);
+        reportCheck(res, strcmp(actual, argv[2]) == 0, argv[1], argv[2], actual);
+        return true;
+    }
+
+    fprintf(stderr, "%s:%d: 无法识别的检查 '%s'\n", opt.script, lineNo, argv[1]);
+    return false;
+}
+
+static bool runCapture(const RunnerOptions &opt, int lineNo, char **argv, int argc) {
+    if (strcmp(argv[1], "scope") == 0 && argc == 2) {
+        if (screens.isActive("scope")) {
+            screens.requestHome();
+        } else {
+            screens.request("scope");
+        }
+        return true;
+    }
+    if (strcmp(argv[1], "arm") == 0 && argc == 5) {
+        static const char *const EDGES[] = {"none", "rise", "fall", "any", "step"};
+        CaptureConfig cfg = captureDefaultConfig();
+        if (strcmp(argv[2], "uout") == 0) cfg.source = CAPTURE_U_OUT;
+        else if (strcmp(argv[2], "iout") == 0) cfg.source = CAPTURE_I_OUT;
+        else {
+            fprintf(stderr, "%s:%d: 未知通道 '%s'\n", opt.script, lineNo, argv[2]);
+            return false;
+        }
+        int edge = -1;
+        for (int i = 0; i < 5; i++) {
+            if (strcmp(argv[3], EDGES[i]) == 0) edge = i;
+        }
+        if (edge < 0) {
+            fprintf(stderr, "%s:%d: 未知触发边沿 '%s'\n", opt.script, lineNo, argv[3]);
+            return false;
+        }
+        cfg.edge = (uint8_t)edge;
+        cfg.level = (float)atof(argv[4]);
+        if (!capture.arm(cfg)) {
+            fprintf(stderr, "%s:%d: 无法开始捕获\n", opt.script, lineNo);
+            return false;
+        }
+        return true;
+    }
+    fprintf(stderr, "%s:%d: 无法识别的捕获命令 '%s'\n", opt.script, lineNo, argv[1]);
+    return false;
+}
+
+static bool runPlant(const RunnerOptions &opt, int lineNo, char **argv, int argc) {
+    if (strcmp(argv[1], "start") == 0 && argc <= 3) {
+        PlantParams p = plantDefaultParams();
+        if (argc == 3) {
+            p.vinOpen = (float)atof(argv[2]);
+        }
+        delete s_plant;
+        s_plant = new HostPlant(p);
+        s_plant->attachToClock();
+        return true;
+    }
+    if (s_plant == NULL) {
+        fprintf(stderr, "%s:%d: 需要先执行 plant start\n", opt.script, lineNo);
+        return false;
+    }
+    if (strcmp(argv[1], "load") == 0 && argc == 4) {
+        bool cc = strcmp(argv[2], "cc") == 0;
+        if (!cc && strcmp(argv[2], "res") != 0) {
+            fprintf(stderr, "%s:%d: 未知负载类型 '%s'\n", opt.script, lineNo, argv[2]);
+            return false;
+        }
+        s_plant->setLoad(cc ? PLANT_LOAD_CONSTANT_CURRENT : PLANT_LOAD_RESISTIVE, (float)atof(argv[3]));
+        return true;
+    }
+    if (strcmp(argv[1], "sag") == 0 && argc == 4) {
+        s_plant->scheduleSag(host_micros(), (uint32_t)(atof(argv[3]) * 1000.0), (float)atof(argv[2]));
+        return true;
+    }
+    if (strcmp(argv[1], "mark") == 0 && (argc == 3 || argc == 4)) {
+        s_plant->mark((float)atof(argv[2]), argc == 4 ? (float)atof(argv[3]) : 2.0f);
+        return true;
+    }
+    if (strcmp(argv[1], "trace") == 0 && (argc == 3 || argc == 4)) {
+        uint32_t us = argc == 4 ? (uint32_t)atoi(argv[3]) : RUNNER_TRACE_US;
+        if (!s_plant->openTrace(argv[2], us)) {
+            fprintf(stderr, "%s:%d: 无法创建 %s\n", opt.script, lineNo, argv[2]);
+            return false;
+        }
+        return true;
+    }
+
+    fprintf(stderr, "%s:%d: 无法识别的模型命令 '%s'\n", opt.script, lineNo, argv[1]);
+    return false;
+}
+
+// 与基准图比较，返回超出容差的像素数；不一致时输出差异图
+static long compareGolden(const RunnerOptions &opt, const char *name, const uint8_t *actual, int w, int h,
+                          bool *missing) {
+    char path[RUNNER_PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s.png", opt.goldenDir, name);
+
+    uint8_t *golden = NULL;
+    int gw = 0, gh = 0;
+    if (host_png_read_rgb888(path, &golden, &gw, &gh) != 0) {
+        *missing = true;
+        return 0;
+    }
+    *missing = false;
+    if (gw != w || gh != h) {
+        free(golden);
+        return (long)w * h;
+    }
+
+    uint8_t *diff = (uint8_t *)malloc((size_t)w * h * 3);
+    long bad = 0;
+    for (int i = 0; i < w * h; i++) {
+        int maxd = 0;
+        for (int c = 0; c < 3; c++) {
+            int d = abs((int)actual[i * 3 + c] - (int)golden[i * 3 + c]);
+            if (d > maxd) maxd = d;
+        }
+        bool over = maxd > opt.tolerance;
+        if (over) bad++;
+        if (diff) {
+            // 不一致的像素标红，其余像素变暗显示
+            diff[i * 3 + 0] = over ? 0xff : actual[i * 3 + 0] / 4;
+            diff[i * 3 + 1] = over ? 0x00 : actual[i * 3 + 1] / 4;
+            diff[i * 3 + 2] = over ? 0x00 : actual[i * 3 + 2] / 4;
+        }
+    }
+    if (bad > 0 && diff) {
+        snprintf(path, sizeof(path), "%s/%s.diff.png", opt.outDir, name);
+        host_png_write_rgb888(path, diff, w, h);
+    }
+    free(diff);
+    free(golden);
+    return bad;
+}
+
+static bool renderFrame(const RunnerOptions &opt, const char *name, RunnerResult *res, FILE *csv) {
+    const int w = tft.width();
+    const int h = tft.height();
+
+    // 增量渲染：只重绘脚本操作造成的脏区域
+    tft.resetStats();
+    int64_t t0 = nowUs();
+    lv_refr_now(NULL);
+    int64_t dirtyUs = nowUs() - t0;
+    uint32_t flushedPx = tft.pixelsPushed();
+
+    uint8_t *rgb = (uint8_t *)malloc((size_t)w * h * 3);
+    if (rgb == NULL) {
+        return false;
+    }
+    host_rgb565_to_rgb888(tft.framebuffer(), rgb, w * h);
+
+    // 整屏重绘耗时，多次取平均
+    int64_t fullTotal = 0;
+    for (int i = 0; i < opt.repeat; i++) {
+        lv_obj_invalidate(lv_scr_act());
+        int64_t f0 = nowUs();
+        lv_refr_now(NULL);
+        fullTotal += nowUs() - f0;
+    }
+    double fullMs = opt.repeat > 0 ? (double)fullTotal / opt.repeat / 1000.0 : 0.0;
+
+    char path[RUNNER_PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s.png", opt.outDir, name);
+    host_png_write_rgb888(path, rgb, w, h);
+
+    const char *status = "ok";
+    bool failed = false;
+    long badPx = 0;
+    if (opt.updateGolden) {
+        snprintf(path, sizeof(path), "%s/%s.png", opt.goldenDir, name);
+        if (host_png_write_rgb888(path, rgb, w, h) != 0) {
+            fprintf(stderr, "无法写入基准图 %s\n", path);
+            failed = true;
+            status = "error";
+        } else {
+            status = "updated";
+        }
+    } else {
+        bool missing = false;
+        badPx = compareGolden(opt, name, rgb, w, h, &missing);
+        if (missing) {
+            res->missing++;
+            status = "no-golden";
+        } else if (badPx > 0) {
+            failed = true;
+            status = "mismatch";
+        }
+    }
+
+    if (opt.budgetMs > 0 && fullMs > opt.budgetMs) {
+        status = badPx > 0 ? "mismatch+slow" : "slow";
+        failed = true;
+    }
+
+    printf("frame %-20s dirty %7.3f ms  flushed %6u px  full %7.3f ms  %s",
+           name, dirtyUs / 1000.0, (unsigned)flushedPx, fullMs, status);
+    if (badPx > 0) {
+        printf(" (%ld px)", badPx);
+    }
+    printf("\n");
+
+    if (csv) {
+        fprintf(csv, "%s,%.3f,%u,%.3f,%ld,%s\n", name, dirtyUs / 1000.0, (unsigned)flushedPx, fullMs, badPx, status);
+    }
+
+    free(rgb);
+    res->frames++;
+    if (failed) {
+        res->failed++;
+    }
+    return true;
+}
+
+static bool runLine(const RunnerOptions &opt, char *line, int lineNo, RunnerResult *res, FILE *csv) {
+    char *hash = strchr(line, '#');
+    if (hash) *hash = 0;
+
+    char *argv[8];
+    int argc = 0;
+    for (char *tok = strtok(line, " \t\r\n"); tok && argc < 8; tok = strtok(NULL, " \t\r\n")) {
+        argv[argc++] = tok;
+    }
+    if (argc == 0) {
+        return true;
+    }
+
+    if (strcmp(argv[0], "adc") == 0 && argc == 5) {
+        // 校准系数为1，电压/电流值直接对应毫伏读数
+        host_set_adc_mv(ADC_U_IN_PIN, (uint32_t)lround(atof(argv[1]) * 1000.0));
+        host_set_adc_mv(ADC_I_IN_PIN, (uint32_t)lround(atof(argv[2]) * 1000.0));
+        host_set_adc_mv(ADC_U_OUT_PIN, (uint32_t)lround(atof(argv[3]) * 1000.0));
+        host_set_adc_mv(ADC_I_OUT_PIN, (uint32_t)lround(atof(argv[4]) * 1000.0));
+        delay(ADC_UPDATE_INTERVAL);
+        adc->update();
+        updateDisplay();
+        return true;
+    }
+    if (strcmp(argv[0], "uset") == 0 && argc >= 2) {
+        bool confirmed = true;
+        bool fine = true;
+        for (int i = 2; i < argc; i++) {
+            if (strcmp(argv[i], "unconfirmed") == 0) confirmed = false;
+            else if (strcmp(argv[i], "coarse") == 0) fine = false;
+        }
+        updateUSetDisplay((float)atof(argv[1]), confirmed, fine, &encoder);
+        return true;
+    }
+    if (strcmp(argv[0], "state") == 0 && argc == 2) {
+        updateButtonState(strcmp(argv[1], "on") == 0);
+        return true;
+    }
+    if (strcmp(argv[0], "step") == 0 && argc == 2) {
+        runFor((uint32_t)atoi(argv[1]));
+        return true;
+    }
+    if (strcmp(argv[0], "frame") == 0 && argc == 2) {
+        return renderFrame(opt, argv[1], res, csv);
+    }
+    if (strcmp(argv[0], "run") == 0 && argc == 2) {
+        runTasks((uint32_t)atoi(argv[1]));
+        return true;
+    }
+    if (strcmp(argv[0], "gpio") == 0 && argc == 3) {
+        host_set_gpio((uint8_t)atoi(argv[1]), atoi(argv[2]) ? HIGH : LOW);
+        return true;
+    }
+    if (strcmp(argv[0], "encoder") == 0 && argc == 2) {
+        int steps = atoi(argv[1]);
+        for (int i = 0; i < abs(steps); i++) {
+            turnEncoder(steps > 0);
+            runTasks(RUNNER_ENCODER_DETENT_MS);
+        }
+        return true;
+    }
+    if (strcmp(argv[0], "press") == 0 && (argc == 2 || argc == 3)) {
+        uint8_t pin;
+        if (strcmp(argv[1], "state") == 0) pin = RUNNER_BUTTON_STATE_PIN;
+        else if (strcmp(argv[1], "confirm") == 0) pin = RUNNER_CONFIRM_BUTTON_PIN;
+        else if (strcmp(argv[1], "step") == 0) pin = RUNNER_STEP_SWITCH_PIN;
+        else {
+            fprintf(stderr, "%s:%d: 未知按钮 '%s'\n", opt.script, lineNo, argv[1]);
+            return false;
+        }
+        host_set_gpio(pin, HIGH);
+        runTasks(argc == 3 ? (uint32_t)atoi(argv[2]) : RUNNER_PRESS_MS);
+        host_set_gpio(pin, LOW);
+        runTasks(RUNNER_ENCODER_DETENT_MS);
+        return true;
+    }
+    if (strcmp(argv[0], "protect") == 0 && argc == 3) {
+        // 阈值经系统状态发布，限流回路在下一个周期交给保护模块
+        SystemState state;
+        systemState.snapshot(state);
+        ProtectionLimits limits = state.limits;
+        float value = (float)atof(argv[2]);
+        if (strcmp(argv[1], "ovp") == 0) limits.ovpV = value;
+        else if (strcmp(argv[1], "ocp") == 0) limits.ocpA = value;
+        else if (strcmp(argv[1], "uvlo") == 0) limits.uvloV = value;
+        else if (strcmp(argv[1], "opp") == 0) limits.oppW = value;
+        else {
+            fprintf(stderr, "%s:%d: 未知保护 '%s'\n", opt.script, lineNo, argv[1]);
+            return false;
+        }
+        systemState.setProtectionLimits(limits);
+        return true;
+    }
+    if (strcmp(argv[0], "plant") == 0 && argc >= 2) {
+        return runPlant(opt, lineNo, argv, argc);
+    }
+    if (strcmp(argv[0], "capture") == 0 && argc >= 2) {
+        return runCapture(opt, lineNo, argv, argc);
+    }
+    if (strcmp(argv[0], "expect") == 0 && argc >= 2) {
+        return runExpect(opt, lineNo, argv, argc, res);
+    }
+
+    fprintf(stderr, "%s:%d: 无法识别的命令 '%s'\n", opt.script, lineNo, argv[0]);
+    return false;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "用法: %s --script <file> --golden-dir <dir> --out-dir <dir>\n"
+            "          [--update-golden] [--tolerance N] [--repeat N] [--budget-ms X]\n"
+            "          [--timing-csv <file>] [--verbose]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    RunnerOptions opt = {NULL, NULL, NULL, NULL, false, false, 0, 5, 0.0};
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        bool hasNext = i + 1 < argc;
+        if (strcmp(a, "--script") == 0 && hasNext) opt.script = argv[++i];
+        else if (strcmp(a, "--golden-dir") == 0 && hasNext) opt.goldenDir = argv[++i];
+        else if (strcmp(a, "--out-dir") == 0 && hasNext) opt.outDir = argv[++i];
+        else if (strcmp(a, "--timing-csv") == 0 && hasNext) opt.timingCsv = argv[++i];
+        else if (strcmp(a, "--tolerance") == 0 && hasNext) opt.tolerance = atoi(argv[++i]);
+        else if (strcmp(a, "--repeat") == 0 && hasNext) opt.repeat = atoi(argv[++i]);
+        else if (strcmp(a, "--budget-ms") == 0 && hasNext) opt.budgetMs = atof(argv[++i]);
+        else if (strcmp(a, "--update-golden") == 0) opt.updateGolden = true;
+        else if (strcmp(a, "--verbose") == 0) opt.verbose = true;
+        else {
+            usage(argv[0]);
+            return RUNNER_EXIT_USAGE;
+        }
+    }
+    if (opt.script == NULL || opt.goldenDir == NULL || opt.outDir == NULL) {
+        usage(argv[0]);
+        return RUNNER_EXIT_USAGE;
+    }
+
+    FILE *script = fopen(opt.script, "r");
+    if (script == NULL) {
+        fprintf(stderr, "无法打开脚本 %s\n", opt.script);
+        return RUNNER_EXIT_USAGE;
+    }
+    if (makeDirs(opt.outDir) != 0 || (opt.updateGolden && makeDirs(opt.goldenDir) != 0)) {
+        fprintf(stderr, "无法创建输出目录\n");
+        fclose(script);
+        return RUNNER_EXIT_USAGE;
+    }
+
+    FILE *csv = NULL;
+    if (opt.timingCsv) {
+        csv = fopen(opt.timingCsv, "w");
+        if (csv) {
+            fprintf(csv, "frame,dirty_ms,flushed_px,full_ms,mismatch_px,status\n");
+        }
+    }
+
+    Serial.setEnabled(opt.verbose);
+    setup();
+
+    RunnerResult res = {0, 0, 0, 0, 0};
+    char line[RUNNER_LINE_MAX];
+    int lineNo = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), script)) {
+        lineNo++;
+        ok = runLine(opt, line, lineNo, &res, csv);
+    }
+    fclose(script);
+    if (csv) {
+        fclose(csv);
+    }
+    delete s_plant;
+
+    if (!ok) {
+        return RUNNER_EXIT_USAGE;
+    }
+
+    printf("%d 帧, %d 失败, %d 缺少基准图\n", res.frames, res.failed, res.missing);
+    if (res.checks > 0) {
+        printf("%d 项检查, %d 失败\n", res.checks, res.checksFailed);
+    }
+    // 缺少基准图的帧没有被比较，判为失败而不是跳过，否则整个场景的比较会悄悄失效
+    if (res.missing > 0) {
+        printf("用 --update-golden（或 update_golden 目标）生成基准图并提交到 host/golden/\n");
+    }
+    if (res.failed > 0 || res.checksFailed > 0 || res.missing > 0) {
+        return RUNNER_EXIT_FAIL;
+    }
+    return RUNNER_EXIT_OK;
+}
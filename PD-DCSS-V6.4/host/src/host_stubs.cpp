@@ -0,0 +1,585 @@
+/**
+ * @file host_stubs.cpp
+ * @brief 主机构建的Arduino/FreeRTOS/ESP-IDF替身实现
+ * @details
+ * 任务由一个确定性的协作式调度器运行（ucontext，每个任务一个独立的栈）：
+ * - 只有脚本调用 host_run_tasks() 时任务才会运行，其余时间处于主上下文（脚本和 setup()）；
+ * - 总是运行优先级最高的就绪任务，同优先级轮转；任务只在阻塞、延时或唤醒了
+ *   更高优先级任务时切换，不做时间片抢占；
+ * - 所有任务都阻塞时虚拟时钟直接跳到最早的唤醒时刻，所以结果与机器速度无关；
+ * - 主上下文中的阻塞调用保持原来的行为：互斥量总能获取，事件组和队列不阻塞，
+ *   延时推进虚拟时钟。
+ * 主机上没有多核，任务表中的核心分配被忽略。
+ * GPIO、ADC、SPI和睡眠由 hal_linux.cpp 实现，Arduino的引脚函数转发到那里。
+ */
+
+#include <stdarg.h>
+#include <ucontext.h>
+#include <vector>
+
+#include "Arduino.h"
+#include "host_stubs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "freertos/queue.h"
+#include "myHAL.h"
+
+HostSerial Serial;
+
+/* 虚拟时钟 */
+
+static uint64_t s_nowUs = 0;
+static HostClockHook s_clockHook = NULL;
+
+// 时钟只通过这里前进，以便仿真模型跟上虚拟时间
+static void setNow(uint64_t us) {
+    if (us <= s_nowUs) {
+        return;
+    }
+    uint64_t from = s_nowUs;
+    s_nowUs = us;
+    if (s_clockHook) {
+        s_clockHook(from, us);
+    }
+}
+
+void host_set_clock_hook(HostClockHook hook) { s_clockHook = hook; }
+
+extern "C" uint64_t host_micros(void) { return s_nowUs; }
+extern "C" uint32_t host_millis(void) { return (uint32_t)(s_nowUs / 1000); }
+extern "C" void host_advance_us(uint64_t us) { setNow(s_nowUs + us); }
+extern "C" void host_advance_ms(uint32_t ms) { setNow(s_nowUs + (uint64_t)ms * 1000); }
+
+unsigned long millis() { return host_millis(); }
+unsigned long micros() { return (unsigned long)host_micros(); }
+// Arduino-ESP32 的 delay() 就是 vTaskDelay()，在任务中会让出CPU
+void delay(uint32_t ms) { vTaskDelay(ms); }
+void delayMicroseconds(uint32_t us) { host_advance_us(us); }
+void ets_delay_us(uint32_t us) { host_advance_us(us); }
+
+/* Serial */
+
+size_t HostSerial::write(const char *s) {
+    size_t n = strlen(s);
+    if (_enabled) {
+        fputs(s, stdout);
+    }
+    return n;
+}
+
+size_t HostSerial::write(const uint8_t *data, size_t len) {
+    if (_enabled) {
+        fwrite(data, 1, len, stdout);
+    }
+    return len;
+}
+
+size_t HostSerial::printf(const char *fmt, ...) {
+    char buf[256];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (n < 0) {
+        return 0;
+    }
+    write(buf);
+    return (size_t)n;
+}
+
+/* GPIO：转发到HAL */
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    HalPinMode halMode = HAL_PIN_INPUT;
+    if (mode == OUTPUT) halMode = HAL_PIN_OUTPUT;
+    else if (mode == INPUT_PULLUP) halMode = HAL_PIN_INPUT_PULLUP;
+    else if (mode == INPUT_PULLDOWN) halMode = HAL_PIN_INPUT_PULLDOWN;
+    halGpioMode(pin, halMode);
+}
+
+int digitalRead(uint8_t pin) { return halGpioRead(pin); }
+void digitalWrite(uint8_t pin, uint8_t val) { halGpioWrite(pin, val); }
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode) {
+    HalEdge edge = mode == RISING ? HAL_EDGE_RISING : (mode == FALLING ? HAL_EDGE_FALLING : HAL_EDGE_CHANGE);
+    halGpioAttachIsr(pin, isr, edge);
+}
+
+void detachInterrupt(uint8_t pin) { halGpioDetachIsr(pin); }
+
+/* 调度器 */
+
+#define HOST_TASK_STACK_BYTES (512 * 1024)   // 主机上栈用量与目标板无关，统一取足够大的值
+#define HOST_WAIT_FOREVER UINT64_MAX
+#define HOST_LIVELOCK_DISPATCHES 100000      // 同一时刻连续调度这么多次仍无任务阻塞，视为忙等
+
+enum HostTaskState {
+    HOST_TASK_READY = 0,
+    HOST_TASK_BLOCKED,
+    HOST_TASK_DELETED,
+};
+
+struct HostTask {
+    const char *name;
+    TaskFunction_t fn;
+    void *param;
+    UBaseType_t priority;
+    HostTaskState state;
+    const void *waitObj;   // 等待的内核对象，NULL表示纯延时
+    uint64_t wakeUs;       // 超时时刻
+    bool timedOut;         // 最近一次等待是否因超时结束
+    uint64_t lastRun;      // 最近一次被调度的序号，用于同优先级轮转
+    uint32_t notifyValue;  // 任务通知计数
+    uint8_t *stack;
+    ucontext_t ctx;
+};
+
+static std::vector<HostTask *> s_tasks;
+static HostTask *s_current = NULL;   // NULL表示主上下文
+static ucontext_t s_schedCtx;
+static uint64_t s_dispatchSeq = 0;
+
+bool host_in_task() { return s_current != NULL; }
+
+int host_task_count() {
+    int n = 0;
+    for (HostTask *t : s_tasks) {
+        if (t->state != HOST_TASK_DELETED) {
+            n++;
+        }
+    }
+    return n;
+}
+
+static uint64_t deadlineAfter(TickType_t ticks) {
+    if (ticks == portMAX_DELAY) {
+        return HOST_WAIT_FOREVER;
+    }
+    return s_nowUs + (uint64_t)ticks * 1000;
+}
+
+static void switchToScheduler() {
+    swapcontext(&s_current->ctx, &s_schedCtx);
+}
+
+// 在任务上下文中等待 obj 被唤醒或到达 deadlineUs；返回false表示超时。
+// 调用者被唤醒后必须重新检查等待条件
+static bool waitOn(const void *obj, uint64_t deadlineUs) {
+    if (s_current == NULL || s_nowUs >= deadlineUs) {
+        return false;
+    }
+    s_current->state = HOST_TASK_BLOCKED;
+    s_current->waitObj = obj;
+    s_current->wakeUs = deadlineUs;
+    switchToScheduler();
+    return !s_current->timedOut;
+}
+
+// 当前任务让出CPU，保持就绪
+static void yieldCurrent() {
+    if (s_current != NULL) {
+        switchToScheduler();
+    }
+}
+
+// 唤醒等待 obj 的所有任务；返回是否唤醒了比当前任务优先级更高的任务
+static bool wakeWaiters(const void *obj) {
+    bool higher = false;
+    for (HostTask *t : s_tasks) {
+        if (t->state == HOST_TASK_BLOCKED && t->waitObj == obj) {
+            t->state = HOST_TASK_READY;
+            t->waitObj = NULL;
+            t->timedOut = false;
+            if (s_current == NULL || t->priority > s_current->priority) {
+                higher = true;
+            }
+        }
+    }
+    return higher;
+}
+
+// 任务上下文中唤醒了更高优先级的任务时立即切换，与FreeRTOS的抢占行为一致
+static void wakeAndPreempt(const void *obj) {
+    if (wakeWaiters(obj) && s_current != NULL) {
+        yieldCurrent();
+    }
+}
+
+static void wakeFromIsr(const void *obj, BaseType_t *woken) {
+    bool higher = wakeWaiters(obj);
+    if (woken) {
+        *woken = higher ? pdTRUE : pdFALSE;
+    }
+}
+
+static void taskTrampoline() {
+    HostTask *t = s_current;
+    t->fn(t->param);
+    // FreeRTOS的任务函数不允许返回，这里按自行删除处理
+    fprintf(stderr, "警告: 任务 %s 的入口函数返回\n", t->name);
+    vTaskDelete(NULL);
+}
+
+static HostTask *pickReady() {
+    HostTask *best = NULL;
+    for (HostTask *t : s_tasks) {
+        if (t->state != HOST_TASK_READY) {
+            continue;
+        }
+        if (best == NULL || t->priority > best->priority ||
+            (t->priority == best->priority && t->lastRun < best->lastRun)) {
+            best = t;
+        }
+    }
+    return best;
+}
+
+static void reapDeleted() {
+    for (size_t i = 0; i < s_tasks.size();) {
+        HostTask *t = s_tasks[i];
+        if (t->state == HOST_TASK_DELETED) {
+            delete[] t->stack;
+            delete t;
+            s_tasks.erase(s_tasks.begin() + i);
+        } else {
+            i++;
+        }
+    }
+}
+
+void host_run_tasks(uint32_t ms) {
+    if (s_current != NULL) {
+        fprintf(stderr, "错误: host_run_tasks 不能在任务中调用\n");
+        return;
+    }
+    uint64_t endUs = s_nowUs + (uint64_t)ms * 1000;
+    uint64_t lastDispatchUs = s_nowUs;
+    uint32_t sameTimeDispatches = 0;
+
+    while (true) {
+        reapDeleted();
+
+        // 超时的任务转为就绪，同时找出最早的唤醒时刻
+        uint64_t nextWakeUs = HOST_WAIT_FOREVER;
+        for (HostTask *t : s_tasks) {
+            if (t->state != HOST_TASK_BLOCKED) {
+                continue;
+            }
+            if (t->wakeUs <= s_nowUs) {
+                t->state = HOST_TASK_READY;
+                t->waitObj = NULL;
+                t->timedOut = true;
+            } else if (t->wakeUs < nextWakeUs) {
+                nextWakeUs = t->wakeUs;
+            }
+        }
+
+        if (s_nowUs >= endUs) {
+            break;
+        }
+
+        HostTask *next = pickReady();
+        if (next == NULL) {
+            // 全部阻塞：时钟跳到下一个唤醒时刻
+            setNow(nextWakeUs < endUs ? nextWakeUs : endUs);
+            continue;
+        }
+
+        if (s_nowUs == lastDispatchUs) {
+            if (++sameTimeDispatches >= HOST_LIVELOCK_DISPATCHES) {
+                fprintf(stderr, "警告: 任务 %s 在忙等，虚拟时钟前进1ms\n", next->name);
+                host_advance_ms(1);
+                sameTimeDispatches = 0;
+            }
+        } else {
+            lastDispatchUs = s_nowUs;
+            sameTimeDispatches = 0;
+        }
+
+        next->lastRun = ++s_dispatchSeq;
+        s_current = next;
+        swapcontext(&s_schedCtx, &next->ctx);
+        s_current = NULL;
+    }
+    reapDeleted();
+}
+
+/* 任务 */
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stackDepth, void *param,
+                       UBaseType_t priority, TaskHandle_t *handle) {
+    return xTaskCreatePinnedToCore(fn, name, stackDepth, param, priority, handle, tskNO_AFFINITY);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stackDepth, void *param,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core) {
+    (void)stackDepth; (void)core;
+    HostTask *task = new HostTask();
+    task->name = name;
+    task->fn = fn;
+    task->param = param;
+    task->priority = priority;
+    task->state = HOST_TASK_READY;
+    task->stack = new uint8_t[HOST_TASK_STACK_BYTES];
+
+    getcontext(&task->ctx);
+    task->ctx.uc_stack.ss_sp = task->stack;
+    task->ctx.uc_stack.ss_size = HOST_TASK_STACK_BYTES;
+    task->ctx.uc_link = &s_schedCtx;
+    makecontext(&task->ctx, taskTrampoline, 0);
+
+    s_tasks.push_back(task);
+    if (handle) {
+        *handle = task;
+    }
+    // 在任务中创建了更高优先级的任务时立即切换
+    if (s_current != NULL && priority > s_current->priority) {
+        yieldCurrent();
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task == NULL) {
+        task = s_current;
+    }
+    if (task == NULL) {
+        return;
+    }
+    task->state = HOST_TASK_DELETED;
+    if (task == s_current) {
+        // 栈由调度器回收，不会再返回
+        switchToScheduler();
+    } else if (s_current == NULL) {
+        reapDeleted();
+    }
+}
+
+void vTaskPrioritySet(TaskHandle_t task, UBaseType_t priority) {
+    if (task == NULL) {
+        task = s_current;
+    }
+    if (task != NULL) {
+        task->priority = priority;
+    }
+}
+
+void vTaskDelay(TickType_t ticks) {
+    if (s_current == NULL) {
+        host_advance_ms(ticks);
+    } else if (ticks == 0) {
+        yieldCurrent();
+    } else {
+        waitOn(NULL, deadlineAfter(ticks));
+    }
+}
+
+void vTaskDelayUntil(TickType_t *previousWakeTime, TickType_t period) {
+    TickType_t wake = *previousWakeTime + period;
+    TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(wake - now) > 0) {
+        vTaskDelay(wake - now);
+    }
+    *previousWakeTime = wake;
+}
+
+TickType_t xTaskGetTickCount(void) { return host_millis(); }
+
+/* 任务通知：等待的对象是任务自己 */
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    if (task == NULL) {
+        return pdFALSE;
+    }
+    task->notifyValue++;
+    wakeAndPreempt(task);
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    if (s_current == NULL) {
+        return 0;
+    }
+    uint64_t deadline = deadlineAfter(ticks);
+    while (s_current->notifyValue == 0) {
+        if (!waitOn(s_current, deadline)) {
+            break;
+        }
+    }
+    uint32_t value = s_current->notifyValue;
+    if (value > 0) {
+        s_current->notifyValue = clearOnExit ? 0 : value - 1;
+    }
+    return value;
+}
+
+/* 互斥量：任务间按持有者互斥；主上下文中总能获取 */
+
+struct HostSemaphore {
+    int taken;
+    HostTask *owner;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) { return new HostSemaphore{0, NULL}; }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+    if (sem == NULL) {
+        return pdFALSE;
+    }
+    uint64_t deadline = deadlineAfter(ticks);
+    while (s_current != NULL && sem->taken > 0 && sem->owner != s_current) {
+        if (!waitOn(sem, deadline) && sem->taken > 0) {
+            return pdFALSE;
+        }
+    }
+    if (sem->taken == 0) {
+        sem->owner = s_current;
+    }
+    sem->taken++;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    if (sem == NULL || sem->taken == 0) {
+        return pdFALSE;
+    }
+    sem->taken--;
+    if (sem->taken == 0) {
+        sem->owner = NULL;
+        wakeAndPreempt(sem);
+    }
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem) { delete sem; }
+
+/* 事件组 */
+
+struct HostEventGroup {
+    EventBits_t bits;
+};
+
+EventGroupHandle_t xEventGroupCreate(void) { return new HostEventGroup{0}; }
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+    group->bits |= bits;
+    EventBits_t result = group->bits;
+    wakeAndPreempt(group);
+    return result;
+}
+
+BaseType_t xEventGroupSetBitsFromISR(EventGroupHandle_t group, EventBits_t bits, BaseType_t *woken) {
+    group->bits |= bits;
+    wakeFromIsr(group, woken);
+    return pdPASS;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+    EventBits_t old = group->bits;
+    group->bits &= ~bits;
+    return old;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group) { return group->bits; }
+
+static bool bitsSatisfied(EventBits_t current, EventBits_t bits, BaseType_t waitForAll) {
+    return waitForAll ? ((current & bits) == bits) : ((current & bits) != 0);
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clearOnExit,
+                                BaseType_t waitForAll, TickType_t ticks) {
+    uint64_t deadline = deadlineAfter(ticks);
+    while (!bitsSatisfied(group->bits, bits, waitForAll)) {
+        if (!waitOn(group, deadline)) {
+            break;
+        }
+    }
+    EventBits_t current = group->bits;
+    if (bitsSatisfied(current, bits, waitForAll) && clearOnExit) {
+        group->bits &= ~bits;
+    }
+    return current;
+}
+
+/* 队列：定长环形缓冲 */
+
+struct HostQueue {
+    uint8_t *storage;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    UBaseType_t head;
+    UBaseType_t count;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    HostQueue *q = new HostQueue;
+    q->storage = new uint8_t[length * itemSize];
+    q->length = length;
+    q->itemSize = itemSize;
+    q->head = 0;
+    q->count = 0;
+    return q;
+}
+
+static void enqueue(QueueHandle_t q, const void *item) {
+    UBaseType_t tail = (q->head + q->count) % q->length;
+    memcpy(q->storage + tail * q->itemSize, item, q->itemSize);
+    q->count++;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks) {
+    if (q == NULL) {
+        return pdFALSE;
+    }
+    uint64_t deadline = deadlineAfter(ticks);
+    while (q->count >= q->length) {
+        if (!waitOn(q, deadline) && q->count >= q->length) {
+            return pdFALSE;
+        }
+    }
+    enqueue(q, item);
+    wakeAndPreempt(q);
+    return pdTRUE;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t q, const void *item, BaseType_t *woken) {
+    if (woken) {
+        *woken = pdFALSE;
+    }
+    if (q == NULL || q->count >= q->length) {
+        return pdFALSE;
+    }
+    enqueue(q, item);
+    wakeFromIsr(q, woken);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks) {
+    if (q == NULL) {
+        return pdFALSE;
+    }
+    uint64_t deadline = deadlineAfter(ticks);
+    while (q->count == 0) {
+        if (!waitOn(q, deadline) && q->count == 0) {
+            return pdFALSE;
+        }
+    }
+    memcpy(item, q->storage + q->head * q->itemSize, q->itemSize);
+    q->head = (q->head + 1) % q->length;
+    q->count--;
+    wakeAndPreempt(q);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReset(QueueHandle_t q) {
+    if (q != NULL) {
+        q->head = 0;
+        q->count = 0;
+        wakeAndPreempt(q);
+    }
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) { return q ? q->count : 0; }
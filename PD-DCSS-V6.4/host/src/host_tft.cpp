@@ -0,0 +1,88 @@
+/**
+ * @file host_tft.cpp
+ * @brief TFT_eSPI替身：内存帧缓冲
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "TFT_eSPI.h"
+#include "host_stubs.h"
+
+static HostTouchSource s_touchSource = NULL;
+static uint32_t s_touchIndex = 0;
+static uint32_t s_touchReadUs = 0;
+
+void host_set_touch_source(HostTouchSource source) {
+    s_touchSource = source;
+    s_touchIndex = 0;
+}
+
+void host_set_touch_read_us(uint32_t us) {
+    s_touchReadUs = us;
+}
+
+TFT_eSPI::TFT_eSPI(int16_t w, int16_t h) :
+    _w(w),
+    _h(h),
+    _fb(NULL),
+    _winX(0), _winY(0), _winW(0), _winH(0),
+    _pixelsPushed(0),
+    _flushCount(0)
+{
+    _fb = (uint16_t *)calloc((size_t)w * h, sizeof(uint16_t));
+}
+
+TFT_eSPI::~TFT_eSPI() {
+    free(_fb);
+}
+
+void TFT_eSPI::begin() {
+    memset(_fb, 0, (size_t)_w * _h * sizeof(uint16_t));
+    resetStats();
+}
+
+bool TFT_eSPI::getTouch(uint16_t *x, uint16_t *y, uint16_t threshold) {
+    (void)x; (void)y; (void)threshold;
+    return false;
+}
+
+uint8_t TFT_eSPI::getTouchRaw(uint16_t *x, uint16_t *y) {
+    uint16_t z = 0;
+    *x = 0;
+    *y = 0;
+    if (s_touchSource != NULL) {
+        s_touchSource(s_touchIndex++, x, y, &z);
+    }
+    host_advance_us(s_touchReadUs);
+    return 1;
+}
+
+uint16_t TFT_eSPI::getTouchRawZ() {
+    uint16_t x = 0, y = 0, z = 0;
+    if (s_touchSource != NULL) {
+        s_touchSource(s_touchIndex, &x, &y, &z);
+    }
+    return z;
+}
+
+void TFT_eSPI::setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h) {
+    _winX = x;
+    _winY = y;
+    _winW = w;
+    _winH = h;
+}
+
+void TFT_eSPI::pushColors(uint16_t *data, uint32_t len, bool swap) {
+    (void)swap;
+    // 按行写入当前地址窗口，超出屏幕的部分丢弃
+    for (uint32_t i = 0; i < len && _winW > 0; i++) {
+        int32_t x = _winX + (int32_t)(i % (uint32_t)_winW);
+        int32_t y = _winY + (int32_t)(i / (uint32_t)_winW);
+        if (x >= 0 && x < _w && y >= 0 && y < _h && y < _winY + _winH) {
+            _fb[y * _w + x] = data[i];
+        }
+    }
+    _pixelsPushed += len;
+    _flushCount++;
+}
@@ -0,0 +1,296 @@
+/**
+ * @file plant_sim.cpp
+ * @brief 降压变换器模型的独立运行器：单个场景输出波形和指标，或批量扫描场景做回归检查
+ * @details
+ * 单个场景（时间从0开始，DAC在0时刻给定为目标电压）：
+ *   plant_sim --vout 3.3 --vin 12 --load res:4 --step-at 10 --step cc:2
+ *             --sag-at 15 --sag 3 --sag-ms 2 --duration-ms 20 --trace out.csv
+ * 负载写作 res:<Ω>（0为开路）或 cc:<A>。打印启动阶段和负载阶跃之后的指标。
+ *
+ * 扫描（--sweep）：输入电压 x 目标电压 x 负载 x 阶跃负载的全部组合。启动窗口检查超调、
+ * 稳定时间和效率；负载阶跃窗口检查最大偏离（偏离目标的电压，向上或向下）、恢复时间和效率。
+ * 输入电压不足以维持目标电压的组合（压降）不检查稳定时间和效率；非同步整流时
+ * 阶跃到开路没有放电通路，输出停在阶跃后的峰值，不检查阶跃窗口。
+ *
+ * 返回值：0 全部通过；1 有场景超出限值；2 参数错误。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+
+#include "host_plant.h"
+#include "host_stubs.h"
+
+#define SIM_EXIT_OK 0
+#define SIM_EXIT_FAIL 1
+#define SIM_EXIT_USAGE 2
+
+#define SIM_HEADROOM_V 0.5f   // 输入电压比目标高出此值以上才认为能稳压
+
+struct SimLoad {
+    PlantLoadKind kind;
+    float value;
+};
+
+struct SimLimits {
+    float maxOvershootPct;   // 启动超调
+    float maxDeviationV;     // 负载阶跃后的最大偏离(V)，低输出电压时按百分比不合理
+    float maxSettleMs;
+    float minEfficiency;     // 只在输出功率不小于 minPowerW 的窗口检查
+    float minPowerW;
+};
+
+struct SimScenario {
+    float vin;
+    float vout;
+    SimLoad load;
+    bool hasStep;
+    float stepAtMs;
+    SimLoad step;
+    bool hasSag;
+    float sagAtMs;
+    float sagV;
+    float sagMs;
+    float durationMs;
+};
+
+static bool parseLoad(const char *s, SimLoad *load) {
+    if (strncmp(s, "res:", 4) == 0) {
+        load->kind = PLANT_LOAD_RESISTIVE;
+    } else if (strncmp(s, "cc:", 3) == 0) {
+        load->kind = PLANT_LOAD_CONSTANT_CURRENT;
+    } else {
+        return false;
+    }
+    load->value = (float)atof(strchr(s, ':') + 1);
+    return true;
+}
+
+static void formatLoad(const SimLoad &load, char *buf, size_t size) {
+    snprintf(buf, size, load.kind == PLANT_LOAD_RESISTIVE ? "res:%g" : "cc:%g", load.value);
+}
+
+static float loadCurrentAt(const SimLoad &load, float vout) {
+    if (load.kind == PLANT_LOAD_CONSTANT_CURRENT) {
+        return load.value;
+    }
+    return load.value > 0.0f ? vout / load.value : 0.0f;
+}
+
+// 稳态下输入电压能否维持目标电压（占空比上限、电感和源内阻压降）
+static bool canRegulate(const PlantParams &p, float vin, float vout, const SimLoad &load) {
+    float i = loadCurrentAt(load, vout);
+    if (i > p.currentLimit) {
+        return false;
+    }
+    float vsw = vout + i * p.inductorResistance;
+    float iin = vsw * i / vin;
+    return p.dutyMax * (vin - iin * p.sourceResistance) - vsw >= SIM_HEADROOM_V;
+}
+
+static uint64_t msToUs(float ms) {
+    return (uint64_t)llroundf(ms * 1000.0f);
+}
+
+static void printMetrics(const char *window, const PlantMetrics &m) {
+    printf("%-8s vout %.3f  peak %.3f  min %.3f  overshoot %.2f%%  settle %.2fms  efficiency %.1f%%  ripple %.4fV\n",
+           window, m.finalVout, m.peakVout, m.minVout, m.overshootPct, m.settleMs, m.efficiency * 100.0f,
+           m.rippleV);
+}
+
+/**
+ * @brief 检查一个测量窗口，不通过时打印原因
+ * @return 通过返回true
+ */
+static bool checkWindow(const SimScenario &sc, const char *window, const PlantMetrics &m, float outPowerW,
+                        bool regulating, const SimLimits &lim) {
+    const char *reason = NULL;
+    bool isStep = strcmp(window, "step") == 0;
+    float deviation = std::max(m.peakVout - m.target, m.target - m.minVout);
+    if (!isStep && m.overshootPct > lim.maxOvershootPct) {
+        reason = "overshoot";
+    } else if (isStep && regulating && deviation > lim.maxDeviationV) {
+        reason = "deviation";
+    } else if (regulating && (m.settleMs < 0.0f || m.settleMs > lim.maxSettleMs)) {
+        reason = "settle";
+    } else if (regulating && outPowerW >= lim.minPowerW && m.efficiency < lim.minEfficiency) {
+        reason = "efficiency";
+    }
+    if (reason == NULL) {
+        return true;
+    }
+    char load[32];
+    char step[32];
+    formatLoad(sc.load, load, sizeof(load));
+    formatLoad(sc.step, step, sizeof(step));
+    printf("FAIL %-10s vin %.1f vout %.2f load %s step %s %s: ", reason, sc.vin, sc.vout, load,
+           sc.hasStep ? step : "-", window);
+    printMetrics("", m);
+    return false;
+}
+
+/**
+ * @brief 运行一个场景：启动窗口到阶跃时刻（没有阶跃时到结束），阶跃窗口到结束
+ * @return 全部窗口通过返回true
+ */
+static bool runScenario(const SimScenario &sc, const SimLimits &lim, const char *tracePath, uint32_t traceUs,
+                        bool print) {
+    PlantParams p = plantDefaultParams();
+    p.vinOpen = sc.vin;
+    HostPlant plant(p);
+    plant.overrideDac(sc.vout / p.refGain);
+    plant.setLoad(sc.load.kind, sc.load.value);
+    if (sc.hasSag) {
+        plant.scheduleSag(plant.state().timeUs + msToUs(sc.sagAtMs), (uint32_t)msToUs(sc.sagMs), sc.sagV);
+    }
+    if (tracePath && !plant.openTrace(tracePath, traceUs)) {
+        fprintf(stderr, "无法创建 %s\n", tracePath);
+        return false;
+    }
+
+    uint64_t t0 = plant.state().timeUs;
+    float firstEndMs = sc.hasStep ? sc.stepAtMs : sc.durationMs;
+    bool ok = true;
+
+    plant.mark(sc.vout);
+    plant.advanceTo(t0 + msToUs(firstEndMs));
+    PlantMetrics m = plant.metrics();
+    float power = m.finalVout * loadCurrentAt(sc.load, m.finalVout);
+    ok &= checkWindow(sc, "startup", m, power, canRegulate(p, sc.vin, sc.vout, sc.load), lim);
+    if (print) {
+        printMetrics("startup", m);
+    }
+
+    if (sc.hasStep) {
+        plant.scheduleLoad(plant.state().timeUs, sc.step.kind, sc.step.value);
+        plant.mark(sc.vout);
+        plant.advanceTo(t0 + msToUs(sc.durationMs));
+        m = plant.metrics();
+        power = m.finalVout * loadCurrentAt(sc.step, m.finalVout);
+        bool openWithDiode = p.diodeRectifier && loadCurrentAt(sc.step, sc.vout) <= 0.0f;
+        bool regulating = !openWithDiode && canRegulate(p, sc.vin, sc.vout, sc.step);
+        ok &= checkWindow(sc, "step", m, power, regulating, lim);
+        if (print) {
+            printMetrics("step", m);
+        }
+    }
+    return ok;
+}
+
+static int runSweep(const SimLimits &lim, float durationMs) {
+    static const float VINS[] = {5.0f, 8.0f, 12.0f, 15.0f, 20.0f, 24.0f};
+    static const float VOUTS[] = {0.5f, 1.0f, 1.8f, 2.5f, 3.3f, 4.0f};
+    static const SimLoad LOADS[] = {
+        {PLANT_LOAD_RESISTIVE, 0.0f},  {PLANT_LOAD_RESISTIVE, 20.0f},
+        {PLANT_LOAD_RESISTIVE, 5.0f},  {PLANT_LOAD_RESISTIVE, 2.0f},
+        {PLANT_LOAD_CONSTANT_CURRENT, 0.2f}, {PLANT_LOAD_CONSTANT_CURRENT, 1.0f},
+        {PLANT_LOAD_CONSTANT_CURRENT, 2.0f}, {PLANT_LOAD_CONSTANT_CURRENT, 3.0f},
+    };
+    static const int VIN_COUNT = sizeof(VINS) / sizeof(VINS[0]);
+    static const int VOUT_COUNT = sizeof(VOUTS) / sizeof(VOUTS[0]);
+    static const int LOAD_COUNT = sizeof(LOADS) / sizeof(LOADS[0]);
+
+    int scenarios = 0;
+    int failed = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int v = 0; v < VIN_COUNT; v++) {
+        for (int o = 0; o < VOUT_COUNT; o++) {
+            for (int l = 0; l < LOAD_COUNT; l++) {
+                // 不阶跃，以及阶跃到每一种不同的负载
+                for (int s = -1; s < LOAD_COUNT; s++) {
+                    if (s == l) {
+                        continue;
+                    }
+                    SimScenario sc;
+                    memset(&sc, 0, sizeof(sc));
+                    sc.vin = VINS[v];
+                    sc.vout = VOUTS[o];
+                    sc.load = LOADS[l];
+                    sc.hasStep = s >= 0;
+                    sc.stepAtMs = durationMs / 2.0f;
+                    sc.step = s >= 0 ? LOADS[s] : LOADS[l];
+                    sc.durationMs = durationMs;
+                    scenarios++;
+                    if (!runScenario(sc, lim, NULL, 0, false)) {
+                        failed++;
+                    }
+                }
+            }
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    printf("%d scenarios, %d failed, %.0f ms host time (%.1f s simulated)\n", scenarios, failed, ms,
+           scenarios * durationMs / 1000.0f);
+    return failed == 0 ? SIM_EXIT_OK : SIM_EXIT_FAIL;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "用法: %s [--vin V] [--vout V] [--load res:<Ω>|cc:<A>] [--duration-ms ms]\n"
+            "          [--step-at ms --step res:<Ω>|cc:<A>] [--sag-at ms --sag V --sag-ms ms]\n"
+            "          [--trace file.csv] [--trace-us us]\n"
+            "       %s --sweep [--duration-ms ms]\n"
+            "限值: [--max-overshoot %%] [--max-deviation V] [--max-settle-ms ms] [--min-efficiency 0..1]\n",
+            prog, prog);
+}
+
+int main(int argc, char **argv) {
+    SimScenario sc;
+    memset(&sc, 0, sizeof(sc));
+    sc.vin = 12.0f;
+    sc.vout = 3.3f;
+    sc.load.kind = PLANT_LOAD_RESISTIVE;
+    sc.load.value = 0.0f;
+    sc.durationMs = 20.0f;
+    SimLimits lim = {5.0f, 0.6f, 8.0f, 0.6f, 1.0f};
+    const char *tracePath = NULL;
+    uint32_t traceUs = 10;
+    bool sweep = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        bool hasNext = i + 1 < argc;
+        if (strcmp(a, "--sweep") == 0) sweep = true;
+        else if (strcmp(a, "--vin") == 0 && hasNext) sc.vin = (float)atof(argv[++i]);
+        else if (strcmp(a, "--vout") == 0 && hasNext) sc.vout = (float)atof(argv[++i]);
+        else if (strcmp(a, "--duration-ms") == 0 && hasNext) sc.durationMs = (float)atof(argv[++i]);
+        else if (strcmp(a, "--step-at") == 0 && hasNext) sc.stepAtMs = (float)atof(argv[++i]);
+        else if (strcmp(a, "--sag-at") == 0 && hasNext) sc.sagAtMs = (float)atof(argv[++i]);
+        else if (strcmp(a, "--sag") == 0 && hasNext) { sc.hasSag = true; sc.sagV = (float)atof(argv[++i]); }
+        else if (strcmp(a, "--sag-ms") == 0 && hasNext) sc.sagMs = (float)atof(argv[++i]);
+        else if (strcmp(a, "--trace") == 0 && hasNext) tracePath = argv[++i];
+        else if (strcmp(a, "--trace-us") == 0 && hasNext) traceUs = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(a, "--max-overshoot") == 0 && hasNext) lim.maxOvershootPct = (float)atof(argv[++i]);
+        else if (strcmp(a, "--max-deviation") == 0 && hasNext) lim.maxDeviationV = (float)atof(argv[++i]);
+        else if (strcmp(a, "--max-settle-ms") == 0 && hasNext) lim.maxSettleMs = (float)atof(argv[++i]);
+        else if (strcmp(a, "--min-efficiency") == 0 && hasNext) lim.minEfficiency = (float)atof(argv[++i]);
+        else if (strcmp(a, "--load") == 0 && hasNext) {
+            if (!parseLoad(argv[++i], &sc.load)) {
+                usage(argv[0]);
+                return SIM_EXIT_USAGE;
+            }
+        } else if (strcmp(a, "--step") == 0 && hasNext) {
+            if (!parseLoad(argv[++i], &sc.step)) {
+                usage(argv[0]);
+                return SIM_EXIT_USAGE;
+            }
+            sc.hasStep = true;
+        } else {
+            usage(argv[0]);
+            return SIM_EXIT_USAGE;
+        }
+    }
+
+    if (sweep) {
+        return runSweep(lim, sc.durationMs);
+    }
+    if (sc.hasStep && (sc.stepAtMs <= 0.0f || sc.stepAtMs >= sc.durationMs)) {
+        fprintf(stderr, "--step-at 必须在 0 和 --duration-ms 之间\n");
+        return SIM_EXIT_USAGE;
+    }
+    return runScenario(sc, lim, tracePath, traceUs, true) ? SIM_EXIT_OK : SIM_EXIT_FAIL;
+}
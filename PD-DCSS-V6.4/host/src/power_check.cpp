@@ -0,0 +1,187 @@
+/**
+ * @file power_check.cpp
+ * @brief 电源管理（lib/myPower）的检查：各使用者对应的锁、手动调频和统计
+ * @details
+ * 主机HAL默认不支持电源管理（与没有启用 CONFIG_PM_ENABLE 的Arduino构建相同），
+ * host_set_pm_support() 打开后 halPmConfigure() 和锁可用。依次检查：
+ * - 没有电源管理：改为手动调频，只在 update() 中设置频率；有需要最高频率的使用者时240MHz，
+ *   嵌套的使用者都结束 POWER_MANUAL_HOLD_MS 之后才降到80MHz，每帧渲染的声明不切换频率；
+ *   平均频率按持有时间计算；
+ * - 动态调频和自动轻睡眠：各使用者持有的锁类型正确，全部结束后没有任何锁，
+ *   按键和编码器引脚登记为唤醒源，编码器按当前电平的相反电平唤醒，begin() 之前声明的使用者补上锁；
+ * - 只有动态调频：不配置自动轻睡眠；
+ * - 编码器延迟超过预算的计数和定时唤醒延迟的统计。
+ *
+ * 返回值见 check_util.h。
+ */
+
+#include <stdio.h>
+#include <math.h>
+
+#include "myPower.h"
+#include "myHAL.h"
+#include "host_stubs.h"
+#include "check_util.h"
+
+static const uint8_t WAKE_PINS[] = {19, 21};
+static const uint8_t ENCODER_PINS[] = {16, 17};
+
+static bool locksHeld(int cpu, int apb, int noSleep) {
+    return host_pm_lock_held(HAL_PM_CPU_MAX) == cpu && host_pm_lock_held(HAL_PM_APB_MAX) == apb &&
+           host_pm_lock_held(HAL_PM_NO_SLEEP) == noSleep;
+}
+
+static void checkManual() {
+    printf("没有电源管理（手动调频）\n");
+    MyPower p;
+    PowerMode mode = p.begin(WAKE_PINS, sizeof(WAKE_PINS));
+    check(mode == POWER_MODE_MANUAL, "改为手动调频");
+    check(halCpuMhz() == POWER_MIN_MHZ, "没有使用者时降到最低频率");
+    check(host_pm_wake_mask() == 0, "没有自动轻睡眠时不登记唤醒引脚");
+
+    p.setActive(POWER_CLIENT_SCREEN, true);
+    p.update();
+    check(halCpuMhz() == POWER_MIN_MHZ, "亮屏不需要最高频率");
+
+    uint32_t switches = host_cpu_switch_count();
+    p.setActive(POWER_CLIENT_CONTROL, true);
+    check(halCpuMhz() == POWER_MIN_MHZ, "声明的任务不设置频率");
+    p.update();
+    check(halCpuMhz() == POWER_MAX_MHZ && p.needsMaxClock(), "限流回路运行时升到最高频率");
+    host_advance_ms(500);
+    p.setActive(POWER_CLIENT_RENDER, true);
+    host_advance_ms(500);
+    p.setActive(POWER_CLIENT_CONTROL, false);
+    p.update();
+    check(halCpuMhz() == POWER_MAX_MHZ, "还在渲染时保持最高频率");
+    p.setActive(POWER_CLIENT_RENDER, true);
+    p.setActive(POWER_CLIENT_CONTROL, false);
+    p.setActive(POWER_CLIENT_RENDER, false);
+    p.update();
+    check(halCpuMhz() == POWER_MAX_MHZ, "刚结束时保持最高频率");
+    host_advance_ms(POWER_MANUAL_HOLD_MS);
+    p.update();
+    check(halCpuMhz() == POWER_MIN_MHZ, "都结束 POWER_MANUAL_HOLD_MS 后降到最低频率");
+    check(host_cpu_switch_count() - switches == 2, "嵌套和重复声明不多切换频率");
+
+    // 渲染每33ms声明一次（UI任务），每次调用 update()：一直保持最高频率
+    switches = host_cpu_switch_count();
+    for (int frame = 0; frame < 30; frame++) {
+        p.setActive(POWER_CLIENT_RENDER, true);
+        host_advance_ms(10);
+        p.setActive(POWER_CLIENT_RENDER, false);
+        p.update();
+        host_advance_ms(23);
+        p.update();
+    }
+    check(halCpuMhz() == POWER_MAX_MHZ && host_cpu_switch_count() - switches == 1, "渲染不每帧切换频率");
+    host_advance_ms(POWER_MANUAL_HOLD_MS);
+    p.update();
+    check(halCpuMhz() == POWER_MIN_MHZ && host_cpu_switch_count() - switches == 2, "渲染停止后降频一次");
+    host_advance_ms(3000 - POWER_MANUAL_HOLD_MS);
+
+    PowerStats st;
+    p.stats(st);
+    printf("    平均 %.1fMHz\n", p.averageMhz(st));
+    check(st.activations[POWER_CLIENT_CONTROL] == 1 && st.activations[POWER_CLIENT_RENDER] == 31,
+          "重复声明不计入次数");
+    check(st.heldUs[POWER_CLIENT_CONTROL] == 1000000 && st.heldUs[POWER_CLIENT_RENDER] == 800000,
+          "各使用者的持有时间");
+    check(st.cpuMaxUs == 1300000 && st.totalUs == 5990000, "需要最高频率的时间按并集计算");
+    check(fabsf(p.averageMhz(st) - (1.3f * POWER_MAX_MHZ + 4.69f * POWER_MIN_MHZ) / 5.99f) < 0.01f,
+          "平均频率按持有时间计算");
+    check(st.heldUs[POWER_CLIENT_SCREEN] == 5990000, "正在持有的部分算到现在");
+    p.setActive(POWER_CLIENT_SCREEN, false);
+}
+
+static void checkAutoSleep() {
+    printf("动态调频和自动轻睡眠\n");
+    host_set_pm_support(true, true);
+    MyPower p;
+    host_set_gpio(16, 1);
+    host_set_gpio(17, 1);
+    PowerMode mode = p.begin(WAKE_PINS, sizeof(WAKE_PINS), ENCODER_PINS, sizeof(ENCODER_PINS));
+    check(mode == POWER_MODE_AUTO_SLEEP && host_pm_light_sleep(), "配置自动轻睡眠");
+    check(host_pm_wake_mask() == ((1ULL << 19) | (1ULL << 21)), "按键引脚登记为唤醒源");
+    check(host_pm_wake_change_mask() == ((1ULL << 16) | (1ULL << 17)) && host_pm_wake_change_levels() == 0,
+          "编码器引脚登记为唤醒源，静止在高电平时低电平唤醒");
+    host_set_gpio(16, 0);
+    p.rearmWake();
+    check(host_pm_wake_change_levels() == (1ULL << 16), "旋转后按新电平重新登记");
+    host_set_gpio(16, 1);
+    p.rearmWake();
+    check(locksHeld(0, 0, 0), "没有使用者时没有锁");
+
+    uint32_t switches = host_cpu_switch_count();
+    p.setActive(POWER_CLIENT_CONTROL, true);
+    check(locksHeld(1, 0, 1), "限流回路：最高频率、不睡眠");
+    p.setActive(POWER_CLIENT_CONTROL, true);
+    check(locksHeld(1, 0, 1), "重复声明不重复获取");
+    p.setActive(POWER_CLIENT_ADC_STREAM, true);
+    check(locksHeld(1, 1, 2), "ADC连续采样：APB最高、不睡眠");
+    p.setActive(POWER_CLIENT_RENDER, true);
+    check(locksHeld(2, 2, 2), "渲染：最高频率、APB最高");
+    p.setActive(POWER_CLIENT_SCREEN, true);
+    check(locksHeld(2, 2, 3), "亮屏：不睡眠");
+    p.setActive(POWER_CLIENT_CONTROL, false);
+    p.setActive(POWER_CLIENT_ADC_STREAM, false);
+    p.setActive(POWER_CLIENT_RENDER, false);
+    p.setActive(POWER_CLIENT_SCREEN, false);
+    p.setActive(POWER_CLIENT_SCREEN, false);
+    check(locksHeld(0, 0, 0), "全部结束后没有任何锁");
+    p.update();
+    check(host_cpu_switch_count() == switches, "由esp_pm调频，不手动设置频率");
+
+    // 输出关闭、熄屏：只有定时唤醒，统计中允许轻睡眠的时间
+    host_advance_ms(1000);
+    p.setActive(POWER_CLIENT_SCREEN, true);
+    host_advance_ms(1000);
+    p.setActive(POWER_CLIENT_SCREEN, false);
+    PowerStats st;
+    p.stats(st);
+    check(st.noSleepUs == 1000000 && st.cpuMaxUs == 0, "不睡眠和最高频率的时间分别统计");
+    p.printReport();
+
+    MyPower early;
+    early.setActive(POWER_CLIENT_SCREEN, true);
+    early.begin(WAKE_PINS, sizeof(WAKE_PINS));
+    check(locksHeld(0, 0, 1), "begin() 之前声明的使用者补上锁");
+    early.setActive(POWER_CLIENT_SCREEN, false);
+    check(locksHeld(0, 0, 0), "之后照常释放");
+}
+
+static void checkDfsOnly() {
+    printf("只有动态调频\n");
+    host_set_pm_support(true, false);
+    MyPower p;
+    check(p.begin(WAKE_PINS, sizeof(WAKE_PINS)) == POWER_MODE_DFS && !host_pm_light_sleep(), "不配置自动轻睡眠");
+    p.setActive(POWER_CLIENT_RENDER, true);
+    check(locksHeld(1, 1, 0), "锁照常获取");
+    p.setActive(POWER_CLIENT_RENDER, false);
+    check(locksHeld(0, 0, 0), "锁照常释放");
+}
+
+static void checkLatency() {
+    printf("延迟统计\n");
+    MyPower p;
+    p.begin(WAKE_PINS, sizeof(WAKE_PINS));
+    p.recordInputLatency(800);
+    p.recordInputLatency(1200);
+    p.recordInputLatency(POWER_INPUT_BUDGET_US + 1);
+    p.recordTimerWake(0);
+    p.recordTimerWake(300);
+    PowerStats st;
+    p.stats(st);
+    check(st.inputs == 3 && st.overBudget == 1 && st.maxInputUs == POWER_INPUT_BUDGET_US + 1, "超过预算的编码器延迟");
+    check(st.timerWakes == 2 && st.timerLateUs == 300 && st.maxTimerLateUs == 300, "定时唤醒延迟");
+    p.printReport();
+}
+
+int main() {
+    checkManual();
+    checkAutoSleep();
+    checkDfsOnly();
+    checkLatency();
+
+    return checkResult();
+}
@@ -0,0 +1,259 @@
+/**
+ * @file presets_check.cpp
+ * @brief 预设（lib/myPresets）的检查：保存、空位和无效预设、一次发布的调用、调用到DAC任务写入的延迟和重新启动后恢复
+ * @details
+ * 运行固件的限流任务和DAC任务，DAC任务写入后经 MyPresets::onDacApplied 报告输出组的版本号。
+ * 输入固定为12V、输出空载，限流回路一直恒压；每次采样推进虚拟时钟50us作为采样耗时。
+ * 采集帧回调把本周期的DAC输出电压和保护阈值作为“本周期生效的组合”记录下来。依次检查：
+ * - 空位、编号超出范围的调用被拒绝，设定值不变；设定值不低于保护阈值时不能保存；
+ * - 保存：取已确认的设定值和当前的保护阈值，只改设置存储的内存记录；
+ * - 调用：设定值组和输出组在一次发布中改变，两个设定值都是已确认的；
+ *   限流任务看到的每个组合都是某个预设（或启动时）的完整组合，没有新设定值配旧阈值；
+ *   从调用到DAC任务写入不超过一个周期；输出关闭时调用、与当前设定相同的调用不计延迟；
+ * - 选择：第一次从最近调用的预设开始，前后循环，取出后结束选择；
+ * - 重新启动：设置存储写入后，新的实例一次读取恢复全部预设。
+ *
+ * 返回值见 check_util.h。
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "myPresets.h"
+#include "mySettings.h"
+#include "mySystemState.h"
+#include "myRegulator.h"
+#include "myProtection.h"
+#include "myDAC.h"
+#include "myTaskTable.h"
+#include "myHAL.h"
+#include "host_stubs.h"
+#include "check_util.h"
+
+#define CHECK_PERIOD_MS REGULATOR_PERIOD_MS
+#define CHECK_STEP_US 50
+#define CHECK_UIN_MV 12000
+
+// 与 main.cpp 任务表中的条目相同
+static const TaskSpec TASKS[] = {
+    {"DAC_Task",  NULL, 2048, TASK_CLASS_CONTROL,  TASK_CORE_CONTROL, TASK_STACK_INTERNAL, NULL},
+    {"Regulator", NULL, 3072, TASK_CLASS_REALTIME, TASK_CORE_CONTROL, TASK_STACK_INTERNAL, NULL},
+};
+
+static uint32_t s_mixed = 0;         // 限流任务看到的不属于任何预设的组合
+
+// 允许出现的组合：启动时和两个预设
+struct Combination {
+    float dac;
+    ProtectionLimits limits;
+};
+static Combination s_allowed[3];
+static int s_allowedCount = 0;
+
+static void allow(float dac, const ProtectionLimits &limits) {
+    s_allowed[s_allowedCount].dac = dac;
+    s_allowed[s_allowedCount].limits = limits;
+    s_allowedCount++;
+}
+
+static bool allowed(float dac, const ProtectionLimits &limits) {
+    for (int i = 0; i < s_allowedCount; i++) {
+        if (s_allowed[i].dac == dac && memcmp(&s_allowed[i].limits, &limits, sizeof(limits)) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 与 MyADC::readFrame 相同，校准系数为1；采样耗时推进虚拟时钟
+static void readFrame(AdcFrame &frame, void *ctx) {
+    (void)ctx;
+    host_advance_us(CHECK_STEP_US);
+    frame.timeUs = (int64_t)halMicros();
+    frame.uIn = halAdcRawToMv(halAdcReadRaw(0)) / 1000.0f;
+    frame.iIn = halAdcRawToMv(halAdcReadRaw(1)) / 1000.0f;
+    frame.uOut = halAdcRawToMv(halAdcReadRaw(2)) / 1000.0f;
+    frame.iOut = halAdcRawToMv(halAdcReadRaw(3)) / 1000.0f;
+}
+
+// 限流回路本周期写DAC的电压和使用的保护阈值（恒压时DAC输出电压等于设定值）
+static void onFrame(const AdcFrame &frame, void *ctx) {
+    (void)frame;
+    (void)ctx;
+    if (!allowed(regulator.getCommand(), protection.getLimits())) {
+        s_mixed++;
+    }
+}
+
+static ProtectionLimits tightLimits() {
+    ProtectionLimits l = protectionDefaultLimits();
+    l.ovpV = 13.2f;
+    l.ocpA = 1.2f;
+    l.oppW = 15.0f;
+    return l;
+}
+
+// 与编码器确认设定值相同的发布方式
+static void confirmSetpoint(float u, float i) {
+    systemState.setSetpoint(u, true, true);
+    systemState.setCurrentSetpoint(i, true, false);
+    systemState.setDacVoltage(u);
+    systemState.setCurrentLimit(i);
+}
+
+static void checkReject() {
+    printf("空位和无效预设\n");
+    SystemState before;
+    systemState.snapshot(before);
+    PresetStats st;
+    check(!presets.recall(3), "空位不能调用");
+    check(!presets.recall(0) && !presets.recall(PRESET_COUNT + 1), "编号超出范围不能调用");
+    presets.stats(st);
+    SystemState after;
+    systemState.snapshot(after);
+    check(st.rejected == 3 && st.recalls == 0 && after.version == before.version, "设定值不变");
+
+    // 阈值低于设定值：调用后会立即触发保护
+    ProtectionLimits low = protectionDefaultLimits();
+    low.ovpV = 4.0f;
+    systemState.setProtectionLimits(low);
+    SettingsPreset p;
+    check(!presets.store(4) && !presets.get(4, p), "设定值不低于过压阈值时不能保存");
+    systemState.setProtectionLimits(protectionDefaultLimits());
+}
+
+static void checkStore() {
+    printf("保存\n");
+    check(presets.store(1), "保存M1");
+    SettingsPreset p;
+    check(presets.get(1, p) && p.uSet == 5.00f && p.iSet == 2.00f && p.limits.ovpV == protectionDefaultLimits().ovpV,
+          "M1为已确认的设定值和当前阈值");
+
+    // 编辑中（未确认）的设定值不保存
+    systemState.setSetpoint(7.00f, false, true);
+    systemState.setCurrentSetpoint(1.50f, false, false);
+    check(presets.store(9) && presets.get(9, p) && p.uSet == 5.00f && p.iSet == 2.00f, "未确认的设定值不保存");
+
+    confirmSetpoint(12.00f, 1.00f);
+    systemState.setProtectionLimits(tightLimits());
+    allow(12.00f, tightLimits());
+    check(presets.store(2), "保存M2");
+    check(settings.isDirty(), "只改内存记录，按设置存储的规则延迟写入");
+
+    // 回到M1的组合，之后由调用切换
+    confirmSetpoint(5.00f, 2.00f);
+    systemState.setProtectionLimits(protectionDefaultLimits());
+    host_run_tasks(10);
+}
+
+static void checkRecall() {
+    printf("调用\n");
+    uint32_t mixed = s_mixed;
+    SystemState before;
+    systemState.snapshot(before);
+    check(presets.recall(2), "调用M2");
+    SystemState after;
+    systemState.snapshot(after);
+    check(after.version == before.version + 2, "一次发布");
+    check(after.groupVersion[SYSSTATE_GROUP_SETPOINT] == before.groupVersion[SYSSTATE_GROUP_SETPOINT] + 1 &&
+          after.groupVersion[SYSSTATE_GROUP_OUTPUT] == before.groupVersion[SYSSTATE_GROUP_OUTPUT] + 1,
+          "设定值组和输出组各变化一次");
+    check(after.uSet == 12.00f && after.uSetConfirmed && after.iSet == 1.00f && after.iSetConfirmed &&
+          after.dacVoltage == 12.00f && after.iLimit == 1.00f && after.limits.ovpV == tightLimits().ovpV,
+          "设定值（已确认）、DAC目标电压、限流值和保护阈值");
+
+    host_run_tasks(CHECK_PERIOD_MS + 1);
+    PresetStats st;
+    presets.stats(st);
+    printf("    从调用到DAC任务写入 %luus（周期 %dms）\n", (unsigned long)st.lastLatencyUs, CHECK_PERIOD_MS);
+    check(st.measured == 1 && st.lastLatencyUs <= CHECK_PERIOD_MS * 1000 + CHECK_STEP_US, "延迟不超过一个周期");
+
+    // 来回调用多次
+    for (int i = 0; i < 50; i++) {
+        presets.recall(i % 2 == 0 ? 1 : 2);
+        host_run_tasks(CHECK_PERIOD_MS + i % 5);
+    }
+    host_run_tasks(10);
+    presets.stats(st);
+    check(s_mixed == mixed, "限流任务没有看到新设定值配旧阈值的组合");
+    check(st.recalls == 51 && st.measured == 51, "每次调用都计入延迟");
+    check(st.maxLatencyUs <= CHECK_PERIOD_MS * 1000 + CHECK_STEP_US, "最长延迟不超过一个周期");
+
+    // 输出关闭时调用：设定值照常发布，不计延迟
+    systemState.setOutputEnabled(false);
+    check(presets.recall(1), "输出关闭时调用");
+    host_run_tasks(10);
+    systemState.setOutputEnabled(true);
+    host_run_tasks(10);
+    PresetStats off;
+    presets.stats(off);
+    check(off.recalls == st.recalls + 1 && off.measured == st.measured && systemState.getDacVoltage() == 5.00f,
+          "不计入延迟统计");
+
+    // 内容相同的调用不改变版本号，没有需要等待的写入
+    check(presets.recall(1), "调用与当前相同的预设");
+    host_run_tasks(CHECK_PERIOD_MS + 1);
+    presets.stats(st);
+    check(st.recalls == off.recalls + 1 && st.measured == off.measured, "不计入延迟统计");
+}
+
+static void checkSelect() {
+    printf("选择\n");
+    check(presets.lastSlot() == 1 && presets.select(1) == 1, "第一次从最近调用的预设开始");
+    check(presets.select(-1) == PRESET_COUNT && presets.select(1) == 1 && presets.select(3) == 4, "前后循环");
+    check(presets.takeSelection() == 4 && presets.selection() == 0 && presets.takeSelection() == 0, "取出后结束选择");
+    presets.selectSlot(PRESET_COUNT + 1);
+    check(presets.selection() == 0, "编号超出范围时不选择");
+}
+
+static void checkRestore() {
+    printf("重新启动\n");
+    host_run_tasks(SETTINGS_MAX_DELAY_MS + SETTINGS_MIN_INTERVAL_MS);
+    check(!settings.isDirty(), "设置存储已写入");
+    MySettings next;
+    check(next.begin(checkDefaultSettings()), "恢复保存的记录");
+    Settings s;
+    next.get(s);
+    check(s.presets[0].valid && s.presets[1].valid && s.presets[8].valid && !s.presets[2].valid, "恢复全部预设");
+    check(s.presets[1].uSet == 12.00f && s.presets[1].iSet == 1.00f &&
+          memcmp(&s.presets[1].limits, &s_allowed[1].limits, sizeof(ProtectionLimits)) == 0, "预设的设定值和阈值");
+
+    // 预设不能使用（阈值低于设定值）时整个记录不使用
+    struct {
+        uint32_t version;
+        Settings settings;
+    } rec = {SETTINGS_VERSION, s};
+    rec.settings.presets[1].limits.ovpV = 11.0f;
+    halNvsSave(SETTINGS_NVS_NAMESPACE, SETTINGS_NVS_KEY, &rec, sizeof(rec));
+    MySettings bad;
+    check(!bad.begin(checkDefaultSettings()), "预设无效时使用默认值");
+}
+
+int main() {
+    taskTableInstall(TASKS, sizeof(TASKS) / sizeof(TASKS[0]));
+    host_nvs_clear();
+    host_set_adc_mv(0, CHECK_UIN_MV);
+    settings.begin(checkDefaultSettings());
+    confirmSetpoint(5.00f, 2.00f);
+    allow(5.00f, protectionDefaultLimits());
+    systemState.setOutputEnabled(true);
+    settings.start();
+
+    MyDAC dac(5, 7, 6);
+    dac.begin();
+    addDACAppliedHandler(MyPresets::onDacApplied, &presets);
+    createDACTask(&dac);
+    regulator.addFrameCallback(onFrame, NULL);
+    regulator.begin(readFrame, NULL);
+    host_run_tasks(10);
+
+    checkReject();
+    checkStore();
+    checkRecall();
+    checkSelect();
+    checkRestore();
+
+    presets.printReport();
+    return checkResult();
+}
@@ -0,0 +1,191 @@
+/**
+ * @file protection_check.cpp
+ * @brief 输出保护（lib/myProtection）和限流回路（lib/myRegulator）与降压变换器模型闭环的检查，不需要LVGL
+ * @details
+ * 运行固件的限流任务和DAC任务：限流任务每2ms按 MyADC::readFrame 的方式（校准系数为1）读取模型写入的
+ * ADC通道，DAC任务经HAL的SPI驱动模型的基准。12V输入、4Ω负载，设定值4.00V/3.00A。依次检查：
+ * - OVP、OCP：阈值降到当前输出以下，一个采样周期内锁存告警、SPI写0x0000，
+ *   从采样到DAC写0的触发延迟不超过100us；锁存期间不再写DAC，输出降到0；
+ * - UVLO：输入跌落到2V，OPP：功率阈值降到3W，连续 PROTECTION_FILTER_SAMPLES 个采样后触发；
+ *   UVLO在跌落结束后仍然锁存；
+ * - 确认只登记请求，限流任务在下一个周期解除锁存；每种保护在阈值恢复、确认告警后
+ *   从设定值重新稳压到4.00V；
+ * - 恒压/恒流切换：限流值降到0.50A后一个周期内进入恒流，输出折返到0.50A×4Ω = 2.00V，
+ *   不触发保护；负载换成10Ω后电流低于限流值，输出逐步回到4.00V并恢复恒压。
+ *
+ * 返回值见 check_util.h。
+ */
+
+#include <stdio.h>
+#include <math.h>
+
+#include "freertos/FreeRTOS.h"
+#include "myRegulator.h"
+#include "myProtection.h"
+#include "myDAC.h"
+#include "mySystemState.h"
+#include "myTaskTable.h"
+#include "myHAL.h"
+#include "host_plant.h"
+#include "host_stubs.h"
+#include "check_util.h"
+
+#define CHECK_PERIOD_US (REGULATOR_PERIOD_MS * 1000)
+#define CHECK_POLL_MS 1                // 等待触发时每次推进的时间
+#define CHECK_TRIP_LATENCY_US 100      // 从采样到DAC写0
+#define CHECK_VOUT_TOLERANCE 0.02f
+#define CHECK_SPI_4V 0x0f9c            // 4.00V -> 999 << 2
+
+// 与 main.cpp 任务表中的条目相同
+static const TaskSpec TASKS[] = {
+    {"DAC_Task",  NULL, 2048, TASK_CLASS_CONTROL,  TASK_CORE_CONTROL, TASK_STACK_INTERNAL, NULL},
+    {"Regulator", NULL, 3072, TASK_CLASS_REALTIME, TASK_CORE_CONTROL, TASK_STACK_INTERNAL, NULL},
+};
+
+static HostPlant *s_plant = NULL;
+
+// 与 MyADC::readFrame 相同，校准系数为1（模型按1V对应1000mV写ADC通道）
+static void readFrame(AdcFrame &frame, void *ctx) {
+    (void)ctx;
+    frame.timeUs = (int64_t)halMicros();
+    frame.uIn = halAdcRawToMv(halAdcReadRaw(0)) / 1000.0f;
+    frame.iIn = halAdcRawToMv(halAdcReadRaw(1)) / 1000.0f;
+    frame.uOut = halAdcRawToMv(halAdcReadRaw(2)) / 1000.0f;
+    frame.iOut = halAdcRawToMv(halAdcReadRaw(3)) / 1000.0f;
+}
+
+static uint32_t alarms() {
+    SystemState s;
+    systemState.snapshot(s);
+    return s.alarms & PROT_ALARM_MASK;
+}
+
+static bool voutNear(float v) {
+    return fabsf(s_plant->state().vout - v) <= CHECK_VOUT_TOLERANCE;
+}
+
+static void setLimit(float ProtectionLimits::*field, float value) {
+    SystemState s;
+    systemState.snapshot(s);
+    ProtectionLimits l = s.limits;
+    l.*field = value;
+    systemState.setProtectionLimits(l);
+}
+
+// 按 CHECK_POLL_MS 推进，直到锁存告警或超时，返回从调用到DAC写0的时间(us)，超时返回-1
+static int64_t waitTrip(uint32_t timeoutMs) {
+    uint64_t t0 = halMicros();
+    for (uint32_t i = 0; i < timeoutMs; i += CHECK_POLL_MS) {
+        host_run_tasks(CHECK_POLL_MS);
+        if (protection.isTripped() && host_spi_last_word() == 0x0000) {
+            return (int64_t)(halMicros() - t0);
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief 触发一种保护并检查告警、DAC写0、延迟和锁存，然后恢复阈值、确认并检查重新稳压
+ * @param samples 触发需要的连续采样数
+ */
+static void checkTrip(const char *name, uint32_t alarm, uint32_t samples, void (*inject)(), void (*restore)()) {
+    printf("%s\n", name);
+    uint32_t trips = protection.getTripCount();
+    inject();
+    int64_t us = waitTrip(50);
+    // 条件出现后的第samples个采样触发，加上推进的粒度
+    uint32_t bound = samples * CHECK_PERIOD_US + CHECK_POLL_MS * 1000;
+    printf("    从条件出现到DAC写0 %lldus（上限 %luus）  从采样到DAC写0 %luus\n", (long long)us,
+           (unsigned long)bound, (unsigned long)protection.getLastLatencyUs());
+    check(us >= 0 && alarms() == alarm && protection.getTripCount() == trips + 1, "锁存对应的告警");
+    check(host_spi_last_word() == 0x0000, "SPI写0x0000");
+    check(us >= 0 && (uint64_t)us <= bound, samples == 1 ? "一个采样周期内触发" : "连续采样超限后立即触发");
+    check(protection.getLastLatencyUs() <= CHECK_TRIP_LATENCY_US, "从采样到DAC写0不超过100us");
+
+    uint32_t writes = host_spi_write_count();
+    host_run_tasks(100);
+    check(protection.isTripped() && host_spi_write_count() == writes && s_plant->state().vout < 0.1f,
+          "锁存期间不写DAC，输出降到0");
+
+    restore();
+    protection.acknowledge();
+    check(protection.isTripped() && alarms() == alarm, "确认后由限流任务解除锁存");
+    host_run_tasks(REGULATOR_PERIOD_MS);
+    check(!protection.isTripped(), "下一个周期解除锁存");
+    host_run_tasks(100);
+    check(alarms() == 0 && !protection.isTripped() && voutNear(4.00f) && host_spi_last_word() == CHECK_SPI_4V,
+          "确认后重新稳压到4.00V");
+}
+
+static void injectOvp() { setLimit(&ProtectionLimits::ovpV, 3.5f); }
+static void restoreOvp() { setLimit(&ProtectionLimits::ovpV, protectionDefaultLimits().ovpV); }
+static void injectOcp() { setLimit(&ProtectionLimits::ocpA, 0.8f); }
+static void restoreOcp() { setLimit(&ProtectionLimits::ocpA, protectionDefaultLimits().ocpA); }
+static void injectUvlo() { s_plant->scheduleSag(halMicros(), 50000, 10.0f); }
+static void restoreUvlo() { host_run_tasks(50); }
+static void injectOpp() { setLimit(&ProtectionLimits::oppW, 3.0f); }
+static void restoreOpp() { setLimit(&ProtectionLimits::oppW, protectionDefaultLimits().oppW); }
+
+static void checkUvloLatched() {
+    // 跌落已经结束，告警仍然锁存到确认
+    printf("UVLO锁存\n");
+    s_plant->scheduleSag(halMicros(), 20000, 10.0f);
+    host_run_tasks(60);
+    check(protection.isTripped() && alarms() == PROT_ALARM_UVLO && s_plant->state().vin > 11.0f,
+          "输入恢复后告警仍然锁存");
+    protection.acknowledge();
+    host_run_tasks(100);
+    check(alarms() == 0 && voutNear(4.00f), "确认后重新稳压");
+}
+
+static void checkCrossover() {
+    printf("恒压/恒流切换\n");
+    systemState.setCurrentLimit(0.50f);
+    host_run_tasks(2 * REGULATOR_PERIOD_MS);
+    check(regulator.getMode() == SYS_MODE_CC, "电流超过限流值，一个周期内进入恒流");
+    host_run_tasks(200);
+    printf("    恒流 %.3fV %.3fA\n", s_plant->state().vout, s_plant->state().iload);
+    check(voutNear(2.00f) && fabsf(s_plant->state().iload - 0.50f) <= 0.01f, "输出折返到 0.50A×4Ω = 2.00V");
+    check(alarms() == 0 && !protection.isTripped(), "折返不触发保护");
+
+    s_plant->setLoad(PLANT_LOAD_RESISTIVE, 10.0f);
+    host_run_tasks(300);
+    check(regulator.getMode() == SYS_MODE_CV && voutNear(4.00f), "电流低于限流值后回到4.00V并恢复恒压");
+
+    systemState.setCurrentLimit(3.00f);
+    s_plant->setLoad(PLANT_LOAD_RESISTIVE, 4.0f);
+    host_run_tasks(100);
+}
+
+int main() {
+    taskTableInstall(TASKS, sizeof(TASKS) / sizeof(TASKS[0]));
+
+    HostPlant plant(plantDefaultParams());
+    plant.setLoad(PLANT_LOAD_RESISTIVE, 4.0f);
+    plant.attachToClock();
+    s_plant = &plant;
+
+    MyDAC dac(5, 7, 6);
+    dac.begin();
+    createDACTask(&dac);
+    systemState.setSetpoint(4.00f, true, true);
+    systemState.setCurrentSetpoint(3.00f, true, false);
+    systemState.setDacVoltage(4.00f);
+    systemState.setCurrentLimit(3.00f);
+    systemState.setOutputEnabled(true);
+    regulator.begin(readFrame, NULL);
+    host_run_tasks(300);
+
+    printf("启动\n");
+    check(alarms() == 0 && voutNear(4.00f) && host_spi_last_word() == CHECK_SPI_4V, "稳压到4.00V，没有告警");
+
+    checkTrip("OVP", PROT_ALARM_OVP, 1, injectOvp, restoreOvp);
+    checkTrip("OCP", PROT_ALARM_OCP, 1, injectOcp, restoreOcp);
+    checkTrip("UVLO", PROT_ALARM_UVLO, PROTECTION_FILTER_SAMPLES, injectUvlo, restoreUvlo);
+    checkUvloLatched();
+    checkTrip("OPP", PROT_ALARM_OPP, PROTECTION_FILTER_SAMPLES, injectOpp, restoreOpp);
+    checkCrossover();
+
+    protection.printReport();
+    return checkResult();
+}
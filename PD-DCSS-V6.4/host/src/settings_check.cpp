@@ -0,0 +1,221 @@
+/**
+ * @file settings_check.cpp
+ * @brief 设置存储（lib/mySettings）的检查：一次读取恢复、修改合并、写入时机、掉电写入和flash写入次数
+ * @details
+ * 设定值的修改和编码器一样经系统状态发布，U_IN由脚本直接交给 MySettings::onFrame()（代替限流任务），
+ * 写入次数由主机NVS计数。依次检查：
+ * - 没有保存的记录：使用默认值，启动时只读一次；发布与记录相同的设定值不写入；
+ * - 大量旋转：10分钟内每20ms转一格、每2.2秒确认一次，写入次数按最迟写入时间计不超过11次，
+ *   未确认的设定值不算修改；停止后安静一段时间写入最后确认的值；
+ * - 单次修改安静3秒后写入；刚写入过时等到最短间隔；改了又改回去不写入；
+ * - U_IN跌落：连续两个采样低于平常值的85%立即写入，单个采样的毛刺不触发，
+ *   输入换到较低的电压只触发一次；
+ * - 重新启动：一次读取恢复最后写入的值；版本不符或内容无效时使用默认值；
+ * - 只改一个字段：保存预设不改变设定值，保存设定值不改变预设，未确认的设定值保持原值。
+ *
+ * 返回值见 check_util.h。
+ */
+
+#include <stdio.h>
+#include <math.h>
+
+#include "mySettings.h"
+#include "mySystemState.h"
+#include "myHAL.h"
+#include "host_stubs.h"
+#include "check_util.h"
+
+#define CHECK_DETENT_MS 20          // 旋转时每格的间隔
+#define CHECK_CONFIRM_EVERY 110     // 每隔多少格确认一次（2.2秒，短于安静期）
+#define CHECK_KNOB_MINUTES 10
+#define CHECK_FRAME_US 2000         // 采集帧间隔（与限流任务相同）
+
+static float savedUSet() {
+    Settings s;
+    settings.get(s);
+    return s.uSet;
+}
+
+// 与编码器相同的发布方式：确认前只有设定值变化，确认后设定值标记为已确认
+static void publishUSet(float u, bool confirmed) {
+    systemState.setSetpoint(u, confirmed, true);
+}
+
+static void feedUIn(float uIn, int frames) {
+    for (int i = 0; i < frames; i++) {
+        AdcFrame f = {(int64_t)halMicros(), uIn, 0.5f, 5.0f, 1.0f};
+        MySettings::onFrame(f, &settings);
+        host_advance_us(CHECK_FRAME_US);
+    }
+}
+
+static void checkDefaults() {
+    printf("没有保存的记录\n");
+    host_nvs_clear();
+    uint32_t reads = host_nvs_read_count();
+    Settings d = checkDefaultSettings();
+    check(!settings.begin(d), "使用默认值");
+    check(host_nvs_read_count() - reads == 1, "启动时只读一次");
+    Settings s;
+    settings.get(s);
+    check(s.uSet == d.uSet && s.iSetMax == d.iSetMax && s.fineStep && s.adcFactors[3] == 1.0f, "默认值");
+
+    publishUSet(d.uSet, true);
+    systemState.setCurrentSetpoint(d.iSet, true, false);
+    check(settings.start(), "开始监听设定值");
+    uint32_t writes = host_nvs_write_count();
+    host_run_tasks(SETTINGS_MAX_DELAY_MS + 10000);
+    check(host_nvs_write_count() == writes && !settings.isDirty(), "与记录相同的设定值不写入");
+}
+
+static void checkKnob() {
+    printf("大量旋转\n");
+    SettingsStats before;
+    settings.stats(before);
+    uint32_t writes = host_nvs_write_count();
+    uint32_t detents = CHECK_KNOB_MINUTES * 60 * 1000 / CHECK_DETENT_MS;
+    float u = 5.00f;
+    float lastConfirmed = u;
+    for (uint32_t i = 1; i <= detents; i++) {
+        // 在5.0V和10.0V之间来回转
+        u = 5.00f + 0.10f * (float)((i / 50) % 2 == 0 ? i % 50 : 50 - i % 50);
+        bool confirm = i % CHECK_CONFIRM_EVERY == 0;
+        publishUSet(u, confirm);
+        if (confirm) {
+            lastConfirmed = u;
+        }
+        host_run_tasks(CHECK_DETENT_MS);
+    }
+    SettingsStats after;
+    settings.stats(after);
+    uint32_t n = host_nvs_write_count() - writes;
+    uint32_t changes = after.changes - before.changes;
+    uint32_t maxWrites = CHECK_KNOB_MINUTES * 60000 / SETTINGS_MAX_DELAY_MS + 1;
+    printf("    %lu格，确认 %lu次，记录修改 %lu次，写入flash %lu次\n", (unsigned long)detents,
+           (unsigned long)(detents / CHECK_CONFIRM_EVERY), (unsigned long)changes, (unsigned long)n);
+    check(changes <= detents / CHECK_CONFIRM_EVERY, "未确认的设定值不算修改");
+    check(n >= 1 && n <= maxWrites, "一直在修改时按最迟写入时间写入");
+    check(after.writes - before.writes == n, "写入计数与flash写入次数一致");
+
+    host_run_tasks(SETTINGS_MIN_INTERVAL_MS + SETTINGS_QUIET_MS);
+    check(!settings.isDirty() && fabsf(savedUSet() - lastConfirmed) < 1e-4f, "停止后写入最后确认的值");
+}
+
+static void checkTiming() {
+    printf("写入时机\n");
+    host_run_tasks(SETTINGS_MIN_INTERVAL_MS);
+    uint32_t writes = host_nvs_write_count();
+    publishUSet(7.30f, true);
+    host_run_tasks(SETTINGS_QUIET_MS - 500);
+    check(host_nvs_write_count() == writes && settings.isDirty(), "安静期间不写入");
+    host_run_tasks(600);
+    check(host_nvs_write_count() == writes + 1 && !settings.isDirty(), "安静3秒后写入");
+
+    publishUSet(7.70f, true);
+    host_run_tasks(SETTINGS_QUIET_MS + 500);
+    check(host_nvs_write_count() == writes + 1, "刚写入过：安静后仍等待最短间隔");
+    host_run_tasks(SETTINGS_MIN_INTERVAL_MS - SETTINGS_QUIET_MS);
+    check(host_nvs_write_count() == writes + 2, "到最短间隔时写入");
+
+    SettingsStats before;
+    settings.stats(before);
+    host_run_tasks(SETTINGS_MIN_INTERVAL_MS);
+    publishUSet(8.20f, true);
+    host_run_tasks(500);
+    publishUSet(7.70f, true);
+    host_run_tasks(SETTINGS_MIN_INTERVAL_MS);
+    SettingsStats after;
+    settings.stats(after);
+    check(host_nvs_write_count() == writes + 2 && after.skipped == before.skipped + 1, "改了又改回去不写入");
+}
+
+static void checkDrop() {
+    printf("输入跌落\n");
+    feedUIn(12.0f, 500);
+    uint32_t writes = host_nvs_write_count();
+    publishUSet(9.00f, true);
+    host_run_tasks(1);
+    feedUIn(12.0f * SETTINGS_DROP_RATIO - 1.0f, 1);
+    feedUIn(12.0f, 10);
+    host_run_tasks(1);
+    check(host_nvs_write_count() == writes && settings.isDirty(), "单个采样的毛刺不触发");
+
+    feedUIn(8.0f, SETTINGS_DROP_SAMPLES);
+    host_run_tasks(1);
+    SettingsStats st;
+    settings.stats(st);
+    printf("    从检测到写入完成 %luus\n", (unsigned long)st.lastDropUs);
+    check(host_nvs_write_count() == writes + 1 && !settings.isDirty() && st.dropWrites == 1, "立即写入未保存的修改");
+    check(st.lastDropUs <= CHECK_FRAME_US + 1000, "不等待安静期和最短间隔");
+
+    // 输入恢复后又换到9V（例如PD重新协商）：触发一次，平常值追上后不再触发
+    feedUIn(12.0f, 2000);
+    uint32_t drops = st.drops;
+    feedUIn(9.0f, 5000);
+    host_run_tasks(1);
+    settings.stats(st);
+    check(st.drops == drops + 1 && host_nvs_write_count() == writes + 1, "没有未保存的修改时不写入，换到较低电压只触发一次");
+    feedUIn(9.0f * SETTINGS_DROP_RATIO - 0.5f, SETTINGS_DROP_SAMPLES);
+    settings.stats(st);
+    check(st.drops == drops + 2, "追上新的平常值后重新检测");
+    feedUIn(9.0f, 2000);
+}
+
+static void checkRestore() {
+    printf("重新启动\n");
+    Settings cur;
+    settings.get(cur);
+    MySettings next;
+    uint32_t reads = host_nvs_read_count();
+    check(next.begin(checkDefaultSettings()), "恢复保存的记录");
+    check(host_nvs_read_count() - reads == 1, "只读一次");
+    Settings s;
+    next.get(s);
+    check(fabsf(s.uSet - 9.00f) < 1e-4f && s.uSet == cur.uSet && s.fineStep == cur.fineStep, "恢复最后写入的值");
+
+    struct {
+        uint32_t version;
+        Settings settings;
+    } rec = {SETTINGS_VERSION + 1, cur};
+    halNvsSave(SETTINGS_NVS_NAMESPACE, SETTINGS_NVS_KEY, &rec, sizeof(rec));
+    MySettings old;
+    check(!old.begin(checkDefaultSettings()), "版本不符时使用默认值");
+    rec.version = SETTINGS_VERSION;
+    rec.settings.uSet = 99.0f;
+    halNvsSave(SETTINGS_NVS_NAMESPACE, SETTINGS_NVS_KEY, &rec, sizeof(rec));
+    MySettings bad;
+    check(!bad.begin(checkDefaultSettings()), "设定值超出范围时使用默认值");
+    bad.get(s);
+    check(s.uSet == checkDefaultSettings().uSet, "默认值");
+}
+
+static void checkFields() {
+    printf("只改一个字段\n");
+    publishUSet(7.00f, true);
+    host_run_tasks(10);
+    SettingsPreset p = {true, 6.00f, 1.00f, protectionDefaultLimits()};
+    check(settings.setPreset(1, p), "保存预设");
+    check(!settings.setPreset(1, p) && !settings.setPreset(0, p) && !settings.setPreset(SETTINGS_PRESET_COUNT + 1, p),
+          "相同内容和无效位置不算修改");
+    Settings s;
+    settings.get(s);
+    check(fabsf(s.uSet - 7.00f) < 1e-4f, "保存预设不改变设定值");
+
+    check(settings.setSetpoint(NAN, 1.20f, false), "保存设定值");
+    settings.get(s);
+    check(fabsf(s.uSet - 7.00f) < 1e-4f && fabsf(s.iSet - 1.20f) < 1e-4f && !s.fineStep, "NAN保持原值");
+    check(s.presets[0].valid && s.presets[0].uSet == p.uSet && s.presets[0].iSet == p.iSet, "保存设定值不改变预设");
+    check(!settings.setSetpoint(NAN, NAN, false), "没有变化不算修改");
+}
+
+int main() {
+    checkDefaults();
+    checkKnob();
+    checkTiming();
+    checkDrop();
+    checkRestore();
+    checkFields();
+
+    settings.printReport();
+    return checkResult();
+}
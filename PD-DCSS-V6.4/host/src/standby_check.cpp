@@ -0,0 +1,207 @@
+/**
+ * @file standby_check.cpp
+ * @brief 待机（lib/myStandby）的检查：进入和恢复的状态机、任务通知唤醒和用时统计
+ * @details
+ * 限流任务依赖ADC，这里用一个按相同方式运行的任务代替：输出打开时每2ms一个周期，
+ * 输出关闭时第一次关断DAC，之后每20ms一个待机周期并调用 outputOff()，
+ * 在 ulTaskNotifyTake() 中等待（恢复时被通知立即唤醒）；恢复时解除关断，
+ * 调用 outputOn() 后通过DAC任务写回设定值。每个周期推进虚拟时钟50us作为采样耗时。
+ * DAC任务和 MyStandby::onDacApplied() 与 main.cpp 相同。
+ * 依次检查：
+ * - 进入待机：立即发布输出关闭、背光变暗，下一个周期关断DAC，进入用时不超过一个周期；
+ * - 待机期间按20ms的周期检查（保护保持有效），不再按2ms运行；
+ * - 恢复：被通知的任务在请求后立即运行，用时远小于待机周期，计时到DAC任务写入SPI为止；
+ * - 保护锁存时恢复：DAC保持0V，不计恢复用时，单独计数；
+ * - 进入后立即恢复、恢复后立即进入都能回到稳定状态，重复请求不计次数；
+ * - 没有经过 enter()/resume() 的输出开关变化只改变状态，累计待机时间照常统计。
+ *
+ * 返回值见 check_util.h。
+ */
+
+#include <stdio.h>
+
+#include "myStandby.h"
+#include "myDAC.h"
+#include "myTaskTable.h"
+#include "myBacklight.h"
+#include "mySystemState.h"
+#include "myHAL.h"
+#include "host_stubs.h"
+#include "check_util.h"
+
+#define CHECK_PERIOD_MS 2
+#define CHECK_STANDBY_PERIOD_MS 20
+#define CHECK_STEP_US 50
+#define CHECK_DAC_VOLTAGE 2.5f
+
+// 与 main.cpp 任务表中的条目相同
+static const TaskSpec TASKS[] = {
+    {"DAC_Task",  NULL, 2048, TASK_CLASS_CONTROL,  TASK_CORE_CONTROL, TASK_STACK_INTERNAL, NULL},
+};
+
+static uint32_t s_activeSteps = 0;
+static uint32_t s_standbySteps = 0;
+static uint32_t s_dacOffs = 0;
+static volatile bool s_tripped = false;   // 代替 protection.check() 的结果
+
+// 与 MyRegulator::taskEntry 和 step() 的待机部分相同
+static void controlTask(void *param) {
+    (void)param;
+    bool dacOff = false;
+    TickType_t lastWake = xTaskGetTickCount();
+    while (true) {
+        host_advance_us(CHECK_STEP_US);
+        if (!systemState.isOutputEnabled()) {
+            if (!dacOff) {
+                shutdownDAC();
+                dacOff = true;
+                s_dacOffs++;
+            }
+            s_standbySteps++;
+            standby.outputOff();
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CHECK_STANDBY_PERIOD_MS));
+            lastWake = xTaskGetTickCount();
+            continue;
+        }
+        bool resumed = dacOff;
+        if (dacOff) {
+            dacOff = false;
+            releaseDAC();
+        }
+        s_activeSteps++;
+        bool tripped = s_tripped;
+        if (standby.isStandby()) {
+            standby.outputOn(!tripped);
+        }
+        if (resumed && !tripped) {
+            setDACVoltage(CHECK_DAC_VOLTAGE);
+        }
+        // 本周期其余部分（帧回调等），DAC任务优先级较低，在此之后写入
+        host_advance_us(CHECK_STEP_US);
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(CHECK_PERIOD_MS));
+    }
+}
+
+static void checkEnter() {
+    printf("进入待机\n");
+    standby.enter();
+    check(!systemState.isOutputEnabled() && standby.state() == STANDBY_ENTERING, "立即发布输出关闭");
+    check(backlight.state() == BACKLIGHT_DIM, "背光立即变暗");
+    host_run_tasks(CHECK_PERIOD_MS + 1);
+    StandbyStats st;
+    standby.stats(st);
+    printf("    进入用时 %luus\n", (unsigned long)st.lastEnterUs);
+    check(standby.state() == STANDBY_IDLE && s_dacOffs == 1, "下一个周期关断DAC");
+    check(st.entries == 1 && st.lastEnterUs <= CHECK_PERIOD_MS * 1000 + CHECK_STEP_US, "进入用时不超过一个周期");
+
+    standby.enter();
+    standby.stats(st);
+    check(st.entries == 1, "重复请求不计次数");
+}
+
+static void checkIdle() {
+    printf("待机\n");
+    uint32_t active = s_activeSteps;
+    uint32_t steps = s_standbySteps;
+    host_run_tasks(1000);
+    uint32_t n = s_standbySteps - steps;
+    printf("    1秒 %lu 个待机周期\n", (unsigned long)n);
+    check(n >= 1000 / CHECK_STANDBY_PERIOD_MS - 1 && n <= 1000 / CHECK_STANDBY_PERIOD_MS + 1, "按待机周期检查保护");
+    check(s_activeSteps == active, "不再按限流周期运行");
+}
+
+static void checkResume() {
+    printf("恢复\n");
+    host_run_tasks(CHECK_STANDBY_PERIOD_MS / 2 + 3);   // 停在待机周期中间
+    uint32_t writes = host_spi_write_count();
+    standby.resume();
+    check(systemState.isOutputEnabled() && standby.state() == STANDBY_RESUMING, "立即发布输出打开");
+    host_run_tasks(1);
+    StandbyStats st;
+    standby.stats(st);
+    printf("    恢复用时 %luus（待机周期 %dms）\n", (unsigned long)st.lastResumeUs, CHECK_STANDBY_PERIOD_MS);
+    check(host_spi_write_count() > writes, "DAC任务写入设定值");
+    check(standby.state() == STANDBY_ACTIVE && st.resumes == 1 && st.resumesMeasured == 1, "DAC写入后结束恢复");
+    // 限流任务发出设定值之后还运行了一个采样耗时，DAC任务才写入
+    check(st.lastResumeUs >= 2 * CHECK_STEP_US, "计时到DAC写入为止，不在发出设定值时结束");
+    check(st.lastResumeUs <= CHECK_PERIOD_MS * 1000, "被通知立即运行，不等待待机周期结束");
+    check(st.standbyUs >= 1000000 && st.standbyUs < 1100000, "累计待机时间");
+}
+
+static void checkTripped() {
+    printf("保护锁存时恢复\n");
+    standby.enter();
+    host_run_tasks(CHECK_STANDBY_PERIOD_MS * 2);
+    StandbyStats before;
+    standby.stats(before);
+    s_tripped = true;
+    uint32_t writes = host_spi_write_count();
+    standby.resume();
+    host_run_tasks(10);
+    StandbyStats st;
+    standby.stats(st);
+    check(standby.state() == STANDBY_ACTIVE && host_spi_write_count() == writes, "恢复结束，DAC保持0V");
+    check(st.resumes == before.resumes + 1 && st.resumesTripped == before.resumesTripped + 1 &&
+          st.resumesMeasured == before.resumesMeasured && st.lastResumeUs == before.lastResumeUs,
+          "不计恢复用时，单独计数");
+    s_tripped = false;
+}
+
+static void checkRaces() {
+    printf("连续请求\n");
+    standby.enter();
+    standby.resume();
+    host_run_tasks(10);
+    check(standby.state() == STANDBY_ACTIVE && systemState.isOutputEnabled(), "进入后立即恢复：回到运行");
+
+    standby.enter();
+    host_run_tasks(10);
+    standby.resume();
+    standby.enter();
+    host_run_tasks(CHECK_STANDBY_PERIOD_MS * 2);
+    check(standby.state() == STANDBY_IDLE && !systemState.isOutputEnabled(), "恢复后立即进入：回到待机");
+    standby.resume();
+    host_run_tasks(10);
+    check(standby.state() == STANDBY_ACTIVE, "再次恢复");
+}
+
+static void checkExternal() {
+    printf("其他来源的输出开关\n");
+    StandbyStats before;
+    standby.stats(before);
+    systemState.setOutputEnabled(false);
+    host_run_tasks(100);
+    check(standby.state() == STANDBY_IDLE, "输出关闭：进入待机状态");
+    systemState.setOutputEnabled(true);
+    host_run_tasks(CHECK_STANDBY_PERIOD_MS + CHECK_PERIOD_MS);
+    StandbyStats after;
+    standby.stats(after);
+    check(standby.state() == STANDBY_ACTIVE, "输出打开：回到运行");
+    check(after.entries == before.entries && after.resumes == before.resumes, "不计入进入和恢复次数");
+    check(after.standbyUs - before.standbyUs >= 100000, "待机时间照常统计");
+    standby.printReport();
+}
+
+int main() {
+    taskTableInstall(TASKS, sizeof(TASKS) / sizeof(TASKS[0]));
+    backlight.begin(-1);
+    MyDAC dac(5, 7, 6);
+    dac.begin();
+    addDACAppliedHandler(MyStandby::onDacApplied, &standby);
+    createDACTask(&dac);
+    systemState.setOutputEnabled(true);
+    TaskHandle_t task = NULL;
+    xTaskCreate(controlTask, "Regulator", 4096, NULL, 20, &task);
+    standby.setControlTask(task);
+    host_run_tasks(100);
+    check(standby.state() == STANDBY_ACTIVE && s_activeSteps >= 100 / CHECK_PERIOD_MS - 1, "启动时输出打开");
+
+    checkEnter();
+    checkIdle();
+    checkResume();
+    checkTripped();
+    checkRaces();
+    checkExternal();
+
+    return checkResult();
+}
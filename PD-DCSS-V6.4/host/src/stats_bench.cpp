@@ -0,0 +1,166 @@
+/**
+ * @file stats_bench.cpp
+ * @brief 滑动窗口统计（lib/myStats）的正确性检查和每帧耗时基准
+ * @details
+ * 喂入带纹波、噪声、缓慢漂移和偶发尖峰的采集帧，每隔一段时间把各窗口的结果与
+ * 按同一段帧逐个重新计算的结果比较（最小、最大值必须相同，平均、RMS、标准差相对误差 < 1e-5）；
+ * 中途插入一次输出关闭的间隔和一次窗口长度修改，检查清空逻辑。
+ * 最后不做比较连续喂入，统计 addFrame() 的平均耗时。
+ *   stats_bench [--frames N] [--budget-ns N]   默认20万帧；budget-ns 为每帧耗时上限，0表示不检查
+ *
+ * 返回值：0 通过；1 结果不一致或超出耗时上限；2 参数错误。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include "myStats.h"
+#include "check_util.h"
+
+#define BENCH_PERIOD_US 2000
+#define BENCH_CHECK_EVERY 997          // 每隔这么多帧比较一次（与桶长互质，覆盖桶内各位置）
+#define BENCH_TOLERANCE 1e-5
+
+static AdcFrame makeFrame(uint64_t n, int64_t timeUs) {
+    AdcFrame f;
+    f.timeUs = timeUs;
+    float t = n * (BENCH_PERIOD_US * 1e-6f);
+    float spike = (n % 7919 == 0) ? 0.5f : 0.0f;
+    f.uIn = 12.0f + 0.05f * checkNoise() - 0.0001f * t;
+    f.iIn = 0.55f + 0.01f * checkNoise();
+    f.uOut = 5.0f + 0.02f * sinf(t * 2.0f * (float)M_PI * 7.0f) + 0.005f * checkNoise() + spike;
+    f.iOut = 1.2f + 0.01f * checkNoise() - spike;
+    return f;
+}
+
+static bool closeEnough(double a, double b) {
+    return fabs(a - b) <= BENCH_TOLERANCE * fmax(1e-3, fabs(b));
+}
+
+// 用最近 frames 帧逐个重新计算，与模块结果比较
+static bool verify(const std::vector<AdcFrame> &history, const WindowStats &ws, uint8_t index) {
+    if (ws.frames > history.size()) {
+        printf("窗口%u: 帧数 %u 超过历史 %zu\n", index, ws.frames, history.size());
+        return false;
+    }
+    bool ok = true;
+    for (int ch = 0; ch < STATS_CHANNELS; ch++) {
+        int32_t lo = INT32_MAX;
+        int32_t hi = INT32_MIN;
+        double sum = 0.0;
+        double sumSq = 0.0;
+        for (size_t i = history.size() - ws.frames; i < history.size(); i++) {
+            const AdcFrame &f = history[i];
+            float values[STATS_CHANNELS] = {f.uIn, f.iIn, f.uOut, f.iOut};
+            int32_t v = (int32_t)lroundf(values[ch] * 1000.0f);
+            lo = v < lo ? v : lo;
+            hi = v > hi ? v : hi;
+            sum += v;
+            sumSq += (double)v * v;
+        }
+        double mean = sum / ws.frames;
+        double meanSq = sumSq / ws.frames;
+        double stddev = sqrt(fmax(0.0, meanSq - mean * mean));
+        const ChannelStats &c = ws.channel[ch];
+        if (c.min != lo / 1000.0f || c.max != hi / 1000.0f || !closeEnough(c.mean, mean / 1000.0) ||
+            !closeEnough(c.rms, sqrt(meanSq) / 1000.0) || !closeEnough(c.stddev, stddev / 1000.0)) {
+            printf("窗口%u %s 不一致: 最小 %.3f/%.3f 最大 %.3f/%.3f 平均 %.5f/%.5f 标准差 %.5f/%.5f\n",
+                   index, MyStats::channelName(ch), c.min, lo / 1000.0, c.max, hi / 1000.0,
+                   c.mean, mean / 1000.0, c.stddev, stddev / 1000.0);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    checkSeed(2025);
+    uint64_t frames = 200000;
+    double budgetNs = 0.0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--budget-ns") == 0 && i + 1 < argc) {
+            budgetNs = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "用法: %s [--frames N] [--budget-ns N]\n", argv[0]);
+            return CHECK_EXIT_USAGE;
+        }
+    }
+
+    // 正确性：窗口内容与逐帧重算一致
+    MyStats st;
+    std::vector<AdcFrame> history;
+    int64_t t = 1000;
+    uint32_t checks = 0;
+    bool ok = true;
+    for (uint64_t n = 0; n < frames && ok; n++) {
+        if (n == frames / 3) {
+            // 输出关闭5秒：所有窗口清空
+            t += 5000000;
+            history.clear();
+        } else {
+            t += BENCH_PERIOD_US;
+        }
+        if (n == frames / 2) {
+            // 修改窗口长度：该窗口清空，其他窗口不受影响
+            st.setWindow(0, 2);
+        }
+        AdcFrame f = makeFrame(n, t);
+        st.addFrame(f);
+        history.push_back(f);
+
+        if (n % BENCH_CHECK_EVERY == 0 || n + 1 == frames) {
+            for (uint8_t w = 0; w < STATS_WINDOWS; w++) {
+                WindowStats ws;
+                if (!st.read(w, ws)) {
+                    printf("窗口%u 在第%llu帧没有数据\n", w, (unsigned long long)n);
+                    ok = false;
+                    break;
+                }
+                // 修改过长度的窗口只能包含修改之后的帧
+                if (w == 0 && n >= frames / 2 && ws.frames > n - frames / 2 + 1) {
+                    printf("窗口0 修改长度后仍包含旧数据\n");
+                    ok = false;
+                    break;
+                }
+                ok = verify(history, ws, w) && ok;
+                checks++;
+            }
+        }
+    }
+
+    // 耗时：只调用 addFrame
+    std::vector<AdcFrame> input;
+    input.reserve(65536);
+    for (uint64_t n = 0; n < 65536; n++) {
+        input.push_back(makeFrame(n, 0));
+    }
+    MyStats bench;
+    t = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t n = 0; n < frames; n++) {
+        AdcFrame &f = input[n & 65535];
+        t += BENCH_PERIOD_US;
+        f.timeUs = t;
+        bench.addFrame(f);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / frames;
+    WindowStats last;
+    bench.read(STATS_WINDOWS - 1, last);
+
+    printf("%llu帧  比较 %u 次  窗口 %us/%us/%us\n", (unsigned long long)frames, checks,
+           st.windowSeconds(0), st.windowSeconds(1), st.windowSeconds(2));
+    printf("每帧耗时 %.1fns（%d个窗口 × %d个通道）  最后窗口 U_OUT 峰峰值 %.3fV\n", ns, STATS_WINDOWS, STATS_CHANNELS,
+           last.channel[STATS_U_OUT].max - last.channel[STATS_U_OUT].min);
+    if (budgetNs > 0.0 && ns > budgetNs) {
+        printf("超出耗时上限 %.1fns\n", budgetNs);
+        ok = false;
+    }
+    printf("%s\n", ok ? "通过" : "失败");
+    return ok ? CHECK_EXIT_OK : CHECK_EXIT_FAIL;
+}
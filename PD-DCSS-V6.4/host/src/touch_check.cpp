@@ -0,0 +1,271 @@
+/**
+ * @file touch_check.cpp
+ * @brief 触摸屏输入（lib/myTouch）的检查：中断触发的采样、中值滤波、四点校准和NVS保存
+ * @details
+ * 触摸控制器的原始读数由一个模拟面板给出：屏幕坐标经过交换X、Y、两轴反向并带少量错切的
+ * 仿射变换得到原始坐标，每个读数加±8的抖动，每7个读数有一个偏离900的尖峰。
+ * 采样任务由协作式调度器运行，按下和松开通过PENIRQ引脚的电平驱动。依次检查：
+ * - 没有触摸时采样任务不读总线；
+ * - solveCalibration() 对精确的四点求出的变换在全屏误差 < 0.05像素，点数不足或共线时失败；
+ * - 四点校准流程：轻触不算；校准期间不发布按下；完成后生效并保存到NVS；
+ * - 校准后全屏各点的坐标误差 ≤ 1像素（尖峰被中值滤除），松开后读回调返回松开；
+ * - 读数分散时整组丢弃，不发布按下；
+ * - 拟合误差过大时重新开始，原来的参数不变；
+ * - 采样任务一次占用总线的时间不超过一组读数；
+ * - 重新启动（新的实例）从NVS读回相同的参数；清除后恢复默认参数。
+ *
+ * 返回值见 check_util.h。
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "myTouch.h"
+#include "myTaskTable.h"
+#include "myHAL.h"
+#include "host_stubs.h"
+#include "check_util.h"
+
+#define CHECK_IRQ_PIN 18
+#define CHECK_PRESSURE 1200
+#define CHECK_SPIKE_EVERY 7
+#define CHECK_SPIKE 900
+#define CHECK_READ_US 25
+
+static const TaskSpec TASKS[] = {
+    {"Touch", NULL, 3072, TASK_CLASS_UI, TASK_CORE_SYSTEM, TASK_STACK_INTERNAL, NULL},
+};
+
+static TFT_eSPI s_tft(320, 240);
+
+// 模拟面板
+static bool s_down = false;
+static float s_sx = 0, s_sy = 0;
+static int s_scatter = 0;                // 额外的读数分散幅度
+
+static void toRaw(float sx, float sy, float *rx, float *ry) {
+    *rx = 3900.0f - sy * 14.5f + sx * 0.3f;
+    *ry = 3800.0f - sx * 11.2f;
+}
+
+static void panel(uint32_t index, uint16_t *x, uint16_t *y, uint16_t *z) {
+    if (!s_down) {
+        *x = 0;
+        *y = 0;
+        *z = 0;
+        return;
+    }
+    float rx, ry;
+    toRaw(s_sx, s_sy, &rx, &ry);
+    int jitter = (int)((index * 2654435761u) >> 28) - 8;
+    int spread = s_scatter > 0 ? (int)((index * 40503u) % (2 * s_scatter + 1)) - s_scatter : 0;
+    int spike = index % CHECK_SPIKE_EVERY == CHECK_SPIKE_EVERY - 1 ? CHECK_SPIKE : 0;
+    *x = (uint16_t)(rx + jitter + spread + spike);
+    *y = (uint16_t)(ry - jitter + spread);
+    *z = CHECK_PRESSURE;
+}
+
+static void press(float sx, float sy, uint32_t ms) {
+    s_sx = sx;
+    s_sy = sy;
+    s_down = true;
+    host_set_gpio(CHECK_IRQ_PIN, LOW);
+    host_run_tasks(ms);
+}
+
+static void release() {
+    s_down = false;
+    host_set_gpio(CHECK_IRQ_PIN, HIGH);
+    host_run_tasks(60);
+}
+
+static float mapError(const TouchCalibration &cal, float sx, float sy) {
+    float rx, ry;
+    toRaw(sx, sy, &rx, &ry);
+    float dx = cal.a * rx + cal.b * ry + cal.c - sx;
+    float dy = cal.d * rx + cal.e * ry + cal.f - sy;
+    return sqrtf(dx * dx + dy * dy);
+}
+
+static void checkIdle() {
+    printf("没有触摸\n");
+    host_run_tasks(500);
+    TouchStats st;
+    touch.stats(st);
+    int16_t x, y;
+    check(st.bursts == 0 && st.irqs == 0 && !touch.read(&x, &y), "采样任务不读总线，读回调返回松开");
+}
+
+static void checkSolve() {
+    printf("求解\n");
+    float raw[TOUCH_CAL_POINTS][2];
+    int16_t screen[TOUCH_CAL_POINTS][2];
+    for (uint8_t i = 0; i < TOUCH_CAL_POINTS; i++) {
+        MyTouch::calibrationTarget(i, &screen[i][0], &screen[i][1]);
+        toRaw(screen[i][0], screen[i][1], &raw[i][0], &raw[i][1]);
+    }
+    TouchCalibration cal;
+    float err = -1.0f;
+    bool ok = MyTouch::solveCalibration(raw, screen, TOUCH_CAL_POINTS, cal, &err);
+    float worst = 0.0f;
+    for (int sy = 0; sy < TOUCH_SCREEN_H; sy += 8) {
+        for (int sx = 0; sx < TOUCH_SCREEN_W; sx += 8) {
+            float e = mapError(cal, sx, sy);
+            worst = e > worst ? e : worst;
+        }
+    }
+    printf("    拟合误差 %.4f  全屏最大误差 %.4f像素\n", err, worst);
+    check(ok && err < 0.01f && worst < 0.05f, "精确的四点求出的变换全屏误差 < 0.05像素");
+
+    check(!MyTouch::solveCalibration(raw, screen, 2, cal, NULL), "两个点无解");
+    float line[3][2] = {{100, 100}, {200, 200}, {300, 300}};
+    check(!MyTouch::solveCalibration(line, screen, 3, cal, NULL), "共线的点无解");
+}
+
+static void checkCalibration() {
+    printf("四点校准\n");
+    check(!touch.isCalibrated(), "NVS中没有记录时未校准");
+    touch.beginCalibration();
+    check(touch.calibrationState() == TOUCH_CAL_RUNNING && touch.calibrationStep() == 0, "开始校准");
+
+    int16_t tx, ty;
+    MyTouch::calibrationTarget(0, &tx, &ty);
+    press(tx, ty, 12);
+    release();
+    check(touch.calibrationStep() == 0, "轻触（读数不足）不算");
+
+    bool anyPressed = false;
+    for (uint8_t i = 0; i < TOUCH_CAL_POINTS; i++) {
+        MyTouch::calibrationTarget(i, &tx, &ty);
+        press(tx, ty, 100);
+        int16_t x, y;
+        anyPressed = anyPressed || touch.read(&x, &y);
+        release();
+    }
+    check(!anyPressed, "校准期间不向LVGL发布按下");
+    printf("    最大误差 %.2f像素\n", touch.calibrationError());
+    check(touch.calibrationState() == TOUCH_CAL_DONE && touch.isCalibrated(), "校准完成并保存");
+    check(touch.calibrationError() >= 0.0f && touch.calibrationError() < 1.0f, "拟合误差 < 1像素");
+
+    uint8_t record[64];
+    bool exact = halNvsLoad(TOUCH_NVS_NAMESPACE, TOUCH_NVS_KEY, record, sizeof(uint32_t) + sizeof(TouchCalibration));
+    check(exact, "NVS中有校准记录");
+}
+
+static void checkTracking() {
+    printf("校准后的坐标\n");
+    TouchStats before;
+    touch.stats(before);
+    float worst = 0.0f;
+    bool allPressed = true;
+    bool allReleased = true;
+    int presses = 0;
+    for (int sy = 0; sy < TOUCH_SCREEN_H; sy += 40) {
+        for (int sx = 0; sx < TOUCH_SCREEN_W; sx += 40) {
+            float px = sx + 3.0f, py = sy + 5.0f;
+            press(px, py, 60);
+            int16_t x, y;
+            bool pressed = touch.read(&x, &y);
+            allPressed = allPressed && pressed;
+            float e = sqrtf((x - px) * (x - px) + (y - py) * (y - py));
+            worst = e > worst ? e : worst;
+            release();
+            allReleased = allReleased && !touch.read(&x, &y);
+            presses++;
+        }
+    }
+    TouchStats after;
+    touch.stats(after);
+    printf("    %d次按下  最大误差 %.2f像素  丢弃%lu组\n", presses, worst,
+           (unsigned long)(after.noisy - before.noisy));
+    check(allPressed && allReleased, "按下时发布按下，松开后发布松开");
+    check(worst <= 1.0f, "全屏坐标误差 ≤ 1像素（尖峰被中值滤除）");
+    check(after.presses - before.presses == (uint32_t)presses, "按下次数正确");
+}
+
+static void checkScatter() {
+    printf("读数分散\n");
+    TouchStats before;
+    touch.stats(before);
+    s_scatter = 300;
+    press(160, 120, 80);
+    int16_t x, y;
+    bool pressed = touch.read(&x, &y);
+    release();
+    s_scatter = 0;
+    TouchStats after;
+    touch.stats(after);
+    check(!pressed && after.noisy - before.noisy == after.bursts - before.bursts && after.bursts > before.bursts,
+          "分散的读数整组丢弃，不发布按下");
+}
+
+static void checkRetry() {
+    printf("误差过大时重新开始\n");
+    TouchCalibration before;
+    touch.calibration(before);
+    touch.beginCalibration();
+    for (uint8_t i = 0; i < TOUCH_CAL_POINTS; i++) {
+        int16_t tx, ty;
+        MyTouch::calibrationTarget(i, &tx, &ty);
+        press(tx + (i == 2 ? 40 : 0), ty, 100);
+        release();
+    }
+    TouchCalibration after;
+    touch.calibration(after);
+    printf("    最大误差 %.1f像素\n", touch.calibrationError());
+    check(touch.calibrationState() == TOUCH_CAL_RETRY && touch.calibrationStep() == 0, "重新从第一个点开始");
+    check(memcmp(&before, &after, sizeof(before)) == 0, "原来的参数不变");
+    touch.cancelCalibration();
+    check(touch.calibrationState() == TOUCH_CAL_IDLE, "取消校准");
+}
+
+static void checkBusHold() {
+    printf("总线占用\n");
+    host_set_touch_read_us(CHECK_READ_US);
+    press(100, 100, 100);
+    release();
+    host_set_touch_read_us(0);
+    TouchStats st;
+    touch.stats(st);
+    printf("    一组读数最长占用 %luus\n", (unsigned long)st.maxHoldUs);
+    check(st.maxHoldUs > 0 && st.maxHoldUs <= TOUCH_BURST * CHECK_READ_US, "一次只占用一组读数的时间");
+}
+
+static void checkPersist() {
+    printf("重新启动\n");
+    TouchCalibration saved;
+    touch.calibration(saved);
+    MyTouch reboot;
+    reboot.begin(&s_tft, -1);
+    TouchCalibration loaded;
+    reboot.calibration(loaded);
+    check(reboot.isCalibrated() && memcmp(&saved, &loaded, sizeof(saved)) == 0, "从NVS读回相同的参数");
+    reboot.clearCalibration();
+    TouchCalibration cleared;
+    reboot.calibration(cleared);
+    uint8_t record[64];
+    check(!reboot.isCalibrated() && memcmp(&saved, &cleared, sizeof(saved)) != 0 &&
+          !halNvsLoad(TOUCH_NVS_NAMESPACE, TOUCH_NVS_KEY, record, sizeof(uint32_t) + sizeof(TouchCalibration)),
+          "清除后恢复默认参数，NVS中没有记录");
+}
+
+int main() {
+    taskTableInstall(TASKS, sizeof(TASKS) / sizeof(TASKS[0]));
+    host_nvs_clear();
+    host_set_touch_source(panel);
+    if (!touch.begin(&s_tft, CHECK_IRQ_PIN)) {
+        printf("失败\n");
+        return CHECK_EXIT_FAIL;
+    }
+    checkIdle();
+    checkSolve();
+    checkCalibration();
+    checkTracking();
+    checkScatter();
+    checkRetry();
+    checkBusHold();
+    checkPersist();
+
+    return checkResult();
+}
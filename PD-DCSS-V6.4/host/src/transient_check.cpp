@@ -0,0 +1,220 @@
+/**
+ * @file transient_check.cpp
+ * @brief 负载瞬态分析（lib/myTransient）的检查：合成波形和降压变换器模型闭环
+ * @details
+ * 合成波形（40kHz，4096帧，触发帧512，叠加±2mV噪声）：
+ * - 加载：U_OUT在1ms内线性跌落140mV，之后按400us时间常数指数恢复，稳定值比阶跃前低10mV；
+ *   下冲、峰值时刻、恢复到±1%的时间与解析值一致，直方图计入对应的格；
+ * - 卸载：对称的过冲；
+ * - 持续振荡时记为未稳定；电流变化不足时不算事件。
+ * 模型闭环：DAC直接给定4V，负载在4Ω和2Ω之间阶跃，阶跃触发的捕获由协作式调度器运行，
+ * poll() 分析后重新 arm；下冲、恢复时间与模型自身记录的最低电压、稳定时间（mark()，±1%）
+ * 比较，检查直方图的计数和示波器注释。
+ * 监测期间输入跌落（HAL与ESP32相同，连续采样期间U_IN的单次读数保持开始前的值）：
+ * 窗口超时后停止连续采样，单次读数在一个窗口加一次捕获和间隔的时间内看到跌落，超时的窗口不计为事件。
+ *
+ * 返回值见 check_util.h。
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+
+#include "myTransient.h"
+#include "myCapture.h"
+#include "myTaskTable.h"
+#include "myHAL.h"
+#include "host_plant.h"
+#include "host_stubs.h"
+#include "check_util.h"
+
+#define TRACE_HZ 40000
+#define TRACE_FRAMES 4096
+#define TRACE_TRIGGER 512
+
+static const TaskSpec TASKS[] = {
+    {"Capture", NULL, 3072, TASK_CLASS_CONTROL, TASK_CORE_CONTROL, TASK_STACK_INTERNAL, NULL},
+};
+
+/**
+ * @brief 生成一次阶跃：阶跃在触发帧之前3帧，偏离在 rampUs 内线性达到 peakV（带符号），
+ *        之后按 tauUs 指数衰减到 vFinal；ringHz 不为0时衰减部分再乘以该频率的余弦（振荡）
+ */
+static void makeTrace(std::vector<float> &u, std::vector<float> &i, float i0, float i1, float v0, float vFinal,
+                      float peakV, float rampUs, float tauUs, float ringHz = 0.0f) {
+    u.resize(TRACE_FRAMES);
+    i.resize(TRACE_FRAMES);
+    const uint32_t step = TRACE_TRIGGER - 3;
+    for (uint32_t f = 0; f < TRACE_FRAMES; f++) {
+        double v = v0;
+        double a = i0;
+        if (f >= step) {
+            double t = (f - step) * 1e6 / TRACE_HZ;
+            double dev = t < rampUs ? peakV * t / rampUs
+                                    : peakV * exp(-(t - rampUs) / tauUs) * cos(2 * M_PI * ringHz * (t - rampUs) * 1e-6);
+            v = vFinal + dev;
+            a = i1;
+        }
+        u[f] = (float)(v + 0.002 * checkUniform());
+        i[f] = (float)(a + 0.005 * checkUniform());
+    }
+}
+
+static void checkSynthetic(MyTransient &t) {
+    printf("合成波形\n");
+    TransientConfig cfg = transientDefaultConfig();
+    std::vector<float> u;
+    std::vector<float> i;
+    TransientEvent e;
+
+    // 加载：5.000V -> 4.990V，下冲140mV，1ms后最低，恢复到±49.9mV需要 1000 + 400*ln(140/49.9) = 1412.6us
+    makeTrace(u, i, 1.0f, 2.0f, 5.0f, 4.99f, -0.14f, 1000.0f, 400.0f);
+    bool ok = MyTransient::analyze(u.data(), i.data(), TRACE_FRAMES, TRACE_TRIGGER, TRACE_HZ, cfg, e);
+    double expected = 1000.0 + 400.0 * log(0.14 / (4.99 * 0.01));
+    printf("    下冲 %.1fmV 峰值 %.0fus 恢复 %.0fus（解析值 %.0fus）\n", e.undershootV * 1000, e.peakUs,
+           e.recoveryUs, expected);
+    check(ok && e.rising && fabsf(e.iBefore - 1.0f) < 0.01f && fabsf(e.iAfter - 2.0f) < 0.01f &&
+          fabsf(e.vBefore - 5.0f) < 0.002f && fabsf(e.vFinal - 4.99f) < 0.002f, "阶跃前后的电流、电压");
+    check(ok && fabsf(e.undershootV - 0.14f) < 0.004f && e.overshootV < 0.003f && e.peakDeviationV == e.undershootV,
+          "下冲140mV，没有过冲");
+    check(ok && fabsf(e.peakUs - 1000.0f) <= 50.0f, "最大偏离出现在阶跃后1ms（两个采样周期内）");
+    check(ok && fabs(e.recoveryUs - expected) <= 50.0, "恢复时间与解析值相差不超过两个采样周期");
+    t.record(e);
+
+    // 卸载：过冲80mV，200us后最高，恢复到±50mV需要 200 + 150*ln(80/50) = 270.5us
+    makeTrace(u, i, 2.0f, 1.0f, 4.99f, 5.0f, 0.08f, 200.0f, 150.0f);
+    ok = MyTransient::analyze(u.data(), i.data(), TRACE_FRAMES, TRACE_TRIGGER, TRACE_HZ, cfg, e);
+    expected = 200.0 + 150.0 * log(0.08 / 0.05);
+    printf("    过冲 %.1fmV 峰值 %.0fus 恢复 %.0fus（解析值 %.0fus）\n", e.overshootV * 1000, e.peakUs,
+           e.recoveryUs, expected);
+    check(ok && !e.rising && fabsf(e.overshootV - 0.08f) < 0.004f && e.undershootV < 0.003f &&
+          fabs(e.recoveryUs - expected) <= 50.0, "卸载：过冲和恢复时间");
+    t.record(e);
+
+    // 500Hz持续振荡，100ms的捕获末尾仍在带外
+    makeTrace(u, i, 0.5f, 2.5f, 5.0f, 5.0f, -0.5f, 100.0f, 1e9f, 500.0f);
+    ok = MyTransient::analyze(u.data(), i.data(), TRACE_FRAMES, TRACE_TRIGGER, TRACE_HZ, cfg, e);
+    check(ok && e.recoveryUs < 0.0f, "恢复太慢时记为未稳定");
+    t.record(e);
+
+    // 0.1A的变化不到 stepA/2
+    makeTrace(u, i, 1.0f, 1.1f, 5.0f, 5.0f, -0.01f, 100.0f, 100.0f);
+    check(!MyTransient::analyze(u.data(), i.data(), TRACE_FRAMES, TRACE_TRIGGER, TRACE_HZ, cfg, e), "电流变化不足时不算事件");
+
+    const TransientHistogram &h = t.histogram();
+    uint32_t recovered = 0;
+    uint32_t deviations = 0;
+    for (int b = 0; b < TRANSIENT_RECOVERY_BUCKETS; b++) {
+        recovered += h.recovery[b];
+    }
+    for (int d = 0; d < TRANSIENT_DEVIATION_BUCKETS; d++) {
+        deviations += h.deviation[d];
+    }
+    // 1412us 在 <=1600us 一格，270us 在 <=400us 一格；偏离 2.8%、1.6%、>= 3.5%
+    check(h.events == 3 && h.rising == 2 && h.falling == 1 && h.unsettled == 1 && recovered == 2 &&
+          h.recovery[5] == 1 && h.recovery[3] == 1, "直方图：事件数和恢复时间分布");
+    check(deviations == 3 && h.deviation[5] == 1 && h.deviation[3] == 1 && h.deviation[TRANSIENT_DEVIATION_BUCKETS - 1] == 1,
+          "直方图：最大偏离分布");
+    t.printReport();
+}
+
+// 在协作式调度器中运行 ms 毫秒，每10ms调用一次 poll()（与 loop() 相同）
+static void runWithPoll(uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t += 10) {
+        host_run_tasks(10);
+        transient.poll();
+    }
+}
+
+// 等到一个窗口结束、间隔之后重新 arm，再写满预触发深度（512帧，12.8ms）
+static void waitFreshWindow() {
+    uint32_t generation = capture.generation();
+    for (uint32_t t = 0; t < 1000 && capture.generation() == generation; t += 10) {
+        runWithPoll(10);
+    }
+    for (uint32_t t = 0; t < 100 && capture.state() != CAPTURE_ARMED; t += 10) {
+        runWithPoll(10);
+    }
+    runWithPoll(20);
+}
+
+static void checkPlantStep(HostPlant &plant, float ohms, bool rising) {
+    printf("模型闭环：负载阶跃到 %.0fΩ\n", ohms);
+    const TransientHistogram &h = transient.histogram();
+    waitFreshWindow();
+    uint32_t events = h.events;
+    plant.setLoad(PLANT_LOAD_RESISTIVE, ohms);
+    plant.mark(4.0f, 1.0f);
+    runWithPoll(200);
+    PlantMetrics m = plant.metrics();
+    const TransientEvent &e = transient.lastEvent();
+    printf("    模型: 最低 %.3fV 最高 %.3fV 稳定 %.3fms   分析: 下冲 %.1fmV 过冲 %.1fmV 恢复 %.0fus\n",
+           m.minVout, m.peakVout, m.settleMs, e.undershootV * 1000, e.overshootV * 1000, e.recoveryUs);
+    check(h.events == events + 1 && e.rising == rising && e.captureGeneration == capture.generation(),
+          "检测到一次阶跃，方向正确");
+    float extreme = rising ? e.vFinal - e.undershootV : e.vFinal + e.overshootV;
+    float model = rising ? m.minVout : m.peakVout;
+    check(fabsf(extreme - model) < 0.01f, "最大偏离与模型记录的极值相差不超过10mV");
+    // 滑动平均和ADC量化使带边附近的判定相差一两个采样周期
+    check(m.settleMs >= 0.0f && e.recoveryUs >= 0.0f && fabsf(e.recoveryUs - m.settleMs * 1000.0f) <= 100.0f,
+          "恢复时间与模型的稳定时间（±1%）相差不超过100us");
+
+    char note[CAPTURE_NOTE_MAX];
+    check(capture.note(e.captureGeneration, note, sizeof(note)) && note[0] == '#', "示波器注释");
+    check(transient.isRunning() && capture.state() == CAPTURE_ARMED, "分析后重新等待下一次阶跃");
+}
+
+static void checkInputRefresh(HostPlant &plant) {
+    printf("监测期间输入跌落\n");
+    const TransientHistogram &h = transient.histogram();
+    uint32_t events = h.events;
+    uint32_t captureMs = transientDefaultConfig().depth * 1000 / transientDefaultConfig().sampleHz;
+    uint32_t bound = TRANSIENT_WINDOW_MS + captureMs + TRANSIENT_GAP_MS + 20;
+    // 12V跌到8V：输出仍为4V，I_OUT不变，不触发阶跃
+    plant.scheduleSag(halMicros(), 1000000, 4.0f);
+    uint32_t seenMs = 0;
+    bool seen = false;
+    for (uint32_t t = 0; t < 2 * bound && !seen; t += 10) {
+        runWithPoll(10);
+        uint32_t mv = halAdcRawToMv(halAdcReadRaw(0));
+        seen = mv > 6000 && mv < 9000;
+        seenMs = t + 10;
+    }
+    printf("    单次读数 %lums 后看到跌落（上限 %lums）\n", (unsigned long)seenMs, (unsigned long)bound);
+    check(seen && seenMs <= bound, "窗口之间单次读数更新");
+    check(transient.isRunning() && h.events == events, "超时的窗口不计为事件，监测继续");
+    runWithPoll(1000);
+}
+
+int main() {
+    checkSeed(2025);
+    taskTableInstall(TASKS, sizeof(TASKS) / sizeof(TASKS[0]));
+
+    MyTransient recorded;
+    checkSynthetic(recorded);
+
+    HostPlant plant(plantDefaultParams());
+    plant.overrideDac(4.0f);
+    plant.setLoad(PLANT_LOAD_RESISTIVE, 4.0f);
+    plant.attachToClock();
+    host_run_tasks(50);
+    if (!capture.begin()) {
+        printf("失败\n");
+        return CHECK_EXIT_FAIL;
+    }
+    check(transient.start(), "开始监测");
+    // 写满预触发深度（512帧，12.8ms）
+    runWithPoll(30);
+    checkPlantStep(plant, 2.0f, true);
+    checkPlantStep(plant, 4.0f, false);
+    checkInputRefresh(plant);
+
+    const TransientHistogram &h = transient.histogram();
+    check(h.events == 2 && h.rising == 1 && h.falling == 1 && h.unsettled == 0, "直方图：一次加载、一次卸载");
+    transient.printReport();
+    transient.stop();
+    host_run_tasks(20);
+    check(!transient.isRunning() && capture.state() == CAPTURE_IDLE, "停止后取消捕获");
+
+    return checkResult();
+}
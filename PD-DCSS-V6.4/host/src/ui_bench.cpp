@@ -0,0 +1,347 @@
+/**
+ * @file ui_bench.cpp
+ * @brief 主屏幕的重绘耗时基准：大字号读数控件、预合成背景层和共享常量样式，各与原来的实现比较
+ * @details
+ * 不运行 main.cpp 的 setup()，只初始化显示和 gui_guider 的主屏幕，然后按 MyADC::updateUI 的格式
+ * 逐次改写读数：输出在设定值附近有 ±20mV 的噪声（通常只有最后一两位变化），
+ * 每 BENCH_STEP_EVERY 次设定值跳变一次（全部数字变化）。每次更新后调用 lv_refr_now()，
+ * 记录重绘和刷屏的耗时（主机真实时间）和刷屏像素数。同一串数值（同一个种子）依次用于各种配置。
+ *   ui_bench --mode readout [--updates N]
+ *       U_OUT、I_OUT、P_OUT先用原来的55px标签（lv_label_set_text），再换成 MyReadout（setText），
+ *       报告两者每次更新的平均和最长耗时、刷屏像素数和精灵图缓存大小。
+ *   ui_bench --mode backdrop [--updates N]
+ *       U_IN、I_IN、P_IN、效率和三个大字号读数全部按标签改写（与没有读数控件时的 updateUI 相同），
+ *       先在原来的屏幕（边框图片逐像素alpha混合）上，再在 MyBackdrop 合成静态对象之后各运行一遍，
+ *       另外报告整屏重绘的平均耗时、合成背景层的用时和缓存大小。
+ *   ui_bench --mode styles [--updates N]
+ *       setup_scr_screen.c 经 tools/compact_styles.py 改写后每个控件只引用一个共享常量样式。
+ *       先测量主屏幕占用的LVGL内存（lv_mem_monitor，init_gui 前后之差）、整屏和U_IN、Uout标签的重绘耗时；
+ *       再把共享样式展开成局部样式并补上脚本去掉的默认值（与 GUI Guider 原来的输出相同），
+ *       测量同样的数据，并逐像素比较两次最后的整屏画面，不一致时判为失败。
+ *       与 test/Test_style_bench.cpp 相同，在主机上运行。
+ * 主机上的耗时只用于同一台机器上的相对比较，绝对值与ESP32-S3无关。
+ *
+ * 返回值见 check_util.h（读数控件或背景层创建失败、两种样式的画面不一致时为 CHECK_EXIT_FAIL）。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include <Arduino.h>
+#include "myTFT.h"
+#include "myReadout.h"
+#include "myBackdrop.h"
+#include "check_util.h"
+
+#define BENCH_UPDATES 500
+#define BENCH_FULL_REPEAT 20
+#define BENCH_STEP_EVERY 50          // 每隔多少次更新设定值跳变一次
+#define BENCH_NOISE_V 0.02f
+#define BENCH_LOAD_OHM 4.0f
+#define BENCH_BG_COLOR 0x000822      // 与 main.cpp 的 READOUT_BG_COLOR 相同
+
+// 与 main.cpp initReadouts() 相同的颜色，顺序为 U_OUT、I_OUT、P_OUT
+static const uint32_t READOUT_COLORS[3] = {0xcfc300, 0x00a629, 0x3aabff};
+static const float SETPOINTS[] = {5.00f, 12.00f, 3.30f, 9.87f};
+
+// 脚本去掉的默认值属性（与 tools/compact_styles.py 中的 DEFAULTS 相同），只用于标签
+static const lv_style_prop_t LABEL_DEFAULT_PROPS[] = {
+    LV_STYLE_BORDER_WIDTH, LV_STYLE_RADIUS, LV_STYLE_PAD_TOP, LV_STYLE_PAD_RIGHT, LV_STYLE_PAD_BOTTOM,
+    LV_STYLE_PAD_LEFT, LV_STYLE_SHADOW_WIDTH, LV_STYLE_BG_OPA, LV_STYLE_TEXT_OPA,
+    LV_STYLE_TEXT_LETTER_SPACE, LV_STYLE_TEXT_LINE_SPACE,
+};
+
+static MyReadout *s_readouts[3] = {NULL, NULL, NULL};   // NULL时用原来的标签
+static bool s_inputs = false;                            // 同时改写输入侧的小字号标签
+static uint32_t s_baseBytes = 0;                         // init_gui 之前LVGL内存池的占用
+static int64_t s_buildUs = 0;                            // init_gui 的用时
+
+struct BenchStats {
+    int updates;
+    int64_t totalUs;
+    int64_t maxUs;
+    uint64_t flushedPx;
+};
+
+static int64_t nowUs() {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void setValue(int ch, lv_obj_t *label, float value) {
+    char text[16];
+    snprintf(text, sizeof(text), "%.2f", value);
+    if (s_readouts[ch] != NULL) {
+        s_readouts[ch]->setText(text);
+    } else {
+        lv_label_set_text(label, text);
+    }
+}
+
+// 第i次更新的读数，与 MyADC::updateUI 一样三个大字号读数同时改写
+static void update(int i) {
+    float u = SETPOINTS[(i / BENCH_STEP_EVERY) % (sizeof(SETPOINTS) / sizeof(SETPOINTS[0]))];
+    u += checkNoise() * BENCH_NOISE_V;
+    float iOut = u / BENCH_LOAD_OHM;
+    setValue(0, guider_ui.screen_Uout, u);
+    setValue(1, guider_ui.screen_Iout, iOut);
+    setValue(2, guider_ui.screen_Pout, u * iOut);
+    if (s_inputs) {
+        // 输入12V，效率约90%
+        float pIn = u * iOut / 0.9f;
+        char text[16];
+        lv_label_set_text(guider_ui.screen_U_IN, "12.00");
+        snprintf(text, sizeof(text), "%.2f", pIn / 12.0f);
+        lv_label_set_text(guider_ui.screen_I_IN, text);
+        snprintf(text, sizeof(text), "%.2f", pIn);
+        lv_label_set_text(guider_ui.screen_P_IN, text);
+        snprintf(text, sizeof(text), "%d", (int)(u * iOut / pIn * 100.0f + 0.5f));
+        lv_label_set_text(guider_ui.screen_Efficiency, text);
+    }
+}
+
+static BenchStats run(int updates) {
+    BenchStats st = {0, 0, 0, 0};
+    checkSeed(2025);
+    for (int i = 0; i < updates; i++) {
+        update(i);
+        tft.resetStats();
+        int64_t t0 = nowUs();
+        lv_refr_now(NULL);
+        int64_t us = nowUs() - t0;
+        st.updates++;
+        st.totalUs += us;
+        st.maxUs = us > st.maxUs ? us : st.maxUs;
+        st.flushedPx += tft.pixelsPushed();
+    }
+    return st;
+}
+
+// 整屏重绘的平均耗时(us)
+static double fullRedrawUs(int repeat) {
+    int64_t total = 0;
+    for (int i = 0; i < repeat; i++) {
+        lv_obj_invalidate(lv_scr_act());
+        int64_t t0 = nowUs();
+        lv_refr_now(NULL);
+        total += nowUs() - t0;
+    }
+    return (double)total / repeat;
+}
+
+static uint32_t lvglUsed() {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+}
+
+// 只改写一个标签，每次重绘的平均耗时(us)
+static double labelRedrawUs(lv_obj_t *label, int repeat) {
+    char text[16];
+    int64_t total = 0;
+    for (int i = 0; i < repeat; i++) {
+        snprintf(text, sizeof(text), "%.2f", 10.0f + 0.37f * (i % 17));
+        lv_label_set_text(label, text);
+        int64_t t0 = nowUs();
+        lv_refr_now(NULL);
+        total += nowUs() - t0;
+    }
+    return (double)total / repeat;
+}
+
+static void printStats(const char *name, const BenchStats &st) {
+    printf("%-10s %5d次  平均 %8.1fus  最长 %7lldus  每次刷屏 %8.0f px\n", name, st.updates,
+           (double)st.totalUs / st.updates, (long long)st.maxUs, (double)st.flushedPx / st.updates);
+}
+
+static int benchReadout(int updates) {
+    // 先把启动后的整屏画完，之后只计增量重绘
+    lv_refr_now(NULL);
+    BenchStats label = run(updates);
+    printStats("标签", label);
+
+    lv_obj_t *labels[3] = {guider_ui.screen_Uout, guider_ui.screen_Iout, guider_ui.screen_Pout};
+    size_t cacheBytes = 0;
+    for (int ch = 0; ch < 3; ch++) {
+        s_readouts[ch] = new MyReadout(&lv_font_Alatsi_Regular_55, lv_color_hex(READOUT_COLORS[ch]),
+                                       lv_color_hex(BENCH_BG_COLOR), 5);
+        if (!s_readouts[ch]->begin(labels[ch])) {
+            fprintf(stderr, "读数控件创建失败\n");
+            return CHECK_EXIT_FAIL;
+        }
+        cacheBytes += s_readouts[ch]->getCacheBytes();
+    }
+    lv_refr_now(NULL);
+    BenchStats readout = run(updates);
+    printStats("读数控件", readout);
+
+    double ratio = readout.totalUs > 0 ? (double)label.totalUs / readout.totalUs : 0.0;
+    printf("读数控件的平均重绘耗时为标签的 1/%.1f，刷屏像素为标签的 %.0f%%，精灵图缓存 %u字节\n", ratio,
+           label.flushedPx > 0 ? 100.0 * readout.flushedPx / label.flushedPx : 0.0, (unsigned)cacheBytes);
+    for (int ch = 0; ch < 3; ch++) {
+        delete s_readouts[ch];
+        s_readouts[ch] = NULL;
+    }
+    return CHECK_EXIT_OK;
+}
+
+static int benchBackdrop(int updates) {
+    // 与 main.cpp initBackdrop() 相同的静态对象
+    static lv_obj_t *staticObjs[] = {
+        guider_ui.screen_img_1,
+        guider_ui.screen_U_SET_label,
+        guider_ui.screen_PERCENT_label,
+        guider_ui.screen_Efficiency_label,
+        guider_ui.screen_W_label,
+        guider_ui.screen_A_label,
+        guider_ui.screen_V_label,
+        guider_ui.screen_V_label_IN,
+        guider_ui.screen_U_IN_label,
+        guider_ui.screen_I_IN_label,
+        guider_ui.screen_A_label_IN,
+        guider_ui.screen_Pin_W_label,
+        guider_ui.screen_P_IN_label,
+    };
+    s_inputs = true;
+    lv_refr_now(NULL);
+    double fullBefore = fullRedrawUs(BENCH_FULL_REPEAT);
+    BenchStats before = run(updates);
+    printStats("原来的屏幕", before);
+
+    MyBackdrop backdrop;
+    int64_t t0 = nowUs();
+    if (!backdrop.begin(guider_ui.screen, staticObjs, sizeof(staticObjs) / sizeof(staticObjs[0]))) {
+        fprintf(stderr, "背景层创建失败（LV_USE_SNAPSHOT 为0或内存不足）\n");
+        return CHECK_EXIT_FAIL;
+    }
+    int64_t beginUs = nowUs() - t0;
+    lv_refr_now(NULL);
+    double fullAfter = fullRedrawUs(BENCH_FULL_REPEAT);
+    BenchStats after = run(updates);
+    printStats("背景层", after);
+
+    printf("整屏重绘 %.1fus -> %.1fus；每次更新平均 %.1fus -> %.1fus\n", fullBefore, fullAfter,
+           (double)before.totalUs / before.updates, (double)after.totalUs / after.updates);
+    printf("合成背景层 %lldus，缓存 %u字节\n", (long long)beginUs, (unsigned)backdrop.getBufferBytes());
+    backdrop.release();
+    return CHECK_EXIT_OK;
+}
+
+// 把控件的共享常量样式展开成局部样式，标签再补上默认值属性
+static void expandToLocal(lv_obj_t *obj) {
+    for (int32_t i = (int32_t)obj->style_cnt - 1; i >= 0; i--) {
+        lv_style_t *style = (lv_style_t *)obj->styles[i].style;
+        lv_style_selector_t selector = obj->styles[i].selector;
+        if (obj->styles[i].is_local || style->prop1 != LV_STYLE_PROP_ANY) {
+            continue;
+        }
+        for (uint32_t k = 0; k < style->prop_cnt; k++) {
+            const lv_style_const_prop_t *p = &style->v_p.const_props[k];
+            if (p->prop != LV_STYLE_PROP_INV) {
+                lv_obj_set_local_style_prop(obj, p->prop, p->value, selector);
+            }
+        }
+        lv_obj_remove_style(obj, style, selector);
+    }
+    if (lv_obj_check_type(obj, &lv_label_class)) {
+        for (size_t k = 0; k < sizeof(LABEL_DEFAULT_PROPS) / sizeof(LABEL_DEFAULT_PROPS[0]); k++) {
+            lv_style_value_t v;
+            if (lv_obj_get_local_style_prop(obj, LABEL_DEFAULT_PROPS[k], &v, LV_PART_MAIN) != LV_RES_OK) {
+                lv_obj_set_local_style_prop(obj, LABEL_DEFAULT_PROPS[k],
+                                            lv_style_prop_get_default(LABEL_DEFAULT_PROPS[k]), LV_PART_MAIN);
+            }
+        }
+    }
+}
+
+// 测量一种样式：两个标签的重绘，然后整屏重绘，最后一次整屏画面留在帧缓冲中
+static void measureStyles(const char *name, int updates, uint16_t *frame, size_t pixels) {
+    uint32_t bytes = lvglUsed() - s_baseBytes;
+    double uIn = labelRedrawUs(guider_ui.screen_U_IN, updates);
+    double uOut = labelRedrawUs(guider_ui.screen_Uout, updates);
+    double full = fullRedrawUs(BENCH_FULL_REPEAT);
+    memcpy(frame, tft.framebuffer(), pixels * sizeof(uint16_t));
+    printf("%-10s 主屏幕LVGL内存 %6lu字节  整屏 %8.1fus  U_IN %7.1fus  Uout %7.1fus\n", name,
+           (unsigned long)bytes, full, uIn, uOut);
+}
+
+static int benchStyles(int updates) {
+    size_t pixels = (size_t)tft.width() * tft.height();
+    uint16_t *shared = (uint16_t *)malloc(pixels * sizeof(uint16_t));
+    uint16_t *local = (uint16_t *)malloc(pixels * sizeof(uint16_t));
+    if (shared == NULL || local == NULL) {
+        free(shared);
+        free(local);
+        return CHECK_EXIT_FAIL;
+    }
+    printf("init_gui %lldus\n", (long long)s_buildUs);
+    uint32_t sharedBytes = lvglUsed() - s_baseBytes;
+    measureStyles("共享样式", updates, shared, pixels);
+
+    expandToLocal(guider_ui.screen);
+    uint32_t childCount = lv_obj_get_child_cnt(guider_ui.screen);
+    for (uint32_t i = 0; i < childCount; i++) {
+        expandToLocal(lv_obj_get_child(guider_ui.screen, i));
+    }
+    uint32_t localBytes = lvglUsed() - s_baseBytes;
+    measureStyles("局部样式", updates, local, pixels);
+
+    long differ = 0;
+    for (size_t i = 0; i < pixels; i++) {
+        differ += shared[i] != local[i] ? 1 : 0;
+    }
+    printf("共享样式少用 %ld字节LVGL内存\n", (long)localBytes - (long)sharedBytes);
+    check(differ == 0, "共享样式与原来的局部样式画面逐像素相同");
+    if (differ > 0) {
+        printf("    %ld px不同\n", differ);
+    }
+    free(shared);
+    free(local);
+    return checkResult();
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "用法: %s --mode readout|backdrop|styles [--updates N]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    const char *mode = NULL;
+    int updates = BENCH_UPDATES;
+    for (int i = 1; i < argc; i++) {
+        bool hasNext = i + 1 < argc;
+        if (strcmp(argv[i], "--mode") == 0 && hasNext) {
+            mode = argv[++i];
+        } else if (strcmp(argv[i], "--updates") == 0 && hasNext) {
+            updates = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return CHECK_EXIT_USAGE;
+        }
+    }
+    if (mode == NULL || updates <= 0) {
+        usage(argv[0]);
+        return CHECK_EXIT_USAGE;
+    }
+
+    Serial.setEnabled(false);
+    tft_init();
+    lvgl_setup();
+    s_baseBytes = lvglUsed();
+    int64_t t0 = nowUs();
+    init_gui(&guider_ui);
+    s_buildUs = nowUs() - t0;
+
+    if (strcmp(mode, "readout") == 0) {
+        return benchReadout(updates);
+    }
+    if (strcmp(mode, "backdrop") == 0) {
+        return benchBackdrop(updates);
+    }
+    if (strcmp(mode, "styles") == 0) {
+        return benchStyles(updates);
+    }
+    usage(argv[0]);
+    return CHECK_EXIT_USAGE;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file Arduino.h
+ * @brief 主机构建使用的Arduino最小替身
+ * @details 只实现固件中实际用到的接口：时间、GPIO、中断和Serial。
+ * GPIO读数和ADC读数由测试脚本通过 host_stubs.h 中的函数设置。
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "host_time.h"
+
+#define IRAM_ATTR
+
+#define HIGH 1
+#define LOW 0
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define INPUT_PULLDOWN 0x09
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define digitalPinToInterrupt(p) (p)
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void ets_delay_us(uint32_t us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t val);
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+// 串口替身：默认丢弃输出，--verbose 时打印到标准输出
+class HostSerial {
+public:
+    void begin(unsigned long) {}
+    void flush() { fflush(stdout); }
+    void setEnabled(bool enabled) { _enabled = enabled; }
+    int available() { return 0; }
+    int read() { return -1; }
+
+    size_t print(const char *s) { return write(s); }
+    size_t print(char c) { char s[2] = {c, 0}; return write(s); }
+    size_t print(int v) { return printf("%d", v); }
+    size_t print(unsigned int v) { return printf("%u", v); }
+    size_t print(long v) { return printf("%ld", v); }
+    size_t print(unsigned long v) { return printf("%lu", v); }
+    size_t print(long long v) { return printf("%lld", v); }
+    size_t print(unsigned long long v) { return printf("%llu", v); }
+    size_t print(double v, int digits = 2) { return printf("%.*f", digits, v); }
+
+    size_t println() { return write("\n"); }
+    template <typename T> size_t println(T v) { size_t n = print(v); return n + println(); }
+    size_t println(double v, int digits) { size_t n = print(v, digits); return n + println(); }
+
+    size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+    size_t write(const uint8_t *data, size_t len);
+
+private:
+    bool _enabled = false;
+    size_t write(const char *s);
+};
+
+extern HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,51 @@
+/**
+ * @file TFT_eSPI.h
+ * @brief 主机构建使用的TFT_eSPI替身
+ * @details
+ * 不驱动真实屏幕，pushColors 把像素写进内存帧缓冲（RGB565），
+ * 这样 myTFT.cpp 中的 my_disp_flush 可以原样编译运行。
+ * 帧缓冲和刷屏统计供主机测试读取。触摸屏的原始读数由 host_set_touch_source() 给定。
+ */
+
+#ifndef HOST_TFT_ESPI_H
+#define HOST_TFT_ESPI_H
+
+#include <stdint.h>
+
+class TFT_eSPI {
+public:
+    TFT_eSPI(int16_t w = 240, int16_t h = 320);
+    ~TFT_eSPI();
+
+    void begin();
+    void setRotation(uint8_t r) { (void)r; }
+    void setTouch(uint16_t *data) { (void)data; }
+    bool getTouch(uint16_t *x, uint16_t *y, uint16_t threshold = 600);
+    uint8_t getTouchRaw(uint16_t *x, uint16_t *y);
+    uint16_t getTouchRawZ();
+
+    void startWrite() {}
+    void endWrite() {}
+    void setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h);
+    // swap 只影响SPI线上的字节序，帧缓冲里始终保存本机字节序的RGB565
+    void pushColors(uint16_t *data, uint32_t len, bool swap = true);
+
+    int16_t width() const { return _w; }
+    int16_t height() const { return _h; }
+
+    // 主机测试接口
+    const uint16_t *framebuffer() const { return _fb; }
+    uint32_t pixelsPushed() const { return _pixelsPushed; }
+    uint32_t flushCount() const { return _flushCount; }
+    void resetStats() { _pixelsPushed = 0; _flushCount = 0; }
+
+private:
+    int16_t _w;
+    int16_t _h;
+    uint16_t *_fb;
+    int32_t _winX, _winY, _winW, _winH;
+    uint32_t _pixelsPushed;
+    uint32_t _flushCount;
+};
+
+#endif // HOST_TFT_ESPI_H
@@ -0,0 +1,32 @@
+#ifndef HOST_ESP_HEAP_CAPS_H
+#define HOST_ESP_HEAP_CAPS_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_EXEC (1 << 0)
+#define MALLOC_CAP_32BIT (1 << 1)
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DMA (1 << 3)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 主机上所有内存区域都是普通堆
+static inline void *heap_caps_malloc(size_t size, uint32_t caps) { (void)caps; return malloc(size); }
+static inline void *heap_caps_calloc(size_t n, size_t size, uint32_t caps) { (void)caps; return calloc(n, size); }
+static inline void heap_caps_free(void *ptr) { free(ptr); }
+// 主机上没有区域统计
+static inline size_t heap_caps_get_free_size(uint32_t caps) { (void)caps; return 0; }
+static inline size_t heap_caps_get_largest_free_block(uint32_t caps) { (void)caps; return 0; }
+static inline size_t heap_caps_get_minimum_free_size(uint32_t caps) { (void)caps; return 0; }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_ESP_HEAP_CAPS_H
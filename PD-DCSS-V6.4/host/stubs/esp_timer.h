@@ -0,0 +1,9 @@
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include <stdint.h>
+#include "host_time.h"
+
+static inline int64_t esp_timer_get_time(void) { return (int64_t)host_micros(); }
+
+#endif // HOST_ESP_TIMER_H
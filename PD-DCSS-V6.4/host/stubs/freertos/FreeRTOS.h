@@ -0,0 +1,57 @@
+/**
+ * @file FreeRTOS.h
+ * @brief 主机构建使用的FreeRTOS替身
+ * @details
+ * 任务由 host_stubs.cpp 中的协作式调度器在虚拟时钟上运行，只有脚本调用
+ * host_run_tasks() 时才会执行（见 host_stubs.h）：
+ * - 任务中的阻塞调用（延时、互斥量、事件组、队列）会让出CPU，超时按虚拟时钟计算；
+ * - 主上下文（setup() 和脚本）中互斥量总能立即获取，事件组和队列不阻塞，
+ *   vTaskDelay 等延时函数推进虚拟时钟；
+ * - 临界区在单线程上没有意义，为空操作。
+ */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "host_time.h"
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t EventBits_t;
+typedef uint32_t StackType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS 1
+#define configTICK_RATE_HZ 1000
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+typedef struct {
+    volatile uint32_t owner;
+    volatile uint32_t count;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0, 0}
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
+#define portYIELD_FROM_ISR(...) ((void)0)
+
+typedef struct HostTask *TaskHandle_t;
+typedef struct HostSemaphore *SemaphoreHandle_t;
+typedef struct HostEventGroup *EventGroupHandle_t;
+typedef struct HostQueue *QueueHandle_t;
+
+typedef void (*TaskFunction_t)(void *);
+
+#endif // HOST_FREERTOS_H
@@ -0,0 +1,73 @@
+/**
+ * @file host_stubs.h
+ * @brief 主机构建中由测试脚本控制的硬件输入、可检查的输出和任务调度
+ */
+
+#ifndef HOST_STUBS_H
+#define HOST_STUBS_H
+
+#include <stdint.h>
+
+#include "host_time.h"
+
+// 设置某个ADC1通道的读数（毫伏）；halAdcReadRaw 会原样返回
+void host_set_adc_mv(int channel, uint32_t mv);
+
+// 设置GPIO输入电平；电平变化且符合登记的边沿时立即调用中断函数
+void host_set_gpio(uint8_t pin, int level);
+
+// SPI最后发送的16位数据和累计发送次数
+uint16_t host_spi_last_word();
+uint32_t host_spi_write_count();
+
+// PWM通道的当前占空比和 halPwmWrite() 调用次数
+uint32_t host_pwm_duty(uint8_t channel);
+uint32_t host_pwm_write_count(uint8_t channel);
+
+// 轻睡眠次数
+uint32_t host_sleep_count();
+
+// 电源管理：dfs 为true时 halPmConfigure() 和锁可用，lightSleep 为true时还允许自动轻睡眠
+// （默认都不支持，与没有启用 CONFIG_PM_ENABLE 的Arduino构建相同）
+void host_set_pm_support(bool dfs, bool lightSleep);
+
+// 各类电源管理锁当前的持有次数（类型为 HalPmLockType）、是否配置了自动轻睡眠、
+// halCpuSetMhz() 实际改变频率的次数、halPmWakeOnHigh() 登记的引脚
+int host_pm_lock_held(int type);
+bool host_pm_light_sleep();
+uint32_t host_cpu_switch_count();
+uint64_t host_pm_wake_mask();
+
+// halPmWakeOnChange() 登记的引脚，以及其中按高电平唤醒的引脚（最近一次登记时为低电平）
+uint64_t host_pm_wake_change_mask();
+uint64_t host_pm_wake_change_levels();
+
+// 清空非易失存储（相当于擦除NVS分区）
+void host_nvs_clear();
+
+// halNvsLoad() 和 halNvsSave() 的累计调用次数（写入次数即flash写入次数）
+uint32_t host_nvs_read_count();
+uint32_t host_nvs_write_count();
+
+// 触摸屏原始读数的来源：TFT_eSPI::getTouchRawZ() 和 getTouchRaw() 都取第 index 个读数，
+// getTouchRaw() 之后 index 加1；为NULL（默认）时没有触摸，压力为0
+typedef void (*HostTouchSource)(uint32_t index, uint16_t *x, uint16_t *y, uint16_t *z);
+void host_set_touch_source(HostTouchSource source);
+
+// 每次 getTouchRaw() 推进虚拟时钟的微秒数（模拟SPI读数耗时），默认0
+void host_set_touch_read_us(uint32_t us);
+
+// 已创建且未删除的任务数量
+int host_task_count();
+
+// 按优先级运行已创建的任务，直到虚拟时间前进 ms 毫秒；只能在主上下文（脚本）中调用
+void host_run_tasks(uint32_t ms);
+
+// 当前是否在任务上下文中执行
+bool host_in_task();
+
+// 虚拟时钟每次前进时调用（from、to为微秒），用于让仿真模型跟上虚拟时间；传NULL取消
+typedef void (*HostClockHook)(uint64_t fromUs, uint64_t toUs);
+void host_set_clock_hook(HostClockHook hook);
+
+#endif // HOST_STUBS_H
@@ -0,0 +1,31 @@
+/**
+ * @file host_time.h
+ * @brief 主机构建使用的虚拟时钟
+ * @details
+ * 主机上 millis()/vTaskDelay() 等函数都基于这个虚拟时钟，只有脚本显式推进时
+ * 时间才会前进，因此渲染结果与机器速度无关，可以和基准图逐像素比较。
+ * 这个头文件同时被LVGL（C代码）用作 LV_TICK_CUSTOM 的时间源。
+ */
+
+#ifndef HOST_TIME_H
+#define HOST_TIME_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 当前虚拟时间
+uint64_t host_micros(void);
+uint32_t host_millis(void);
+
+// 推进虚拟时间
+void host_advance_us(uint64_t us);
+void host_advance_ms(uint32_t ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_TIME_H
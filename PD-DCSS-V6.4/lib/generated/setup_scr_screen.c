@@ -14,6 +14,179 @@
 #include "widgets_init.h"
 #include "custom.h"
 
+/* Shared const styles generated by tools/compact_styles.py; do not edit by hand. */
+/* screen */
+static const lv_style_const_prop_t style_screen_props[] = {
+    LV_STYLE_CONST_BG_OPA(255),
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0x00, 0x08, 0x22)),
+    LV_STYLE_CONST_BG_GRAD_DIR(LV_GRAD_DIR_NONE),
+    { .prop = LV_STYLE_PROP_INV, .value = { .num = 0 } },
+};
+static LV_STYLE_CONST_INIT(style_screen, style_screen_props);
+/* screen_img_1 */
+static const lv_style_const_prop_t style_screen_img_1_props[] = {
+    LV_STYLE_CONST_CLIP_CORNER(true),
+    { .prop = LV_STYLE_PROP_INV, .value = { .num = 0 } },
+};
+static LV_STYLE_CONST_INIT(style_screen_img_1, style_screen_img_1_props);
+/* screen_Uout */
+static const lv_style_const_prop_t style_screen_Uout_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0xcf, 0xc3, 0x00)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_Alatsi_Regular_55),
+    LV_STYLE_CONST_TEXT_LETTER_SPACE(5),
+    LV_STYLE_CONST_TEXT_LINE_SPACE(1),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_CENTER),
+    { .prop = LV_STYLE_PROP_INV, .value = { .num = 0 } },
+};
+static LV_STYLE_CONST_INIT(style_screen_Uout, style_screen_Uout_props);
+/* screen_Iout */
+static const lv_style_const_prop_t style_screen_Iout_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0x00, 0xa6, 0x29)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_Alatsi_Regular_55),
+    LV_STYLE_CONST_TEXT_LETTER_SPACE(5),
+    LV_STYLE_CONST_TEXT_LINE_SPACE(1),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_CENTER),
+    { .prop = LV_STYLE_PROP_INV, .value = { .num = 0 } },
+};
+static LV_STYLE_CONST_INIT(style_screen_Iout, style_screen_Iout_props);
+/* screen_Pout */
+static const lv_style_const_prop_t style_screen_Pout_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0x3a, 0xab, 0xff)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_Alatsi_Regular_55),
+    LV_STYLE_CONST_TEXT_LETTER_SPACE(5),
+    LV_STYLE_CONST_TEXT_LINE_SPACE(1),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_CENTER),
+    { .prop = LV_STYLE_PROP_INV, .value = { .num = 0 } },
+};
+static LV_STYLE_CONST_INIT(style_screen_Pout, style_screen_Pout_props);
+/* screen_STATE */
+static const lv_style_const_prop_t style_screen_STATE_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0xe0, 0xe0, 0xe0)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_Alatsi_Regular_20),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_CENTER),
+    LV_STYLE_CONST_BG_OPA(255),
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0x00, 0x61, 0x7e)),
+    LV_STYLE_CONST_PAD_TOP(9),
+    LV_STYLE_CONST_PAD_RIGHT(1),
+    { .prop = LV_STYLE_PROP_INV, .value = { .num = 0 } },
+};
+static LV_STYLE_CONST_INIT(style_screen_STATE, style_screen_STATE_props);
+/* screen_U_SET, screen_U_IN, screen_I_IN */
+static const lv_style_const_prop_t style_screen_U_SET_props[] = {
+    LV_STYLE_CONST_BORDER_WIDTH(3),
+    LV_STYLE_CONST_BORDER_COLOR(LV_COLOR_MAKE(0x00, 0x61, 0x7e)),
+    LV_STYLE_CONST_RADIUS(3),
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0xe0, 0xe0, 0xe0)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_Alatsi_Regular_12),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_CENTER),
+    LV_STYLE_CONST_PAD_TOP(2),
+    LV_STYLE_CONST_PAD_RIGHT(11),
+    { .prop = LV_STYLE_PROP_INV, .value = { .num = 0 } },
+};
+static LV_STYLE_CONST_INIT(style_screen_U_SET, style_screen_U_SET_props);
+/* screen_U_SET_label, screen_U_IN_label, screen_I_IN_label */
+static const lv_style_const_prop_t style_screen_U_SET_label_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0xe2, 0xe2, 0xe2)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_Alatsi_Regular_10),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_CENTER),
+    LV_STYLE_CONST_BG_OPA(255),
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0x00, 0x61, 0x7e)),
+    { .prop = LV_STYLE_PROP_INV, .value = { .num = 0 } },
+};
+static LV_STYLE_CONST_INIT(style_screen_U_SET_label, style_screen_U_SET_label_props);
+/* screen_Efficiency */
+static const lv_style_const_prop_t style_screen_Efficiency_props[] = {
+    LV_STYLE_CONST_BORDER_WIDTH(3),
+    LV_STYLE_CONST_BORDER_COLOR(LV_COLOR_MAKE(0x00, 0x61, 0x7e)),
+    LV_STYLE_CONST_RADIUS(3),
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0xe0, 0xe0, 0xe0)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_Alatsi_Regular_12),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_RIGHT),
+    LV_STYLE_CONST_PAD_TOP(2),
+    LV_STYLE_CONST_PAD_RIGHT(25),
+    { .prop = LV_STYLE_PROP_INV, .value = { .num = 0 } },
+};
+static LV_STYLE_CONST_INIT(style_screen_Efficiency, style_screen_Efficiency_props);
+/* screen_PERCENT_label, screen_V_label_set, screen_V_label_IN, screen_A_label_IN, screen_Pin_W_label */
+static const lv_style_const_prop_t style_screen_PERCENT_label_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0xe0, 0xe0, 0xe0)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_Alatsi_Regular_12),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_CENTER),
+    { .prop = LV_STYLE_PROP_INV, .value = { .num = 0 } },
+};
+static LV_STYLE_CONST_INIT(style_screen_PERCENT_label, style_screen_PERCENT_label_props);
+/* screen_Efficiency_label, screen_P_IN_label */
+static const lv_style_const_prop_t style_screen_Efficiency_label_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0xe2, 0xe2, 0xe2)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_Alatsi_Regular_9),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_CENTER),
+    LV_STYLE_CONST_BG_OPA(255),
+    LV_STYLE_CONST_BG_COLOR(LV_COLOR_MAKE(0x00, 0x61, 0x7e)),
+    { .prop = LV_STYLE_PROP_INV, .value = { .num = 0 } },
+};
+static LV_STYLE_CONST_INIT(style_screen_Efficiency_label, style_screen_Efficiency_label_props);
+/* screen_W_label */
+static const lv_style_const_prop_t style_screen_W_label_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0x3a, 0xab, 0xff)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_Alatsi_Regular_55),
+    LV_STYLE_CONST_TEXT_LETTER_SPACE(5),
+    LV_STYLE_CONST_TEXT_LINE_SPACE(1),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_LEFT),
+    { .prop = LV_STYLE_PROP_INV, .value = { .num = 0 } },
+};
+static LV_STYLE_CONST_INIT(style_screen_W_label, style_screen_W_label_props);
+/* screen_A_label */
+static const lv_style_const_prop_t style_screen_A_label_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0x00, 0xa6, 0x29)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_Alatsi_Regular_55),
+    LV_STYLE_CONST_TEXT_LETTER_SPACE(5),
+    LV_STYLE_CONST_TEXT_LINE_SPACE(1),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_LEFT),
+    { .prop = LV_STYLE_PROP_INV, .value = { .num = 0 } },
+};
+static LV_STYLE_CONST_INIT(style_screen_A_label, style_screen_A_label_props);
+/* screen_V_label */
+static const lv_style_const_prop_t style_screen_V_label_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0xcf, 0xc3, 0x00)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_Alatsi_Regular_55),
+    LV_STYLE_CONST_TEXT_LETTER_SPACE(5),
+    LV_STYLE_CONST_TEXT_LINE_SPACE(1),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_LEFT),
+    { .prop = LV_STYLE_PROP_INV, .value = { .num = 0 } },
+};
+static LV_STYLE_CONST_INIT(style_screen_V_label, style_screen_V_label_props);
+/* screen_P_IN */
+static const lv_style_const_prop_t style_screen_P_IN_props[] = {
+    LV_STYLE_CONST_BORDER_WIDTH(3),
+    LV_STYLE_CONST_BORDER_COLOR(LV_COLOR_MAKE(0x00, 0x61, 0x7e)),
+    LV_STYLE_CONST_RADIUS(3),
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0xe0, 0xe0, 0xe0)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_Alatsi_Regular_12),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_RIGHT),
+    LV_STYLE_CONST_PAD_TOP(2),
+    LV_STYLE_CONST_PAD_RIGHT(15),
+    { .prop = LV_STYLE_PROP_INV, .value = { .num = 0 } },
+};
+static LV_STYLE_CONST_INIT(style_screen_P_IN, style_screen_P_IN_props);
+/* screen_standby_label1 */
+static const lv_style_const_prop_t style_screen_standby_label1_props[] = {
+    LV_STYLE_CONST_RADIUS(3),
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0xdc, 0x00, 0x21)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_Alatsi_Regular_12),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_CENTER),
+    { .prop = LV_STYLE_PROP_INV, .value = { .num = 0 } },
+};
+static LV_STYLE_CONST_INIT(style_screen_standby_label1, style_screen_standby_label1_props);
+/* screen_standby_label2 */
+static const lv_style_const_prop_t style_screen_standby_label2_props[] = {
+    LV_STYLE_CONST_TEXT_COLOR(LV_COLOR_MAKE(0xb0, 0xb0, 0xb0)),
+    LV_STYLE_CONST_TEXT_FONT(&lv_font_montserratMedium_9),
+    LV_STYLE_CONST_TEXT_ALIGN(LV_TEXT_ALIGN_CENTER),
+    { .prop = LV_STYLE_PROP_INV, .value = { .num = 0 } },
+};
+static LV_STYLE_CONST_INIT(style_screen_standby_label2, style_screen_standby_label2_props);
+
+
 
 
 void setup_scr_screen(lv_ui *ui)
@@ -24,9 +197,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_scrollbar_mode(ui->screen, LV_SCROLLBAR_MODE_OFF);
 
     //Write style for screen, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_bg_opa(ui->screen, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_color(ui->screen, lv_color_hex(0x000822), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_grad_dir(ui->screen, LV_GRAD_DIR_NONE, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen, (lv_style_t *)&style_screen, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_img_1
     ui->screen_img_1 = lv_img_create(ui->screen);
@@ -38,10 +209,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_img_1, 256, 242);
 
     //Write style for screen_img_1, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_img_recolor_opa(ui->screen_img_1, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_img_opa(ui->screen_img_1, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_img_1, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_clip_corner(ui->screen_img_1, true, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_img_1, (lv_style_t *)&style_screen_img_1, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_Uout
     ui->screen_Uout = lv_label_create(ui->screen);
@@ -51,20 +219,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_Uout, 170, 60);
 
     //Write style for screen_Uout, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_Uout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_Uout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_Uout, lv_color_hex(0xcfc300), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_Uout, &lv_font_Alatsi_Regular_55, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_Uout, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_Uout, 5, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_Uout, 1, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_Uout, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_Uout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_Uout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_Uout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_Uout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_Uout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_Uout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_Uout, (lv_style_t *)&style_screen_Uout, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_Iout
     ui->screen_Iout = lv_label_create(ui->screen);
@@ -74,20 +229,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_Iout, 170, 60);
 
     //Write style for screen_Iout, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_Iout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_Iout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_Iout, lv_color_hex(0x00a629), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_Iout, &lv_font_Alatsi_Regular_55, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_Iout, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_Iout, 5, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_Iout, 1, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_Iout, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_Iout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_Iout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_Iout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_Iout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_Iout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_Iout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_Iout, (lv_style_t *)&style_screen_Iout, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_Pout
     ui->screen_Pout = lv_label_create(ui->screen);
@@ -97,20 +239,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_Pout, 170, 60);
 
     //Write style for screen_Pout, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_Pout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_Pout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_Pout, lv_color_hex(0x3aabff), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_Pout, &lv_font_Alatsi_Regular_55, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_Pout, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_Pout, 5, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_Pout, 1, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_Pout, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_Pout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_Pout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_Pout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_Pout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_Pout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_Pout, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_Pout, (lv_style_t *)&style_screen_Pout, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_STATE
     ui->screen_STATE = lv_label_create(ui->screen);
@@ -120,22 +249,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_STATE, 46, 37);
 
     //Write style for screen_STATE, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_STATE, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_STATE, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_STATE, lv_color_hex(0xe0e0e0), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_STATE, &lv_font_Alatsi_Regular_20, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_STATE, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_STATE, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_STATE, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_STATE, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_STATE, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_color(ui->screen_STATE, lv_color_hex(0x00617e), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_grad_dir(ui->screen_STATE, LV_GRAD_DIR_NONE, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_STATE, 9, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_STATE, 1, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_STATE, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_STATE, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_STATE, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_STATE, (lv_style_t *)&style_screen_STATE, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_U_SET
     ui->screen_U_SET = lv_label_create(ui->screen);
@@ -145,23 +259,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_U_SET, 55, 23);
 
     //Write style for screen_U_SET, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_U_SET, 3, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_border_opa(ui->screen_U_SET, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_border_color(ui->screen_U_SET, lv_color_hex(0x00617e), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_border_side(ui->screen_U_SET, LV_BORDER_SIDE_FULL, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_U_SET, 3, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_U_SET, lv_color_hex(0xe0e0e0), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_U_SET, &lv_font_Alatsi_Regular_12, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_U_SET, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_U_SET, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_U_SET, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_U_SET, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_U_SET, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_U_SET, 2, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_U_SET, 11, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_U_SET, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_U_SET, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_U_SET, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_U_SET, (lv_style_t *)&style_screen_U_SET, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_U_SET_label
     ui->screen_U_SET_label = lv_label_create(ui->screen);
@@ -171,22 +269,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_U_SET_label, 55, 10);
 
     //Write style for screen_U_SET_label, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_U_SET_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_U_SET_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_U_SET_label, lv_color_hex(0xe2e2e2), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_U_SET_label, &lv_font_Alatsi_Regular_10, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_U_SET_label, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_U_SET_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_U_SET_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_U_SET_label, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_U_SET_label, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_color(ui->screen_U_SET_label, lv_color_hex(0x00617e), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_grad_dir(ui->screen_U_SET_label, LV_GRAD_DIR_NONE, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_U_SET_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_U_SET_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_U_SET_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_U_SET_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_U_SET_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_U_SET_label, (lv_style_t *)&style_screen_U_SET_label, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_Efficiency
     ui->screen_Efficiency = lv_label_create(ui->screen);
@@ -196,23 +279,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_Efficiency, 55, 23);
 
     //Write style for screen_Efficiency, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_Efficiency, 3, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_border_opa(ui->screen_Efficiency, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_border_color(ui->screen_Efficiency, lv_color_hex(0x00617e), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_border_side(ui->screen_Efficiency, LV_BORDER_SIDE_FULL, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_Efficiency, 3, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_Efficiency, lv_color_hex(0xe0e0e0), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_Efficiency, &lv_font_Alatsi_Regular_12, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_Efficiency, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_Efficiency, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_Efficiency, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_Efficiency, LV_TEXT_ALIGN_RIGHT, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_Efficiency, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_Efficiency, 2, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_Efficiency, 25, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_Efficiency, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_Efficiency, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_Efficiency, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_Efficiency, (lv_style_t *)&style_screen_Efficiency, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_PERCENT_label
     ui->screen_PERCENT_label = lv_label_create(ui->screen);
@@ -222,20 +289,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_PERCENT_label, 18, 13);
 
     //Write style for screen_PERCENT_label, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_PERCENT_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_PERCENT_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_PERCENT_label, lv_color_hex(0xe0e0e0), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_PERCENT_label, &lv_font_Alatsi_Regular_12, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_PERCENT_label, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_PERCENT_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_PERCENT_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_PERCENT_label, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_PERCENT_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_PERCENT_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_PERCENT_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_PERCENT_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_PERCENT_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_PERCENT_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_PERCENT_label, (lv_style_t *)&style_screen_PERCENT_label, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_Efficiency_label
     ui->screen_Efficiency_label = lv_label_create(ui->screen);
@@ -245,22 +299,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_Efficiency_label, 55, 10);
 
     //Write style for screen_Efficiency_label, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_Efficiency_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_Efficiency_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_Efficiency_label, lv_color_hex(0xe2e2e2), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_Efficiency_label, &lv_font_Alatsi_Regular_9, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_Efficiency_label, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_Efficiency_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_Efficiency_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_Efficiency_label, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_Efficiency_label, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_color(ui->screen_Efficiency_label, lv_color_hex(0x00617e), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_grad_dir(ui->screen_Efficiency_label, LV_GRAD_DIR_NONE, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_Efficiency_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_Efficiency_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_Efficiency_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_Efficiency_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_Efficiency_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_Efficiency_label, (lv_style_t *)&style_screen_Efficiency_label, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_W_label
     ui->screen_W_label = lv_label_create(ui->screen);
@@ -270,20 +309,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_W_label, 50, 60);
 
     //Write style for screen_W_label, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_W_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_W_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_W_label, lv_color_hex(0x3aabff), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_W_label, &lv_font_Alatsi_Regular_55, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_W_label, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_W_label, 5, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_W_label, 1, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_W_label, LV_TEXT_ALIGN_LEFT, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_W_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_W_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_W_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_W_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_W_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_W_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_W_label, (lv_style_t *)&style_screen_W_label, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_A_label
     ui->screen_A_label = lv_label_create(ui->screen);
@@ -293,20 +319,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_A_label, 50, 60);
 
     //Write style for screen_A_label, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_A_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_A_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_A_label, lv_color_hex(0x00a629), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_A_label, &lv_font_Alatsi_Regular_55, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_A_label, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_A_label, 5, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_A_label, 1, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_A_label, LV_TEXT_ALIGN_LEFT, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_A_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_A_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_A_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_A_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_A_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_A_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_A_label, (lv_style_t *)&style_screen_A_label, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_V_label
     ui->screen_V_label = lv_label_create(ui->screen);
@@ -316,20 +329,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_V_label, 50, 60);
 
     //Write style for screen_V_label, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_V_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_V_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_V_label, lv_color_hex(0xcfc300), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_V_label, &lv_font_Alatsi_Regular_55, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_V_label, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_V_label, 5, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_V_label, 1, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_V_label, LV_TEXT_ALIGN_LEFT, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_V_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_V_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_V_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_V_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_V_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_V_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_V_label, (lv_style_t *)&style_screen_V_label, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_V_label_set
     ui->screen_V_label_set = lv_label_create(ui->screen);
@@ -339,20 +339,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_V_label_set, 16, 13);
 
     //Write style for screen_V_label_set, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_V_label_set, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_V_label_set, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_V_label_set, lv_color_hex(0xe0e0e0), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_V_label_set, &lv_font_Alatsi_Regular_12, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_V_label_set, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_V_label_set, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_V_label_set, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_V_label_set, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_V_label_set, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_V_label_set, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_V_label_set, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_V_label_set, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_V_label_set, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_V_label_set, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_V_label_set, (lv_style_t *)&style_screen_PERCENT_label, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_U_IN
     ui->screen_U_IN = lv_label_create(ui->screen);
@@ -362,23 +349,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_U_IN, 55, 23);
 
     //Write style for screen_U_IN, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_U_IN, 3, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_border_opa(ui->screen_U_IN, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_border_color(ui->screen_U_IN, lv_color_hex(0x00617e), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_border_side(ui->screen_U_IN, LV_BORDER_SIDE_FULL, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_U_IN, 3, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_U_IN, lv_color_hex(0xe0e0e0), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_U_IN, &lv_font_Alatsi_Regular_12, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_U_IN, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_U_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_U_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_U_IN, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_U_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_U_IN, 2, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_U_IN, 11, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_U_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_U_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_U_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_U_IN, (lv_style_t *)&style_screen_U_SET, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_V_label_IN
     ui->screen_V_label_IN = lv_label_create(ui->screen);
@@ -388,20 +359,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_V_label_IN, 16, 13);
 
     //Write style for screen_V_label_IN, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_V_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_V_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_V_label_IN, lv_color_hex(0xe0e0e0), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_V_label_IN, &lv_font_Alatsi_Regular_12, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_V_label_IN, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_V_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_V_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_V_label_IN, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_V_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_V_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_V_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_V_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_V_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_V_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_V_label_IN, (lv_style_t *)&style_screen_PERCENT_label, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_U_IN_label
     ui->screen_U_IN_label = lv_label_create(ui->screen);
@@ -411,22 +369,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_U_IN_label, 55, 10);
 
     //Write style for screen_U_IN_label, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_U_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_U_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_U_IN_label, lv_color_hex(0xe2e2e2), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_U_IN_label, &lv_font_Alatsi_Regular_10, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_U_IN_label, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_U_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_U_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_U_IN_label, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_U_IN_label, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_color(ui->screen_U_IN_label, lv_color_hex(0x00617e), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_grad_dir(ui->screen_U_IN_label, LV_GRAD_DIR_NONE, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_U_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_U_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_U_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_U_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_U_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_U_IN_label, (lv_style_t *)&style_screen_U_SET_label, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_I_IN_label
     ui->screen_I_IN_label = lv_label_create(ui->screen);
@@ -436,22 +379,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_I_IN_label, 55, 10);
 
     //Write style for screen_I_IN_label, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_I_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_I_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_I_IN_label, lv_color_hex(0xe2e2e2), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_I_IN_label, &lv_font_Alatsi_Regular_10, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_I_IN_label, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_I_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_I_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_I_IN_label, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_I_IN_label, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_color(ui->screen_I_IN_label, lv_color_hex(0x00617e), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_grad_dir(ui->screen_I_IN_label, LV_GRAD_DIR_NONE, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_I_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_I_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_I_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_I_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_I_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_I_IN_label, (lv_style_t *)&style_screen_U_SET_label, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_I_IN
     ui->screen_I_IN = lv_label_create(ui->screen);
@@ -461,23 +389,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_I_IN, 55, 23);
 
     //Write style for screen_I_IN, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_I_IN, 3, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_border_opa(ui->screen_I_IN, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_border_color(ui->screen_I_IN, lv_color_hex(0x00617e), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_border_side(ui->screen_I_IN, LV_BORDER_SIDE_FULL, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_I_IN, 3, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_I_IN, lv_color_hex(0xe0e0e0), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_I_IN, &lv_font_Alatsi_Regular_12, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_I_IN, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_I_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_I_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_I_IN, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_I_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_I_IN, 2, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_I_IN, 11, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_I_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_I_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_I_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_I_IN, (lv_style_t *)&style_screen_U_SET, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_A_label_IN
     ui->screen_A_label_IN = lv_label_create(ui->screen);
@@ -487,20 +399,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_A_label_IN, 16, 13);
 
     //Write style for screen_A_label_IN, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_A_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_A_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_A_label_IN, lv_color_hex(0xe0e0e0), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_A_label_IN, &lv_font_Alatsi_Regular_12, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_A_label_IN, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_A_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_A_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_A_label_IN, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_A_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_A_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_A_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_A_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_A_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_A_label_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_A_label_IN, (lv_style_t *)&style_screen_PERCENT_label, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_P_IN
     ui->screen_P_IN = lv_label_create(ui->screen);
@@ -510,23 +409,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_P_IN, 55, 23);
 
     //Write style for screen_P_IN, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_P_IN, 3, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_border_opa(ui->screen_P_IN, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_border_color(ui->screen_P_IN, lv_color_hex(0x00617e), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_border_side(ui->screen_P_IN, LV_BORDER_SIDE_FULL, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_P_IN, 3, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_P_IN, lv_color_hex(0xe0e0e0), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_P_IN, &lv_font_Alatsi_Regular_12, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_P_IN, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_P_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_P_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_P_IN, LV_TEXT_ALIGN_RIGHT, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_P_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_P_IN, 2, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_P_IN, 15, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_P_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_P_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_P_IN, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_P_IN, (lv_style_t *)&style_screen_P_IN, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_Pin_W_label
     ui->screen_Pin_W_label = lv_label_create(ui->screen);
@@ -536,20 +419,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_Pin_W_label, 18, 13);
 
     //Write style for screen_Pin_W_label, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_Pin_W_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_Pin_W_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_Pin_W_label, lv_color_hex(0xe0e0e0), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_Pin_W_label, &lv_font_Alatsi_Regular_12, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_Pin_W_label, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_Pin_W_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_Pin_W_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_Pin_W_label, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_Pin_W_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_Pin_W_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_Pin_W_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_Pin_W_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_Pin_W_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_Pin_W_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_Pin_W_label, (lv_style_t *)&style_screen_PERCENT_label, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_P_IN_label
     ui->screen_P_IN_label = lv_label_create(ui->screen);
@@ -559,22 +429,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_set_size(ui->screen_P_IN_label, 55, 10);
 
     //Write style for screen_P_IN_label, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_P_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_P_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_P_IN_label, lv_color_hex(0xe2e2e2), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_P_IN_label, &lv_font_Alatsi_Regular_9, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_P_IN_label, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_P_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_P_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_P_IN_label, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_P_IN_label, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_color(ui->screen_P_IN_label, lv_color_hex(0x00617e), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_grad_dir(ui->screen_P_IN_label, LV_GRAD_DIR_NONE, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_P_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_P_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_P_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_P_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_P_IN_label, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_P_IN_label, (lv_style_t *)&style_screen_Efficiency_label, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_standby_label1
     ui->screen_standby_label1 = lv_label_create(ui->screen);
@@ -585,20 +440,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_add_flag(ui->screen_standby_label1, LV_OBJ_FLAG_HIDDEN);
 
     //Write style for screen_standby_label1, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_standby_label1, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_standby_label1, 3, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_standby_label1, lv_color_hex(0xdc0021), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_standby_label1, &lv_font_Alatsi_Regular_12, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_standby_label1, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_standby_label1, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_standby_label1, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_standby_label1, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_standby_label1, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_standby_label1, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_standby_label1, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_standby_label1, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_standby_label1, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_standby_label1, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_standby_label1, (lv_style_t *)&style_screen_standby_label1, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //Write codes screen_standby_label2
     ui->screen_standby_label2 = lv_label_create(ui->screen);
@@ -609,20 +451,7 @@ void setup_scr_screen(lv_ui *ui)
     lv_obj_add_flag(ui->screen_standby_label2, LV_OBJ_FLAG_HIDDEN);
 
     //Write style for screen_standby_label2, Part: LV_PART_MAIN, State: LV_STATE_DEFAULT.
-    lv_obj_set_style_border_width(ui->screen_standby_label2, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_radius(ui->screen_standby_label2, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_color(ui->screen_standby_label2, lv_color_hex(0xb0b0b0), LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_font(ui->screen_standby_label2, &lv_font_montserratMedium_9, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_opa(ui->screen_standby_label2, 255, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_letter_space(ui->screen_standby_label2, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_line_space(ui->screen_standby_label2, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_text_align(ui->screen_standby_label2, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_bg_opa(ui->screen_standby_label2, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_top(ui->screen_standby_label2, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_right(ui->screen_standby_label2, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_bottom(ui->screen_standby_label2, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_pad_left(ui->screen_standby_label2, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
-    lv_obj_set_style_shadow_width(ui->screen_standby_label2, 0, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_style(ui->screen_standby_label2, (lv_style_t *)&style_screen_standby_label2, LV_PART_MAIN|LV_STATE_DEFAULT);
 
     //The custom code of screen.
 
@@ -6,13 +6,14 @@
  */
 
 #include "myADC.h"
-
-// ADC参考电压
-#define DEFAULT_VREF    1100        // 使用默认参考电压
-#define ADC_ATTEN       ADC_ATTEN_DB_12 // 12dB衰减，量程0-3.3V
+#include "myReadout.h"
+#include "mySystemState.h"
 
 MyADC::MyADC(lv_ui *ui) : 
     ui_ptr(ui),
+    readout_u_out(NULL),
+    readout_i_out(NULL),
+    readout_p_out(NULL),
     lastUpdateTime(0),
     k_u_in(1.0f),
     k_i_in(1.0f),
@@ -27,17 +28,9 @@ MyADC::MyADC(lv_ui *ui) :
 }
 
 void MyADC::begin() {
-    // 设置ADC参数
-    adc1_config_width(ADC_WIDTH_BIT_12);  // 设置ADC1为12位分辨率
-    
-    // 配置ADC下拉输入模式
-    adc1_config_channel_atten(ADC_U_IN_PIN, ADC_ATTEN); // 输入电压检测
-    adc1_config_channel_atten(ADC_I_IN_PIN, ADC_ATTEN); // 输入电流检测
-    adc1_config_channel_atten(ADC_U_OUT_PIN, ADC_ATTEN); // 输出电压检测
-    adc1_config_channel_atten(ADC_I_OUT_PIN, ADC_ATTEN); // 输出电流检测
-    
-    // 初始化ADC校准
-    esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN, ADC_WIDTH_BIT_12, DEFAULT_VREF, &adc_chars);
+    // 12位分辨率、12dB衰减（量程0-3.3V），并初始化校准
+    static const uint8_t channels[] = {ADC_U_IN_PIN, ADC_I_IN_PIN, ADC_U_OUT_PIN, ADC_I_OUT_PIN};
+    halAdcInit(channels, sizeof(channels) / sizeof(channels[0]));
     
     Serial.println("ADC初始化完成");
 }
@@ -55,7 +48,7 @@ void MyADC::setCalibrationFactors(float ch1_k, float ch2_k, float ch3_k, float c
     Serial.print("I_OUT校准系数: "); Serial.println(k_i_out);
 }
 
-uint32_t MyADC::readADCRaw(adc1_channel_t channel) {
+uint32_t MyADC::readADCRaw(uint8_t channel) {
     uint32_t adc_reading = 0;
     unsigned long startTime = millis();
     int samplesCollected = 0;
@@ -67,7 +60,7 @@ uint32_t MyADC::readADCRaw(adc1_channel_t channel) {
         
         // 检查是否达到采样间隔
         if (currentTime - startTime >= samplesCollected * ADC_SAMPLE_INTERVAL) {
-            adc_reading += adc1_get_raw(channel);
+            adc_reading += halAdcReadRaw(channel);
             samplesCollected++;
             
             // 如果已经采集够了样本数，跳出循环
@@ -84,8 +77,7 @@ uint32_t MyADC::readADCRaw(adc1_channel_t channel) {
     adc_reading /= ADC_SAMPLES_COUNT;
     
     // 将ADC原始值转换为电压值(mV)
-    uint32_t voltage = 0;
-    voltage = esp_adc_cal_raw_to_voltage(adc_reading, &adc_chars) * 1.0;
+    uint32_t voltage = halAdcRawToMv(adc_reading);
     
     return voltage;
 }
@@ -114,6 +106,9 @@ void MyADC::update() {
     // 记录更新时间
     lastUpdateTime = currentTime;
     
+    // 发布到共享系统状态，UI任务从快照读取，不直接访问这些成员
+    systemState.setMeasurements(u_in, i_in, u_out, i_out);
+    
     // 减少打印调试信息，以降低堆栈使用
 #ifdef ADC_DEBUG
     Serial.print("电压: U_in="); Serial.print(u_in);
@@ -125,11 +120,31 @@ void MyADC::update() {
 #endif
 }
 
+void MyADC::readFrame(AdcFrame &frame) {
+    frame.timeUs = (int64_t)halMicros();
+    frame.uIn = (halAdcRawToMv(halAdcReadRaw(ADC_U_IN_PIN)) / 1000.0f) * k_u_in;
+    frame.iIn = (halAdcRawToMv(halAdcReadRaw(ADC_I_IN_PIN)) / 1000.0f) * k_i_in;
+    frame.uOut = (halAdcRawToMv(halAdcReadRaw(ADC_U_OUT_PIN)) / 1000.0f) * k_u_out;
+    frame.iOut = (halAdcRawToMv(halAdcReadRaw(ADC_I_OUT_PIN)) / 1000.0f) * k_i_out;
+}
+
+void MyADC::frameSource(AdcFrame &frame, void *ctx) {
+    static_cast<MyADC *>(ctx)->readFrame(frame);
+}
+
 void MyADC::updateUI() {
     if (ui_ptr == nullptr) {
         return;
     }
     
+    // 从共享系统状态取一份一致的测量值快照，避免采样任务写到一半时读到新旧混合的数值
+    SystemState state;
+    systemState.snapshot(state);
+    float u_in = state.uIn;
+    float i_in = state.iIn;
+    float u_out = state.uOut;
+    float i_out = state.iOut;
+    
     // 格式化字符串，显示两位小数
     char u_in_str[16];
     char i_in_str[16];
@@ -159,9 +174,19 @@ void MyADC::updateUI() {
     // 更新UI标签
     lv_label_set_text(ui_ptr->screen_U_IN, u_in_str);
     lv_label_set_text(ui_ptr->screen_I_IN, i_in_str);
-    lv_label_set_text(ui_ptr->screen_Uout, u_out_str);
-    lv_label_set_text(ui_ptr->screen_Iout, i_out_str);
-    lv_label_set_text(ui_ptr->screen_Pout, p_out_str);
+    // 大字号读数优先使用读数控件，只重绘变化的数字格
+    if (readout_u_out) readout_u_out->setText(u_out_str);
+    else lv_label_set_text(ui_ptr->screen_Uout, u_out_str);
+    if (readout_i_out) readout_i_out->setText(i_out_str);
+    else lv_label_set_text(ui_ptr->screen_Iout, i_out_str);
+    if (readout_p_out) readout_p_out->setText(p_out_str);
+    else lv_label_set_text(ui_ptr->screen_Pout, p_out_str);
     lv_label_set_text(ui_ptr->screen_P_IN, p_in_str);
     lv_label_set_text(ui_ptr->screen_Efficiency, efficiency_str);
-}
\ No newline at end of file
+}
+
+void MyADC::setReadouts(MyReadout *uOut, MyReadout *iOut, MyReadout *pOut) {
+    readout_u_out = uOut;
+    readout_i_out = iOut;
+    readout_p_out = pOut;
+}
@@ -9,21 +9,23 @@
 #define MY_ADC_H
 
 #include <Arduino.h>
-#include "driver/adc.h"
-#include "esp_adc_cal.h"
+#include "myHAL.h"
+#include "myAdcFrame.h"
 #include "../generated/gui_guider.h"
 
-// ADC引脚定义
-#define ADC_U_IN_PIN   ADC1_CHANNEL_0  // GPIO1 - 输入电压检测
-#define ADC_I_IN_PIN   ADC1_CHANNEL_1  // GPIO2 - 输入电流检测
-#define ADC_U_OUT_PIN  ADC1_CHANNEL_2  // GPIO3 - 输出电压检测
-#define ADC_I_OUT_PIN  ADC1_CHANNEL_3  // GPIO4 - 输出电流检测
+// ADC引脚定义（ADC1通道号）
+#define ADC_U_IN_PIN   0  // ADC1_CHANNEL_0, GPIO1 - 输入电压检测
+#define ADC_I_IN_PIN   1  // ADC1_CHANNEL_1, GPIO2 - 输入电流检测
+#define ADC_U_OUT_PIN  2  // ADC1_CHANNEL_2, GPIO3 - 输出电压检测
+#define ADC_I_OUT_PIN  3  // ADC1_CHANNEL_3, GPIO4 - 输出电流检测
 
 // 采样参数
 #define ADC_SAMPLES_COUNT 10          // 每次测量的采样次数
 #define ADC_SAMPLE_INTERVAL 50        // 采样间隔，单位ms
 #define ADC_UPDATE_INTERVAL 500       // 更新间隔，单位ms
 
+class MyReadout;
+
 class MyADC {
 public:
     /**
@@ -50,6 +52,10 @@ public:
      * @param ch4_k 输出电流校准系数
      */
     void setCalibrationFactors(float ch1_k, float ch2_k, float ch3_k, float ch4_k);
+
+    // 输出电压、输出电流通道的校准系数（波形捕获按同样的系数换算）
+    float getOutputVoltageFactor() const { return k_u_out; }
+    float getOutputCurrentFactor() const { return k_i_out; }
     
     /**
      * @brief 获取当前输入电压
@@ -81,13 +87,34 @@ public:
     float getOutputPower() const { return u_out * i_out; }
     
     /**
-     * @brief 更新UI上的数值显示
+     * @brief 快速读取一个采集帧：每个通道只转换一次，不做平均，不发布到系统状态
+     * @details 供限流回路、输出保护和能量累计等使用，耗时几十微秒；
+     *          显示用的测量值仍由 update() 多次采样平均得到
+     * @param frame 输出的采集帧
+     */
+    void readFrame(AdcFrame &frame);
+
+    // 以回调形式读取采集帧，ctx为 MyADC 实例（见 MyRegulator::begin）
+    static void frameSource(AdcFrame &frame, void *ctx);
+
+    /**
+     * @brief 更新UI上的数值显示（数值取自共享系统状态的快照）
      */
     void updateUI();
 
+    /**
+     * @brief 设置大字号读数控件，设置后Uout/Iout/Pout改由读数控件显示
+     * @param uOut 输出电压读数控件（可为NULL，NULL时仍使用原标签）
+     * @param iOut 输出电流读数控件
+     * @param pOut 输出功率读数控件
+     */
+    void setReadouts(MyReadout *uOut, MyReadout *iOut, MyReadout *pOut);
+
 private:
     lv_ui *ui_ptr;                    // 指向UI的指针
-    esp_adc_cal_characteristics_t adc_chars; // ADC校准特性
+    MyReadout *readout_u_out;         // 输出电压读数控件
+    MyReadout *readout_i_out;         // 输出电流读数控件
+    MyReadout *readout_p_out;         // 输出功率读数控件
     unsigned long lastUpdateTime;     // 上次更新时间
 
     // 校准系数
@@ -104,10 +131,10 @@ private:
 
     /**
      * @brief 读取ADC通道的原始值，并进行多次采样平均
-     * @param channel ADC通道
+     * @param channel ADC1通道号
      * @return 转换后的电压值（mV）
      */
-    uint32_t readADCRaw(adc1_channel_t channel);
+    uint32_t readADCRaw(uint8_t channel);
 };
 
 #endif // MY_ADC_H
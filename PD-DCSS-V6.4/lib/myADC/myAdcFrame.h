@@ -0,0 +1,24 @@
+/**
+ * @file myAdcFrame.h
+ * @brief 采集帧：四个ADC通道各转换一次的一组快速采样
+ * @author watermelon6uice
+ * @details
+ * 由 MyADC::readFrame() 填写，限流回路每个采样周期读取一帧并交给保护、能量累计等使用者。
+ * 单独放在这个头文件里，使用者不需要引入界面相关的 myADC.h。
+ * @date 2025-06-13
+ */
+
+#ifndef MY_ADC_FRAME_H
+#define MY_ADC_FRAME_H
+
+#include <stdint.h>
+
+struct AdcFrame {
+    int64_t timeUs;  // 开始读取的时间(us，halMicros)
+    float uIn;       // 输入电压(V)
+    float iIn;       // 输入电流(A)
+    float uOut;      // 输出电压(V)
+    float iOut;      // 输出电流(A)
+};
+
+#endif // MY_ADC_FRAME_H
@@ -0,0 +1,151 @@
+/**
+ * @file myBackdrop.cpp
+ * @brief 预合成的静态背景层
+ * @author watermelon6uice
+ * @details
+ * 背景层是一张LV_IMG_CF_TRUE_COLOR格式、不缩放不旋转的图片：
+ * 1. 绘制时LVGL的混合函数在不透明、无遮罩的情况下直接逐行memcpy；
+ * 2. lv_img 对这种图片的 COVER_CHECK 返回"完全覆盖"，刷新时从背景层开始绘制，
+ *    屏幕本身的背景色也不再填充。
+ * @date 2025-06-06
+ */
+
+#include "myBackdrop.h"
+#include "esp_heap_caps.h"
+
+MyBackdrop::MyBackdrop() :
+    _screen(NULL),
+    _img(NULL),
+    _buf(NULL),
+    _bufBytes(0),
+    _staticObjs(NULL),
+    _staticCount(0)
+{
+    memset(&_dsc, 0, sizeof(_dsc));
+}
+
+MyBackdrop::~MyBackdrop() {
+    release();
+}
+
+bool MyBackdrop::isStatic(lv_obj_t *obj) const {
+    for (size_t i = 0; i < _staticCount; i++) {
+        if (_staticObjs[i] == obj) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MyBackdrop::begin(lv_obj_t *screen, lv_obj_t *const *staticObjs, size_t count) {
+#if LV_USE_SNAPSHOT
+    if (screen == NULL || _img != NULL) {
+        return false;
+    }
+
+    if (lv_obj_get_child_cnt(screen) > BACKDROP_MAX_CHILDREN) {
+        Serial.println("背景层错误: 屏幕子对象过多");
+        return false;
+    }
+
+    _screen = screen;
+    _staticObjs = staticObjs;
+    _staticCount = count;
+
+    lv_obj_update_layout(screen);
+
+    // 分配背景缓存，优先PSRAM
+    _bufBytes = lv_snapshot_buf_size_needed(screen, LV_IMG_CF_TRUE_COLOR);
+    _buf = heap_caps_malloc(_bufBytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    bool inPsram = (_buf != NULL);
+    if (_buf == NULL) {
+        _buf = heap_caps_malloc(_bufBytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    if (_buf == NULL) {
+        Serial.println("背景层错误: 无法分配背景缓存");
+        _bufBytes = 0;
+        return false;
+    }
+
+    // 临时隐藏所有动态对象，只留下屏幕背景和静态对象，拍一张快照
+    uint32_t childCnt = LV_MIN(lv_obj_get_child_cnt(screen), BACKDROP_MAX_CHILDREN);
+    uint64_t visibleMask = 0;
+    for (uint32_t i = 0; i < childCnt; i++) {
+        lv_obj_t *child = lv_obj_get_child(screen, i);
+        if (!isStatic(child) && !lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN)) {
+            visibleMask |= (1ULL << i);
+            lv_obj_add_flag(child, LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+
+    lv_res_t res = lv_snapshot_take_to_buf(screen, LV_IMG_CF_TRUE_COLOR, &_dsc, _buf, _bufBytes);
+
+    // 恢复动态对象的可见性
+    for (uint32_t i = 0; i < childCnt; i++) {
+        if (visibleMask & (1ULL << i)) {
+            lv_obj_clear_flag(lv_obj_get_child(screen, i), LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+
+    if (res != LV_RES_OK) {
+        Serial.println("背景层错误: 快照失败");
+        heap_caps_free(_buf);
+        _buf = NULL;
+        _bufBytes = 0;
+        return false;
+    }
+
+    // 静态对象已经合成进背景，隐藏它们
+    for (size_t i = 0; i < _staticCount; i++) {
+        if (_staticObjs[i] != NULL) {
+            lv_obj_add_flag(_staticObjs[i], LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+
+    // 背景层放在最底层
+    _img = lv_img_create(screen);
+    lv_img_set_src(_img, &_dsc);
+    lv_obj_set_pos(_img, 0, 0);
+    lv_obj_clear_flag(_img, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_move_to_index(_img, 0);
+    lv_obj_add_event_cb(_img, imgEventCb, LV_EVENT_DELETE, this);
+
+    Serial.printf("背景层已创建: %dx%d, %u字节 (%s), 合成静态对象%u个\n",
+                  (int)_dsc.header.w, (int)_dsc.header.h, (unsigned)_bufBytes,
+                  inPsram ? "PSRAM" : "内部RAM", (unsigned)_staticCount);
+    return true;
+#else
+    Serial.println("背景层未启用: LV_USE_SNAPSHOT 为0（见 platformio.ini 的 build_flags 和 lv_conf.h）");
+    return false;
+#endif
+}
+
+void MyBackdrop::release() {
+    if (_img != NULL) {
+        lv_obj_t *img = _img;
+        _img = NULL;
+        lv_obj_del(img);
+
+        for (size_t i = 0; i < _staticCount; i++) {
+            if (_staticObjs[i] != NULL) {
+                lv_obj_clear_flag(_staticObjs[i], LV_OBJ_FLAG_HIDDEN);
+            }
+        }
+    }
+    if (_buf != NULL) {
+        heap_caps_free(_buf);
+        _buf = NULL;
+        _bufBytes = 0;
+    }
+}
+
+void MyBackdrop::imgEventCb(lv_event_t *e) {
+    // 屏幕被删除时背景层对象随之删除，只需要释放缓存
+    MyBackdrop *self = static_cast<MyBackdrop *>(lv_event_get_user_data(e));
+    self->_img = NULL;
+    if (self->_buf != NULL) {
+        heap_caps_free(self->_buf);
+        self->_buf = NULL;
+        self->_bufBytes = 0;
+    }
+}
@@ -0,0 +1,68 @@
+/**
+ * @file myBackdrop.h
+ * @brief 预合成的静态背景层
+ * @author watermelon6uice
+ * @details
+ * 主界面上 _UI_frame_alpha_256x242 是一张带alpha通道的图片，铺在所有读数后面。
+ * 任何标签失效时，LVGL都要对脏区域重新绘制屏幕背景并逐像素混合这张图片。
+ * 本模块在启动时把"屏幕背景色 + 边框图片 + 静态说明标签"一次性渲染成一张
+ * 不透明的RGB565图片（优先放在PSRAM），然后隐藏原来的静态对象，用这张图片作为
+ * 屏幕最底层。之后脏区域的背景恢复只是一次逐行的memcpy，不再需要alpha混合。
+ * 依赖LVGL的快照功能：LV_USE_SNAPSHOT 需为1（固件由 platformio.ini 的 build_flags 定义，主机构建见 host/lv_conf.h）。
+ * @date 2025-06-06
+ */
+
+#ifndef MY_BACKDROP_H
+#define MY_BACKDROP_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+
+// 屏幕子对象数量上限（快照时用位掩码记录可见性）
+#define BACKDROP_MAX_CHILDREN 64
+
+class MyBackdrop {
+public:
+    MyBackdrop();
+    ~MyBackdrop();
+
+    /**
+     * @brief 渲染背景层并替换静态对象
+     * @param screen 屏幕对象
+     * @param staticObjs 会被合成进背景的静态对象（边框图片、说明标签等）
+     * @param count 静态对象数量
+     * @return 成功返回true；失败时界面保持原样
+     */
+    bool begin(lv_obj_t *screen, lv_obj_t *const *staticObjs, size_t count);
+
+    /**
+     * @brief 释放背景层，恢复原来的静态对象（例如静态标签内容需要修改时）
+     */
+    void release();
+
+    /**
+     * @brief 背景层是否已启用
+     */
+    bool isActive() const { return _img != NULL; }
+
+    /**
+     * @brief 背景缓存占用的字节数
+     */
+    size_t getBufferBytes() const { return _bufBytes; }
+
+private:
+    lv_obj_t *_screen;
+    lv_obj_t *_img;                   // 显示背景层的图片对象
+    void *_buf;                       // RGB565背景缓存
+    size_t _bufBytes;
+    lv_img_dsc_t _dsc;
+
+    // 被合成进背景并隐藏的静态对象
+    lv_obj_t *const *_staticObjs;
+    size_t _staticCount;
+
+    bool isStatic(lv_obj_t *obj) const;
+    static void imgEventCb(lv_event_t *e);
+};
+
+#endif // MY_BACKDROP_H
@@ -0,0 +1,242 @@
+/**
+ * @file myBacklight.cpp
+ * @brief 屏幕背光：LEDC调光、空闲变暗、输出关闭时熄屏并暂停渲染
+ * @author watermelon6uice
+ * @date 2025-06-14
+ */
+
+#include "myBacklight.h"
+#include "myHAL.h"
+#include <string.h>
+
+MyBacklight backlight;
+
+static const char *const STATE_NAMES[BACKLIGHT_STATE_COUNT] = {"亮", "暗", "熄", "点亮中"};
+
+MyBacklight::MyBacklight() :
+    _pin(-1),
+    _state(BACKLIGHT_ON),
+    _brightness(BACKLIGHT_DEFAULT_BRIGHTNESS),
+    _dimLevel(BACKLIGHT_DEFAULT_DIM),
+    _dimMs(BACKLIGHT_DIM_MS),
+    _blankMs(BACKLIGHT_BLANK_MS),
+    _lastActivityMs(0),
+    _wakeStartUs(0),
+    _duty(0),
+    _accountMs(0)
+{
+    portMUX_TYPE unlocked = portMUX_INITIALIZER_UNLOCKED;
+    _mux = unlocked;
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+bool MyBacklight::begin(int pin) {
+    _pin = pin;
+    uint32_t now = halMillis();
+    _lastActivityMs = now;
+    _accountMs = now;
+    _state = BACKLIGHT_ON;
+    _duty = targetDuty(BACKLIGHT_ON);
+    if (pin < 0) {
+        Serial.println("背光引脚未配置，只暂停熄屏时的渲染");
+        return true;
+    }
+    if (!halPwmInit((uint8_t)pin, BACKLIGHT_PWM_CHANNEL, BACKLIGHT_PWM_FREQ_HZ, BACKLIGHT_PWM_BITS)) {
+        Serial.printf("背光PWM配置失败（引脚%d）\n", pin);
+        _pin = -1;
+        return false;
+    }
+    halPwmWrite(BACKLIGHT_PWM_CHANNEL, _duty);
+    return true;
+}
+
+uint32_t MyBacklight::dutyFor(uint8_t percent) {
+    if (percent > 100) {
+        percent = 100;
+    }
+    return (BACKLIGHT_DUTY_MAX * percent * percent + 5000) / 10000;
+}
+
+void MyBacklight::setBrightness(uint8_t percent) {
+    percent = percent < 1 ? 1 : (percent > 100 ? 100 : percent);
+    portENTER_CRITICAL(&_mux);
+    _brightness = percent;
+    if (_dimLevel > percent) {
+        _dimLevel = percent;
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyBacklight::setDimLevel(uint8_t percent) {
+    portENTER_CRITICAL(&_mux);
+    _dimLevel = percent > _brightness ? _brightness : percent;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyBacklight::setTimeouts(uint32_t dimMs, uint32_t blankMs) {
+    portENTER_CRITICAL(&_mux);
+    _dimMs = dimMs;
+    _blankMs = blankMs;
+    portEXIT_CRITICAL(&_mux);
+}
+
+bool MyBacklight::activity() {
+    bool wasBlank = false;
+    portENTER_CRITICAL(&_mux);
+    _lastActivityMs = halMillis();
+    if (_state == BACKLIGHT_BLANK) {
+        // 先恢复渲染，背光等UI任务渲染完一帧再打开
+        _state = BACKLIGHT_WAKING;
+        _wakeStartUs = halMicros();
+        wasBlank = true;
+    } else if (_state == BACKLIGHT_WAKING) {
+        wasBlank = true;
+    } else if (_state == BACKLIGHT_DIM) {
+        _state = BACKLIGHT_ON;
+    }
+    portEXIT_CRITICAL(&_mux);
+    return wasBlank;
+}
+
+void MyBacklight::dimNow() {
+    portENTER_CRITICAL(&_mux);
+    if (_state != BACKLIGHT_BLANK) {
+        uint32_t now = halMillis();
+        account(now);
+        _lastActivityMs = now;
+        if (_state == BACKLIGHT_ON) {
+            _state = BACKLIGHT_DIM;
+            _stats.dims++;
+        }
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+uint32_t MyBacklight::targetDuty(BacklightState state) const {
+    switch (state) {
+        case BACKLIGHT_ON:
+            return dutyFor(_brightness);
+        case BACKLIGHT_DIM:
+            return dutyFor(_dimLevel);
+        default:
+            return 0;
+    }
+}
+
+// 把上次累计以来的时间记到当前状态，同时积分占空比（调用者持有 _mux）
+void MyBacklight::account(uint32_t now) {
+    uint32_t dt = now - _accountMs;
+    _accountMs = now;
+    _stats.stateMs[_state] += dt;
+    _stats.dutyMs += (uint64_t)_duty * dt;
+}
+
+void MyBacklight::update(bool outputEnabled) {
+    uint32_t now = halMillis();
+    BacklightState from;
+    BacklightState to;
+    uint32_t duty;
+    uint32_t wakeUs = 0;
+
+    portENTER_CRITICAL(&_mux);
+    account(now);
+    from = _state;
+    to = from;
+    uint32_t idle = now - _lastActivityMs;
+    switch (from) {
+        case BACKLIGHT_WAKING:
+            // 调用者刚渲染完一帧，现在打开背光
+            to = BACKLIGHT_ON;
+            wakeUs = (uint32_t)(halMicros() - _wakeStartUs);
+            _stats.wakes++;
+            _stats.lastWakeUs = wakeUs;
+            if (wakeUs > _stats.maxWakeUs) {
+                _stats.maxWakeUs = wakeUs;
+            }
+            break;
+        case BACKLIGHT_BLANK:
+            // 输出打开时必须能看到读数
+            if (outputEnabled) {
+                to = BACKLIGHT_WAKING;
+                _wakeStartUs = halMicros();
+                _lastActivityMs = now;
+            }
+            break;
+        default:
+            if (!outputEnabled && _blankMs > 0 && idle >= _blankMs) {
+                to = BACKLIGHT_BLANK;
+                _stats.blanks++;
+            } else if (from == BACKLIGHT_ON && _dimMs > 0 && idle >= _dimMs) {
+                to = BACKLIGHT_DIM;
+                _stats.dims++;
+            }
+            break;
+    }
+    _state = to;
+    duty = targetDuty(to);
+    bool changed = duty != _duty;
+    _duty = duty;
+    portEXIT_CRITICAL(&_mux);
+
+    if (changed && _pin >= 0) {
+        halPwmWrite(BACKLIGHT_PWM_CHANNEL, duty);
+    }
+    if (from != to && to != BACKLIGHT_ON) {
+        Serial.printf("背光: %s\n", STATE_NAMES[to]);
+    } else if (from == BACKLIGHT_WAKING) {
+        Serial.printf("背光: 亮（点亮用时 %luus）\n", (unsigned long)wakeUs);
+    }
+}
+
+void MyBacklight::recordRender(uint32_t us) {
+    portENTER_CRITICAL(&_mux);
+    _stats.renders++;
+    _stats.renderUs += us;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyBacklight::recordSkippedRender() {
+    portENTER_CRITICAL(&_mux);
+    _stats.skippedRenders++;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyBacklight::stats(BacklightStats &out) const {
+    portENTER_CRITICAL(&_mux);
+    out = _stats;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyBacklight::printReport() const {
+    BacklightStats st;
+    stats(st);
+    uint32_t totalMs = 0;
+    for (int i = 0; i < BACKLIGHT_STATE_COUNT; i++) {
+        totalMs += st.stateMs[i];
+    }
+    Serial.println("===== 背光 =====");
+    Serial.printf("状态: %s  亮度 %u%%  变暗 %u%%  变暗前空闲 %lus  熄屏前空闲 %lus（仅输出关闭时）\n",
+                  STATE_NAMES[_state], _brightness, _dimLevel, (unsigned long)(_dimMs / 1000),
+                  (unsigned long)(_blankMs / 1000));
+    if (totalMs == 0) {
+        return;
+    }
+    Serial.printf("累计时间: 亮 %lus  暗 %lus  熄 %lus（变暗%lu次，熄屏%lu次）\n",
+                  (unsigned long)(st.stateMs[BACKLIGHT_ON] / 1000), (unsigned long)(st.stateMs[BACKLIGHT_DIM] / 1000),
+                  (unsigned long)(st.stateMs[BACKLIGHT_BLANK] / 1000), (unsigned long)st.dims,
+                  (unsigned long)st.blanks);
+    float avgMa = BACKLIGHT_FULL_MA * (float)st.dutyMs / ((float)BACKLIGHT_DUTY_MAX * totalMs);
+    Serial.printf("背光平均电流（估算）: %.1fmA，一直全亮为 %.1fmA，节省 %.0f%%\n", avgMa, BACKLIGHT_FULL_MA,
+                  (1.0f - avgMa / BACKLIGHT_FULL_MA) * 100.0f);
+    if (st.wakes > 0) {
+        Serial.printf("从熄屏点亮: %lu次  最近 %.1fms  最长 %.1fms\n", (unsigned long)st.wakes,
+                      st.lastWakeUs / 1000.0f, st.maxWakeUs / 1000.0f);
+    }
+    if (st.renders > 0) {
+        float avgUs = (float)st.renderUs / st.renders;
+        float savedMs = avgUs * st.skippedRenders / 1000.0f;
+        Serial.printf("渲染: 亮屏时%lu次，平均 %.0fus；熄屏时跳过%lu次，估计节省CPU %.0fms（占总时间 %.2f%%）\n",
+                      (unsigned long)st.renders, avgUs, (unsigned long)st.skippedRenders, savedMs,
+                      savedMs / totalMs * 100.0f);
+    }
+}
@@ -0,0 +1,135 @@
+/**
+ * @file myBacklight.h
+ * @brief 屏幕背光：LEDC调光、空闲变暗、输出关闭时熄屏并暂停渲染
+ * @author watermelon6uice
+ * @details
+ * 以前背光一直全亮，UI任务不管有没有人看都以30fps调用 lv_timer_handler()。
+ *
+ * 现在背光由LEDC输出PWM，有四个状态：
+ * - 亮：亮度为 setBrightness() 设定的百分比；
+ * - 暗：连续 dimMs 没有操作后降到 setDimLevel() 的亮度，界面照常刷新；
+ * - 熄：输出关闭且连续 blankMs 没有操作后背光关闭，渲染和刷屏完全停止
+ *   （handle_lvgl_tasks 直接返回，不调用 lv_timer_handler，也就没有刷屏）；
+ * - 点亮中：熄屏时有操作，先恢复渲染，UI任务渲染完这一帧后再打开背光，
+ *   屏幕亮起时显示的已经是最新内容。
+ * 按键、编码器、触摸和输出开关变化都算操作（main.cpp 中调用 activity()）。
+ * 熄屏时的操作只用于点亮屏幕，不再执行原来的功能。输出打开时不熄屏。
+ *
+ * PWM占空比只在UI任务的 update() 中写入，其他任务调用 activity() 只记录时间和改变状态，
+ * 最迟下一个UI周期（33ms）生效。亮度按平方关系换算为占空比，百分比与人眼感觉的亮度大致成正比。
+ * 报告中按各状态的累计时间和占空比估算背光电流，并按亮屏时每次渲染的平均耗时
+ * 估算熄屏期间节省的CPU时间。
+ * @date 2025-06-14
+ */
+
+#ifndef MY_BACKLIGHT_H
+#define MY_BACKLIGHT_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+
+#define BACKLIGHT_PWM_CHANNEL 7          // LEDC通道，避开从0开始分配的其他用途
+#define BACKLIGHT_PWM_FREQ_HZ 20000      // 高于可闻频率，看不出闪烁
+#define BACKLIGHT_PWM_BITS 10
+#define BACKLIGHT_DUTY_MAX ((1u << BACKLIGHT_PWM_BITS) - 1)
+
+#define BACKLIGHT_DEFAULT_BRIGHTNESS 100 // 百分比
+#define BACKLIGHT_DEFAULT_DIM 20         // 变暗后的亮度百分比
+#define BACKLIGHT_DIM_MS 30000           // 空闲多久变暗，0为不变暗
+#define BACKLIGHT_BLANK_MS 120000        // 输出关闭时空闲多久熄屏，0为不熄屏
+#define BACKLIGHT_FULL_MA 60.0f          // 背光全亮时的电流（估算用，2.8寸模块的典型值）
+
+enum BacklightState {
+    BACKLIGHT_ON = 0,
+    BACKLIGHT_DIM,
+    BACKLIGHT_BLANK,
+    BACKLIGHT_WAKING,    // 熄屏时有操作，等UI任务渲染完一帧再打开背光
+    BACKLIGHT_STATE_COUNT
+};
+
+struct BacklightStats {
+    uint32_t stateMs[BACKLIGHT_STATE_COUNT]; // 各状态累计时间
+    uint64_t dutyMs;                         // 占空比对时间的积分（占空比 x ms），用于估算电流
+    uint32_t dims;                           // 变暗次数
+    uint32_t blanks;                         // 熄屏次数
+    uint32_t wakes;                          // 从熄屏点亮的次数
+    uint32_t lastWakeUs;                     // 最近一次从操作到背光打开的时间
+    uint32_t maxWakeUs;
+    uint32_t renders;                        // 亮屏时 handle_lvgl_tasks 的调用次数
+    uint64_t renderUs;                       // 以及这些调用的总耗时
+    uint32_t skippedRenders;                 // 熄屏期间跳过的调用次数
+};
+
+class MyBacklight {
+public:
+    MyBacklight();
+
+    /**
+     * @brief 配置PWM并以设定亮度点亮
+     * @param pin 背光引脚，-1表示背光不可控（状态和暂停渲染照常工作）
+     * @return PWM配置成功（或pin为-1）返回true
+     */
+    bool begin(int pin);
+
+    // 亮度百分比（1-100）；变暗后的亮度百分比（0-100，不超过亮度）
+    void setBrightness(uint8_t percent);
+    uint8_t brightness() const { return _brightness; }
+    void setDimLevel(uint8_t percent);
+
+    // 空闲多久变暗、输出关闭时空闲多久熄屏，0为不变暗/不熄屏
+    void setTimeouts(uint32_t dimMs, uint32_t blankMs);
+
+    /**
+     * @brief 有操作（任何任务中调用）：重新计时，变暗或熄屏时恢复
+     * @return 屏幕原来是熄的（这次操作只用于点亮屏幕）返回true
+     */
+    bool activity();
+
+    /**
+     * @brief 进入待机时调用：亮着时立即变暗，并从现在开始熄屏的空闲计时（熄屏时不做任何事）
+     * @details 占空比与 activity() 一样在下一次 update() 中写入
+     */
+    void dimNow();
+
+    /**
+     * @brief UI任务每个周期在渲染之后调用：按空闲时间切换状态，写入占空比
+     * @param outputEnabled 输出是否打开（打开时不熄屏，熄屏中打开输出会立即点亮）
+     */
+    void update(bool outputEnabled);
+
+    // 是否允许渲染（熄屏时为false）
+    bool renderAllowed() const { return _state != BACKLIGHT_BLANK; }
+    BacklightState state() const { return _state; }
+
+    // 由 handle_lvgl_tasks 调用，统计渲染耗时和熄屏时跳过的次数
+    void recordRender(uint32_t us);
+    void recordSkippedRender();
+
+    void stats(BacklightStats &out) const;
+    void printReport() const;
+
+    // 亮度百分比对应的占空比
+    static uint32_t dutyFor(uint8_t percent);
+
+private:
+    int _pin;
+    mutable portMUX_TYPE _mux;
+    volatile BacklightState _state;
+    uint8_t _brightness;
+    uint8_t _dimLevel;
+    uint32_t _dimMs;
+    uint32_t _blankMs;
+
+    volatile uint32_t _lastActivityMs;
+    uint64_t _wakeStartUs;
+    uint32_t _duty;                      // 当前写入的占空比
+    uint32_t _accountMs;                 // 上次累计状态时间的时刻
+    BacklightStats _stats;
+
+    uint32_t targetDuty(BacklightState state) const;
+    void account(uint32_t now);
+};
+
+extern MyBacklight backlight;
+
+#endif // MY_BACKLIGHT_H
@@ -0,0 +1,470 @@
+/**
+ * @file myCapture.cpp
+ * @brief 高速波形捕获（示波器模式）：U_OUT/I_OUT连续采样到PSRAM，电平/边沿触发，可设预触发深度
+ * @author watermelon6uice
+ * @date 2025-06-13
+ */
+
+#include "myCapture.h"
+#include "myHAL.h"
+#include "myPower.h"
+#include "myTaskTable.h"
+#include "esp_heap_caps.h"
+#include <math.h>
+
+// 与 myADC.h 中的 ADC_U_OUT_PIN、ADC_I_OUT_PIN 一致
+#define CAPTURE_ADC_U_OUT 2
+#define CAPTURE_ADC_I_OUT 3
+
+#define CAPTURE_MIN_DEPTH 16
+
+static const uint8_t CAPTURE_ADC_CHANNELS[CAPTURE_CHANNELS] = {CAPTURE_ADC_U_OUT, CAPTURE_ADC_I_OUT};
+static const char *CHANNEL_NAMES[CAPTURE_CHANNELS] = {"U_OUT", "I_OUT"};
+
+MyCapture capture;
+
+CaptureConfig captureDefaultConfig() {
+    CaptureConfig c;
+    c.channelMask = CAPTURE_MASK(CAPTURE_U_OUT) | CAPTURE_MASK(CAPTURE_I_OUT);
+    c.sampleHz = 40000;
+    c.depth = 4096;
+    c.preTrigger = 1024;
+    c.source = CAPTURE_I_OUT;
+    c.edge = CAPTURE_TRIG_RISING;
+    c.level = 1.0f;
+    c.hysteresis = 0.02f;
+    c.autoMs = 0;
+    return c;
+}
+
+MyCapture::MyCapture() :
+    _buffer(NULL),
+    _requests(NULL),
+    _state(CAPTURE_IDLE),
+    _cancel(false),
+    _generation(0),
+    _config(captureDefaultConfig()),
+    _channels(0),
+    _startFrame(0),
+    _triggered(false),
+    _triggerUs(0),
+    _overruns(0),
+    _noteGeneration(0),
+    _noteSeq(0)
+{
+    portMUX_TYPE unlocked = portMUX_INITIALIZER_UNLOCKED;
+    _noteMux = unlocked;
+    _note[0] = '\0';
+    for (int ch = 0; ch < CAPTURE_CHANNELS; ch++) {
+        _scale[ch] = 0.001f;
+        _slot[ch] = 0;
+    }
+}
+
+bool MyCapture::begin() {
+    _buffer = (uint16_t *)heap_caps_malloc(CAPTURE_MAX_SAMPLES * sizeof(uint16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (_buffer == NULL) {
+        Serial.println("错误: 无法分配波形捕获缓冲区");
+        return false;
+    }
+    _requests = xQueueCreate(1, sizeof(CaptureConfig));
+    if (_requests == NULL || taskTableCreate(taskEntry, "Capture", this, NULL) != pdPASS) {
+        Serial.println("错误: 无法创建波形捕获任务");
+        return false;
+    }
+    return true;
+}
+
+void MyCapture::setScale(uint8_t channel, float unitsPerMv) {
+    if (channel < CAPTURE_CHANNELS && unitsPerMv > 0.0f) {
+        _scale[channel] = unitsPerMv;
+    }
+}
+
+float MyCapture::scale(uint8_t channel) const {
+    return channel < CAPTURE_CHANNELS ? _scale[channel] : 0.0f;
+}
+
+bool MyCapture::validate(const CaptureConfig &c) const {
+    uint8_t n = 0;
+    for (int ch = 0; ch < CAPTURE_CHANNELS; ch++) {
+        if (c.channelMask & CAPTURE_MASK(ch)) {
+            n++;
+        }
+    }
+    if (n == 0 || (c.channelMask >> CAPTURE_CHANNELS) != 0) {
+        return false;
+    }
+    uint32_t totalHz = c.sampleHz * n;
+    if (c.sampleHz == 0 || totalHz < HAL_ADC_STREAM_MIN_HZ || totalHz > HAL_ADC_STREAM_MAX_HZ) {
+        return false;
+    }
+    if (c.depth < CAPTURE_MIN_DEPTH || c.depth * n > CAPTURE_MAX_SAMPLES || c.preTrigger >= c.depth) {
+        return false;
+    }
+    if (c.edge > CAPTURE_TRIG_STEP || c.hysteresis < 0.0f) {
+        return false;
+    }
+    if (c.edge == CAPTURE_TRIG_STEP && (c.level <= 0.0f || c.depth <= CAPTURE_STEP_FRAMES)) {
+        return false;
+    }
+    if (c.edge != CAPTURE_TRIG_NONE && (c.source >= CAPTURE_CHANNELS || !(c.channelMask & CAPTURE_MASK(c.source)))) {
+        return false;
+    }
+    return true;
+}
+
+bool MyCapture::arm(const CaptureConfig &config) {
+    if (_buffer == NULL || _requests == NULL || !validate(config)) {
+        return false;
+    }
+    // 正在进行的捕获看到取消标志后结束，捕获任务随后取出新的请求
+    if (_state == CAPTURE_ARMED) {
+        _cancel = true;
+    }
+    if (xQueueSend(_requests, &config, 0) != pdTRUE) {
+        return false;
+    }
+    _state = CAPTURE_ARMED;
+    return true;
+}
+
+void MyCapture::cancel() {
+    if (_state == CAPTURE_ARMED) {
+        _cancel = true;
+        _state = CAPTURE_IDLE;
+    }
+}
+
+void MyCapture::taskEntry(void *param) {
+    MyCapture *self = static_cast<MyCapture *>(param);
+    CaptureConfig config;
+    while (true) {
+        if (xQueueReceive(self->_requests, &config, portMAX_DELAY) == pdTRUE) {
+            self->_cancel = false;
+            self->run(config);
+        }
+    }
+}
+
+void MyCapture::run(const CaptureConfig &config) {
+    _state = CAPTURE_ARMED;
+    _config = config;
+    _channels = 0;
+    uint8_t adcChannels[CAPTURE_CHANNELS];
+    for (int ch = 0; ch < CAPTURE_CHANNELS; ch++) {
+        if (config.channelMask & CAPTURE_MASK(ch)) {
+            _slot[ch] = _channels;
+            adcChannels[_channels++] = CAPTURE_ADC_CHANNELS[ch];
+        }
+    }
+    _triggered = false;
+    _triggerUs = 0;
+    _overruns = 0;
+
+    const uint32_t depth = config.depth;
+    const uint32_t post = depth - config.preTrigger;
+    const uint8_t full = (1 << _channels) - 1;
+    const uint8_t sourceSlot = _slot[config.source < CAPTURE_CHANNELS ? config.source : 0];
+    const float sourceScale = _scale[config.source < CAPTURE_CHANNELS ? config.source : 0];
+    const float levelMv = config.level / sourceScale;
+    const float lowMv = (config.level - config.hysteresis) / sourceScale;
+    const float highMv = (config.level + config.hysteresis) / sourceScale;
+
+    // 连续采样期间APB保持最高频率（ADC的DMA时钟），不进入轻睡眠
+    power.setActive(POWER_CLIENT_ADC_STREAM, true);
+    if (!halAdcStreamStart(adcChannels, _channels, config.sampleHz * _channels)) {
+        power.setActive(POWER_CLIENT_ADC_STREAM, false);
+        Serial.println("错误: 无法启动ADC连续采样");
+        _state = CAPTURE_FAILED;
+        return;
+    }
+    uint32_t armMs = halMillis();
+    int64_t startUs = (int64_t)halMicros();
+
+    HalAdcSample block[CAPTURE_BLOCK_SAMPLES];
+    uint16_t partial[CAPTURE_CHANNELS];
+    uint8_t have = 0;
+    uint64_t total = 0;          // 已写入的帧数
+    uint64_t triggerTotal = 0;
+    bool triggered = false;
+    bool belowSeen = false;      // 上升沿：已低于 level - hysteresis
+    bool aboveSeen = false;      // 下降沿：已高于 level + hysteresis
+    bool done = false;
+
+    while (!done && !_cancel) {
+        bool overrun = false;
+        size_t got = halAdcStreamRead(block, CAPTURE_BLOCK_SAMPLES, CAPTURE_READ_TIMEOUT_MS, &overrun);
+        if (overrun && triggered) {
+            _overruns++;
+        }
+        for (size_t i = 0; i < got && !done; i++) {
+            uint8_t ch = block[i].channel == CAPTURE_ADC_U_OUT ? CAPTURE_U_OUT :
+                         block[i].channel == CAPTURE_ADC_I_OUT ? CAPTURE_I_OUT : CAPTURE_CHANNELS;
+            if (ch >= CAPTURE_CHANNELS || !(config.channelMask & CAPTURE_MASK(ch))) {
+                continue;
+            }
+            uint8_t slot = _slot[ch];
+            if (have & (1 << slot)) {
+                // 丢了样本，从这个样本重新对齐
+                have = 0;
+            }
+            partial[slot] = (uint16_t)halAdcRawToMv(block[i].raw);
+            have |= 1 << slot;
+            if (have != full) {
+                continue;
+            }
+            have = 0;
+
+            memcpy(&_buffer[(total % depth) * _channels], partial, _channels * sizeof(uint16_t));
+            total++;
+
+            if (!triggered) {
+                // 触发帧之前至少要有 preTrigger 帧
+                bool ready = total > config.preTrigger;
+                bool hit = false;
+                float v = partial[sourceSlot];
+                if (config.edge == CAPTURE_TRIG_NONE) {
+                    hit = ready;
+                }
+                if (config.edge == CAPTURE_TRIG_RISING || config.edge == CAPTURE_TRIG_EITHER) {
+                    if (v < lowMv) {
+                        belowSeen = true;
+                    } else if (v >= levelMv) {
+                        hit = hit || (belowSeen && ready);
+                        belowSeen = false;
+                    }
+                }
+                if (config.edge == CAPTURE_TRIG_FALLING || config.edge == CAPTURE_TRIG_EITHER) {
+                    if (v > highMv) {
+                        aboveSeen = true;
+                    } else if (v <= levelMv) {
+                        hit = hit || (aboveSeen && ready);
+                        aboveSeen = false;
+                    }
+                }
+                if (config.edge == CAPTURE_TRIG_STEP && ready && total > CAPTURE_STEP_FRAMES) {
+                    // 与 CAPTURE_STEP_FRAMES 帧之前的样本比较（仍在环形缓冲区中）
+                    float old = _buffer[((total - 1 - CAPTURE_STEP_FRAMES) % depth) * _channels + sourceSlot];
+                    hit = fabsf(v - old) >= levelMv;
+                }
+                _triggered = hit && config.edge != CAPTURE_TRIG_NONE;
+                if (!hit && ready && config.autoMs > 0 && halMillis() - armMs >= config.autoMs) {
+                    hit = true;
+                }
+                if (hit) {
+                    triggered = true;
+                    triggerTotal = total - 1;
+                    _triggerUs = startUs + (int64_t)(triggerTotal * 1000000ull / config.sampleHz);
+                }
+            }
+            if (triggered && total - triggerTotal >= post) {
+                done = true;
+            }
+        }
+    }
+    halAdcStreamStop();
+    power.setActive(POWER_CLIENT_ADC_STREAM, false);
+    if (!done) {
+        // 已取消：状态由 cancel() 或新的 arm() 设置
+        return;
+    }
+    // 完成时 total - triggerTotal == post，逻辑第0帧是第 total - depth 帧
+    _startFrame = (uint32_t)(total % depth);
+    _generation++;
+    _state = CAPTURE_DONE;
+}
+
+uint32_t MyCapture::physical(uint32_t frame) const {
+    uint32_t pos = _startFrame + frame;
+    return pos >= _config.depth ? pos - _config.depth : pos;
+}
+
+bool MyCapture::info(CaptureInfo &out) const {
+    uint32_t gen = _generation;
+    if (_state != CAPTURE_DONE) {
+        return false;
+    }
+    out.channelMask = _config.channelMask;
+    out.channels = _channels;
+    out.sampleHz = _config.sampleHz;
+    out.frames = _config.depth;
+    out.triggerFrame = _config.preTrigger;
+    out.triggered = _triggered;
+    out.triggerUs = _triggerUs;
+    out.overruns = _overruns;
+    out.generation = gen;
+    return _state == CAPTURE_DONE && _generation == gen;
+}
+
+uint16_t MyCapture::sampleMv(uint32_t frame, uint8_t channel) const {
+    if (_buffer == NULL || channel >= CAPTURE_CHANNELS || !(_config.channelMask & CAPTURE_MASK(channel)) ||
+        frame >= _config.depth) {
+        return 0;
+    }
+    return _buffer[physical(frame) * _channels + _slot[channel]];
+}
+
+float MyCapture::sample(uint32_t frame, uint8_t channel) const {
+    return sampleMv(frame, channel) * scale(channel);
+}
+
+bool MyCapture::decimate(uint8_t channel, uint32_t first, uint32_t count, uint16_t columns,
+                         float *mins, float *maxs) const {
+    uint32_t gen = _generation;
+    if (_state != CAPTURE_DONE || columns == 0 || channel >= CAPTURE_CHANNELS ||
+        !(_config.channelMask & CAPTURE_MASK(channel)) || first >= _config.depth) {
+        return false;
+    }
+    if (count > _config.depth - first) {
+        count = _config.depth - first;
+    }
+    float k = _scale[channel];
+    for (uint16_t c = 0; c < columns; c++) {
+        uint32_t begin = first + (uint32_t)((uint64_t)c * count / columns);
+        uint32_t end = first + (uint32_t)((uint64_t)(c + 1) * count / columns);
+        if (end <= begin) {
+            // 帧数少于列数：这一列取最近的一帧
+            end = begin + 1;
+        }
+        uint16_t lo = UINT16_MAX;
+        uint16_t hi = 0;
+        for (uint32_t f = begin; f < end; f++) {
+            uint16_t v = _buffer[physical(f) * _channels + _slot[channel]];
+            lo = v < lo ? v : lo;
+            hi = v > hi ? v : hi;
+        }
+        mins[c] = lo * k;
+        maxs[c] = hi * k;
+    }
+    return _state == CAPTURE_DONE && _generation == gen;
+}
+
+uint16_t MyCapture::crc16(uint16_t crc, const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void putU32(uint8_t *p, uint32_t v) {
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+    p[2] = (v >> 16) & 0xff;
+    p[3] = (v >> 24) & 0xff;
+}
+
+size_t MyCapture::exportBinary(CaptureWriter write, void *ctx) const {
+    CaptureInfo ci;
+    if (!info(ci)) {
+        return 0;
+    }
+    uint8_t header[20 + 4 * CAPTURE_CHANNELS];
+    memcpy(header, "PDCP", 4);
+    header[4] = CAPTURE_FORMAT_VERSION;
+    header[5] = ci.channels;
+    header[6] = ci.channelMask;
+    header[7] = ci.triggered ? 1 : 0;
+    putU32(&header[8], ci.sampleHz);
+    putU32(&header[12], ci.frames);
+    putU32(&header[16], ci.triggerFrame);
+    size_t headerLen = 20;
+    for (int ch = 0; ch < CAPTURE_CHANNELS; ch++) {
+        if (ci.channelMask & CAPTURE_MASK(ch)) {
+            uint32_t bits;
+            memcpy(&bits, &_scale[ch], sizeof(bits));
+            putU32(&header[headerLen], bits);
+            headerLen += 4;
+        }
+    }
+    size_t written = write(header, headerLen, ctx);
+    uint16_t crc = crc16(0xffff, header, headerLen);
+
+    // 按逻辑顺序分块写出样本
+    uint8_t chunk[256];
+    size_t used = 0;
+    for (uint32_t f = 0; f < ci.frames; f++) {
+        const uint16_t *frame = &_buffer[physical(f) * _channels];
+        for (uint8_t s = 0; s < _channels; s++) {
+            chunk[used++] = frame[s] & 0xff;
+            chunk[used++] = frame[s] >> 8;
+        }
+        if (used + 2 * CAPTURE_CHANNELS > sizeof(chunk) || f + 1 == ci.frames) {
+            written += write(chunk, used, ctx);
+            crc = crc16(crc, chunk, used);
+            used = 0;
+        }
+    }
+    uint8_t tail[2] = {(uint8_t)(crc & 0xff), (uint8_t)(crc >> 8)};
+    written += write(tail, sizeof(tail), ctx);
+    if (_state != CAPTURE_DONE || _generation != ci.generation) {
+        Serial.println("警告: 导出期间开始了新的捕获，数据无效");
+    }
+    return written;
+}
+
+void MyCapture::setNote(uint32_t generation, const char *text) {
+    portENTER_CRITICAL(&_noteMux);
+    snprintf(_note, sizeof(_note), "%s", text);
+    _noteGeneration = generation;
+    _noteSeq++;
+    portEXIT_CRITICAL(&_noteMux);
+}
+
+bool MyCapture::note(uint32_t generation, char *out, size_t size) const {
+    if (size == 0) {
+        return false;
+    }
+    portENTER_CRITICAL(&_noteMux);
+    bool found = _noteSeq > 0 && _noteGeneration == generation;
+    snprintf(out, size, "%s", found ? _note : "");
+    portEXIT_CRITICAL(&_noteMux);
+    return found;
+}
+
+void MyCapture::printReport() const {
+    Serial.println("===== 波形捕获 =====");
+    CaptureInfo ci;
+    if (!info(ci)) {
+        Serial.printf("状态: %s\n", stateName(_state));
+        return;
+    }
+    Serial.printf("状态: %s  %u通道 每通道%luHz  %lu帧（%.1fms）\n", stateName(_state), ci.channels,
+                  (unsigned long)ci.sampleHz, (unsigned long)ci.frames, ci.frames * 1000.0f / ci.sampleHz);
+    Serial.printf("触发: 第%lu帧 %s  丢失样本 %lu次\n", (unsigned long)ci.triggerFrame,
+                  ci.triggered ? "由触发条件触发" : "强制触发", (unsigned long)ci.overruns);
+    for (uint8_t ch = 0; ch < CAPTURE_CHANNELS; ch++) {
+        if (!(ci.channelMask & CAPTURE_MASK(ch))) {
+            continue;
+        }
+        uint16_t lo = UINT16_MAX;
+        uint16_t hi = 0;
+        uint64_t sum = 0;
+        for (uint32_t f = 0; f < ci.frames; f++) {
+            uint16_t v = sampleMv(f, ch);
+            lo = v < lo ? v : lo;
+            hi = v > hi ? v : hi;
+            sum += v;
+        }
+        float k = _scale[ch];
+        Serial.printf("  %-6s 最小 %.3f  最大 %.3f  平均 %.4f  触发点 %.3f\n", channelName(ch),
+                      lo * k, hi * k, (float)sum / ci.frames * k, sample(ci.triggerFrame, ch));
+    }
+}
+
+const char *MyCapture::stateName(CaptureState state) {
+    switch (state) {
+        case CAPTURE_IDLE: return "空闲";
+        case CAPTURE_ARMED: return "等待触发";
+        case CAPTURE_DONE: return "完成";
+        case CAPTURE_FAILED: return "失败";
+        default: return "?";
+    }
+}
+
+const char *MyCapture::channelName(uint8_t channel) {
+    return channel < CAPTURE_CHANNELS ? CHANNEL_NAMES[channel] : "?";
+}
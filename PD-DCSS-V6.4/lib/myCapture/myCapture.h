@@ -0,0 +1,219 @@
+/**
+ * @file myCapture.h
+ * @brief 高速波形捕获（示波器模式）：U_OUT/I_OUT连续采样到PSRAM，电平/边沿触发，可设预触发深度
+ * @author watermelon6uice
+ * @details
+ * 显示用的测量值每50ms采样一次，限流回路每2ms一帧，都看不到负载瞬变和纹波。
+ * 本模块用HAL的ADC连续采样（DMA，合计最高约83kHz）以固定速率采集一个或两个通道：
+ * - arm() 之后样本写入环形缓冲区，至少写满预触发深度后开始检查触发条件；
+ * - 触发：触发通道越过电平（上升沿、下降沿或任一边沿，带迟滞），或超过 autoMs 未触发时强制触发，
+ *   CAPTURE_TRIG_NONE 写满预触发深度后立即触发；CAPTURE_TRIG_STEP 在触发通道
+ *   CAPTURE_STEP_FRAMES 帧之内变化超过 level 时触发（任一方向，用于检测负载阶跃）；
+ * - 触发后再采集 depth - preTrigger 帧即完成，停止连续采样。完成的波形中触发点固定在
+ *   第 preTrigger 帧，逻辑第0帧是最早的样本。
+ * 样本按毫伏保存为16位整数（两个通道交错），每个通道有换算系数（V/mV或A/mV，与MyADC的校准一致）。
+ * 捕获期间单次读数改为返回连续采样的最近结果（见 halAdcStreamStart），
+ * 限流回路和输出保护照常运行；U_IN/I_IN不在连续采样中，期间保持开始捕获前的读数，
+ * 长时间反复捕获的使用者要在两次捕获之间留出间隔（见 myTransient.h）。
+ *
+ * 读取（sample、decimate、exportBinary）只在 CAPTURE_DONE 状态下有效。每完成一次捕获
+ * generation 加1，读取者在读取前后比较 generation 即可发现读取期间被重新 arm 覆盖的数据。
+ *
+ * 二进制导出格式（小端）：
+ *   0   4  "PDCP"
+ *   4   1  版本（1）
+ *   5   1  通道数N
+ *   6   1  通道掩码（bit0 U_OUT，bit1 I_OUT），样本按通道号从小到大交错
+ *   7   1  标志（bit0 由触发条件触发，为0表示强制触发或立即触发）
+ *   8   4  每通道采样率(Hz)
+ *   12  4  帧数
+ *   16  4  触发帧序号
+ *   20  4N 各通道换算系数（float32，每毫伏对应的V或A）
+ *   ..  2×N×帧数  样本（uint16，毫伏）
+ *   末尾 2  CRC-16/CCITT-FALSE（覆盖前面全部字节）
+ * @date 2025-06-13
+ */
+
+#ifndef MY_CAPTURE_H
+#define MY_CAPTURE_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#define CAPTURE_CHANNELS 2              // U_OUT、I_OUT
+#define CAPTURE_MAX_SAMPLES 65536       // 缓冲区容量（所有通道合计的样本数），PSRAM中128KB
+#define CAPTURE_BLOCK_SAMPLES 128       // 每次从HAL读取的样本数
+#define CAPTURE_READ_TIMEOUT_MS 20      // 单次读取的超时
+#define CAPTURE_FORMAT_VERSION 1
+#define CAPTURE_STEP_FRAMES 8           // 阶跃触发比较的帧间隔（40kHz时200us）
+#define CAPTURE_NOTE_MAX 64             // 捕获注释的最大长度（含结尾的0）
+
+enum CaptureChannel {
+    CAPTURE_U_OUT = 0,
+    CAPTURE_I_OUT = 1,
+};
+
+#define CAPTURE_MASK(ch) (1 << (ch))
+
+enum CaptureEdge {
+    CAPTURE_TRIG_NONE = 0,   // 写满预触发深度后立即触发
+    CAPTURE_TRIG_RISING,
+    CAPTURE_TRIG_FALLING,
+    CAPTURE_TRIG_EITHER,
+    CAPTURE_TRIG_STEP,       // CAPTURE_STEP_FRAMES 帧内变化超过 level（level为变化量）
+};
+
+enum CaptureState {
+    CAPTURE_IDLE = 0,        // 没有捕获，或已取消
+    CAPTURE_ARMED,           // 正在采集，等待触发或触发后的样本
+    CAPTURE_DONE,            // 波形可读
+    CAPTURE_FAILED,          // 连续采样启动失败
+};
+
+struct CaptureConfig {
+    uint8_t channelMask;     // 参与采集的通道
+    uint32_t sampleHz;       // 每个通道的采样率
+    uint32_t depth;          // 帧数（每通道样本数）
+    uint32_t preTrigger;     // 触发点之前的帧数，小于 depth
+    uint8_t source;          // 触发通道（CaptureChannel），必须在 channelMask 中
+    uint8_t edge;            // CaptureEdge
+    float level;             // 触发电平(V或A)
+    float hysteresis;        // 迟滞：上升沿要求先低于 level - hysteresis，下降沿要求先高于 level + hysteresis
+    uint32_t autoMs;         // 超过此时间未触发则强制触发，0表示一直等待
+};
+
+// 默认配置：两个通道各40kHz，4096帧（约100ms），预触发25%，I_OUT上升沿
+CaptureConfig captureDefaultConfig();
+
+// 完成的捕获
+struct CaptureInfo {
+    uint8_t channelMask;
+    uint8_t channels;        // 通道数
+    uint32_t sampleHz;
+    uint32_t frames;
+    uint32_t triggerFrame;   // 触发点的帧序号（等于 preTrigger）
+    bool triggered;          // 由触发条件触发（否则为强制或立即触发）
+    int64_t triggerUs;       // 触发帧的时刻(us，halMicros)
+    uint32_t overruns;       // 触发后因读取不及时丢失样本的次数
+    uint32_t generation;
+};
+
+// 导出时的写出函数，返回写出的字节数
+typedef size_t (*CaptureWriter)(const uint8_t *data, size_t len, void *ctx);
+
+class MyCapture {
+public:
+    MyCapture();
+
+    /**
+     * @brief 分配采样缓冲区（优先PSRAM）并创建捕获任务
+     * @return 成功返回true
+     */
+    bool begin();
+
+    /**
+     * @brief 设置通道的换算系数（每毫伏对应的V或A），默认0.001（校准系数为1）
+     */
+    void setScale(uint8_t channel, float unitsPerMv);
+    float scale(uint8_t channel) const;
+
+    /**
+     * @brief 按配置开始一次捕获；正在捕获时先取消
+     * @return 配置无效或没有缓冲区时返回false
+     */
+    bool arm(const CaptureConfig &config);
+
+    // 取消正在进行的捕获，回到 CAPTURE_IDLE
+    void cancel();
+
+    CaptureState state() const { return _state; }
+    uint32_t generation() const { return _generation; }
+
+    // 当前（或最近完成的）捕获的配置
+    const CaptureConfig &config() const { return _config; }
+
+    /**
+     * @brief 读取最近一次完成的捕获的信息
+     * @return 不在 CAPTURE_DONE 状态时返回false
+     */
+    bool info(CaptureInfo &out) const;
+
+    /**
+     * @brief 第 frame 帧某通道的样本
+     * @return 毫伏；通道不在捕获中或超出范围时返回0
+     */
+    uint16_t sampleMv(uint32_t frame, uint8_t channel) const;
+
+    // 同上，按换算系数换算为V或A
+    float sample(uint32_t frame, uint8_t channel) const;
+
+    /**
+     * @brief 把 [first, first+count) 帧分成 columns 列，求每列的最小、最大值（V或A），用于绘图
+     * @return 完成且期间没有被新的捕获覆盖返回true
+     */
+    bool decimate(uint8_t channel, uint32_t first, uint32_t count, uint16_t columns,
+                  float *mins, float *maxs) const;
+
+    /**
+     * @brief 按头文件中说明的格式导出最近一次完成的捕获
+     * @return 写出的字节数，没有完成的捕获时为0
+     */
+    size_t exportBinary(CaptureWriter write, void *ctx) const;
+
+    /**
+     * @brief 为某次完成的捕获附加一行注释（如瞬态分析的结果），示波器屏幕显示该捕获时一并显示
+     * @param generation 捕获序号（CaptureInfo::generation）
+     * @note 可在任意任务中调用，文本被复制
+     */
+    void setNote(uint32_t generation, const char *text);
+
+    /**
+     * @brief 读取 generation 对应的注释
+     * @return 该捕获没有注释时返回false
+     */
+    bool note(uint32_t generation, char *out, size_t size) const;
+
+    // 每次 setNote() 加1，显示方据此判断是否需要刷新
+    uint32_t noteSeq() const { return _noteSeq; }
+
+    // 串口输出状态和各通道的最小、最大、平均值
+    void printReport() const;
+
+    static const char *stateName(CaptureState state);
+    static const char *channelName(uint8_t channel);
+    static uint16_t crc16(uint16_t crc, const uint8_t *data, size_t len);
+
+private:
+    uint16_t *_buffer;
+    QueueHandle_t _requests;
+    volatile CaptureState _state;
+    volatile bool _cancel;
+    volatile uint32_t _generation;
+    float _scale[CAPTURE_CHANNELS];
+
+    // 当前（或最近完成的）捕获
+    CaptureConfig _config;
+    uint8_t _channels;
+    uint8_t _slot[CAPTURE_CHANNELS];   // 通道在帧内的位置
+    uint32_t _startFrame;              // 环形缓冲区中逻辑第0帧的位置
+    bool _triggered;
+    int64_t _triggerUs;
+    uint32_t _overruns;
+
+    // 注释
+    mutable portMUX_TYPE _noteMux;
+    char _note[CAPTURE_NOTE_MAX];
+    uint32_t _noteGeneration;
+    volatile uint32_t _noteSeq;
+
+    static void taskEntry(void *param);
+    void run(const CaptureConfig &config);
+    bool validate(const CaptureConfig &config) const;
+    uint32_t physical(uint32_t frame) const;
+};
+
+extern MyCapture capture;
+
+#endif // MY_CAPTURE_H
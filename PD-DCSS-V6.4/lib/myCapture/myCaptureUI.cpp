@@ -0,0 +1,265 @@
+/**
+ * @file myCaptureUI.cpp
+ * @brief 示波器屏幕：显示最近一次完成的波形捕获（每列最小/最大值），触发点和触发电平
+ * @author watermelon6uice
+ * @details
+ * 屏幕由屏幕表（myScreens）在第一次切换或空闲预加载时创建。U_OUT和I_OUT各占一个通道带，纵向按本次波形的范围自动缩放。
+ * 每次捕获完成后只抽取一次（每列的最小、最大值换算成像素），
+ * 绘制回调按列画竖线并与相邻列相连，陡峭的边沿和纹波的包络都不会漏掉。
+ * @date 2025-06-13
+ */
+
+#include "myCaptureUI.h"
+#include "myCapture.h"
+#include "gui_guider.h"
+
+#define SCOPE_COLUMNS 300            // 绘图区宽度（像素列）
+#define SCOPE_LANE_H 84              // 每个通道带的高度
+#define SCOPE_LANE_GAP 8
+#define SCOPE_PLOT_X 10
+#define SCOPE_PLOT_Y 22
+#define SCOPE_PLOT_H (CAPTURE_CHANNELS * SCOPE_LANE_H + (CAPTURE_CHANNELS - 1) * SCOPE_LANE_GAP)
+#define SCOPE_MIN_SPAN 0.02f         // 纵向最小量程(V或A)，平直的波形不会把噪声放大到满幅
+#define SCOPE_MARGIN 0.1f            // 上下各留出量程的10%
+
+#define SCOPE_BG_COLOR 0x000822
+#define SCOPE_GRID_COLOR 0x1f3050
+#define SCOPE_TRIGGER_COLOR 0xff0027
+#define SCOPE_TEXT_COLOR 0xffffff
+#define SCOPE_NOTE_COLOR 0x7fb2ff
+
+static const uint32_t TRACE_COLORS[CAPTURE_CHANNELS] = {0xcfc300, 0x00a629};
+static const char *const EDGE_NAMES[] = {"none", "rise", "fall", "any", "step"};
+
+static lv_obj_t *s_plot = NULL;
+static lv_obj_t *s_status = NULL;
+static lv_obj_t *s_info = NULL;
+static lv_obj_t *s_laneLabel[CAPTURE_CHANNELS];
+static lv_obj_t *s_note = NULL;
+static uint32_t s_noteShownSeq = 0;
+
+// 已显示的捕获
+static uint32_t s_shownGeneration = 0;
+static CaptureState s_shownState = CAPTURE_IDLE;
+static bool s_haveTrace = false;
+static bool s_laneValid[CAPTURE_CHANNELS];
+static lv_coord_t s_top[CAPTURE_CHANNELS][SCOPE_COLUMNS];      // 每列最大值对应的像素行（相对绘图区）
+static lv_coord_t s_bottom[CAPTURE_CHANNELS][SCOPE_COLUMNS];   // 每列最小值对应的像素行
+static lv_coord_t s_triggerX = -1;
+static lv_coord_t s_levelY = -1;
+
+// 抽取用的临时数组，放在静态区，不占UI任务的栈
+static float s_mins[SCOPE_COLUMNS];
+static float s_maxs[SCOPE_COLUMNS];
+
+static lv_coord_t laneTop(uint8_t channel) {
+    return channel * (SCOPE_LANE_H + SCOPE_LANE_GAP);
+}
+
+static lv_coord_t toPixel(uint8_t channel, float value, float lo, float span) {
+    float pos = (value - lo) / span;
+    if (pos < 0.0f) pos = 0.0f;
+    if (pos > 1.0f) pos = 1.0f;
+    return laneTop(channel) + (SCOPE_LANE_H - 1) - (lv_coord_t)(pos * (SCOPE_LANE_H - 1) + 0.5f);
+}
+
+static void drawLine(lv_draw_ctx_t *ctx, const lv_draw_line_dsc_t *dsc,
+                     lv_coord_t x1, lv_coord_t y1, lv_coord_t x2, lv_coord_t y2) {
+    lv_point_t p1 = {x1, y1};
+    lv_point_t p2 = {x2, y2};
+    lv_draw_line(ctx, dsc, &p1, &p2);
+}
+
+static void plotDrawCb(lv_event_t *e) {
+    lv_draw_ctx_t *ctx = lv_event_get_draw_ctx(e);
+    lv_area_t a;
+    lv_obj_get_coords(lv_event_get_target(e), &a);
+
+    lv_draw_line_dsc_t dsc;
+    lv_draw_line_dsc_init(&dsc);
+    dsc.width = 1;
+
+    // 通道带的上下边界和中线
+    dsc.color = lv_color_hex(SCOPE_GRID_COLOR);
+    dsc.dash_width = 2;
+    dsc.dash_gap = 3;
+    for (uint8_t ch = 0; ch < CAPTURE_CHANNELS; ch++) {
+        lv_coord_t y = a.y1 + laneTop(ch);
+        drawLine(ctx, &dsc, a.x1, y, a.x2, y);
+        drawLine(ctx, &dsc, a.x1, y + SCOPE_LANE_H / 2, a.x2, y + SCOPE_LANE_H / 2);
+        drawLine(ctx, &dsc, a.x1, y + SCOPE_LANE_H - 1, a.x2, y + SCOPE_LANE_H - 1);
+    }
+    if (!s_haveTrace) {
+        return;
+    }
+
+    // 触发点和触发电平
+    dsc.color = lv_color_hex(SCOPE_TRIGGER_COLOR);
+    if (s_triggerX >= 0) {
+        drawLine(ctx, &dsc, a.x1 + s_triggerX, a.y1, a.x1 + s_triggerX, a.y2);
+    }
+    if (s_levelY >= 0) {
+        drawLine(ctx, &dsc, a.x1, a.y1 + s_levelY, a.x2, a.y1 + s_levelY);
+    }
+
+    // 波形：每列从最大值画到最小值，并延伸到与前一列相接
+    dsc.dash_width = 0;
+    dsc.dash_gap = 0;
+    for (uint8_t ch = 0; ch < CAPTURE_CHANNELS; ch++) {
+        if (!s_laneValid[ch]) {
+            continue;
+        }
+        dsc.color = lv_color_hex(TRACE_COLORS[ch]);
+        for (uint16_t c = 0; c < SCOPE_COLUMNS; c++) {
+            lv_coord_t top = s_top[ch][c];
+            lv_coord_t bottom = s_bottom[ch][c];
+            if (c > 0) {
+                top = LV_MIN(top, s_bottom[ch][c - 1]);
+                bottom = LV_MAX(bottom, s_top[ch][c - 1]);
+            }
+            // 终点比起点多一行，单个像素也能画出来
+            drawLine(ctx, &dsc, a.x1 + c, a.y1 + top, a.x1 + c, a.y1 + bottom + 1);
+        }
+    }
+}
+
+static lv_obj_t *createLabel(lv_obj_t *parent, lv_coord_t x, lv_coord_t y, uint32_t color) {
+    lv_obj_t *label = lv_label_create(parent);
+    lv_obj_set_style_text_font(label, &lv_font_montserratMedium_9, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(label, lv_color_hex(color), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_pos(label, x, y);
+    lv_label_set_text(label, "");
+    return label;
+}
+
+static void showState(CaptureState state) {
+    s_shownState = state;
+    lv_label_set_text_fmt(s_status, "%s  c:arm  x:export  o:back", MyCapture::stateName(state));
+}
+
+// 屏幕被删除（超出屏幕内存预算）时清空所有对象指针
+static void screenDeleteCb(lv_event_t *e) {
+    s_plot = NULL;
+    s_status = NULL;
+    s_info = NULL;
+    s_note = NULL;
+    for (uint8_t ch = 0; ch < CAPTURE_CHANNELS; ch++) {
+        s_laneLabel[ch] = NULL;
+    }
+}
+
+void buildCaptureScreen(lv_obj_t *screen) {
+    lv_obj_set_style_bg_color(screen, lv_color_hex(SCOPE_BG_COLOR), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(screen, LV_OPA_COVER, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_event_cb(screen, screenDeleteCb, LV_EVENT_DELETE, NULL);
+
+    lv_obj_t *title = lv_label_create(screen);
+    lv_obj_set_style_text_font(title, &lv_font_Alatsi_Regular_12, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(title, lv_color_hex(SCOPE_TEXT_COLOR), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_pos(title, SCOPE_PLOT_X, 3);
+    lv_label_set_text(title, "SCOPE");
+
+    s_status = createLabel(screen, 70, 6, SCOPE_TEXT_COLOR);
+
+    // 绘图区不用任何样式，全部在绘制回调中画
+    s_plot = lv_obj_create(screen);
+    lv_obj_remove_style_all(s_plot);
+    lv_obj_clear_flag(s_plot, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_clear_flag(s_plot, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_pos(s_plot, SCOPE_PLOT_X, SCOPE_PLOT_Y);
+    lv_obj_set_size(s_plot, SCOPE_COLUMNS, SCOPE_PLOT_H);
+    lv_obj_add_event_cb(s_plot, plotDrawCb, LV_EVENT_DRAW_MAIN, NULL);
+
+    for (uint8_t ch = 0; ch < CAPTURE_CHANNELS; ch++) {
+        s_laneLabel[ch] = createLabel(screen, SCOPE_PLOT_X + 2, SCOPE_PLOT_Y + laneTop(ch) + 2, TRACE_COLORS[ch]);
+        lv_label_set_text(s_laneLabel[ch], MyCapture::channelName(ch));
+    }
+    s_info = createLabel(screen, SCOPE_PLOT_X, SCOPE_PLOT_Y + SCOPE_PLOT_H + 4, SCOPE_TEXT_COLOR);
+    s_note = createLabel(screen, SCOPE_PLOT_X, SCOPE_PLOT_Y + SCOPE_PLOT_H + 16, SCOPE_NOTE_COLOR);
+    showState(capture.state());
+    // 重新创建的屏幕要重新抽取最近一次捕获，填写通道和信息标签
+    s_haveTrace = false;
+    s_shownGeneration = capture.generation() - 1;
+}
+
+// 抽取最近一次完成的捕获并换算成像素，被新的捕获覆盖时返回false（下次再试）
+static bool rebuildTrace(const CaptureInfo &ci, const CaptureConfig &cfg) {
+    for (uint8_t ch = 0; ch < CAPTURE_CHANNELS; ch++) {
+        s_laneValid[ch] = false;
+        const char *unit = ch == CAPTURE_U_OUT ? "V" : "A";
+        if (!(ci.channelMask & CAPTURE_MASK(ch))) {
+            lv_label_set_text_fmt(s_laneLabel[ch], "%s --", MyCapture::channelName(ch));
+            continue;
+        }
+        if (!capture.decimate(ch, 0, ci.frames, SCOPE_COLUMNS, s_mins, s_maxs)) {
+            return false;
+        }
+        float lo = s_mins[0];
+        float hi = s_maxs[0];
+        for (uint16_t c = 1; c < SCOPE_COLUMNS; c++) {
+            lo = s_mins[c] < lo ? s_mins[c] : lo;
+            hi = s_maxs[c] > hi ? s_maxs[c] : hi;
+        }
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%s %.3f~%.3f%s", MyCapture::channelName(ch), lo, hi, unit);
+        lv_label_set_text(s_laneLabel[ch], buf);
+
+        float span = hi - lo;
+        if (span < SCOPE_MIN_SPAN) {
+            lo -= (SCOPE_MIN_SPAN - span) / 2.0f;
+            span = SCOPE_MIN_SPAN;
+        }
+        lo -= span * SCOPE_MARGIN;
+        span *= 1.0f + 2.0f * SCOPE_MARGIN;
+        for (uint16_t c = 0; c < SCOPE_COLUMNS; c++) {
+            s_top[ch][c] = toPixel(ch, s_maxs[c], lo, span);
+            s_bottom[ch][c] = toPixel(ch, s_mins[c], lo, span);
+        }
+        s_laneValid[ch] = true;
+
+        if (ch == cfg.source) {
+            // 阶跃触发的 level 是变化量，不画电平线
+            bool levelEdge = cfg.edge != CAPTURE_TRIG_NONE && cfg.edge != CAPTURE_TRIG_STEP;
+            s_levelY = (levelEdge && cfg.level >= lo && cfg.level <= lo + span)
+                       ? toPixel(ch, cfg.level, lo, span) : -1;
+        }
+    }
+    s_triggerX = (lv_coord_t)((uint64_t)ci.triggerFrame * SCOPE_COLUMNS / ci.frames);
+
+    float ms = ci.frames * 1000.0f / ci.sampleHz;
+    char buf[96];
+    snprintf(buf, sizeof(buf), "%.1fkHz  %upts  %.1fms (%.2fms/div)  %s %s %.2f%s  %s",
+             ci.sampleHz / 1000.0f, ci.frames, ms, ms / 10.0f,
+             MyCapture::channelName(cfg.source), EDGE_NAMES[cfg.edge <= CAPTURE_TRIG_STEP ? cfg.edge : 0], cfg.level,
+             cfg.source == CAPTURE_U_OUT ? "V" : "A", ci.triggered ? "trig" : "auto");
+    lv_label_set_text(s_info, buf);
+    return true;
+}
+
+// 显示的捕获有注释（MyCapture::setNote）时显示注释，否则清空
+static void showNote() {
+    char text[CAPTURE_NOTE_MAX];
+    s_noteShownSeq = capture.noteSeq();
+    bool found = s_haveTrace && capture.note(s_shownGeneration, text, sizeof(text));
+    lv_label_set_text(s_note, found ? text : "");
+}
+
+void updateCaptureScreen(lv_obj_t *screen) {
+    CaptureState state = capture.state();
+    uint32_t generation = capture.generation();
+    if (state == CAPTURE_DONE && generation != s_shownGeneration) {
+        CaptureInfo ci;
+        if (capture.info(ci) && rebuildTrace(ci, capture.config())) {
+            s_shownGeneration = generation;
+            s_haveTrace = true;
+            lv_obj_invalidate(s_plot);
+            showNote();
+        }
+    }
+    if (capture.noteSeq() != s_noteShownSeq) {
+        showNote();
+    }
+    if (state != s_shownState) {
+        showState(state);
+    }
+}
@@ -0,0 +1,22 @@
+/**
+ * @file myCaptureUI.h
+ * @brief 示波器屏幕：显示最近一次完成的波形捕获（每列最小/最大值），触发点和触发电平
+ * @author watermelon6uice
+ * @date 2025-06-13
+ */
+
+#ifndef MY_CAPTURE_UI_H
+#define MY_CAPTURE_UI_H
+
+#include "lvgl.h"
+
+// 屏幕表的创建函数：在 screen 中创建示波器屏幕的控件
+void buildCaptureScreen(lv_obj_t *screen);
+
+/**
+ * @brief 屏幕表的更新函数：有新的捕获或状态变化就刷新波形和标签
+ * @note 由 screens.update() 在UI任务中调用，只在示波器屏幕显示时调用
+ */
+void updateCaptureScreen(lv_obj_t *screen);
+
+#endif // MY_CAPTURE_UI_H
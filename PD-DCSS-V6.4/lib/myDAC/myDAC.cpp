@@ -1,29 +1,31 @@
 #include "myDAC.h"
+#include "myPerf.h"
+#include "myTaskTable.h"
 
 // FreeRTOS相关变量
 TaskHandle_t dacTaskHandle = NULL;
 QueueHandle_t dacVoltageQueue = NULL;
 static MyDAC* globalDacInstance = NULL;
+static SemaphoreHandle_t dacWriteMutex = NULL;   // DAC任务和 shutdownDAC() 之间串行化SPI写入（互斥量带优先级继承）
+static volatile bool dacShutdown = false;        // 保护关断期间DAC任务丢弃队列中的值
+static DacAppliedHandler dacAppliedHandlers[DAC_MAX_APPLIED_HANDLERS];
+static void *dacAppliedCtx[DAC_MAX_APPLIED_HANDLERS];
+static int dacAppliedCount = 0;
 
 // 构造函数
 MyDAC::MyDAC(uint8_t csPin, uint8_t mosiPin, uint8_t sckPin) : 
     _csPin(csPin),
     _mosiPin(mosiPin),
     _sckPin(sckPin),
-    _currentValue(0)
+    _currentValue(0),
+    _spi(NULL)
 {
-    // 创建新的HSPI实例
-    _spi = new SPIClass(HSPI);
 }
 
 // 初始化DAC
 void MyDAC::begin() {
-    // 配置引脚
-    pinMode(_csPin, OUTPUT);
-    digitalWrite(_csPin, HIGH);  // 默认CS为高电平（未选中）
-    
-    // 初始化SPI
-    _spi->begin(_sckPin, -1, _mosiPin, -1); // MISO pin不需要
+    // 初始化SPI（1MHz，模式0），CS默认为高电平（未选中）
+    _spi = halSpiOpen(_sckPin, _mosiPin, _csPin, 1000000);
     
     // 初始化输出为0V
     setValue(0);
@@ -51,15 +53,8 @@ void MyDAC::setValue(uint16_t value) {
     // TLC5615要求数据左移2位，参考reference.cpp的实现
     uint16_t data = value << 2;
     
-    // 发送数据
-    digitalWrite(_csPin, LOW);  // 拉低CS，开始传输
-    _spi->beginTransaction(SPISettings(1000000, MSBFIRST, SPI_MODE0));
-    
-    // 使用transfer16直接发送16位数据，而不是分两次发送
-    _spi->transfer16(data);
-    
-    _spi->endTransaction();
-    digitalWrite(_csPin, HIGH);  // 拉高CS，结束传输
+    // 一次发送16位数据，片选由HAL拉低和拉高
+    halSpiWrite16(_spi, data);
 }
 
 // 设置DAC输出电压（0-4.096V）
@@ -88,7 +83,8 @@ float MyDAC::getCurrentVoltage() {
 
 // DAC任务函数 - 从队列接收电压值并设置DAC输出
 void dacTask(void * parameter) {
-    float voltage = 0.0;
+    (void)parameter;
+    DacCommand cmd;
     
     // 检查全局DAC实例和队列
     if (globalDacInstance == NULL || dacVoltageQueue == NULL) {
@@ -101,8 +97,20 @@ void dacTask(void * parameter) {
     
     while(1) {
         // 从队列接收电压值，阻塞等待直到有新值
-        if (xQueueReceive(dacVoltageQueue, &voltage, portMAX_DELAY) == pdTRUE) {
-            globalDacInstance->setVoltage(voltage);
+        if (xQueueReceive(dacVoltageQueue, &cmd, portMAX_DELAY) == pdTRUE) {
+            int64_t t0 = esp_timer_get_time();
+            xSemaphoreTake(dacWriteMutex, portMAX_DELAY);
+            // 在互斥量内检查，保证关断后不会再写入关断前取出的值
+            bool written = !dacShutdown;
+            if (written) {
+                globalDacInstance->setVoltage(cmd.voltage);
+            }
+            xSemaphoreGive(dacWriteMutex);
+            perf.record(PERF_STAGE_DAC, t0);
+            // 只报告真正写入了SPI的值
+            for (int i = 0; written && i < dacAppliedCount; i++) {
+                dacAppliedHandlers[i](cmd.tag, dacAppliedCtx[i]);
+            }
         }
         
         // 短暂延时以允许其他任务运行
@@ -111,7 +119,7 @@ void dacTask(void * parameter) {
 }
 
 // 创建DAC任务
-void createDACTask(MyDAC* dac, uint8_t priority, uint8_t core) {
+void createDACTask(MyDAC* dac) {
     // 如果任务已经存在，先停止
     if (dacTaskHandle != NULL) {
         stopDACTask();
@@ -120,9 +128,13 @@ void createDACTask(MyDAC* dac, uint8_t priority, uint8_t core) {
     // 保存DAC实例到全局变量
     globalDacInstance = dac;
     
+    if (dacWriteMutex == NULL) {
+        dacWriteMutex = xSemaphoreCreateMutex();
+    }
+    
     // 创建电压队列
     if (dacVoltageQueue == NULL) {
-        dacVoltageQueue = xQueueCreate(10, sizeof(float));
+        dacVoltageQueue = xQueueCreate(10, sizeof(DacCommand));
         if (dacVoltageQueue == NULL) {
             Serial.println("错误: 无法创建DAC电压队列");
             return;
@@ -130,21 +142,10 @@ void createDACTask(MyDAC* dac, uint8_t priority, uint8_t core) {
     }
     
     // 创建DAC任务
-    BaseType_t result = xTaskCreatePinnedToCore(
-        dacTask,         // 任务函数
-        "DAC_Task",      // 任务名称
-        2048,            // 任务堆栈大小
-        NULL,            // 任务参数
-        priority,        // 任务优先级
-        &dacTaskHandle,  // 任务句柄
-        core             // 运行核心
-    );
-    
-    if (result != pdPASS) {
+    // 优先级、核心和栈大小由任务表中的 DAC_Task 条目决定
+    if (taskTableCreate(dacTask, "DAC_Task", NULL, &dacTaskHandle) != pdPASS) {
         Serial.println("错误: 无法创建DAC任务");
         dacTaskHandle = NULL;
-    } else {
-        Serial.printf("DAC任务已创建: 优先级=%d, 核心=%d\n", priority, core);
     }
 }
 
@@ -163,13 +164,46 @@ void stopDACTask() {
 }
 
 // 通过队列设置DAC电压
-void setDACVoltage(float voltage) {
+void setDACVoltage(float voltage, uint32_t tag) {
     if (dacVoltageQueue != NULL) {
+        DacCommand cmd = {voltage, tag};
         // 将电压值发送到队列，最大等待时间为10个时钟周期
-        if (xQueueSend(dacVoltageQueue, &voltage, 10) != pdTRUE) {
+        if (xQueueSend(dacVoltageQueue, &cmd, 10) != pdTRUE) {
             Serial.println("警告: DAC电压队列已满");
         }
     } else {
         Serial.println("错误: DAC电压队列未创建");
     }
-}
\ No newline at end of file
+}
+
+// 登记写入后的通知函数（在创建DAC任务之前调用）
+bool addDACAppliedHandler(DacAppliedHandler handler, void *ctx) {
+    if (dacAppliedCount >= DAC_MAX_APPLIED_HANDLERS) {
+        Serial.println("错误: DAC写入通知函数数量已达上限");
+        return false;
+    }
+    dacAppliedHandlers[dacAppliedCount] = handler;
+    dacAppliedCtx[dacAppliedCount] = ctx;
+    dacAppliedCount++;
+    return true;
+}
+
+// 保护触发时关断DAC - 不经过队列，直接在调用者（限流回路）中写0
+void shutdownDAC() {
+    dacShutdown = true;
+    if (dacVoltageQueue != NULL) {
+        xQueueReset(dacVoltageQueue);
+    }
+    if (globalDacInstance == NULL || dacWriteMutex == NULL) {
+        return;
+    }
+    // DAC任务正在写时最多等它写完一个16位数据
+    xSemaphoreTake(dacWriteMutex, portMAX_DELAY);
+    globalDacInstance->setValue(0);
+    xSemaphoreGive(dacWriteMutex);
+}
+
+// 解除关断
+void releaseDAC() {
+    dacShutdown = false;
+}
@@ -2,14 +2,16 @@
 #define MY_DAC_H
 
 #include <Arduino.h>
-#include <SPI.h>
+#include "myHAL.h"
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/queue.h>
+#include <freertos/semphr.h>
 
 // TLC5615 DAC参数定义
 #define DAC_MAX_VALUE 1023      // TLC5615是10位DAC，范围是0-1023
 #define DAC_MAX_VOLTAGE 4.096f  // TLC5615最大输出电压为4.096V
+#define DAC_MAX_APPLIED_HANDLERS 4   // 写入后通知函数的最大数量
 
 class MyDAC {
 private:
@@ -17,7 +19,7 @@ private:
     uint8_t _mosiPin;
     uint8_t _sckPin;
     uint16_t _currentValue;
-    SPIClass* _spi;
+    HalSpi* _spi;
     
     // 电压转换为DAC值 (0-1023)
     uint16_t voltageToDAC(float voltage);
@@ -40,13 +42,25 @@ public:
     float getCurrentVoltage();
 };
 
+// 队列中的一次写入：电压和调用者给定的标记（限流回路为系统状态输出组的版本号）
+struct DacCommand {
+    float voltage;
+    uint32_t tag;
+};
+
+// DAC任务写入SPI之后调用，tag为该次写入的标记（在DAC任务中调用，必须很快返回）
+typedef void (*DacAppliedHandler)(uint32_t tag, void *ctx);
+
 // FreeRTOS DAC任务相关
 extern TaskHandle_t dacTaskHandle;
-extern QueueHandle_t dacVoltageQueue;   // 电压值队列
+extern QueueHandle_t dacVoltageQueue;   // 电压值队列（DacCommand）
 
 // FreeRTOS任务函数和控制函数
-void createDACTask(MyDAC* dac, uint8_t priority = 1, uint8_t core = 1);
+void createDACTask(MyDAC* dac);  // 优先级和核心见任务表中的 DAC_Task 条目
 void stopDACTask();
-void setDACVoltage(float voltage);  // 通过队列设置电压
+void setDACVoltage(float voltage, uint32_t tag = 0);  // 通过队列设置电压，写入后以tag调用 addDACAppliedHandler() 登记的函数
+bool addDACAppliedHandler(DacAppliedHandler handler, void *ctx);  // 按登记顺序调用，数量达到上限时返回false
+void shutdownDAC();  // 保护触发：在调用者上下文中立即输出0V并丢弃队列中的值，直到 releaseDAC()
+void releaseDAC();   // 解除关断，DAC任务恢复处理队列
 
 #endif // MY_DAC_H
\ No newline at end of file
@@ -13,12 +13,21 @@
  * 6. 提供UI回调接口，支持外部自定义显示逻辑，实现与显示界面的无缝集成。
  * 7. 支持编码器方向反转，适配不同硬件接线方式。
  * 8. 代码结构清晰，便于扩展和维护，适合在ESP32等FreeRTOS环境下使用。
+ * 9. 同样方式调整限流设定值（I_SET）：长按步进切换按钮（超过0.8秒后松开）在U_SET和I_SET之间切换编辑对象，
+ *    已确认的I_SET作为限流值发布到共享系统状态，由限流回路（myRegulator）使用。
+ * 10. 可设置旋转拦截回调（setRotationHandler）：主屏幕以外的屏幕显示时，旋转用于切换屏幕而不调整设定值。
+ * 11. 按住步进切换按钮时的旋转先交给 setHoldRotationHandler 登记的回调（选择预设），被处理后松开按钮
+ *     发送 HOLD_ROTATE_EVENT，不再切换步进或编辑对象；applyPreset() 一次设置并确认U_SET和I_SET，
+ *     与保护阈值在系统状态的一次发布中写入。
  * 
  * 典型应用流程：用户旋转编码器调整电压设定值，可随时切换步进精度，调整后通过确认按钮锁定设定值，若长时间未确认则自动回滚。所有操作均有串口调试输出，便于开发与调试。
  * @date 2025-05-25
  */
 
 #include "myEncoder.h"
+#include "myHAL.h"
+#include "myTaskTable.h"
+#include "mySystemState.h"
 
 // 初始化静态变量
 portMUX_TYPE myEncoder::mux = portMUX_INITIALIZER_UNLOCKED;
@@ -61,10 +70,24 @@ myEncoder::myEncoder(
     use_fine_step(true),
     u_set_confirmed(true),
     confirm_timeout(confirmTimeoutMs),
+    i_set(2.00f),
+    orig_i_set(2.00f),
+    i_set_min(0.10f),
+    i_set_max(5.00f),
+    i_set_step_fine(0.01f),
+    i_set_step_coarse(0.10f),
+    i_set_confirmed(true),
+    edit_current(false),
     systemEventsPtr(nullptr),
     stepSwitchQueue(nullptr),
     stepButtonTaskHandle(nullptr),    
     _uSetDisplayCallback(nullptr),    
+    _iSetDisplayCallback(nullptr),
+    _rotationHandler(nullptr),
+    _rotationHandlerCtx(nullptr),
+    _holdRotationHandler(nullptr),
+    _holdRotationHandlerCtx(nullptr),
+    holdRotated(false),
     lastPinAState(false),      lastPinBState(false),    
     lastDebounceTime(0),
     debounceDelay(0), // 完全移除消抖延时，以最大限度提高响应速度
@@ -72,6 +95,7 @@ myEncoder::myEncoder(
     lastValidRotationTime(0), // 初始化最后有效旋转时间
     stepSequence(0), // 初始化步进序列计数器
     stepDirection(0), // 初始化步进方向
+    lastStepUs(0),
     encoderState(0)
 {
     instance = this;
@@ -83,26 +107,50 @@ myEncoder::myEncoder(
     }
 }
 
+// 配置限流设定值
+void myEncoder::configureCurrent(float initialISet, float minISet, float maxISet, float fineStep, float coarseStep) {
+    i_set = initialISet;
+    orig_i_set = initialISet;
+    i_set_min = minISet;
+    i_set_max = maxISet;
+    i_set_step_fine = fineStep;
+    i_set_step_coarse = coarseStep;
+}
+
+// 配置电压设定值和范围
+void myEncoder::configureVoltage(float initialUSet, float minUSet, float maxUSet) {
+    u_set = initialUSet;
+    orig_u_set = initialUSet;
+    last_u_set = initialUSet;
+    u_set_min = minUSet;
+    u_set_max = maxUSet;
+}
+
+// 设置步进模式 (true=细调, false=粗调)
+void myEncoder::setFineStep(bool fine) {
+    use_fine_step = fine;
+}
+
 // 初始化编码器
 void myEncoder::begin() {    
     // 清除之前可能存在的中断
     if (pinA >= 0) {
-        detachInterrupt(digitalPinToInterrupt(pinA));
+        halGpioDetachIsr(pinA);
     }
     if (pinB >= 0) {
-        detachInterrupt(digitalPinToInterrupt(pinB));
+        halGpioDetachIsr(pinB);
     }
     if (confirmPin >= 0) {
-        detachInterrupt(digitalPinToInterrupt(confirmPin));
+        halGpioDetachIsr(confirmPin);
     }
     if (stepSwitchPin >= 0) {
-        detachInterrupt(digitalPinToInterrupt(stepSwitchPin));
+        halGpioDetachIsr(stepSwitchPin);
     }    // 配置编码器引脚
-    pinMode(pinA, INPUT_PULLUP);
-    pinMode(pinB, INPUT_PULLUP);
+    halGpioMode(pinA, HAL_PIN_INPUT_PULLUP);
+    halGpioMode(pinB, HAL_PIN_INPUT_PULLUP);
       // 读取初始状态
-    lastPinAState = digitalRead(pinA);
-    lastPinBState = digitalRead(pinB);
+    lastPinAState = halGpioRead(pinA);
+    lastPinBState = halGpioRead(pinB);
       // 初始化编码器变量
     encoderCount = 0;
     lastDirection = 0;
@@ -120,8 +168,8 @@ void myEncoder::begin() {
                  lastPinBState ? "高" : "低");
     
     // 为A相和B相都设置中断，使用电平变化模式捕获所有状态变化
-    attachInterrupt(digitalPinToInterrupt(pinA), isrA, CHANGE);
-    attachInterrupt(digitalPinToInterrupt(pinB), isrB, CHANGE);
+    halGpioAttachIsr(pinA, isrA, HAL_EDGE_CHANGE);
+    halGpioAttachIsr(pinB, isrB, HAL_EDGE_CHANGE);
     Serial.print("编码器A相已设置为电平变化中断，引脚号: ");
     Serial.println(pinA);
     Serial.print("编码器B相已设置为电平变化中断，引脚号: ");
@@ -129,8 +177,8 @@ void myEncoder::begin() {
     
     // 如果设置了确认按钮，配置相应的中断
     if (confirmPin >= 0) {
-        pinMode(confirmPin, INPUT_PULLDOWN);
-        attachInterrupt(digitalPinToInterrupt(confirmPin), confirmButtonISR, RISING);
+        halGpioMode(confirmPin, HAL_PIN_INPUT_PULLDOWN);
+        halGpioAttachIsr(confirmPin, confirmButtonISR, HAL_EDGE_RISING);
         Serial.print("确认按钮已设置为中断模式, 引脚号: ");
         Serial.println(confirmPin);
     }
@@ -143,14 +191,19 @@ void myEncoder::begin() {
             stepButtonTaskHandle = nullptr;
         }
         
-        pinMode(stepSwitchPin, INPUT_PULLDOWN);
-        attachInterrupt(digitalPinToInterrupt(stepSwitchPin), stepSwitchISR, CHANGE);
+        halGpioMode(stepSwitchPin, HAL_PIN_INPUT_PULLDOWN);
+        halGpioAttachIsr(stepSwitchPin, stepSwitchISR, HAL_EDGE_CHANGE);
         Serial.print("步进切换按钮已设置为中断模式，引脚号: ");
         Serial.println(stepSwitchPin);
         
         // 创建步进按钮监控任务
         createStepButtonTask();
     }
+    
+    // 发布初始设定值（DAC目标电压由main设置，限流值在这里发布）
+    systemState.setSetpoint(u_set, u_set_confirmed, use_fine_step);
+    systemState.setCurrentSetpoint(i_set, i_set_confirmed, edit_current);
+    systemState.setCurrentLimit(i_set);
 }
 
 // 读取并重置编码器计数 - 与STM32参考实现类似
@@ -204,7 +257,7 @@ void IRAM_ATTR myEncoder::stepSwitchISR() {
     if (instance && instance->stepSwitchQueue) {
         // 根据按钮状态发送不同消息
         uint32_t msg;
-        if (digitalRead(instance->stepSwitchPin) == HIGH) {
+        if (halGpioRead(instance->stepSwitchPin) == HIGH) {
             // 按钮按下
             msg = instance->MSG_STEP_BUTTON_PRESSED;
         } else {
@@ -240,8 +293,8 @@ void myEncoder::handleIsrB() {
 // 统一的编码器中断处理函数 - 改进版本，每旋转一格只触发一次更新
 void myEncoder::handleEncoderInterrupt() {
     // 读取当前A相和B相的状态
-    bool currentPinAState = digitalRead(pinA);
-    bool currentPinBState = digitalRead(pinB);
+    bool currentPinAState = halGpioRead(pinA);
+    bool currentPinBState = halGpioRead(pinB);
     
     // 进入临界区保护共享变量
     portENTER_CRITICAL(&mux);
@@ -298,6 +351,7 @@ void myEncoder::handleEncoderInterrupt() {
                     
                     lastDirection = delta;
                     lastValidRotationTime = currentTime;
+                    lastStepUs = micros();
                     
 #ifdef DEBUG_ENCODER
                     Serial.printf("[编码器] 检测到完整旋转一格, 方向: %s\n", 
@@ -329,17 +383,8 @@ void myEncoder::handleEncoderInterrupt() {
 
 // 创建步进按钮任务
 void myEncoder::createStepButtonTask() {
-    // 创建步进按钮监控任务
-    xTaskCreate(
-        stepButtonTask,       // 任务函数
-        "StepButtonTask",     // 任务名称
-        2048,                 // 堆栈大小
-        this,                 // 任务参数
-        1,                    // 高优先级(1是最高优先级)
-        &stepButtonTaskHandle // 任务句柄
-    );
-    
-    Serial.println("步进按钮监控任务已启动，优先级已优化");
+    // 创建步进按钮监控任务，优先级和核心由任务表中的 StepButtonTask 条目决定
+    taskTableCreate(stepButtonTask, "StepButtonTask", this, &stepButtonTaskHandle);
 }
 
 // 步进按钮监控任务
@@ -347,9 +392,6 @@ void myEncoder::stepButtonTask(void* parameter) {
     myEncoder* encoder = static_cast<myEncoder*>(parameter);
     uint32_t msg;
     
-    // 设置任务优先级较高，确保按钮响应及时
-    vTaskPrioritySet(NULL, 1); // 在ESP-IDF FreeRTOS中，数字越小优先级越高
-    
     while (1) {
         // 等待队列消息，无限等待
         if (xQueueReceive(encoder->stepSwitchQueue, &msg, portMAX_DELAY)) {
@@ -362,14 +404,15 @@ void myEncoder::stepButtonTask(void* parameter) {
                     lastStepDebounceTime = currentMillis;
                     
                     // 确认按钮按下，增强防抖检测
-                    if (digitalRead(encoder->stepSwitchPin) == HIGH) {
+                    if (halGpioRead(encoder->stepSwitchPin) == HIGH) {
                         // 短暂等待再次检查，增强防抖可靠性
-                        ets_delay_us(1000); // 微秒级延迟，不影响任务调度
+                        halDelayUs(1000); // 微秒级延迟，不影响任务调度
                         
                         // 再次确认按钮状态
-                        if (digitalRead(encoder->stepSwitchPin) == HIGH) {
+                        if (halGpioRead(encoder->stepSwitchPin) == HIGH) {
                             stepButtonPressed = true;
                             stepButtonReleaseHandled = false;
+                            encoder->holdRotated = false;
                             Serial.println("步进按钮已按下");
                         }
                     }
@@ -379,26 +422,33 @@ void myEncoder::stepButtonTask(void* parameter) {
             // 按钮释放消息
             else if (msg == encoder->MSG_STEP_BUTTON_RELEASED && stepButtonPressed && !stepButtonReleaseHandled) {
                 if (currentMillis - lastStepDebounceTime > STEP_DEBOUNCE_DELAY) {
+                    // 按下时记录了 lastStepDebounceTime，据此区分短按和长按
+                    bool longPress = currentMillis - lastStepDebounceTime >= STEP_LONG_PRESS;
                     lastStepDebounceTime = currentMillis;
                     
                     // 确认按钮释放，增强防抖检测
-                    if (digitalRead(encoder->stepSwitchPin) == LOW) {
+                    if (halGpioRead(encoder->stepSwitchPin) == LOW) {
                         // 短暂等待再次检查，增强防抖可靠性
-                        ets_delay_us(1000); // 微秒级延迟，不影响任务调度
+                        halDelayUs(1000); // 微秒级延迟，不影响任务调度
                         
                         // 再次确认按钮状态
-                        if (digitalRead(encoder->stepSwitchPin) == LOW) {
+                        if (halGpioRead(encoder->stepSwitchPin) == LOW) {
                             stepButtonPressed = false;
                             stepButtonReleaseHandled = true;
                             
-                            Serial.println("步进按钮已释放，触发步进值切换");
+                            // 按住期间旋转过（例如选择预设）时不切换步进值或编辑对象
+                            uint32_t event = encoder->holdRotated ? encoder->HOLD_ROTATE_EVENT
+                                           : longPress ? encoder->EDIT_TARGET_EVENT : encoder->STEP_SWITCH_EVENT;
+                            Serial.println(encoder->holdRotated ? "步进按钮按住旋转后释放"
+                                           : longPress ? "步进按钮长按后释放，触发编辑对象切换"
+                                                       : "步进按钮已释放，触发步进值切换");
                             
                             // 延迟50ms确保系统稳定，然后再发送事件
                             vTaskDelay(pdMS_TO_TICKS(50));
                             
                             if (encoder->systemEventsPtr) {
                                 Serial.println("发送步进切换事件到UI任务...");
-                                xEventGroupSetBits(*(encoder->systemEventsPtr), encoder->STEP_SWITCH_EVENT);
+                                xEventGroupSetBits(*(encoder->systemEventsPtr), event);
                             }
                         }
                     }
@@ -421,6 +471,29 @@ EventGroupHandle_t* myEncoder::getSystemEventsPtr() {
     return systemEventsPtr;
 }
 
+// 发布设定值到共享系统状态，已确认的设定值同时作为DAC目标电压和限流值（调用时须持有dataMutex）
+void myEncoder::publishSetpoint() {
+    systemState.setSetpoint(u_set, u_set_confirmed, use_fine_step);
+    systemState.setCurrentSetpoint(i_set, i_set_confirmed, edit_current);
+    if (u_set_confirmed) {
+        systemState.setDacVoltage(u_set);
+    }
+    if (i_set_confirmed) {
+        systemState.setCurrentLimit(i_set);
+    }
+}
+
+// 调用U_SET或I_SET的显示回调（调用时须持有dataMutex）
+void myEncoder::notifyDisplay(bool current) {
+    if (current) {
+        if (_iSetDisplayCallback) {
+            _iSetDisplayCallback(i_set, i_set_confirmed, use_fine_step, this);
+        }
+    } else if (_uSetDisplayCallback) {
+        _uSetDisplayCallback(u_set, u_set_confirmed, use_fine_step, this);
+    }
+}
+
 // 获取当前电压设置值
 float myEncoder::getUSet() {
     float value;
@@ -441,7 +514,54 @@ bool myEncoder::isUSetConfirmed() {
     return confirmed;
 }
 
-// 确认当前电压设置
+// 获取当前限流设置值
+float myEncoder::getISet() {
+    float value = 0.0f;
+    if (xSemaphoreTake(dataMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        value = i_set;
+        xSemaphoreGive(dataMutex);
+    }
+    return value;
+}
+
+// 检查限流设置是否已确认
+bool myEncoder::isISetConfirmed() {
+    bool confirmed = true;
+    if (xSemaphoreTake(dataMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        confirmed = i_set_confirmed;
+        xSemaphoreGive(dataMutex);
+    }
+    return confirmed;
+}
+
+// 编码器当前是否在调整I_SET
+bool myEncoder::isEditingCurrent() {
+    return edit_current;
+}
+
+// 切换编辑对象，返回当前状态 (true=I_SET, false=U_SET)
+bool myEncoder::toggleEditTarget() {
+    bool current = edit_current;
+    if (xSemaphoreTake(dataMutex, pdMS_TO_TICKS(500)) == pdTRUE) {
+        edit_current = !edit_current;
+        current = edit_current;
+        
+        Serial.print("切换编辑对象: ");
+        Serial.println(edit_current ? "I_SET" : "U_SET");
+        
+        // 发布到共享系统状态
+        publishSetpoint();
+        
+        // 两个设定值的显示都要刷新（当前编辑对象的颜色不同）
+        notifyDisplay(false);
+        notifyDisplay(true);
+        
+        xSemaphoreGive(dataMutex);
+    }
+    return current;
+}
+
+// 确认当前电压设置和限流设置
 void myEncoder::confirmUSet() {
     if (xSemaphoreTake(dataMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
         // 如果电压设置未确认，进行确认
@@ -451,10 +571,21 @@ void myEncoder::confirmUSet() {
             Serial.print("电压设置已确认: ");
             Serial.println(u_set);
             
+            // 发布到共享系统状态
+            publishSetpoint();
+            
             // 调用UI回调函数
-            if (_uSetDisplayCallback) {
-                _uSetDisplayCallback(u_set, true, use_fine_step, this);
-            }
+            notifyDisplay(false);
+        }
+        // 限流设置同样处理
+        if (!i_set_confirmed) {
+            i_set_confirmed = true;
+            
+            Serial.print("限流设置已确认: ");
+            Serial.println(i_set);
+            
+            publishSetpoint();
+            notifyDisplay(true);
         }
         xSemaphoreGive(dataMutex);
     }
@@ -469,6 +600,9 @@ void myEncoder::resetUSet() {
         
         Serial.println("电压设置已重置");
         
+        // 发布到共享系统状态
+        publishSetpoint();
+        
         // 调用UI回调函数
         if (_uSetDisplayCallback) {
             _uSetDisplayCallback(u_set, true, use_fine_step, this);
@@ -495,13 +629,18 @@ bool myEncoder::toggleStepSize() {
         Serial.print("切换步进模式: ");
         Serial.print(use_fine_step ? "细调" : "粗调");
         Serial.print("，当前步进值: ");
-        Serial.println(use_fine_step ? u_set_step_fine : u_set_step_coarse);
-        
-        // 调用UI回调函数
-        if (_uSetDisplayCallback) {
-            _uSetDisplayCallback(u_set, u_set_confirmed, use_fine_step, this);
+        if (edit_current) {
+            Serial.println(use_fine_step ? i_set_step_fine : i_set_step_coarse);
+        } else {
+            Serial.println(use_fine_step ? u_set_step_fine : u_set_step_coarse);
         }
         
+        // 发布到共享系统状态
+        publishSetpoint();
+        
+        // 调用当前编辑对象的UI回调函数
+        notifyDisplay(edit_current);
+        
         xSemaphoreGive(dataMutex);
     }
     
@@ -512,7 +651,11 @@ bool myEncoder::toggleStepSize() {
 float myEncoder::getCurrentStepSize() {
     float step;
     if (xSemaphoreTake(dataMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        step = use_fine_step ? u_set_step_fine : u_set_step_coarse;
+        if (edit_current) {
+            step = use_fine_step ? i_set_step_fine : i_set_step_coarse;
+        } else {
+            step = use_fine_step ? u_set_step_fine : u_set_step_coarse;
+        }
         xSemaphoreGive(dataMutex);
     }
     return step;
@@ -520,18 +663,23 @@ float myEncoder::getCurrentStepSize() {
 
 // 检查确认超时
 void myEncoder::checkConfirmTimeout() {
-    // 如果电压设置没有确认，且超过确认超时时间，则回滚到原始值
-    if (u_set_confirmed == false && (millis() - last_adjustment_time > confirm_timeout)) {
+    // 如果电压或限流设置没有确认，且超过确认超时时间，则回滚到原始值
+    if ((u_set_confirmed == false || i_set_confirmed == false) && (millis() - last_adjustment_time > confirm_timeout)) {
         if (xSemaphoreTake(dataMutex, portMAX_DELAY) == pdTRUE) {
             // 回滚设置
-            u_set = orig_u_set;
-            u_set_confirmed = true;
-            
-            Serial.println("电压设置超时回滚");
-            
-            // 调用UI回调函数
-            if (_uSetDisplayCallback) {
-                _uSetDisplayCallback(u_set, true, use_fine_step, this);
+            if (!u_set_confirmed) {
+                u_set = orig_u_set;
+                u_set_confirmed = true;
+                Serial.println("电压设置超时回滚");
+                publishSetpoint();
+                notifyDisplay(false);
+            }
+            if (!i_set_confirmed) {
+                i_set = orig_i_set;
+                i_set_confirmed = true;
+                Serial.println("限流设置超时回滚");
+                publishSetpoint();
+                notifyDisplay(true);
             }
             
             xSemaphoreGive(dataMutex);
@@ -544,6 +692,32 @@ void myEncoder::checkConfirmTimeout() {
     }
 }
 
+// 调用预设：设定值直接成为已确认的值，与保护阈值一起一次发布，DAC不会先用新设定值配旧阈值
+uint32_t myEncoder::applyPreset(float uSet, float iSet, const ProtectionLimits &limits) {
+    uint32_t version = 0;
+    if (xSemaphoreTake(dataMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        u_set = uSet;
+        orig_u_set = uSet;
+        u_set_confirmed = true;
+        i_set = iSet;
+        orig_i_set = iSet;
+        i_set_confirmed = true;
+        
+        version = systemState.recallSetpoint(u_set, i_set, limits);
+        
+        // 两个设定值的显示都要刷新
+        notifyDisplay(false);
+        notifyDisplay(true);
+        
+        xSemaphoreGive(dataMutex);
+        
+        if (systemEventsPtr) {
+            xEventGroupSetBits(*systemEventsPtr, (1 << 0)); // UI_UPDATE_EVENT
+        }
+    }
+    return version;
+}
+
 // 从编码器读取并更新U_SET值 - 改进为事件驱动模式
 void myEncoder::updateUSetFromEncoder() {
     // 不再通过定时轮询检查，而是通过事件触发
@@ -578,56 +752,79 @@ void myEncoder::updateUSetFromEncoder() {
             encoderValue = (encoderValue > 0) ? 1 : -1;
         }
         
+        // 按住步进按钮时的旋转（例如选择预设）被处理后不调整设定值
+        if (stepButtonPressed && _holdRotationHandler != nullptr &&
+            _holdRotationHandler(encoderValue, _holdRotationHandlerCtx)) {
+            holdRotated = true;
+            return;
+        }
+        
+        // 旋转被拦截（例如用于切换屏幕）时不调整设定值
+        if (_rotationHandler != nullptr && _rotationHandler(encoderValue, _rotationHandlerCtx)) {
+            return;
+        }
+        
         Serial.println("\n[编码器更新] ====开始====");
         Serial.printf("[编码器计数] 读取到计数值: %d, 方向: %s\n", 
                      encoderValue, 
                      encoderValue > 0 ? "顺时针" : "逆时针");
-        Serial.printf("[编码器更新] 当前状态: 步进=%s, 已确认=%s\n",
+        Serial.printf("[编码器更新] 当前状态: 对象=%s, 步进=%s, 已确认=%s\n",
+                     edit_current ? "I_SET" : "U_SET",
                      use_fine_step ? "细调" : "粗调",
-                     u_set_confirmed ? "是" : "否");
+                     (edit_current ? i_set_confirmed : u_set_confirmed) ? "是" : "否");
         
         // 获取互斥量
         if (xSemaphoreTake(dataMutex, pdMS_TO_TICKS(50)) == pdTRUE) { // 增加超时时间提高成功率
-            float oldValue = u_set;
+            // 按编辑对象选择要调整的设定值及其范围和步进值
+            bool current = edit_current;
+            float &value = current ? i_set : u_set;
+            float &origValue = current ? orig_i_set : orig_u_set;
+            bool &confirmed = current ? i_set_confirmed : u_set_confirmed;
+            float minValue = current ? i_set_min : u_set_min;
+            float maxValue = current ? i_set_max : u_set_max;
+            float fineStep = current ? i_set_step_fine : u_set_step_fine;
+            float coarseStep = current ? i_set_step_coarse : u_set_step_coarse;
+            float oldValue = value;
             
             // 如果是确认状态的第一次调整，保存原始值并切换到未确认状态
-            if (u_set_confirmed) {
-                orig_u_set = u_set;
-                u_set_confirmed = false;
-                Serial.printf("[编码器更新] 首次调整，保存原始值: %.2f\n", orig_u_set);
+            if (confirmed) {
+                origValue = value;
+                confirmed = false;
+                Serial.printf("[编码器更新] 首次调整，保存原始值: %.2f\n", origValue);
             }
             
             // 根据当前步进模式选择步进值并计算新值
-            float step = use_fine_step ? u_set_step_fine : u_set_step_coarse;
-            float newValue = u_set + (encoderValue * step);
+            float step = use_fine_step ? fineStep : coarseStep;
+            float newValue = value + (encoderValue * step);
             
             Serial.printf("[编码器更新] 计算: %.2f %c %.2f = %.2f\n", 
-                         u_set, 
+                         value, 
                          (encoderValue * step) >= 0 ? '+' : '-',
                          fabs(encoderValue * step), 
                          newValue);
             
             // 限制范围
-            if (newValue > u_set_max) {
-                newValue = u_set_max;
+            if (newValue > maxValue) {
+                newValue = maxValue;
                 Serial.println("[编码器更新] 已达到最大值限制");
             }
-            if (newValue < u_set_min) {
-                newValue = u_set_min;
+            if (newValue < minValue) {
+                newValue = minValue;
                 Serial.println("[编码器更新] 已达到最小值限制");
             }
             
             // 更新值
-            u_set = newValue;
+            value = newValue;
             last_adjustment_time = millis();
             
             Serial.printf("[编码器更新] 值已更新: %.2f -> %.2f\n", oldValue, newValue);
             
+            // 发布到共享系统状态
+            publishSetpoint();
+            
             // 调用UI回调
-            if (_uSetDisplayCallback) {
-                _uSetDisplayCallback(u_set, u_set_confirmed, use_fine_step, this);
-                Serial.println("[编码器更新] UI回调已执行");
-            }
+            notifyDisplay(current);
+            Serial.println("[编码器更新] UI回调已执行");
             
             // 设置UI更新事件
             if (systemEventsPtr) {
@@ -650,8 +847,8 @@ void myEncoder::reverseDirection() {
     portENTER_CRITICAL(&mux);
     
     // 临时禁用中断
-    detachInterrupt(digitalPinToInterrupt(pinA));
-    detachInterrupt(digitalPinToInterrupt(pinB));
+    halGpioDetachIsr(pinA);
+    halGpioDetachIsr(pinB);
     
     // 交换A、B引脚
     int tempPin = pinA;
@@ -659,8 +856,8 @@ void myEncoder::reverseDirection() {
     pinB = tempPin;
     
     // 重新计算编码器初始状态
-    lastPinAState = digitalRead(pinA);
-    lastPinBState = digitalRead(pinB);
+    lastPinAState = halGpioRead(pinA);
+    lastPinBState = halGpioRead(pinB);
     lastEncoderState = (lastPinAState << 1) | lastPinBState;
     encoderState = lastEncoderState;
       // 清空旧的计数和方向
@@ -670,8 +867,8 @@ void myEncoder::reverseDirection() {
     stepDirection = 0;
     
     // 重新附加中断（不再需要交换A/B处理函数，而是交换了物理引脚）
-    attachInterrupt(digitalPinToInterrupt(pinA), isrA, CHANGE);
-    attachInterrupt(digitalPinToInterrupt(pinB), isrB, CHANGE);
+    halGpioAttachIsr(pinA, isrA, HAL_EDGE_CHANGE);
+    halGpioAttachIsr(pinB, isrB, HAL_EDGE_CHANGE);
     
     portEXIT_CRITICAL(&mux);
     
@@ -682,3 +879,20 @@ void myEncoder::reverseDirection() {
 void myEncoder::setUSetDisplayCallback(USetDisplayCallback callback) {
     _uSetDisplayCallback = callback;
 }
+
+// 设置I_SET显示回调函数
+void myEncoder::setISetDisplayCallback(USetDisplayCallback callback) {
+    _iSetDisplayCallback = callback;
+}
+
+// 设置旋转拦截回调
+void myEncoder::setRotationHandler(RotationHandler handler, void* ctx) {
+    _rotationHandlerCtx = ctx;
+    _rotationHandler = handler;
+}
+
+// 设置按住步进按钮时的旋转回调
+void myEncoder::setHoldRotationHandler(RotationHandler handler, void* ctx) {
+    _holdRotationHandlerCtx = ctx;
+    _holdRotationHandler = handler;
+}
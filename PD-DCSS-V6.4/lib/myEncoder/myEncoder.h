@@ -7,6 +7,7 @@
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "freertos/event_groups.h"
+#include "myProtection.h"
 
 // 取消注释以启用编码器详细调试
 // #define DEBUG_ENCODER
@@ -42,15 +43,27 @@ private:    // 旋转编码器引脚定义
     bool u_set_confirmed; // 电压设置是否已确认
     unsigned long last_adjustment_time; // 最后一次调整时间
     unsigned long confirm_timeout; // 确认超时时间（毫秒）
+    
+    // I_SET相关变量（限流设定值），确认和超时回滚规则与U_SET相同
+    float i_set; // 限流设置值
+    float orig_i_set; // 原始限流设置值，用于在超时时恢复
+    float i_set_min; // 最小允许值
+    float i_set_max; // 最大允许值
+    float i_set_step_fine; // 细调步进值
+    float i_set_step_coarse; // 粗调步进值
+    bool i_set_confirmed; // 限流设置是否已确认
+    bool edit_current; // true时编码器调整I_SET，false时调整U_SET
       // 步进按钮相关
     static bool stepButtonPressed;
     static bool stepButtonReleaseHandled;
     static unsigned long lastStepDebounceTime;
-    static const unsigned long STEP_DEBOUNCE_DELAY = 30;    // 编码器状态追踪
+    static const unsigned long STEP_DEBOUNCE_DELAY = 30;
+    static const unsigned long STEP_LONG_PRESS = 800; // 步进按钮按住超过此时间(ms)松开时切换编辑对象    // 编码器状态追踪
     volatile int8_t lastValidDirection; // 记录上一次有效的旋转方向
     volatile unsigned long lastValidRotationTime; // 记录上一次有效旋转的时间
     volatile uint8_t stepSequence; // 用于追踪一个完整步进的状态序列
     volatile int8_t stepDirection; // 当前步进方向
+    volatile uint32_t lastStepUs; // 最近一次完整旋转一格的时间（中断中记录，用于统计处理延迟）
 
     // 互斥锁，用于保护中断和读取之间的共享资源
     static portMUX_TYPE mux;
@@ -60,6 +73,8 @@ private:    // 旋转编码器引脚定义
     static const uint32_t CONFIRM_EVENT = (1 << 2);
     static const uint32_t STEP_SWITCH_EVENT = (1 << 3);
     static const uint32_t ENCODER_UPDATE_EVENT = (1 << 4);  // 新增：编码器更新事件
+    static const uint32_t EDIT_TARGET_EVENT = (1 << 5);  // 切换编辑对象（U_SET/I_SET）事件
+    static const uint32_t HOLD_ROTATE_EVENT = (1 << 8);  // 按住步进按钮时旋转过（旋转已被处理），松开时代替上面两个事件
     
     // 中断服务程序
     static myEncoder* instance; // 静态实例指针(用于中断回调)
@@ -74,6 +89,7 @@ private:    // 旋转编码器引脚定义
     static const uint32_t MSG_STEP_BUTTON_RELEASED = 2;
     
     void createStepButtonTask(); // 创建步进按钮任务
+    void publishSetpoint(); // 发布设定值到共享系统状态
     
 public:
     // 基本构造函数 (保持与原版兼容)
@@ -92,6 +108,17 @@ public:
         unsigned long confirmTimeoutMs = 5000
     );
     
+    /**
+     * @brief 配置限流设定值（在begin()之前调用，未调用时使用构造函数中的默认值）
+     */
+    void configureCurrent(float initialISet, float minISet, float maxISet, float fineStep, float coarseStep);
+    
+    /**
+     * @brief 配置电压设定值和范围、步进模式（在begin()之前调用，用于恢复保存的设置；步进值不变）
+     */
+    void configureVoltage(float initialUSet, float minUSet, float maxUSet);
+    void setFineStep(bool fine);
+    
     void begin(); // 初始化编码器
     int16_t read(); // 获取并重置编码器计数值
       // U_SET 相关功能
@@ -99,17 +126,35 @@ public:
     EventGroupHandle_t* getSystemEventsPtr(); // 获取系统事件组指针
     float getUSet(); // 获取当前电压设置值
     bool isUSetConfirmed(); // 检查电压设置是否已确认
-    void confirmUSet(); // 确认当前电压设置
+    float getISet(); // 获取当前限流设置值
+    bool isISetConfirmed(); // 检查限流设置是否已确认
+    bool isEditingCurrent(); // 编码器当前是否在调整I_SET
+    bool toggleEditTarget(); // 切换编辑对象，返回当前状态 (true=I_SET, false=U_SET)
+    void confirmUSet(); // 确认当前电压设置和限流设置
     void resetUSet(); // 重置电压设置为原始值
     bool toggleStepSize(); // 切换步进大小，返回当前状态 (true=细调, false=粗调)
     float getCurrentStepSize(); // 获取当前步进值
-    void checkConfirmTimeout(); // 检查确认超时
-    void updateUSetFromEncoder(); // 从编码器读取并更新U_SET值
+    void checkConfirmTimeout(); // 检查确认超时（U_SET和I_SET）
+    void updateUSetFromEncoder(); // 从编码器读取并更新当前编辑对象（U_SET或I_SET）
     void reverseDirection(); // 反转编码器方向
     
+    /**
+     * @brief 一次设置并确认U_SET和I_SET，与保护阈值一起在系统状态的一次发布中写入（调用预设）
+     * @return 发布后系统状态输出组的版本号，无法获取互斥量时返回0
+     */
+    uint32_t applyPreset(float uSet, float iSet, const ProtectionLimits &limits);
+    uint32_t getLastStepUs() const { return lastStepUs; } // 最近一次旋转一格的中断时间(micros)
+    
     // UI回调函数
     typedef void (*USetDisplayCallback)(float value, bool confirmed, bool isFineStep, void* encoderPtr);
     void setUSetDisplayCallback(USetDisplayCallback callback);
+    void setISetDisplayCallback(USetDisplayCallback callback); // I_SET显示回调，参数含义与U_SET相同
+    
+    // 旋转拦截回调：在编码器任务中调用，返回true时这次旋转不调整设定值（delta为正表示顺时针）
+    typedef bool (*RotationHandler)(int16_t delta, void* ctx);
+    void setRotationHandler(RotationHandler handler, void* ctx);
+    // 按住步进按钮时的旋转先交给它（例如选择预设），返回true时松开按钮发送 HOLD_ROTATE_EVENT
+    void setHoldRotationHandler(RotationHandler handler, void* ctx);
       // 内部使用的中断处理程序
     void handleIsrA(); // 处理A相中断
     void handleIsrB(); // 处理B相中断
@@ -120,6 +165,14 @@ public:
 private:
     // UI回调
     USetDisplayCallback _uSetDisplayCallback;
+    USetDisplayCallback _iSetDisplayCallback;
+    RotationHandler _rotationHandler;
+    void* _rotationHandlerCtx;
+    RotationHandler _holdRotationHandler;
+    void* _holdRotationHandlerCtx;
+    volatile bool holdRotated; // 本次按住步进按钮期间有旋转被 _holdRotationHandler 处理
+    
+    void notifyDisplay(bool current); // 调用U_SET或I_SET的显示回调（调用时须持有dataMutex）
     volatile int8_t lastDirection;  // 用于跟踪最后的旋转方向
 };
 
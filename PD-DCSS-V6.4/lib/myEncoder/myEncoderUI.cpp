@@ -1,11 +1,11 @@
 #include "myEncoder.h"
 #include "myTFT.h"
+#include "myTaskTable.h"
 #include "../generated/gui_guider.h" // 添加GUI引用，包含guider_ui结构体定义
 #include "../generated/events_init.h" // 添加事件初始化引用
 extern lv_ui guider_ui; // 引用外部声明的guider_ui变量
 
-// 声明全局DAC输出电压变量（定义在main.cpp中）
-extern float g_dacOutputVoltage;
+static lv_obj_t* s_iSetLabel = NULL; // I_SET标签，由initISetDisplay创建
 
 // U_SET显示回调函数 - 处理电压设置值显示、颜色变化和DAC输出设置
 void updateUSetDisplay(float value, bool confirmed, bool isFineStep, void* encoderPtr) {
@@ -16,14 +16,11 @@ void updateUSetDisplay(float value, bool confirmed, bool isFineStep, void* encod
     sprintf(u_set_buf, "%.2f", value);
     lv_label_set_text(guider_ui.screen_U_SET, u_set_buf);
     
-    // 当电压值被确认时，更新全局DAC输出电压变量
+    // 已确认的设定值由编码器发布到共享系统状态，DAC更新任务从那里读取
     if (confirmed) {
-        // 更新全局DAC输出电压变量
-        g_dacOutputVoltage = value;
-        
         // 可以添加调试输出
         Serial.print("DAC电压已更新为: ");
-        Serial.print(g_dacOutputVoltage);
+        Serial.print(value);
         Serial.println("V");
     }
     
@@ -50,8 +47,8 @@ void updateUSetDisplay(float value, bool confirmed, bool isFineStep, void* encod
             lv_obj_set_style_text_color(guider_ui.screen_V_label_set, lv_color_hex(0xff8000), LV_PART_MAIN|LV_STATE_DEFAULT);
         }
         
-        // 创建一次性延时任务来恢复颜色（2秒后）
-        xTaskCreate(
+        // 创建一次性延时任务来恢复颜色（2秒后），优先级和核心见任务表中的 RestoreColor 条目
+        taskTableCreate(
             [](void* taskParam) {
                 // 等待2秒
                 vTaskDelay(pdMS_TO_TICKS(2000));
@@ -74,9 +71,7 @@ void updateUSetDisplay(float value, bool confirmed, bool isFineStep, void* encod
                 vTaskDelete(NULL); // 删除任务
             },
             "RestoreColor",   // 任务名称
-            2048,             // 堆栈大小
             encoderPtr,       // 任务参数 - 传递encoder对象
-            2,                // 任务优先级
             NULL              // 任务句柄
         );
     }
@@ -87,3 +82,43 @@ void updateUSetDisplay(float value, bool confirmed, bool isFineStep, void* encod
         xEventGroupSetBits(*systemEventsPtr, (1 << 0)); // UI_UPDATE_EVENT
     }
 }
+
+// 创建I_SET标签 - 字体和颜色与U_SET一致，放在左下角（与待机提示标签同一行，输出打开时待机标签隐藏）
+void initISetDisplay(lv_obj_t* parent, float value) {
+    s_iSetLabel = lv_label_create(parent);
+    lv_obj_set_pos(s_iSetLabel, 14, 208);
+    lv_obj_set_size(s_iSetLabel, 120, 15);
+    lv_obj_set_style_text_font(s_iSetLabel, &lv_font_Alatsi_Regular_12, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(s_iSetLabel, lv_color_hex(0xe0e0e0), LV_PART_MAIN|LV_STATE_DEFAULT);
+    
+    char i_set_buf[24];
+    sprintf(i_set_buf, "I-SET %.2fA", value);
+    lv_label_set_text(s_iSetLabel, i_set_buf);
+}
+
+// I_SET显示回调函数 - 处理限流设定值显示和颜色变化
+void updateISetDisplay(float value, bool confirmed, bool isFineStep, void* encoderPtr) {
+    (void)isFineStep; // 步进模式由U_SET旁边的V标签提示
+    if (s_iSetLabel == NULL) {
+        return;
+    }
+    
+    char i_set_buf[24];
+    sprintf(i_set_buf, "I-SET %.2fA", value);
+    lv_label_set_text(s_iSetLabel, i_set_buf);
+    
+    // 根据状态设置颜色：未确认 - 黄色，正在编辑 - 蓝色，其他 - 白色
+    uint32_t color = 0xe0e0e0;
+    if (!confirmed) {
+        color = 0xffff00;
+    } else if (((myEncoder*)encoderPtr)->isEditingCurrent()) {
+        color = 0x00ffff;
+    }
+    lv_obj_set_style_text_color(s_iSetLabel, lv_color_hex(color), LV_PART_MAIN|LV_STATE_DEFAULT);
+    
+    // 设置UI更新事件，请求刷新
+    EventGroupHandle_t* systemEventsPtr = ((myEncoder*)encoderPtr)->getSystemEventsPtr();
+    if (systemEventsPtr) {
+        xEventGroupSetBits(*systemEventsPtr, (1 << 0)); // UI_UPDATE_EVENT
+    }
+}
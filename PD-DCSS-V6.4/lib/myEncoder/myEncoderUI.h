@@ -1,7 +1,15 @@
 #ifndef MY_ENCODER_UI_H
 #define MY_ENCODER_UI_H
 
+#include "lvgl.h"
+
 // U_SET显示回调函数 - 处理电压设置值显示和颜色变化
 void updateUSetDisplay(float value, bool confirmed, bool isFineStep, void* encoderPtr);
 
+// 创建I_SET（限流设定值）标签，位于屏幕左下角
+void initISetDisplay(lv_obj_t* parent, float value);
+
+// I_SET显示回调函数 - 未确认为黄色，正在编辑为蓝色，否则为白色
+void updateISetDisplay(float value, bool confirmed, bool isFineStep, void* encoderPtr);
+
 #endif // MY_ENCODER_UI_H
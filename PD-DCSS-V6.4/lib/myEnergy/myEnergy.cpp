@@ -0,0 +1,113 @@
+/**
+ * @file myEnergy.cpp
+ * @brief 能量、电荷和运行时间累计：按采集帧积分输入输出的Wh、Ah
+ * @author watermelon6uice
+ * @date 2025-06-13
+ */
+
+#include "myEnergy.h"
+#include "myHAL.h"
+
+MyEnergy energy;
+
+// 四舍五入为整数（毫瓦、毫安），负值（零点附近的噪声）按0处理
+static int32_t toMilli(float value) {
+    return value > 0.0f ? (int32_t)lroundf(value * 1000.0f) : 0;
+}
+
+MyEnergy::MyEnergy() :
+    _outEnergy(0),
+    _inEnergy(0),
+    _outCharge(0),
+    _inCharge(0),
+    _runtimeUs(0),
+    _frames(0),
+    _sessionStartUs(0),
+    _havePrev(false),
+    _prevUs(0),
+    _prevOutMw(0),
+    _prevInMw(0),
+    _prevOutMa(0),
+    _prevInMa(0)
+{
+    portMUX_TYPE unlocked = portMUX_INITIALIZER_UNLOCKED;
+    _mux = unlocked;
+}
+
+void MyEnergy::accumulate(const AdcFrame &frame) {
+    int32_t outMw = toMilli(frame.uOut * frame.iOut);
+    int32_t inMw = toMilli(frame.uIn * frame.iIn);
+    int32_t outMa = toMilli(frame.iOut);
+    int32_t inMa = toMilli(frame.iIn);
+
+    portENTER_CRITICAL(&_mux);
+    int64_t dt = frame.timeUs - _prevUs;
+    if (_havePrev && dt > 0 && dt <= ENERGY_MAX_GAP_US) {
+        _outEnergy += (int64_t)(_prevOutMw + outMw) * dt;
+        _inEnergy += (int64_t)(_prevInMw + inMw) * dt;
+        _outCharge += (int64_t)(_prevOutMa + outMa) * dt;
+        _inCharge += (int64_t)(_prevInMa + inMa) * dt;
+        _runtimeUs += dt;
+        _frames++;
+    }
+    _havePrev = true;
+    _prevUs = frame.timeUs;
+    _prevOutMw = outMw;
+    _prevInMw = inMw;
+    _prevOutMa = outMa;
+    _prevInMa = inMa;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyEnergy::onFrame(const AdcFrame &frame, void *ctx) {
+    static_cast<MyEnergy *>(ctx)->accumulate(frame);
+}
+
+void MyEnergy::reset() {
+    portENTER_CRITICAL(&_mux);
+    _outEnergy = 0;
+    _inEnergy = 0;
+    _outCharge = 0;
+    _inCharge = 0;
+    _runtimeUs = 0;
+    _frames = 0;
+    _sessionStartUs = (int64_t)halMicros();
+    // 保留上一帧，下一帧照常积分
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyEnergy::read(EnergyReading &out) const {
+    portENTER_CRITICAL(&_mux);
+    int64_t outEnergy = _outEnergy;
+    int64_t inEnergy = _inEnergy;
+    int64_t outCharge = _outCharge;
+    int64_t inCharge = _inCharge;
+    int64_t runtimeUs = _runtimeUs;
+    uint32_t frames = _frames;
+    int64_t sessionStartUs = _sessionStartUs;
+    portEXIT_CRITICAL(&_mux);
+
+    // 0.5nJ -> Wh：除以2e9得到J，再除以3600
+    const double halfNanoPerHour = 2e9 * 3600.0;
+    out.outWh = outEnergy / halfNanoPerHour;
+    out.inWh = inEnergy / halfNanoPerHour;
+    out.outAh = outCharge / halfNanoPerHour;
+    out.inAh = inCharge / halfNanoPerHour;
+    out.runtimeS = runtimeUs / 1e6;
+    out.sessionS = ((int64_t)halMicros() - sessionStartUs) / 1e6;
+    out.frames = frames;
+}
+
+void MyEnergy::printReport() const {
+    EnergyReading r;
+    read(r);
+    uint32_t runtime = (uint32_t)r.runtimeS;
+    Serial.println("===== 能量累计 =====");
+    Serial.printf("输出: %.4fWh  %.4fAh\n", r.outWh, r.outAh);
+    Serial.printf("输入: %.4fWh  %.4fAh\n", r.inWh, r.inAh);
+    if (r.inWh > 0.0) {
+        Serial.printf("平均效率: %.1f%%\n", r.outWh / r.inWh * 100.0);
+    }
+    Serial.printf("运行时间: %u:%02u:%02u（会话 %.0fs，%u帧）\n",
+                  runtime / 3600, runtime / 60 % 60, runtime % 60, r.sessionS, r.frames);
+}
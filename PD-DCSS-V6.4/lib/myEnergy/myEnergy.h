@@ -0,0 +1,84 @@
+/**
+ * @file myEnergy.h
+ * @brief 能量、电荷和运行时间累计：按采集帧积分输入输出的Wh、Ah
+ * @author watermelon6uice
+ * @details
+ * 以前只有 MyADC::getOutputPower() 给出的瞬时功率，界面每次刷新重新计算一次，没有累计值。
+ * 本模块登记为限流回路的采集帧回调（每2ms一帧），用帧的微秒时间戳按梯形法积分：
+ * - 功率换算为整数毫瓦、电流换算为整数毫安，乘以间隔微秒后累加到64位整数
+ *   （单位分别为 0.5nJ 和 0.5nC，梯形法的1/2留到读取时再除），累加本身没有舍入误差，
+ *   连续运行多天也不会像浮点累加那样因为总量变大而丢掉每帧的小增量；
+ *   输出75W时64位整数可以累计约700天；
+ * - 运行时间为参与积分的间隔之和，即输出打开的时间；
+ * - 两帧间隔超过 ENERGY_MAX_GAP_US（输出关闭、保护锁存等）时不积分这一段；
+ * - reset() 开始新的统计会话。
+ * 累加在限流任务中进行，读取可以在任何任务中进行（短临界区保护64位数据）。
+ * @date 2025-06-13
+ */
+
+#ifndef MY_ENERGY_H
+#define MY_ENERGY_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "myAdcFrame.h"
+
+#define ENERGY_MAX_GAP_US 100000   // 两帧间隔超过100ms时不积分（输出关闭期间没有采集帧）
+
+// 读取结果（换算为常用单位）
+struct EnergyReading {
+    double outWh;        // 输出能量(Wh)
+    double inWh;         // 输入能量(Wh)
+    double outAh;        // 输出电荷(Ah)
+    double inAh;         // 输入电荷(Ah)
+    double runtimeS;     // 参与积分的时间(s)，即本会话中输出打开的时间
+    double sessionS;     // 本会话开始至今的时间(s)
+    uint32_t frames;     // 参与积分的帧数
+};
+
+class MyEnergy {
+public:
+    MyEnergy();
+
+    /**
+     * @brief 累计一个采集帧（由限流回路调用）
+     */
+    void accumulate(const AdcFrame &frame);
+
+    // 采集帧回调，ctx 为 MyEnergy 对象
+    static void onFrame(const AdcFrame &frame, void *ctx);
+
+    /**
+     * @brief 清零所有累计值，开始新的会话
+     */
+    void reset();
+
+    void read(EnergyReading &out) const;
+
+    // 串口输出本会话的累计值
+    void printReport() const;
+
+private:
+    // 64位定点累计值，梯形法：每帧累加 (上一帧 + 本帧) × 间隔
+    int64_t _outEnergy;      // 0.5nJ（mW·us的2倍）
+    int64_t _inEnergy;
+    int64_t _outCharge;      // 0.5nC（mA·us的2倍）
+    int64_t _inCharge;
+    int64_t _runtimeUs;
+    uint32_t _frames;
+    int64_t _sessionStartUs;
+
+    // 上一帧
+    bool _havePrev;
+    int64_t _prevUs;
+    int32_t _prevOutMw;
+    int32_t _prevInMw;
+    int32_t _prevOutMa;
+    int32_t _prevInMa;
+
+    mutable portMUX_TYPE _mux;
+};
+
+extern MyEnergy energy;
+
+#endif // MY_ENERGY_H
@@ -0,0 +1,247 @@
+/**
+ * @file myHAL.h
+ * @brief 硬件抽象层：GPIO、ADC、SPI、PWM、计时、睡眠、电源管理、非易失存储和日志
+ * @author watermelon6uice
+ * @details
+ * 各功能库以前直接调用Arduino和ESP-IDF的硬件接口（adc1_get_raw、esp_adc_cal、SPIClass、
+ * esp_sleep_*、ets_delay_us 等），主机构建只能为每个接口各写一个替身，
+ * 替身之间没有联系，脚本也无法模拟"按下按钮触发中断"这样的输入。
+ *
+ * 现在硬件访问集中到这组函数：
+ * - myHAL_esp32.cpp 用Arduino/ESP-IDF实现，固件构建使用；
+ * - host/src/hal_linux.cpp 用内存中的引脚电平、ADC读数和SPI记录实现，主机构建使用，
+ *   测试脚本通过 host_stubs.h 中的函数设置输入（设置GPIO电平会按边沿调用已登记的中断函数）
+ *   并检查输出。
+ * 接口只覆盖本项目实际用到的功能，不追求通用。
+ * @date 2025-06-12
+ */
+
+#ifndef MY_HAL_H
+#define MY_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* GPIO */
+
+enum HalPinMode {
+    HAL_PIN_INPUT = 0,
+    HAL_PIN_INPUT_PULLUP,
+    HAL_PIN_INPUT_PULLDOWN,
+    HAL_PIN_OUTPUT,
+};
+
+enum HalEdge {
+    HAL_EDGE_RISING = 0,
+    HAL_EDGE_FALLING,
+    HAL_EDGE_CHANGE,
+};
+
+typedef void (*HalIsr)(void);
+
+void halGpioMode(uint8_t pin, HalPinMode mode);
+int halGpioRead(uint8_t pin);
+void halGpioWrite(uint8_t pin, int level);
+void halGpioAttachIsr(uint8_t pin, HalIsr isr, HalEdge edge);
+void halGpioDetachIsr(uint8_t pin);
+
+/* ADC（ADC1，12位，12dB衰减，量程约0-3.3V） */
+
+/**
+ * @brief 配置ADC1的分辨率、各通道衰减和校准
+ * @param channels ADC1通道号数组
+ * @param count 通道数量
+ */
+void halAdcInit(const uint8_t *channels, size_t count);
+
+/**
+ * @brief 读取一次原始值
+ */
+uint32_t halAdcReadRaw(uint8_t channel);
+
+/**
+ * @brief 按校准曲线把原始值换算为毫伏
+ */
+uint32_t halAdcRawToMv(uint32_t raw);
+
+/* ADC连续采样（DMA，用于波形捕获） */
+
+#define HAL_ADC_STREAM_MAX_HZ 83333      // 所有通道合计的最高转换速率
+#define HAL_ADC_STREAM_MIN_HZ 611
+#define HAL_ADC_STREAM_MAX_CHANNELS 4
+
+struct HalAdcSample {
+    uint8_t channel;   // ADC1通道号
+    uint16_t raw;      // 原始值
+};
+
+/**
+ * @brief 按给定的合计速率轮流转换这些通道，结果由DMA写入驱动的缓冲区
+ * @details 连续采样期间不能单次转换：halAdcReadRaw() 对参与连续采样的通道返回最近一个
+ *          连续采样结果，其他通道返回开始连续采样前最后一次读数
+ * @param channels ADC1通道号数组，按此顺序轮流转换
+ * @param count 通道数量，1 ~ HAL_ADC_STREAM_MAX_CHANNELS
+ * @param totalHz 所有通道合计的转换速率，HAL_ADC_STREAM_MIN_HZ ~ HAL_ADC_STREAM_MAX_HZ
+ * @return 启动成功返回true
+ */
+bool halAdcStreamStart(const uint8_t *channels, size_t count, uint32_t totalHz);
+
+/**
+ * @brief 读取连续采样结果，没有数据时最多阻塞 timeoutMs 毫秒（阻塞期间让出CPU）
+ * @param out 输出数组
+ * @param maxSamples 最多读取的样本数
+ * @param overrun 读取不及时、驱动缓冲区溢出丢失了样本时置为true（可为NULL）
+ * @return 读到的样本数，超时为0
+ */
+size_t halAdcStreamRead(HalAdcSample *out, size_t maxSamples, uint32_t timeoutMs, bool *overrun);
+
+/**
+ * @brief 停止连续采样，恢复单次转换
+ */
+void halAdcStreamStop();
+
+/* SPI（只发送，片选由HAL控制） */
+
+struct HalSpi;
+
+/**
+ * @brief 打开一条只发送的SPI总线（模式0，高位在前）
+ * @return 总线句柄，失败返回NULL
+ */
+HalSpi *halSpiOpen(uint8_t sckPin, uint8_t mosiPin, uint8_t csPin, uint32_t clockHz);
+
+/**
+ * @brief 拉低片选，发送16位数据，再拉高片选
+ */
+void halSpiWrite16(HalSpi *spi, uint16_t data);
+
+/* PWM（ESP32上为LEDC） */
+
+/**
+ * @brief 把引脚接到一个PWM通道并以占空比0开始输出
+ * @param channel 通道号（ESP32-S3为0-7）
+ * @param bits 占空比分辨率，满占空比为 (1 << bits) - 1
+ * @return 配置成功返回true
+ */
+bool halPwmInit(uint8_t pin, uint8_t channel, uint32_t freqHz, uint8_t bits);
+
+/**
+ * @brief 设置通道的占空比，立即生效
+ */
+void halPwmWrite(uint8_t channel, uint32_t duty);
+
+/* 计时 */
+
+uint32_t halMillis();
+uint64_t halMicros();
+
+/**
+ * @brief 忙等待若干微秒，不让出CPU（用于按钮消抖等极短延时）
+ */
+void halDelayUs(uint32_t us);
+
+/* 睡眠和复位 */
+
+enum HalWakeCause {
+    HAL_WAKE_OTHER = 0,
+    HAL_WAKE_GPIO,       // 由 halSleepEnableGpioWakeup 设置的引脚唤醒
+};
+
+/**
+ * @brief 配置轻睡眠：睡眠期间保持RTC外设和RTC慢速内存供电
+ */
+void halSleepInit();
+
+/**
+ * @brief 允许某个引脚在指定电平时唤醒（ESP32上只能是RTC IO）
+ */
+void halSleepEnableGpioWakeup(uint8_t pin, int level);
+
+/**
+ * @brief 进入轻睡眠，唤醒后返回唤醒原因
+ */
+HalWakeCause halSleepLight();
+
+/**
+ * @brief 禁用全部唤醒源
+ */
+void halSleepDisableWakeup();
+
+/**
+ * @brief 上次复位原因（ESP32上为 esp_reset_reason_t 的值）
+ */
+int halResetReason();
+
+/* 电源管理（ESP32上为 esp_pm：动态调频和自动轻睡眠） */
+
+enum HalPmLockType {
+    HAL_PM_CPU_MAX = 0,  // 持有期间CPU保持最高频率
+    HAL_PM_APB_MAX,      // 持有期间APB保持80MHz（外设时钟不变）
+    HAL_PM_NO_SLEEP,     // 持有期间不自动进入轻睡眠
+};
+
+struct HalPmLock;
+
+/**
+ * @brief 配置动态调频：没有锁时CPU降到 minMhz，lightSleep 为true时空闲时自动轻睡眠
+ * @return 固件没有启用电源管理（CONFIG_PM_ENABLE，自动轻睡眠还需要
+ *         CONFIG_FREERTOS_USE_TICKLESS_IDLE）或参数不支持时返回false
+ */
+bool halPmConfigure(uint32_t maxMhz, uint32_t minMhz, bool lightSleep);
+
+/**
+ * @brief 创建一个电源管理锁，不支持电源管理时返回NULL
+ */
+HalPmLock *halPmLockCreate(HalPmLockType type, const char *name);
+
+// 获取/释放锁（可嵌套，按次数计）；lock 为NULL时为空操作
+void halPmLockAcquire(HalPmLock *lock);
+void halPmLockRelease(HalPmLock *lock);
+
+/**
+ * @brief 直接设置CPU频率（没有电源管理时手动调频用），不支持的频率返回false
+ */
+bool halCpuSetMhz(uint32_t mhz);
+uint32_t halCpuMhz();
+
+/**
+ * @brief 自动轻睡眠中，这些引脚任一为高电平时唤醒（ESP32-S3上只能是RTC IO，GPIO0-21）
+ * @details 不改变引脚上已登记的中断
+ */
+void halPmWakeOnHigh(const uint8_t *pins, size_t count);
+
+/**
+ * @brief 自动轻睡眠中，这些引脚离开当前电平时唤醒（用于编码器，ESP32-S3上只能是RTC IO，GPIO0-21）
+ * @details 按调用时的电平登记相反电平的唤醒，引脚电平改变后要重新调用；
+ *          用RTC IO的电平唤醒，不改变引脚上已登记的边沿中断
+ */
+void halPmWakeOnChange(const uint8_t *pins, size_t count);
+
+/* 非易失存储（ESP32上为NVS，主机上在内存中） */
+
+/**
+ * @brief 读取一个二进制记录
+ * @param ns 命名空间（ESP32的NVS中最长15个字符）
+ * @param key 键（最长15个字符）
+ * @return 记录存在且长度正好为 size 时读入 data 并返回true；否则不修改 data，返回false
+ */
+bool halNvsLoad(const char *ns, const char *key, void *data, size_t size);
+
+/**
+ * @brief 写入（覆盖）一个二进制记录，返回时已提交
+ */
+bool halNvsSave(const char *ns, const char *key, const void *data, size_t size);
+
+/**
+ * @brief 删除一个记录，记录不存在也返回true
+ */
+bool halNvsErase(const char *ns, const char *key);
+
+/* 日志 */
+
+/**
+ * @brief 格式化输出一行日志（固件上为串口，主机上 --verbose 时输出到标准输出）
+ */
+void halLog(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+#endif // MY_HAL_H
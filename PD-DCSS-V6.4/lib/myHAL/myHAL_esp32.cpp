@@ -0,0 +1,400 @@
+/**
+ * @file myHAL_esp32.cpp
+ * @brief 硬件抽象层的ESP32实现（Arduino + ESP-IDF）
+ * @author watermelon6uice
+ * @details 主机构建不编译本文件，改用 host/src/hal_linux.cpp。
+ * @date 2025-06-12
+ */
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <Preferences.h>
+#include <stdarg.h>
+#include "driver/adc.h"
+#include "esp_adc_cal.h"
+#include "esp_sleep.h"
+#include "esp_system.h"
+#include "driver/rtc_io.h"
+#include "esp_timer.h"
+#include "esp_pm.h"
+#include "myHAL.h"
+
+#define HAL_ADC_DEFAULT_VREF 1100              // 没有eFuse校准值时使用的参考电压(mV)
+#define HAL_ADC_ATTEN        ADC_ATTEN_DB_12   // 12dB衰减，量程0-3.3V
+#define HAL_ADC_WIDTH        ADC_WIDTH_BIT_12
+#define HAL_ADC_CHANNELS     10                // ADC1通道数
+#define HAL_ADC_STREAM_POOL  4096              // 连续采样时驱动缓冲区大小(字节)
+#define HAL_ADC_STREAM_FRAME 256               // 每次DMA中断的转换结果字节数
+
+/* GPIO */
+
+void halGpioMode(uint8_t pin, HalPinMode mode) {
+    static const uint8_t ARDUINO_MODES[] = {INPUT, INPUT_PULLUP, INPUT_PULLDOWN, OUTPUT};
+    pinMode(pin, ARDUINO_MODES[mode]);
+}
+
+int halGpioRead(uint8_t pin) {
+    return digitalRead(pin);
+}
+
+void halGpioWrite(uint8_t pin, int level) {
+    digitalWrite(pin, level ? HIGH : LOW);
+}
+
+void halGpioAttachIsr(uint8_t pin, HalIsr isr, HalEdge edge) {
+    static const int ARDUINO_EDGES[] = {RISING, FALLING, CHANGE};
+    attachInterrupt(digitalPinToInterrupt(pin), isr, ARDUINO_EDGES[edge]);
+}
+
+void halGpioDetachIsr(uint8_t pin) {
+    detachInterrupt(digitalPinToInterrupt(pin));
+}
+
+/* ADC */
+
+static esp_adc_cal_characteristics_t s_adcChars;
+static uint8_t s_adcChannels[HAL_ADC_CHANNELS];
+static size_t s_adcChannelCount = 0;
+static volatile bool s_adcStreaming = false;
+static volatile uint16_t s_adcLast[HAL_ADC_CHANNELS];   // 各通道最近一次读数，连续采样期间代替单次转换
+
+static void configureOneShot() {
+    adc1_config_width(HAL_ADC_WIDTH);
+    for (size_t i = 0; i < s_adcChannelCount; i++) {
+        adc1_config_channel_atten((adc1_channel_t)s_adcChannels[i], HAL_ADC_ATTEN);
+    }
+}
+
+void halAdcInit(const uint8_t *channels, size_t count) {
+    s_adcChannelCount = count < HAL_ADC_CHANNELS ? count : HAL_ADC_CHANNELS;
+    memcpy(s_adcChannels, channels, s_adcChannelCount);
+    configureOneShot();
+    esp_adc_cal_characterize(ADC_UNIT_1, HAL_ADC_ATTEN, HAL_ADC_WIDTH, HAL_ADC_DEFAULT_VREF, &s_adcChars);
+}
+
+uint32_t halAdcReadRaw(uint8_t channel) {
+    if (channel >= HAL_ADC_CHANNELS) {
+        return 0;
+    }
+    if (s_adcStreaming) {
+        return s_adcLast[channel];
+    }
+    uint16_t raw = (uint16_t)adc1_get_raw((adc1_channel_t)channel);
+    s_adcLast[channel] = raw;
+    return raw;
+}
+
+uint32_t halAdcRawToMv(uint32_t raw) {
+    return esp_adc_cal_raw_to_voltage(raw, &s_adcChars);
+}
+
+bool halAdcStreamStart(const uint8_t *channels, size_t count, uint32_t totalHz) {
+    if (s_adcStreaming || count == 0 || count > HAL_ADC_STREAM_MAX_CHANNELS ||
+        totalHz < HAL_ADC_STREAM_MIN_HZ || totalHz > HAL_ADC_STREAM_MAX_HZ) {
+        return false;
+    }
+    uint32_t mask = 0;
+    adc_digi_pattern_config_t pattern[HAL_ADC_STREAM_MAX_CHANNELS] = {};
+    for (size_t i = 0; i < count; i++) {
+        mask |= 1u << channels[i];
+        pattern[i].atten = HAL_ADC_ATTEN;
+        pattern[i].channel = channels[i];
+        pattern[i].unit = 0;   // ADC1
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+
+    adc_digi_init_config_t init = {};
+    init.max_store_buf_size = HAL_ADC_STREAM_POOL;
+    init.conv_num_each_intr = HAL_ADC_STREAM_FRAME;
+    init.adc1_chan_mask = mask;
+    init.adc2_chan_mask = 0;
+    if (adc_digi_initialize(&init) != ESP_OK) {
+        return false;
+    }
+
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en = false;
+    config.conv_limit_num = 250;
+    config.pattern_num = count;
+    config.adc_pattern = pattern;
+    config.sample_freq_hz = totalHz;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+    if (adc_digi_controller_configure(&config) != ESP_OK) {
+        adc_digi_deinitialize();
+        return false;
+    }
+    // 先置位再启动：此后单次读数改为返回缓存，不再与DMA争用ADC1
+    s_adcStreaming = true;
+    if (adc_digi_start() != ESP_OK) {
+        s_adcStreaming = false;
+        adc_digi_deinitialize();
+        configureOneShot();
+        return false;
+    }
+    return true;
+}
+
+size_t halAdcStreamRead(HalAdcSample *out, size_t maxSamples, uint32_t timeoutMs, bool *overrun) {
+    uint8_t buf[HAL_ADC_STREAM_FRAME];
+    size_t want = maxSamples * SOC_ADC_DIGI_RESULT_BYTES;
+    if (want > sizeof(buf)) {
+        want = sizeof(buf);
+    }
+    uint32_t len = 0;
+    esp_err_t err = adc_digi_read_bytes(buf, want, &len, timeoutMs);
+    if (overrun != NULL) {
+        // 驱动缓冲区满时仍返回已有数据
+        *overrun = err == ESP_ERR_INVALID_STATE;
+    }
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        return 0;
+    }
+    size_t n = 0;
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= len && n < maxSamples; i += SOC_ADC_DIGI_RESULT_BYTES) {
+        const adc_digi_output_data_t *p = (const adc_digi_output_data_t *)&buf[i];
+        if (p->type2.unit != 0 || p->type2.channel >= HAL_ADC_CHANNELS) {
+            continue;
+        }
+        out[n].channel = p->type2.channel;
+        out[n].raw = p->type2.data;
+        s_adcLast[p->type2.channel] = p->type2.data;
+        n++;
+    }
+    return n;
+}
+
+void halAdcStreamStop() {
+    if (!s_adcStreaming) {
+        return;
+    }
+    adc_digi_stop();
+    adc_digi_deinitialize();
+    configureOneShot();
+    s_adcStreaming = false;
+}
+
+/* SPI */
+
+struct HalSpi {
+    SPIClass *bus;
+    uint8_t csPin;
+    uint32_t clockHz;
+};
+
+HalSpi *halSpiOpen(uint8_t sckPin, uint8_t mosiPin, uint8_t csPin, uint32_t clockHz) {
+    HalSpi *spi = new HalSpi;
+    spi->bus = new SPIClass(HSPI);
+    spi->csPin = csPin;
+    spi->clockHz = clockHz;
+
+    pinMode(csPin, OUTPUT);
+    digitalWrite(csPin, HIGH);  // 默认CS为高电平（未选中）
+    spi->bus->begin(sckPin, -1, mosiPin, -1); // 只发送，不需要MISO
+    return spi;
+}
+
+void halSpiWrite16(HalSpi *spi, uint16_t data) {
+    if (spi == NULL) {
+        return;
+    }
+    digitalWrite(spi->csPin, LOW);
+    spi->bus->beginTransaction(SPISettings(spi->clockHz, MSBFIRST, SPI_MODE0));
+    spi->bus->transfer16(data);
+    spi->bus->endTransaction();
+    digitalWrite(spi->csPin, HIGH);
+}
+
+/* PWM */
+
+bool halPwmInit(uint8_t pin, uint8_t channel, uint32_t freqHz, uint8_t bits) {
+    if (ledcSetup(channel, freqHz, bits) == 0) {
+        return false;
+    }
+    ledcAttachPin(pin, channel);
+    ledcWrite(channel, 0);
+    return true;
+}
+
+void halPwmWrite(uint8_t channel, uint32_t duty) {
+    ledcWrite(channel, duty);
+}
+
+/* 计时 */
+
+uint32_t halMillis() {
+    return millis();
+}
+
+uint64_t halMicros() {
+    return (uint64_t)esp_timer_get_time();
+}
+
+void halDelayUs(uint32_t us) {
+    ets_delay_us(us);
+}
+
+/* 睡眠和复位 */
+
+void halSleepInit() {
+    // 允许SPI外设在睡眠时保持活动
+    esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH, ESP_PD_OPTION_ON);
+    esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_SLOW_MEM, ESP_PD_OPTION_ON);
+}
+
+void halSleepEnableGpioWakeup(uint8_t pin, int level) {
+    esp_sleep_enable_ext0_wakeup((gpio_num_t)pin, level);
+}
+
+HalWakeCause halSleepLight() {
+    esp_light_sleep_start();
+    return esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_EXT0 ? HAL_WAKE_GPIO : HAL_WAKE_OTHER;
+}
+
+void halSleepDisableWakeup() {
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+}
+
+int halResetReason() {
+    return (int)esp_reset_reason();
+}
+
+/* 电源管理 */
+
+#if CONFIG_PM_ENABLE
+struct HalPmLock {
+    esp_pm_lock_handle_t handle;
+};
+#endif
+
+bool halPmConfigure(uint32_t maxMhz, uint32_t minMhz, bool lightSleep) {
+#if CONFIG_PM_ENABLE && CONFIG_IDF_TARGET_ESP32S3
+    esp_pm_config_esp32s3_t config = {};
+    config.max_freq_mhz = (int)maxMhz;
+    config.min_freq_mhz = (int)minMhz;
+    config.light_sleep_enable = lightSleep;
+    return esp_pm_configure(&config) == ESP_OK;
+#else
+    (void)maxMhz;
+    (void)minMhz;
+    (void)lightSleep;
+    return false;
+#endif
+}
+
+HalPmLock *halPmLockCreate(HalPmLockType type, const char *name) {
+#if CONFIG_PM_ENABLE
+    esp_pm_lock_type_t pmType = type == HAL_PM_CPU_MAX ? ESP_PM_CPU_FREQ_MAX :
+                                type == HAL_PM_APB_MAX ? ESP_PM_APB_FREQ_MAX : ESP_PM_NO_LIGHT_SLEEP;
+    HalPmLock *lock = new HalPmLock;
+    if (esp_pm_lock_create(pmType, 0, name, &lock->handle) != ESP_OK) {
+        delete lock;
+        return NULL;
+    }
+    return lock;
+#else
+    (void)type;
+    (void)name;
+    return NULL;
+#endif
+}
+
+void halPmLockAcquire(HalPmLock *lock) {
+#if CONFIG_PM_ENABLE
+    if (lock != NULL) {
+        esp_pm_lock_acquire(lock->handle);
+    }
+#else
+    (void)lock;
+#endif
+}
+
+void halPmLockRelease(HalPmLock *lock) {
+#if CONFIG_PM_ENABLE
+    if (lock != NULL) {
+        esp_pm_lock_release(lock->handle);
+    }
+#else
+    (void)lock;
+#endif
+}
+
+bool halCpuSetMhz(uint32_t mhz) {
+    return setCpuFrequencyMhz(mhz);
+}
+
+uint32_t halCpuMhz() {
+    return getCpuFrequencyMhz();
+}
+
+void halPmWakeOnHigh(const uint8_t *pins, size_t count) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < count; i++) {
+        mask |= 1ULL << pins[i];
+    }
+    if (mask != 0) {
+        esp_sleep_enable_ext1_wakeup(mask, ESP_EXT1_WAKEUP_ANY_HIGH);
+    }
+}
+
+void halPmWakeOnChange(const uint8_t *pins, size_t count) {
+    bool any = false;
+    for (size_t i = 0; i < count; i++) {
+        gpio_num_t pin = (gpio_num_t)pins[i];
+        if (!rtc_gpio_is_valid_gpio(pin)) {
+            continue;
+        }
+        // gpio_wakeup_enable() 会把数字GPIO的中断类型改成电平中断，这里只设置RTC IO的唤醒
+        rtc_gpio_wakeup_enable(pin, halGpioRead(pins[i]) ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+        any = true;
+    }
+    if (any) {
+        esp_sleep_enable_gpio_wakeup();
+    }
+}
+
+/* 非易失存储 */
+
+bool halNvsLoad(const char *ns, const char *key, void *data, size_t size) {
+    Preferences prefs;
+    // 只读打开不存在的命名空间会失败，相当于记录不存在
+    if (!prefs.begin(ns, true)) {
+        return false;
+    }
+    bool ok = prefs.getBytesLength(key) == size && prefs.getBytes(key, data, size) == size;
+    prefs.end();
+    return ok;
+}
+
+bool halNvsSave(const char *ns, const char *key, const void *data, size_t size) {
+    Preferences prefs;
+    if (!prefs.begin(ns, false)) {
+        return false;
+    }
+    bool ok = prefs.putBytes(key, data, size) == size;
+    prefs.end();
+    return ok;
+}
+
+bool halNvsErase(const char *ns, const char *key) {
+    Preferences prefs;
+    if (!prefs.begin(ns, false)) {
+        return false;
+    }
+    if (prefs.isKey(key)) {
+        prefs.remove(key);
+    }
+    prefs.end();
+    return true;
+}
+
+/* 日志 */
+
+void halLog(const char *fmt, ...) {
+    char buf[256];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    Serial.print(buf);
+}
@@ -0,0 +1,213 @@
+/**
+ * @file myHistory.cpp
+ * @brief 多分辨率历史记录：U_OUT、I_OUT、P_OUT按1秒、10秒、1分钟分档保存最小、最大、平均值
+ * @author watermelon6uice
+ * @date 2025-06-13
+ */
+
+#include "myHistory.h"
+#include "esp_heap_caps.h"
+#include <float.h>
+#include <string.h>
+
+MyHistory history;
+
+// 每档的周期必须是下一档的整数倍，桶的边界才能对齐
+static const uint32_t TIER_PERIOD_S[HISTORY_TIERS] = {1, 10, 60};
+static const uint16_t TIER_LENGTH[HISTORY_TIERS] = {300, 360, 1440};
+
+static const char *const CHANNEL_NAMES[HISTORY_CHANNELS] = {"U_OUT", "I_OUT", "P_OUT"};
+static const char *const UNIT_NAMES[HISTORY_CHANNELS] = {"V", "A", "W"};
+
+#define HISTORY_EMPTY_SEQ 0xffffffffu
+
+MyHistory::MyHistory() :
+    _generation(0)
+{
+    portMUX_TYPE unlocked = portMUX_INITIALIZER_UNLOCKED;
+    _mux = unlocked;
+    for (int k = 0; k < HISTORY_TIERS; k++) {
+        _tiers[k].periodS = TIER_PERIOD_S[k];
+        _tiers[k].length = TIER_LENGTH[k];
+        _tiers[k].ring = NULL;
+        clearAcc(_tiers[k].acc, 0);
+    }
+}
+
+bool MyHistory::begin() {
+    for (int k = 0; k < HISTORY_TIERS; k++) {
+        if (_tiers[k].ring == NULL) {
+            _tiers[k].ring = (HistoryPoint *)heap_caps_malloc(_tiers[k].length * sizeof(HistoryPoint),
+                                                              MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        }
+        if (_tiers[k].ring == NULL) {
+            Serial.println("错误: 历史记录缓冲区分配失败");
+            return false;
+        }
+    }
+    reset();
+    return true;
+}
+
+void MyHistory::clearAcc(Acc &a, uint32_t seq) {
+    a.seq = seq;
+    a.count = 0;
+    for (int ch = 0; ch < HISTORY_CHANNELS; ch++) {
+        a.min[ch] = FLT_MAX;
+        a.max[ch] = -FLT_MAX;
+        a.sum[ch] = 0.0;
+    }
+}
+
+void MyHistory::reset() {
+    portENTER_CRITICAL(&_mux);
+    for (int k = 0; k < HISTORY_TIERS; k++) {
+        Tier &t = _tiers[k];
+        for (uint16_t n = 0; t.ring != NULL && n < t.length; n++) {
+            t.ring[n].seq = HISTORY_EMPTY_SEQ;
+        }
+        clearAcc(t.acc, 0);
+    }
+    _generation++;
+    portEXIT_CRITICAL(&_mux);
+}
+
+// 把当前桶写入环形记录，并合并到上一档的当前桶
+void MyHistory::commit(uint8_t tier) {
+    Tier &t = _tiers[tier];
+    const Acc &a = t.acc;
+    HistoryPoint &p = t.ring[a.seq % t.length];
+    p.seq = a.seq;
+    for (int ch = 0; ch < HISTORY_CHANNELS; ch++) {
+        p.min[ch] = a.min[ch];
+        p.max[ch] = a.max[ch];
+        p.mean[ch] = (float)(a.sum[ch] / a.count);
+    }
+
+    if (tier + 1 >= HISTORY_TIERS) {
+        return;
+    }
+    Tier &up = _tiers[tier + 1];
+    advance(tier + 1, (uint32_t)((uint64_t)a.seq * t.periodS / up.periodS));
+    up.acc.count += a.count;
+    for (int ch = 0; ch < HISTORY_CHANNELS; ch++) {
+        up.acc.min[ch] = a.min[ch] < up.acc.min[ch] ? a.min[ch] : up.acc.min[ch];
+        up.acc.max[ch] = a.max[ch] > up.acc.max[ch] ? a.max[ch] : up.acc.max[ch];
+        up.acc.sum[ch] += a.sum[ch];
+    }
+}
+
+// 该档的当前桶移到 seq，原来的桶有数据时先写入
+void MyHistory::advance(uint8_t tier, uint32_t seq) {
+    Acc &a = _tiers[tier].acc;
+    if (a.seq == seq) {
+        return;
+    }
+    if (a.count > 0) {
+        commit(tier);
+    }
+    clearAcc(a, seq);
+}
+
+void MyHistory::closeBefore(int64_t nowUs) {
+    uint64_t s = nowUs > 0 ? (uint64_t)nowUs / 1000000u : 0;
+    for (uint8_t k = 0; k < HISTORY_TIERS; k++) {
+        advance(k, (uint32_t)(s / _tiers[k].periodS));
+    }
+}
+
+void MyHistory::addFrame(const AdcFrame &frame) {
+    if (_tiers[0].ring == NULL) {
+        return;
+    }
+    const float v[HISTORY_CHANNELS] = {frame.uOut, frame.iOut, frame.uOut * frame.iOut};
+    portENTER_CRITICAL(&_mux);
+    closeBefore(frame.timeUs);
+    Acc &a = _tiers[0].acc;
+    a.count++;
+    for (int ch = 0; ch < HISTORY_CHANNELS; ch++) {
+        a.min[ch] = v[ch] < a.min[ch] ? v[ch] : a.min[ch];
+        a.max[ch] = v[ch] > a.max[ch] ? v[ch] : a.max[ch];
+        a.sum[ch] += v[ch];
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyHistory::onFrame(const AdcFrame &frame, void *ctx) {
+    static_cast<MyHistory *>(ctx)->addFrame(frame);
+}
+
+void MyHistory::flush(int64_t nowUs) {
+    if (_tiers[0].ring == NULL) {
+        return;
+    }
+    portENTER_CRITICAL(&_mux);
+    closeBefore(nowUs);
+    portEXIT_CRITICAL(&_mux);
+}
+
+uint32_t MyHistory::periodS(uint8_t tier) const {
+    return tier < HISTORY_TIERS ? _tiers[tier].periodS : 0;
+}
+
+uint16_t MyHistory::length(uint8_t tier) const {
+    return tier < HISTORY_TIERS ? _tiers[tier].length : 0;
+}
+
+uint32_t MyHistory::head(uint8_t tier) const {
+    return tier < HISTORY_TIERS ? _tiers[tier].acc.seq : 0;
+}
+
+bool MyHistory::read(uint8_t tier, uint32_t seq, HistoryPoint &out) const {
+    if (tier >= HISTORY_TIERS || _tiers[tier].ring == NULL) {
+        return false;
+    }
+    const Tier &t = _tiers[tier];
+    portENTER_CRITICAL(&_mux);
+    bool found = seq < t.acc.seq && t.acc.seq - seq <= t.length && t.ring[seq % t.length].seq == seq;
+    if (found) {
+        out = t.ring[seq % t.length];
+    }
+    portEXIT_CRITICAL(&_mux);
+    return found;
+}
+
+bool MyHistory::columns(uint8_t tier, uint8_t channel, uint16_t count, float *mins, float *maxs, float *means,
+                        bool *valid) const {
+    if (tier >= HISTORY_TIERS || channel >= HISTORY_CHANNELS || count == 0 || _tiers[tier].ring == NULL) {
+        return false;
+    }
+    const uint16_t len = _tiers[tier].length;
+    const uint32_t first = head(tier) - len;   // 可能回绕，read() 会判断为空点
+    HistoryPoint p;
+    for (uint16_t c = 0; c < count; c++) {
+        uint32_t b = (uint32_t)c * len / count;
+        uint32_t e = (uint32_t)(c + 1) * len / count;
+        float lo = FLT_MAX;
+        float hi = -FLT_MAX;
+        double sum = 0.0;
+        uint32_t n = 0;
+        for (uint32_t k = b; k < e; k++) {
+            if (!read(tier, first + k, p)) {
+                continue;
+            }
+            lo = p.min[channel] < lo ? p.min[channel] : lo;
+            hi = p.max[channel] > hi ? p.max[channel] : hi;
+            sum += p.mean[channel];
+            n++;
+        }
+        valid[c] = n > 0;
+        mins[c] = n > 0 ? lo : 0.0f;
+        maxs[c] = n > 0 ? hi : 0.0f;
+        means[c] = n > 0 ? (float)(sum / n) : 0.0f;
+    }
+    return true;
+}
+
+const char *MyHistory::channelName(uint8_t channel) {
+    return channel < HISTORY_CHANNELS ? CHANNEL_NAMES[channel] : "?";
+}
+
+const char *MyHistory::unitName(uint8_t channel) {
+    return channel < HISTORY_CHANNELS ? UNIT_NAMES[channel] : "";
+}
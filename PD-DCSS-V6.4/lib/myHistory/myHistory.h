@@ -0,0 +1,125 @@
+/**
+ * @file myHistory.h
+ * @brief 多分辨率历史记录：U_OUT、I_OUT、P_OUT按1秒、10秒、1分钟分档保存最小、最大、平均值
+ * @author watermelon6uice
+ * @details
+ * 趋势图需要几分钟到一天的数据，不能每次从头统计。本模块登记为限流回路的采集帧回调，
+ * 在采集时增量维护 HISTORY_TIERS 档环形记录（默认 1秒/点 5分钟、10秒/点 1小时、1分钟/点 24小时）：
+ * - 每一帧只更新第0档当前桶的最小、最大、和与帧数；
+ * - 桶按时间对齐（第k档的桶序号 = 帧时间 / 该档的周期），时间跨入下一个桶时写入环形记录，
+ *   并合并到上一档的当前桶（最小取最小、最大取最大，和与帧数相加），上一档同样按时间写入；
+ * - 没有数据的桶（输出关闭期间没有采集帧）不写入，环形记录中每个点保存自己的桶序号，
+ *   读取时序号对不上即为空点，跨过很长的空档也只需常数时间；
+ * - flush() 按当前时间写入已经结束的桶，输出关闭时趋势图照样向前推进。
+ * 环形记录约84KB，begin() 时分配在PSRAM中。写入在限流任务中进行，读取可以在任何任务中
+ * 进行（每个点一次短临界区）。
+ * @date 2025-06-13
+ */
+
+#ifndef MY_HISTORY_H
+#define MY_HISTORY_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "myAdcFrame.h"
+
+#define HISTORY_CHANNELS 3           // U_OUT、I_OUT、P_OUT
+#define HISTORY_TIERS 3
+
+enum HistoryChannel {
+    HISTORY_U_OUT = 0,
+    HISTORY_I_OUT,
+    HISTORY_P_OUT,
+};
+
+// 一个桶的统计值（V、A、W）
+struct HistoryPoint {
+    uint32_t seq;                        // 桶序号（桶的起始时间 / 周期）
+    float min[HISTORY_CHANNELS];
+    float max[HISTORY_CHANNELS];
+    float mean[HISTORY_CHANNELS];
+};
+
+class MyHistory {
+public:
+    MyHistory();
+
+    /**
+     * @brief 在PSRAM中分配环形记录
+     * @return 成功返回true
+     */
+    bool begin();
+
+    /**
+     * @brief 加入一个采集帧（由限流回路调用）
+     */
+    void addFrame(const AdcFrame &frame);
+
+    // 采集帧回调，ctx 为 MyHistory 对象
+    static void onFrame(const AdcFrame &frame, void *ctx);
+
+    /**
+     * @brief 写入到 nowUs 为止已经结束的桶（没有采集帧时由界面周期调用）
+     * @param nowUs 当前时间(us，halMicros)
+     */
+    void flush(int64_t nowUs);
+
+    // 清空所有记录
+    void reset();
+
+    uint32_t periodS(uint8_t tier) const;
+    uint16_t length(uint8_t tier) const;
+
+    // 当前桶的序号：已写入的点的序号都小于它，可读的是 [head - length, head)
+    uint32_t head(uint8_t tier) const;
+
+    // 每次 reset() 加1；显示方比较它和 head() 判断是否需要刷新
+    uint32_t generation() const { return _generation; }
+
+    /**
+     * @brief 读取一个点
+     * @return 该桶没有数据（空点、已被覆盖或尚未写入）时返回false
+     */
+    bool read(uint8_t tier, uint32_t seq, HistoryPoint &out) const;
+
+    /**
+     * @brief 把某档最近 length() 个点分成 columns 列，求每列的最小、最大、平均值，用于绘图
+     * @param valid 每列是否有数据（整列都是空点时为false）
+     * @return 档号或通道无效、没有分配记录时返回false
+     */
+    bool columns(uint8_t tier, uint8_t channel, uint16_t count, float *mins, float *maxs, float *means,
+                 bool *valid) const;
+
+    static const char *channelName(uint8_t channel);
+    static const char *unitName(uint8_t channel);
+
+private:
+    // 当前（未结束的）桶
+    struct Acc {
+        uint32_t seq;
+        uint32_t count;                  // 帧数
+        float min[HISTORY_CHANNELS];
+        float max[HISTORY_CHANNELS];
+        double sum[HISTORY_CHANNELS];
+    };
+
+    struct Tier {
+        uint32_t periodS;
+        uint16_t length;
+        HistoryPoint *ring;
+        Acc acc;
+    };
+
+    Tier _tiers[HISTORY_TIERS];
+    volatile uint32_t _generation;
+    mutable portMUX_TYPE _mux;
+
+    static void clearAcc(Acc &a, uint32_t seq);
+    void commit(uint8_t tier);
+    void advance(uint8_t tier, uint32_t seq);
+    void closeBefore(int64_t nowUs);
+};
+
+extern MyHistory history;
+
+#endif // MY_HISTORY_H
@@ -0,0 +1,220 @@
+/**
+ * @file myHistoryUI.cpp
+ * @brief 趋势屏幕：U_OUT、I_OUT、P_OUT的历史曲线（每列的最小、最大、平均值），三档时间范围
+ * @author watermelon6uice
+ * @details
+ * 屏幕由屏幕表（myScreens）在第一次切换时创建，离开后是否保留由屏幕表的内存预算决定，
+ * 删除后图表的点数组等不再占用LVGL内存。步进按钮（或串口命令v）切换时间范围。
+ * 每个通道一个 lv_chart，三条曲线：每列的最大值、最小值（暗色包络）和平均值。
+ * 纵向按显示范围内的数据自动缩放，图表内部统一使用 0 ~ TREND_RANGE 的坐标，
+ * 与通道的单位和大小无关（lv_coord_t 只有16位）。没有数据的列不画。
+ * @date 2025-06-13
+ */
+
+#include "myHistoryUI.h"
+#include "myHistory.h"
+#include "myHAL.h"
+
+#define TREND_POINTS 240             // 每个图表的列数
+#define TREND_CHART_X 56
+#define TREND_CHART_Y 22
+#define TREND_CHART_W 256
+#define TREND_CHART_H 60
+#define TREND_CHART_STEP 72          // 图表之间的纵向间距
+#define TREND_RANGE 1000             // 图表内部的纵向坐标范围
+#define TREND_MARGIN 0.1f            // 上下各留出量程的10%
+
+#define TREND_BG_COLOR 0x000822
+#define TREND_GRID_COLOR 0x1f3050
+#define TREND_TEXT_COLOR 0xffffff
+
+static const uint32_t MEAN_COLORS[HISTORY_CHANNELS] = {0xcfc300, 0x00a629, 0xff7f27};
+static const uint32_t RANGE_COLORS[HISTORY_CHANNELS] = {0x5a5500, 0x004a12, 0x6a3510};
+
+// 纵向最小量程，平直的曲线不会把噪声放大到满幅
+static const float MIN_SPAN[HISTORY_CHANNELS] = {0.05f, 0.01f, 0.05f};
+
+static lv_obj_t *s_title = NULL;
+static lv_obj_t *s_chart[HISTORY_CHANNELS];
+static lv_obj_t *s_top[HISTORY_CHANNELS];       // 纵向上限
+static lv_obj_t *s_bottom[HISTORY_CHANNELS];    // 纵向下限
+static lv_obj_t *s_last[HISTORY_CHANNELS];      // 最近一列的平均值
+static lv_chart_series_t *s_maxSeries[HISTORY_CHANNELS];
+static lv_chart_series_t *s_minSeries[HISTORY_CHANNELS];
+static lv_chart_series_t *s_meanSeries[HISTORY_CHANNELS];
+static uint8_t s_tier = 0;
+static uint32_t s_shownHead = 0;               // 已显示的档的 head()，变化时有新的点
+static uint32_t s_shownGeneration = 0;
+
+// 抽取时的临时数组，刷新期间从LVGL内存中分配
+struct TrendColumns {
+    float mins[TREND_POINTS];
+    float maxs[TREND_POINTS];
+    float means[TREND_POINTS];
+    bool valid[TREND_POINTS];
+};
+
+static lv_obj_t *createLabel(lv_obj_t *parent, lv_coord_t x, lv_coord_t y, uint32_t color) {
+    lv_obj_t *label = lv_label_create(parent);
+    lv_obj_set_style_text_font(label, &lv_font_montserratMedium_9, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(label, lv_color_hex(color), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_pos(label, x, y);
+    lv_label_set_text(label, "");
+    return label;
+}
+
+// 屏幕被删除（离开后超出屏幕内存预算）时清空所有对象指针
+static void screenDeleteCb(lv_event_t *e) {
+    s_title = NULL;
+    for (uint8_t ch = 0; ch < HISTORY_CHANNELS; ch++) {
+        s_chart[ch] = NULL;
+        s_top[ch] = NULL;
+        s_bottom[ch] = NULL;
+        s_last[ch] = NULL;
+    }
+}
+
+static void showTitle() {
+    uint32_t period = history.periodS(s_tier);
+    uint32_t span = period * history.length(s_tier);
+    char range[16];
+    char step[16];
+    if (span >= 3600) {
+        snprintf(range, sizeof(range), "%luh", (unsigned long)(span / 3600));
+    } else {
+        snprintf(range, sizeof(range), "%lumin", (unsigned long)(span / 60));
+    }
+    if (period >= 60) {
+        snprintf(step, sizeof(step), "%lumin/pt", (unsigned long)(period / 60));
+    } else {
+        snprintf(step, sizeof(step), "%lus/pt", (unsigned long)period);
+    }
+    lv_label_set_text_fmt(s_title, "TREND  %s  %s  min/max/mean   step:range", range, step);
+}
+
+void buildTrendScreen(lv_obj_t *screen) {
+    lv_obj_set_style_bg_color(screen, lv_color_hex(TREND_BG_COLOR), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(screen, LV_OPA_COVER, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_event_cb(screen, screenDeleteCb, LV_EVENT_DELETE, NULL);
+
+    s_title = createLabel(screen, 10, 6, TREND_TEXT_COLOR);
+
+    for (uint8_t ch = 0; ch < HISTORY_CHANNELS; ch++) {
+        lv_coord_t y = TREND_CHART_Y + ch * TREND_CHART_STEP;
+        lv_obj_t *chart = lv_chart_create(screen);
+        lv_obj_set_pos(chart, TREND_CHART_X, y);
+        lv_obj_set_size(chart, TREND_CHART_W, TREND_CHART_H);
+        lv_chart_set_type(chart, LV_CHART_TYPE_LINE);
+        lv_chart_set_point_count(chart, TREND_POINTS);
+        lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, 0, TREND_RANGE);
+        lv_chart_set_div_line_count(chart, 3, 5);
+        lv_obj_set_style_bg_color(chart, lv_color_hex(TREND_BG_COLOR), LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_border_color(chart, lv_color_hex(TREND_GRID_COLOR), LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_line_color(chart, lv_color_hex(TREND_GRID_COLOR), LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_border_width(chart, 1, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_radius(chart, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_pad_all(chart, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_line_width(chart, 1, LV_PART_ITEMS | LV_STATE_DEFAULT);
+        lv_obj_set_style_size(chart, 0, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+        // 先加的曲线在下面：包络在下，平均值在上
+        s_maxSeries[ch] = lv_chart_add_series(chart, lv_color_hex(RANGE_COLORS[ch]), LV_CHART_AXIS_PRIMARY_Y);
+        s_minSeries[ch] = lv_chart_add_series(chart, lv_color_hex(RANGE_COLORS[ch]), LV_CHART_AXIS_PRIMARY_Y);
+        s_meanSeries[ch] = lv_chart_add_series(chart, lv_color_hex(MEAN_COLORS[ch]), LV_CHART_AXIS_PRIMARY_Y);
+        s_chart[ch] = chart;
+
+        lv_obj_t *name = createLabel(screen, 4, y + TREND_CHART_H / 2 - 12, MEAN_COLORS[ch]);
+        lv_label_set_text(name, MyHistory::channelName(ch));
+        s_last[ch] = createLabel(screen, 4, y + TREND_CHART_H / 2, MEAN_COLORS[ch]);
+        s_top[ch] = createLabel(screen, 4, y, TREND_TEXT_COLOR);
+        s_bottom[ch] = createLabel(screen, 4, y + TREND_CHART_H - 11, TREND_TEXT_COLOR);
+    }
+    showTitle();
+    // 新建的屏幕一定要刷新一次
+    s_shownGeneration = history.generation() - 1;
+}
+
+static lv_coord_t toChart(float value, float lo, float span) {
+    float pos = (value - lo) / span;
+    if (pos < 0.0f) pos = 0.0f;
+    if (pos > 1.0f) pos = 1.0f;
+    return (lv_coord_t)(pos * TREND_RANGE + 0.5f);
+}
+
+static void refreshChannel(uint8_t ch, TrendColumns &c) {
+    lv_obj_t *chart = s_chart[ch];
+    bool any = history.columns(s_tier, ch, TREND_POINTS, c.mins, c.maxs, c.means, c.valid);
+    float lo = 1e9f;
+    float hi = -1e9f;
+    int last = -1;
+    for (uint16_t i = 0; any && i < TREND_POINTS; i++) {
+        if (c.valid[i]) {
+            lo = LV_MIN(lo, c.mins[i]);
+            hi = LV_MAX(hi, c.maxs[i]);
+            last = i;
+        }
+    }
+    if (last < 0) {
+        for (uint16_t i = 0; i < TREND_POINTS; i++) {
+            lv_chart_set_value_by_id(chart, s_maxSeries[ch], i, LV_CHART_POINT_NONE);
+            lv_chart_set_value_by_id(chart, s_minSeries[ch], i, LV_CHART_POINT_NONE);
+            lv_chart_set_value_by_id(chart, s_meanSeries[ch], i, LV_CHART_POINT_NONE);
+        }
+        lv_label_set_text(s_top[ch], "");
+        lv_label_set_text(s_bottom[ch], "");
+        lv_label_set_text(s_last[ch], "--");
+        lv_chart_refresh(chart);
+        return;
+    }
+
+    float span = LV_MAX(hi - lo, MIN_SPAN[ch]);
+    float mid = (hi + lo) / 2.0f;
+    span *= 1.0f + 2.0f * TREND_MARGIN;
+    lo = mid - span / 2.0f;
+    for (uint16_t i = 0; i < TREND_POINTS; i++) {
+        bool v = c.valid[i];
+        lv_chart_set_value_by_id(chart, s_maxSeries[ch], i, v ? toChart(c.maxs[i], lo, span) : LV_CHART_POINT_NONE);
+        lv_chart_set_value_by_id(chart, s_minSeries[ch], i, v ? toChart(c.mins[i], lo, span) : LV_CHART_POINT_NONE);
+        lv_chart_set_value_by_id(chart, s_meanSeries[ch], i, v ? toChart(c.means[i], lo, span) : LV_CHART_POINT_NONE);
+    }
+    lv_chart_refresh(chart);
+
+    const char *unit = MyHistory::unitName(ch);
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%.3f%s", lo + span, unit);
+    lv_label_set_text(s_top[ch], buf);
+    snprintf(buf, sizeof(buf), "%.3f%s", lo, unit);
+    lv_label_set_text(s_bottom[ch], buf);
+    snprintf(buf, sizeof(buf), "%.3f%s", c.means[last], unit);
+    lv_label_set_text(s_last[ch], buf);
+}
+
+static void refresh() {
+    TrendColumns *c = (TrendColumns *)lv_mem_alloc(sizeof(TrendColumns));
+    if (c == NULL) {
+        return;
+    }
+    s_shownHead = history.head(s_tier);
+    s_shownGeneration = history.generation();
+    for (uint8_t ch = 0; ch < HISTORY_CHANNELS; ch++) {
+        refreshChannel(ch, *c);
+    }
+    lv_mem_free(c);
+}
+
+bool trendScreenKey(ScreenKey key) {
+    if (key != SCREEN_KEY_STEP || s_title == NULL) {
+        return false;
+    }
+    s_tier = (s_tier + 1) % HISTORY_TIERS;
+    showTitle();
+    s_shownGeneration = history.generation() - 1;
+    return true;
+}
+
+void updateTrendScreen(lv_obj_t *screen) {
+    // 输出关闭时没有采集帧，按当前时间写入已结束的桶，曲线照样向前推进
+    history.flush((int64_t)halMicros());
+    if (history.head(s_tier) != s_shownHead || history.generation() != s_shownGeneration) {
+        refresh();
+    }
+}
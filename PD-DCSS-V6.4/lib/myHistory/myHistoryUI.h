@@ -0,0 +1,26 @@
+/**
+ * @file myHistoryUI.h
+ * @brief 趋势屏幕：U_OUT、I_OUT、P_OUT的历史曲线（每列的最小、最大、平均值），三档时间范围
+ * @author watermelon6uice
+ * @date 2025-06-13
+ */
+
+#ifndef MY_HISTORY_UI_H
+#define MY_HISTORY_UI_H
+
+#include "lvgl.h"
+#include "myScreens.h"
+
+// 屏幕表的创建函数：在 screen 中创建趋势屏幕的控件
+void buildTrendScreen(lv_obj_t *screen);
+
+/**
+ * @brief 屏幕表的更新函数：有新的历史点就刷新曲线
+ * @note 由 screens.update() 在UI任务中调用，只在趋势屏幕显示时调用
+ */
+void updateTrendScreen(lv_obj_t *screen);
+
+// 屏幕表的按键函数：步进按钮切换时间范围 5分钟 -> 1小时 -> 24小时 -> 5分钟
+bool trendScreenKey(ScreenKey key);
+
+#endif // MY_HISTORY_UI_H
@@ -0,0 +1,215 @@
+/**
+ * @file myPerf.cpp
+ * @brief 性能监视：各处理阶段耗时直方图、帧率、刷屏吞吐和任务CPU占用
+ * @author watermelon6uice
+ * @details
+ * 直方图按2的幂分桶，记录时只需要找最高位，临界区内只有几次加法；
+ * 百分位数取所在桶的上界，精度在2倍以内，足够判断耗时落在哪个量级。
+ * @date 2025-06-08
+ */
+
+#include "myPerf.h"
+
+MyPerf perf;
+
+static const char *const STAGE_NAMES[PERF_STAGE_COUNT] = {
+    "渲染",
+    "刷屏",
+    "ADC",
+    "界面",
+    "DAC",
+    "编码器",
+    "限流",
+};
+
+MyPerf::MyPerf() :
+    _curFrames(0),
+    _lastFrames(0),
+    _frameSeq(0),
+    _curFramePx(0),
+    _lastFramePx(0),
+    _curFlushBytes(0),
+    _lastFlushBytes(0),
+    _windowStartUs(0),
+    _lastWindowUs(0),
+    _serialReport(false),
+    _overlay(NULL),
+    _overlayToggleRequest(false),
+    _lastOverlayUpdate(0),
+    _taskPrevCount(0),
+    _taskPrevTotal(0)
+{
+    portMUX_TYPE unlocked = portMUX_INITIALIZER_UNLOCKED;
+    _mux = unlocked;
+    for (int i = 0; i < PERF_STAGE_COUNT; i++) {
+        resetHistogram(_cur[i]);
+        resetHistogram(_last[i]);
+    }
+}
+
+void MyPerf::resetHistogram(PerfHistogram &h) {
+    memset(&h, 0, sizeof(h));
+    h.minUs = UINT32_MAX;
+}
+
+void MyPerf::recordDuration(PerfStage stage, uint32_t us) {
+    // 最高位所在位置即桶号
+    uint32_t bucket = us < 2 ? 0 : 31 - __builtin_clz(us);
+    if (bucket >= PERF_HIST_BUCKETS) {
+        bucket = PERF_HIST_BUCKETS - 1;
+    }
+
+    portENTER_CRITICAL(&_mux);
+    PerfHistogram &h = _cur[stage];
+    h.count++;
+    h.sumUs += us;
+    if (us < h.minUs) h.minUs = us;
+    if (us > h.maxUs) h.maxUs = us;
+    h.buckets[bucket]++;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyPerf::recordFlush(int64_t startUs, uint32_t bytes) {
+    recordDuration(PERF_STAGE_FLUSH, (uint32_t)(esp_timer_get_time() - startUs));
+    portENTER_CRITICAL(&_mux);
+    _curFlushBytes += bytes;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyPerf::recordFrame(uint32_t px) {
+    portENTER_CRITICAL(&_mux);
+    _curFrames++;
+    _curFramePx += px;
+    _frameSeq++;
+    portEXIT_CRITICAL(&_mux);
+}
+
+uint32_t MyPerf::percentile(const PerfHistogram &h, uint32_t permille) {
+    if (h.count == 0) {
+        return 0;
+    }
+    uint32_t target = (uint32_t)(((uint64_t)h.count * permille + 999) / 1000);
+    uint32_t seen = 0;
+    for (int i = 0; i < PERF_HIST_BUCKETS; i++) {
+        seen += h.buckets[i];
+        if (seen >= target) {
+            // 桶上界，不超过实际最大值
+            uint32_t upper = (i >= 31) ? UINT32_MAX : ((2u << i) - 1);
+            return upper < h.maxUs ? upper : h.maxUs;
+        }
+    }
+    return h.maxUs;
+}
+
+void MyPerf::rollWindow() {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&_mux);
+    for (int i = 0; i < PERF_STAGE_COUNT; i++) {
+        _last[i] = _cur[i];
+        resetHistogram(_cur[i]);
+    }
+    _lastFrames = _curFrames;
+    _lastFramePx = _curFramePx;
+    _lastFlushBytes = _curFlushBytes;
+    _curFrames = 0;
+    _curFramePx = 0;
+    _curFlushBytes = 0;
+    _lastWindowUs = now - _windowStartUs;
+    _windowStartUs = now;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyPerf::tick() {
+    if (_windowStartUs == 0) {
+        _windowStartUs = esp_timer_get_time();
+        return;
+    }
+    if (esp_timer_get_time() - _windowStartUs < (int64_t)PERF_REPORT_INTERVAL * 1000) {
+        return;
+    }
+    rollWindow();
+    if (_serialReport) {
+        printSummary();
+    }
+}
+
+void MyPerf::printSummary() {
+    // 先复制一份上一个完整窗口，避免打印期间被记录函数修改
+    PerfHistogram stats[PERF_STAGE_COUNT];
+    portENTER_CRITICAL(&_mux);
+    memcpy(stats, _last, sizeof(stats));
+    uint32_t frames = _lastFrames;
+    uint64_t framePx = _lastFramePx;
+    uint64_t flushBytes = _lastFlushBytes;
+    int64_t windowUs = _lastWindowUs;
+    portEXIT_CRITICAL(&_mux);
+
+    if (windowUs <= 0) {
+        Serial.println("[性能] 第一个统计窗口尚未结束");
+        return;
+    }
+
+    float seconds = windowUs / 1000000.0f;
+    const PerfHistogram &flush = stats[PERF_STAGE_FLUSH];
+    float flushMBps = flush.sumUs > 0 ? (float)flushBytes / (float)flush.sumUs : 0.0f;
+    Serial.printf("\n[性能] 窗口 %.1fs, 帧率 %.1f fps, 平均每帧 %u 像素, 刷屏 %u KB (%.2f MB/s)\n",
+                  seconds, frames / seconds, frames ? (unsigned)(framePx / frames) : 0u,
+                  (unsigned)(flushBytes / 1024), flushMBps);
+    Serial.println("阶段      次数     平均us   p50us    p95us    p99us    最大us");
+    for (int i = 0; i < PERF_STAGE_COUNT; i++) {
+        const PerfHistogram &h = stats[i];
+        if (h.count == 0) {
+            Serial.printf("%-8s  %5u\n", STAGE_NAMES[i], 0u);
+            continue;
+        }
+        Serial.printf("%-8s  %5u  %8u %8u %8u %8u %8u\n", STAGE_NAMES[i], (unsigned)h.count,
+                      (unsigned)(h.sumUs / h.count), (unsigned)percentile(h, 500),
+                      (unsigned)percentile(h, 950), (unsigned)percentile(h, 990), (unsigned)h.maxUs);
+    }
+    printTaskStats();
+}
+
+void MyPerf::printTaskStats() {
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+    // 多留几个位置，防止统计期间有新任务创建
+    UBaseType_t n = uxTaskGetNumberOfTasks() + 2;
+    TaskStatus_t *status = (TaskStatus_t *)malloc(sizeof(TaskStatus_t) * n);
+    if (status == NULL) {
+        return;
+    }
+    uint32_t total = 0;
+    n = uxTaskGetSystemState(status, n, &total);
+
+    uint32_t totalDelta = total - _taskPrevTotal;
+    Serial.println("任务              核心 优先级  CPU%(本窗口，双核合计200%)");
+    for (UBaseType_t i = 0; i < n; i++) {
+        // 找到上次的计数，没有则从0开始（新任务）
+        uint32_t prev = 0;
+        for (uint32_t j = 0; j < _taskPrevCount; j++) {
+            if (_taskPrev[j].handle == status[i].xHandle) {
+                prev = _taskPrev[j].runTime;
+                break;
+            }
+        }
+        uint32_t delta = status[i].ulRunTimeCounter - prev;
+        float pct = totalDelta > 0 ? delta * 100.0f / totalDelta : 0.0f;
+#if configTASKLIST_INCLUDE_COREID
+        int core = status[i].xCoreID == tskNO_AFFINITY ? -1 : (int)status[i].xCoreID;
+#else
+        int core = -1;
+#endif
+        Serial.printf("%-16s  %4d %6u  %6.1f\n", status[i].pcTaskName, core,
+                      (unsigned)status[i].uxCurrentPriority, pct);
+    }
+
+    _taskPrevCount = n < PERF_MAX_TASKS ? n : PERF_MAX_TASKS;
+    for (UBaseType_t i = 0; i < _taskPrevCount; i++) {
+        _taskPrev[i].handle = status[i].xHandle;
+        _taskPrev[i].runTime = status[i].ulRunTimeCounter;
+    }
+    _taskPrevTotal = total;
+    free(status);
+#else
+    Serial.println("任务CPU占用: 未启用 configGENERATE_RUN_TIME_STATS");
+#endif
+}
@@ -0,0 +1,159 @@
+/**
+ * @file myPerf.h
+ * @brief 性能监视：各处理阶段耗时直方图、帧率、刷屏吞吐和任务CPU占用
+ * @author watermelon6uice
+ * @details
+ * 在关键路径上用 esp_timer_get_time() 打时间戳，按阶段累计到对数分桶的直方图中：
+ * - 渲染：发生了刷新的 lv_timer_handler() 调用的总耗时（包含绘制和刷屏）；
+ * - 刷屏：my_disp_flush 推送一块像素的耗时和字节数；
+ * - ADC采样、读数界面更新、DAC写入、编码器处理、限流回路。
+ * 统计按窗口滚动：每个汇报周期输出一次串口汇总，然后开始新窗口。
+ * 汇总同时包含各FreeRTOS任务在本窗口内的CPU占用（需要在sdkconfig中启用
+ * configGENERATE_RUN_TIME_STATS 和 configUSE_TRACE_FACILITY）。
+ * 可选的屏幕叠加标签放在LVGL顶层，显示帧率和主要耗时。
+ *
+ * 记录函数可以在任意任务中调用；叠加标签只能在LVGL所在的任务中更新。
+ * @date 2025-06-08
+ */
+
+#ifndef MY_PERF_H
+#define MY_PERF_H
+
+#include <Arduino.h>
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define PERF_HIST_BUCKETS 24          // 第i桶统计 [2^i, 2^(i+1)) 微秒，覆盖到约16秒
+#define PERF_REPORT_INTERVAL 5000     // 串口汇总周期，单位ms
+#define PERF_OVERLAY_INTERVAL 500     // 叠加标签刷新周期，单位ms
+#define PERF_MAX_TASKS 24             // 任务CPU占用统计的任务数上限
+
+// 记录函数会在DAC、ADC等任务中调用，头文件不依赖LVGL
+struct _lv_obj_t;
+
+// 计时阶段
+enum PerfStage {
+    PERF_STAGE_LVGL = 0,  // 一帧的渲染总耗时（lv_timer_handler）
+    PERF_STAGE_FLUSH,     // 刷屏（SPI推送）
+    PERF_STAGE_ADC,       // ADC采样
+    PERF_STAGE_UI,        // 读数标签更新
+    PERF_STAGE_DAC,       // DAC写入
+    PERF_STAGE_ENCODER,   // 编码器处理
+    PERF_STAGE_REGULATOR, // 限流回路一次采样和计算
+    PERF_STAGE_COUNT
+};
+
+// 单个阶段在一个窗口内的统计
+struct PerfHistogram {
+    uint32_t count;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint64_t sumUs;
+    uint32_t buckets[PERF_HIST_BUCKETS];
+};
+
+class MyPerf {
+public:
+    MyPerf();
+
+    /**
+     * @brief 记录一个阶段的耗时
+     * @param stage 阶段
+     * @param startUs 阶段开始时 esp_timer_get_time() 的返回值
+     */
+    void record(PerfStage stage, int64_t startUs) {
+        recordDuration(stage, (uint32_t)(esp_timer_get_time() - startUs));
+    }
+
+    /**
+     * @brief 记录一次刷屏
+     * @param startUs 刷屏开始时间
+     * @param bytes 推送的字节数
+     */
+    void recordFlush(int64_t startUs, uint32_t bytes);
+
+    /**
+     * @brief LVGL完成一帧刷新（由显示驱动的 monitor_cb 调用）
+     * @param px 本帧重绘的像素数
+     */
+    void recordFrame(uint32_t px);
+
+    /**
+     * @brief 已完成的帧计数，用于判断一次 lv_timer_handler() 是否发生了刷新
+     */
+    uint32_t frameSeq() const { return _frameSeq; }
+
+    void recordDuration(PerfStage stage, uint32_t us);
+
+    /**
+     * @brief 周期处理：到达汇报周期时输出串口汇总并开始新窗口
+     * @details 在主循环等低优先级任务中调用
+     */
+    void tick();
+
+    /**
+     * @brief 立即输出一次串口汇总（不重置窗口）
+     */
+    void printSummary();
+
+    /**
+     * @brief 打开/关闭周期性串口汇总
+     */
+    void setSerialReport(bool enable) { _serialReport = enable; }
+    bool isSerialReportEnabled() const { return _serialReport; }
+
+    /**
+     * @brief 显示/隐藏屏幕叠加标签
+     * @details 必须在LVGL所在的任务中调用
+     */
+    void setOverlayVisible(bool visible);
+    bool isOverlayVisible() const;
+
+    /**
+     * @brief 请求切换叠加标签（任意任务中调用，下次 updateOverlay 时生效）
+     */
+    void requestOverlayToggle() { _overlayToggleRequest = true; }
+
+    /**
+     * @brief 刷新叠加标签内容
+     * @details 在UI任务中周期调用，内部按 PERF_OVERLAY_INTERVAL 限频
+     */
+    void updateOverlay();
+
+private:
+    portMUX_TYPE _mux;
+
+    // 当前窗口与上一个完整窗口
+    PerfHistogram _cur[PERF_STAGE_COUNT];
+    PerfHistogram _last[PERF_STAGE_COUNT];
+    uint32_t _curFrames, _lastFrames;
+    volatile uint32_t _frameSeq;
+    uint64_t _curFramePx, _lastFramePx;
+    uint64_t _curFlushBytes, _lastFlushBytes;
+    int64_t _windowStartUs;
+    int64_t _lastWindowUs;
+
+    bool _serialReport;
+    struct _lv_obj_t *_overlay;
+    volatile bool _overlayToggleRequest;
+    unsigned long _lastOverlayUpdate;
+
+    // 任务运行时间计数，用于计算窗口内的CPU占用
+    struct TaskSample {
+        TaskHandle_t handle;
+        uint32_t runTime;
+    };
+    TaskSample _taskPrev[PERF_MAX_TASKS];
+    uint32_t _taskPrevCount;
+    uint32_t _taskPrevTotal;
+
+    void rollWindow();
+    void printTaskStats();
+    static uint32_t percentile(const PerfHistogram &h, uint32_t permille);
+    static void resetHistogram(PerfHistogram &h);
+};
+
+extern MyPerf perf;
+
+#endif // MY_PERF_H
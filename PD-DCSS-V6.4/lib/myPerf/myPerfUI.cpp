@@ -0,0 +1,72 @@
+/**
+ * @file myPerfUI.cpp
+ * @brief 性能监视的屏幕叠加标签：帧率和主要耗时（LVGL顶层）
+ * @author watermelon6uice
+ * @details
+ * 与 myPerf.cpp 分开，记录和串口汇总部分不依赖LVGL，主机上的限流回路和保护检查可以单独链接。
+ * 只能在LVGL所在的任务中调用。
+ * @date 2025-06-08
+ */
+
+#include "myPerf.h"
+#include <lvgl.h>
+#include "gui_guider.h"
+
+void MyPerf::setOverlayVisible(bool visible) {
+    if (_overlay == NULL) {
+        if (!visible) {
+            return;
+        }
+        // 放在顶层，不受屏幕切换和背景层影响
+        _overlay = lv_label_create(lv_layer_top());
+        lv_obj_set_style_text_font(_overlay, &lv_font_montserratMedium_9, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_text_color(_overlay, lv_color_hex(0xffffff), LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_bg_color(_overlay, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_bg_opa(_overlay, LV_OPA_70, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_set_style_pad_all(_overlay, 2, LV_PART_MAIN | LV_STATE_DEFAULT);
+        lv_obj_align(_overlay, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+        lv_label_set_text(_overlay, "");
+        _lastOverlayUpdate = 0;
+    }
+    if (visible) {
+        lv_obj_clear_flag(_overlay, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(_overlay, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+bool MyPerf::isOverlayVisible() const {
+    return _overlay != NULL && !lv_obj_has_flag(_overlay, LV_OBJ_FLAG_HIDDEN);
+}
+
+void MyPerf::updateOverlay() {
+    if (_overlayToggleRequest) {
+        _overlayToggleRequest = false;
+        setOverlayVisible(!isOverlayVisible());
+    }
+    if (!isOverlayVisible()) {
+        return;
+    }
+    unsigned long now = millis();
+    if (_lastOverlayUpdate != 0 && now - _lastOverlayUpdate < PERF_OVERLAY_INTERVAL) {
+        return;
+    }
+    _lastOverlayUpdate = now;
+
+    // 叠加标签显示当前窗口的实时数据
+    portENTER_CRITICAL(&_mux);
+    PerfHistogram lvgl = _cur[PERF_STAGE_LVGL];
+    PerfHistogram flush = _cur[PERF_STAGE_FLUSH];
+    uint32_t frames = _curFrames;
+    int64_t elapsedUs = esp_timer_get_time() - _windowStartUs;
+    portEXIT_CRITICAL(&_mux);
+
+    float fps = elapsedUs > 0 ? frames * 1000000.0f / elapsedUs : 0.0f;
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.1ffps R%.1f/%.1fms F%.1fms",
+             fps,
+             lvgl.count ? lvgl.sumUs / (float)lvgl.count / 1000.0f : 0.0f,
+             lvgl.count ? lvgl.maxUs / 1000.0f : 0.0f,
+             flush.count ? flush.sumUs / (float)flush.count / 1000.0f : 0.0f);
+    lv_label_set_text(_overlay, buf);
+}
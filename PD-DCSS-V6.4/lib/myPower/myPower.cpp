@@ -0,0 +1,263 @@
+/**
+ * @file myPower.cpp
+ * @brief 电源管理：动态调频和自动轻睡眠，只在需要时按使用者持有锁
+ * @author watermelon6uice
+ * @date 2025-06-14
+ */
+
+#include "myPower.h"
+#include "myHAL.h"
+#include <string.h>
+
+#define LOCK_CPU_MAX (1 << HAL_PM_CPU_MAX)
+#define LOCK_APB_MAX (1 << HAL_PM_APB_MAX)
+#define LOCK_NO_SLEEP (1 << HAL_PM_NO_SLEEP)
+#define LOCK_TYPES 3
+
+MyPower power;
+
+struct ClientSpec {
+    const char *name;        // 报告中的名称
+    const char *lockName;    // esp_pm锁的名称
+    uint8_t locks;
+};
+
+static const ClientSpec CLIENTS[POWER_CLIENT_COUNT] = {
+    {"限流回路", "control", LOCK_CPU_MAX | LOCK_NO_SLEEP},
+    {"ADC连续采样", "adc_stream", LOCK_APB_MAX | LOCK_NO_SLEEP},
+    {"渲染", "render", LOCK_CPU_MAX | LOCK_APB_MAX},
+    {"亮屏", "screen", LOCK_NO_SLEEP},
+};
+
+static const char *const MODE_NAMES[] = {"固定频率", "手动调频", "动态调频", "动态调频和自动轻睡眠"};
+
+MyPower::MyPower() :
+    _mode(POWER_MODE_FIXED),
+    _cpuMaxHolders(0),
+    _noSleepHolders(0),
+    _cpuMaxSince(0),
+    _noSleepSince(0),
+    _startUs(0),
+    _cpuMaxReleasedUs(0),
+    _appliedMhz(0),
+    _changePins(NULL),
+    _changeCount(0)
+{
+    portMUX_TYPE unlocked = portMUX_INITIALIZER_UNLOCKED;
+    _mux = unlocked;
+    memset(_active, 0, sizeof(_active));
+    memset(_since, 0, sizeof(_since));
+    memset(_locks, 0, sizeof(_locks));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+const char *MyPower::clientName(PowerClient client) {
+    return client < POWER_CLIENT_COUNT ? CLIENTS[client].name : "?";
+}
+
+PowerMode MyPower::begin(const uint8_t *wakePins, size_t wakeCount, const uint8_t *changePins,
+                         size_t changeCount) {
+    PowerMode mode = POWER_MODE_FIXED;
+    if (halPmConfigure(POWER_MAX_MHZ, POWER_MIN_MHZ, true)) {
+        mode = POWER_MODE_AUTO_SLEEP;
+    } else if (halPmConfigure(POWER_MAX_MHZ, POWER_MIN_MHZ, false)) {
+        mode = POWER_MODE_DFS;
+    } else if (halCpuSetMhz(POWER_MAX_MHZ)) {
+        mode = POWER_MODE_MANUAL;
+        _appliedMhz = POWER_MAX_MHZ;
+    }
+
+    if (mode == POWER_MODE_DFS || mode == POWER_MODE_AUTO_SLEEP) {
+        for (int c = 0; c < POWER_CLIENT_COUNT; c++) {
+            for (int t = 0; t < LOCK_TYPES; t++) {
+                if (CLIENTS[c].locks & (1 << t)) {
+                    _locks[c][t] = halPmLockCreate((HalPmLockType)t, CLIENTS[c].lockName);
+                }
+            }
+        }
+    }
+    if (mode == POWER_MODE_AUTO_SLEEP) {
+        halPmWakeOnHigh(wakePins, wakeCount);
+        halPmWakeOnChange(changePins, changeCount);
+    }
+
+    portENTER_CRITICAL(&_mux);
+    _mode = mode;
+    _changePins = changePins;
+    _changeCount = changeCount;
+    _startUs = halMicros();
+    memset(&_stats, 0, sizeof(_stats));
+    for (int c = 0; c < POWER_CLIENT_COUNT; c++) {
+        _since[c] = _startUs;
+    }
+    _cpuMaxSince = _startUs;
+    _noSleepSince = _startUs;
+    // 还没有使用者结束过，不需要保持（无符号数相减，启动时刻很小也成立）
+    _cpuMaxReleasedUs = _startUs - (uint64_t)POWER_MANUAL_HOLD_MS * 1000;
+    portEXIT_CRITICAL(&_mux);
+
+    // begin() 之前已经声明的使用者补上锁
+    for (int c = 0; c < POWER_CLIENT_COUNT; c++) {
+        if (!_active[c]) {
+            continue;
+        }
+        for (int t = 0; t < LOCK_TYPES; t++) {
+            halPmLockAcquire(_locks[c][t]);
+        }
+    }
+    // 其他任务还没有运行，直接按当前使用者设置
+    if (mode == POWER_MODE_MANUAL) {
+        _appliedMhz = _cpuMaxHolders > 0 ? POWER_MAX_MHZ : POWER_MIN_MHZ;
+        halCpuSetMhz(_appliedMhz);
+    }
+    Serial.printf("电源管理: %s（%u-%uMHz）\n", MODE_NAMES[mode], POWER_MIN_MHZ, POWER_MAX_MHZ);
+    return mode;
+}
+
+void MyPower::setActive(PowerClient client, bool active) {
+    if (client >= POWER_CLIENT_COUNT) {
+        return;
+    }
+    uint64_t now = halMicros();
+    uint8_t locks = CLIENTS[client].locks;
+
+    portENTER_CRITICAL(&_mux);
+    if (_active[client] == active) {
+        portEXIT_CRITICAL(&_mux);
+        return;
+    }
+    _active[client] = active;
+    if (active) {
+        _since[client] = now;
+        _stats.activations[client]++;
+        if ((locks & LOCK_CPU_MAX) && _cpuMaxHolders++ == 0) {
+            _cpuMaxSince = now;
+        }
+        if ((locks & LOCK_NO_SLEEP) && _noSleepHolders++ == 0) {
+            _noSleepSince = now;
+        }
+    } else {
+        _stats.heldUs[client] += now - _since[client];
+        if ((locks & LOCK_CPU_MAX) && --_cpuMaxHolders == 0) {
+            _stats.cpuMaxUs += now - _cpuMaxSince;
+            _cpuMaxReleasedUs = now;
+        }
+        if ((locks & LOCK_NO_SLEEP) && --_noSleepHolders == 0) {
+            _stats.noSleepUs += now - _noSleepSince;
+        }
+    }
+    // esp_pm的锁在判断状态的同一个临界区内获取/释放（esp_pm_lock_acquire/release 可以在临界区和中断中调用）。
+    // 放在临界区外时，两个任务交错可能先释放后获取，锁一直被持有，CPU停在最高频率
+    PowerMode mode = _mode;
+    if (mode == POWER_MODE_DFS || mode == POWER_MODE_AUTO_SLEEP) {
+        for (int t = 0; t < LOCK_TYPES; t++) {
+            if (active) {
+                halPmLockAcquire(_locks[client][t]);
+            } else {
+                halPmLockRelease(_locks[client][t]);
+            }
+        }
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyPower::update() {
+    if (_mode != POWER_MODE_MANUAL) {
+        return;
+    }
+    uint64_t now = halMicros();
+    portENTER_CRITICAL(&_mux);
+    bool busy = _cpuMaxHolders > 0 || now - _cpuMaxReleasedUs < (uint64_t)POWER_MANUAL_HOLD_MS * 1000;
+    portEXIT_CRITICAL(&_mux);
+    uint32_t want = busy ? POWER_MAX_MHZ : POWER_MIN_MHZ;
+    if (want != _appliedMhz) {
+        halCpuSetMhz(want);
+        _appliedMhz = want;
+    }
+}
+
+void MyPower::rearmWake() {
+    if (_mode == POWER_MODE_AUTO_SLEEP) {
+        halPmWakeOnChange(_changePins, _changeCount);
+    }
+}
+
+void MyPower::recordInputLatency(uint32_t us) {
+    portENTER_CRITICAL(&_mux);
+    _stats.inputs++;
+    _stats.inputUs += us;
+    if (us > _stats.maxInputUs) {
+        _stats.maxInputUs = us;
+    }
+    if (us > POWER_INPUT_BUDGET_US) {
+        _stats.overBudget++;
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyPower::recordTimerWake(uint32_t lateUs) {
+    portENTER_CRITICAL(&_mux);
+    _stats.timerWakes++;
+    _stats.timerLateUs += lateUs;
+    if (lateUs > _stats.maxTimerLateUs) {
+        _stats.maxTimerLateUs = lateUs;
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyPower::stats(PowerStats &out) const {
+    uint64_t now = halMicros();
+    portENTER_CRITICAL(&_mux);
+    out = _stats;
+    // 正在持有的部分算到现在
+    for (int c = 0; c < POWER_CLIENT_COUNT; c++) {
+        if (_active[c]) {
+            out.heldUs[c] += now - _since[c];
+        }
+    }
+    if (_cpuMaxHolders > 0) {
+        out.cpuMaxUs += now - _cpuMaxSince;
+    }
+    if (_noSleepHolders > 0) {
+        out.noSleepUs += now - _noSleepSince;
+    }
+    out.totalUs = now - _startUs;
+    portEXIT_CRITICAL(&_mux);
+}
+
+float MyPower::averageMhz(const PowerStats &st) const {
+    if (_mode == POWER_MODE_FIXED || st.totalUs == 0) {
+        return (float)halCpuMhz();
+    }
+    return (float)(st.cpuMaxUs * POWER_MAX_MHZ + (st.totalUs - st.cpuMaxUs) * POWER_MIN_MHZ) / st.totalUs;
+}
+
+void MyPower::printReport() const {
+    PowerStats st;
+    stats(st);
+    Serial.println("===== 电源管理 =====");
+    Serial.printf("方式: %s  当前CPU频率 %luMHz\n", MODE_NAMES[_mode], (unsigned long)halCpuMhz());
+    if (st.totalUs == 0) {
+        return;
+    }
+    float total = (float)st.totalUs;
+    Serial.println("使用者          次数  持有时间(s)  占比");
+    for (int c = 0; c < POWER_CLIENT_COUNT; c++) {
+        Serial.printf("%-14s %6lu %11.1f %5.1f%%%s\n", CLIENTS[c].name, (unsigned long)st.activations[c],
+                      st.heldUs[c] / 1e6f, st.heldUs[c] * 100.0f / total, _active[c] ? "  *" : "");
+    }
+    Serial.printf("需要最高频率的时间 %.1f%%，平均CPU频率约 %.0fMHz（一直最高为 %uMHz）\n",
+                  st.cpuMaxUs * 100.0f / total, averageMhz(st), POWER_MAX_MHZ);
+    if (_mode == POWER_MODE_AUTO_SLEEP) {
+        Serial.printf("允许自动轻睡眠的时间 %.1f%%\n", (st.totalUs - st.noSleepUs) * 100.0f / total);
+    }
+    if (st.inputs > 0) {
+        Serial.printf("编码器延迟: %lu次  平均 %luus  最长 %luus，超过预算(%uus) %lu次\n", (unsigned long)st.inputs,
+                      (unsigned long)(st.inputUs / st.inputs), (unsigned long)st.maxInputUs, POWER_INPUT_BUDGET_US,
+                      (unsigned long)st.overBudget);
+    }
+    if (st.timerWakes > 0) {
+        Serial.printf("定时唤醒延迟: %lu次  平均 %luus  最长 %luus\n", (unsigned long)st.timerWakes,
+                      (unsigned long)(st.timerLateUs / st.timerWakes), (unsigned long)st.maxTimerLateUs);
+    }
+}
@@ -0,0 +1,137 @@
+/**
+ * @file myPower.h
+ * @brief 电源管理：动态调频和自动轻睡眠，只在需要时按使用者持有锁
+ * @author watermelon6uice
+ * @details
+ * 以前CPU一直以240MHz运行，输出关闭时 MyStateButton 调用 esp_light_sleep_start()
+ * 让整个芯片睡眠，测量和所有任务都停止。
+ *
+ * 现在由本模块配置 esp_pm：没有锁时CPU降到 POWER_MIN_MHZ，空闲时自动轻睡眠
+ * （FreeRTOS无滴答空闲，定时器、halPmWakeOnHigh() 登记的按键和 halPmWakeOnChange() 登记的
+ * 编码器引脚唤醒；编码器引脚按当前电平登记相反电平，编码器任务每次处理后由 rearmWake() 重新登记）。
+ * 各使用者只在真正需要时用 setActive() 声明，本模块换算成对应的锁：
+ * - 限流回路（输出打开时，2ms采样周期）：最高频率、不睡眠；
+ * - ADC连续采样（波形捕获期间，DMA时钟来自APB）：APB最高、不睡眠；
+ * - 渲染（UI任务的 lv_timer_handler 期间，包括SPI刷屏）：最高频率、APB最高；
+ * - 亮屏（背光没有熄灭时，LEDC的PWM在轻睡眠时会停止）：不睡眠。
+ * 输出关闭且熄屏后没有任何锁，测量按 REGULATOR_STANDBY_PERIOD_MS 的低速率继续。
+ *
+ * 固件没有启用电源管理时（Arduino预编译库默认没有 CONFIG_PM_ENABLE），
+ * begin() 改为手动调频：只由UI任务每个周期调用的 update() 设置频率（setCpuFrequencyMhz 不能在
+ * 两个核上同时调用）；有需要最高频率的使用者时设为最高频率，最后一个结束 POWER_MANUAL_HOLD_MS
+ * 之后才设为最低频率，渲染每帧的声明不会每帧切换频率；升频最多晚一个UI周期。
+ * 没有自动轻睡眠。两种方式下都不再让整机睡眠。
+ *
+ * 报告中有各使用者的持有时间、按持有时间计算的平均CPU频率（自动轻睡眠的时间不单独计算，
+ * 平均频率是上限）、编码器从中断到任务处理的延迟（与 POWER_INPUT_BUDGET_US 比较）
+ * 和定时唤醒的延迟（限流任务在低速率测量时每次醒来比预定时间晚多少）。
+ * @date 2025-06-14
+ */
+
+#ifndef MY_POWER_H
+#define MY_POWER_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+
+#define POWER_MAX_MHZ 240
+#define POWER_MIN_MHZ 80                 // 低于80MHz时APB也会降频，SPI和UART的时钟会变
+#define POWER_INPUT_BUDGET_US 5000       // 编码器从中断到任务处理的延迟上限
+#define POWER_MANUAL_HOLD_MS 1000        // 手动调频：没有需要最高频率的使用者持续这么久才降频
+
+enum PowerClient {
+    POWER_CLIENT_CONTROL = 0,    // 限流回路
+    POWER_CLIENT_ADC_STREAM,     // ADC连续采样
+    POWER_CLIENT_RENDER,         // 渲染和刷屏
+    POWER_CLIENT_SCREEN,         // 亮屏
+    POWER_CLIENT_COUNT
+};
+
+enum PowerMode {
+    POWER_MODE_FIXED = 0,        // 未配置，CPU保持启动时的频率
+    POWER_MODE_MANUAL,           // 没有电源管理，手动调频
+    POWER_MODE_DFS,              // esp_pm动态调频，没有自动轻睡眠
+    POWER_MODE_AUTO_SLEEP,       // esp_pm动态调频和自动轻睡眠
+};
+
+struct PowerStats {
+    uint32_t activations[POWER_CLIENT_COUNT];
+    uint64_t heldUs[POWER_CLIENT_COUNT];     // 各使用者的累计持有时间
+    uint64_t cpuMaxUs;                       // 至少有一个需要最高频率的使用者的时间
+    uint64_t noSleepUs;                      // 至少有一个禁止轻睡眠的使用者的时间
+    uint64_t totalUs;                        // begin() 以来的时间
+    uint32_t inputs;                         // 编码器延迟的样本数
+    uint64_t inputUs;
+    uint32_t maxInputUs;
+    uint32_t overBudget;                     // 超过 POWER_INPUT_BUDGET_US 的次数
+    uint32_t timerWakes;                     // 定时唤醒延迟的样本数
+    uint64_t timerLateUs;
+    uint32_t maxTimerLateUs;
+};
+
+class MyPower {
+public:
+    MyPower();
+
+    /**
+     * @brief 配置电源管理，不支持时改为手动调频
+     * @param wakePins 自动轻睡眠时用于唤醒的按键引脚（按下为高电平）
+     * @param changePins 自动轻睡眠时电平改变即唤醒的引脚（编码器），数组要一直有效
+     * @return 实际使用的方式
+     */
+    PowerMode begin(const uint8_t *wakePins, size_t wakeCount, const uint8_t *changePins = NULL,
+                    size_t changeCount = 0);
+    PowerMode mode() const { return _mode; }
+
+    /**
+     * @brief 声明某个使用者开始/结束工作（可重复调用，状态不变时不做任何事）
+     * @note 在任务中调用，不能在中断中调用
+     */
+    void setActive(PowerClient client, bool active);
+    bool isActive(PowerClient client) const { return _active[client]; }
+
+    /**
+     * @brief 手动调频时按使用者设置CPU频率，其他方式下不做任何事
+     * @note 只能由一个任务（UI任务）调用
+     */
+    void update();
+
+    // 按 changePins 当前的电平重新登记唤醒（编码器任务每次处理后调用），没有自动轻睡眠时不做任何事
+    void rearmWake();
+
+    // 当前是否至少有一个需要最高频率的使用者
+    bool needsMaxClock() const { return _cpuMaxHolders > 0; }
+
+    // 编码器从中断到任务处理的延迟
+    void recordInputLatency(uint32_t us);
+    // 定时唤醒比预定时间晚的时间
+    void recordTimerWake(uint32_t lateUs);
+
+    void stats(PowerStats &out) const;
+    // 按持有时间计算的平均CPU频率
+    float averageMhz(const PowerStats &st) const;
+    void printReport() const;
+
+    static const char *clientName(PowerClient client);
+
+private:
+    mutable portMUX_TYPE _mux;
+    PowerMode _mode;
+    bool _active[POWER_CLIENT_COUNT];
+    uint64_t _since[POWER_CLIENT_COUNT];
+    struct HalPmLock *_locks[POWER_CLIENT_COUNT][3];
+    int _cpuMaxHolders;
+    int _noSleepHolders;
+    uint64_t _cpuMaxSince;
+    uint64_t _noSleepSince;
+    uint64_t _startUs;
+    uint64_t _cpuMaxReleasedUs;          // 最后一个需要最高频率的使用者结束的时刻
+    uint32_t _appliedMhz;                // 手动调频时最后设置的频率，只在 begin() 和 update() 中修改
+    const uint8_t *_changePins;
+    size_t _changeCount;
+    PowerStats _stats;
+};
+
+extern MyPower power;
+
+#endif // MY_POWER_H
@@ -0,0 +1,186 @@
+/**
+ * @file myPresets.cpp
+ * @brief 预设M1..M9：电压设定值、限流设定值和保护阈值，一次发布调用，统计从调用到DAC任务写入的时间
+ * @author watermelon6uice
+ * @date 2025-06-14
+ */
+
+#include "myPresets.h"
+#include "myHAL.h"
+#include "mySystemState.h"
+#include <string.h>
+
+MyPresets presets;
+
+MyPresets::MyPresets() :
+    _applyHandler(NULL),
+    _applyCtx(NULL),
+    _selection(0),
+    _lastSlot(0),
+    _pending(false),
+    _pendingVersion(0),
+    _requestUs(0)
+{
+    portMUX_TYPE unlocked = portMUX_INITIALIZER_UNLOCKED;
+    _mux = unlocked;
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void MyPresets::setApplyHandler(PresetApplyHandler handler, void *ctx) {
+    _applyCtx = ctx;
+    _applyHandler = handler;
+}
+
+bool MyPresets::get(int slot, SettingsPreset &out) const {
+    if (slot < 1 || slot > PRESET_COUNT) {
+        return false;
+    }
+    Settings s;
+    settings.get(s);
+    out = s.presets[slot - 1];
+    return out.valid;
+}
+
+bool MyPresets::store(int slot) {
+    if (slot < 1 || slot > PRESET_COUNT) {
+        return false;
+    }
+    SystemState state;
+    systemState.snapshot(state);
+    Settings s;
+    settings.get(s);
+    SettingsPreset p;
+    memset(&p, 0, sizeof(p));
+    p.valid = true;
+    p.uSet = state.dacVoltage;
+    p.iSet = state.iLimit;
+    p.limits = state.limits;
+    if (!MySettings::presetValid(s, p)) {
+        Serial.printf("预设M%d不能保存: %.2fV %.2fA 不在设定范围内或不低于保护阈值\n", slot, p.uSet, p.iSet);
+        return false;
+    }
+    // 只改这一个预设，不把取出的整个记录写回（设置任务可能同时在保存设定值）
+    settings.setPreset(slot, p);
+    portENTER_CRITICAL(&_mux);
+    _stats.stores++;
+    portEXIT_CRITICAL(&_mux);
+    Serial.printf("预设M%d已保存: %.2fV %.2fA  OVP %.2fV OCP %.2fA\n", slot, p.uSet, p.iSet, p.limits.ovpV,
+                  p.limits.ocpA);
+    return true;
+}
+
+bool MyPresets::recall(int slot) {
+    uint64_t t0 = halMicros();
+    Settings s;
+    settings.get(s);
+    if (slot < 1 || slot > PRESET_COUNT || !MySettings::presetValid(s, s.presets[slot - 1])) {
+        portENTER_CRITICAL(&_mux);
+        _stats.rejected++;
+        portEXIT_CRITICAL(&_mux);
+        Serial.printf("预设M%d是空位或不能使用\n", slot);
+        return false;
+    }
+    const SettingsPreset &p = s.presets[slot - 1];
+    SystemState state;
+    systemState.snapshot(state);
+    bool output = state.outputEnabled;
+
+    // 先记下请求时刻再发布，限流回路可能在另一个核心上立即取到新值
+    portENTER_CRITICAL(&_mux);
+    _pending = false;
+    _requestUs = t0;
+    portEXIT_CRITICAL(&_mux);
+    uint32_t version = _applyHandler != NULL ? _applyHandler(p.uSet, p.iSet, p.limits, _applyCtx)
+                                             : systemState.recallSetpoint(p.uSet, p.iSet, p.limits);
+    portENTER_CRITICAL(&_mux);
+    _stats.recalls++;
+    _lastSlot = slot;
+    // 输出关闭时不写DAC，与当前设定相同时版本号不变、没有新的写入，都不计延迟
+    _pendingVersion = version;
+    _pending = output && version != state.groupVersion[SYSSTATE_GROUP_OUTPUT];
+    portEXIT_CRITICAL(&_mux);
+
+    Serial.printf("调用预设M%d: %.2fV %.2fA  OVP %.2fV OCP %.2fA\n", slot, p.uSet, p.iSet, p.limits.ovpV, p.limits.ocpA);
+    return true;
+}
+
+int MyPresets::select(int delta) {
+    portENTER_CRITICAL(&_mux);
+    int slot = _selection;
+    if (slot == 0) {
+        slot = _lastSlot > 0 ? _lastSlot : 1;
+    } else {
+        slot = ((slot - 1 + delta) % PRESET_COUNT + PRESET_COUNT) % PRESET_COUNT + 1;
+    }
+    _selection = slot;
+    portEXIT_CRITICAL(&_mux);
+    return slot;
+}
+
+void MyPresets::selectSlot(int slot) {
+    _selection = slot >= 1 && slot <= PRESET_COUNT ? slot : 0;
+}
+
+int MyPresets::takeSelection() {
+    portENTER_CRITICAL(&_mux);
+    int slot = _selection;
+    _selection = 0;
+    portEXIT_CRITICAL(&_mux);
+    return slot;
+}
+
+void MyPresets::outputApplied(uint32_t version) {
+    // 限流回路每个周期都调用，没有等待的调用时只读一个标志
+    if (!_pending) {
+        return;
+    }
+    uint64_t now = halMicros();
+    portENTER_CRITICAL(&_mux);
+    if (_pending && (int32_t)(version - _pendingVersion) >= 0) {
+        _pending = false;
+        uint64_t us = now - _requestUs;
+        if (us <= PRESETS_PENDING_MAX_MS * 1000ULL) {
+            _stats.measured++;
+            _stats.lastLatencyUs = (uint32_t)us;
+            _stats.totalLatencyUs += us;
+            if (us > _stats.maxLatencyUs) {
+                _stats.maxLatencyUs = (uint32_t)us;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyPresets::onDacApplied(uint32_t tag, void *ctx) {
+    static_cast<MyPresets *>(ctx)->outputApplied(tag);
+}
+
+void MyPresets::stats(PresetStats &out) const {
+    portENTER_CRITICAL(&_mux);
+    out = _stats;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyPresets::printReport() const {
+    Settings s;
+    settings.get(s);
+    PresetStats st;
+    stats(st);
+    Serial.println("===== 预设 =====");
+    for (int i = 0; i < PRESET_COUNT; i++) {
+        const SettingsPreset &p = s.presets[i];
+        if (!p.valid) {
+            Serial.printf("M%d  空\n", i + 1);
+            continue;
+        }
+        Serial.printf("M%d  %.2fV %.2fA  OVP %.2fV OCP %.2fA UVLO %.2fV OPP %.1fW%s\n", i + 1, p.uSet, p.iSet,
+                      p.limits.ovpV, p.limits.ocpA, p.limits.uvloV, p.limits.oppW, i + 1 == _lastSlot ? "  *" : "");
+    }
+    Serial.printf("保存 %lu次  调用 %lu次  拒绝 %lu次\n", (unsigned long)st.stores, (unsigned long)st.recalls,
+                  (unsigned long)st.rejected);
+    if (st.measured > 0) {
+        Serial.printf("从调用到DAC任务写入: 最近 %.2fms  平均 %.2fms  最长 %.2fms（%lu次）\n", st.lastLatencyUs / 1000.0f,
+                      st.totalLatencyUs / 1000.0f / st.measured, st.maxLatencyUs / 1000.0f,
+                      (unsigned long)st.measured);
+    }
+}
@@ -0,0 +1,101 @@
+/**
+ * @file myPresets.h
+ * @brief 预设M1..M9：电压设定值、限流设定值和保护阈值，一次发布调用，统计从调用到DAC任务写入的时间
+ * @author watermelon6uice
+ * @details
+ * 预设保存在设置存储的记录中（Settings::presets，按设置存储的规则合并后延迟写入NVS）。
+ * - 保存（store）：取系统状态中已确认的设定值（DAC目标电压和限流值）和当前的保护阈值；
+ * - 调用（recall）：先检查预设在当前的设定范围内、设定值低于过压和过流阈值，
+ *   然后把设定值、DAC目标电压、限流值和保护阈值在系统状态的一次发布中写入
+ *   （MySystemState::recallSetpoint），限流回路在同一个周期的同一份快照中取到全部新值，
+ *   不会出现新设定值配旧阈值（或反过来）的中间组合。
+ *   登记了 setApplyHandler() 时由它完成这次发布（编码器同时更新自己的设定值和显示）；
+ * - 选择：按住步进按钮旋转编码器时用 select() 在M1..M9之间移动，松开时调用选中的预设，
+ *   按住期间按确认键把当前设定值保存到选中的预设（见main.cpp）；
+ * - 延迟：输出打开时，从 recall() 到DAC任务把限流回路按新设定值算出的电压写入SPI的时间。
+ *   限流回路把快照中输出组的版本号随电压放进DAC队列，DAC任务写入后经 onDacApplied()
+ *   （用 addDACAppliedHandler() 登记）调用 outputApplied()。保存最近一次、平均和最大值。
+ *   输出关闭或保护锁存时调用的预设在输出恢复时才生效，超过 PRESETS_PENDING_MAX_MS 的不计入；
+ *   与当前设定完全相同的预设不改变版本号，不计入。
+ * @date 2025-06-14
+ */
+
+#ifndef MY_PRESETS_H
+#define MY_PRESETS_H
+
+#include <Arduino.h>
+#include "mySettings.h"
+
+#define PRESET_COUNT SETTINGS_PRESET_COUNT
+#define PRESETS_PENDING_MAX_MS 100   // 调用后超过这个时间才写入DAC的不计入延迟统计
+
+struct PresetStats {
+    uint32_t recalls;            // 调用次数
+    uint32_t rejected;           // 空位或不能使用的预设
+    uint32_t stores;             // 保存次数
+    uint32_t measured;           // 计入延迟统计的调用次数
+    uint32_t lastLatencyUs;      // 从调用到DAC任务写入
+    uint32_t maxLatencyUs;
+    uint64_t totalLatencyUs;
+};
+
+// 完成调用的发布，返回发布后系统状态输出组的版本号（见 MySystemState::recallSetpoint）
+typedef uint32_t (*PresetApplyHandler)(float uSet, float iSet, const ProtectionLimits &limits, void *ctx);
+
+class MyPresets {
+public:
+    MyPresets();
+
+    // 登记调用时的发布函数（未登记时直接调用 systemState.recallSetpoint）
+    void setApplyHandler(PresetApplyHandler handler, void *ctx);
+
+    /**
+     * @brief 读取预设
+     * @param slot 1..PRESET_COUNT
+     * @return 编号有效且不是空位时返回true
+     */
+    bool get(int slot, SettingsPreset &out) const;
+
+    /**
+     * @brief 把已确认的设定值和当前的保护阈值保存到预设（按设置存储的规则延迟写入）
+     */
+    bool store(int slot);
+
+    /**
+     * @brief 调用预设：检查后一次发布设定值、限流值和保护阈值（在任务中调用）
+     * @return 空位或预设不能使用时返回false，设定值不变
+     */
+    bool recall(int slot);
+
+    // 选择：delta为编码器的旋转量，第一次从最近调用的预设开始；返回选中的编号
+    int select(int delta);
+    void selectSlot(int slot);
+    int selection() const { return _selection; }
+    // 取出选中的编号并结束选择，没有选择时返回0
+    int takeSelection();
+    // 最近调用的编号，没有调用过时返回0
+    int lastSlot() const { return _lastSlot; }
+
+    // DAC任务写入之后调用，version为限流回路取值的快照中输出组的版本号
+    void outputApplied(uint32_t version);
+    // DacAppliedHandler，ctx为 MyPresets 实例
+    static void onDacApplied(uint32_t tag, void *ctx);
+
+    void stats(PresetStats &out) const;
+    void printReport() const;
+
+private:
+    mutable portMUX_TYPE _mux;
+    PresetApplyHandler _applyHandler;
+    void *_applyCtx;
+    volatile int _selection;
+    int _lastSlot;
+    volatile bool _pending;      // 等DAC任务写入
+    uint32_t _pendingVersion;
+    uint64_t _requestUs;
+    PresetStats _stats;
+};
+
+extern MyPresets presets;
+
+#endif // MY_PRESETS_H
@@ -0,0 +1,131 @@
+/**
+ * @file myPresetsUI.cpp
+ * @brief 预设屏幕：M1..M9的设定值和保护阈值、选择和最近调用的预设、调用到DAC任务写入的延迟
+ * @author watermelon6uice
+ * @details
+ * 屏幕由屏幕表（myScreens）在第一次切换时创建，不缓存，离开时删除。
+ * 每个预设一行：设定值、限流值、OVP/OCP/UVLO/OPP阈值，空位显示EMPTY；
+ * 正在选择的预设高亮，最近调用的预设标*。与主屏幕相同，按住步进按钮旋转选择，
+ * 松开时调用，按住期间按确认键保存（见main.cpp）。保存、调用、选择或设置存储的记录变化时才刷新。
+ * @date 2025-06-14
+ */
+
+#include "myPresetsUI.h"
+#include "myPresets.h"
+#include <string.h>
+
+#define PRESETS_ROW_X 10
+#define PRESETS_ROW_Y 24
+#define PRESETS_ROW_STEP 20
+
+#define PRESETS_BG_COLOR 0x000822
+#define PRESETS_TEXT_COLOR 0xffffff
+#define PRESETS_EMPTY_COLOR 0x646464
+#define PRESETS_SELECT_COLOR 0xcfc300
+
+static lv_obj_t *s_rows[PRESET_COUNT];
+static lv_obj_t *s_latency = NULL;
+
+// 影响显示内容的计数和编号，任何一个变化时刷新
+struct PresetsShown {
+    uint32_t recalls;
+    uint32_t stores;
+    uint32_t measured;
+    uint32_t changes;        // 设置存储的记录被修改的次数（保存的预设在这里）
+    int selection;
+    int lastSlot;
+};
+static PresetsShown s_shown;
+
+static lv_obj_t *createLabel(lv_obj_t *parent, lv_coord_t x, lv_coord_t y) {
+    lv_obj_t *label = lv_label_create(parent);
+    lv_obj_set_style_text_font(label, &lv_font_montserratMedium_9, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(label, lv_color_hex(PRESETS_TEXT_COLOR), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_pos(label, x, y);
+    lv_label_set_text(label, "");
+    return label;
+}
+
+// 屏幕被删除（离开预设屏幕）时清空所有对象指针
+static void screenDeleteCb(lv_event_t *e) {
+    for (uint8_t i = 0; i < PRESET_COUNT; i++) {
+        s_rows[i] = NULL;
+    }
+    s_latency = NULL;
+}
+
+static void current(PresetsShown &out) {
+    PresetStats st;
+    presets.stats(st);
+    SettingsStats ss;
+    settings.stats(ss);
+    out.recalls = st.recalls;
+    out.stores = st.stores;
+    out.measured = st.measured;
+    out.changes = ss.changes;
+    out.selection = presets.selection();
+    out.lastSlot = presets.lastSlot();
+}
+
+static void refresh() {
+    current(s_shown);
+    Settings s;
+    settings.get(s);
+    int selection = s_shown.selection;
+    int last = s_shown.lastSlot;
+    char buf[96];
+    for (uint8_t i = 0; i < PRESET_COUNT; i++) {
+        const SettingsPreset &p = s.presets[i];
+        int slot = i + 1;
+        uint32_t color = PRESETS_TEXT_COLOR;
+        if (slot == selection) {
+            color = PRESETS_SELECT_COLOR;
+        } else if (!p.valid) {
+            color = PRESETS_EMPTY_COLOR;
+        }
+        if (p.valid) {
+            snprintf(buf, sizeof(buf), "M%d%s %5.2fV %4.2fA  OVP %.2fV OCP %.2fA UVLO %.2fV OPP %.1fW", slot,
+                     slot == last ? "*" : " ", p.uSet, p.iSet, p.limits.ovpV, p.limits.ocpA, p.limits.uvloV,
+                     p.limits.oppW);
+        } else {
+            snprintf(buf, sizeof(buf), "M%d%s EMPTY", slot, slot == last ? "*" : " ");
+        }
+        lv_label_set_text(s_rows[i], buf);
+        lv_obj_set_style_text_color(s_rows[i], lv_color_hex(color), LV_PART_MAIN | LV_STATE_DEFAULT);
+    }
+
+    PresetStats st;
+    presets.stats(st);
+    if (st.measured > 0) {
+        lv_label_set_text_fmt(s_latency, "recall -> DAC  last %.2fms  avg %.2fms  max %.2fms  (%lu)",
+                              st.lastLatencyUs / 1000.0f, st.totalLatencyUs / 1000.0f / st.measured,
+                              st.maxLatencyUs / 1000.0f, (unsigned long)st.measured);
+    } else {
+        lv_label_set_text(s_latency, "recall -> DAC  --");
+    }
+}
+
+void buildPresetsScreen(lv_obj_t *screen) {
+    lv_obj_set_style_bg_color(screen, lv_color_hex(PRESETS_BG_COLOR), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(screen, LV_OPA_COVER, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_event_cb(screen, screenDeleteCb, LV_EVENT_DELETE, NULL);
+
+    lv_obj_t *title = createLabel(screen, PRESETS_ROW_X, 6);
+    lv_label_set_text(title, "PRESETS");
+    lv_obj_t *hint = createLabel(screen, PRESETS_ROW_X, 226);
+    lv_label_set_text(hint, "hold step + rotate: select   release: recall   confirm: store");
+    for (uint8_t i = 0; i < PRESET_COUNT; i++) {
+        s_rows[i] = createLabel(screen, PRESETS_ROW_X, PRESETS_ROW_Y + i * PRESETS_ROW_STEP);
+    }
+    s_latency = createLabel(screen, PRESETS_ROW_X, PRESETS_ROW_Y + PRESET_COUNT * PRESETS_ROW_STEP + 4);
+
+    refresh();
+}
+
+void updatePresetsScreen(lv_obj_t *screen) {
+    PresetsShown now;
+    current(now);
+    if (memcmp(&now, &s_shown, sizeof(now)) != 0) {
+        refresh();
+    }
+}
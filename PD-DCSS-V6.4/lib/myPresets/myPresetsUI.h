@@ -0,0 +1,23 @@
+/**
+ * @file myPresetsUI.h
+ * @brief 预设屏幕：M1..M9的设定值和保护阈值、选择和最近调用的预设、调用到DAC任务写入的延迟
+ * @author watermelon6uice
+ * @date 2025-06-14
+ */
+
+#ifndef MY_PRESETS_UI_H
+#define MY_PRESETS_UI_H
+
+#include "lvgl.h"
+#include "myScreens.h"
+
+// 屏幕表的创建函数：在 screen 中创建预设屏幕的控件
+void buildPresetsScreen(lv_obj_t *screen);
+
+/**
+ * @brief 屏幕表的更新函数：保存、调用或选择变化时刷新列表
+ * @note 由 screens.update() 在UI任务中调用，只在预设屏幕显示时调用
+ */
+void updatePresetsScreen(lv_obj_t *screen);
+
+#endif // MY_PRESETS_UI_H
@@ -0,0 +1,127 @@
+/**
+ * @file myProtection.cpp
+ * @brief 输出保护：过压、过流、输入欠压和过功率，触发后立即把DAC写0并锁存告警
+ * @author watermelon6uice
+ * @date 2025-06-13
+ */
+
+#include "myProtection.h"
+#include "myDAC.h"
+#include "mySystemState.h"
+#include "esp_timer.h"
+
+MyProtection protection;
+
+MyProtection::MyProtection() :
+    _limits(protectionDefaultLimits()),
+    _tripped(false),
+    _ackRequested(false),
+    _tripAlarms(0),
+    _tripCount(0),
+    _lastLatencyUs(0),
+    _maxLatencyUs(0),
+    _uvloCount(0),
+    _oppCount(0),
+    _tripUIn(0.0f),
+    _tripUOut(0.0f),
+    _tripIOut(0.0f)
+{
+}
+
+void MyProtection::setLimits(const ProtectionLimits &limits) {
+    _limits = limits;
+}
+
+bool MyProtection::check(const AdcFrame &frame) {
+    if (_tripped) {
+        return true;
+    }
+    float uIn = frame.uIn;
+    float uOut = frame.uOut;
+    float iOut = frame.iOut;
+
+    uint32_t alarms = 0;
+    if (uOut > _limits.ovpV) {
+        alarms |= PROT_ALARM_OVP;
+    }
+    if (iOut > _limits.ocpA) {
+        alarms |= PROT_ALARM_OCP;
+    }
+    _uvloCount = uIn < _limits.uvloV ? _uvloCount + 1 : 0;
+    if (_uvloCount >= PROTECTION_FILTER_SAMPLES) {
+        alarms |= PROT_ALARM_UVLO;
+    }
+    _oppCount = uOut * iOut > _limits.oppW ? _oppCount + 1 : 0;
+    if (_oppCount >= PROTECTION_FILTER_SAMPLES) {
+        alarms |= PROT_ALARM_OPP;
+    }
+
+    if (alarms == 0) {
+        return false;
+    }
+    trip(alarms, uIn, uOut, iOut, frame.timeUs);
+    return true;
+}
+
+void MyProtection::trip(uint32_t alarms, float uIn, float uOut, float iOut, int64_t sampleUs) {
+    // 先关断，再记录；这里不打印，串口输出由界面任务在收到告警变化后进行
+    shutdownDAC();
+    uint32_t latency = (uint32_t)(esp_timer_get_time() - sampleUs);
+
+    _tripped = true;
+    _tripAlarms = alarms;
+    _tripCount++;
+    _lastLatencyUs = latency;
+    if (latency > _maxLatencyUs) {
+        _maxLatencyUs = latency;
+    }
+    _tripUIn = uIn;
+    _tripUOut = uOut;
+    _tripIOut = iOut;
+
+    systemState.setRegulation(SYS_MODE_CV, 0.0f);
+    systemState.raiseAlarm(alarms);
+}
+
+void MyProtection::acknowledge() {
+    if (_tripped) {
+        _ackRequested = true;
+    }
+}
+
+void MyProtection::applyAcknowledge() {
+    if (!_ackRequested) {
+        return;
+    }
+    _ackRequested = false;
+    if (!_tripped) {
+        return;
+    }
+    _uvloCount = 0;
+    _oppCount = 0;
+    systemState.clearAlarm(PROT_ALARM_MASK);
+    releaseDAC();
+    // 最后解除锁存，限流回路看到后从设定值重新开始写DAC
+    _tripped = false;
+}
+
+const char *MyProtection::alarmName(uint32_t alarms) {
+    if (alarms & PROT_ALARM_OVP) return "OVP";
+    if (alarms & PROT_ALARM_OCP) return "OCP";
+    if (alarms & PROT_ALARM_UVLO) return "UVLO";
+    if (alarms & PROT_ALARM_OPP) return "OPP";
+    return "";
+}
+
+void MyProtection::printReport() const {
+    Serial.println("===== 输出保护 =====");
+    Serial.printf("阈值: OVP %.2fV  OCP %.2fA  UVLO %.2fV  OPP %.1fW\n",
+                  _limits.ovpV, _limits.ocpA, _limits.uvloV, _limits.oppW);
+    Serial.printf("状态: %s", _tripped ? "已锁存 " : "正常");
+    if (_tripped) {
+        Serial.printf("%s（Uin %.2fV  Uout %.2fV  Iout %.3fA）", alarmName(_tripAlarms), _tripUIn, _tripUOut, _tripIOut);
+    }
+    Serial.println();
+    Serial.printf("触发次数: %u  触发延迟(采样->DAC写0): 最近 %uus  最大 %uus\n",
+                  _tripCount, _lastLatencyUs, _maxLatencyUs);
+}
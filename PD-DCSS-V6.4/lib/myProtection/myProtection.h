@@ -0,0 +1,109 @@
+/**
+ * @file myProtection.h
+ * @brief 输出保护：过压、过流、输入欠压和过功率，触发后立即把DAC写0并锁存告警
+ * @author watermelon6uice
+ * @details
+ * 由限流回路（myRegulator）在每个采样周期调用 check()，与限流使用同一组快速采样：
+ * - OVP：输出电压超过阈值，OCP：输出电流超过阈值，单个采样即触发；
+ * - UVLO：输入电压低于阈值，OPP：输出功率超过阈值，连续 PROTECTION_FILTER_SAMPLES
+ *   个采样才触发（输入跌落和功率计算受噪声影响较大）；
+ * - 触发时在调用者上下文中直接写DAC（shutdownDAC，不经过DAC任务的队列），
+ *   把告警位写入系统状态并锁存。锁存期间限流回路不再写DAC；
+ * - 用户确认（acknowledge，界面上为确认键）只登记请求，限流任务在下一个周期开始时
+ *   （applyAcknowledge）解除锁存、清零滤波计数，之后从设定值重新开始，如果条件仍然存在会再次触发；
+ *   锁存状态和计数只在限流任务中修改；
+ * - 从读取采样到DAC写0完成的时间记为触发延迟，保存最近一次和最大值。
+ * 阈值保存在系统状态的输出组中（setProtectionLimits()，调用预设时与设定值一起发布），
+ * 限流回路每个周期用同一份快照中的阈值调用 setLimits()，阈值和设定值总是同时生效；
+ * 默认值见 protectionDefaultLimits()。
+ * @date 2025-06-13
+ */
+
+#ifndef MY_PROTECTION_H
+#define MY_PROTECTION_H
+
+#include <Arduino.h>
+#include "myAdcFrame.h"
+
+// 告警位（系统状态 alarms 字段）
+#define PROT_ALARM_OVP  (1u << 0)   // 输出过压
+#define PROT_ALARM_OCP  (1u << 1)   // 输出过流
+#define PROT_ALARM_UVLO (1u << 2)   // 输入欠压
+#define PROT_ALARM_OPP  (1u << 3)   // 输出过功率
+#define PROT_ALARM_MASK (PROT_ALARM_OVP | PROT_ALARM_OCP | PROT_ALARM_UVLO | PROT_ALARM_OPP)
+
+#define PROTECTION_FILTER_SAMPLES 3  // UVLO和OPP需要连续超限的采样数
+
+struct ProtectionLimits {
+    float ovpV;     // 输出过压阈值(V)
+    float ocpA;     // 输出过流阈值(A)，高于限流设定值的上限，用于限流来不及折返的情况
+    float uvloV;    // 输入欠压阈值(V)
+    float oppW;     // 输出过功率阈值(W)
+};
+
+// 默认阈值：设定值上限15V/5A之上留10%余量，输入低于3V视为掉电
+inline ProtectionLimits protectionDefaultLimits() {
+    ProtectionLimits l;
+    l.ovpV = 16.5f;
+    l.ocpA = 5.5f;
+    l.uvloV = 3.0f;
+    l.oppW = 80.0f;
+    return l;
+}
+
+class MyProtection {
+public:
+    MyProtection();
+
+    void setLimits(const ProtectionLimits &limits);
+    ProtectionLimits getLimits() const { return _limits; }
+
+    /**
+     * @brief 检查一个采集帧，超限时立即关断DAC并锁存告警（由限流回路调用）
+     * @param frame 采集帧，其时间戳作为计算触发延迟的起点
+     * @return 已锁存（本次触发或之前触发未确认）时返回true，调用者不得再写DAC
+     */
+    bool check(const AdcFrame &frame);
+
+    /**
+     * @brief 用户确认告警：登记请求，由限流任务在下一个周期开始时解除锁存（可在任意任务中调用）
+     */
+    void acknowledge();
+
+    /**
+     * @brief 处理确认请求：解除锁存、清零滤波计数、清除告警位并恢复DAC写入（由限流回路在周期开始时调用）
+     */
+    void applyAcknowledge();
+
+    bool isTripped() const { return _tripped; }
+    uint32_t getTripAlarms() const { return _tripAlarms; }   // 最近一次触发的告警位
+    uint32_t getTripCount() const { return _tripCount; }
+    uint32_t getLastLatencyUs() const { return _lastLatencyUs; }
+    uint32_t getMaxLatencyUs() const { return _maxLatencyUs; }
+
+    // 告警位对应的简称（OVP/OCP/UVLO/OPP），多个位时返回最低位的
+    static const char *alarmName(uint32_t alarms);
+
+    // 串口输出阈值、锁存状态、触发次数和延迟
+    void printReport() const;
+
+private:
+    ProtectionLimits _limits;
+    volatile bool _tripped;
+    volatile bool _ackRequested;   // 确认请求，限流任务处理后清除
+    uint32_t _tripAlarms;
+    uint32_t _tripCount;
+    uint32_t _lastLatencyUs;
+    uint32_t _maxLatencyUs;
+    uint8_t _uvloCount;      // UVLO连续超限采样数
+    uint8_t _oppCount;       // OPP连续超限采样数
+    float _tripUIn;          // 触发时的采样，供报告使用
+    float _tripUOut;
+    float _tripIOut;
+
+    void trip(uint32_t alarms, float uIn, float uOut, float iOut, int64_t sampleUs);
+};
+
+extern MyProtection protection;
+
+#endif // MY_PROTECTION_H
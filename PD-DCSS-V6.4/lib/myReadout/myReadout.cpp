@@ -0,0 +1,320 @@
+/**
+ * @file myReadout.cpp
+ * @brief 大字号数值读数控件，使用预渲染的数字精灵图（sprite）代替LVGL标签
+ * @author watermelon6uice
+ * @details
+ * 实现要点：
+ * 1. 数字采用等宽排列（格宽 = 最宽数字的advance + 字间距），这样同样位数的两个数值
+ *    每一格的位置都相同，变化时只需重绘变化的那几格；
+ * 2. 精灵图是不透明的RGB565图像，绘制时LVGL走直接拷贝路径；
+ * 3. 控件响应 LV_EVENT_COVER_CHECK，脏区域完全落在数字格内时告诉LVGL
+ *    "此区域已被完全覆盖"，LVGL就不再绘制下面的屏幕背景和半透明边框图片。
+ * @date 2025-06-05
+ */
+
+#include "myReadout.h"
+#include "esp_heap_caps.h"
+
+MyReadout::MyReadout(const lv_font_t *font, lv_color_t fg, lv_color_t bg, lv_coord_t letterSpace) :
+    _font(font),
+    _fg(fg),
+    _bg(bg),
+    _letterSpace(letterSpace),
+    _obj(NULL),
+    _cache(NULL),
+    _cacheBytes(0),
+    _digitCellW(0),
+    _dotCellW(0),
+    _cellH(0),
+    _len(0),
+    _lastDirtyPixels(0)
+{
+    memset(_sprites, 0, sizeof(_sprites));
+    memset(_cellX, 0, sizeof(_cellX));
+    _text[0] = '\0';
+}
+
+MyReadout::~MyReadout() {
+    if (_obj != NULL) {
+        lv_obj_del(_obj);
+    }
+    if (_cache != NULL) {
+        heap_caps_free(_cache);
+    }
+}
+
+int MyReadout::glyphIndex(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c == '.') {
+        return 10;
+    }
+    return -1;
+}
+
+lv_coord_t MyReadout::cellWidth(char c) const {
+    return (c == '.') ? _dotCellW : _digitCellW;
+}
+
+bool MyReadout::begin(lv_obj_t *templateLabel) {
+    if (templateLabel == NULL || _font == NULL || _obj != NULL) {
+        return false;
+    }
+
+    lv_obj_update_layout(templateLabel);
+    lv_coord_t objW = lv_obj_get_width(templateLabel);
+    lv_coord_t objH = lv_obj_get_height(templateLabel);
+
+    // 计算格尺寸：数字取最宽的advance，保证等宽
+    lv_font_glyph_dsc_t g;
+    lv_coord_t maxDigitAdv = 0;
+    for (char c = '0'; c <= '9'; c++) {
+        if (lv_font_get_glyph_dsc(_font, &g, c, 0) && g.adv_w > maxDigitAdv) {
+            maxDigitAdv = g.adv_w;
+        }
+    }
+    lv_coord_t dotAdv = 0;
+    if (lv_font_get_glyph_dsc(_font, &g, '.', 0)) {
+        dotAdv = g.adv_w;
+    }
+    if (maxDigitAdv == 0) {
+        Serial.println("读数控件错误: 字体中没有数字字形");
+        return false;
+    }
+
+    _digitCellW = maxDigitAdv + _letterSpace;
+    _dotCellW = dotAdv + _letterSpace;
+    _cellH = LV_MIN(lv_font_get_line_height(_font), objH);
+
+    // 一次性分配全部精灵图，优先PSRAM
+    size_t digitPixels = (size_t)_digitCellW * _cellH;
+    size_t dotPixels = (size_t)_dotCellW * _cellH;
+    _cacheBytes = (digitPixels * 10 + dotPixels) * sizeof(lv_color_t);
+    _cache = (lv_color_t *)heap_caps_malloc(_cacheBytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    bool inPsram = (_cache != NULL);
+    if (_cache == NULL) {
+        _cache = (lv_color_t *)heap_caps_malloc(_cacheBytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    if (_cache == NULL) {
+        Serial.println("读数控件错误: 无法分配精灵图缓存，继续使用标签显示");
+        _cacheBytes = 0;
+        return false;
+    }
+
+    lv_color_t *dst = _cache;
+    for (int i = 0; i < READOUT_GLYPH_COUNT; i++) {
+        char c = (i < 10) ? ('0' + i) : '.';
+        lv_coord_t w = cellWidth(c);
+
+        renderGlyph(c, dst, w, _cellH);
+
+        _sprites[i].header.always_zero = 0;
+        _sprites[i].header.cf = LV_IMG_CF_TRUE_COLOR;
+        _sprites[i].header.w = w;
+        _sprites[i].header.h = _cellH;
+        _sprites[i].data_size = (uint32_t)w * _cellH * sizeof(lv_color_t);
+        _sprites[i].data = (const uint8_t *)dst;
+
+        dst += (size_t)w * _cellH;
+    }
+
+    // 在模板标签的位置创建一个不带任何样式的对象，由本类负责绘制
+    _obj = lv_obj_create(lv_obj_get_parent(templateLabel));
+    lv_obj_remove_style_all(_obj);
+    lv_obj_clear_flag(_obj, LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_pos(_obj, lv_obj_get_x(templateLabel), lv_obj_get_y(templateLabel));
+    lv_obj_set_size(_obj, objW, objH);
+    lv_obj_move_to_index(_obj, lv_obj_get_index(templateLabel));
+    lv_obj_add_event_cb(_obj, eventCb, LV_EVENT_ALL, this);
+
+    // 沿用标签当前的文本，然后隐藏标签
+    setText(lv_label_get_text(templateLabel));
+    lv_obj_add_flag(templateLabel, LV_OBJ_FLAG_HIDDEN);
+
+    Serial.printf("读数控件已创建: 格宽=%d/%d, 格高=%d, 缓存=%u字节 (%s)\n",
+                  _digitCellW, _dotCellW, _cellH, (unsigned)_cacheBytes,
+                  inPsram ? "PSRAM" : "内部RAM");
+    return true;
+}
+
+void MyReadout::renderGlyph(uint32_t letter, lv_color_t *dst, lv_coord_t w, lv_coord_t h) {
+    // 先填充背景色
+    for (size_t i = 0; i < (size_t)w * h; i++) {
+        dst[i] = _bg;
+    }
+
+    lv_font_glyph_dsc_t g;
+    if (!lv_font_get_glyph_dsc(_font, &g, letter, 0) || g.box_w == 0 || g.box_h == 0) {
+        return;
+    }
+    const uint8_t *bmp = lv_font_get_glyph_bitmap(_font, letter);
+    if (bmp == NULL) {
+        return;
+    }
+
+    // 字形在格内水平居中（等宽排列），垂直位置与 lv_draw_letter 的计算方式一致
+    lv_coord_t advW = w - _letterSpace;
+    lv_coord_t x0 = (advW - (lv_coord_t)g.adv_w) / 2 + g.ofs_x;
+    lv_coord_t y0 = (_font->line_height - _font->base_line) - g.box_h - g.ofs_y;
+
+    // 字形位图按行连续打包，高位在前，每像素bpp位
+    uint8_t bpp = g.bpp;
+    uint8_t mask = (uint8_t)((1 << bpp) - 1);
+    for (lv_coord_t y = 0; y < g.box_h; y++) {
+        lv_coord_t py = y0 + y;
+        if (py < 0 || py >= h) {
+            continue;
+        }
+        for (lv_coord_t x = 0; x < g.box_w; x++) {
+            lv_coord_t px = x0 + x;
+            if (px < 0 || px >= w) {
+                continue;
+            }
+            uint32_t bit = ((uint32_t)y * g.box_w + x) * bpp;
+            uint8_t v = (bmp[bit >> 3] >> (8 - bpp - (bit & 7))) & mask;
+            if (v == 0) {
+                continue;
+            }
+            lv_opa_t opa = (lv_opa_t)((v * 255) / mask);
+            dst[(size_t)py * w + px] = lv_color_mix(_fg, _bg, opa);
+        }
+    }
+}
+
+void MyReadout::layout(const char *text, uint8_t len, lv_coord_t *cellX) const {
+    lv_coord_t total = 0;
+    for (uint8_t i = 0; i < len; i++) {
+        total += cellWidth(text[i]);
+    }
+    // 与原标签一样居中，最后一格的字间距不计入宽度
+    if (len > 0) {
+        total -= _letterSpace;
+    }
+
+    lv_coord_t x = (lv_obj_get_width(_obj) - total) / 2;
+    for (uint8_t i = 0; i < len; i++) {
+        cellX[i] = x;
+        x += cellWidth(text[i]);
+    }
+}
+
+void MyReadout::invalidateCell(lv_coord_t x, lv_coord_t w) {
+    lv_area_t area;
+    lv_obj_get_coords(_obj, &area);
+    area.x1 += x;
+    area.x2 = area.x1 + w - 1;
+    area.y2 = area.y1 + _cellH - 1;
+    lv_obj_invalidate_area(_obj, &area);
+    _lastDirtyPixels += (uint32_t)w * _cellH;
+}
+
+void MyReadout::setText(const char *text) {
+    if (_obj == NULL || text == NULL) {
+        return;
+    }
+
+    uint8_t len = (uint8_t)strnlen(text, READOUT_MAX_CHARS);
+    if (len == _len && memcmp(text, _text, len) == 0) {
+        _lastDirtyPixels = 0;
+        return;
+    }
+
+    lv_coord_t newX[READOUT_MAX_CHARS];
+    layout(text, len, newX);
+
+    // 排版是否不变：长度相同且每格位置相同（即小数点位置相同）
+    bool sameLayout = (len == _len) && memcmp(newX, _cellX, len * sizeof(lv_coord_t)) == 0;
+
+    _lastDirtyPixels = 0;
+    if (sameLayout) {
+        // 只使变化的格失效
+        for (uint8_t i = 0; i < len; i++) {
+            if (text[i] != _text[i]) {
+                invalidateCell(newX[i], cellWidth(text[i]));
+            }
+        }
+    } else {
+        // 位数或小数点位置变化，使新旧文本覆盖的整个范围失效
+        lv_coord_t x1 = lv_obj_get_width(_obj);
+        lv_coord_t x2 = 0;
+        if (_len > 0) {
+            x1 = LV_MIN(x1, _cellX[0]);
+            x2 = LV_MAX(x2, _cellX[_len - 1] + cellWidth(_text[_len - 1]));
+        }
+        if (len > 0) {
+            x1 = LV_MIN(x1, newX[0]);
+            x2 = LV_MAX(x2, newX[len - 1] + cellWidth(text[len - 1]));
+        }
+        if (x2 > x1) {
+            invalidateCell(x1, x2 - x1);
+        }
+    }
+
+    memcpy(_text, text, len);
+    _text[len] = '\0';
+    memcpy(_cellX, newX, len * sizeof(lv_coord_t));
+    _len = len;
+}
+
+bool MyReadout::covers(const lv_area_t *area) const {
+    if (_len == 0) {
+        return false;
+    }
+
+    // 所有字符格连续排列且都是不透明绘制，覆盖范围为 [第一格左边, 最后一格右边]
+    lv_area_t cells;
+    lv_obj_get_coords(_obj, &cells);
+    lv_coord_t left = cells.x1;
+    cells.x1 = left + _cellX[0];
+    cells.x2 = left + _cellX[_len - 1] + cellWidth(_text[_len - 1]) - 1;
+    cells.y2 = cells.y1 + _cellH - 1;
+    return _lv_area_is_in(area, &cells, 0);
+}
+
+void MyReadout::draw(lv_draw_ctx_t *drawCtx) {
+    lv_area_t coords;
+    lv_obj_get_coords(_obj, &coords);
+
+    lv_draw_img_dsc_t imgDsc;
+    lv_draw_img_dsc_init(&imgDsc);
+
+    lv_draw_rect_dsc_t blankDsc;
+    lv_draw_rect_dsc_init(&blankDsc);
+    blankDsc.bg_color = _bg;
+    blankDsc.bg_opa = LV_OPA_COVER;
+
+    for (uint8_t i = 0; i < _len; i++) {
+        lv_area_t cell;
+        cell.x1 = coords.x1 + _cellX[i];
+        cell.y1 = coords.y1;
+        cell.x2 = cell.x1 + cellWidth(_text[i]) - 1;
+        cell.y2 = cell.y1 + _cellH - 1;
+
+        int idx = glyphIndex(_text[i]);
+        if (idx >= 0) {
+            lv_draw_img(drawCtx, &imgDsc, &cell, &_sprites[idx]);
+        } else {
+            // 空格也要不透明填充，保证覆盖检查成立
+            lv_draw_rect(drawCtx, &blankDsc, &cell);
+        }
+    }
+}
+
+void MyReadout::eventCb(lv_event_t *e) {
+    MyReadout *self = static_cast<MyReadout *>(lv_event_get_user_data(e));
+    lv_event_code_t code = lv_event_get_code(e);
+
+    if (code == LV_EVENT_DRAW_MAIN) {
+        self->draw(lv_event_get_draw_ctx(e));
+    } else if (code == LV_EVENT_COVER_CHECK) {
+        // 基类因 bg_opa=0 已判定为NOT_COVER，lv_event_set_cover_res 只接受"更弱"的结果，
+        // 所以这里直接改写检查结果；带遮罩（MASKED）的情况保持不变
+        lv_cover_check_info_t *info = (lv_cover_check_info_t *)lv_event_get_param(e);
+        if (info->res != LV_COVER_RES_MASKED && self->covers(info->area)) {
+            info->res = LV_COVER_RES_COVER;
+        }
+    } else if (code == LV_EVENT_DELETE) {
+        self->_obj = NULL;
+    }
+}
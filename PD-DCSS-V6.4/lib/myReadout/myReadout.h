@@ -0,0 +1,103 @@
+/**
+ * @file myReadout.h
+ * @brief 大字号数值读数控件，使用预渲染的数字精灵图（sprite）代替LVGL标签
+ * @author watermelon6uice
+ * @details
+ * screen_Uout / screen_Iout / screen_Pout 使用55px、4bpp的抗锯齿字体显示，
+ * 每次数值变化时LVGL都要对整个标签重新栅格化字形并与背景做alpha混合。
+ * 本控件在启动时把 '0'-'9' 和 '.' 共11个字形与已知背景色预先混合成RGB565精灵图
+ * （优先放在PSRAM，失败时退回内部RAM），数值变化时只使相应变化的数字格失效，
+ * 重绘时直接拷贝不透明的精灵图，不再需要字形栅格化和混合。
+ * @date 2025-06-05
+ */
+
+#ifndef MY_READOUT_H
+#define MY_READOUT_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+
+// 最多显示的字符数（例如 "100.00"）
+#define READOUT_MAX_CHARS 7
+
+// 精灵图数量：'0'-'9' 加 '.'
+#define READOUT_GLYPH_COUNT 11
+
+class MyReadout {
+public:
+    /**
+     * @brief 构造函数
+     * @param font 使用的字体（与被替换的标签一致）
+     * @param fg 文字颜色
+     * @param bg 预混合使用的背景色
+     * @param letterSpace 字间距，与标签的 text_letter_space 一致
+     */
+    MyReadout(const lv_font_t *font, lv_color_t fg, lv_color_t bg, lv_coord_t letterSpace);
+
+    ~MyReadout();
+
+    /**
+     * @brief 生成精灵图缓存，并在模板标签的位置创建读数控件
+     * @param templateLabel 被替换的标签，创建后会被隐藏
+     * @return 成功返回true；内存不足时返回false，此时标签保持原样
+     */
+    bool begin(lv_obj_t *templateLabel);
+
+    /**
+     * @brief 设置显示文本，只使发生变化的数字格失效
+     * @param text 只支持数字、'.' 和空格，其他字符按空格处理
+     */
+    void setText(const char *text);
+
+    /**
+     * @brief 获取控件对象（begin之前为NULL）
+     */
+    lv_obj_t *getObj() const { return _obj; }
+
+    /**
+     * @brief 上一次setText使之失效的像素数，用于性能对比
+     */
+    uint32_t getLastDirtyPixels() const { return _lastDirtyPixels; }
+
+    /**
+     * @brief 精灵图缓存占用的字节数
+     */
+    size_t getCacheBytes() const { return _cacheBytes; }
+
+private:
+    const lv_font_t *_font;
+    lv_color_t _fg;
+    lv_color_t _bg;
+    lv_coord_t _letterSpace;
+
+    lv_obj_t *_obj;
+    lv_color_t *_cache;               // 所有精灵图的连续缓存
+    size_t _cacheBytes;
+    lv_img_dsc_t _sprites[READOUT_GLYPH_COUNT];
+    lv_coord_t _digitCellW;           // 数字格宽度（等宽排列，包含字间距）
+    lv_coord_t _dotCellW;             // 小数点格宽度（包含字间距）
+    lv_coord_t _cellH;                // 格高度（裁剪到控件高度）
+
+    char _text[READOUT_MAX_CHARS + 1];
+    lv_coord_t _cellX[READOUT_MAX_CHARS]; // 每个字符格相对控件左边的偏移
+    uint8_t _len;
+    uint32_t _lastDirtyPixels;
+
+    // 字符到精灵图索引，空格等返回-1
+    static int glyphIndex(char c);
+    lv_coord_t cellWidth(char c) const;
+
+    // 根据文本计算每格位置（居中对齐，与原标签一致）
+    void layout(const char *text, uint8_t len, lv_coord_t *cellX) const;
+
+    // 把单个字形渲染进精灵图
+    void renderGlyph(uint32_t letter, lv_color_t *dst, lv_coord_t w, lv_coord_t h);
+
+    void invalidateCell(lv_coord_t x, lv_coord_t w);
+
+    static void eventCb(lv_event_t *e);
+    void draw(lv_draw_ctx_t *drawCtx);
+    bool covers(const lv_area_t *area) const;
+};
+
+#endif // MY_READOUT_H
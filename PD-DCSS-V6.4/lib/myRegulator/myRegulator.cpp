@@ -0,0 +1,183 @@
+/**
+ * @file myRegulator.cpp
+ * @brief 限流回路：快速采样输出电流，超过限流值时折返DAC输出，实现恒压/恒流自动切换
+ * @author watermelon6uice
+ * @date 2025-06-13
+ */
+
+#include "myRegulator.h"
+#include "myDAC.h"
+#include "myPerf.h"
+#include "myPower.h"
+#include "myHAL.h"
+#include "myProtection.h"
+#include "myStandby.h"
+#include "myTaskTable.h"
+
+#define REGULATOR_DAC_LSB (DAC_MAX_VOLTAGE / DAC_MAX_VALUE)
+
+MyRegulator regulator;
+
+MyRegulator::MyRegulator() :
+    _read(NULL),
+    _readCtx(NULL),
+    _command(0.0f),
+    _lastSent(-1.0f),
+    _lastSendMs(0),
+    _lastSentVersion(0),
+    _mode(SYS_MODE_CV),
+    _enabled(false),
+    _standby(false),
+    _task(NULL),
+    _frameCallbackCount(0)
+{
+}
+
+void MyRegulator::begin(AdcFrameReader read, void *ctx) {
+    _readCtx = ctx;
+    _read = read;
+    if (taskTableCreate(taskEntry, "Regulator", this, &_task) != pdPASS) {
+        Serial.println("错误: 无法创建限流任务");
+        return;
+    }
+    standby.setControlTask(_task);
+}
+
+void MyRegulator::taskEntry(void *param) {
+    MyRegulator *self = static_cast<MyRegulator *>(param);
+    TickType_t lastWake = xTaskGetTickCount();
+    while (true) {
+        bool active = systemState.isOutputEnabled();
+        power.setActive(POWER_CLIENT_CONTROL, active);
+        self->step();
+        if (active) {
+            vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(REGULATOR_PERIOD_MS));
+            continue;
+        }
+        // 待机：低速率运行，恢复输出时由 MyStandby::resume() 的通知立即唤醒；
+        // 按时醒来时与预定时间比较（提前不到一个节拍的按0计）
+        uint64_t due = halMicros() + REGULATOR_STANDBY_PERIOD_MS * 1000ULL;
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(REGULATOR_STANDBY_PERIOD_MS)) == 0) {
+            uint64_t now = halMicros();
+            power.recordTimerWake(now > due ? (uint32_t)(now - due) : 0);
+        }
+        lastWake = xTaskGetTickCount();
+    }
+}
+
+void MyRegulator::step() {
+    // 界面确认的告警在这里解除，锁存和滤波计数只在本任务中修改
+    protection.applyAcknowledge();
+    SystemState s;
+    systemState.snapshot(s);
+    if (_read == NULL) {
+        return;
+    }
+    // 保护阈值和设定值取自同一份快照，调用预设时两者在同一个周期生效
+    protection.setLimits(s.limits);
+    AdcFrame frame;
+    if (!s.outputEnabled) {
+        if (!_standby) {
+            // 进入待机：直接把DAC写0并丢弃队列中的值，恢复输出时解除
+            shutdownDAC();
+            _standby = true;
+            _enabled = false;
+        }
+        // 待机时保护照常检查（输入欠压、DAC关断后输出仍有电压等），采集帧只交给要求待机帧的使用者
+        _read(frame, _readCtx);
+        protection.check(frame);
+        standby.outputOff();
+        for (int i = 0; i < _frameCallbackCount; i++) {
+            if (_frameCallbacks[i].standby) {
+                _frameCallbacks[i].fn(frame, _frameCallbacks[i].ctx);
+            }
+        }
+        return;
+    }
+    if (_standby) {
+        _standby = false;
+        releaseDAC();
+    }
+    if (!_enabled) {
+        // 输出刚打开，从设定值开始，并立即写一次DAC
+        _enabled = true;
+        _command = s.dacVoltage;
+        _mode = SYS_MODE_CV;
+        _lastSent = -1.0f;
+    }
+
+    _read(frame, _readCtx);
+    bool tripped = protection.check(frame);
+    // 从待机恢复：在写DAC之前登记，DAC任务写入后结束；保护锁存时DAC保持0V，不计恢复用时
+    if (standby.isStandby()) {
+        standby.outputOn(!tripped);
+    }
+    // 保护触发或锁存时DAC已被写0；确认后按刚打开输出处理，从设定值重新开始
+    if (tripped) {
+        _enabled = false;
+    } else {
+        regulate(s, frame.iOut);
+    }
+    perf.record(PERF_STAGE_REGULATOR, frame.timeUs);
+
+    // 采集帧交给登记的使用者（能量累计等）
+    for (int i = 0; i < _frameCallbackCount; i++) {
+        _frameCallbacks[i].fn(frame, _frameCallbacks[i].ctx);
+    }
+}
+
+bool MyRegulator::addFrameCallback(AdcFrameCallback fn, void *ctx, bool standby) {
+    if (_frameCallbackCount >= REGULATOR_MAX_FRAME_CALLBACKS) {
+        Serial.println("错误: 采集帧回调数量已达上限");
+        return false;
+    }
+    _frameCallbacks[_frameCallbackCount].fn = fn;
+    _frameCallbacks[_frameCallbackCount].ctx = ctx;
+    _frameCallbacks[_frameCallbackCount].standby = standby;
+    _frameCallbackCount++;
+    return true;
+}
+
+void MyRegulator::regulate(const SystemState &s, float iOut) {
+    float target = s.dacVoltage;
+
+    if (s.iLimit > 0.0f && iOut > s.iLimit) {
+        // 折返：电阻性负载下电流与电压成正比，按比例一步缩到限流点
+        _command = _command * s.iLimit / iOut;
+        _mode = SYS_MODE_CC;
+    } else if (_mode == SYS_MODE_CC) {
+        // 电流有余量，逐步抬高输出，回到设定值后恢复恒压
+        float rise = REGULATOR_RECOVER_GAIN * (s.iLimit - iOut);
+        _command += rise < REGULATOR_MAX_RISE_V ? rise : REGULATOR_MAX_RISE_V;
+        if (_command >= target) {
+            _mode = SYS_MODE_CV;
+        }
+    } else {
+        _command = target;
+    }
+    // 设定值可能在恒流时被调低
+    if (_command > target) {
+        _command = target;
+    }
+    if (_command < 0.0f) {
+        _command = 0.0f;
+    }
+
+    systemState.setRegulation(_mode, _command);
+    send(_command, s.groupVersion[SYSSTATE_GROUP_OUTPUT]);
+}
+
+void MyRegulator::send(float voltage, uint32_t version) {
+    // 变化不到半个DAC分辨率时不写，但定期重发，防止队列满时丢失的值一直不生效；
+    // 输出组有新的发布时总是写一次，DAC任务写入后带着版本号报告（预设调用的延迟到此为止）
+    uint32_t now = millis();
+    bool changed = _lastSent < 0.0f || fabsf(voltage - _lastSent) >= REGULATOR_DAC_LSB / 2 ||
+                   version != _lastSentVersion;
+    if (!changed && now - _lastSendMs < REGULATOR_REFRESH_MS) {
+        return;
+    }
+    setDACVoltage(voltage, version);
+    _lastSent = voltage;
+    _lastSendMs = now;
+    _lastSentVersion = version;
+}
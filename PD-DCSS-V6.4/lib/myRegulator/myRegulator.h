@@ -0,0 +1,100 @@
+/**
+ * @file myRegulator.h
+ * @brief 限流回路：快速采样输出电流，超过限流值时折返DAC输出，实现恒压/恒流自动切换
+ * @author watermelon6uice
+ * @details
+ * 显示用的测量值每500ms才更新一次（多次采样平均），用来限流太慢。本模块的任务每
+ * REGULATOR_PERIOD_MS 毫秒读取一个采集帧（MyADC::readFrame，四个通道各转换一次），
+ * 先交给输出保护（myProtection）检查（阈值取自同一份快照），保护锁存期间不写DAC；
+ * 并且是DAC的唯一写入者（代替原来main.cpp中每100ms写一次的DAC更新任务）：
+ * - 恒压：DAC输出等于已确认的设定值（系统状态中的 dacVoltage）；
+ * - 输出电流超过限流值（iLimit）：按 iLimit/iOut 的比例一次缩小DAC输出
+ *   （电阻性负载下一个采样周期即回到限流点），进入恒流；
+ * - 恒流时电流低于限流值：按余量逐步抬高DAC输出，回到设定值后恢复恒压。
+ * 实际DAC输出和模式发布到系统状态的模式组，界面据此显示CV/CC。
+ * 输出关闭（待机，见 myStandby）时直接把DAC写0（shutdownDAC），重新打开时解除并从设定值开始。
+ * 只有输出打开时按 REGULATOR_PERIOD_MS 运行并向电源管理声明限流回路（最高频率、不睡眠）；
+ * 待机时改为每 REGULATOR_STANDBY_PERIOD_MS 读取一个采集帧交给输出保护，其余时间CPU可以降频或轻睡眠，
+ * 每次醒来比预定时间晚多少记入电源管理的定时唤醒延迟；恢复输出时由任务通知立即唤醒。
+ * 每个采集帧最后交给 addFrameCallback() 登记的使用者（能量累计等），它们在本任务中运行，
+ * 必须很快返回；待机时采集帧只交给保护和登记时要求待机帧的使用者（输入掉电检测等）。
+ * @date 2025-06-13
+ */
+
+#ifndef MY_REGULATOR_H
+#define MY_REGULATOR_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "mySystemState.h"
+#include "myAdcFrame.h"
+
+#define REGULATOR_PERIOD_MS 2           // 采样周期
+#define REGULATOR_STANDBY_PERIOD_MS 20  // 待机时的采样周期（保护检查）
+#define REGULATOR_RECOVER_GAIN 0.5f     // 恒流时每个周期按电流余量抬高输出(V/A)
+#define REGULATOR_MAX_RISE_V 0.05f      // 恒流时每个周期最多抬高的电压(V)
+#define REGULATOR_REFRESH_MS 100        // 输出不变时也按此周期重发一次DAC值
+#define REGULATOR_MAX_FRAME_CALLBACKS 4 // 采集帧回调数量上限
+
+// 读取一个采集帧（固件中为 MyADC::frameSource），在限流任务中调用
+typedef void (*AdcFrameReader)(AdcFrame &frame, void *ctx);
+
+// 采集帧回调，在限流任务中调用
+typedef void (*AdcFrameCallback)(const AdcFrame &frame, void *ctx);
+
+class MyRegulator {
+public:
+    MyRegulator();
+
+    /**
+     * @brief 创建限流任务（优先级和核心见任务表中的 Regulator 条目）
+     * @param read 快速读取一个采集帧（输出电压和电流等），本模块不直接依赖 MyADC，
+     *        主机上的保护和限流检查可以不带界面单独链接
+     * @param ctx 传给 read 的参数
+     */
+    void begin(AdcFrameReader read, void *ctx);
+
+    /**
+     * @brief 执行一个采样周期：读取输出、更新DAC输出和模式（由任务周期调用）
+     */
+    void step();
+
+    /**
+     * @brief 登记采集帧回调（在 begin() 之前或任务运行前调用）
+     * @param standby 为true时待机期间的采集帧（每 REGULATOR_STANDBY_PERIOD_MS 一帧）也交给它
+     * @return 数量已达上限时返回false
+     */
+    bool addFrameCallback(AdcFrameCallback fn, void *ctx, bool standby = false);
+
+    SysMode getMode() const { return _mode; }
+    float getCommand() const { return _command; }
+
+private:
+    AdcFrameReader _read;
+    void *_readCtx;
+    float _command;          // 当前DAC输出电压
+    float _lastSent;         // 上次写入DAC的电压，小于0表示需要重发
+    uint32_t _lastSendMs;
+    uint32_t _lastSentVersion;  // 上次写入时快照中输出组的版本号，随DAC写入报告给 addDACAppliedHandler()
+    SysMode _mode;
+    bool _enabled;           // 上个周期输出是否打开
+    bool _standby;           // 待机中，DAC已关断
+    TaskHandle_t _task;
+
+    struct FrameCallback {
+        AdcFrameCallback fn;
+        void *ctx;
+        bool standby;
+    };
+    FrameCallback _frameCallbacks[REGULATOR_MAX_FRAME_CALLBACKS];
+    int _frameCallbackCount;
+
+    void regulate(const SystemState &s, float iOut);
+    void send(float voltage, uint32_t version);
+    static void taskEntry(void *param);
+};
+
+extern MyRegulator regulator;
+
+#endif // MY_REGULATOR_H
@@ -0,0 +1,308 @@
+/**
+ * @file myScreens.cpp
+ * @brief 声明式屏幕表：各屏幕按需创建、空闲时预加载、在内存预算内缓存，并记录创建耗时和内存
+ * @author watermelon6uice
+ * @date 2025-06-13
+ */
+
+#include "myScreens.h"
+#include "myHAL.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+
+MyScreens screens;
+
+MyScreens::MyScreens() :
+    _table(NULL),
+    _count(0),
+    _ui(NULL),
+    _showSeq(0),
+    _budget(0),
+    _installMs(0),
+    _active(0),
+    _loadDel(false),
+    _pendingScreen(-1),
+    _pendingStep(0),
+    _pendingKey(-1)
+{
+    portMUX_TYPE unlocked = portMUX_INITIALIZER_UNLOCKED;
+    _mux = unlocked;
+    memset(_root, 0, sizeof(_root));
+    memset(_stats, 0, sizeof(_stats));
+    memset(_lastShown, 0, sizeof(_lastShown));
+}
+
+bool MyScreens::install(const ScreenSpec *table, size_t count, lv_ui *ui) {
+    bool ok = true;
+    if (count > SCREEN_MAX) {
+        Serial.printf("屏幕表错误: %u个屏幕，最多%d个\n", (unsigned)count, SCREEN_MAX);
+        count = SCREEN_MAX;
+        ok = false;
+    }
+    if (count == 0 || !(table[0].flags & SCREEN_RESIDENT) || (table[0].flags & SCREEN_HIDDEN)) {
+        Serial.println("屏幕表错误: 第0项必须是常驻、不隐藏的主屏幕");
+        ok = false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!(table[i].flags & SCREEN_RESIDENT) && table[i].build == NULL) {
+            Serial.printf("屏幕表错误: %s 没有创建函数\n", table[i].name);
+            ok = false;
+        }
+        for (size_t j = 0; j < i; j++) {
+            if (strcmp(table[i].name, table[j].name) == 0) {
+                Serial.printf("屏幕表错误: 屏幕名 %s 重复\n", table[i].name);
+                ok = false;
+            }
+        }
+    }
+    _table = table;
+    _count = count;
+    _ui = ui;
+    _active = 0;
+    _installMs = (uint32_t)(halMicros() / 1000);
+    return ok;
+}
+
+void MyScreens::adopt(const char *name, lv_obj_t *root, uint32_t buildUs, int32_t bytes) {
+    int index = find(name);
+    if (index < 0 || !(_table[index].flags & SCREEN_RESIDENT)) {
+        Serial.printf("屏幕表错误: %s 不是常驻屏幕\n", name);
+        return;
+    }
+    _root[index] = root;
+    ScreenStats &st = _stats[index];
+    st.built = true;
+    st.builds = 1;
+    st.lastBuildUs = buildUs;
+    st.maxBuildUs = buildUs;
+    st.bytes = bytes;
+}
+
+int MyScreens::find(const char *name) const {
+    for (size_t i = 0; i < _count; i++) {
+        if (strcmp(_table[i].name, name) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+bool MyScreens::isActive(const char *name) const {
+    int index = find(name);
+    return index >= 0 && index == _active;
+}
+
+bool MyScreens::request(const char *name) {
+    int index = find(name);
+    if (index < 0) {
+        return false;
+    }
+    portENTER_CRITICAL(&_mux);
+    _pendingScreen = index;
+    _pendingStep = 0;
+    portEXIT_CRITICAL(&_mux);
+    return true;
+}
+
+void MyScreens::requestHome() {
+    portENTER_CRITICAL(&_mux);
+    _pendingScreen = 0;
+    _pendingStep = 0;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyScreens::requestStep(int8_t delta) {
+    portENTER_CRITICAL(&_mux);
+    _pendingStep += delta;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyScreens::requestKey(ScreenKey key) {
+    portENTER_CRITICAL(&_mux);
+    _pendingKey = (int)key;
+    portEXIT_CRITICAL(&_mux);
+}
+
+int32_t MyScreens::usedBytes() {
+    int32_t used = 0;
+#if LV_MEM_CUSTOM == 0
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    used += (int32_t)(mon.total_size - mon.free_size);
+#endif
+    // LV_MEM_CUSTOM 时LVGL的对象直接分配在堆上；两者都计入，图表点数组等也不会漏掉
+    used -= (int32_t)heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    return used;
+}
+
+bool MyScreens::build(int index) {
+    int32_t before = usedBytes();
+    uint64_t t0 = halMicros();
+    lv_obj_t *root = lv_obj_create(NULL);
+    if (root == NULL) {
+        Serial.printf("错误: 屏幕 %s 创建失败（LVGL内存不足）\n", _table[index].name);
+        return false;
+    }
+    lv_obj_clear_flag(root, LV_OBJ_FLAG_SCROLLABLE);
+    _table[index].build(root);
+    uint32_t us = (uint32_t)(halMicros() - t0);
+
+    _root[index] = root;
+    ScreenStats &st = _stats[index];
+    st.built = true;
+    st.builds++;
+    st.lastBuildUs = us;
+    st.maxBuildUs = us > st.maxBuildUs ? us : st.maxBuildUs;
+    st.bytes = usedBytes() - before;
+    return true;
+}
+
+void MyScreens::destroy(int index) {
+    if (_root[index] == NULL || (_table[index].flags & SCREEN_RESIDENT) || index == _active) {
+        return;
+    }
+    int32_t before = usedBytes();
+    lv_obj_del(_root[index]);
+    _root[index] = NULL;
+    _stats[index].built = false;
+    _stats[index].freedBytes = before - usedBytes();
+}
+
+void MyScreens::show(int index) {
+    if (index == _active) {
+        return;
+    }
+    if (_root[index] == NULL && !build(index)) {
+        return;
+    }
+    int previous = _active;
+    // 新屏幕已经创建好，ui_load_scr_animation 只负责切换；旧屏幕由下面按标志和预算处理
+    ui_load_scr_animation(_ui, &_root[index], false, &_loadDel, NULL, LV_SCR_LOAD_ANIM_NONE, 0, 0, false, false);
+    _active = index;
+    _stats[index].shows++;
+    _lastShown[index] = ++_showSeq;
+    if (!(_table[previous].flags & SCREEN_CACHE)) {
+        destroy(previous);
+    }
+    enforceBudget();
+}
+
+int32_t MyScreens::cachedBytes() const {
+    int32_t total = 0;
+    for (size_t i = 0; i < _count; i++) {
+        if (_root[i] != NULL && !(_table[i].flags & SCREEN_RESIDENT)) {
+            total += _stats[i].bytes;
+        }
+    }
+    return total;
+}
+
+// 超出预算时按最久未显示的顺序删除不在显示的屏幕
+void MyScreens::enforceBudget() {
+    while (_budget > 0 && cachedBytes() > (int32_t)_budget) {
+        int victim = -1;
+        for (size_t i = 0; i < _count; i++) {
+            if (_root[i] == NULL || (_table[i].flags & SCREEN_RESIDENT) || (int)i == _active) {
+                continue;
+            }
+            if (victim < 0 || _lastShown[i] < _lastShown[victim]) {
+                victim = (int)i;
+            }
+        }
+        if (victim < 0) {
+            return;
+        }
+        destroy(victim);
+    }
+}
+
+// 每次最多预加载一个屏幕；加上它会超出预算（按上次测得的内存）时不预加载
+void MyScreens::preloadOne() {
+    if ((uint32_t)(halMicros() / 1000) - _installMs < SCREEN_PRELOAD_DELAY_MS) {
+        return;
+    }
+    for (size_t i = 0; i < _count; i++) {
+        const ScreenSpec &spec = _table[i];
+        if (!(spec.flags & SCREEN_PRELOAD) || _root[i] != NULL) {
+            continue;
+        }
+        if (_budget > 0 && _stats[i].builds > 0 && cachedBytes() + _stats[i].bytes > (int32_t)_budget) {
+            continue;
+        }
+        build((int)i);
+        return;
+    }
+}
+
+// 从当前屏幕按表中顺序前后数 step 个不隐藏的屏幕（主屏幕不隐藏，循环一定能数到）
+int MyScreens::stepTarget(int step) const {
+    int n = (int)_count;
+    int dir = step > 0 ? 1 : -1;
+    int index = _active;
+    while (step != 0) {
+        index = ((index + dir) % n + n) % n;
+        if (!(_table[index].flags & SCREEN_HIDDEN)) {
+            step -= dir;
+        }
+    }
+    return index;
+}
+
+bool MyScreens::handleKey(ScreenKey key) {
+    if (_table == NULL) {
+        return false;
+    }
+    const ScreenSpec &spec = _table[_active];
+    return spec.key != NULL && spec.key(key);
+}
+
+void MyScreens::update(bool idle) {
+    if (_table == NULL) {
+        return;
+    }
+    portENTER_CRITICAL(&_mux);
+    int target = _pendingScreen;
+    int step = _pendingStep;
+    int key = _pendingKey;
+    _pendingScreen = -1;
+    _pendingStep = 0;
+    _pendingKey = -1;
+    portEXIT_CRITICAL(&_mux);
+
+    if (target < 0 && step != 0) {
+        target = stepTarget(step);
+    }
+    if (target >= 0) {
+        show(target);
+    }
+    if (key >= 0) {
+        handleKey((ScreenKey)key);
+    }
+    const ScreenSpec &spec = _table[_active];
+    if (spec.update != NULL && _root[_active] != NULL) {
+        spec.update(_root[_active]);
+    }
+    if (idle && target < 0) {
+        preloadOne();
+    }
+}
+
+bool MyScreens::stats(int index, ScreenStats &out) const {
+    if (index < 0 || index >= (int)_count) {
+        return false;
+    }
+    out = _stats[index];
+    return true;
+}
+
+void MyScreens::printReport() const {
+    Serial.printf("屏幕（预算 %lu字节，已缓存 %ld字节）\n", (unsigned long)_budget, (long)cachedBytes());
+    Serial.println("屏幕        状态    创建次数 上次创建us 最长us   内存字节 释放字节 显示次数");
+    for (size_t i = 0; i < _count; i++) {
+        const ScreenStats &st = _stats[i];
+        const char *state = (int)i == _active ? "显示" : (_root[i] != NULL ? "缓存" : "未创建");
+        Serial.printf("%-10s  %-6s %8lu %10lu %7lu %9ld %8ld %8lu\n", _table[i].name, state,
+                      (unsigned long)st.builds, (unsigned long)st.lastBuildUs, (unsigned long)st.maxBuildUs,
+                      (long)st.bytes, (long)st.freedBytes, (unsigned long)st.shows);
+    }
+}
@@ -0,0 +1,157 @@
+/**
+ * @file myScreens.h
+ * @brief 声明式屏幕表：各屏幕按需创建、空闲时预加载、在内存预算内缓存，并记录创建耗时和内存
+ * @author watermelon6uice
+ * @details
+ * gui_guider 的 lv_ui 只描述主屏幕，setup_ui 在启动时创建全部控件；示波器、趋势等屏幕
+ * 以前各自管理创建、切换和删除，每增加一个屏幕都要在UI任务里加一段切换逻辑，
+ * 也不知道每个屏幕占多少内存、创建要多久。
+ *
+ * 现在所有屏幕登记在一张表里（见main.cpp中的 SCREEN_TABLE），本模块统一负责：
+ * - 第一次切换到某屏幕时调用它的创建函数（SCREEN_PRELOAD 的屏幕在启动几秒后、
+ *   UI任务空闲时提前创建，不增加启动时间）；
+ * - 切换通过 ui_load_scr_animation 进行（不用动画，屏幕的删除由本模块决定）；
+ * - 离开的屏幕：没有 SCREEN_CACHE 的立即删除；有的保留，所有非常驻屏幕的内存合计
+ *   超过预算时，按最久未显示的顺序删除；SCREEN_RESIDENT（主屏幕）永不删除；
+ * - 每次创建记录耗时（us）和占用的内存（LVGL内存池和堆的减少量之和），删除时记录
+ *   释放的内存，两者不相等说明屏幕有泄漏，串口命令可以输出报告。
+ * 切换请求可以在任何任务中发出，真正的LVGL操作都在UI任务调用 update() 时进行。
+ * 屏幕自己的对象指针应在根对象的 LV_EVENT_DELETE 回调中清空。
+ * @date 2025-06-13
+ */
+
+#ifndef MY_SCREENS_H
+#define MY_SCREENS_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "lvgl.h"
+#include "gui_guider.h"
+
+#define SCREEN_MAX 8                     // 屏幕表最多的条目数
+#define SCREEN_PRELOAD_DELAY_MS 3000     // 启动后多久开始预加载
+
+// 屏幕标志
+#define SCREEN_RESIDENT (1 << 0)         // 由别处创建（adopt()），永不删除
+#define SCREEN_PRELOAD  (1 << 1)         // 空闲时提前创建
+#define SCREEN_CACHE    (1 << 2)         // 离开后保留（受内存预算限制）
+#define SCREEN_HIDDEN   (1 << 3)         // 不参与前后切换，只能按名字切换（如触摸校准）
+
+// 交给当前屏幕处理的按键
+enum ScreenKey {
+    SCREEN_KEY_STEP = 0,                 // 步进按钮短按
+};
+
+// 在 screen（已创建的空白根对象）中创建控件
+typedef void (*ScreenBuildFn)(lv_obj_t *screen);
+// 屏幕显示期间UI任务每个周期调用一次
+typedef void (*ScreenUpdateFn)(lv_obj_t *screen);
+// 处理按键，返回false时按键按主屏幕的含义处理
+typedef bool (*ScreenKeyFn)(ScreenKey key);
+
+// 屏幕表条目
+struct ScreenSpec {
+    const char *name;        // 屏幕名，也是请求切换时的键
+    ScreenBuildFn build;     // 创建函数，SCREEN_RESIDENT 的屏幕为NULL
+    ScreenUpdateFn update;   // 可为NULL
+    ScreenKeyFn key;         // 可为NULL
+    uint8_t flags;
+};
+
+// 一个屏幕的统计
+struct ScreenStats {
+    bool built;              // 当前是否已创建
+    uint32_t builds;         // 创建次数
+    uint32_t lastBuildUs;
+    uint32_t maxBuildUs;
+    int32_t bytes;           // 最近一次创建占用的内存
+    int32_t freedBytes;      // 最近一次删除释放的内存
+    uint32_t shows;          // 显示次数
+};
+
+class MyScreens {
+public:
+    MyScreens();
+
+    /**
+     * @brief 安装屏幕表，第0项为主屏幕
+     * @details 表本身不会被复制，必须是静态存储的数组。
+     * @param ui gui_guider 的界面（切换时传给 ui_load_scr_animation）
+     * @return 配置有误（条目过多、第0项不是常驻屏幕、非常驻屏幕没有创建函数）时返回false
+     */
+    bool install(const ScreenSpec *table, size_t count, lv_ui *ui);
+
+    /**
+     * @brief 登记由别处创建的常驻屏幕（主屏幕由 setup_ui 创建）
+     * @param buildUs、bytes 创建耗时和内存，只用于报告
+     */
+    void adopt(const char *name, lv_obj_t *root, uint32_t buildUs, int32_t bytes);
+
+    // 非常驻屏幕（已创建的）内存合计的上限，0表示不限
+    void setBudget(uint32_t bytes) { _budget = bytes; }
+
+    // 以下请求可在任何任务中调用，下次 update() 时生效
+    bool request(const char *name);
+    void requestHome();
+    void requestStep(int8_t delta);      // 按表中顺序前后切换（循环，跳过 SCREEN_HIDDEN）
+    void requestKey(ScreenKey key);      // 交给当前屏幕处理（串口命令使用）
+
+    /**
+     * @brief 处理切换请求和按键，调用当前屏幕的更新函数，空闲时预加载
+     * @param idle 本周期UI任务没有其他工作
+     * @note 只能在UI任务中调用
+     */
+    void update(bool idle);
+
+    /**
+     * @brief 把按键交给当前屏幕
+     * @return 当前屏幕处理了该按键时返回true
+     * @note 只能在UI任务中调用
+     */
+    bool handleKey(ScreenKey key);
+
+    int active() const { return _active; }
+    bool isHomeActive() const { return _active == 0; }
+    bool isActive(const char *name) const;
+    int find(const char *name) const;
+
+    // 屏幕统计，index 无效时返回false
+    bool stats(int index, ScreenStats &out) const;
+
+    // 输出各屏幕的状态、创建耗时和内存
+    void printReport() const;
+
+    // 当前已占用的内存（LVGL内存池 + 8位可访问的堆），用于测量创建和删除前后的差值
+    static int32_t usedBytes();
+
+private:
+    const ScreenSpec *_table;
+    size_t _count;
+    lv_ui *_ui;
+    lv_obj_t *_root[SCREEN_MAX];
+    ScreenStats _stats[SCREEN_MAX];
+    uint32_t _lastShown[SCREEN_MAX];     // 最近一次显示的序号，用于按最久未显示删除
+    uint32_t _showSeq;
+    uint32_t _budget;
+    uint32_t _installMs;
+    volatile int _active;
+    bool _loadDel;                       // ui_load_scr_animation 的 old_scr_del 输出，本模块不使用
+
+    // 请求（多个任务写入）
+    portMUX_TYPE _mux;
+    int _pendingScreen;                  // -1 表示没有
+    int _pendingStep;
+    int _pendingKey;                     // -1 表示没有
+
+    bool build(int index);
+    void destroy(int index);
+    void show(int index);
+    void enforceBudget();
+    void preloadOne();
+    int stepTarget(int step) const;
+    int32_t cachedBytes() const;
+};
+
+extern MyScreens screens;
+
+#endif // MY_SCREENS_H
@@ -0,0 +1,402 @@
+/**
+ * @file mySettings.cpp
+ * @brief 设置存储：设定值、步进模式、设定范围和ADC校准保存在NVS中，修改先在内存中合并，延迟写入
+ * @author watermelon6uice
+ * @date 2025-06-14
+ */
+
+#include "mySettings.h"
+#include "myHAL.h"
+#include "mySystemState.h"
+#include "myTaskTable.h"
+#include <string.h>
+#include <math.h>
+
+#define SETTINGS_EVENT_CHANGED (1 << 0)   // 系统状态的设定值组有变化
+#define SETTINGS_EVENT_DROP (1 << 1)      // 检测到U_IN跌落
+
+MySettings settings;
+
+MySettings::MySettings() :
+    _dirty(false),
+    _firstChangeMs(0),
+    _lastChangeMs(0),
+    _lastWriteMs(0),
+    _beginMs(0),
+    _started(false),
+    _events(NULL),
+    _uInAvg(0.0f),
+    _dropCount(0),
+    _dropArmed(true),
+    _dropUs(0)
+{
+    portMUX_TYPE unlocked = portMUX_INITIALIZER_UNLOCKED;
+    _mux = unlocked;
+    memset(&_current, 0, sizeof(_current));
+    memset(&_saved, 0, sizeof(_saved));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+bool MySettings::equal(const Settings &a, const Settings &b) {
+    return a.uSet == b.uSet && a.uSetMin == b.uSetMin && a.uSetMax == b.uSetMax && a.iSet == b.iSet &&
+           a.iSetMin == b.iSetMin && a.iSetMax == b.iSetMax && a.fineStep == b.fineStep &&
+           memcmp(a.adcFactors, b.adcFactors, sizeof(a.adcFactors)) == 0 && presetsEqual(a, b);
+}
+
+// 逐个字段比较（结构体中有填充字节）
+bool MySettings::presetsEqual(const Settings &a, const Settings &b) {
+    for (int i = 0; i < SETTINGS_PRESET_COUNT; i++) {
+        if (!presetEqual(a.presets[i], b.presets[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MySettings::presetEqual(const SettingsPreset &p, const SettingsPreset &q) {
+    if (p.valid != q.valid) {
+        return false;
+    }
+    return !p.valid || (p.uSet == q.uSet && p.iSet == q.iSet && memcmp(&p.limits, &q.limits, sizeof(p.limits)) == 0);
+}
+
+bool MySettings::presetValid(const Settings &s, const SettingsPreset &p) {
+    return p.valid && p.uSet >= s.uSetMin && p.uSet <= s.uSetMax && p.iSet >= s.iSetMin && p.iSet <= s.iSetMax &&
+           p.limits.ovpV > p.uSet && p.limits.ocpA > p.iSet && p.limits.uvloV >= 0.0f && p.limits.oppW > 0.0f;
+}
+
+// 设定值在范围内、校准系数为正、保存的预设有效（NaN也不能通过）
+bool MySettings::valid(const Settings &s) {
+    if (!(s.uSetMin < s.uSetMax && s.uSet >= s.uSetMin && s.uSet <= s.uSetMax)) {
+        return false;
+    }
+    if (!(s.iSetMin < s.iSetMax && s.iSet >= s.iSetMin && s.iSet <= s.iSetMax)) {
+        return false;
+    }
+    for (int i = 0; i < 4; i++) {
+        if (!(s.adcFactors[i] > 0.0f)) {
+            return false;
+        }
+    }
+    for (int i = 0; i < SETTINGS_PRESET_COUNT; i++) {
+        if (s.presets[i].valid && !presetValid(s, s.presets[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MySettings::begin(const Settings &defaults) {
+    Record rec;
+    uint64_t t0 = halMicros();
+    bool loaded = halNvsLoad(SETTINGS_NVS_NAMESPACE, SETTINGS_NVS_KEY, &rec, sizeof(rec));
+    uint32_t us = (uint32_t)(halMicros() - t0);
+    bool restored = loaded && rec.version == SETTINGS_VERSION && valid(rec.settings);
+
+    uint32_t now = millis();
+    portENTER_CRITICAL(&_mux);
+    _current = restored ? rec.settings : defaults;
+    _saved = _current;
+    _dirty = false;
+    _beginMs = now;
+    // 启动后的第一次修改不受最短间隔限制
+    _lastWriteMs = now - SETTINGS_MIN_INTERVAL_MS;
+    _stats.restored = restored;
+    _stats.loadUs = us;
+    portEXIT_CRITICAL(&_mux);
+
+    if (restored) {
+        Serial.printf("设置已从NVS恢复: U_SET %.2fV  I_SET %.2fA  %s（读取 %luus）\n", rec.settings.uSet,
+                      rec.settings.iSet, rec.settings.fineStep ? "细调" : "粗调", (unsigned long)us);
+    } else if (loaded) {
+        Serial.println("NVS中的设置版本不符或内容无效，使用默认值");
+    } else {
+        Serial.println("NVS中没有保存的设置，使用默认值");
+    }
+    return restored;
+}
+
+bool MySettings::start() {
+    if (_started) {
+        return true;
+    }
+    _events = xEventGroupCreate();
+    if (_events == NULL || !systemState.addListener(_events, SETTINGS_EVENT_CHANGED, SYSSTATE_CHANGED_SETPOINT)) {
+        Serial.println("错误: 设置存储无法监听设定值");
+        return false;
+    }
+    if (taskTableCreate(taskEntry, "Settings", this, NULL) != pdPASS) {
+        Serial.println("错误: 无法创建设置存储任务");
+        return false;
+    }
+    _started = true;
+    return true;
+}
+
+void MySettings::get(Settings &out) const {
+    portENTER_CRITICAL(&_mux);
+    out = _current;
+    portEXIT_CRITICAL(&_mux);
+}
+
+bool MySettings::update(const Settings &next) {
+    uint32_t now = millis();
+    portENTER_CRITICAL(&_mux);
+    if (equal(next, _current)) {
+        portEXIT_CRITICAL(&_mux);
+        return false;
+    }
+    _current = next;
+    markChanged(now);
+    portEXIT_CRITICAL(&_mux);
+    notifyChanged();
+    return true;
+}
+
+// 在同一个临界区内读取和修改，不会覆盖其他调用者同时做的修改
+bool MySettings::setPreset(int slot, const SettingsPreset &p) {
+    if (slot < 1 || slot > SETTINGS_PRESET_COUNT) {
+        return false;
+    }
+    uint32_t now = millis();
+    portENTER_CRITICAL(&_mux);
+    SettingsPreset &cur = _current.presets[slot - 1];
+    if (presetEqual(cur, p)) {
+        portEXIT_CRITICAL(&_mux);
+        return false;
+    }
+    cur = p;
+    markChanged(now);
+    portEXIT_CRITICAL(&_mux);
+    notifyChanged();
+    return true;
+}
+
+bool MySettings::setSetpoint(float uSet, float iSet, bool fineStep) {
+    uint32_t now = millis();
+    portENTER_CRITICAL(&_mux);
+    float u = isnan(uSet) ? _current.uSet : uSet;
+    float i = isnan(iSet) ? _current.iSet : iSet;
+    if (u == _current.uSet && i == _current.iSet && fineStep == _current.fineStep) {
+        portEXIT_CRITICAL(&_mux);
+        return false;
+    }
+    _current.uSet = u;
+    _current.iSet = i;
+    _current.fineStep = fineStep;
+    markChanged(now);
+    portEXIT_CRITICAL(&_mux);
+    notifyChanged();
+    return true;
+}
+
+// 在 _mux 内调用
+void MySettings::markChanged(uint32_t now) {
+    _stats.changes++;
+    if (!_dirty) {
+        _dirty = true;
+        _firstChangeMs = now;
+    }
+    _lastChangeMs = now;
+}
+
+// 唤醒写入任务重新计算到期时间
+void MySettings::notifyChanged() {
+    if (_events != NULL) {
+        xEventGroupSetBits(_events, SETTINGS_EVENT_CHANGED);
+    }
+}
+
+void MySettings::taskEntry(void *param) {
+    static_cast<MySettings *>(param)->run();
+}
+
+void MySettings::run() {
+    while (true) {
+        EventBits_t bits = xEventGroupWaitBits(_events, SETTINGS_EVENT_CHANGED | SETTINGS_EVENT_DROP, pdTRUE,
+                                               pdFALSE, ticksUntilDue());
+        if (bits & SETTINGS_EVENT_CHANGED) {
+            captureSetpoint();
+        }
+        if (bits & SETTINGS_EVENT_DROP) {
+            commit(true);
+        } else if (_dirty && ticksUntilDue() == 0) {
+            commit(false);
+        }
+    }
+}
+
+// 从系统状态取已确认的设定值和步进模式，编辑中（未确认）的值不保存
+void MySettings::captureSetpoint() {
+    SystemState s;
+    systemState.snapshot(s);
+    setSetpoint(s.uSetConfirmed ? s.uSet : NAN, s.iSetConfirmed ? s.iSet : NAN, s.fineStep);
+}
+
+// 到下一次写入的时间：安静 SETTINGS_QUIET_MS 且距上次写入 SETTINGS_MIN_INTERVAL_MS，
+// 但从第一次修改起不超过 SETTINGS_MAX_DELAY_MS
+TickType_t MySettings::ticksUntilDue() const {
+    uint32_t now = millis();
+    portENTER_CRITICAL(&_mux);
+    if (!_dirty) {
+        portEXIT_CRITICAL(&_mux);
+        return portMAX_DELAY;
+    }
+    uint32_t quiet = now - _lastChangeMs;
+    uint32_t sinceWrite = now - _lastWriteMs;
+    uint32_t age = now - _firstChangeMs;
+    portEXIT_CRITICAL(&_mux);
+
+    uint32_t wait = quiet < SETTINGS_QUIET_MS ? SETTINGS_QUIET_MS - quiet : 0;
+    if (sinceWrite < SETTINGS_MIN_INTERVAL_MS && SETTINGS_MIN_INTERVAL_MS - sinceWrite > wait) {
+        wait = SETTINGS_MIN_INTERVAL_MS - sinceWrite;
+    }
+    uint32_t maxWait = age < SETTINGS_MAX_DELAY_MS ? SETTINGS_MAX_DELAY_MS - age : 0;
+    if (wait > maxWait) {
+        wait = maxWait;
+    }
+    return pdMS_TO_TICKS(wait);
+}
+
+bool MySettings::commit(bool drop) {
+    Record rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.version = SETTINGS_VERSION;
+    portENTER_CRITICAL(&_mux);
+    bool dirty = _dirty;
+    rec.settings = _current;
+    _dirty = false;
+    portEXIT_CRITICAL(&_mux);
+
+    if (!dirty) {
+        return true;
+    }
+    if (equal(rec.settings, _saved)) {
+        // 改了又改回去
+        portENTER_CRITICAL(&_mux);
+        _stats.skipped++;
+        portEXIT_CRITICAL(&_mux);
+        return true;
+    }
+
+    uint64_t t0 = halMicros();
+    bool ok = halNvsSave(SETTINGS_NVS_NAMESPACE, SETTINGS_NVS_KEY, &rec, sizeof(rec));
+    uint64_t t1 = halMicros();
+    uint32_t us = (uint32_t)(t1 - t0);
+    uint32_t now = millis();
+
+    portENTER_CRITICAL(&_mux);
+    // 失败时也按写入计时，按最短间隔重试
+    _lastWriteMs = now;
+    if (ok) {
+        _stats.writes++;
+        _stats.lastWriteUs = us;
+        if (us > _stats.maxWriteUs) {
+            _stats.maxWriteUs = us;
+        }
+        if (drop) {
+            _stats.dropWrites++;
+            _stats.lastDropUs = (uint32_t)(t1 - (uint64_t)_dropUs);
+        }
+    } else {
+        _stats.failures++;
+        if (!_dirty) {
+            _dirty = true;
+            _firstChangeMs = now;
+            _lastChangeMs = now;
+        }
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    if (ok) {
+        _saved = rec.settings;
+    } else {
+        Serial.println("设置写入NVS失败，稍后重试");
+    }
+    return ok;
+}
+
+void MySettings::onFrame(const AdcFrame &frame, void *ctx) {
+    static_cast<MySettings *>(ctx)->detectDrop(frame);
+}
+
+void MySettings::detectDrop(const AdcFrame &frame) {
+    float uIn = frame.uIn;
+    if (_uInAvg <= 0.0f) {
+        _uInAvg = uIn;
+        return;
+    }
+    if (_dropArmed && _uInAvg >= SETTINGS_MIN_INPUT_V && uIn < _uInAvg * SETTINGS_DROP_RATIO) {
+        // 跌落期间不更新平常值
+        if (++_dropCount >= SETTINGS_DROP_SAMPLES) {
+            _dropCount = 0;
+            _dropArmed = false;
+            _dropUs = frame.timeUs;
+            portENTER_CRITICAL(&_mux);
+            _stats.drops++;
+            portEXIT_CRITICAL(&_mux);
+            if (_events != NULL) {
+                xEventGroupSetBits(_events, SETTINGS_EVENT_DROP);
+            }
+        }
+        return;
+    }
+    _dropCount = 0;
+    // 输入换到较低的电压（例如PD重新协商）时平常值随之下降，追上后重新开始检测
+    _uInAvg += (uIn - _uInAvg) * SETTINGS_AVG_ALPHA;
+    if (!_dropArmed && uIn >= _uInAvg * SETTINGS_REARM_RATIO) {
+        _dropArmed = true;
+    }
+}
+
+void MySettings::stats(SettingsStats &out) const {
+    portENTER_CRITICAL(&_mux);
+    out = _stats;
+    portEXIT_CRITICAL(&_mux);
+}
+
+// ESP-IDF的NVS中一个二进制记录占用一个索引条目、一个数据头条目和按32字节计的数据条目
+uint32_t MySettings::entriesPerWrite() {
+    return 2 + (sizeof(Record) + 31) / 32;
+}
+
+uint32_t MySettings::lifetimeWrites() {
+    return (uint32_t)((uint64_t)SETTINGS_FLASH_CYCLES * SETTINGS_NVS_PAGES * SETTINGS_NVS_PAGE_ENTRIES /
+                      entriesPerWrite());
+}
+
+void MySettings::printReport() const {
+    Settings s;
+    get(s);
+    SettingsStats st;
+    stats(st);
+    uint32_t uptimeMs = millis() - _beginMs;
+
+    Serial.println("===== 设置存储 =====");
+    Serial.printf("U_SET %.2fV (%.2f-%.2f)  I_SET %.2fA (%.2f-%.2f)  %s  校准 %.3f/%.3f/%.3f/%.3f%s\n", s.uSet,
+                  s.uSetMin, s.uSetMax, s.iSet, s.iSetMin, s.iSetMax, s.fineStep ? "细调" : "粗调", s.adcFactors[0],
+                  s.adcFactors[1], s.adcFactors[2], s.adcFactors[3], _dirty ? "  (未保存)" : "");
+    int presets = 0;
+    for (int i = 0; i < SETTINGS_PRESET_COUNT; i++) {
+        presets += s.presets[i].valid ? 1 : 0;
+    }
+    Serial.printf("已保存的预设 %d个（M1..M%d）\n", presets, SETTINGS_PRESET_COUNT);
+    Serial.printf("启动时%s，读取 %luus\n", st.restored ? "从NVS恢复" : "使用默认值", (unsigned long)st.loadUs);
+    Serial.printf("修改 %lu次  写入flash %lu次  内容未变跳过 %lu次  失败 %lu次\n", (unsigned long)st.changes,
+                  (unsigned long)st.writes, (unsigned long)st.skipped, (unsigned long)st.failures);
+    if (st.writes > 0) {
+        Serial.printf("写入用时 最近 %.2fms  最长 %.2fms\n", st.lastWriteUs / 1000.0f, st.maxWriteUs / 1000.0f);
+    }
+    if (st.drops > 0) {
+        Serial.printf("输入跌落 %lu次，其中写入未保存的修改 %lu次，最近一次从检测到写入完成 %.2fms\n",
+                      (unsigned long)st.drops, (unsigned long)st.dropWrites, st.lastDropUs / 1000.0f);
+    }
+    uint32_t lifetime = lifetimeWrites();
+    Serial.printf("每次写入占用 %lu个NVS条目，flash寿命内约可写入 %lu次", (unsigned long)entriesPerWrite(),
+                  (unsigned long)lifetime);
+    if (st.writes > 0 && uptimeMs > 0) {
+        float perDay = st.writes * 86400000.0f / uptimeMs;
+        Serial.printf("；按本次运行每天 %.0f次的频率约可使用 %.0f年", perDay, lifetime / perDay / 365.0f);
+    }
+    Serial.println();
+}
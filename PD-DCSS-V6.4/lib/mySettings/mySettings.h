@@ -0,0 +1,179 @@
+/**
+ * @file mySettings.h
+ * @brief 设置存储：设定值、步进模式、设定范围和ADC校准保存在NVS中，修改先在内存中合并，延迟写入
+ * @author watermelon6uice
+ * @details
+ * 以前U_SET（初始5.00V）、步进模式、设定范围和校准系数都是main.cpp中的常量，每次上电都回到初始值。
+ * 现在它们和预设（M1..M9，见 myPresets）放在一个带版本号的记录（Settings）里：
+ * - 启动时 begin() 一次读取整个记录，记录不存在或版本不符时使用调用者给出的默认值；
+ * - start() 之后本模块的任务监听系统状态的设定值组，只取已确认的U_SET、I_SET和步进模式，
+ *   编码器每转一格（未确认的设定值）不会引起写入；也可以用 update() 直接修改；
+ * - 修改只改内存中的记录，安静 SETTINGS_QUIET_MS 后才写入；两次写入至少间隔
+ *   SETTINGS_MIN_INTERVAL_MS，一直在修改时第一次修改后最迟 SETTINGS_MAX_DELAY_MS 写入。
+ *   到期时内容与已保存的相同（改了又改回去）则不写；
+ * - 掉电检测：限流任务的采集帧（待机时也有）中U_IN比平常值低 SETTINGS_DROP_RATIO 以上，
+ *   连续 SETTINGS_DROP_SAMPLES 个采样，立即写入未保存的修改，不再等待；
+ * - 统计修改次数、实际写入flash的次数和用时，按NVS的条目占用估算在flash寿命内可写入的次数。
+ * 写入在本模块的任务中进行（栈在内部RAM，写flash期间缓存关闭）。
+ * @date 2025-06-14
+ */
+
+#ifndef MY_SETTINGS_H
+#define MY_SETTINGS_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "myAdcFrame.h"
+#include "myProtection.h"
+
+#define SETTINGS_NVS_NAMESPACE "settings"
+#define SETTINGS_NVS_KEY "main"
+#define SETTINGS_VERSION 2               // 记录结构改变时加1，旧记录不再使用
+#define SETTINGS_PRESET_COUNT 9          // 预设M1..M9
+
+#define SETTINGS_QUIET_MS 3000           // 最后一次修改之后安静多久写入
+#define SETTINGS_MIN_INTERVAL_MS 10000   // 两次写入之间的最短间隔
+#define SETTINGS_MAX_DELAY_MS 60000      // 一直在修改时，第一次修改之后最迟多久写入
+
+#define SETTINGS_DROP_RATIO 0.85f        // U_IN低于平常值的这个比例视为掉电
+#define SETTINGS_REARM_RATIO 0.95f       // 回到平常值的这个比例以上重新开始检测
+#define SETTINGS_DROP_SAMPLES 2          // 需要连续低于阈值的采样数
+#define SETTINGS_MIN_INPUT_V 3.0f        // 平常值低于此值（没有接输入）时不检测
+#define SETTINGS_AVG_ALPHA 0.02f         // U_IN平常值的平滑系数（每个采集帧）
+
+// flash寿命估算：NVS分区中可轮换的页数（默认20KB分区5页，其中一页留给垃圾回收）、
+// 每页的条目数（每条32字节）、每个扇区的擦写次数
+#define SETTINGS_NVS_PAGES 4
+#define SETTINGS_NVS_PAGE_ENTRIES 126
+#define SETTINGS_FLASH_CYCLES 100000
+
+// 一个预设：电压设定值、限流设定值和保护阈值
+struct SettingsPreset {
+    bool valid;              // false为空位
+    float uSet;
+    float iSet;
+    ProtectionLimits limits;
+};
+
+struct Settings {
+    float uSet;              // 已确认的电压设定值(V)
+    float uSetMin;           // 电压设定范围(V)
+    float uSetMax;
+    float iSet;              // 已确认的限流设定值(A)
+    float iSetMin;           // 限流设定范围(A)
+    float iSetMax;
+    bool fineStep;           // true为细调步进
+    float adcFactors[4];     // ADC校准系数：U_IN、I_IN、U_OUT、I_OUT
+    SettingsPreset presets[SETTINGS_PRESET_COUNT];   // M1..M9，默认都是空位
+};
+
+struct SettingsStats {
+    bool restored;           // 启动时从NVS恢复了记录
+    uint32_t loadUs;         // 启动时读取的用时
+    uint32_t changes;        // 记录被修改的次数
+    uint32_t writes;         // 写入flash的次数
+    uint32_t skipped;        // 到期时内容与已保存的相同，没有写入
+    uint32_t failures;       // 写入失败
+    uint32_t lastWriteUs;    // 写入用时
+    uint32_t maxWriteUs;
+    uint32_t drops;          // 检测到U_IN跌落
+    uint32_t dropWrites;     // 其中有未保存的修改并写入
+    uint32_t lastDropUs;     // 从检测到跌落的采样到写入完成
+};
+
+class MySettings {
+public:
+    MySettings();
+
+    /**
+     * @brief 从NVS读取整个记录（一次读取）
+     * @param defaults 没有记录或版本不符时使用的值
+     * @return 恢复了保存的记录时返回true
+     */
+    bool begin(const Settings &defaults);
+
+    /**
+     * @brief 开始监听设定值的变化并创建写入任务（见任务表中的 Settings 条目），
+     *        在发布了恢复的设定值之后调用
+     */
+    bool start();
+
+    // 当前的记录（可能还没写入）
+    void get(Settings &out) const;
+
+    /**
+     * @brief 修改记录，只改内存，按写入规则延迟写入
+     * @return 内容有变化时返回true
+     */
+    bool update(const Settings &next);
+
+    /**
+     * @brief 只修改一个预设（slot 为1..SETTINGS_PRESET_COUNT），其他字段不受影响，写入规则同 update()
+     * @return 内容有变化时返回true
+     */
+    bool setPreset(int slot, const SettingsPreset &p);
+
+    /**
+     * @brief 只修改设定值和步进模式，uSet、iSet 为NAN时保持原值，写入规则同 update()
+     * @return 内容有变化时返回true
+     */
+    bool setSetpoint(float uSet, float iSet, bool fineStep);
+
+    bool isDirty() const { return _dirty; }
+
+    // 采集帧回调（在限流任务中调用，待机时也调用），检测U_IN跌落
+    static void onFrame(const AdcFrame &frame, void *ctx);
+
+    void stats(SettingsStats &out) const;
+
+    // 估算的每次写入占用的NVS条目数和flash寿命内可写入的次数
+    static uint32_t entriesPerWrite();
+    static uint32_t lifetimeWrites();
+
+    // 预设的设定值在 s 的范围内，且低于过压、过流阈值（调用后不会立即触发保护）
+    static bool presetValid(const Settings &s, const SettingsPreset &p);
+
+    void printReport() const;
+
+private:
+    struct Record {
+        uint32_t version;
+        Settings settings;
+    };
+
+    mutable portMUX_TYPE _mux;
+    Settings _current;           // 内存中的记录
+    Settings _saved;             // 已写入的记录
+    bool _dirty;
+    uint32_t _firstChangeMs;     // 未保存的修改中最早和最近一次的时刻
+    uint32_t _lastChangeMs;
+    uint32_t _lastWriteMs;
+    uint32_t _beginMs;
+    bool _started;
+    EventGroupHandle_t _events;
+    SettingsStats _stats;
+
+    // 掉电检测（只在限流任务中使用）
+    float _uInAvg;
+    uint8_t _dropCount;
+    bool _dropArmed;
+    int64_t _dropUs;
+
+    static void taskEntry(void *param);
+    void run();
+    void captureSetpoint();
+    void markChanged(uint32_t now);
+    void notifyChanged();
+    TickType_t ticksUntilDue() const;
+    bool commit(bool drop);
+    void detectDrop(const AdcFrame &frame);
+    static bool equal(const Settings &a, const Settings &b);
+    static bool presetsEqual(const Settings &a, const Settings &b);
+    static bool presetEqual(const SettingsPreset &p, const SettingsPreset &q);
+    static bool valid(const Settings &s);
+};
+
+extern MySettings settings;
+
+#endif // MY_SETTINGS_H
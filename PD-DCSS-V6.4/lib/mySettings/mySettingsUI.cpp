@@ -0,0 +1,98 @@
+/**
+ * @file mySettingsUI.cpp
+ * @brief 设置屏幕：保存的设定值、范围、步进模式和ADC校准，设置存储的写入统计
+ * @author watermelon6uice
+ * @details
+ * 屏幕由屏幕表（myScreens）在第一次切换时创建，不缓存，离开时删除。只显示，不修改：
+ * 设定值由编码器确认后经系统状态进入记录，预设在预设屏幕或主屏幕上保存。
+ * 统计与串口报告（MySettings::printReport）相同，统计或未保存标志变化时才刷新。
+ * @date 2025-06-14
+ */
+
+#include "mySettingsUI.h"
+#include "mySettings.h"
+#include <string.h>
+
+#define SETTINGS_UI_X 10
+#define SETTINGS_UI_Y 24
+#define SETTINGS_UI_STEP 18
+#define SETTINGS_UI_LINES 10
+
+#define SETTINGS_UI_BG_COLOR 0x000822
+#define SETTINGS_UI_TEXT_COLOR 0xffffff
+#define SETTINGS_UI_DIRTY_COLOR 0xff7f27
+
+static lv_obj_t *s_lines[SETTINGS_UI_LINES];
+static SettingsStats s_shownStats;
+static bool s_shownDirty = false;
+
+static lv_obj_t *createLabel(lv_obj_t *parent, lv_coord_t x, lv_coord_t y) {
+    lv_obj_t *label = lv_label_create(parent);
+    lv_obj_set_style_text_font(label, &lv_font_montserratMedium_9, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(label, lv_color_hex(SETTINGS_UI_TEXT_COLOR), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_pos(label, x, y);
+    lv_label_set_text(label, "");
+    return label;
+}
+
+// 屏幕被删除（离开设置屏幕）时清空所有对象指针
+static void screenDeleteCb(lv_event_t *e) {
+    for (uint8_t i = 0; i < SETTINGS_UI_LINES; i++) {
+        s_lines[i] = NULL;
+    }
+}
+
+static void refresh() {
+    settings.stats(s_shownStats);
+    s_shownDirty = settings.isDirty();
+    Settings s;
+    settings.get(s);
+    int presetCount = 0;
+    for (int i = 0; i < SETTINGS_PRESET_COUNT; i++) {
+        presetCount += s.presets[i].valid ? 1 : 0;
+    }
+    const SettingsStats &st = s_shownStats;
+
+    lv_label_set_text_fmt(s_lines[0], "U_SET  %.2fV   range %.2f - %.2fV", s.uSet, s.uSetMin, s.uSetMax);
+    lv_label_set_text_fmt(s_lines[1], "I_SET  %.2fA   range %.2f - %.2fA", s.iSet, s.iSetMin, s.iSetMax);
+    lv_label_set_text_fmt(s_lines[2], "STEP   %s", s.fineStep ? "fine" : "coarse");
+    lv_label_set_text_fmt(s_lines[3], "ADC CAL  U_IN %.3f  I_IN %.3f  U_OUT %.3f  I_OUT %.3f", s.adcFactors[0],
+                          s.adcFactors[1], s.adcFactors[2], s.adcFactors[3]);
+    lv_label_set_text_fmt(s_lines[4], "PRESETS  %d of %d", presetCount, SETTINGS_PRESET_COUNT);
+    lv_label_set_text_fmt(s_lines[5], "NVS  %s, load %luus", st.restored ? "restored" : "defaults",
+                          (unsigned long)st.loadUs);
+    lv_label_set_text_fmt(s_lines[6], "changes %lu  writes %lu  skipped %lu  failures %lu", (unsigned long)st.changes,
+                          (unsigned long)st.writes, (unsigned long)st.skipped, (unsigned long)st.failures);
+    if (st.writes > 0) {
+        lv_label_set_text_fmt(s_lines[7], "write  last %.2fms  max %.2fms", st.lastWriteUs / 1000.0f,
+                              st.maxWriteUs / 1000.0f);
+    } else {
+        lv_label_set_text(s_lines[7], "write  --");
+    }
+    lv_label_set_text_fmt(s_lines[8], "input drops %lu  written %lu   lifetime ~%lu writes", (unsigned long)st.drops,
+                          (unsigned long)st.dropWrites, (unsigned long)MySettings::lifetimeWrites());
+    lv_label_set_text(s_lines[9], s_shownDirty ? "unsaved changes" : "saved");
+    uint32_t color = s_shownDirty ? SETTINGS_UI_DIRTY_COLOR : SETTINGS_UI_TEXT_COLOR;
+    lv_obj_set_style_text_color(s_lines[9], lv_color_hex(color), LV_PART_MAIN | LV_STATE_DEFAULT);
+}
+
+void buildSettingsScreen(lv_obj_t *screen) {
+    lv_obj_set_style_bg_color(screen, lv_color_hex(SETTINGS_UI_BG_COLOR), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(screen, LV_OPA_COVER, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_event_cb(screen, screenDeleteCb, LV_EVENT_DELETE, NULL);
+
+    lv_obj_t *title = createLabel(screen, SETTINGS_UI_X, 6);
+    lv_label_set_text(title, "SETTINGS");
+    for (uint8_t i = 0; i < SETTINGS_UI_LINES; i++) {
+        s_lines[i] = createLabel(screen, SETTINGS_UI_X, SETTINGS_UI_Y + i * SETTINGS_UI_STEP);
+    }
+    refresh();
+}
+
+void updateSettingsScreen(lv_obj_t *screen) {
+    SettingsStats st;
+    settings.stats(st);
+    if (memcmp(&st, &s_shownStats, sizeof(st)) != 0 || settings.isDirty() != s_shownDirty) {
+        refresh();
+    }
+}
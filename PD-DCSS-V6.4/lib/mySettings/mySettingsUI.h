@@ -0,0 +1,23 @@
+/**
+ * @file mySettingsUI.h
+ * @brief 设置屏幕：保存的设定值、范围、步进模式和ADC校准，设置存储的写入统计
+ * @author watermelon6uice
+ * @date 2025-06-14
+ */
+
+#ifndef MY_SETTINGS_UI_H
+#define MY_SETTINGS_UI_H
+
+#include "lvgl.h"
+#include "myScreens.h"
+
+// 屏幕表的创建函数：在 screen 中创建设置屏幕的控件
+void buildSettingsScreen(lv_obj_t *screen);
+
+/**
+ * @brief 屏幕表的更新函数：记录被修改或写入后刷新
+ * @note 由 screens.update() 在UI任务中调用，只在设置屏幕显示时调用
+ */
+void updateSettingsScreen(lv_obj_t *screen);
+
+#endif // MY_SETTINGS_UI_H
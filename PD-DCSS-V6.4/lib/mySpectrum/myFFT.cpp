@@ -0,0 +1,175 @@
+/**
+ * @file myFFT.cpp
+ * @brief 基2 FFT内核：复数FFT、实数FFT（N/2点复数FFT加拆分）和窗函数
+ * @author watermelon6uice
+ * @date 2025-06-13
+ */
+
+#include "myFFT.h"
+#include <math.h>
+#include <stdlib.h>
+
+#if defined(ESP_PLATFORM) && defined(__has_include)
+#if __has_include(<esp_dsp.h>)
+#include <esp_dsp.h>
+#define FFT_USE_ESP_DSP 1
+#endif
+#endif
+#ifndef FFT_USE_ESP_DSP
+#define FFT_USE_ESP_DSP 0
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// 旋转因子 exp(-j*2*pi*k/FFT_MAX_POINTS)，k = 0 .. FFT_MAX_POINTS/2 - 1，实部、虚部交错
+static float *s_twiddle = NULL;
+
+bool fftIsValidSize(uint32_t n) {
+    return n >= FFT_MIN_POINTS && n <= FFT_MAX_POINTS && (n & (n - 1)) == 0;
+}
+
+bool fftInit() {
+    if (s_twiddle != NULL) {
+        return true;
+    }
+    float *table = (float *)malloc(FFT_MAX_POINTS * sizeof(float));
+    if (table == NULL) {
+        return false;
+    }
+    for (int k = 0; k < FFT_MAX_POINTS / 2; k++) {
+        // 双精度计算后再取整，避免大点数时的相位累积误差
+        double a = -2.0 * M_PI * k / FFT_MAX_POINTS;
+        table[2 * k] = (float)cos(a);
+        table[2 * k + 1] = (float)sin(a);
+    }
+#if FFT_USE_ESP_DSP
+    if (dsps_fft2r_init_fc32(NULL, FFT_MAX_POINTS / 2) != ESP_OK) {
+        free(table);
+        return false;
+    }
+#endif
+    s_twiddle = table;
+    return true;
+}
+
+#if !FFT_USE_ESP_DSP
+// 按位反转重排
+static void bitReverse(float *data, uint16_t n) {
+    for (uint16_t i = 1, j = 0; i < n; i++) {
+        uint16_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            float re = data[2 * i];
+            float im = data[2 * i + 1];
+            data[2 * i] = data[2 * j];
+            data[2 * i + 1] = data[2 * j + 1];
+            data[2 * j] = re;
+            data[2 * j + 1] = im;
+        }
+    }
+}
+#endif
+
+bool fftComplex(float *data, uint16_t n) {
+    if (data == NULL || n < 2 || n > FFT_MAX_POINTS / 2 || (n & (n - 1)) != 0 || !fftInit()) {
+        return false;
+    }
+#if FFT_USE_ESP_DSP
+    dsps_fft2r_fc32(data, n);
+    dsps_bit_rev_fc32(data, n);
+#else
+    bitReverse(data, n);
+    // 逐级蝶形运算（时间抽取），第 len 级的旋转因子在表中的步长为 FFT_MAX_POINTS / len
+    for (uint16_t len = 2; len <= n; len <<= 1) {
+        uint16_t half = len >> 1;
+        uint16_t stride = FFT_MAX_POINTS / len;
+        for (uint16_t i = 0; i < n; i += len) {
+            for (uint16_t k = 0; k < half; k++) {
+                float wr = s_twiddle[2 * k * stride];
+                float wi = s_twiddle[2 * k * stride + 1];
+                float *a = &data[2 * (i + k)];
+                float *b = &data[2 * (i + k + half)];
+                float tr = b[0] * wr - b[1] * wi;
+                float ti = b[0] * wi + b[1] * wr;
+                b[0] = a[0] - tr;
+                b[1] = a[1] - ti;
+                a[0] += tr;
+                a[1] += ti;
+            }
+        }
+    }
+#endif
+    return true;
+}
+
+bool fftReal(float *data, uint16_t n) {
+    if (data == NULL || !fftIsValidSize(n)) {
+        return false;
+    }
+    // 偶数、奇数样本分别作为实部、虚部，做 n/2 点复数FFT
+    uint16_t m = n / 2;
+    if (!fftComplex(data, m)) {
+        return false;
+    }
+
+    // 拆分：X[k] = (Z[k] + conj(Z[m-k])) / 2 + W^k * (Z[k] - conj(Z[m-k])) / 2j，W = exp(-j*2*pi/n)
+    float z0r = data[0];
+    float z0i = data[1];
+    data[0] = z0r + z0i;    // 直流
+    data[1] = z0r - z0i;    // 奈奎斯特
+    uint16_t stride = FFT_MAX_POINTS / n;
+    for (uint16_t k = 1; k <= m / 2; k++) {
+        uint16_t j = m - k;
+        float ar = data[2 * k];
+        float ai = data[2 * k + 1];
+        float br = data[2 * j];
+        float bi = data[2 * j + 1];
+        float er = 0.5f * (ar + br);        // 偶数样本的频谱
+        float ei = 0.5f * (ai - bi);
+        float orr = 0.5f * (ai + bi);       // 奇数样本的频谱
+        float oi = -0.5f * (ar - br);
+        float wr = s_twiddle[2 * k * stride];
+        float wi = s_twiddle[2 * k * stride + 1];
+        float tr = orr * wr - oi * wi;
+        float ti = orr * wi + oi * wr;
+        data[2 * k] = er + tr;
+        data[2 * k + 1] = ei + ti;
+        // X[m-k] = conj(E[k] - W^k O[k])
+        data[2 * j] = er - tr;
+        data[2 * j + 1] = -(ei - ti);
+    }
+    return true;
+}
+
+float fftWindowFill(float *w, uint16_t n, FftWindow type) {
+    double sumSq = 0.0;
+    for (uint16_t i = 0; i < n; i++) {
+        // 周期窗（分母为n），频点正好落在主瓣的整数位置
+        double x = 2.0 * M_PI * i / n;
+        double v;
+        switch (type) {
+            case FFT_WINDOW_HANN:
+                v = 0.5 - 0.5 * cos(x);
+                break;
+            case FFT_WINDOW_FLATTOP:
+                v = 0.21557895 - 0.41663158 * cos(x) + 0.277263158 * cos(2 * x) -
+                    0.083578947 * cos(3 * x) + 0.006947368 * cos(4 * x);
+                break;
+            default:
+                v = 1.0;
+                break;
+        }
+        w[i] = (float)v;
+        sumSq += v * v;
+    }
+    return (float)sumSq;
+}
+
+const char *fftBackendName() {
+    return FFT_USE_ESP_DSP ? "esp-dsp" : "scalar";
+}
@@ -0,0 +1,61 @@
+/**
+ * @file myFFT.h
+ * @brief 基2 FFT内核：复数FFT、实数FFT（N/2点复数FFT加拆分）和窗函数
+ * @author watermelon6uice
+ * @details
+ * 固件构建中若能找到 esp-dsp（Arduino-ESP32自带），复数FFT交给 dsps_fft2r_fc32，
+ * ESP32-S3上它是用PIE向量指令写的汇编实现；否则（包括主机构建）使用可移植的标量实现。
+ * 两种实现共用同一张旋转因子表和实数拆分步骤，输出一致。
+ * 不可重入：同一时间只能有一个调用者（频谱分析只在一个任务中运行）。
+ * @date 2025-06-13
+ */
+
+#ifndef MY_FFT_H
+#define MY_FFT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define FFT_MIN_POINTS 16
+#define FFT_MAX_POINTS 4096     // 实数FFT的最大点数
+
+enum FftWindow {
+    FFT_WINDOW_RECT = 0,
+    FFT_WINDOW_HANN,            // 主瓣 ±2 个频点，适合按频带求功率
+    FFT_WINDOW_FLATTOP,         // 主瓣 ±5 个频点，单频点幅值误差 < 0.01dB
+};
+
+// n 是否为 FFT_MIN_POINTS ~ FFT_MAX_POINTS 之间的2的幂
+bool fftIsValidSize(uint32_t n);
+
+/**
+ * @brief 分配旋转因子表（FFT_MAX_POINTS 对应的表，约16KB），之后各种点数共用
+ * @return 已初始化或初始化成功返回true
+ */
+bool fftInit();
+
+/**
+ * @brief 原地复数FFT（正变换，不归一化）
+ * @param data 交错存放的实部、虚部，共 2n 个 float
+ * @param n 复数点数，2的幂，不超过 FFT_MAX_POINTS / 2
+ */
+bool fftComplex(float *data, uint16_t n);
+
+/**
+ * @brief 原地实数FFT（正变换，不归一化）
+ * @param data n 个实数样本；输出为压缩的半频谱：data[0] 为直流，data[1] 为奈奎斯特频点（均为实数），
+ *             data[2k]、data[2k+1] 为第k个频点的实部、虚部（1 <= k < n/2）
+ * @param n 实数点数，fftIsValidSize(n)
+ */
+bool fftReal(float *data, uint16_t n);
+
+/**
+ * @brief 生成窗函数
+ * @return 窗函数的平方和（按频带换算功率时用）
+ */
+float fftWindowFill(float *w, uint16_t n, FftWindow type);
+
+// 当前使用的复数FFT实现（"esp-dsp" 或 "scalar"）
+const char *fftBackendName();
+
+#endif // MY_FFT_H
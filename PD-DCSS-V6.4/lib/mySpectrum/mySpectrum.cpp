@@ -0,0 +1,259 @@
+/**
+ * @file mySpectrum.cpp
+ * @brief 输出纹波和噪声的频谱分析：对U_OUT的一段连续采样做加窗FFT
+ * @author watermelon6uice
+ * @date 2025-06-13
+ */
+
+#include "mySpectrum.h"
+#include "myCapture.h"
+#include "esp_heap_caps.h"
+#include <math.h>
+#include <string.h>
+
+MySpectrum spectrum;
+
+static const char *const WINDOW_NAMES[] = {"矩形", "Hann", "平顶"};
+
+// 单频信号在频谱中占据的半宽（频点数），覆盖窗函数的主瓣
+static const uint8_t TONE_HALF_BINS[] = {3, 3, 6};
+
+SpectrumConfig spectrumDefaultConfig() {
+    SpectrumConfig c;
+    c.points = SPECTRUM_DEFAULT_POINTS;
+    c.sampleHz = SPECTRUM_DEFAULT_SAMPLE_HZ;
+    c.switchingHz = SPECTRUM_DEFAULT_SWITCHING_HZ;
+    c.harmonics = SPECTRUM_MAX_HARMONICS;
+    c.bandLowHz = 100.0f;
+    c.bandHighHz = 0.0f;
+    c.window = FFT_WINDOW_HANN;
+    return c;
+}
+
+MySpectrum::MySpectrum() :
+    _buf(NULL),
+    _window(NULL),
+    _windowPoints(0),
+    _windowType(0),
+    _windowSumSq(0.0f),
+    _pending(false),
+    _pendingGeneration(0),
+    _haveResult(false)
+{
+    memset(_toneMask, 0, sizeof(_toneMask));
+    memset(&_result, 0, sizeof(_result));
+}
+
+// 工作区放在内部RAM（FFT反复访问，PSRAM慢很多），不够时退到任意内存
+static float *allocFloats(size_t count) {
+    float *p = (float *)heap_caps_malloc(count * sizeof(float), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (p == NULL) {
+        p = (float *)heap_caps_malloc(count * sizeof(float), MALLOC_CAP_8BIT);
+    }
+    return p;
+}
+
+bool MySpectrum::prepare(const SpectrumConfig &c) {
+    if (!fftIsValidSize(c.points) || c.sampleHz == 0 || c.harmonics > SPECTRUM_MAX_HARMONICS ||
+        c.window > FFT_WINDOW_FLATTOP || c.switchingHz < 0.0f) {
+        return false;
+    }
+    if (_buf == NULL) {
+        _buf = allocFloats(FFT_MAX_POINTS);
+    }
+    if (_window == NULL) {
+        _window = allocFloats(FFT_MAX_POINTS);
+    }
+    if (_buf == NULL || _window == NULL || !fftInit()) {
+        Serial.println("频谱分析: 内存不足");
+        return false;
+    }
+    if (_windowPoints != c.points || _windowType != c.window) {
+        _windowSumSq = fftWindowFill(_window, c.points, (FftWindow)c.window);
+        _windowPoints = c.points;
+        _windowType = c.window;
+    }
+    return true;
+}
+
+double MySpectrum::sumPower(uint32_t first, uint32_t last, bool skipTones, uint32_t *bins) const {
+    double sum = 0.0;
+    uint32_t count = 0;
+    for (uint32_t k = first; k <= last; k++) {
+        if (skipTones && isTone(k)) {
+            continue;
+        }
+        sum += (double)_buf[2 * k] * _buf[2 * k] + (double)_buf[2 * k + 1] * _buf[2 * k + 1];
+        count++;
+    }
+    if (bins != NULL) {
+        *bins = count;
+    }
+    return sum;
+}
+
+void MySpectrum::markTone(uint32_t first, uint32_t last) {
+    for (uint32_t k = first; k <= last; k++) {
+        _toneMask[k >> 5] |= 1u << (k & 31);
+    }
+}
+
+bool MySpectrum::analyze(const float *samples, const SpectrumConfig &config, SpectrumResult &out) {
+    if (samples == NULL || !prepare(config)) {
+        return false;
+    }
+    const uint16_t n = config.points;
+    const uint32_t half = n / 2;
+    memset(&out, 0, sizeof(out));
+    out.points = n;
+    out.sampleHz = config.sampleHz;
+    out.binHz = (float)config.sampleHz / n;
+    out.window = config.window;
+
+    // 直流和交流有效值在时域计算（双精度，毫伏级纹波叠加在几伏直流上）
+    double sum = 0.0;
+    for (uint16_t i = 0; i < n; i++) {
+        sum += samples[i];
+    }
+    double mean = sum / n;
+    double sumSq = 0.0;
+    for (uint16_t i = 0; i < n; i++) {
+        double d = samples[i] - mean;
+        sumSq += d * d;
+    }
+    out.dc = (float)mean;
+    out.acRms = (float)sqrt(sumSq / n);
+
+    // 去掉直流后加窗；samples 可以就是工作区（逐个样本原地改写）
+    unsigned long t0 = micros();
+    for (uint16_t i = 0; i < n; i++) {
+        _buf[i] = (float)(samples[i] - mean) * _window[i];
+    }
+    fftReal(_buf, n);
+    out.fftUs = micros() - t0;
+
+    // 单边频谱：均方值 = 2 * sum(|X[k]|^2) / (N * sum(w^2))
+    const double scale = 2.0 / ((double)n * _windowSumSq);
+    const uint32_t hw = TONE_HALF_BINS[config.window];
+    const float fs = (float)config.sampleHz;
+    memset(_toneMask, 0, sizeof(_toneMask));
+
+    // 开关频率的各次谐波：折叠到 0 ~ fs/2，取主瓣内的功率
+    if (config.switchingHz > 0.0f) {
+        for (uint8_t h = 1; h <= config.harmonics; h++) {
+            SpectrumTone &t = out.tones[out.toneCount++];
+            t.hz = config.switchingHz * h;
+            float alias = fmodf(t.hz, fs);
+            if (alias > fs / 2.0f) {
+                alias = fs - alias;
+            }
+            t.aliasHz = alias;
+            int32_t center = (int32_t)lroundf(alias / out.binHz);
+            int32_t lo = center - (int32_t)hw;
+            int32_t hi = center + (int32_t)hw;
+            uint32_t first = lo < 1 ? 1 : (uint32_t)lo;
+            uint32_t last = hi > (int32_t)half - 1 ? half - 1 : (uint32_t)hi;
+            t.rms = (float)sqrt(scale * sumPower(first, last, false, NULL));
+            markTone(first, last);
+        }
+    }
+
+    // 噪声频带
+    float high = config.bandHighHz > 0.0f && config.bandHighHz < fs / 2.0f ? config.bandHighHz : fs / 2.0f;
+    uint32_t first = (uint32_t)ceilf(config.bandLowHz / out.binHz);
+    uint32_t last = (uint32_t)floorf(high / out.binHz);
+    first = first < 1 ? 1 : first;
+    last = last > half - 1 ? half - 1 : last;
+    if (first <= last) {
+        uint32_t total = last - first + 1;
+        uint32_t rest = 0;
+        out.bandRms = (float)sqrt(scale * sumPower(first, last, false, NULL));
+        double noise = sumPower(first, last, true, &rest);
+        // 扣除谐波占用的频点后，按剩余频点的平均功率推算整个频带
+        out.noiseRms = rest > 0 ? (float)sqrt(scale * noise * total / rest) : 0.0f;
+    }
+
+    // 最大分量
+    uint32_t peak = 1;
+    double peakPower = -1.0;
+    for (uint32_t k = 1; k < half; k++) {
+        double p = (double)_buf[2 * k] * _buf[2 * k] + (double)_buf[2 * k + 1] * _buf[2 * k + 1];
+        if (p > peakPower) {
+            peakPower = p;
+            peak = k;
+        }
+    }
+    uint32_t pFirst = peak > hw ? peak - hw : 1;
+    uint32_t pLast = peak + hw > half - 1 ? half - 1 : peak + hw;
+    out.peakHz = peak * out.binHz;
+    out.peakRms = (float)sqrt(scale * sumPower(pFirst, pLast, false, NULL));
+    return true;
+}
+
+bool MySpectrum::request(const SpectrumConfig &config) {
+    if (!prepare(config)) {
+        return false;
+    }
+    CaptureConfig c = captureDefaultConfig();
+    c.channelMask = CAPTURE_MASK(CAPTURE_U_OUT);
+    c.sampleHz = config.sampleHz;
+    c.depth = config.points;
+    c.preTrigger = 0;
+    c.source = CAPTURE_U_OUT;
+    c.edge = CAPTURE_TRIG_NONE;
+    c.autoMs = 0;
+    _pendingGeneration = capture.generation();
+    if (!capture.arm(c)) {
+        return false;
+    }
+    _pendingConfig = config;
+    _pending = true;
+    return true;
+}
+
+void MySpectrum::poll() {
+    if (!_pending) {
+        return;
+    }
+    CaptureState state = capture.state();
+    uint32_t generation = capture.generation();
+    if (state == CAPTURE_ARMED) {
+        return;
+    }
+    if (state != CAPTURE_DONE || generation != _pendingGeneration + 1) {
+        // 采集失败、被取消或被别的捕获覆盖
+        _pending = false;
+        Serial.println("频谱分析: 采集没有完成");
+        return;
+    }
+    _pending = false;
+
+    // 样本直接读入工作区，analyze() 原地处理
+    for (uint16_t i = 0; i < _pendingConfig.points; i++) {
+        _buf[i] = capture.sample(i, CAPTURE_U_OUT);
+    }
+    if (capture.generation() != generation) {
+        Serial.println("频谱分析: 读取期间捕获被覆盖");
+        return;
+    }
+    if (analyze(_buf, _pendingConfig, _result)) {
+        _haveResult = true;
+        printReport(_result);
+    }
+}
+
+void MySpectrum::printReport(const SpectrumResult &r) {
+    Serial.println("===== 输出纹波频谱 =====");
+    Serial.printf("%u点 %luHz 分辨率%.1fHz %s窗 内核%s FFT耗时%luus\n", r.points, (unsigned long)r.sampleHz,
+                  r.binHz, WINDOW_NAMES[r.window], fftBackendName(), (unsigned long)r.fftUs);
+    Serial.printf("直流 %.4fV  交流有效值 %.3fmV\n", r.dc, r.acRms * 1000.0f);
+    if (r.toneCount > 0) {
+        Serial.println("  谐波       频率      折叠后     有效值");
+        for (uint8_t i = 0; i < r.toneCount; i++) {
+            const SpectrumTone &t = r.tones[i];
+            Serial.printf("  %2u   %9.0fHz %9.0fHz %8.3fmV\n", i + 1, t.hz, t.aliasHz, t.rms * 1000.0f);
+        }
+    }
+    Serial.printf("频带内总有效值 %.3fmV  扣除谐波后噪声 %.3fmV\n", r.bandRms * 1000.0f, r.noiseRms * 1000.0f);
+    Serial.printf("最大分量 %.0fHz %.3fmV\n", r.peakHz, r.peakRms * 1000.0f);
+}
@@ -0,0 +1,112 @@
+/**
+ * @file mySpectrum.h
+ * @brief 输出纹波和噪声的频谱分析：对U_OUT的一段连续采样做加窗FFT
+ * @author watermelon6uice
+ * @details
+ * request() 用波形捕获（myCapture）只采集U_OUT，立即触发，深度等于FFT点数；
+ * poll() 在捕获完成后做分析并从串口输出。分析内容：
+ * - 直流分量和交流有效值（时域计算）；
+ * - 开关频率及其各次谐波的有效值：每个谐波按采样率折叠到 0 ~ fs/2 之间（开关频率通常
+ *   高于奈奎斯特频率，ADC的采样保持带宽远高于采样率，纹波以折叠后的频率出现），
+ *   取该频点左右几个频点（窗函数主瓣宽度）的功率之和，与频点是否对齐无关；
+ * - 指定频带内的总有效值，以及扣除各谐波之后的噪声有效值（用剩余频点的平均功率密度
+ *   推算整个频带）；
+ * - 最大的频谱分量。
+ * 功率换算：频带内单边频谱的均方值 = 2 * sum(|X[k]|^2) / (N * sum(w^2))。
+ * @date 2025-06-13
+ */
+
+#ifndef MY_SPECTRUM_H
+#define MY_SPECTRUM_H
+
+#include <Arduino.h>
+#include "myFFT.h"
+
+#define SPECTRUM_MAX_HARMONICS 5
+#define SPECTRUM_DEFAULT_POINTS 2048
+#define SPECTRUM_DEFAULT_SAMPLE_HZ 80000         // 只采集U_OUT，接近连续采样的上限
+#define SPECTRUM_DEFAULT_SWITCHING_HZ 150000.0f  // 降压变换器的开关频率
+
+struct SpectrumConfig {
+    uint16_t points;         // FFT点数，fftIsValidSize()
+    uint32_t sampleHz;       // 采样率
+    float switchingHz;       // 开关频率（基波），0表示不统计谐波
+    uint8_t harmonics;       // 统计的谐波次数（含基波），不超过 SPECTRUM_MAX_HARMONICS
+    float bandLowHz;         // 噪声频带下限
+    float bandHighHz;        // 噪声频带上限，0表示到奈奎斯特频率
+    uint8_t window;          // FftWindow
+};
+
+// 默认配置：2048点、80kHz（频率分辨率约39Hz），Hann窗，5次谐波，频带 100Hz ~ fs/2
+SpectrumConfig spectrumDefaultConfig();
+
+struct SpectrumTone {
+    float hz;                // 谐波频率
+    float aliasHz;           // 在频谱中出现的位置（折叠后）
+    float rms;               // 有效值(V)
+};
+
+struct SpectrumResult {
+    uint16_t points;
+    uint32_t sampleHz;
+    float binHz;             // 频率分辨率
+    uint8_t window;          // FftWindow
+    float dc;                // 直流分量(V)
+    float acRms;             // 交流有效值(V)，时域计算
+    uint8_t toneCount;
+    SpectrumTone tones[SPECTRUM_MAX_HARMONICS];
+    float bandRms;           // 频带内总有效值
+    float noiseRms;          // 频带内扣除谐波后的噪声有效值
+    float peakHz;            // 最大的频谱分量
+    float peakRms;
+    uint32_t fftUs;          // 加窗和FFT的耗时
+};
+
+class MySpectrum {
+public:
+    MySpectrum();
+
+    /**
+     * @brief 分析一段等间隔样本（主机测试直接调用）
+     * @param samples 样本(V)，个数等于 config.points
+     * @return 配置无效或内存不足时返回false
+     */
+    bool analyze(const float *samples, const SpectrumConfig &config, SpectrumResult &out);
+
+    /**
+     * @brief 开始一次采集（覆盖示波器当前的捕获），完成后由 poll() 分析并输出
+     * @return 配置无效或捕获无法开始时返回false
+     */
+    bool request(const SpectrumConfig &config);
+
+    // 在 loop() 中调用：请求的采集完成后做分析并从串口输出，之后结果可由 lastResult() 读取
+    void poll();
+
+    bool hasResult() const { return _haveResult; }
+    const SpectrumResult &lastResult() const { return _result; }
+
+    static void printReport(const SpectrumResult &result);
+
+private:
+    float *_buf;             // FFT工作区
+    float *_window;
+    uint16_t _windowPoints;  // 当前窗函数的点数和类型，变化时重新生成
+    uint8_t _windowType;
+    float _windowSumSq;
+    uint32_t _toneMask[FFT_MAX_POINTS / 2 / 32];   // 属于某个谐波的频点
+
+    bool _pending;
+    uint32_t _pendingGeneration;   // 请求时的捕获序号，完成后应为它加1
+    SpectrumConfig _pendingConfig;
+    bool _haveResult;
+    SpectrumResult _result;
+
+    bool prepare(const SpectrumConfig &config);
+    double sumPower(uint32_t first, uint32_t last, bool skipTones, uint32_t *bins) const;
+    void markTone(uint32_t first, uint32_t last);
+    bool isTone(uint32_t k) const { return (_toneMask[k >> 5] >> (k & 31)) & 1; }
+};
+
+extern MySpectrum spectrum;
+
+#endif // MY_SPECTRUM_H
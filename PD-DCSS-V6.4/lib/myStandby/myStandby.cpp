@@ -0,0 +1,166 @@
+/**
+ * @file myStandby.cpp
+ * @brief 待机：输出关闭时由DAC关断输出、屏幕变暗、低速率测量，保护保持有效，毫秒级恢复
+ * @author watermelon6uice
+ * @date 2025-06-14
+ */
+
+#include "myStandby.h"
+#include "myHAL.h"
+#include "mySystemState.h"
+#include "myBacklight.h"
+#include <string.h>
+
+MyStandby standby;
+
+static const char *const STATE_NAMES[STANDBY_STATE_COUNT] = {"运行", "进入待机中", "待机", "恢复中"};
+
+MyStandby::MyStandby() :
+    _state(STANDBY_ACTIVE),
+    _controlTask(NULL),
+    _awaitingDac(false),
+    _requestUs(0),
+    _idleSinceUs(0)
+{
+    portMUX_TYPE unlocked = portMUX_INITIALIZER_UNLOCKED;
+    _mux = unlocked;
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void MyStandby::setControlTask(TaskHandle_t task) {
+    _controlTask = task;
+}
+
+void MyStandby::enter() {
+    uint64_t now = halMicros();
+    portENTER_CRITICAL(&_mux);
+    if (_state == STANDBY_ENTERING || _state == STANDBY_IDLE) {
+        portEXIT_CRITICAL(&_mux);
+        return;
+    }
+    _state = STANDBY_ENTERING;
+    _requestUs = now;
+    _stats.entries++;
+    portEXIT_CRITICAL(&_mux);
+
+    // 限流任务在下一个周期（最多 REGULATOR_PERIOD_MS）关断DAC
+    systemState.setOutputEnabled(false);
+    backlight.dimNow();
+}
+
+void MyStandby::resume() {
+    uint64_t now = halMicros();
+    portENTER_CRITICAL(&_mux);
+    if (_state == STANDBY_ACTIVE || _state == STANDBY_RESUMING) {
+        portEXIT_CRITICAL(&_mux);
+        return;
+    }
+    if (_state == STANDBY_IDLE) {
+        _stats.standbyUs += now - _idleSinceUs;
+    }
+    // 进入中：限流任务还没有关断DAC，不会再写一次设定值，直接回到运行，不计用时
+    _state = _state == STANDBY_ENTERING ? STANDBY_ACTIVE : STANDBY_RESUMING;
+    _awaitingDac = false;
+    _requestUs = now;
+    _stats.resumes++;
+    portEXIT_CRITICAL(&_mux);
+
+    systemState.setOutputEnabled(true);
+    // 限流任务在待机周期中等待通知，收到后立即运行，不等周期结束
+    if (_controlTask != NULL) {
+        xTaskNotifyGive(_controlTask);
+    }
+}
+
+void MyStandby::outputOff() {
+    uint64_t now = halMicros();
+    portENTER_CRITICAL(&_mux);
+    _stats.frames++;
+    if (_state == STANDBY_ENTERING) {
+        uint32_t us = (uint32_t)(now - _requestUs);
+        _stats.lastEnterUs = us;
+        if (us > _stats.maxEnterUs) {
+            _stats.maxEnterUs = us;
+        }
+    }
+    _awaitingDac = false;
+    if (_state == STANDBY_ENTERING || _state == STANDBY_ACTIVE) {
+        _state = STANDBY_IDLE;
+        _idleSinceUs = now;
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyStandby::outputOn(bool driving) {
+    uint64_t now = halMicros();
+    portENTER_CRITICAL(&_mux);
+    if (_state == STANDBY_RESUMING) {
+        if (driving) {
+            // 计时到DAC任务写入为止（dacApplied）
+            _awaitingDac = true;
+        } else {
+            // 保护锁存，输出保持0V：恢复结束，不计用时
+            _awaitingDac = false;
+            _stats.resumesTripped++;
+            _state = STANDBY_ACTIVE;
+        }
+    } else if (_state == STANDBY_IDLE) {
+        // 没有经过 resume() 打开了输出
+        _stats.standbyUs += now - _idleSinceUs;
+        _state = STANDBY_ACTIVE;
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyStandby::onDacApplied(uint32_t tag, void *ctx) {
+    (void)tag;
+    MyStandby *self = static_cast<MyStandby *>(ctx);
+    // DAC任务每次写入都调用，没有等待的恢复时只读一个标志
+    if (!self->_awaitingDac) {
+        return;
+    }
+    uint64_t now = halMicros();
+    portENTER_CRITICAL(&self->_mux);
+    if (self->_awaitingDac && self->_state == STANDBY_RESUMING) {
+        uint32_t us = (uint32_t)(now - self->_requestUs);
+        self->_stats.resumesMeasured++;
+        self->_stats.lastResumeUs = us;
+        self->_stats.totalResumeUs += us;
+        if (us > self->_stats.maxResumeUs) {
+            self->_stats.maxResumeUs = us;
+        }
+        self->_state = STANDBY_ACTIVE;
+    }
+    self->_awaitingDac = false;
+    portEXIT_CRITICAL(&self->_mux);
+}
+
+void MyStandby::stats(StandbyStats &out) const {
+    uint64_t now = halMicros();
+    portENTER_CRITICAL(&_mux);
+    out = _stats;
+    if (_state == STANDBY_IDLE) {
+        out.standbyUs += now - _idleSinceUs;
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyStandby::printReport() const {
+    StandbyStats st;
+    stats(st);
+    Serial.println("===== 待机 =====");
+    Serial.printf("状态: %s  累计待机 %lus  待机期间保护检查 %lu帧\n", STATE_NAMES[_state],
+                  (unsigned long)(st.standbyUs / 1000000), (unsigned long)st.frames);
+    if (st.entries > 0) {
+        Serial.printf("进入待机: %lu次  从请求到DAC关断 最近 %.2fms  最长 %.2fms\n", (unsigned long)st.entries,
+                      st.lastEnterUs / 1000.0f, st.maxEnterUs / 1000.0f);
+    }
+    if (st.resumesMeasured > 0) {
+        Serial.printf("恢复输出: %lu次  从请求到DAC写入 最近 %.2fms  平均 %.2fms  最长 %.2fms\n",
+                      (unsigned long)st.resumes, st.lastResumeUs / 1000.0f,
+                      st.totalResumeUs / 1000.0f / st.resumesMeasured, st.maxResumeUs / 1000.0f);
+    }
+    if (st.resumesTripped > 0) {
+        Serial.printf("保护锁存时恢复（输出保持0V，不计用时）: %lu次\n", (unsigned long)st.resumesTripped);
+    }
+}
@@ -0,0 +1,92 @@
+/**
+ * @file myStandby.h
+ * @brief 待机：输出关闭时由DAC关断输出、屏幕变暗、低速率测量，保护保持有效，毫秒级恢复
+ * @author watermelon6uice
+ * @details
+ * 以前状态按钮切到OFF时 MyStateButton 调用 esp_light_sleep_start() 让整个芯片睡眠，
+ * U_IN的测量和保护全部停止；唤醒后靠几段100ms/50ms的延时和标志位恢复。
+ *
+ * 现在OFF只是一个状态，所有任务照常运行：
+ * - 进入（enter）：发布输出关闭，背光立即变暗（之后按背光的设置熄屏）；
+ *   限流任务看到后直接把DAC写0（shutdownDAC，丢弃队列中的值），然后每
+ *   REGULATOR_STANDBY_PERIOD_MS 读取一个采集帧交给输出保护，输入欠压、DAC关断后
+ *   输出仍有电压等情况照常触发告警；显示用的测量值每2秒更新一次；
+ * - 恢复（resume）：发布输出打开并用任务通知立即唤醒限流任务，不等待它的待机周期，
+ *   限流任务解除DAC关断并写回设定值，DAC任务写入SPI后经 onDacApplied()
+ *   （用 addDACAppliedHandler() 登记）结束恢复。
+ * 状态：运行 -> 进入中（等限流任务关断DAC）-> 待机 -> 恢复中（等DAC任务写入设定值）-> 运行，
+ * 进入中请求恢复时直接回到运行。
+ * 进入记录从请求到限流任务关断DAC的时间，恢复记录从请求到DAC任务写入SPI的时间（最近一次和最大值）。
+ * 恢复时保护仍然锁存（DAC保持0V）的不计恢复用时，单独计数。
+ * 没有经过 enter()/resume() 的输出开关变化（启动时发布的初始状态等）也会被限流任务
+ * 报告，状态随之改变，但不计入次数和时间。
+ * @date 2025-06-14
+ */
+
+#ifndef MY_STANDBY_H
+#define MY_STANDBY_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+enum StandbyState {
+    STANDBY_ACTIVE = 0,      // 输出打开
+    STANDBY_ENTERING,        // 已请求待机，等限流任务关断DAC
+    STANDBY_IDLE,            // 待机：DAC关断，低速率测量，保护有效
+    STANDBY_RESUMING,        // 已请求恢复，等限流任务写回设定值
+    STANDBY_STATE_COUNT
+};
+
+struct StandbyStats {
+    uint32_t entries;                // 进入待机的次数
+    uint32_t lastEnterUs;            // 从请求到DAC关断
+    uint32_t maxEnterUs;
+    uint32_t resumes;                // 恢复的次数
+    uint32_t resumesMeasured;        // 其中计入用时的次数
+    uint32_t resumesTripped;         // 保护锁存、输出保持0V的恢复，不计用时
+    uint32_t lastResumeUs;           // 从请求到DAC任务写入SPI
+    uint32_t maxResumeUs;
+    uint64_t totalResumeUs;
+    uint32_t frames;                 // 待机期间交给保护检查的采集帧
+    uint64_t standbyUs;              // 累计待机时间（DAC关断到恢复）
+};
+
+class MyStandby {
+public:
+    MyStandby();
+
+    // 登记限流任务，resume() 用任务通知唤醒它
+    void setControlTask(TaskHandle_t task);
+
+    // 请求待机/恢复（在任务中调用，重复调用时不做任何事）
+    void enter();
+    void resume();
+
+    // 由限流任务调用：输出关闭时每个待机周期调用 outputOff()（DAC已关断、采集帧已交给保护），
+    // 输出打开且 isStandby() 时在写DAC之前调用 outputOn()；driving 为false表示保护锁存、DAC保持0V
+    void outputOff();
+    void outputOn(bool driving);
+
+    // DAC任务写入SPI之后调用（用 addDACAppliedHandler() 登记，ctx 为 MyStandby）
+    static void onDacApplied(uint32_t tag, void *ctx);
+
+    StandbyState state() const { return _state; }
+    bool isStandby() const { return _state != STANDBY_ACTIVE; }
+
+    void stats(StandbyStats &out) const;
+    void printReport() const;
+
+private:
+    mutable portMUX_TYPE _mux;
+    volatile StandbyState _state;
+    TaskHandle_t _controlTask;
+    volatile bool _awaitingDac;      // 限流任务已写回设定值，等DAC任务写入
+    uint64_t _requestUs;             // 最近一次 enter()/resume() 的时刻
+    uint64_t _idleSinceUs;           // 进入待机状态的时刻
+    StandbyStats _stats;
+};
+
+extern MyStandby standby;
+
+#endif // MY_STANDBY_H
@@ -1,6 +1,6 @@
 /**
  * @file myStateButton.cpp
- * @brief 使用按钮控制程序的ON/OFF状态。OFF状态下ESP32进入低功耗轻睡眠模式。
+ * @brief 使用按钮控制程序的ON/OFF状态。OFF状态下进入待机（myStandby）。
  * @author watermelon6uice
  * @date 2025-05-15
  */
@@ -14,9 +14,6 @@
 #include "freertos/queue.h"
 #include "freertos/semphr.h"
 #include "freertos/event_groups.h"
-#include "esp_system.h"
-#include "esp_sleep.h"
-#include "driver/rtc_io.h"
 
 class MyStateButton {
 public:
@@ -48,17 +45,11 @@ public:
     // 设置系统事件组（可选，用于事件通知）
     void setSystemEvents(EventGroupHandle_t* eventGroupPtr);
     
-    // 设置任务控制互斥量和标志（用于控制数据采样任务）
-    void setTaskControl(SemaphoreHandle_t* mutexPtr, volatile bool* runningFlagPtr);
+    // 把当前状态发布到共享系统状态（输出开关），数据采样和DAC任务据此启停
+    void publishState();
     
-    // 进入轻睡眠模式
-    void enterLightSleep();
-    
-    // 退出轻睡眠模式
-    void exitLightSleep();
-    
-    // 检查是否处于睡眠模式
-    bool isInSleepMode() const;
+    // 检查是否处于待机（包括正在进入和正在恢复）
+    bool isInStandby() const;
     
     // UI回调函数
     typedef void (*UIUpdateCallback)(bool isOn);
@@ -71,8 +62,6 @@ private:
     // 状态跟踪
     bool _state;
     
-    // 进入轻睡眠的步骤
-    void _enterLightSleepInternal();
       // 按钮任务的静态方法
     static void _buttonTask(void* parameter);
     
@@ -98,12 +87,6 @@ private:
     unsigned long _lastDebounceTime;
     static const unsigned long _debounceDelay = 30; // 减少防抖时间提高响应性
     
-    // 睡眠模式标志
-    bool _inSleepMode;
-    
-    // 用于跟踪从睡眠唤醒后的按钮释放动作
-    bool _wakeupButtonRelease;
-    
     // 状态变化回调
     StateChangeCallback _stateChangeCallback;
     
@@ -116,9 +99,6 @@ private:
     // 数据互斥量指针
     SemaphoreHandle_t* _dataMutexPtr;
     
-    // 任务控制互斥量和标志指针
-    SemaphoreHandle_t* _taskControlMutexPtr;
-    volatile bool* _dataTaskRunningPtr;
       // 事件定义
     static const uint32_t UI_UPDATE_EVENT = (1 << 0);
     static const uint32_t DATA_READY_EVENT = (1 << 1);
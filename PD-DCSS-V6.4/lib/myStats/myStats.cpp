@@ -0,0 +1,248 @@
+/**
+ * @file myStats.cpp
+ * @brief 滑动窗口统计：按采集帧计算各通道在最近若干秒内的最小、最大、平均、RMS和标准差
+ * @author watermelon6uice
+ * @date 2025-06-13
+ */
+
+#include "myStats.h"
+#include <math.h>
+
+MyStats stats;
+
+static const uint16_t DEFAULT_WINDOW_S[STATS_WINDOWS] = {1, 10, 60};
+
+static const char *CHANNEL_NAMES[STATS_CHANNELS] = {"U_IN", "I_IN", "U_OUT", "I_OUT"};
+
+// 四舍五入为毫伏/毫安（保留符号，零点附近的噪声照常统计）
+static int32_t toMilli(float value) {
+    return (int32_t)lroundf(value * 1000.0f);
+}
+
+MyStats::MyStats() :
+    _havePrev(false),
+    _prevUs(0)
+{
+    portMUX_TYPE unlocked = portMUX_INITIALIZER_UNLOCKED;
+    _mux = unlocked;
+    for (int i = 0; i < STATS_WINDOWS; i++) {
+        _windows[i].seconds = DEFAULT_WINDOW_S[i];
+        clearWindow(_windows[i]);
+    }
+}
+
+void MyStats::clearBucket(Bucket &b) {
+    b.min = INT32_MAX;
+    b.max = INT32_MIN;
+    b.sum = 0;
+    b.sumSq = 0;
+}
+
+void MyStats::clearWindow(Window &w) {
+    w.bucketFrames = (uint32_t)w.seconds * STATS_FRAMES_PER_S / STATS_BUCKETS;
+    if (w.bucketFrames == 0) {
+        w.bucketFrames = 1;
+    }
+    w.filled = 0;
+    w.closed = 0;
+    for (int ch = 0; ch < STATS_CHANNELS; ch++) {
+        clearBucket(w.current[ch]);
+        w.sum[ch] = 0;
+        w.sumSq[ch] = 0;
+        w.minQ[ch].head = 0;
+        w.minQ[ch].count = 0;
+        w.maxQ[ch].head = 0;
+        w.maxQ[ch].count = 0;
+    }
+}
+
+// 当前桶写满：并入环和滑动和，更新单调队列，开始下一个桶
+void MyStats::closeBucket(Window &w) {
+    uint32_t seq = w.closed;
+    uint32_t slot = seq % STATS_BUCKETS;
+    for (int ch = 0; ch < STATS_CHANNELS; ch++) {
+        Bucket &cur = w.current[ch];
+        Bucket &old = w.ring[ch][slot];
+        if (seq >= STATS_BUCKETS) {
+            w.sum[ch] -= old.sum;
+            w.sumSq[ch] -= old.sumSq;
+        }
+        old = cur;
+        w.sum[ch] += cur.sum;
+        w.sumSq[ch] += cur.sumSq;
+
+        // 最小值队列：队首移出已滑出窗口的桶，队尾移出不小于新桶最小值的桶
+        Deque &mq = w.minQ[ch];
+        while (mq.count > 0 && mq.seq[mq.head] + STATS_BUCKETS <= seq) {
+            mq.head = (mq.head + 1) % STATS_BUCKETS;
+            mq.count--;
+        }
+        while (mq.count > 0 &&
+               w.ring[ch][mq.seq[(mq.head + mq.count - 1) % STATS_BUCKETS] % STATS_BUCKETS].min >= cur.min) {
+            mq.count--;
+        }
+        mq.seq[(mq.head + mq.count) % STATS_BUCKETS] = seq;
+        mq.count++;
+
+        // 最大值队列同理
+        Deque &xq = w.maxQ[ch];
+        while (xq.count > 0 && xq.seq[xq.head] + STATS_BUCKETS <= seq) {
+            xq.head = (xq.head + 1) % STATS_BUCKETS;
+            xq.count--;
+        }
+        while (xq.count > 0 &&
+               w.ring[ch][xq.seq[(xq.head + xq.count - 1) % STATS_BUCKETS] % STATS_BUCKETS].max <= cur.max) {
+            xq.count--;
+        }
+        xq.seq[(xq.head + xq.count) % STATS_BUCKETS] = seq;
+        xq.count++;
+
+        clearBucket(cur);
+    }
+    w.closed++;
+    w.filled = 0;
+}
+
+void MyStats::addFrame(const AdcFrame &frame) {
+    int32_t value[STATS_CHANNELS] = {
+        toMilli(frame.uIn), toMilli(frame.iIn), toMilli(frame.uOut), toMilli(frame.iOut)
+    };
+
+    portENTER_CRITICAL(&_mux);
+    if (_havePrev && frame.timeUs - _prevUs > STATS_MAX_GAP_US) {
+        for (int i = 0; i < STATS_WINDOWS; i++) {
+            clearWindow(_windows[i]);
+        }
+    }
+    _havePrev = true;
+    _prevUs = frame.timeUs;
+
+    for (int i = 0; i < STATS_WINDOWS; i++) {
+        Window &w = _windows[i];
+        for (int ch = 0; ch < STATS_CHANNELS; ch++) {
+            Bucket &b = w.current[ch];
+            int32_t v = value[ch];
+            if (v < b.min) {
+                b.min = v;
+            }
+            if (v > b.max) {
+                b.max = v;
+            }
+            b.sum += v;
+            b.sumSq += (int64_t)v * v;
+        }
+        if (++w.filled >= w.bucketFrames) {
+            closeBucket(w);
+        }
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyStats::onFrame(const AdcFrame &frame, void *ctx) {
+    static_cast<MyStats *>(ctx)->addFrame(frame);
+}
+
+bool MyStats::setWindow(uint8_t index, uint16_t seconds) {
+    if (index >= STATS_WINDOWS || seconds == 0 || seconds > STATS_MAX_WINDOW_S) {
+        return false;
+    }
+    portENTER_CRITICAL(&_mux);
+    _windows[index].seconds = seconds;
+    clearWindow(_windows[index]);
+    portEXIT_CRITICAL(&_mux);
+    return true;
+}
+
+uint16_t MyStats::windowSeconds(uint8_t index) const {
+    return index < STATS_WINDOWS ? _windows[index].seconds : 0;
+}
+
+void MyStats::reset() {
+    portENTER_CRITICAL(&_mux);
+    for (int i = 0; i < STATS_WINDOWS; i++) {
+        clearWindow(_windows[i]);
+    }
+    _havePrev = false;
+    portEXIT_CRITICAL(&_mux);
+}
+
+bool MyStats::read(uint8_t index, WindowStats &out) const {
+    if (index >= STATS_WINDOWS) {
+        return false;
+    }
+
+    // 临界区内只复制整数结果，换算在外面做
+    int32_t mins[STATS_CHANNELS];
+    int32_t maxs[STATS_CHANNELS];
+    int64_t sums[STATS_CHANNELS];
+    int64_t sumSqs[STATS_CHANNELS];
+    uint32_t frames;
+
+    portENTER_CRITICAL(&_mux);
+    const Window &w = _windows[index];
+    uint32_t full = w.closed < STATS_BUCKETS ? w.closed : STATS_BUCKETS;
+    frames = full * w.bucketFrames + w.filled;
+    out.seconds = w.seconds;
+    for (int ch = 0; ch < STATS_CHANNELS; ch++) {
+        const Bucket &cur = w.current[ch];
+        mins[ch] = cur.min;
+        maxs[ch] = cur.max;
+        const Deque &mq = w.minQ[ch];
+        if (mq.count > 0) {
+            int32_t v = w.ring[ch][mq.seq[mq.head] % STATS_BUCKETS].min;
+            if (v < mins[ch]) {
+                mins[ch] = v;
+            }
+        }
+        const Deque &xq = w.maxQ[ch];
+        if (xq.count > 0) {
+            int32_t v = w.ring[ch][xq.seq[xq.head] % STATS_BUCKETS].max;
+            if (v > maxs[ch]) {
+                maxs[ch] = v;
+            }
+        }
+        sums[ch] = w.sum[ch] + cur.sum;
+        sumSqs[ch] = w.sumSq[ch] + cur.sumSq;
+    }
+    portEXIT_CRITICAL(&_mux);
+
+    out.frames = frames;
+    if (frames == 0) {
+        return false;
+    }
+    for (int ch = 0; ch < STATS_CHANNELS; ch++) {
+        // 和与平方和是精确的整数，方差在双精度下相减不会丢掉纹波量级的差值
+        double mean = (double)sums[ch] / frames;
+        double meanSq = (double)sumSqs[ch] / frames;
+        double variance = meanSq - mean * mean;
+        ChannelStats &c = out.channel[ch];
+        c.min = mins[ch] / 1000.0f;
+        c.max = maxs[ch] / 1000.0f;
+        c.mean = (float)(mean / 1000.0);
+        c.rms = (float)(sqrt(meanSq) / 1000.0);
+        c.stddev = (float)(variance > 0.0 ? sqrt(variance) / 1000.0 : 0.0);
+    }
+    return true;
+}
+
+void MyStats::printReport() const {
+    Serial.println("===== 滑动窗口统计 =====");
+    for (uint8_t i = 0; i < STATS_WINDOWS; i++) {
+        WindowStats ws;
+        if (!read(i, ws)) {
+            Serial.printf("窗口 %us: 无数据\n", windowSeconds(i));
+            continue;
+        }
+        Serial.printf("窗口 %us（%u帧，%.1fs）\n", ws.seconds, ws.frames, (float)ws.frames / STATS_FRAMES_PER_S);
+        Serial.println("  通道      最小     最大     平均      RMS     标准差   峰峰值");
+        for (uint8_t ch = 0; ch < STATS_CHANNELS; ch++) {
+            const ChannelStats &c = ws.channel[ch];
+            Serial.printf("  %-6s %8.3f %8.3f %8.4f %8.4f %8.4f %8.3f\n", channelName(ch),
+                          c.min, c.max, c.mean, c.rms, c.stddev, c.max - c.min);
+        }
+    }
+}
+
+const char *MyStats::channelName(uint8_t channel) {
+    return channel < STATS_CHANNELS ? CHANNEL_NAMES[channel] : "?";
+}
@@ -0,0 +1,135 @@
+/**
+ * @file myStats.h
+ * @brief 滑动窗口统计：按采集帧计算各通道在最近若干秒内的最小、最大、平均、RMS和标准差
+ * @author watermelon6uice
+ * @details
+ * 老化测试需要纹波和漂移数据，只看500ms平均一次的显示值不够。本模块登记为限流回路的
+ * 采集帧回调（每2ms一帧），对 U_IN/I_IN/U_OUT/I_OUT 各维护 STATS_WINDOWS 个滑动窗口
+ * （默认1秒、10秒、1分钟，可用 setWindow() 修改），每帧的处理量是常数：
+ * - 每个窗口分成 STATS_BUCKETS 个桶（1秒窗口每桶10帧，1分钟窗口每桶600帧），
+ *   新帧只更新当前桶的最小、最大、和、平方和；
+ * - 桶写满时并入窗口：和、平方和用64位整数（毫伏/毫安）滑动加减，没有浮点累加的漂移；
+ *   最小、最大值用单调队列维护，队首即窗口内的极值，每个桶最多进出队一次；
+ * - 读取时窗口 = 最近 STATS_BUCKETS 个完整的桶 + 当前未满的桶，窗口边界按桶滑动
+ *   （分辨率为窗口长度的1/STATS_BUCKETS），极值不会因为分桶而丢失。
+ * 窗口按帧数计，即最近若干秒的输出打开时间；两帧间隔超过 STATS_MAX_GAP_US
+ * （输出关闭、保护锁存）时全部清空重新开始，统计结果只描述连续的一段输出。
+ * 累计在限流任务中进行，读取可以在任何任务中进行（短临界区保护）。
+ * @date 2025-06-13
+ */
+
+#ifndef MY_STATS_H
+#define MY_STATS_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "myAdcFrame.h"
+
+#define STATS_CHANNELS 4             // 通道顺序与 AdcFrame 相同：U_IN、I_IN、U_OUT、I_OUT
+#define STATS_WINDOWS 3              // 窗口数量
+#define STATS_BUCKETS 50             // 每个窗口的桶数
+#define STATS_FRAMES_PER_S 500       // 采集帧率，与 REGULATOR_PERIOD_MS 一致
+#define STATS_MAX_WINDOW_S 3600      // 窗口长度上限(s)
+#define STATS_MAX_GAP_US 100000      // 两帧间隔超过100ms时清空所有窗口
+
+enum StatsChannel {
+    STATS_U_IN = 0,
+    STATS_I_IN,
+    STATS_U_OUT,
+    STATS_I_OUT,
+};
+
+// 一个通道在一个窗口内的统计值（伏或安）
+struct ChannelStats {
+    float min;
+    float max;
+    float mean;
+    float rms;
+    float stddev;
+};
+
+// 一个窗口的统计结果
+struct WindowStats {
+    uint16_t seconds;     // 窗口长度(s)
+    uint32_t frames;      // 窗口内实际的帧数（刚开始统计时少于窗口长度）
+    ChannelStats channel[STATS_CHANNELS];
+};
+
+class MyStats {
+public:
+    MyStats();
+
+    /**
+     * @brief 加入一个采集帧（由限流回路调用）
+     */
+    void addFrame(const AdcFrame &frame);
+
+    // 采集帧回调，ctx 为 MyStats 对象
+    static void onFrame(const AdcFrame &frame, void *ctx);
+
+    /**
+     * @brief 修改一个窗口的长度，该窗口清空重新统计
+     * @param index 窗口序号，0 ~ STATS_WINDOWS-1
+     * @param seconds 窗口长度，1 ~ STATS_MAX_WINDOW_S
+     * @return 参数有效返回true
+     */
+    bool setWindow(uint8_t index, uint16_t seconds);
+    uint16_t windowSeconds(uint8_t index) const;
+
+    // 清空所有窗口
+    void reset();
+
+    /**
+     * @brief 读取一个窗口的统计结果
+     * @return 窗口内没有数据或序号无效时返回false
+     */
+    bool read(uint8_t index, WindowStats &out) const;
+
+    // 串口输出所有窗口的统计结果
+    void printReport() const;
+
+    static const char *channelName(uint8_t channel);
+
+private:
+    // 一个桶（或当前未满的桶）内的累计值，单位毫伏/毫安
+    struct Bucket {
+        int32_t min;
+        int32_t max;
+        int64_t sum;
+        int64_t sumSq;
+    };
+
+    // 单调队列：存放完整桶的序号，对应的极值从队首到队尾单调
+    struct Deque {
+        uint32_t seq[STATS_BUCKETS];
+        uint8_t head;
+        uint8_t count;
+    };
+
+    struct Window {
+        uint16_t seconds;
+        uint32_t bucketFrames;           // 每桶帧数
+        uint32_t filled;                 // 当前桶已有的帧数
+        uint32_t closed;                 // 已写满的桶数（序号）
+        Bucket current[STATS_CHANNELS];
+        Bucket ring[STATS_CHANNELS][STATS_BUCKETS];
+        int64_t sum[STATS_CHANNELS];     // 环中完整桶的和
+        int64_t sumSq[STATS_CHANNELS];
+        Deque minQ[STATS_CHANNELS];
+        Deque maxQ[STATS_CHANNELS];
+    };
+
+    Window _windows[STATS_WINDOWS];
+    bool _havePrev;
+    int64_t _prevUs;
+
+    mutable portMUX_TYPE _mux;
+
+    static void clearBucket(Bucket &b);
+    void clearWindow(Window &w);
+    void closeBucket(Window &w);
+};
+
+extern MyStats stats;
+
+#endif // MY_STATS_H
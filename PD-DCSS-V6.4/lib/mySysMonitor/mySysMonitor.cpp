@@ -0,0 +1,216 @@
+/**
+ * @file mySysMonitor.cpp
+ * @brief 任务栈水位和堆碎片监视，输出栈大小建议
+ * @author watermelon6uice
+ * @date 2025-06-09
+ */
+
+#include "mySysMonitor.h"
+#include "esp_heap_caps.h"
+#include "myTaskTable.h"
+
+MySysMonitor sysMonitor;
+
+static const char *const REGION_NAMES[SYSMON_REGION_COUNT] = {"内部RAM", "PSRAM", "DMA"};
+static const uint32_t REGION_CAPS[SYSMON_REGION_COUNT] = {
+    MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT,
+    MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT,
+    MALLOC_CAP_DMA,
+};
+
+MySysMonitor::MySysMonitor() :
+    _taskCount(0),
+    _sampleCount(0),
+    _trendLog(false),
+    _mutex(NULL),
+    _taskHandle(NULL)
+{
+    memset(_tasks, 0, sizeof(_tasks));
+    memset(_heap, 0, sizeof(_heap));
+}
+
+bool MySysMonitor::begin() {
+    if (_taskHandle != NULL) {
+        return true;
+    }
+    if (_mutex == NULL) {
+        _mutex = xSemaphoreCreateMutex();
+    }
+    // 优先级、核心和栈大小由任务表中的 SysMonitor 条目决定
+    if (taskTableCreate(monitorTask, "SysMonitor", this, &_taskHandle) != pdPASS) {
+        Serial.println("错误: 无法创建系统监视任务");
+        _taskHandle = NULL;
+        return false;
+    }
+    return true;
+}
+
+MySysMonitor::TaskRecord *MySysMonitor::findTask(const char *name, bool create) {
+    for (uint32_t i = 0; i < _taskCount; i++) {
+        if (strncmp(_tasks[i].name, name, SYSMON_NAME_LEN - 1) == 0) {
+            return &_tasks[i];
+        }
+    }
+    if (!create || _taskCount >= SYSMON_MAX_TASKS) {
+        return NULL;
+    }
+    TaskRecord *rec = &_tasks[_taskCount++];
+    memset(rec, 0, sizeof(*rec));
+    strncpy(rec->name, name, SYSMON_NAME_LEN - 1);
+    rec->minFree = UINT32_MAX;
+    return rec;
+}
+
+void MySysMonitor::setStackSize(const char *name, uint32_t stackBytes) {
+    if (_mutex == NULL) {
+        _mutex = xSemaphoreCreateMutex();
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    TaskRecord *rec = findTask(name, true);
+    if (rec != NULL) {
+        rec->stackBytes = stackBytes;
+    }
+    xSemaphoreGive(_mutex);
+}
+
+void MySysMonitor::sample() {
+    if (_mutex == NULL) {
+        return;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    sampleTasks();
+    sampleHeap();
+    _sampleCount++;
+    xSemaphoreGive(_mutex);
+}
+
+void MySysMonitor::sampleTasks() {
+#if configUSE_TRACE_FACILITY
+    // 多留几个位置，防止采样期间有新任务创建
+    UBaseType_t n = uxTaskGetNumberOfTasks() + 2;
+    TaskStatus_t *status = (TaskStatus_t *)malloc(sizeof(TaskStatus_t) * n);
+    if (status == NULL) {
+        return;
+    }
+    n = uxTaskGetSystemState(status, n, NULL);
+
+    for (UBaseType_t i = 0; i < n; i++) {
+        TaskRecord *rec = findTask(status[i].pcTaskName, true);
+        if (rec == NULL) {
+            continue;
+        }
+        uint32_t freeBytes = status[i].usStackHighWaterMark;
+        rec->lastFree = freeBytes;
+        rec->samples++;
+        if (freeBytes < rec->minFree) {
+            // 第一次采样只记录基准，之后的新低点才算趋势
+            if (_trendLog && rec->samples > 1) {
+                Serial.printf("[监视] 任务 %s 栈剩余新低: %u 字节", rec->name, (unsigned)freeBytes);
+                if (rec->stackBytes > 0) {
+                    Serial.printf(" (已用 %u/%u)", (unsigned)(rec->stackBytes - freeBytes), (unsigned)rec->stackBytes);
+                }
+                Serial.println();
+            }
+            rec->minFree = freeBytes;
+        }
+    }
+    free(status);
+#endif
+}
+
+void MySysMonitor::sampleHeap() {
+    for (int r = 0; r < SYSMON_REGION_COUNT; r++) {
+        HeapRecord &h = _heap[r];
+        uint32_t prevFree = h.freeBytes;
+        uint32_t freeBytes = heap_caps_get_free_size(REGION_CAPS[r]);
+        h.freeBytes = freeBytes;
+        h.largestBlock = heap_caps_get_largest_free_block(REGION_CAPS[r]);
+        h.minFree = heap_caps_get_minimum_free_size(REGION_CAPS[r]);
+
+        // 趋势：一个窗口内空闲量多数时候在下降，且整体减少，可能有泄漏
+        if (_sampleCount % SYSMON_TREND_SAMPLES == 0) {
+            if (_trendLog && _sampleCount > 0 && h.trendStartFree > freeBytes &&
+                h.trendFalls > SYSMON_TREND_SAMPLES / 2) {
+                Serial.printf("[监视] %s 空闲量持续下降: %u -> %u 字节 (%d 秒内)\n",
+                              REGION_NAMES[r], (unsigned)h.trendStartFree, (unsigned)freeBytes,
+                              SYSMON_TREND_SAMPLES * SYSMON_SAMPLE_INTERVAL / 1000);
+            }
+            h.trendStartFree = freeBytes;
+            h.trendFalls = 0;
+        } else if (freeBytes < prevFree) {
+            h.trendFalls++;
+        }
+    }
+}
+
+uint32_t MySysMonitor::recommendStack(uint32_t used) {
+    uint32_t margin = used * SYSMON_STACK_MARGIN_PCT / 100;
+    if (margin < SYSMON_STACK_MARGIN_MIN) {
+        margin = SYSMON_STACK_MARGIN_MIN;
+    }
+    uint32_t size = used + margin;
+    return (size + SYSMON_STACK_ROUND - 1) / SYSMON_STACK_ROUND * SYSMON_STACK_ROUND;
+}
+
+void MySysMonitor::printStackReport() {
+#if configUSE_TRACE_FACILITY
+    if (_mutex == NULL) {
+        return;
+    }
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    Serial.printf("\n[监视] 任务栈使用情况 (%u 次采样，余量 %d%%，最少 %d 字节)\n",
+                  (unsigned)_sampleCount, SYSMON_STACK_MARGIN_PCT, SYSMON_STACK_MARGIN_MIN);
+    Serial.println("任务              分配    最低剩余  最大使用  建议    可省");
+    int32_t totalSaving = 0;
+    for (uint32_t i = 0; i < _taskCount; i++) {
+        const TaskRecord &rec = _tasks[i];
+        if (rec.samples == 0) {
+            Serial.printf("%-16s  %6u  (未采样到)\n", rec.name, (unsigned)rec.stackBytes);
+            continue;
+        }
+        if (rec.stackBytes == 0) {
+            Serial.printf("%-16s  %6s  %8u  (未登记分配大小)\n", rec.name, "?", (unsigned)rec.minFree);
+            continue;
+        }
+        uint32_t used = rec.stackBytes > rec.minFree ? rec.stackBytes - rec.minFree : 0;
+        uint32_t recommended = recommendStack(used);
+        int32_t saving = (int32_t)rec.stackBytes - (int32_t)recommended;
+        totalSaving += saving;
+        Serial.printf("%-16s  %6u  %8u  %8u  %6u  %+6d%s\n", rec.name, (unsigned)rec.stackBytes,
+                      (unsigned)rec.minFree, (unsigned)used, (unsigned)recommended, (int)saving,
+                      saving < 0 ? "  <- 余量不足" : "");
+    }
+    Serial.printf("按建议调整合计可省: %d 字节\n", (int)totalSaving);
+    Serial.println("注意: 水位只反映已经走过的代码路径，先把各功能都操作一遍再参考建议值");
+    xSemaphoreGive(_mutex);
+#else
+    Serial.println("任务栈统计: 未启用 configUSE_TRACE_FACILITY");
+#endif
+}
+
+void MySysMonitor::printHeapReport() {
+    Serial.println("\n[监视] 堆内存            空闲      最大连续块  历史最低  碎片率");
+    for (int r = 0; r < SYSMON_REGION_COUNT; r++) {
+        // 直接读取当前值，不影响监视任务的趋势统计
+        uint32_t freeBytes = heap_caps_get_free_size(REGION_CAPS[r]);
+        uint32_t largest = heap_caps_get_largest_free_block(REGION_CAPS[r]);
+        uint32_t minFree = heap_caps_get_minimum_free_size(REGION_CAPS[r]);
+        if (freeBytes == 0 && minFree == 0) {
+            Serial.printf("%-16s  (不存在)\n", REGION_NAMES[r]);
+            continue;
+        }
+        // 碎片率：空闲内存中不能被一次分配用到的比例
+        uint32_t frag = freeBytes > 0 ? 100 - (uint32_t)((uint64_t)largest * 100 / freeBytes) : 0;
+        Serial.printf("%-16s  %8u  %10u  %8u  %5u%%\n", REGION_NAMES[r], (unsigned)freeBytes,
+                      (unsigned)largest, (unsigned)minFree, (unsigned)frag);
+    }
+}
+
+void MySysMonitor::monitorTask(void *parameter) {
+    MySysMonitor *monitor = static_cast<MySysMonitor *>(parameter);
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+    while (true) {
+        monitor->sample();
+        vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(SYSMON_SAMPLE_INTERVAL));
+    }
+}
@@ -0,0 +1,117 @@
+/**
+ * @file mySysMonitor.h
+ * @brief 任务栈水位和堆碎片监视，输出栈大小建议
+ * @author watermelon6uice
+ * @details
+ * 各任务的栈大小目前是经验值（4096/2048），有的是出现栈溢出后才加大的。
+ * 本模块创建一个低优先级监视任务，周期性地：
+ * 1. 用 uxTaskGetSystemState 遍历所有任务，记录每个任务名的栈最低剩余量（高水位）；
+ * 2. 记录内部RAM、PSRAM、DMA三个区域的空闲量、最大连续块和历史最低空闲量。
+ * 出现新的栈水位低点或堆空闲量持续下降时输出趋势日志；需要时打印一张
+ * 栈大小建议表：已用量加上余量后按256字节取整，列出可以省下的内存。
+ *
+ * 任务按名字统计，同名的临时任务（如RestoreColor）合并为一行。
+ * 分配的栈大小FreeRTOS不会记录，需要用 setStackSize() 登记，未登记的任务只显示水位；
+ * 通过任务表（myTaskTable）创建的任务会自动登记。
+ * 遍历任务需要在sdkconfig中启用 configUSE_TRACE_FACILITY。
+ * ESP-IDF中栈大小和水位的单位都是字节。
+ * @date 2025-06-09
+ */
+
+#ifndef MY_SYS_MONITOR_H
+#define MY_SYS_MONITOR_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#define SYSMON_MAX_TASKS 24            // 跟踪的任务名数量上限
+#define SYSMON_NAME_LEN 16             // 任务名长度（与configMAX_TASK_NAME_LEN一致）
+#define SYSMON_SAMPLE_INTERVAL 1000    // 采样周期，单位ms
+#define SYSMON_TREND_SAMPLES 60        // 堆趋势窗口（采样次数）
+#define SYSMON_STACK_MARGIN_MIN 512    // 建议栈大小的最小余量，单位字节
+#define SYSMON_STACK_MARGIN_PCT 25     // 建议栈大小的余量比例（占已用量）
+#define SYSMON_STACK_ROUND 256         // 建议栈大小的取整单位
+
+// 监视的堆区域
+enum SysMonRegion {
+    SYSMON_REGION_INTERNAL = 0,
+    SYSMON_REGION_SPIRAM,
+    SYSMON_REGION_DMA,
+    SYSMON_REGION_COUNT
+};
+
+class MySysMonitor {
+public:
+    MySysMonitor();
+
+    /**
+     * @brief 按任务表中的 SysMonitor 条目创建监视任务（应为日志类，低于所有业务任务）
+     * @return 创建成功返回true
+     */
+    bool begin();
+
+    /**
+     * @brief 登记任务分配的栈大小，用于计算使用率和建议值
+     * @param name 任务名
+     * @param stackBytes 创建任务时指定的栈大小（字节）
+     */
+    void setStackSize(const char *name, uint32_t stackBytes);
+
+    /**
+     * @brief 立即采样一次（监视任务中周期调用，也可在其他任务中手动调用）
+     */
+    void sample();
+
+    /**
+     * @brief 打印栈使用情况和建议栈大小表
+     */
+    void printStackReport();
+
+    /**
+     * @brief 打印各堆区域的空闲量、最大连续块和碎片率
+     */
+    void printHeapReport();
+
+    /**
+     * @brief 打开/关闭趋势日志（新的栈水位低点、堆空闲量持续下降）
+     */
+    void setTrendLog(bool enable) { _trendLog = enable; }
+    bool isTrendLogEnabled() const { return _trendLog; }
+
+private:
+    struct TaskRecord {
+        char name[SYSMON_NAME_LEN];
+        uint32_t stackBytes;     // 分配的栈大小，0表示未登记
+        uint32_t minFree;        // 历史最低剩余量
+        uint32_t lastFree;       // 最近一次剩余量
+        uint32_t samples;        // 采样到的次数
+    };
+
+    struct HeapRecord {
+        uint32_t freeBytes;
+        uint32_t largestBlock;
+        uint32_t minFree;
+        uint32_t trendStartFree; // 趋势窗口开始时的空闲量
+        uint32_t trendFalls;     // 趋势窗口内空闲量下降的次数
+    };
+
+    TaskRecord _tasks[SYSMON_MAX_TASKS];
+    uint32_t _taskCount;
+    HeapRecord _heap[SYSMON_REGION_COUNT];
+    uint32_t _sampleCount;
+    bool _trendLog;
+    SemaphoreHandle_t _mutex;
+    TaskHandle_t _taskHandle;
+
+    TaskRecord *findTask(const char *name, bool create);
+    void sampleTasks();
+    void sampleHeap();
+    static uint32_t recommendStack(uint32_t used);
+    static void monitorTask(void *parameter);
+};
+
+extern MySysMonitor sysMonitor;
+
+#endif // MY_SYS_MONITOR_H
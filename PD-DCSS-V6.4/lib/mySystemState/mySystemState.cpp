@@ -0,0 +1,252 @@
+/**
+ * @file mySystemState.cpp
+ * @brief 系统共享状态：设定值、输出开关、测量值、模式和告警，用顺序锁发布一致的快照
+ * @author watermelon6uice
+ * @date 2025-06-11
+ */
+
+#include "mySystemState.h"
+
+MySystemState systemState;
+
+MySystemState::MySystemState() :
+    _listenerCount(0)
+{
+    portMUX_TYPE unlocked = portMUX_INITIALIZER_UNLOCKED;
+    _writeMux = unlocked;
+    memset(&_state, 0, sizeof(_state));
+    memset(_listeners, 0, sizeof(_listeners));
+    _state.mode = SYS_MODE_CV;
+    _state.limits = protectionDefaultLimits();
+}
+
+void MySystemState::beginWrite() {
+    portENTER_CRITICAL(&_writeMux);
+    // 版本号变为奇数，读者看到后会重读
+    __atomic_store_n(&_state.version, _state.version + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void MySystemState::endWrite(uint32_t changed) {
+    for (int i = 0; i < SYSSTATE_GROUP_COUNT; i++) {
+        if (changed & SYSSTATE_CHANGED(i)) {
+            _state.groupVersion[i]++;
+        }
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&_state.version, _state.version + 1, __ATOMIC_RELAXED);
+    portEXIT_CRITICAL(&_writeMux);
+    // 事件组API不能在临界区内调用
+    if (changed) {
+        notify(changed);
+    }
+}
+
+void MySystemState::snapshot(SystemState &out) const {
+    uint32_t before;
+    uint32_t after;
+    do {
+        before = __atomic_load_n(&_state.version, __ATOMIC_ACQUIRE);
+        if (before & 1) {
+            continue;
+        }
+        memcpy(&out, &_state, sizeof(out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        after = __atomic_load_n(&_state.version, __ATOMIC_RELAXED);
+    } while ((before & 1) || before != after);
+    out.version = before;
+}
+
+uint32_t MySystemState::changedGroups(const SystemState &prev, const SystemState &cur) {
+    uint32_t changed = 0;
+    for (int i = 0; i < SYSSTATE_GROUP_COUNT; i++) {
+        if (prev.groupVersion[i] != cur.groupVersion[i]) {
+            changed |= SYSSTATE_CHANGED(i);
+        }
+    }
+    return changed;
+}
+
+bool MySystemState::isOutputEnabled() const {
+    SystemState s;
+    snapshot(s);
+    return s.outputEnabled;
+}
+
+float MySystemState::getDacVoltage() const {
+    SystemState s;
+    snapshot(s);
+    return s.dacVoltage;
+}
+
+void MySystemState::setSetpoint(float uSet, bool confirmed, bool fineStep) {
+    uint32_t changed = 0;
+    beginWrite();
+    if (_state.uSet != uSet || _state.uSetConfirmed != confirmed || _state.fineStep != fineStep) {
+        _state.uSet = uSet;
+        _state.uSetConfirmed = confirmed;
+        _state.fineStep = fineStep;
+        changed = SYSSTATE_CHANGED_SETPOINT;
+    }
+    endWrite(changed);
+}
+
+void MySystemState::setCurrentSetpoint(float iSet, bool confirmed, bool editCurrent) {
+    uint32_t changed = 0;
+    beginWrite();
+    if (_state.iSet != iSet || _state.iSetConfirmed != confirmed || _state.editCurrent != editCurrent) {
+        _state.iSet = iSet;
+        _state.iSetConfirmed = confirmed;
+        _state.editCurrent = editCurrent;
+        changed = SYSSTATE_CHANGED_SETPOINT;
+    }
+    endWrite(changed);
+}
+
+void MySystemState::setOutputEnabled(bool enabled) {
+    uint32_t changed = 0;
+    beginWrite();
+    if (_state.outputEnabled != enabled) {
+        _state.outputEnabled = enabled;
+        changed = SYSSTATE_CHANGED_OUTPUT;
+    }
+    endWrite(changed);
+}
+
+void MySystemState::setDacVoltage(float voltage) {
+    uint32_t changed = 0;
+    beginWrite();
+    if (_state.dacVoltage != voltage) {
+        _state.dacVoltage = voltage;
+        changed = SYSSTATE_CHANGED_OUTPUT;
+    }
+    endWrite(changed);
+}
+
+void MySystemState::setCurrentLimit(float limit) {
+    uint32_t changed = 0;
+    beginWrite();
+    if (_state.iLimit != limit) {
+        _state.iLimit = limit;
+        changed = SYSSTATE_CHANGED_OUTPUT;
+    }
+    endWrite(changed);
+}
+
+void MySystemState::setProtectionLimits(const ProtectionLimits &limits) {
+    uint32_t changed = 0;
+    beginWrite();
+    if (memcmp(&_state.limits, &limits, sizeof(limits)) != 0) {
+        _state.limits = limits;
+        changed = SYSSTATE_CHANGED_OUTPUT;
+    }
+    endWrite(changed);
+}
+
+uint32_t MySystemState::recallSetpoint(float uSet, float iSet, const ProtectionLimits &limits) {
+    uint32_t changed = 0;
+    beginWrite();
+    if (_state.uSet != uSet || !_state.uSetConfirmed || _state.iSet != iSet || !_state.iSetConfirmed) {
+        _state.uSet = uSet;
+        _state.uSetConfirmed = true;
+        _state.iSet = iSet;
+        _state.iSetConfirmed = true;
+        changed |= SYSSTATE_CHANGED_SETPOINT;
+    }
+    if (_state.dacVoltage != uSet || _state.iLimit != iSet ||
+        memcmp(&_state.limits, &limits, sizeof(limits)) != 0) {
+        _state.dacVoltage = uSet;
+        _state.iLimit = iSet;
+        _state.limits = limits;
+        changed |= SYSSTATE_CHANGED_OUTPUT;
+    }
+    // 版本号在 endWrite() 中加1，这里按变化与否算出发布后的值
+    uint32_t version = _state.groupVersion[SYSSTATE_GROUP_OUTPUT] + ((changed & SYSSTATE_CHANGED_OUTPUT) ? 1 : 0);
+    endWrite(changed);
+    return version;
+}
+
+void MySystemState::setMeasurements(float uIn, float iIn, float uOut, float iOut) {
+    uint32_t now = millis();
+    // 每次采样都算一次更新，即使数值相同，读者据此判断数据是否新鲜
+    beginWrite();
+    _state.uIn = uIn;
+    _state.iIn = iIn;
+    _state.uOut = uOut;
+    _state.iOut = iOut;
+    _state.measureTimeMs = now;
+    endWrite(SYSSTATE_CHANGED_MEASUREMENT);
+}
+
+void MySystemState::setMode(SysMode mode) {
+    uint32_t changed = 0;
+    beginWrite();
+    if (_state.mode != mode) {
+        _state.mode = mode;
+        changed = SYSSTATE_CHANGED_MODE;
+    }
+    endWrite(changed);
+}
+
+void MySystemState::setRegulation(SysMode mode, float dacCommand) {
+    uint32_t changed = 0;
+    beginWrite();
+    if (_state.mode != mode || _state.dacCommand != dacCommand) {
+        _state.mode = mode;
+        _state.dacCommand = dacCommand;
+        changed = SYSSTATE_CHANGED_MODE;
+    }
+    endWrite(changed);
+}
+
+void MySystemState::setAlarms(uint32_t alarms) {
+    uint32_t changed = 0;
+    beginWrite();
+    if (_state.alarms != alarms) {
+        _state.alarms = alarms;
+        changed = SYSSTATE_CHANGED_ALARM;
+    }
+    endWrite(changed);
+}
+
+void MySystemState::raiseAlarm(uint32_t alarmBits) {
+    uint32_t changed = 0;
+    beginWrite();
+    if ((_state.alarms & alarmBits) != alarmBits) {
+        _state.alarms |= alarmBits;
+        changed = SYSSTATE_CHANGED_ALARM;
+    }
+    endWrite(changed);
+}
+
+void MySystemState::clearAlarm(uint32_t alarmBits) {
+    uint32_t changed = 0;
+    beginWrite();
+    if (_state.alarms & alarmBits) {
+        _state.alarms &= ~alarmBits;
+        changed = SYSSTATE_CHANGED_ALARM;
+    }
+    endWrite(changed);
+}
+
+bool MySystemState::addListener(EventGroupHandle_t group, EventBits_t bits, uint32_t groupMask) {
+    if (group == NULL || _listenerCount >= SYSSTATE_MAX_LISTENERS) {
+        return false;
+    }
+    portENTER_CRITICAL(&_writeMux);
+    _listeners[_listenerCount].group = group;
+    _listeners[_listenerCount].bits = bits;
+    _listeners[_listenerCount].groupMask = groupMask;
+    _listenerCount++;
+    portEXIT_CRITICAL(&_writeMux);
+    return true;
+}
+
+void MySystemState::notify(uint32_t changed) {
+    // 监听者只在启动时登记，之后只读，这里不需要加锁
+    for (uint32_t i = 0; i < _listenerCount; i++) {
+        if (_listeners[i].groupMask & changed) {
+            xEventGroupSetBits(_listeners[i].group, _listeners[i].bits);
+        }
+    }
+}
@@ -0,0 +1,153 @@
+/**
+ * @file mySystemState.h
+ * @brief 系统共享状态：设定值、输出开关、测量值、模式和告警，用顺序锁发布一致的快照
+ * @author watermelon6uice
+ * @details
+ * 以前这些状态散落在各处：main.cpp中的 g_dacOutputVoltage、g_dataTaskRunning
+ * （有的地方用 taskControlMutex 保护，有的地方没有），myEncoder 中用互斥量保护的 u_set，
+ * 以及 MyADC 的成员变量。读者要么不加保护直接读，要么和写者抢同一个互斥量，
+ * 低优先级任务持锁时会让编码器等高优先级任务等待（优先级反转）。
+ *
+ * 现在所有状态放在一个带版本号的结构体里：
+ * - 写者通过顺序锁（seqlock）发布：版本号先加1变为奇数，写完再加1变回偶数。
+ *   写者之间用自旋锁串行，临界区只有几次赋值；
+ * - 读者不加锁，复制整个结构体，前后两次读到的版本号相同且为偶数才算成功，否则重读。
+ *   写者所在核心在临界区内不会被抢占，所以读者最多在另一个核心上自旋几微秒；
+ * - 每个字段组有自己的版本号，读者比较两次快照即可知道哪些组变了；
+ *   也可以用 addListener() 登记事件组，某组变化时自动置位对应的事件位；
+ * - 需要同时生效的几组字段（例如调用预设时的设定值、DAC目标电压、限流值和保护阈值）
+ *   在一次发布中写入（recallSetpoint()），读者不会看到只改了一部分的组合。
+ * 不能在中断中写入；读取可以在任何任务中进行。
+ * @date 2025-06-11
+ */
+
+#ifndef MY_SYSTEM_STATE_H
+#define MY_SYSTEM_STATE_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "myProtection.h"
+
+#define SYSSTATE_MAX_LISTENERS 4   // 事件组监听者数量上限
+
+// 字段组，用于变化通知
+enum SysStateGroup {
+    SYSSTATE_GROUP_SETPOINT = 0,   // 电压/电流设定值、确认状态、步进模式、编辑对象
+    SYSSTATE_GROUP_OUTPUT,         // 输出开关、DAC目标电压、限流值、保护阈值
+    SYSSTATE_GROUP_MEASUREMENT,    // 输入输出电压电流
+    SYSSTATE_GROUP_MODE,           // 工作模式（恒压/恒流）和实际DAC输出
+    SYSSTATE_GROUP_ALARM,          // 告警位
+    SYSSTATE_GROUP_COUNT
+};
+
+#define SYSSTATE_CHANGED(group) (1u << (group))
+#define SYSSTATE_CHANGED_SETPOINT    SYSSTATE_CHANGED(SYSSTATE_GROUP_SETPOINT)
+#define SYSSTATE_CHANGED_OUTPUT      SYSSTATE_CHANGED(SYSSTATE_GROUP_OUTPUT)
+#define SYSSTATE_CHANGED_MEASUREMENT SYSSTATE_CHANGED(SYSSTATE_GROUP_MEASUREMENT)
+#define SYSSTATE_CHANGED_MODE        SYSSTATE_CHANGED(SYSSTATE_GROUP_MODE)
+#define SYSSTATE_CHANGED_ALARM       SYSSTATE_CHANGED(SYSSTATE_GROUP_ALARM)
+#define SYSSTATE_CHANGED_ALL         ((1u << SYSSTATE_GROUP_COUNT) - 1)
+
+// 工作模式
+enum SysMode {
+    SYS_MODE_CV = 0,   // 恒压
+    SYS_MODE_CC,       // 恒流：输出电流达到限流值，DAC输出被折返到目标电压以下
+};
+
+// 系统状态快照
+struct SystemState {
+    uint32_t version;                              // 整体版本号（每次发布加2）
+    uint32_t groupVersion[SYSSTATE_GROUP_COUNT];   // 各字段组的版本号
+
+    // 设定值
+    float uSet;              // 编码器当前设定值（可能未确认）
+    bool uSetConfirmed;      // 设定值是否已确认
+    bool fineStep;           // true为细调步进
+    float iSet;              // 编码器当前限流设定值（可能未确认）
+    bool iSetConfirmed;      // 限流设定值是否已确认
+    bool editCurrent;        // true时编码器调整的是限流设定值
+
+    // 输出
+    bool outputEnabled;      // ON/OFF状态，OFF时停止采样和DAC输出
+    float dacVoltage;        // DAC目标输出电压（已确认的设定值）
+    float iLimit;            // 限流值(A)（已确认的限流设定值）
+    ProtectionLimits limits; // 保护阈值，限流回路每个周期交给输出保护
+
+    // 测量值
+    float uIn;               // 输入电压(V)
+    float iIn;               // 输入电流(A)
+    float uOut;              // 输出电压(V)
+    float iOut;              // 输出电流(A)
+    uint32_t measureTimeMs;  // 测量时间(millis)
+
+    // 模式和告警
+    SysMode mode;
+    float dacCommand;        // 实际写入DAC的电压，恒流时低于 dacVoltage
+    uint32_t alarms;         // 告警位，由保护模块定义
+};
+
+class MySystemState {
+public:
+    MySystemState();
+
+    /**
+     * @brief 读取一份一致的快照（不加锁，写者正在写时自旋重读）
+     */
+    void snapshot(SystemState &out) const;
+
+    /**
+     * @brief 返回自 prev 之后发生变化的字段组（SYSSTATE_CHANGED_* 的组合）
+     */
+    static uint32_t changedGroups(const SystemState &prev, const SystemState &cur);
+
+    // 常用单项读取（内部仍读取完整快照）
+    bool isOutputEnabled() const;
+    float getDacVoltage() const;
+
+    // 写入接口，值没有变化时不发布
+    void setSetpoint(float uSet, bool confirmed, bool fineStep);
+    void setCurrentSetpoint(float iSet, bool confirmed, bool editCurrent);
+    void setOutputEnabled(bool enabled);
+    void setDacVoltage(float voltage);
+    void setCurrentLimit(float limit);
+    void setProtectionLimits(const ProtectionLimits &limits);
+
+    /**
+     * @brief 一次发布调用预设的全部字段：设定值（均为已确认）、DAC目标电压、限流值和保护阈值
+     * @return 发布后输出组的版本号，限流回路快照中的版本号不小于它时新值已生效
+     */
+    uint32_t recallSetpoint(float uSet, float iSet, const ProtectionLimits &limits);
+    void setMeasurements(float uIn, float iIn, float uOut, float iOut);
+    void setMode(SysMode mode);
+    void setRegulation(SysMode mode, float dacCommand);
+    void setAlarms(uint32_t alarms);
+    void raiseAlarm(uint32_t alarmBits);
+    void clearAlarm(uint32_t alarmBits);
+
+    /**
+     * @brief 登记变化通知：groupMask 中任一组变化时置位事件组的 bits
+     * @return 登记成功返回true
+     */
+    bool addListener(EventGroupHandle_t group, EventBits_t bits, uint32_t groupMask);
+
+private:
+    struct Listener {
+        EventGroupHandle_t group;
+        EventBits_t bits;
+        uint32_t groupMask;
+    };
+
+    SystemState _state;
+    mutable portMUX_TYPE _writeMux;
+    Listener _listeners[SYSSTATE_MAX_LISTENERS];
+    uint32_t _listenerCount;
+
+    void beginWrite();
+    void endWrite(uint32_t changed);
+    void notify(uint32_t changed);
+};
+
+extern MySystemState systemState;
+
+#endif // MY_SYSTEM_STATE_H
@@ -2,11 +2,15 @@
  * @file myTFT.cpp
  * @brief 在TFT屏幕上调用UI界面
  * @author watermelon6uice
- * @details 基于LVGL和TFT_eSPI库，调用Gui-Guider生成的UI界面并显示。代码参考自:https://www.cnblogs.com/kyo413/p/16609733.html。触摸参数在85行。
+ * @details 基于LVGL和TFT_eSPI库，调用Gui-Guider生成的UI界面并显示。代码参考自:https://www.cnblogs.com/kyo413/p/16609733.html。触摸屏的采样和校准见myTouch库，背光和熄屏时暂停渲染见myBacklight库。
  * @date 2025-05-10
  */
 
 #include "myTFT.h"
+#include "myPerf.h"
+#include "myTouch.h"
+#include "myBacklight.h"
+#include "myPower.h"
 
 // 定义分辨率
 static const uint16_t screenWidth = 320;
@@ -33,57 +37,43 @@ void my_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color
 {
     uint32_t w = (area->x2 - area->x1 + 1);
     uint32_t h = (area->y2 - area->y1 + 1);
+    int64_t t0 = esp_timer_get_time();
 
+    // 与触摸采样任务共用SPI总线，采样任务每次只占用一组读数的时间
+    touch.lockBus();
     tft.startWrite();
     tft.setAddrWindow(area->x1, area->y1, w, h);
     tft.pushColors((uint16_t *)&color_p->full, w * h, true);
     tft.endWrite();
+    touch.unlockBus();
 
+    perf.recordFlush(t0, w * h * sizeof(lv_color_t));
     lv_disp_flush_ready(disp);
 }
 
+/* 每完成一帧刷新，LVGL回调一次，用于统计帧率和重绘像素 */
+void my_disp_monitor(lv_disp_drv_t *disp, uint32_t time, uint32_t px)
+{
+    perf.recordFrame(px);
+}
+
 /*Read the touchpad*/
-/*输入设备，读取触摸板*/
+/*输入设备，读取触摸板：只读触摸采样任务发布的最新状态，不访问SPI总线*/
 void my_touchpad_read(lv_indev_drv_t *indev_driver, lv_indev_data_t *data)
 {
-    uint16_t touchX, touchY;
-
-    bool touched = tft.getTouch(&touchX, &touchY, 600);
-
-    if (!touched)
-    {
-        data->state = LV_INDEV_STATE_REL;
-    }
-    else
-    {
-        data->state = LV_INDEV_STATE_PR;
-
-        /*Set the coordinates*/
-        data->point.x = touchX + 25;
-        data->point.y = touchY - 75;
+    int16_t touchX, touchY;
+    bool touched = touch.read(&touchX, &touchY);
 
-        Serial.print("Data x ");
-        Serial.println(touchX);
-
-        Serial.print("Data y ");
-        Serial.println(touchY);
-    }
+    data->state = touched ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+    data->point.x = touchX;
+    data->point.y = touchY;
 }
 
 void tft_init()
 {
     tft.begin();          /* TFT init TFT初始化*/
     tft.setRotation(3); /* Landscape orientation, flipped 设置方向*/
-
-    /*Set the touchscreen calibration data,
-     the actual data for your display can be acquired using
-     the Generic -> Touch_calibrate example from the TFT_eSPI library*/
-
-    /*设置触摸屏校准数据，
-      可以使用获取显示的实际数据
-      TFT_eSPI 库中的 Generic -> Touch_calibrate 示例*/
-    uint16_t calData[5] = {353, 3534, 244, 3575, 7};
-    tft.setTouch(calData);
+    // 触摸屏的校准参数由 touch.begin() 从NVS读取（没有时使用原来的参数），不再用 setTouch
 }
 
 void lvgl_setup()
@@ -105,6 +95,7 @@ void lvgl_setup()
     disp_drv.hor_res = screenWidth;
     disp_drv.ver_res = screenHeight;
     disp_drv.flush_cb = my_disp_flush;
+    disp_drv.monitor_cb = my_disp_monitor;
     disp_drv.draw_buf = &draw_buf;
     lv_disp_drv_register(&disp_drv);
 
@@ -126,6 +117,21 @@ void init_gui(lv_ui *ui)
 
 void handle_lvgl_tasks()
 {
+    // 熄屏期间不渲染也不刷屏，点亮后LVGL一次补上这期间积累的无效区域
+    if (!backlight.renderAllowed()) {
+        backlight.recordSkippedRender();
+        return;
+    }
+    // 渲染和SPI刷屏期间CPU和APB保持最高频率
+    power.setActive(POWER_CLIENT_RENDER, true);
+    int64_t t0 = esp_timer_get_time();
+    uint32_t seq = perf.frameSeq();
     lv_timer_handler(); /* let the GUI do its work 让GUI完成它的工作 */
+    backlight.recordRender((uint32_t)(esp_timer_get_time() - t0));
+    power.setActive(POWER_CLIENT_RENDER, false);
+    // 只统计实际发生了刷新的调用
+    if (perf.frameSeq() != seq) {
+        perf.record(PERF_STAGE_LVGL, t0);
+    }
     delay(5);
-}
\ No newline at end of file
+}
\ No newline at end of file
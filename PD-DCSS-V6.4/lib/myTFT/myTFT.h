@@ -2,7 +2,7 @@
  * @file myTFT.h
  * @brief 在TFT屏幕上调用UI界面
  * @author watermelon6uice
- * @details 基于LVGL和TFT_eSPI库，调用Gui-Guider生成的UI界面并显示。代码参考自:https://www.cnblogs.com/kyo413/p/16609733.html。触摸参数在85行。
+ * @details 基于LVGL和TFT_eSPI库，调用Gui-Guider生成的UI界面并显示。代码参考自:https://www.cnblogs.com/kyo413/p/16609733.html。触摸屏的采样和校准见myTouch库，背光和熄屏时暂停渲染见myBacklight库。
  * @date 2025-05-10
  */
 #ifndef MY_TFT_H
@@ -23,7 +23,7 @@ void lvgl_setup();
 // 初始化GUI界面
 void init_gui(lv_ui *ui);
 
-// 处理LVGL任务
+// 处理LVGL任务（只在UI任务中调用，渲染锁 POWER_CLIENT_RENDER 只有这一个使用者）
 void handle_lvgl_tasks();
 
 extern TFT_eSPI tft;
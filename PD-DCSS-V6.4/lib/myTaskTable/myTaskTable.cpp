@@ -0,0 +1,173 @@
+/**
+ * @file myTaskTable.cpp
+ * @brief 声明式任务表：统一规定各任务的栈大小、优先级类别、运行核心和栈内存区域
+ * @author watermelon6uice
+ * @date 2025-06-10
+ */
+
+#include "myTaskTable.h"
+#include "mySysMonitor.h"
+
+static const TaskSpec *s_table = NULL;
+static size_t s_count = 0;
+
+static const char *const CLASS_NAMES[TASK_CLASS_COUNT] = {
+    "日志",
+    "界面",
+    "控制",
+    "实时",
+};
+
+UBaseType_t taskClassPriority(TaskClass cls) {
+    switch (cls) {
+        case TASK_CLASS_REALTIME: return TASK_PRIO_REALTIME;
+        case TASK_CLASS_CONTROL:  return TASK_PRIO_CONTROL;
+        case TASK_CLASS_UI:       return TASK_PRIO_UI;
+        default:                  return TASK_PRIO_LOGGING;
+    }
+}
+
+// 实时和控制任务的栈只能放在内部RAM
+static bool isTimeCritical(TaskClass cls) {
+    return cls == TASK_CLASS_REALTIME || cls == TASK_CLASS_CONTROL;
+}
+
+static uint32_t effectiveStackCaps(const TaskSpec *spec) {
+    if (isTimeCritical(spec->taskClass) || (spec->stackCaps & MALLOC_CAP_SPIRAM) == 0) {
+        return TASK_STACK_INTERNAL;
+    }
+    return spec->stackCaps;
+}
+
+bool taskTableInstall(const TaskSpec *table, size_t count) {
+    s_table = table;
+    s_count = count;
+
+    bool ok = true;
+    for (size_t i = 0; i < count; i++) {
+        const TaskSpec &spec = table[i];
+        for (size_t j = 0; j < i; j++) {
+            if (strcmp(table[j].name, spec.name) == 0) {
+                Serial.printf("任务表错误: 任务名 %s 重复\n", spec.name);
+                ok = false;
+            }
+        }
+        if (isTimeCritical(spec.taskClass)) {
+            if (spec.core != TASK_CORE_CONTROL) {
+                Serial.printf("任务表警告: %s 属于%s类，应运行在核心%d\n",
+                              spec.name, CLASS_NAMES[spec.taskClass], TASK_CORE_CONTROL);
+                ok = false;
+            }
+            if (spec.stackCaps & MALLOC_CAP_SPIRAM) {
+                Serial.printf("任务表警告: %s 属于%s类，栈改为内部RAM\n",
+                              spec.name, CLASS_NAMES[spec.taskClass]);
+                ok = false;
+            }
+        } else if (spec.core == TASK_CORE_CONTROL) {
+            Serial.printf("任务表警告: %s 属于%s类，会与实时/控制任务争用核心%d\n",
+                          spec.name, CLASS_NAMES[spec.taskClass], TASK_CORE_CONTROL);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+const TaskSpec *taskTableFind(const char *name) {
+    for (size_t i = 0; i < s_count; i++) {
+        if (strcmp(s_table[i].name, name) == 0) {
+            return &s_table[i];
+        }
+    }
+    return NULL;
+}
+
+static BaseType_t createFromSpec(const TaskSpec *spec, TaskFunction_t entry, void *param, TaskHandle_t *handle) {
+    UBaseType_t priority = taskClassPriority(spec->taskClass);
+    uint32_t caps = effectiveStackCaps(spec);
+    TaskHandle_t created = NULL;
+    BaseType_t result = pdFAIL;
+
+#if defined(CONFIG_SPIRAM_ALLOW_STACK_EXTERNAL_MEMORY) && configSUPPORT_STATIC_ALLOCATION
+    if (caps & MALLOC_CAP_SPIRAM) {
+        // PSRAM栈需要静态创建；任务控制块必须在内部RAM。
+        // 缓冲区不会释放，只用于常驻任务
+        StackType_t *stack = (StackType_t *)heap_caps_malloc(spec->stackBytes, caps);
+        StaticTask_t *tcb = (StaticTask_t *)heap_caps_malloc(sizeof(StaticTask_t), TASK_STACK_INTERNAL);
+        if (stack != NULL && tcb != NULL) {
+            created = xTaskCreateStaticPinnedToCore(entry, spec->name, spec->stackBytes, param,
+                                                    priority, stack, tcb, spec->core);
+            result = created != NULL ? pdPASS : pdFAIL;
+        }
+        if (result != pdPASS) {
+            heap_caps_free(stack);
+            heap_caps_free(tcb);
+            Serial.printf("任务 %s 的PSRAM栈分配失败，改用内部RAM\n", spec->name);
+            caps = TASK_STACK_INTERNAL;
+        }
+    }
+#else
+    if (caps & MALLOC_CAP_SPIRAM) {
+        // 未启用外部内存栈，退回内部RAM
+        caps = TASK_STACK_INTERNAL;
+    }
+#endif
+
+    if (result != pdPASS) {
+        result = xTaskCreatePinnedToCore(entry, spec->name, spec->stackBytes, param,
+                                         priority, &created, spec->core);
+    }
+
+    if (result != pdPASS) {
+        Serial.printf("错误: 无法创建任务 %s\n", spec->name);
+        return result;
+    }
+
+    if (handle != NULL) {
+        *handle = created;
+    } else if (spec->handle != NULL) {
+        *spec->handle = created;
+    }
+    sysMonitor.setStackSize(spec->name, spec->stackBytes);
+    Serial.printf("任务 %s 已创建: %s类 优先级=%u 核心=%d 栈=%u%s\n",
+                  spec->name, CLASS_NAMES[spec->taskClass], (unsigned)priority,
+                  spec->core == tskNO_AFFINITY ? -1 : (int)spec->core,
+                  (unsigned)spec->stackBytes, (caps & MALLOC_CAP_SPIRAM) ? "(PSRAM)" : "");
+    return result;
+}
+
+BaseType_t taskTableCreate(TaskFunction_t entry, const char *name, void *param, TaskHandle_t *handle) {
+    const TaskSpec *spec = taskTableFind(name);
+    if (spec == NULL) {
+        // 不在表中：按界面类、内部RAM、不绑定核心创建，方便测试程序直接使用各个库
+        Serial.printf("任务表警告: %s 不在任务表中，使用默认参数\n", name);
+        TaskSpec fallback = {name, entry, TASK_TABLE_DEFAULT_STACK, TASK_CLASS_UI,
+                             tskNO_AFFINITY, TASK_STACK_INTERNAL, NULL};
+        return createFromSpec(&fallback, entry, param, handle);
+    }
+    return createFromSpec(spec, entry, param, handle);
+}
+
+bool taskTableStartAll() {
+    bool ok = true;
+    for (size_t i = 0; i < s_count; i++) {
+        if (s_table[i].entry == NULL) {
+            continue;
+        }
+        if (createFromSpec(&s_table[i], s_table[i].entry, NULL, NULL) != pdPASS) {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+void taskTablePrint() {
+    Serial.println("任务              类别 优先级 核心   栈字节  栈区域");
+    for (size_t i = 0; i < s_count; i++) {
+        const TaskSpec &spec = s_table[i];
+        Serial.printf("%-16s  %-4s %6u %4d %8u  %s\n", spec.name, CLASS_NAMES[spec.taskClass],
+                      (unsigned)taskClassPriority(spec.taskClass),
+                      spec.core == tskNO_AFFINITY ? -1 : (int)spec.core,
+                      (unsigned)spec.stackBytes,
+                      (effectiveStackCaps(&spec) & MALLOC_CAP_SPIRAM) ? "PSRAM" : "内部");
+    }
+}
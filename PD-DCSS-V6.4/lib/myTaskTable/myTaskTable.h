@@ -0,0 +1,111 @@
+/**
+ * @file myTaskTable.h
+ * @brief 声明式任务表：统一规定各任务的栈大小、优先级类别、运行核心和栈内存区域
+ * @author watermelon6uice
+ * @details
+ * 以前各任务分散在main.cpp和各个库里用 xTaskCreate 创建，优先级是随手写的数字，
+ * 注释还把FreeRTOS的优先级顺序写反了（FreeRTOS中数值越大优先级越高），
+ * 结果本应最高的编码器任务反而是最低的。
+ *
+ * 现在所有任务都登记在一张表里（见main.cpp中的 TASK_TABLE）：
+ * - 优先级只按类别给出：实时 > 控制 > 界面 > 日志，具体数值由本模块统一换算，
+ *   表里写不出违反这个顺序的配置；
+ * - 核心0同时运行WiFi/系统任务，实时和控制任务放在核心1，界面和日志任务放在核心0；
+ * - 栈内存默认在内部RAM；日志类任务可以把栈放到PSRAM（需要在sdkconfig中启用
+ *   CONFIG_SPIRAM_ALLOW_STACK_EXTERNAL_MEMORY，否则自动退回内部RAM）。
+ *   实时和控制任务的栈必须在内部RAM，PSRAM访问会在缓存未命中时产生不确定的延迟。
+ *
+ * 入口函数为NULL的条目由所属的库在begin()等函数中用 taskTableCreate() 按名字创建，
+ * 这样库不需要知道优先级和核心；不在表中的任务按默认参数创建并打印警告。
+ * 通过本模块创建的任务会自动向 sysMonitor 登记栈大小。
+ * @date 2025-06-10
+ */
+
+#ifndef MY_TASK_TABLE_H
+#define MY_TASK_TABLE_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+
+// 优先级类别，按从低到高排列
+enum TaskClass {
+    TASK_CLASS_LOGGING = 0,   // 日志、统计、监视
+    TASK_CLASS_UI,            // LVGL刷新和界面动画
+    TASK_CLASS_CONTROL,       // 采样、DAC输出、按钮等控制回路
+    TASK_CLASS_REALTIME,      // 编码器等有硬性响应时限的输入
+    TASK_CLASS_COUNT
+};
+
+// 各类别对应的FreeRTOS优先级（数值越大优先级越高）
+// Arduino的loopTask优先级为1，日志类与其相同；类别之间留出间隔，便于以后插入
+#define TASK_PRIO_LOGGING  1
+#define TASK_PRIO_UI       3
+#define TASK_PRIO_CONTROL  5
+#define TASK_PRIO_REALTIME 7
+
+// 核心分配
+#define TASK_CORE_SYSTEM   0   // 与WiFi/系统任务共用的核心，放界面和日志任务
+#define TASK_CORE_CONTROL  1   // 应用核心，放实时和控制任务
+
+// 栈内存区域
+#define TASK_STACK_INTERNAL (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#define TASK_STACK_PSRAM    (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+
+#define TASK_TABLE_DEFAULT_STACK 4096   // 不在表中的任务使用的栈大小
+
+// 任务表条目
+struct TaskSpec {
+    const char *name;         // 任务名，也是库查找条目的键
+    TaskFunction_t entry;     // 入口函数，NULL表示由所属库自行创建
+    uint32_t stackBytes;      // 栈大小（ESP-IDF中单位为字节）
+    TaskClass taskClass;      // 优先级类别
+    BaseType_t core;          // 运行核心，tskNO_AFFINITY表示不绑定
+    uint32_t stackCaps;       // 栈内存区域，TASK_STACK_INTERNAL 或 TASK_STACK_PSRAM
+    TaskHandle_t *handle;     // 保存任务句柄，可为NULL
+};
+
+/**
+ * @brief 安装任务表并检查配置
+ * @details 实时/控制任务不在控制核心上时打印警告；其栈被指定到PSRAM时强制改回内部RAM。
+ *          表本身不会被复制，必须是静态存储的数组。
+ * @param table 任务表
+ * @param count 条目数量
+ * @return 没有发现配置问题返回true
+ */
+bool taskTableInstall(const TaskSpec *table, size_t count);
+
+/**
+ * @brief 创建表中所有入口函数不为NULL的任务，参数为NULL
+ * @return 全部创建成功返回true
+ */
+bool taskTableStartAll();
+
+/**
+ * @brief 按名字查找表中的条目创建任务（参数顺序与 xTaskCreate 一致）
+ * @param entry 入口函数
+ * @param name 任务名
+ * @param param 任务参数
+ * @param handle 保存任务句柄，可为NULL（为NULL时使用表中登记的句柄指针）
+ * @return pdPASS表示创建成功
+ */
+BaseType_t taskTableCreate(TaskFunction_t entry, const char *name, void *param, TaskHandle_t *handle);
+
+/**
+ * @brief 按名字查找条目
+ * @return 找不到返回NULL
+ */
+const TaskSpec *taskTableFind(const char *name);
+
+/**
+ * @brief 优先级类别换算为FreeRTOS优先级
+ */
+UBaseType_t taskClassPriority(TaskClass cls);
+
+/**
+ * @brief 打印任务表（名字、类别、优先级、核心、栈大小和栈区域）
+ */
+void taskTablePrint();
+
+#endif // MY_TASK_TABLE_H
@@ -0,0 +1,435 @@
+/**
+ * @file myTouch.cpp
+ * @brief 触摸屏输入：中断触发的采样任务、中值滤波、无锁发布给LVGL，四点校准保存在NVS中
+ * @author watermelon6uice
+ * @date 2025-06-13
+ */
+
+#include "myTouch.h"
+#include "myHAL.h"
+#include "myTaskTable.h"
+#include <math.h>
+#include <string.h>
+
+#define TOUCH_X_MASK 0x7ffu
+#define TOUCH_Y_SHIFT 11
+#define TOUCH_PRESSED_BIT (1u << 31)
+
+// 校准目标点，与 test/Test_calibration.cpp 相同
+static const int16_t CAL_TARGETS[TOUCH_CAL_POINTS][2] = {
+    {25, 25}, {295, 25}, {25, 215}, {295, 215},
+};
+
+// NVS中没有校准记录时的参数：原来 tft_init 中的 calData {353, 3534, 244, 3575, 7}
+// （交换X、Y，两轴反向）加上读回调中的 +25/-75 偏移，换算成仿射系数
+static const TouchCalibration DEFAULT_CAL = {
+    0.0f, -320.0f / 3534, 320 + 25 + 353 * 320.0f / 3534,
+    -240.0f / 3575, 0.0f, 240 - 75 + 244 * 240.0f / 3575,
+};
+
+// NVS中保存的记录
+struct TouchCalRecord {
+    uint32_t version;
+    TouchCalibration cal;
+};
+
+MyTouch touch;
+MyTouch *MyTouch::_instance = NULL;
+
+MyTouch::MyTouch() :
+    _tft(NULL),
+    _irqPin(-1),
+    _task(NULL),
+    _irq(NULL),
+    _bus(NULL),
+    _cal(DEFAULT_CAL),
+    _calibrated(false),
+    _point(0),
+    _pressed(false),
+    _releasePolls(0),
+    _ignorePress(false),
+    _calState(TOUCH_CAL_IDLE),
+    _calStep(0),
+    _calError(0.0f),
+    _calSumX(0.0f),
+    _calSumY(0.0f),
+    _calSamples(0)
+{
+    portMUX_TYPE unlocked = portMUX_INITIALIZER_UNLOCKED;
+    _mux = unlocked;
+    memset(_calRaw, 0, sizeof(_calRaw));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+bool MyTouch::begin(TFT_eSPI *tft, int irqPin) {
+    _tft = tft;
+    _irqPin = irqPin;
+    _instance = this;
+    if (!loadCalibration()) {
+        Serial.println("触摸屏未校准，使用默认参数（串口命令j开始校准）");
+    }
+    _bus = xSemaphoreCreateMutex();
+    _irq = xQueueCreate(1, sizeof(uint8_t));
+    if (_bus == NULL || _irq == NULL) {
+        Serial.println("错误: 无法创建触摸屏的互斥量或队列");
+        return false;
+    }
+    if (_irqPin >= 0) {
+        halGpioMode((uint8_t)_irqPin, HAL_PIN_INPUT_PULLUP);
+        halGpioAttachIsr((uint8_t)_irqPin, irqHandler, HAL_EDGE_FALLING);
+    }
+    if (taskTableCreate(taskEntry, "Touch", this, &_task) != pdPASS) {
+        Serial.println("错误: 无法创建触摸屏采样任务");
+        return false;
+    }
+    return true;
+}
+
+void MyTouch::lockBus() {
+    if (_bus == NULL) {
+        return;
+    }
+    uint64_t t0 = halMicros();
+    xSemaphoreTake(_bus, portMAX_DELAY);
+    uint32_t waited = (uint32_t)(halMicros() - t0);
+    if (waited > _stats.maxFlushWaitUs) {
+        _stats.maxFlushWaitUs = waited;
+    }
+}
+
+void MyTouch::unlockBus() {
+    if (_bus != NULL) {
+        xSemaphoreGive(_bus);
+    }
+}
+
+bool MyTouch::read(int16_t *x, int16_t *y) const {
+    uint32_t p = _point;
+    *x = (int16_t)(p & TOUCH_X_MASK);
+    *y = (int16_t)((p >> TOUCH_Y_SHIFT) & TOUCH_X_MASK);
+    return (p & TOUCH_PRESSED_BIT) != 0;
+}
+
+void MyTouch::calibration(TouchCalibration &out) const {
+    portENTER_CRITICAL(&_mux);
+    out = _cal;
+    portEXIT_CRITICAL(&_mux);
+}
+
+bool MyTouch::loadCalibration() {
+    TouchCalRecord rec;
+    if (!halNvsLoad(TOUCH_NVS_NAMESPACE, TOUCH_NVS_KEY, &rec, sizeof(rec)) || rec.version != TOUCH_CAL_VERSION) {
+        return false;
+    }
+    portENTER_CRITICAL(&_mux);
+    _cal = rec.cal;
+    _calibrated = true;
+    portEXIT_CRITICAL(&_mux);
+    return true;
+}
+
+void MyTouch::clearCalibration() {
+    halNvsErase(TOUCH_NVS_NAMESPACE, TOUCH_NVS_KEY);
+    portENTER_CRITICAL(&_mux);
+    _cal = DEFAULT_CAL;
+    _calibrated = false;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyTouch::beginCalibration() {
+    portENTER_CRITICAL(&_mux);
+    _calState = TOUCH_CAL_RUNNING;
+    _calStep = 0;
+    _calSamples = 0;
+    _calSumX = 0.0f;
+    _calSumY = 0.0f;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyTouch::cancelCalibration() {
+    portENTER_CRITICAL(&_mux);
+    if (_calState == TOUCH_CAL_RUNNING || _calState == TOUCH_CAL_RETRY) {
+        _calState = TOUCH_CAL_IDLE;
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MyTouch::calibrationTarget(uint8_t i, int16_t *x, int16_t *y) {
+    i = i < TOUCH_CAL_POINTS ? i : TOUCH_CAL_POINTS - 1;
+    *x = CAL_TARGETS[i][0];
+    *y = CAL_TARGETS[i][1];
+}
+
+// 以各点的平均值为原点求解，原始坐标的平方和不会大到损失精度
+bool MyTouch::solveCalibration(const float raw[][2], const int16_t screen[][2], size_t n,
+                               TouchCalibration &out, float *maxErrorPx) {
+    if (n < 3) {
+        return false;
+    }
+    double mx = 0, my = 0, msx = 0, msy = 0;
+    for (size_t i = 0; i < n; i++) {
+        mx += raw[i][0];
+        my += raw[i][1];
+        msx += screen[i][0];
+        msy += screen[i][1];
+    }
+    mx /= n;
+    my /= n;
+    msx /= n;
+    msy /= n;
+    double suu = 0, suv = 0, svv = 0, sux = 0, svx = 0, suy = 0, svy = 0;
+    for (size_t i = 0; i < n; i++) {
+        double u = raw[i][0] - mx;
+        double v = raw[i][1] - my;
+        double sx = screen[i][0] - msx;
+        double sy = screen[i][1] - msy;
+        suu += u * u;
+        suv += u * v;
+        svv += v * v;
+        sux += u * sx;
+        svx += v * sx;
+        suy += u * sy;
+        svy += v * sy;
+    }
+    double det = suu * svv - suv * suv;
+    // 各点共线（或重合）时无解
+    if (det <= 1e-6 * suu * svv || suu <= 0 || svv <= 0) {
+        return false;
+    }
+    double a = (svv * sux - suv * svx) / det;
+    double b = (suu * svx - suv * sux) / det;
+    double d = (svv * suy - suv * svy) / det;
+    double e = (suu * svy - suv * suy) / det;
+    out.a = (float)a;
+    out.b = (float)b;
+    out.c = (float)(msx - a * mx - b * my);
+    out.d = (float)d;
+    out.e = (float)e;
+    out.f = (float)(msy - d * mx - e * my);
+
+    if (maxErrorPx != NULL) {
+        float worst = 0.0f;
+        for (size_t i = 0; i < n; i++) {
+            float dx = out.a * raw[i][0] + out.b * raw[i][1] + out.c - screen[i][0];
+            float dy = out.d * raw[i][0] + out.e * raw[i][1] + out.f - screen[i][1];
+            float err = sqrtf(dx * dx + dy * dy);
+            worst = err > worst ? err : worst;
+        }
+        *maxErrorPx = worst;
+    }
+    return true;
+}
+
+void IRAM_ATTR MyTouch::irqHandler() {
+    if (_instance != NULL && _instance->_irq != NULL) {
+        uint8_t token = 0;
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        _instance->_stats.irqs++;
+        // 队列长度为1，已有未处理的唤醒时丢弃
+        xQueueSendFromISR(_instance->_irq, &token, &xHigherPriorityTaskWoken);
+        if (xHigherPriorityTaskWoken) {
+            portYIELD_FROM_ISR();
+        }
+    }
+}
+
+void MyTouch::taskEntry(void *param) {
+    static_cast<MyTouch *>(param)->run();
+}
+
+void MyTouch::run() {
+    uint8_t token;
+    while (true) {
+        if (!_pressed && _irqPin >= 0 && halGpioRead((uint8_t)_irqPin) != LOW) {
+            // 采样时的读数也会让PENIRQ抖动，丢掉这些唤醒再等下一次按下
+            xQueueReset(_irq);
+            xQueueReceive(_irq, &token, portMAX_DELAY);
+        } else {
+            // 按下期间，或PENIRQ为低但压力还不够时按采样周期读；没有中断引脚时空闲轮询
+            vTaskDelay(pdMS_TO_TICKS(_pressed || _irqPin >= 0 ? TOUCH_PERIOD_MS : TOUCH_POLL_MS));
+        }
+        poll();
+    }
+}
+
+static void sortSamples(uint16_t *v, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        uint16_t key = v[i];
+        size_t j = i;
+        while (j > 0 && v[j - 1] > key) {
+            v[j] = v[j - 1];
+            j--;
+        }
+        v[j] = key;
+    }
+}
+
+int MyTouch::sampleBurst(uint16_t *rx, uint16_t *ry) {
+    uint16_t xs[TOUCH_BURST];
+    uint16_t ys[TOUCH_BURST];
+
+    xSemaphoreTake(_bus, portMAX_DELAY);
+    uint64_t t0 = halMicros();
+    uint16_t zStart = _tft->getTouchRawZ();
+    uint16_t zEnd = 0;
+    if (zStart >= TOUCH_Z_THRESHOLD) {
+        for (int i = 0; i < TOUCH_BURST; i++) {
+            _tft->getTouchRaw(&xs[i], &ys[i]);
+        }
+        zEnd = _tft->getTouchRawZ();
+    }
+    uint32_t held = (uint32_t)(halMicros() - t0);
+    xSemaphoreGive(_bus);
+
+    if (held > _stats.maxHoldUs) {
+        _stats.maxHoldUs = held;
+    }
+    if (zStart < TOUCH_Z_THRESHOLD) {
+        return 0;
+    }
+    _stats.bursts++;
+    sortSamples(xs, TOUCH_BURST);
+    sortSamples(ys, TOUCH_BURST);
+    const int mid = TOUCH_BURST / 2;
+    if (zEnd < TOUCH_Z_THRESHOLD || xs[mid + 1] - xs[mid - 1] > TOUCH_MAX_SPREAD ||
+        ys[mid + 1] - ys[mid - 1] > TOUCH_MAX_SPREAD) {
+        _stats.noisy++;
+        return -1;
+    }
+    *rx = xs[mid];
+    *ry = ys[mid];
+    return 1;
+}
+
+void MyTouch::poll() {
+    uint16_t rx, ry;
+    int result = sampleBurst(&rx, &ry);
+    if (result > 0) {
+        _releasePolls = 0;
+        if (!_pressed) {
+            _pressed = true;
+            _stats.presses++;
+        }
+        if (_calState == TOUCH_CAL_RUNNING || _calState == TOUCH_CAL_RETRY) {
+            _calSumX += rx;
+            _calSumY += ry;
+            _calSamples++;
+            // 校准期间不把触摸交给LVGL
+            int16_t x, y;
+            read(&x, &y);
+            publish(false, x, y);
+        } else if (_ignorePress) {
+            int16_t x, y;
+            read(&x, &y);
+            publish(false, x, y);
+        } else {
+            int16_t x, y;
+            toScreen(rx, ry, &x, &y);
+            publish(true, x, y);
+        }
+    } else if (result == 0 && _pressed && ++_releasePolls >= TOUCH_RELEASE_POLLS) {
+        _pressed = false;
+        _releasePolls = 0;
+        _ignorePress = false;
+        int16_t x, y;
+        read(&x, &y);
+        publish(false, x, y);
+        finishCalibrationPoint();
+    }
+}
+
+void MyTouch::ignoreCurrentPress() {
+    int16_t x, y;
+    if (!read(&x, &y)) {
+        return;
+    }
+    // 先置标志再发布松开，采样任务之后的发布都是松开
+    _ignorePress = true;
+    publish(false, x, y);
+}
+
+void MyTouch::publish(bool pressed, int16_t x, int16_t y) {
+    // 一次32位写入，读回调不会读到一半更新的坐标
+    _point = ((uint32_t)x & TOUCH_X_MASK) | (((uint32_t)y & TOUCH_X_MASK) << TOUCH_Y_SHIFT) |
+             (pressed ? TOUCH_PRESSED_BIT : 0);
+}
+
+void MyTouch::toScreen(float rx, float ry, int16_t *x, int16_t *y) {
+    TouchCalibration cal;
+    calibration(cal);
+    float fx = cal.a * rx + cal.b * ry + cal.c;
+    float fy = cal.d * rx + cal.e * ry + cal.f;
+    fx = fx < 0.0f ? 0.0f : (fx > TOUCH_SCREEN_W - 1 ? TOUCH_SCREEN_W - 1 : fx);
+    fy = fy < 0.0f ? 0.0f : (fy > TOUCH_SCREEN_H - 1 ? TOUCH_SCREEN_H - 1 : fy);
+    *x = (int16_t)(fx + 0.5f);
+    *y = (int16_t)(fy + 0.5f);
+}
+
+// 松开时调用：记录当前校准点，四个点都有了就求解
+void MyTouch::finishCalibrationPoint() {
+    if (_calState != TOUCH_CAL_RUNNING && _calState != TOUCH_CAL_RETRY) {
+        return;
+    }
+    uint32_t samples = _calSamples;
+    float sumX = _calSumX;
+    float sumY = _calSumY;
+    _calSamples = 0;
+    _calSumX = 0.0f;
+    _calSumY = 0.0f;
+    // 轻触一下读数太少，不算
+    if (samples < TOUCH_CAL_MIN_SAMPLES) {
+        return;
+    }
+    uint8_t step = _calStep;
+    _calRaw[step][0] = sumX / samples;
+    _calRaw[step][1] = sumY / samples;
+    Serial.printf("触摸校准点%u: 原始坐标(%.0f, %.0f)，%lu组读数\n", step + 1, _calRaw[step][0],
+                  _calRaw[step][1], (unsigned long)samples);
+    if (step + 1 < TOUCH_CAL_POINTS) {
+        _calStep = step + 1;
+        return;
+    }
+
+    TouchCalibration cal;
+    float err = 0.0f;
+    bool solved = solveCalibration(_calRaw, CAL_TARGETS, TOUCH_CAL_POINTS, cal, &err);
+    _calError = solved ? err : -1.0f;
+    if (!solved || err > TOUCH_CAL_MAX_ERROR_PX) {
+        if (solved) {
+            Serial.printf("触摸校准误差过大（%.1f像素），请重新点击四个点\n", err);
+        } else {
+            Serial.println("触摸校准点共线，请重新点击四个点");
+        }
+        portENTER_CRITICAL(&_mux);
+        _calStep = 0;
+        _calState = TOUCH_CAL_RETRY;
+        portEXIT_CRITICAL(&_mux);
+        return;
+    }
+
+    TouchCalRecord rec;
+    rec.version = TOUCH_CAL_VERSION;
+    rec.cal = cal;
+    bool saved = halNvsSave(TOUCH_NVS_NAMESPACE, TOUCH_NVS_KEY, &rec, sizeof(rec));
+    portENTER_CRITICAL(&_mux);
+    _cal = cal;
+    _calibrated = saved;
+    _calState = TOUCH_CAL_DONE;
+    portEXIT_CRITICAL(&_mux);
+    Serial.printf("触摸校准完成，最大误差%.1f像素%s\n", err, saved ? "，已保存" : "，保存失败（本次运行有效）");
+}
+
+void MyTouch::printReport() const {
+    static const char *CAL_STATES[] = {"空闲", "采集中", "重新采集", "完成"};
+    TouchCalibration cal;
+    calibration(cal);
+    Serial.println("===== 触摸屏 =====");
+    Serial.printf("中断引脚: %d%s  校准: %s  校准流程: %s\n", _irqPin, _irqPin < 0 ? "（轮询）" : "",
+                  _calibrated ? "NVS" : "默认参数", CAL_STATES[_calState]);
+    Serial.printf("x = %.5f*rx + %.5f*ry + %.2f\n", cal.a, cal.b, cal.c);
+    Serial.printf("y = %.5f*rx + %.5f*ry + %.2f\n", cal.d, cal.e, cal.f);
+    Serial.printf("中断 %lu次  读数 %lu组（丢弃%lu组）  按下 %lu次\n", (unsigned long)_stats.irqs,
+                  (unsigned long)_stats.bursts, (unsigned long)_stats.noisy, (unsigned long)_stats.presses);
+    Serial.printf("采样占用总线最长 %luus  刷屏等待总线最长 %luus\n", (unsigned long)_stats.maxHoldUs,
+                  (unsigned long)_stats.maxFlushWaitUs);
+}
@@ -0,0 +1,183 @@
+/**
+ * @file myTouch.h
+ * @brief 触摸屏输入：中断触发的采样任务、中值滤波、无锁发布给LVGL，四点校准保存在NVS中
+ * @author watermelon6uice
+ * @details
+ * 以前LVGL每次轮询输入设备都在UI任务里调用 tft.getTouch()：即使没有触摸，它也要在与屏幕
+ * 共用的SPI总线上读压力值，中间还有几次 delay(1)，刷屏只能等它返回；每次触摸都向串口打印
+ * 坐标；校准参数写死在 tft_init 中，还要在读回调里加 +25/-75 的偏移才能对准。
+ *
+ * 现在：
+ * - 触摸控制器（XPT2046）的 PENIRQ 引脚下降沿唤醒采样任务（任务表中的 "Touch"），
+ *   没有触摸时总线上没有任何触摸读数；没有接中断引脚时按 TOUCH_POLL_MS 轮询；
+ * - 按下期间每 TOUCH_PERIOD_MS 采样一次：连续读 TOUCH_BURST 个原始读数，X、Y分别取中值，
+ *   中间三个读数相差超过 TOUCH_MAX_SPREAD 或读完后压力已低于阈值（手指正在离开）的丢弃；
+ *   连续 TOUCH_RELEASE_POLLS 次压力低于阈值才判为松开；
+ * - 结果换算为屏幕坐标后打包成一个32位字发布，LVGL的读回调只读这个字，不加锁、不访问总线；
+ * - 采样任务和刷屏通过 lockBus()/unlockBus() 轮流使用SPI总线，每次只占用一组读数的时间，
+ *   刷屏最多等待一组读数（报告中有最长等待时间）；
+ * - 校准为仿射变换（屏幕X、Y分别是原始X、Y的线性组合），可以同时校正旋转、反向和偏移。
+ *   四点校准流程（来自 test/Test_calibration.cpp）：依次按住四个目标点再松开，
+ *   每个点取按住期间各组读数的平均值，用最小二乘求系数；拟合误差超过 TOUCH_CAL_MAX_ERROR_PX
+ *   时重新开始，否则立即生效并保存到NVS。NVS中没有校准记录时使用原来的参数。
+ * @date 2025-06-13
+ */
+
+#ifndef MY_TOUCH_H
+#define MY_TOUCH_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+#define TOUCH_SCREEN_W 320
+#define TOUCH_SCREEN_H 240
+
+#define TOUCH_BURST 5                    // 每组连续读取的原始读数个数，取中值
+#define TOUCH_Z_THRESHOLD 600            // 压力阈值，与原来 getTouch() 的阈值相同
+#define TOUCH_MAX_SPREAD 40              // 中间三个读数的最大差值（原始单位），超过视为噪声
+#define TOUCH_PERIOD_MS 10               // 按下期间的采样周期
+#define TOUCH_RELEASE_POLLS 2            // 连续几次压力低于阈值判为松开
+#define TOUCH_POLL_MS 30                 // 没有中断引脚时空闲的轮询周期
+
+#define TOUCH_CAL_POINTS 4
+#define TOUCH_CAL_MIN_SAMPLES 3          // 校准点按住期间至少要有的有效读数组数
+#define TOUCH_CAL_MAX_ERROR_PX 8.0f      // 拟合后各点的最大允许误差
+#define TOUCH_CAL_VERSION 1              // NVS记录的格式版本
+#define TOUCH_NVS_NAMESPACE "touch"
+#define TOUCH_NVS_KEY "cal"
+
+// 原始坐标到屏幕坐标的仿射变换：x = a*rawX + b*rawY + c，y = d*rawX + e*rawY + f
+struct TouchCalibration {
+    float a, b, c;
+    float d, e, f;
+};
+
+enum TouchCalState {
+    TOUCH_CAL_IDLE = 0,      // 没有在校准
+    TOUCH_CAL_RUNNING,       // 正在采集校准点
+    TOUCH_CAL_RETRY,         // 上一轮误差过大，正在重新采集
+    TOUCH_CAL_DONE,          // 最近一次校准已生效并保存
+};
+
+struct TouchStats {
+    uint32_t irqs;           // 中断次数
+    uint32_t bursts;         // 读取的组数
+    uint32_t noisy;          // 因读数分散或手指离开丢弃的组数
+    uint32_t presses;        // 按下次数
+    uint32_t maxHoldUs;      // 采样任务一次占用总线的最长时间
+    uint32_t maxFlushWaitUs; // 刷屏等待总线的最长时间
+};
+
+class MyTouch {
+public:
+    MyTouch();
+
+    /**
+     * @brief 读取NVS中的校准参数，登记中断并创建采样任务
+     * @param tft 与屏幕共用总线的TFT_eSPI实例（用它读取触摸控制器）
+     * @param irqPin PENIRQ引脚，-1表示没有接，改为轮询
+     * @return 任务创建成功返回true
+     */
+    bool begin(TFT_eSPI *tft, int irqPin);
+
+    // 刷屏前后调用，与采样任务轮流使用SPI总线；begin() 之前为空操作
+    void lockBus();
+    void unlockBus();
+
+    /**
+     * @brief 最近发布的触摸状态（LVGL的读回调中调用，不加锁、不访问总线）
+     * @param x、y 最近一次按下的屏幕坐标，松开后保持不变
+     * @return 正在按下时返回true
+     */
+    bool read(int16_t *x, int16_t *y) const;
+
+    /**
+     * @brief 当前这次按下不再发布给LVGL，松开后恢复（用于点亮熄灭的屏幕，不触发控件）
+     * @note 可在任何任务中调用，立即发布为松开
+     */
+    void ignoreCurrentPress();
+
+    // NVS中有校准记录并已加载
+    bool isCalibrated() const { return _calibrated; }
+    void calibration(TouchCalibration &out) const;
+
+    // 删除NVS中的校准记录，恢复默认参数
+    void clearCalibration();
+
+    /**
+     * @brief 开始四点校准（可在任何任务中调用）
+     * @details 校准期间触摸不发布给LVGL，依次按住 calibrationTarget(0..3) 再松开
+     */
+    void beginCalibration();
+    void cancelCalibration();
+    TouchCalState calibrationState() const { return _calState; }
+    uint8_t calibrationStep() const { return _calStep; }         // 下一个要按的目标点
+    float calibrationError() const { return _calError; }         // 最近一轮拟合的最大误差（像素）
+
+    // 第 i 个校准目标点的屏幕坐标
+    static void calibrationTarget(uint8_t i, int16_t *x, int16_t *y);
+
+    /**
+     * @brief 用最小二乘求原始坐标到屏幕坐标的仿射变换
+     * @param raw 各点的原始坐标
+     * @param screen 各点的屏幕坐标
+     * @param n 点数，至少3个且不能共线
+     * @param maxErrorPx 输出拟合后各点的最大误差，可为NULL
+     * @return 点数不足或共线时返回false
+     */
+    static bool solveCalibration(const float raw[][2], const int16_t screen[][2], size_t n,
+                                 TouchCalibration &out, float *maxErrorPx);
+
+    void stats(TouchStats &out) const { out = _stats; }
+    void printReport() const;
+
+private:
+    TFT_eSPI *_tft;
+    int _irqPin;
+    TaskHandle_t _task;
+    QueueHandle_t _irq;                  // 中断唤醒采样任务
+    SemaphoreHandle_t _bus;              // SPI总线（与刷屏共用）
+    mutable portMUX_TYPE _mux;           // 保护校准参数和校准状态
+
+    TouchCalibration _cal;
+    bool _calibrated;
+
+    // 发布给读回调的状态：bit0-10 X，bit11-21 Y，bit31 按下
+    volatile uint32_t _point;
+
+    // 采样任务内部状态
+    bool _pressed;
+    uint8_t _releasePolls;
+    volatile bool _ignorePress;          // 本次按下不发布，松开时清除
+
+    // 校准
+    volatile TouchCalState _calState;
+    volatile uint8_t _calStep;
+    volatile float _calError;
+    float _calRaw[TOUCH_CAL_POINTS][2];
+    float _calSumX, _calSumY;            // 当前按下期间各组读数的累计
+    uint32_t _calSamples;
+
+    TouchStats _stats;
+
+    static MyTouch *_instance;
+    static void IRAM_ATTR irqHandler();
+    static void taskEntry(void *param);
+    void run();
+
+    // 读一组原始读数；返回1为有效（中值写入 rx、ry），0为没有按下，-1为丢弃
+    int sampleBurst(uint16_t *rx, uint16_t *ry);
+    void poll();
+    void publish(bool pressed, int16_t x, int16_t y);
+    void toScreen(float rx, float ry, int16_t *x, int16_t *y);
+    void finishCalibrationPoint();
+    bool loadCalibration();
+};
+
+extern MyTouch touch;
+
+#endif // MY_TOUCH_H
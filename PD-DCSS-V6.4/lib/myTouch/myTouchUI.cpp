@@ -0,0 +1,164 @@
+/**
+ * @file myTouchUI.cpp
+ * @brief 触摸校准屏幕：依次显示四个目标点，完成后返回主屏幕
+ * @author watermelon6uice
+ * @details
+ * 流程来自 test/Test_calibration.cpp：当前目标点为红色并带十字，已完成的为绿色，其余为灰色。
+ * 采集和求解都在触摸采样任务中进行（见 myTouch.h），本屏幕只按 calibrationState()
+ * 和 calibrationStep() 显示进度。屏幕不缓存，每次进入都重新开始校准；
+ * 中途离开（确认键返回主屏幕）时取消，原来的参数不变。
+ * @date 2025-06-13
+ */
+
+#include "myTouchUI.h"
+#include "myTouch.h"
+#include "myHAL.h"
+
+#define TOUCHCAL_BG_COLOR 0x000822
+#define TOUCHCAL_TEXT_COLOR 0xffffff
+#define TOUCHCAL_IDLE_COLOR 0x646464
+#define TOUCHCAL_ACTIVE_COLOR 0xff0000
+#define TOUCHCAL_DONE_COLOR 0x00ff00
+#define TOUCHCAL_TARGET_SIZE 10
+#define TOUCHCAL_CROSS_SIZE 21
+#define TOUCHCAL_RETURN_MS 1500      // 完成后停留多久再返回主屏幕
+
+static lv_obj_t *s_targets[TOUCH_CAL_POINTS];
+static lv_obj_t *s_crossH = NULL;
+static lv_obj_t *s_crossV = NULL;
+static lv_obj_t *s_message = NULL;
+static TouchCalState s_shownState = TOUCH_CAL_IDLE;
+static uint8_t s_shownStep = 0xff;
+static uint32_t s_doneMs = 0;
+
+static lv_obj_t *createBox(lv_obj_t *parent, lv_coord_t w, lv_coord_t h, uint32_t color) {
+    lv_obj_t *box = lv_obj_create(parent);
+    lv_obj_remove_style_all(box);
+    lv_obj_set_size(box, w, h);
+    lv_obj_set_style_bg_color(box, lv_color_hex(color), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(box, LV_OPA_COVER, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_clear_flag(box, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+    return box;
+}
+
+static lv_obj_t *createLabel(lv_obj_t *parent, const lv_font_t *font) {
+    lv_obj_t *label = lv_label_create(parent);
+    lv_obj_set_style_text_font(label, font, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(label, lv_color_hex(TOUCHCAL_TEXT_COLOR), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_align(label, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN | LV_STATE_DEFAULT);
+    return label;
+}
+
+// 屏幕被删除（离开校准屏幕）时取消未完成的校准并清空对象指针
+static void screenDeleteCb(lv_event_t *e) {
+    touch.cancelCalibration();
+    for (uint8_t i = 0; i < TOUCH_CAL_POINTS; i++) {
+        s_targets[i] = NULL;
+    }
+    s_crossH = NULL;
+    s_crossV = NULL;
+    s_message = NULL;
+}
+
+void buildTouchCalScreen(lv_obj_t *screen) {
+    lv_obj_set_style_bg_color(screen, lv_color_hex(TOUCHCAL_BG_COLOR), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(screen, LV_OPA_COVER, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_event_cb(screen, screenDeleteCb, LV_EVENT_DELETE, NULL);
+
+    lv_obj_t *title = createLabel(screen, &lv_font_montserratMedium_16);
+    lv_label_set_text(title, "TOUCH CALIBRATION");
+    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 40);
+
+    s_message = createLabel(screen, &lv_font_montserratMedium_9);
+    lv_obj_align(s_message, LV_ALIGN_CENTER, 0, 0);
+
+    lv_obj_t *hint = createLabel(screen, &lv_font_montserratMedium_9);
+    lv_label_set_text(hint, "confirm: exit   step: restart");
+    lv_obj_align(hint, LV_ALIGN_BOTTOM_MID, 0, -40);
+
+    for (uint8_t i = 0; i < TOUCH_CAL_POINTS; i++) {
+        int16_t x, y;
+        MyTouch::calibrationTarget(i, &x, &y);
+        s_targets[i] = createBox(screen, TOUCHCAL_TARGET_SIZE, TOUCHCAL_TARGET_SIZE, TOUCHCAL_IDLE_COLOR);
+        lv_obj_set_pos(s_targets[i], x - TOUCHCAL_TARGET_SIZE / 2, y - TOUCHCAL_TARGET_SIZE / 2);
+    }
+    s_crossH = createBox(screen, TOUCHCAL_CROSS_SIZE, 1, TOUCHCAL_TEXT_COLOR);
+    s_crossV = createBox(screen, 1, TOUCHCAL_CROSS_SIZE, TOUCHCAL_TEXT_COLOR);
+
+    touch.beginCalibration();
+    // 新建的屏幕一定要刷新一次
+    s_shownState = TOUCH_CAL_IDLE;
+    s_shownStep = 0xff;
+}
+
+static void showProgress(TouchCalState state, uint8_t step) {
+    for (uint8_t i = 0; i < TOUCH_CAL_POINTS; i++) {
+        uint32_t color = TOUCHCAL_IDLE_COLOR;
+        if (state == TOUCH_CAL_DONE || i < step) {
+            color = TOUCHCAL_DONE_COLOR;
+        } else if (i == step) {
+            color = TOUCHCAL_ACTIVE_COLOR;
+        }
+        lv_obj_set_style_bg_color(s_targets[i], lv_color_hex(color), LV_PART_MAIN | LV_STATE_DEFAULT);
+    }
+
+    bool collecting = state == TOUCH_CAL_RUNNING || state == TOUCH_CAL_RETRY;
+    if (collecting) {
+        int16_t x, y;
+        MyTouch::calibrationTarget(step, &x, &y);
+        lv_obj_set_pos(s_crossH, x - TOUCHCAL_CROSS_SIZE / 2, y);
+        lv_obj_set_pos(s_crossV, x, y - TOUCHCAL_CROSS_SIZE / 2);
+        lv_obj_clear_flag(s_crossH, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_clear_flag(s_crossV, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(s_crossH, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(s_crossV, LV_OBJ_FLAG_HIDDEN);
+    }
+
+    float err = touch.calibrationError();
+    switch (state) {
+        case TOUCH_CAL_RUNNING:
+            lv_label_set_text_fmt(s_message, "Press and release the red cross  (%u/%u)", step + 1, TOUCH_CAL_POINTS);
+            break;
+        case TOUCH_CAL_RETRY:
+            if (err < 0.0f) {
+                lv_label_set_text_fmt(s_message, "Points too close, start again  (%u/%u)", step + 1, TOUCH_CAL_POINTS);
+            } else {
+                lv_label_set_text_fmt(s_message, "Error %d px, start again  (%u/%u)", (int)(err + 0.5f), step + 1,
+                                      TOUCH_CAL_POINTS);
+            }
+            break;
+        case TOUCH_CAL_DONE:
+            lv_label_set_text_fmt(s_message, "Done, max error %d px, %s", (int)(err + 0.5f),
+                                  touch.isCalibrated() ? "saved" : "NOT saved");
+            break;
+        default:
+            lv_label_set_text(s_message, "Cancelled");
+            break;
+    }
+    lv_obj_align(s_message, LV_ALIGN_CENTER, 0, 0);
+}
+
+void updateTouchCalScreen(lv_obj_t *screen) {
+    TouchCalState state = touch.calibrationState();
+    uint8_t step = touch.calibrationStep();
+    if (state != s_shownState || step != s_shownStep) {
+        if (state == TOUCH_CAL_DONE && s_shownState != TOUCH_CAL_DONE) {
+            s_doneMs = halMillis();
+        }
+        s_shownState = state;
+        s_shownStep = step;
+        showProgress(state, step);
+    }
+    if (state == TOUCH_CAL_DONE && halMillis() - s_doneMs >= TOUCHCAL_RETURN_MS) {
+        screens.requestHome();
+    }
+}
+
+bool touchCalScreenKey(ScreenKey key) {
+    if (key != SCREEN_KEY_STEP || s_message == NULL) {
+        return false;
+    }
+    touch.beginCalibration();
+    return true;
+}
@@ -0,0 +1,26 @@
+/**
+ * @file myTouchUI.h
+ * @brief 触摸校准屏幕：依次显示四个目标点，完成后返回主屏幕
+ * @author watermelon6uice
+ * @date 2025-06-13
+ */
+
+#ifndef MY_TOUCH_UI_H
+#define MY_TOUCH_UI_H
+
+#include "lvgl.h"
+#include "myScreens.h"
+
+// 屏幕表的创建函数：创建目标点并开始校准（离开屏幕时未完成的校准会取消）
+void buildTouchCalScreen(lv_obj_t *screen);
+
+/**
+ * @brief 屏幕表的更新函数：按校准进度移动目标点，完成后稍等片刻返回主屏幕
+ * @note 由 screens.update() 在UI任务中调用
+ */
+void updateTouchCalScreen(lv_obj_t *screen);
+
+// 屏幕表的按键函数：步进按钮从第一个点重新开始
+bool touchCalScreenKey(ScreenKey key);
+
+#endif // MY_TOUCH_UI_H
@@ -0,0 +1,337 @@
+/**
+ * @file myTransient.cpp
+ * @brief 负载瞬态分析：自动捕获I_OUT阶跃，测量U_OUT的偏离、过冲/下冲和恢复时间，按事件统计分布
+ * @author watermelon6uice
+ * @date 2025-06-13
+ */
+
+#include "myTransient.h"
+#include "myCapture.h"
+#include "myHAL.h"
+#include "esp_heap_caps.h"
+#include <math.h>
+#include <string.h>
+
+MyTransient transient;
+
+// 阶跃之前的区间在触发帧之前留出的帧数（阶跃触发比较的间隔加上余量）
+#define TRANSIENT_GUARD_FRAMES (CAPTURE_STEP_FRAMES + 2)
+#define TRANSIENT_MIN_FRAMES 8           // 阶跃之前、之后的区间至少的帧数
+
+TransientConfig transientDefaultConfig() {
+    TransientConfig c;
+    c.stepA = 0.3f;
+    c.bandPct = 1.0f;
+    c.bandMinV = 0.02f;
+    c.sampleHz = 40000;
+    c.depth = 4096;
+    c.preTrigger = 512;
+    return c;
+}
+
+MyTransient::MyTransient() :
+    _running(false),
+    _config(transientDefaultConfig()),
+    _armGeneration(0),
+    _resting(false),
+    _restMs(0),
+    _u(NULL),
+    _i(NULL),
+    _capacity(0),
+    _haveLast(false)
+{
+    memset(&_hist, 0, sizeof(_hist));
+    memset(&_last, 0, sizeof(_last));
+}
+
+static float mean(const float *x, uint32_t first, uint32_t last) {
+    double sum = 0.0;
+    for (uint32_t f = first; f < last; f++) {
+        sum += x[f];
+    }
+    return (float)(sum / (last - first));
+}
+
+bool MyTransient::analyze(const float *u, const float *i, uint32_t frames, uint32_t triggerFrame,
+                          uint32_t sampleHz, const TransientConfig &config, TransientEvent &out) {
+    if (u == NULL || i == NULL || sampleHz == 0 || triggerFrame >= frames) {
+        return false;
+    }
+    uint32_t preEnd = triggerFrame > TRANSIENT_GUARD_FRAMES ? triggerFrame - TRANSIENT_GUARD_FRAMES : 0;
+    uint32_t tailStart = frames - frames / 4;
+    if (preEnd < TRANSIENT_MIN_FRAMES || tailStart <= triggerFrame + TRANSIENT_MIN_FRAMES) {
+        return false;
+    }
+    memset(&out, 0, sizeof(out));
+    out.iBefore = mean(i, 0, preEnd);
+    out.iAfter = mean(i, tailStart, frames);
+    out.vBefore = mean(u, 0, preEnd);
+    out.vFinal = mean(u, tailStart, frames);
+    float di = out.iAfter - out.iBefore;
+    if (fabsf(di) < config.stepA / 2.0f) {
+        return false;
+    }
+    out.rising = di > 0.0f;
+
+    // 阶跃时刻：电流第一次越过中点
+    float half = out.iBefore + di / 2.0f;
+    uint32_t step = preEnd;
+    while (step < tailStart && (out.rising ? i[step] < half : i[step] > half)) {
+        step++;
+    }
+    if (step >= tailStart) {
+        return false;
+    }
+
+    // 滑动平均窗口 [f - back, f + ahead]，帧数为 TRANSIENT_SMOOTH_FRAMES
+    const uint32_t back = (TRANSIENT_SMOOTH_FRAMES - 1) / 2;
+    const uint32_t ahead = TRANSIENT_SMOOTH_FRAMES - 1 - back;
+    out.bandV = fmaxf(fabsf(out.vFinal) * config.bandPct / 100.0f, config.bandMinV);
+    float lowest = out.vFinal;
+    float highest = out.vFinal;
+    uint32_t lowestAt = step;
+    uint32_t highestAt = step;
+    int64_t lastOut = -1;                // 最后一个在容差带之外的帧
+    float window = 0.0f;
+    for (uint32_t f = step - back; f < step + ahead; f++) {
+        window += u[f];
+    }
+    for (uint32_t f = step; f + ahead < frames; f++) {
+        // 峰值用原始样本（平滑会削掉几十微秒宽的尖峰），恢复判定用平滑后的值
+        if (u[f] < lowest) {
+            lowest = u[f];
+            lowestAt = f;
+        }
+        if (u[f] > highest) {
+            highest = u[f];
+            highestAt = f;
+        }
+        window += u[f + ahead];
+        float v = window / TRANSIENT_SMOOTH_FRAMES;
+        window -= u[f - back];
+        if (fabsf(v - out.vFinal) > out.bandV) {
+            lastOut = f;
+        }
+    }
+
+    const float usPerFrame = 1000000.0f / sampleHz;
+    out.undershootV = out.vFinal - lowest;
+    out.overshootV = highest - out.vFinal;
+    bool under = out.undershootV >= out.overshootV;
+    out.peakDeviationV = under ? out.undershootV : out.overshootV;
+    out.peakUs = ((under ? lowestAt : highestAt) - step) * usPerFrame;
+    if (lastOut < 0) {
+        out.recoveryUs = 0.0f;
+    } else if ((uint32_t)lastOut >= frames - frames / 8) {
+        out.recoveryUs = -1.0f;
+    } else {
+        out.recoveryUs = ((uint32_t)lastOut + 1 - step) * usPerFrame;
+    }
+    return true;
+}
+
+void MyTransient::record(TransientEvent &e) {
+    TransientHistogram &h = _hist;
+    h.events++;
+    e.index = h.events;
+    if (e.rising) {
+        h.rising++;
+    } else {
+        h.falling++;
+    }
+    if (e.recoveryUs < 0.0f) {
+        h.unsettled++;
+    } else {
+        uint8_t b = 0;
+        while (b < TRANSIENT_RECOVERY_BUCKETS - 1 && e.recoveryUs > (float)(TRANSIENT_RECOVERY_BASE_US << b)) {
+            b++;
+        }
+        h.recovery[b]++;
+        h.sumRecoveryUs += e.recoveryUs;
+        h.worstRecoveryUs = fmaxf(h.worstRecoveryUs, e.recoveryUs);
+    }
+    float pct = e.vFinal > 0.0f ? e.peakDeviationV / e.vFinal * 100.0f : 0.0f;
+    uint32_t d = (uint32_t)(pct / TRANSIENT_DEVIATION_STEP_PCT);
+    h.deviation[d < TRANSIENT_DEVIATION_BUCKETS ? d : TRANSIENT_DEVIATION_BUCKETS - 1]++;
+    h.worstUndershootV = fmaxf(h.worstUndershootV, e.undershootV);
+    h.worstOvershootV = fmaxf(h.worstOvershootV, e.overshootV);
+    _last = e;
+    _haveLast = true;
+}
+
+bool MyTransient::arm() {
+    CaptureConfig c = captureDefaultConfig();
+    c.channelMask = CAPTURE_MASK(CAPTURE_U_OUT) | CAPTURE_MASK(CAPTURE_I_OUT);
+    c.sampleHz = _config.sampleHz;
+    c.depth = _config.depth;
+    c.preTrigger = _config.preTrigger;
+    c.source = CAPTURE_I_OUT;
+    c.edge = CAPTURE_TRIG_STEP;
+    c.level = _config.stepA;
+    c.autoMs = TRANSIENT_WINDOW_MS;
+    _armGeneration = capture.generation();
+    return capture.arm(c);
+}
+
+bool MyTransient::start(const TransientConfig &config) {
+    if (config.stepA <= 0.0f || config.bandPct <= 0.0f || config.preTrigger <= TRANSIENT_GUARD_FRAMES + TRANSIENT_MIN_FRAMES ||
+        config.depth <= config.preTrigger) {
+        return false;
+    }
+    if (_capacity < config.depth) {
+        // 样本放在PSRAM（每次捕获只顺序扫描几遍），不够时退到任意内存
+        free(_u);
+        free(_i);
+        _u = (float *)heap_caps_malloc(config.depth * sizeof(float), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        _i = (float *)heap_caps_malloc(config.depth * sizeof(float), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (_u == NULL) {
+            _u = (float *)heap_caps_malloc(config.depth * sizeof(float), MALLOC_CAP_8BIT);
+        }
+        if (_i == NULL) {
+            _i = (float *)heap_caps_malloc(config.depth * sizeof(float), MALLOC_CAP_8BIT);
+        }
+        _capacity = (_u != NULL && _i != NULL) ? config.depth : 0;
+        if (_capacity == 0) {
+            Serial.println("瞬态分析: 内存不足");
+            return false;
+        }
+    }
+    _config = config;
+    memset(&_hist, 0, sizeof(_hist));
+    _haveLast = false;
+    _resting = false;
+    if (!arm()) {
+        return false;
+    }
+    _running = true;
+    return true;
+}
+
+void MyTransient::stop() {
+    // 只取消自己的捕获（poll() 之前可能已被其他功能重新 arm）
+    if (_running && capture.state() == CAPTURE_ARMED && capture.config().edge == CAPTURE_TRIG_STEP) {
+        capture.cancel();
+    }
+    _running = false;
+    _resting = false;
+}
+
+void MyTransient::poll() {
+    if (!_running) {
+        return;
+    }
+    CaptureState state = capture.state();
+    uint32_t generation = capture.generation();
+    if (_resting) {
+        if (state != CAPTURE_DONE || generation != _armGeneration + 1) {
+            _running = false;
+            _resting = false;
+            Serial.println("瞬态分析: 捕获被其他功能占用，监测已停止");
+            return;
+        }
+        // 连续采样已停止，让U_IN/I_IN的单次读数更新
+        if (halMillis() - _restMs < TRANSIENT_GAP_MS) {
+            return;
+        }
+        _resting = false;
+        if (!arm()) {
+            _running = false;
+            Serial.println("瞬态分析: 无法重新开始捕获，监测已停止");
+        }
+        return;
+    }
+    if (state == CAPTURE_ARMED) {
+        return;
+    }
+    CaptureInfo ci;
+    if (state != CAPTURE_DONE || generation != _armGeneration + 1 || !capture.info(ci)) {
+        // 被取消、采集失败或捕获被其他功能占用
+        _running = false;
+        Serial.println("瞬态分析: 捕获被取消或被占用，监测已停止");
+        return;
+    }
+    if (!ci.triggered) {
+        // 窗口内没有阶跃
+        _resting = true;
+        _restMs = halMillis();
+        return;
+    }
+    for (uint32_t f = 0; f < ci.frames; f++) {
+        _u[f] = capture.sample(f, CAPTURE_U_OUT);
+        _i[f] = capture.sample(f, CAPTURE_I_OUT);
+    }
+    if (capture.generation() != generation) {
+        _running = false;
+        Serial.println("瞬态分析: 读取期间捕获被覆盖，监测已停止");
+        return;
+    }
+
+    TransientEvent e;
+    if (analyze(_u, _i, ci.frames, ci.triggerFrame, ci.sampleHz, _config, e)) {
+        e.captureGeneration = generation;
+        record(e);
+        printEvent(e);
+        char note[CAPTURE_NOTE_MAX];
+        if (e.recoveryUs >= 0.0f) {
+            snprintf(note, sizeof(note), "#%lu %+.2fA  dev %.0fmV  rec %.0fus", (unsigned long)e.index,
+                     e.iAfter - e.iBefore, e.peakDeviationV * 1000.0f, e.recoveryUs);
+        } else {
+            snprintf(note, sizeof(note), "#%lu %+.2fA  dev %.0fmV  unsettled", (unsigned long)e.index,
+                     e.iAfter - e.iBefore, e.peakDeviationV * 1000.0f);
+        }
+        capture.setNote(generation, note);
+    }
+    _resting = true;
+    _restMs = halMillis();
+}
+
+void MyTransient::printEvent(const TransientEvent &e) {
+    Serial.printf("瞬态 #%lu %s %.3fA -> %.3fA  U %.3fV -> %.3fV  下冲 %.1fmV 过冲 %.1fmV (峰值 %.0fus)  ",
+                  (unsigned long)e.index, e.rising ? "加载" : "卸载", e.iBefore, e.iAfter, e.vBefore, e.vFinal,
+                  e.undershootV * 1000.0f, e.overshootV * 1000.0f, e.peakUs);
+    if (e.recoveryUs >= 0.0f) {
+        Serial.printf("恢复到±%.0fmV %.0fus\n", e.bandV * 1000.0f, e.recoveryUs);
+    } else {
+        Serial.printf("未恢复到±%.0fmV\n", e.bandV * 1000.0f);
+    }
+}
+
+void MyTransient::printReport() const {
+    const TransientHistogram &h = _hist;
+    Serial.println("===== 负载瞬态 =====");
+    Serial.printf("监测: %s  阶跃 %.2fA  容差 ±%.1f%%(>=%.0fmV)  %luHz %lu帧\n", _running ? "开" : "关",
+                  _config.stepA, _config.bandPct, _config.bandMinV * 1000.0f, (unsigned long)_config.sampleHz,
+                  (unsigned long)_config.depth);
+    Serial.printf("事件 %lu（加载 %lu，卸载 %lu，未恢复 %lu）\n", (unsigned long)h.events, (unsigned long)h.rising,
+                  (unsigned long)h.falling, (unsigned long)h.unsettled);
+    if (h.events == 0) {
+        return;
+    }
+    uint32_t settled = h.events - h.unsettled;
+    Serial.printf("恢复时间 平均 %.0fus 最长 %.0fus  最大下冲 %.1fmV 最大过冲 %.1fmV\n",
+                  settled > 0 ? h.sumRecoveryUs / settled : 0.0f, h.worstRecoveryUs,
+                  h.worstUndershootV * 1000.0f, h.worstOvershootV * 1000.0f);
+    Serial.println("  恢复时间        次数");
+    for (uint8_t b = 0; b < TRANSIENT_RECOVERY_BUCKETS; b++) {
+        if (b < TRANSIENT_RECOVERY_BUCKETS - 1) {
+            Serial.printf("  <= %6luus  %6lu\n", (unsigned long)(TRANSIENT_RECOVERY_BASE_US << b),
+                          (unsigned long)h.recovery[b]);
+        } else {
+            Serial.printf("   > %6luus  %6lu\n", (unsigned long)(TRANSIENT_RECOVERY_BASE_US << (b - 1)),
+                          (unsigned long)h.recovery[b]);
+        }
+    }
+    Serial.println("  最大偏离        次数");
+    for (uint8_t d = 0; d < TRANSIENT_DEVIATION_BUCKETS; d++) {
+        float lo = d * TRANSIENT_DEVIATION_STEP_PCT;
+        if (d < TRANSIENT_DEVIATION_BUCKETS - 1) {
+            Serial.printf("  %.1f ~ %.1f%%  %6lu\n", lo, lo + TRANSIENT_DEVIATION_STEP_PCT, (unsigned long)h.deviation[d]);
+        } else {
+            Serial.printf("  >= %.1f%%     %6lu\n", lo, (unsigned long)h.deviation[d]);
+        }
+    }
+    if (_haveLast) {
+        Serial.print("最近一次: ");
+        printEvent(_last);
+    }
+}
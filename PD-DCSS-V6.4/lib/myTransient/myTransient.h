@@ -0,0 +1,142 @@
+/**
+ * @file myTransient.h
+ * @brief 负载瞬态分析：自动捕获I_OUT阶跃，测量U_OUT的偏离、过冲/下冲和恢复时间，按事件统计分布
+ * @author watermelon6uice
+ * @details
+ * 限流回路每2ms一帧，看不到输出对负载阶跃的响应。本模块用波形捕获（myCapture）的阶跃触发：
+ * I_OUT在 CAPTURE_STEP_FRAMES 帧之内变化超过 stepA 时触发，两个通道同时采集。
+ * start() 之后每次捕获完成由 poll() 分析一次（analyze()），结果计入直方图、从串口输出一行、
+ * 作为注释显示在示波器屏幕的波形下方，然后重新 arm 等待下一次阶跃。
+ * 连续采样期间U_IN/I_IN的单次读数保持开始捕获前的值（见 myCapture.h），因此监测分成窗口：
+ * 每次 arm 最多等待 TRANSIENT_WINDOW_MS，超时强制触发的捕获不分析；每次捕获完成后停止连续采样
+ * TRANSIENT_GAP_MS 再重新 arm，期间单次读数恢复。监测期间输入读数（UVLO、输入功率、掉电检测、
+ * U_IN显示）最多滞后一个窗口加一次捕获的时长（默认约190ms）。
+ * 分析方法（analyze() 也可直接用于记录的波形）：
+ * - 阶跃之前：触发点之前（留出 CAPTURE_STEP_FRAMES + 2 帧）的平均电流、平均电压；
+ * - 阶跃之后：最后四分之一的平均电流，以及稳定后的电压 vFinal；
+ * - 电流变化不足 stepA/2 时不算一次事件（触发来自噪声或毛刺）；
+ * - 阶跃时刻：电流第一次越过前后平均值的中点；
+ * - 阶跃之后U_OUT相对 vFinal 的最大下冲、最大过冲和出现时刻（原始样本，包含噪声）；
+ * - 恢复时间：U_OUT做 TRANSIENT_SMOOTH_FRAMES 帧（近似居中）的滑动平均，阶跃时刻到最后一次
+ *   离开 vFinal ± 容差带（bandPct% 和 bandMinV 取大者）的时刻；直到最后八分之一仍在带外的
+ *   记为未稳定。
+ * 恢复时间的分辨率为一个采样周期（40kHz时25us）。两次捕获之间（分析、间隔、重新 arm 和写满
+ * 预触发深度期间，约35ms）以及强制触发后的采集期间发生的阶跃会漏掉。
+ * 分析在 loop() 中进行，直方图只在这个任务中读写。
+ * @date 2025-06-13
+ */
+
+#ifndef MY_TRANSIENT_H
+#define MY_TRANSIENT_H
+
+#include <Arduino.h>
+
+#define TRANSIENT_RECOVERY_BUCKETS 10    // 第b格：恢复时间 <= 50us * 2^b，最后一格为更长的
+#define TRANSIENT_RECOVERY_BASE_US 50
+#define TRANSIENT_DEVIATION_BUCKETS 8    // 每格为输出电压的0.5%，最后一格为 >= 3.5%
+#define TRANSIENT_DEVIATION_STEP_PCT 0.5f
+#define TRANSIENT_SMOOTH_FRAMES 4        // 判定恢复前U_OUT的滑动平均帧数
+#define TRANSIENT_WINDOW_MS 100          // 每次 arm 等待阶跃的最长时间
+#define TRANSIENT_GAP_MS 20              // 两次捕获之间停止连续采样的时间（10个限流周期）
+
+struct TransientConfig {
+    float stepA;             // 阶跃触发的电流变化量(A)
+    float bandPct;           // 恢复容差带，占 vFinal 的百分比
+    float bandMinV;          // 容差带下限(V)，低电压时不小于ADC的分辨率
+    uint32_t sampleHz;       // 每个通道的采样率
+    uint32_t depth;          // 每次捕获的帧数
+    uint32_t preTrigger;     // 触发点之前的帧数
+};
+
+// 默认配置：0.3A阶跃，±1%（不小于20mV），40kHz，4096帧（约100ms），预触发512帧
+TransientConfig transientDefaultConfig();
+
+// 一次负载阶跃
+struct TransientEvent {
+    uint32_t index;          // 事件序号，从1开始
+    bool rising;             // 电流增大（加载）
+    float iBefore;           // 阶跃前、后的平均电流(A)
+    float iAfter;
+    float vBefore;           // 阶跃前的平均电压(V)
+    float vFinal;            // 稳定后的电压(V)
+    float undershootV;       // 低于 vFinal 的最大值（>= 0）
+    float overshootV;        // 高于 vFinal 的最大值（>= 0）
+    float peakDeviationV;    // 两者中较大的
+    float peakUs;            // 最大偏离出现的时刻（相对阶跃）
+    float recoveryUs;        // 恢复时间，未稳定为 -1
+    float bandV;             // 使用的容差带(V)
+    uint32_t captureGeneration;   // 对应的捕获序号，直接分析波形时为0
+};
+
+struct TransientHistogram {
+    uint32_t events;
+    uint32_t rising;
+    uint32_t falling;
+    uint32_t unsettled;
+    uint32_t recovery[TRANSIENT_RECOVERY_BUCKETS];    // 只计已稳定的事件
+    uint32_t deviation[TRANSIENT_DEVIATION_BUCKETS];
+    float sumRecoveryUs;     // 已稳定事件的恢复时间之和
+    float worstRecoveryUs;   // 已稳定事件中最长的恢复时间
+    float worstUndershootV;
+    float worstOvershootV;
+};
+
+class MyTransient {
+public:
+    MyTransient();
+
+    /**
+     * @brief 分析一次负载阶跃（主机测试直接调用）
+     * @param u U_OUT样本(V)
+     * @param i I_OUT样本(A)
+     * @param frames 帧数
+     * @param triggerFrame 触发帧，阶跃在它之前不超过 CAPTURE_STEP_FRAMES 帧
+     * @return 电流变化不足 config.stepA / 2 或数据太短时返回false
+     */
+    static bool analyze(const float *u, const float *i, uint32_t frames, uint32_t triggerFrame,
+                        uint32_t sampleHz, const TransientConfig &config, TransientEvent &out);
+
+    // 把一次事件计入直方图（填写 index）
+    void record(TransientEvent &event);
+
+    /**
+     * @brief 清空直方图，开始监测负载阶跃（占用波形捕获，覆盖示波器当前的捕获）
+     * @return 配置无效、内存不足或捕获无法开始时返回false
+     */
+    bool start(const TransientConfig &config);
+    bool start() { return start(transientDefaultConfig()); }
+
+    // 停止监测，直方图保留
+    void stop();
+    bool isRunning() const { return _running; }
+
+    // 在 loop() 中调用：捕获完成后分析、输出，间隔 TRANSIENT_GAP_MS 后重新 arm
+    void poll();
+
+    const TransientHistogram &histogram() const { return _hist; }
+    bool hasLastEvent() const { return _haveLast; }
+    const TransientEvent &lastEvent() const { return _last; }
+
+    // 串口输出直方图和最近一次事件
+    void printReport() const;
+    static void printEvent(const TransientEvent &event);
+
+private:
+    bool _running;
+    TransientConfig _config;
+    uint32_t _armGeneration;   // arm 时的捕获序号，完成后应为它加1
+    bool _resting;             // 捕获已完成，等待 TRANSIENT_GAP_MS 后重新 arm
+    uint32_t _restMs;          // 开始等待的时刻(halMillis)
+    float *_u;                 // 从捕获读出的样本
+    float *_i;
+    uint32_t _capacity;        // _u、_i 的帧数
+    TransientHistogram _hist;
+    bool _haveLast;
+    TransientEvent _last;
+
+    bool arm();
+};
+
+extern MyTransient transient;
+
+#endif // MY_TRANSIENT_H
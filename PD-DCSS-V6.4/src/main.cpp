@@ -6,6 +6,33 @@
 #include "myEncoderUI.h" // 引入编码器UI回调函数
 #include "myDAC.h"  // 添加DAC库头文件
 #include "myADC.h"  // 添加ADC库头文件
+#include "myReadout.h"  // 大字号读数控件（预渲染数字精灵图）
+#include "myBackdrop.h" // 预合成的静态背景层
+#include "myPerf.h"     // 性能监视（阶段耗时、帧率、任务CPU占用）
+#include "mySysMonitor.h" // 任务栈水位和堆内存监视
+#include "myTaskTable.h"  // 声明式任务表（优先级类别、核心、栈大小）
+#include "mySystemState.h" // 共享系统状态（设定值、输出开关、测量值），顺序锁发布
+#include "myRegulator.h"  // 限流回路（恒压/恒流自动切换），唯一的DAC写入者
+#include "myProtection.h" // 输出保护（过压、过流、输入欠压、过功率），触发后锁存
+#include "myEnergy.h"     // 输入输出能量、电荷和运行时间累计
+#include "myStats.h"      // 各通道滑动窗口统计（最小、最大、平均、RMS、标准差）
+#include "myCapture.h"    // U_OUT/I_OUT高速波形捕获（示波器模式）
+#include "myCaptureUI.h"  // 示波器屏幕
+#include "mySpectrum.h"   // 输出纹波和噪声的频谱分析（FFT）
+#include "myTransient.h"  // 负载瞬态分析（阶跃触发捕获，恢复时间和偏离的分布）
+#include "myHistory.h"    // U_OUT/I_OUT/P_OUT多分辨率历史记录（PSRAM）
+#include "myHistoryUI.h"  // 趋势屏幕
+#include "myScreens.h"    // 声明式屏幕表（按需创建、预加载、内存预算）
+#include "myTouch.h"      // 触摸屏（中断触发的采样任务、中值滤波、NVS中的四点校准）
+#include "myTouchUI.h"    // 触摸校准屏幕
+#include "myBacklight.h"  // 屏幕背光（空闲变暗，输出关闭时熄屏并暂停渲染）
+#include "myPower.h"      // 电源管理（动态调频、自动轻睡眠，按使用者持有锁）
+#include "myStandby.h"    // 待机（输出关闭时DAC关断、屏幕变暗、低速率测量，保护有效）
+#include "mySettings.h"   // 设置存储（设定值、步进模式、范围和校准保存在NVS中，延迟合并写入）
+#include "myPresets.h"    // 预设M1..M9（设定值、限流值和保护阈值，一次发布调用）
+#include "myPresetsUI.h"  // 预设屏幕
+#include "mySettingsUI.h" // 设置屏幕
+#include "myHAL.h"
 
 // FreeRTOS相关头文件
 #include "freertos/FreeRTOS.h"
@@ -24,9 +51,23 @@ void updateButtonState(bool is_on); // 按钮状态更新回调
 // updateUSetDisplay 函数已被移动到 myEncoder 库中的 myEncoderUI.cpp
 void uiUpdateTask(void* parameter); // 合并的UI更新和LVGL刷新任务
 void dataSamplingTask(void* parameter); // 数据采样任务
-void initTaskControl(); // 初始化任务控制互斥量函数声明
 void encoderTask(void* parameter); // 编码器任务声明
-void dacUpdateTask(void* parameter); // DAC更新任务声明
+void initReadouts(); // 创建大字号读数控件
+void initModeIndicator(); // 创建CV/CC模式指示标签
+void updateModeIndicator(); // 按系统状态中的工作模式刷新CV/CC指示
+void initAlarmIndicator(); // 创建保护告警标签
+void updateAlarmIndicator(); // 按系统状态中的告警位显示/隐藏告警标签
+void initPresetIndicator(); // 创建预设选择标签
+void updatePresetIndicator(); // 按选中的预设显示/隐藏预设选择标签
+void initEnergyDisplay(); // 创建能量累计标签
+void updateEnergyDisplay(); // 刷新能量累计标签
+void initBackdrop(); // 创建预合成背景层
+void handleSerialCommands(); // 处理串口调试命令
+void initSysMonitor(); // 登记任务栈大小并启动系统监视任务
+bool screenRotation(int16_t delta, void* ctx); // 主屏幕以外的屏幕显示时，编码器旋转用于切换屏幕
+bool presetRotation(int16_t delta, void* ctx); // 按住步进按钮时，编码器旋转用于选择预设
+bool presetScreenActive(); // 当前屏幕可以选择和调用预设（主屏幕和预设屏幕）
+uint32_t applyPreset(float uSet, float iSet, const ProtectionLimits &limits, void* ctx); // 调用预设时由编码器发布
 
 // 定义GPIO引脚
 #define BUTTON_STATE_PIN 19
@@ -34,24 +75,37 @@ void dacUpdateTask(void* parameter); // DAC更新任务声明
 #define ENCODER_PIN_B 17  // 编码器B相引脚
 #define CONFIRM_BUTTON_PIN 21  // 确认按钮引脚
 #define STEP_SWITCH_PIN 45  // 步进切换按钮引脚，使用GPIO45
+#define TOUCH_IRQ_PIN 18    // 触摸控制器PENIRQ（T_IRQ）引脚，没有接时改为-1（轮询）
+#ifdef TFT_BL
+#define BACKLIGHT_PIN TFT_BL  // 屏幕背光引脚，与TFT_eSPI配置中的TFT_BL相同
+#else
+#define BACKLIGHT_PIN -1      // TFT_eSPI配置中没有TFT_BL：背光不可控，熄屏时只暂停渲染
+#endif
+
+// 自动轻睡眠时用于唤醒的按键（按下为高电平，须为RTC GPIO）
+static const uint8_t POWER_WAKE_PINS[] = {BUTTON_STATE_PIN, CONFIRM_BUTTON_PIN};
+// 自动轻睡眠时电平改变即唤醒的编码器引脚（须为RTC GPIO），否则熄屏后的旋转会丢失
+static const uint8_t POWER_ENCODER_PINS[] = {ENCODER_PIN_A, ENCODER_PIN_B};
+
+// 输出关闭时数据采样任务每隔几个周期采样一次（500ms x 4 = 2秒）
+#define DATA_STANDBY_DIVIDER 4
 
 // DAC引脚定义
 #define DAC_CS_PIN 5    // DAC片选引脚
 #define DAC_MOSI_PIN 7  // DAC数据输入引脚（DI）
 #define DAC_SCK_PIN 6   // DAC时钟引脚
 
-// DAC全局变量
-float g_dacOutputVoltage = 0.0;   // DAC输出电压全局变量，初始为0V
-unsigned long lastDacUpdateTime = 0; // 上次DAC更新时间
-
 // ADC全局实例
 MyADC* adc = NULL;
 
-// 用于演示更新的变量（现在由ADC实际读取）
-float voltage = 0.0;
-float current = 2.13;
-unsigned long previousMillis = 0;
-const long interval = 1000;
+// 大字号读数控件（替换 Uout/Iout/Pout 标签）
+#define READOUT_BG_COLOR 0x000822  // 屏幕背景色，精灵图预混合使用
+MyReadout* uOutReadout = NULL;
+MyReadout* iOutReadout = NULL;
+MyReadout* pOutReadout = NULL;
+
+// 预合成背景层（屏幕背景 + 边框图片 + 静态说明标签）
+MyBackdrop backdrop;
 
 // 任务句柄
 TaskHandle_t uiTaskHandle = NULL;    // UI和LVGL合并任务的句柄
@@ -67,28 +121,72 @@ EventGroupHandle_t systemEvents;
 #define CONFIRM_EVENT (1 << 2) // 确认事件
 #define STEP_SWITCH_EVENT (1 << 3) // 步进切换事件
 #define ENCODER_UPDATE_EVENT (1 << 4) // 编码器更新事件
+#define EDIT_TARGET_EVENT (1 << 5) // 切换编辑对象（U_SET/I_SET）事件
+#define MODE_CHANGE_EVENT (1 << 6) // 工作模式（CV/CC）变化事件
+#define ALARM_EVENT (1 << 7) // 保护告警变化事件
+#define HOLD_ROTATE_EVENT (1 << 8) // 按住步进按钮旋转后松开（或串口数字键）：调用选中的预设
+#define PRESET_SELECT_EVENT (1 << 9) // 选中的预设变化，刷新预设选择标签
+// 算作操作的事件（重新开始背光的空闲计时）；其中按键事件在熄屏时只用于点亮屏幕
+#define ACTIVITY_EVENTS (UI_UPDATE_EVENT | CONFIRM_EVENT | STEP_SWITCH_EVENT | ENCODER_UPDATE_EVENT | \
+                         EDIT_TARGET_EVENT | ALARM_EVENT | HOLD_ROTATE_EVENT | PRESET_SELECT_EVENT)
+#define KEY_EVENTS (CONFIRM_EVENT | STEP_SWITCH_EVENT | EDIT_TARGET_EVENT)
 
-// 任务优先级 (在ESP-IDF FreeRTOS中，数值越小优先级越高)
-#define UI_TASK_PRIORITY 2      // UI和LVGL刷新任务优先级
-#define DATA_TASK_PRIORITY 3    // 数据采样任务优先级
-#define ENCODER_TASK_PRIORITY 1 // 编码器任务优先级最高，确保实时响应
+// 任务表 - 所有任务的栈大小、优先级类别、运行核心和栈内存区域都在这里规定
+// FreeRTOS中数值越大优先级越高，具体数值由类别换算：实时 > 控制 > 界面 > 日志
+// 入口函数为NULL的任务由对应的库创建（见各库中的 taskTableCreate 调用）
+static const TaskSpec TASK_TABLE[] = {
+    // 名称             入口函数          栈字节 类别                 核心                栈内存               句柄
+    {"Encoder_Task",   encoderTask,      4096, TASK_CLASS_REALTIME, TASK_CORE_CONTROL, TASK_STACK_INTERNAL, NULL},
+    {"StepButtonTask", NULL,             2048, TASK_CLASS_REALTIME, TASK_CORE_CONTROL, TASK_STACK_INTERNAL, NULL},            // myEncoder.cpp
+    {"DAC_Task",       NULL,             2048, TASK_CLASS_CONTROL,  TASK_CORE_CONTROL, TASK_STACK_INTERNAL, NULL},            // myDAC.cpp
+    {"Regulator",      NULL,             3072, TASK_CLASS_REALTIME, TASK_CORE_CONTROL, TASK_STACK_INTERNAL, NULL},            // myRegulator.cpp
+    {"Capture",        NULL,             3072, TASK_CLASS_CONTROL,  TASK_CORE_CONTROL, TASK_STACK_INTERNAL, NULL},            // myCapture.cpp
+    {"Data_Sampling",  dataSamplingTask, 4096, TASK_CLASS_CONTROL,  TASK_CORE_CONTROL, TASK_STACK_INTERNAL, &dataTaskHandle},
+    {"ButtonTask",     NULL,             4096, TASK_CLASS_CONTROL,  TASK_CORE_CONTROL, TASK_STACK_INTERNAL, NULL},            // myStateButton.cpp
+    {"UI_LVGL_Task",   uiUpdateTask,     4096, TASK_CLASS_UI,       TASK_CORE_SYSTEM,  TASK_STACK_INTERNAL, &uiTaskHandle},
+    {"RestoreColor",   NULL,             2048, TASK_CLASS_UI,       TASK_CORE_SYSTEM,  TASK_STACK_INTERNAL, NULL},            // myEncoderUI.cpp，临时任务
+    {"Touch",          NULL,             3072, TASK_CLASS_UI,       TASK_CORE_SYSTEM,  TASK_STACK_INTERNAL, NULL},            // myTouch.cpp
+    {"SysMonitor",     NULL,             3072, TASK_CLASS_LOGGING,  TASK_CORE_SYSTEM,  TASK_STACK_PSRAM,    NULL},            // mySysMonitor.cpp
+    {"Settings",       NULL,             3072, TASK_CLASS_CONTROL,  TASK_CORE_SYSTEM,  TASK_STACK_INTERNAL, NULL},            // mySettings.cpp，写flash时栈须在内部RAM
+};
 
-// 数据采样任务控制变量
-static SemaphoreHandle_t taskControlMutex = NULL; // 用于保护任务控制变量的互斥量
-static volatile bool g_dataTaskRunning = false; // 控制数据采样任务是否执行数据采集
+// 屏幕表 - 第0项是主屏幕（由 setup_ui 创建，常驻）；其余屏幕第一次切换时才创建，
+// SCREEN_PRELOAD 的在启动后UI任务空闲时提前创建，SCREEN_CACHE 的离开后在内存预算内保留
+// 切换顺序与表中顺序相同：主屏幕空闲时按确认键进入下一个屏幕，之后旋转编码器前后切换，确认键返回主屏幕；
+// SCREEN_HIDDEN 的屏幕不参与前后切换，只能按名字进入
+static const ScreenSpec SCREEN_TABLE[] = {
+    // 名称       创建函数             更新函数              按键函数           标志
+    {"home",     NULL,                NULL,                 NULL,              SCREEN_RESIDENT},
+    {"scope",    buildCaptureScreen,  updateCaptureScreen,  NULL,              SCREEN_PRELOAD | SCREEN_CACHE},
+    {"trend",    buildTrendScreen,    updateTrendScreen,    trendScreenKey,    0},
+    {"presets",  buildPresetsScreen,  updatePresetsScreen,  NULL,              0},
+    {"settings", buildSettingsScreen, updateSettingsScreen, NULL,              0},
+    {"touchcal", buildTouchCalScreen, updateTouchCalScreen, touchCalScreenKey, SCREEN_HIDDEN},
+};
+#define SCREEN_BUDGET_BYTES (48 * 1024)  // 主屏幕以外已创建的屏幕合计占用的内存上限
 
 // 创建状态按钮对象 (传入系统事件组)
 MyStateButton stateButton(BUTTON_STATE_PIN);
 
+// 默认设置 - NVS中没有保存的设置（或版本不符）时使用；之后修改的值由设置存储保存，下次启动时恢复
+static const Settings SETTINGS_DEFAULTS = {
+    5.00f, 1.50f, 15.00f,        // 电压设定值、最小值、最大值(V)
+    2.00f, 0.10f, 5.00f,         // 限流设定值、最小值、最大值(A)
+    true,                        // 细调步进
+    {1.0f, 1.0f, 1.0f, 1.0f},    // ADC校准系数：U_IN、I_IN、U_OUT、I_OUT
+    {},                          // 预设M1..M9：都是空位
+};
+
 // 创建旋转编码器对象 (包含电压设置和按钮配置)
+// 设定值、范围和步进模式在setup()中按设置存储恢复的值重新配置
 myEncoder encoder(
     ENCODER_PIN_A,  // A相引脚
     ENCODER_PIN_B,  // B相引脚
     CONFIRM_BUTTON_PIN,  // 确认按钮引脚
     STEP_SWITCH_PIN,     // 步进切换按钮引脚
-    5.00,   // 初始电压设置值
-    1.50,   // 最小值
-    15.00,  // 最大值
+    SETTINGS_DEFAULTS.uSet,     // 初始电压设置值
+    SETTINGS_DEFAULTS.uSetMin,  // 最小值
+    SETTINGS_DEFAULTS.uSetMax,  // 最大值
     0.10,   // 细调步进值
     1.00,   // 粗调步进值
     5000    // 确认超时时间（5秒）
@@ -97,55 +195,105 @@ myEncoder encoder(
 // 创建DAC实例
 MyDAC* dac = NULL;
 
+// CV/CC模式指示标签
+lv_obj_t* modeIndicator = NULL;
+
+// 保护告警标签，告警锁存期间显示
+lv_obj_t* alarmIndicator = NULL;
+
+// 预设选择标签，按住步进按钮旋转时显示
+lv_obj_t* presetIndicator = NULL;
+
+// 能量累计标签（输出Wh、Ah和运行时间），输出打开时显示
+lv_obj_t* energyLabel = NULL;
+
 void setup()
 {    
     Serial.begin(115200); /* prepare for possible serial debug 为可能的串行调试做准备*/
     
+    // 配置动态调频和自动轻睡眠，之后各任务只在工作时持有锁
+    power.begin(POWER_WAKE_PINS, sizeof(POWER_WAKE_PINS), POWER_ENCODER_PINS, sizeof(POWER_ENCODER_PINS));
+    
+    // 安装任务表，之后各库按名字创建自己的任务
+    if (!taskTableInstall(TASK_TABLE, sizeof(TASK_TABLE) / sizeof(TASK_TABLE[0]))) {
+        Serial.println("任务表配置有误，请检查上面的警告");
+    }
+    
+    // 一次读取NVS中保存的设置（设定值、步进模式、范围和校准系数），没有时使用默认值
+    settings.begin(SETTINGS_DEFAULTS);
+    Settings saved;
+    settings.get(saved);
+    
     // 创建互斥量和事件组
     dataMutex = xSemaphoreCreateMutex();
     systemEvents = xEventGroupCreate();
       // 初始化TFT和LVGL
     tft_init();
+    // 背光改由PWM控制，以设定亮度点亮
+    backlight.begin(BACKLIGHT_PIN);
     lvgl_setup();
+    // 触摸屏采样任务（读取NVS中的校准参数），与刷屏轮流使用SPI总线
+    touch.begin(&tft, TOUCH_IRQ_PIN);
       // 初始化ADC并设置校准系数
     adc = new MyADC(&guider_ui);
     adc->begin();
-    adc->setCalibrationFactors(1.0, 1.0, 1.0, 1.0); // 设置校准系数，电压通道使用1倍系数，电流通道为1倍
+    adc->setCalibrationFactors(saved.adcFactors[0], saved.adcFactors[1], saved.adcFactors[2], saved.adcFactors[3]); // 设置校准系数（默认都为1倍）
 
     // 初始化DAC
     dac = new MyDAC(DAC_CS_PIN, DAC_MOSI_PIN, DAC_SCK_PIN);
     dac->begin();
     
-    // 创建DAC任务
-    createDACTask(dac, 1, 0);  // 优先级1，在核心0上运行
+    // 创建DAC任务，写入后把输出组的版本号报告给预设和待机，统计调用、恢复输出到写入的延迟
+    addDACAppliedHandler(MyPresets::onDacApplied, &presets);
+    addDACAppliedHandler(MyStandby::onDacApplied, &standby);
+    createDACTask(dac);
     
     // 设置初始DAC输出电压
-    g_dacOutputVoltage = 2.0; // 初始设置为2.0V
-    setDACVoltage(g_dacOutputVoltage);
-    
-    // 创建DAC更新任务，运行在核心0上
-    xTaskCreatePinnedToCore(
-        dacUpdateTask,    // 任务函数
-        "DAC_Update",     // 任务名称
-        2048,             // 堆栈大小
-        NULL,             // 任务参数
-        1,                // 优先级
-        NULL,             // 任务句柄
-        0                 // 在核心0上运行
-    );
+    systemState.setDacVoltage(2.0); // 初始设置为2.0V
+    setDACVoltage(2.0);
 
     /*Create a GUI-Guider app */
+    int32_t homeBytes = MyScreens::usedBytes();
+    int64_t homeT0 = esp_timer_get_time();
     init_gui(&guider_ui);
     
-    // 初始化任务控制互斥量
-    initTaskControl();    // 配置编码器和按钮之间的关系
+    // 把静态背景合成为一张不透明图片，然后用预渲染的数字精灵图替换三个大字号读数标签
+    initBackdrop();
+    initReadouts();
+    initModeIndicator();
+    initAlarmIndicator();
+    initPresetIndicator();
+    initEnergyDisplay();
+    
+    // 主屏幕已创建，登记它的创建耗时和内存；其他屏幕由屏幕表按需创建
+    if (!screens.install(SCREEN_TABLE, sizeof(SCREEN_TABLE) / sizeof(SCREEN_TABLE[0]), &guider_ui)) {
+        Serial.println("屏幕表配置有误，请检查上面的错误");
+    }
+    screens.adopt("home", guider_ui.screen, (uint32_t)(esp_timer_get_time() - homeT0),
+                  MyScreens::usedBytes() - homeBytes);
+    screens.setBudget(SCREEN_BUDGET_BYTES);
+    
+    // 新测量值发布后唤醒UI任务
+    systemState.addListener(systemEvents, DATA_READY_EVENT, SYSSTATE_CHANGED_MEASUREMENT);
+    // 工作模式或折返后的DAC输出变化时刷新CV/CC指示
+    systemState.addListener(systemEvents, MODE_CHANGE_EVENT, SYSSTATE_CHANGED_MODE);
+    // 保护触发或告警被确认时刷新告警标签
+    systemState.addListener(systemEvents, ALARM_EVENT, SYSSTATE_CHANGED_ALARM);
+    
+    // 配置编码器和按钮之间的关系
     encoder.setSystemEvents(&systemEvents); // 设置系统事件组
     encoder.setUSetDisplayCallback(updateUSetDisplay); // 设置电压值显示回调函数，使用myEncoderUI.h中定义的函数
+    encoder.setISetDisplayCallback(updateISetDisplay); // 设置限流值显示回调函数
+    encoder.configureVoltage(saved.uSet, saved.uSetMin, saved.uSetMax); // 恢复电压设定值和范围
+    encoder.configureCurrent(saved.iSet, saved.iSetMin, saved.iSetMax, 0.01, 0.10); // 限流设定值：初始值、最小值、最大值、细调和粗调步进
+    encoder.setFineStep(saved.fineStep); // 恢复步进模式
+    encoder.setRotationHandler(screenRotation, NULL); // 主屏幕以外的屏幕显示时，旋转用于切换屏幕
+    encoder.setHoldRotationHandler(presetRotation, NULL); // 按住步进按钮旋转选择预设，松开时调用
+    presets.setApplyHandler(applyPreset, NULL); // 调用预设时编码器同时更新自己的设定值和显示
     
     // 配置按钮状态和UI回调
     stateButton.setSystemEvents(&systemEvents); // 设置系统事件组
     stateButton.setDataMutex(&dataMutex); // 设置数据互斥量
-    stateButton.setTaskControl(&taskControlMutex, &g_dataTaskRunning); // 设置任务控制
     stateButton.setStateChangeCallback(updateButtonState); // 设置状态变化回调函数
     
     // 初始化按钮状态库
@@ -157,13 +305,40 @@ void setup()
     // 如果编码器方向相反，取消下面一行的注释
     encoder.reverseDirection();
     
+    // 恢复的设定值已经发布，此后确认的设定值和步进模式由设置存储合并后延迟写入NVS
+    settings.start();
+    
+    // 启动时按住步进按钮进入触摸校准（步进按钮为下拉输入，按下为高电平）
+    if (halGpioRead(STEP_SWITCH_PIN) == HIGH) {
+        screens.request("touchcal");
+    }
+    
+    // 启动限流回路，此后由它按限流值写DAC；每个采集帧同时用于能量累计、滑动窗口统计和历史记录
+    regulator.addFrameCallback(MyEnergy::onFrame, &energy);
+    regulator.addFrameCallback(MyStats::onFrame, &stats);
+    if (history.begin()) {
+        regulator.addFrameCallback(MyHistory::onFrame, &history);
+    } else {
+        Serial.println("历史记录初始化失败，趋势屏幕没有数据");
+    }
+    // 输入掉电检测，待机时也需要，U_IN跌落时立即写入未保存的设置
+    regulator.addFrameCallback(MySettings::onFrame, &settings, true);
+    regulator.begin(MyADC::frameSource, adc);
+
+    // 波形捕获：缓冲区在PSRAM中，换算系数与ADC校准一致
+    capture.setScale(CAPTURE_U_OUT, adc->getOutputVoltageFactor() / 1000.0f);
+    capture.setScale(CAPTURE_I_OUT, adc->getOutputCurrentFactor() / 1000.0f);
+    if (!capture.begin()) {
+        Serial.println("波形捕获初始化失败，示波器模式不可用");
+    }
+    
     // 初始化UI显示状态
     lv_label_set_text(guider_ui.screen_STATE, "ON");
     // 设置ON状态为绿色
     lv_obj_set_style_text_color(guider_ui.screen_STATE, lv_color_hex(0x00ff00), LV_PART_MAIN|LV_STATE_DEFAULT);
     
-    // 根据按钮初始状态设置全局任务运行标志（在创建任务前）
-    g_dataTaskRunning = stateButton.getState();
+    // 根据按钮初始状态发布输出开关（在创建任务前）
+    stateButton.publishState();
     
     // 初始化界面状态（包括待机标签的显示/隐藏）
     updateButtonState(stateButton.getState());
@@ -173,39 +348,26 @@ void setup()
     sprintf(u_set_buf, "%.2f", encoder.getUSet());
     lv_label_set_text(guider_ui.screen_U_SET, u_set_buf);
     
-    // 创建FreeRTOS任务 - UI更新和LVGL刷新已合并为一个任务
-    xTaskCreate(
-        uiUpdateTask,        // 任务函数 - 同时处理UI更新和LVGL刷新
-        "UI_LVGL_Task",      // 任务名称
-        4096,               // 堆栈大小
-        NULL,               // 任务参数
-        UI_TASK_PRIORITY,   // 任务优先级
-        &uiTaskHandle       // 任务句柄
-    );
-      // 创建数据采样任务
-    xTaskCreate(
-        dataSamplingTask,    // 任务函数
-        "Data_Sampling",     // 任务名称
-        4096,                // 增大堆栈大小到4KB，解决堆栈溢出问题
-        NULL,                // 任务参数
-        DATA_TASK_PRIORITY,  // 任务优先级
-        &dataTaskHandle      // 任务句柄
-    );
-      // 创建编码器任务
-    xTaskCreate(
-        encoderTask,           // 任务函数
-        "Encoder_Task",        // 任务名称
-        4096,                  // 增加堆栈大小到4KB
-        NULL,                  // 任务参数
-        ENCODER_TASK_PRIORITY, // 任务优先级
-        NULL                   // 任务句柄
-    );
+    // 初始化I_SET显示
+    initISetDisplay(guider_ui.screen, encoder.getISet());
+    
+    // 创建任务表中由main负责的任务（UI和LVGL刷新、数据采样、编码器）
+    taskTableStartAll();
+    
+    // 所有任务创建完成后启动系统监视
+    initSysMonitor();
 }
 
 void loop()
 {
-    // 主循环只处理按钮状态更新
+    // 主循环处理按钮状态更新、串口调试命令和性能统计汇总
     stateButton.update();
+    handleSerialCommands();
+    // 频谱分析请求的采集完成后在这里做FFT并输出
+    spectrum.poll();
+    // 瞬态监测的捕获完成后在这里分析并重新开始
+    transient.poll();
+    perf.tick();
     vTaskDelay(10 / portTICK_PERIOD_MS);
 }
 
@@ -219,12 +381,11 @@ void uiUpdateTask(void* parameter) {
     // 初始化最后唤醒时间
     xLastWakeTime = xTaskGetTickCount();
     
-    // 设置任务的优先级，确保它能及时响应
-    vTaskPrioritySet(NULL, UI_TASK_PRIORITY);
       while (true) {        // 等待各种事件，包括新增的编码器事件
         EventBits_t bits = xEventGroupWaitBits(
             systemEvents,                 // 事件组句柄
-            DATA_READY_EVENT | UI_UPDATE_EVENT | CONFIRM_EVENT | STEP_SWITCH_EVENT | ENCODER_UPDATE_EVENT, // 等待的事件位
+            DATA_READY_EVENT | UI_UPDATE_EVENT | CONFIRM_EVENT | STEP_SWITCH_EVENT | ENCODER_UPDATE_EVENT |
+            EDIT_TARGET_EVENT | MODE_CHANGE_EVENT | ALARM_EVENT | HOLD_ROTATE_EVENT | PRESET_SELECT_EVENT, // 等待的事件位
             pdTRUE,                       // 清除事件位
             pdFALSE,                      // 任一事件均可唤醒
             0                             // 不等待，立即返回
@@ -232,11 +393,24 @@ void uiUpdateTask(void* parameter) {
         
         bool needRefresh = false;  // 跟踪是否需要特殊刷新
         
+        // 按键、编码器、输出开关、告警和触摸都重新开始背光的空闲计时；
+        // 熄屏时的按键和触摸只用于点亮屏幕（编码器旋转在 screenRotation 中处理）
+        bool woke = (bits & ACTIVITY_EVENTS) && backlight.activity();
+        int16_t touchX, touchY;
+        if (touch.read(&touchX, &touchY) && backlight.activity()) {
+            touch.ignoreCurrentPress();
+        }
+        if (woke) {
+            bits &= ~KEY_EVENTS;
+            needRefresh = true;
+        }
+        
         // 处理数据更新 - 只有在系统ON状态且有新数据时才更新显示
-        if (g_dataTaskRunning && (bits & DATA_READY_EVENT)) {
+        if (systemState.isOutputEnabled() && (bits & DATA_READY_EVENT)) {
             // 使用短暂的锁定时间，仅获取需要的数据
             if (xSemaphoreTake(dataMutex, pdMS_TO_TICKS(10)) == pdTRUE) {
                 updateDisplay();
+                updateEnergyDisplay();
                 xSemaphoreGive(dataMutex);
                 needRefresh = true;
             }
@@ -248,27 +422,83 @@ void uiUpdateTask(void* parameter) {
             needRefresh = true;
         }
         
-        // 处理确认事件
+        // 处理确认事件 - 保护告警锁存时确认键用于复位告警；正在选择预设时把当前设定值保存到选中的预设；
+        // 其他屏幕上返回主屏幕；主屏幕上没有待确认的设定值时进入下一个屏幕
         if (bits & CONFIRM_EVENT) {
             Serial.println("UI任务接收到确认事件");
-            encoder.confirmUSet();
+            if (protection.isTripped()) {
+                protection.acknowledge();
+                Serial.println("保护告警已确认，恢复输出");
+            } else if (presets.selection() > 0) {
+                // 保存后结束选择，松开步进按钮时不再调用
+                presets.store(presets.takeSelection());
+                updatePresetIndicator();
+            } else if (!screens.isHomeActive()) {
+                screens.requestHome();
+            } else if (encoder.isUSetConfirmed() && encoder.isISetConfirmed()) {
+                screens.requestStep(1);
+            } else {
+                encoder.confirmUSet();
+            }
             needRefresh = true;
         }
         
-        // 处理步进切换事件 - 优先级高于其他事件
+        // 处理步进切换事件 - 当前屏幕有自己的含义时交给屏幕（如趋势屏幕切换时间范围）
         if (bits & STEP_SWITCH_EVENT) {
             Serial.println("UI任务接收到步进切换事件，准备执行切换...");
-            // 无论当前状态如何，强制处理步进切换
-            encoder.toggleStepSize();
+            if (!screens.handleKey(SCREEN_KEY_STEP) && screens.isHomeActive()) {
+                encoder.toggleStepSize();
+            }
             needRefresh = true;
             Serial.println("步进切换事件处理完成");
         }
         
+        // 处理编辑对象切换事件（长按步进按钮）
+        if (bits & EDIT_TARGET_EVENT) {
+            encoder.toggleEditTarget();
+            needRefresh = true;
+        }
+        
+        // 处理预设选择事件（按住步进按钮旋转）
+        if (bits & PRESET_SELECT_EVENT) {
+            updatePresetIndicator();
+            needRefresh = true;
+        }
+        
+        // 处理预设调用事件 - 设定值、限流值和保护阈值一次发布，编码器同时刷新设定值显示
+        if (bits & HOLD_ROTATE_EVENT) {
+            int slot = presets.takeSelection();
+            if (slot > 0 && presetScreenActive()) {
+                presets.recall(slot);
+            }
+            updatePresetIndicator();
+            needRefresh = true;
+        }
+        
+        // 处理工作模式变化事件
+        if (bits & MODE_CHANGE_EVENT) {
+            updateModeIndicator();
+        }
+        
+        // 处理保护告警事件
+        if (bits & ALARM_EVENT) {
+            updateAlarmIndicator();
+            needRefresh = true;
+        }
+        
         // 处理编码器更新事件 - 这主要是为了UI任务能够监控编码器事件
         if (bits & ENCODER_UPDATE_EVENT) {
             // 编码器事件已由编码器任务处理，这里只需要强制刷新UI
             needRefresh = true;
         }
+        // 熄屏时不更新屏幕内容，屏幕切换请求留到点亮后处理
+        if (backlight.renderAllowed()) {
+            // 刷新性能叠加标签（隐藏时不做任何事）
+            perf.updateOverlay();
+            // 处理屏幕切换请求，刷新当前屏幕（示波器、趋势等）；本周期没有其他工作时预加载屏幕
+            screens.update(bits == 0 && !needRefresh);
+        }
+        
           // 处理LVGL任务，刷新屏幕
         handle_lvgl_tasks();
         
@@ -278,19 +508,19 @@ void uiUpdateTask(void* parameter) {
             handle_lvgl_tasks();  // 额外的一次刷新
         }
         
+        // 渲染之后切换背光状态：空闲变暗、输出关闭时熄屏，刚点亮的屏幕这时才打开背光
+        backlight.update(systemState.isOutputEnabled());
+        // 背光的PWM在轻睡眠时会停止，亮屏期间不允许轻睡眠
+        power.setActive(POWER_CLIENT_SCREEN, backlight.state() != BACKLIGHT_BLANK);
+        // 没有电源管理时只在这里调频（唯一设置CPU频率的任务）
+        power.update();
+        
         // 确保任务以固定频率运行
         vTaskDelayUntil(&xLastWakeTime, xFrequency);
     }
 }
 
 
-// 初始化任务控制互斥量 - 简单的辅助函数
-void initTaskControl() {
-    if (taskControlMutex == NULL) {
-        taskControlMutex = xSemaphoreCreateMutex();
-    }
-}
-
 void dataSamplingTask(void* parameter) {
     TickType_t xLastWakeTime;
     const TickType_t xFrequency = pdMS_TO_TICKS(500); // 每500ms采样一次数据
@@ -300,14 +530,17 @@ void dataSamplingTask(void* parameter) {
     
     // 首次运行先跳过一次采样，仅设置计时器基准点
     vTaskDelayUntil(&xLastWakeTime, xFrequency);
+    uint32_t cycle = 0;
       while (true) {
-        // 只有在全局运行标志为true时才进行数据采样
-        if (g_dataTaskRunning && adc != NULL) {
+        // 输出为ON时每个周期采样；OFF时降低到每 DATA_STANDBY_DIVIDER 个周期一次，读数保持更新
+        bool outputEnabled = systemState.isOutputEnabled();
+        bool standbySample = !outputEnabled && cycle++ % DATA_STANDBY_DIVIDER == 0;
+        if ((outputEnabled || standbySample) && adc != NULL) {
             // 更新ADC读数，只进行数据采集，不更新UI
+            // 新测量值发布到系统状态后，监听者会置位 DATA_READY_EVENT 通知UI任务
+            int64_t t0 = esp_timer_get_time();
             adc->update(); // 这个方法只读取ADC值，不会更新UI
-            
-            // 通知UI任务进行更新
-            xEventGroupSetBits(systemEvents, DATA_READY_EVENT);
+            perf.record(PERF_STAGE_ADC, t0);
 
             // 调试输出：确认数据采样正在运行
             static unsigned long lastDebugTime = 0;
@@ -316,10 +549,10 @@ void dataSamplingTask(void* parameter) {
                 Serial.println("数据采样任务正在运行，ADC数据已更新");
                 lastDebugTime = currentTime;
             }
-        } else if (!g_dataTaskRunning) {            // 调试输出：数据采样任务暂停
+        } else if (!outputEnabled) {            // 调试输出：数据采样任务暂停
             static bool pausedMsgPrinted = false;
             if (!pausedMsgPrinted) {
-                Serial.println("数据采样任务已暂停 (g_dataTaskRunning = false)");
+                Serial.println("数据采样任务降低到每2秒一次 (输出为OFF)");
                 pausedMsgPrinted = true;
             }
         } else {
@@ -333,29 +566,6 @@ void dataSamplingTask(void* parameter) {
     }
 }
 
-// DAC更新任务 - 监控全局电压变量并更新DAC输出
-void dacUpdateTask(void* parameter) {
-    Serial.println("DAC更新任务已启动，监控全局DAC电压变量");
-    
-    while (1) {
-        // 如果系统状态为ON（运行状态），则更新DAC输出电压
-        if (g_dataTaskRunning) {
-            // 将全局电压变量发送到DAC
-            setDACVoltage(g_dacOutputVoltage);
-            
-            // 可以在调试时打印电压信息
-            #ifdef DAC_DEBUG
-            Serial.print("\nDAC输出电压: ");
-            Serial.print(g_dacOutputVoltage);
-            Serial.println("V");
-            #endif
-        }
-        
-        // 延时100ms，避免过于频繁的更新
-        vTaskDelay(100 / portTICK_PERIOD_MS);
-    }
-}
-
 // 编码器任务函数 - 改为事件驱动
 void encoderTask(void* parameter) {
     Serial.println("编码器任务已启动，事件驱动模式");
@@ -375,12 +585,18 @@ void encoderTask(void* parameter) {
         
         // 处理编码器事件
         if (bits & ENCODER_UPDATE_EVENT) {
+            // 从中断记录的最后一格到这里的延迟，CPU在低频率或刚从轻睡眠醒来时也不能超出预算
+            power.recordInputLatency((uint32_t)micros() - encoder.getLastStepUs());
             Serial.println("[编码器任务] 收到编码器更新事件");
+            int64_t t0 = esp_timer_get_time();
             encoder.updateUSetFromEncoder();
+            perf.record(PERF_STAGE_ENCODER, t0);
         }
         
         // 定期检查超时，确保即使没有编码器操作，超时检查也能执行
         encoder.checkConfirmTimeout();
+        // 按编码器引脚的新电平重新登记轻睡眠唤醒
+        power.rearmWake();
     }
 }
 
@@ -394,7 +610,9 @@ void updateDisplay() {
     }
     
     // 直接调用ADC的updateUI方法来更新所有UI
+    int64_t t0 = esp_timer_get_time();
     adc->updateUI();
+    perf.record(PERF_STAGE_UI, t0);
     
     // 注意: ADC的updateUI方法已经处理了所有UI标签的更新，
     // 包括 U_IN, I_IN, Uout, Iout 和 Pout，
@@ -403,21 +621,174 @@ void updateDisplay() {
 
 // 这段代码已被移动到myEncoderUI.cpp中，作为updateUSetDisplay函数实现
 
+// 创建预合成背景层 - 只合成内容和颜色在运行时都不会改变的对象
+// （V_label_set 的颜色会随编码器状态变化，不能合成进背景）
+void initBackdrop() {
+    static lv_obj_t* staticObjs[] = {
+        guider_ui.screen_img_1,
+        guider_ui.screen_U_SET_label,
+        guider_ui.screen_PERCENT_label,
+        guider_ui.screen_Efficiency_label,
+        guider_ui.screen_W_label,
+        guider_ui.screen_A_label,
+        guider_ui.screen_V_label,
+        guider_ui.screen_V_label_IN,
+        guider_ui.screen_U_IN_label,
+        guider_ui.screen_I_IN_label,
+        guider_ui.screen_A_label_IN,
+        guider_ui.screen_Pin_W_label,
+        guider_ui.screen_P_IN_label,
+    };
+    backdrop.begin(guider_ui.screen, staticObjs, sizeof(staticObjs) / sizeof(staticObjs[0]));
+}
+
+// 创建大字号读数控件 - 颜色、字体和字间距与 setup_scr_screen 中的标签一致
+void initReadouts() {
+    uOutReadout = new MyReadout(&lv_font_Alatsi_Regular_55, lv_color_hex(0xcfc300), lv_color_hex(READOUT_BG_COLOR), 5);
+    iOutReadout = new MyReadout(&lv_font_Alatsi_Regular_55, lv_color_hex(0x00a629), lv_color_hex(READOUT_BG_COLOR), 5);
+    pOutReadout = new MyReadout(&lv_font_Alatsi_Regular_55, lv_color_hex(0x3aabff), lv_color_hex(READOUT_BG_COLOR), 5);
+    
+    // 某个控件创建失败（内存不足）时，对应数值继续用原标签显示
+    if (!uOutReadout->begin(guider_ui.screen_Uout)) { delete uOutReadout; uOutReadout = NULL; }
+    if (!iOutReadout->begin(guider_ui.screen_Iout)) { delete iOutReadout; iOutReadout = NULL; }
+    if (!pOutReadout->begin(guider_ui.screen_Pout)) { delete pOutReadout; pOutReadout = NULL; }
+    
+    if (adc != NULL) {
+        adc->setReadouts(uOutReadout, iOutReadout, pOutReadout);
+    }
+}
+
+// 创建CV/CC模式指示标签 - 放在输出电压单位上方，字体与I_SET标签一致
+void initModeIndicator() {
+    modeIndicator = lv_label_create(guider_ui.screen);
+    lv_obj_set_pos(modeIndicator, 214, 12);
+    lv_obj_set_size(modeIndicator, 30, 15);
+    lv_obj_set_style_text_font(modeIndicator, &lv_font_Alatsi_Regular_12, LV_PART_MAIN|LV_STATE_DEFAULT);
+    updateModeIndicator();
+}
+
+// 刷新CV/CC模式指示：恒压绿色，恒流红色
+void updateModeIndicator() {
+    if (modeIndicator == NULL) {
+        return;
+    }
+    static int lastMode = -1;
+    SystemState state;
+    systemState.snapshot(state);
+    // 恒流时折返后的DAC输出每个采样周期都可能变化，模式不变时不重设标签
+    if ((int)state.mode == lastMode) {
+        return;
+    }
+    lastMode = state.mode;
+    bool cc = state.mode == SYS_MODE_CC;
+    lv_label_set_text(modeIndicator, cc ? "CC" : "CV");
+    lv_obj_set_style_text_color(modeIndicator, lv_color_hex(cc ? 0xff0027 : 0x0dff00), LV_PART_MAIN|LV_STATE_DEFAULT);
+    Serial.printf("工作模式: %s，DAC输出 %.2fV\n", cc ? "恒流" : "恒压", state.dacCommand);
+}
+
+// 创建保护告警标签 - 放在待机提示和CV/CC指示之间，平时隐藏
+void initAlarmIndicator() {
+    alarmIndicator = lv_label_create(guider_ui.screen);
+    lv_obj_set_pos(alarmIndicator, 108, 12);
+    lv_obj_set_size(alarmIndicator, 104, 15);
+    lv_obj_set_style_text_font(alarmIndicator, &lv_font_Alatsi_Regular_12, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(alarmIndicator, lv_color_hex(0xff0027), LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_set_style_text_align(alarmIndicator, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_flag(alarmIndicator, LV_OBJ_FLAG_HIDDEN);
+}
+
+// 刷新保护告警标签，触发时输出一次保护报告（保护模块在限流回路中不打印）
+void updateAlarmIndicator() {
+    if (alarmIndicator == NULL) {
+        return;
+    }
+    SystemState state;
+    systemState.snapshot(state);
+    uint32_t alarms = state.alarms & PROT_ALARM_MASK;
+    if (alarms == 0) {
+        lv_obj_add_flag(alarmIndicator, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%s - PRESS OK", MyProtection::alarmName(alarms));
+    lv_label_set_text(alarmIndicator, buf);
+    lv_obj_clear_flag(alarmIndicator, LV_OBJ_FLAG_HIDDEN);
+    protection.printReport();
+}
+
+// 创建预设选择标签 - 与告警标签位置相同，告警时不显示，平时隐藏
+void initPresetIndicator() {
+    presetIndicator = lv_label_create(guider_ui.screen);
+    lv_obj_set_pos(presetIndicator, 108, 12);
+    lv_obj_set_size(presetIndicator, 104, 15);
+    lv_obj_set_style_text_font(presetIndicator, &lv_font_Alatsi_Regular_12, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(presetIndicator, lv_color_hex(0x00ffff), LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_set_style_text_align(presetIndicator, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_add_flag(presetIndicator, LV_OBJ_FLAG_HIDDEN);
+}
+
+// 刷新预设选择标签：选中的编号和它的设定值，空位显示EMPTY
+void updatePresetIndicator() {
+    if (presetIndicator == NULL) {
+        return;
+    }
+    int slot = presets.selection();
+    SystemState state;
+    systemState.snapshot(state);
+    if (slot == 0 || (state.alarms & PROT_ALARM_MASK)) {
+        lv_obj_add_flag(presetIndicator, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+    SettingsPreset p;
+    char buf[32];
+    if (presets.get(slot, p)) {
+        snprintf(buf, sizeof(buf), "M%d %.2fV %.2fA", slot, p.uSet, p.iSet);
+    } else {
+        snprintf(buf, sizeof(buf), "M%d EMPTY", slot);
+    }
+    lv_label_set_text(presetIndicator, buf);
+    lv_obj_clear_flag(presetIndicator, LV_OBJ_FLAG_HIDDEN);
+}
+
+// 创建能量累计标签 - 与第二个待机标签位置、字体相同（两者不会同时显示）
+void initEnergyDisplay() {
+    energyLabel = lv_label_create(guider_ui.screen);
+    lv_obj_set_pos(energyLabel, 140, 210);
+    lv_obj_set_size(energyLabel, 112, 12);
+    lv_obj_set_style_text_font(energyLabel, &lv_font_montserratMedium_9, LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(energyLabel, lv_color_hex(0xb0b0b0), LV_PART_MAIN|LV_STATE_DEFAULT);
+    lv_obj_set_style_text_align(energyLabel, LV_TEXT_ALIGN_RIGHT, LV_PART_MAIN|LV_STATE_DEFAULT);
+    updateEnergyDisplay();
+}
+
+// 刷新能量累计标签：输出Wh、Ah和运行时间（时:分:秒）
+void updateEnergyDisplay() {
+    if (energyLabel == NULL) {
+        return;
+    }
+    EnergyReading r;
+    energy.read(r);
+    uint32_t runtime = (uint32_t)r.runtimeS;
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.3fWh %.3fAh %u:%02u:%02u", r.outWh, r.outAh,
+             (unsigned)(runtime / 3600), (unsigned)(runtime / 60 % 60), (unsigned)(runtime % 60));
+    lv_label_set_text(energyLabel, buf);
+}
+
 // 按钮状态回调函数 - 处理ON/OFF状态切换
 void updateButtonState(bool is_on) {
     Serial.print("按钮状态变更回调: 状态设置为 ");
     Serial.println(is_on ? "ON" : "OFF");
     
-    // 直接设置g_dataTaskRunning标志，确保与按钮状态同步
-    if (taskControlMutex != NULL) {
-        if (xSemaphoreTake(taskControlMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-            g_dataTaskRunning = is_on;
-            Serial.print("updateButtonState中更新g_dataTaskRunning为：");
-            Serial.println(is_on ? "true" : "false");
-            xSemaphoreGive(taskControlMutex);
-        }
+    // 打开输出算作操作，熄屏时先点亮屏幕，下面的刷新才会生效；
+    // 关闭输出时背光已由待机变暗，这里不再恢复亮度
+    if (is_on) {
+        backlight.activity();
     }
     
+    // 发布输出开关，确保与按钮状态同步（值未变化时不会重复通知）
+    systemState.setOutputEnabled(is_on);
+    
     // 使用互斥量保护数据访问
     if (xSemaphoreTake(dataMutex, portMAX_DELAY) == pdTRUE) {
         if (is_on) {
@@ -425,12 +796,12 @@ void updateButtonState(bool is_on) {
             lv_label_set_text(guider_ui.screen_STATE, "ON");
             lv_obj_set_style_text_color(guider_ui.screen_STATE, lv_color_hex(0x0dff00), LV_PART_MAIN|LV_STATE_DEFAULT);
             
-            // 隐藏待机提示标签
+            // 隐藏待机提示标签，在第二个待机标签的位置显示能量累计
             lv_obj_add_flag(guider_ui.screen_standby_label1, LV_OBJ_FLAG_HIDDEN);
             lv_obj_add_flag(guider_ui.screen_standby_label2, LV_OBJ_FLAG_HIDDEN);
-            
-            // 提前执行一次LVGL刷新，确保待机标签隐藏变更立即生效
-            handle_lvgl_tasks();
+            if (energyLabel != NULL) {
+                lv_obj_clear_flag(energyLabel, LV_OBJ_FLAG_HIDDEN);
+            }
             
             // 恢复显示
             updateDisplay();
@@ -442,19 +813,237 @@ void updateButtonState(bool is_on) {
             // 显示待机提示标签
             lv_obj_clear_flag(guider_ui.screen_standby_label1, LV_OBJ_FLAG_HIDDEN);
             lv_obj_clear_flag(guider_ui.screen_standby_label2, LV_OBJ_FLAG_HIDDEN);
+            if (energyLabel != NULL) {
+                lv_obj_add_flag(energyLabel, LV_OBJ_FLAG_HIDDEN);
+            }
         }
         xSemaphoreGive(dataMutex);
-    }        // 检查g_dataTaskRunning的状态
-        Serial.print("按钮状态回调函数中，g_dataTaskRunning = ");
-        Serial.println(g_dataTaskRunning ? "true" : "false");
-        
-        // 执行一次强制刷新，确保立即显示更改
-        handle_lvgl_tasks();
+    }        // 检查输出开关的状态
+        Serial.print("按钮状态回调函数中，输出状态 = ");
+        Serial.println(systemState.isOutputEnabled() ? "ON" : "OFF");
         
-        // 等待适当时间确保状态切换完全生效
-        vTaskDelay(is_on ? 80 : 50 / portTICK_PERIOD_MS);
-    
-    // 再次调用LVGL刷新，确保所有UI变更都已应用
-    handle_lvgl_tasks();
+        // 这里只改标签，由UI任务按 UI_UPDATE_EVENT 刷新；lv_timer_handler 只在UI任务中调用，
+        // 在按钮所在的loop()中调用会与UI任务同时渲染
+        xEventGroupSetBits(systemEvents, UI_UPDATE_EVENT);
+}
+
+
+// 启动系统监视任务 - 任务表中的任务创建时已自动登记栈大小，这里只需补充Arduino的loopTask
+void initSysMonitor() {
+#ifdef CONFIG_ARDUINO_LOOP_STACK_SIZE
+    sysMonitor.setStackSize("loopTask", CONFIG_ARDUINO_LOOP_STACK_SIZE);
+#endif
+    sysMonitor.begin();
+}
+
+// 编码器旋转拦截（编码器任务中调用）- 主屏幕以外的屏幕显示时按旋转方向前后切换屏幕，
+// 不调整看不见的设定值；切回主屏幕后旋转照旧调整U_SET/I_SET
+bool screenRotation(int16_t delta, void* ctx) {
+    // 熄屏时的旋转只用于点亮屏幕
+    if (backlight.activity()) {
+        return true;
+    }
+    if (screens.isHomeActive()) {
+        return false;
+    }
+    screens.requestStep(delta > 0 ? 1 : -1);
+    return true;
 }
 
+// 按住步进按钮时的旋转（在编码器任务中调用）：主屏幕和预设屏幕上用于选择预设，松开按钮时由UI任务调用
+bool presetRotation(int16_t delta, void* ctx) {
+    // 熄屏时的旋转只用于点亮屏幕
+    if (backlight.activity()) {
+        return true;
+    }
+    if (!presetScreenActive()) {
+        return false;
+    }
+    presets.select(delta);
+    xEventGroupSetBits(systemEvents, PRESET_SELECT_EVENT);
+    return true;
+}
+
+bool presetScreenActive() {
+    return screens.isHomeActive() || screens.isActive("presets");
+}
+
+// 调用预设：编码器在持有自己的互斥量时更新设定值并一次发布设定值、限流值和保护阈值
+uint32_t applyPreset(float uSet, float iSet, const ProtectionLimits &limits, void* ctx) {
+    return encoder.applyPreset(uSet, iSet, limits);
+}
+
+// 波形导出直接写串口
+static size_t writeSerial(const uint8_t *data, size_t len, void *ctx) {
+    return Serial.write(data, len);
+}
+
+// 串口调试命令
+//   p - 显示/隐藏性能叠加标签
+//   r - 打开/关闭周期性性能汇总
+//   s - 立即输出一次性能汇总
+//   m - 输出任务栈使用情况、建议栈大小和堆内存情况
+//   t - 打开/关闭栈水位和堆内存趋势日志
+//   k - 输出任务表（优先级类别、核心、栈大小）
+//   a - 输出保护阈值、告警状态和触发延迟
+//   e - 输出本会话的能量、电荷和运行时间
+//   z - 清零能量累计，开始新的会话
+//   w - 输出各通道滑动窗口（默认1秒、10秒、1分钟）的最小、最大、平均、RMS和标准差
+//   c - 开始一次波形捕获：I_OUT上升到当前电流+0.1A时触发，1秒未触发则强制触发
+//   x - 以二进制格式（见 myCapture.h）导出最近一次完成的捕获
+//   o - 在主屏幕和示波器屏幕之间切换
+//   g - 输出最近一次捕获的状态和各通道的最小、最大、平均值
+//   f - 采集一段U_OUT做FFT，输出开关频率各次谐波的纹波、频带噪声和最大分量
+//   l - 开始/停止负载瞬态监测：I_OUT阶跃超过0.3A时捕获，输出每次的偏离和恢复时间
+//   h - 输出负载瞬态的恢复时间、最大偏离分布和最近一次事件
+//   v - 进入趋势屏幕；已在趋势屏幕时切换时间范围（5分钟 -> 1小时 -> 24小时，同步进按钮）
+//   n - 输出各屏幕的状态、创建耗时和内存
+//   j - 进入触摸校准屏幕（已在校准屏幕时从第一个点重新开始），结果保存在NVS中
+//   u - 输出触摸屏的校准参数、中断和读数统计、总线占用时间
+//   b - 输出背光状态、各状态累计时间、估算的背光电流和熄屏节省的CPU时间
+//   d - 切换背光亮度（100% -> 75% -> 50% -> 25%）
+//   i - 输出电源管理方式、各使用者的持有时间、平均CPU频率、编码器延迟和定时唤醒延迟
+//   y - 输出待机状态、累计待机时间、进入待机和恢复输出的用时
+//   q - 输出保存的设置、修改和flash写入次数、写入用时、掉电写入和估算的flash寿命
+//   1..9 - 调用预设M1..M9（同按住步进按钮旋转选择后松开；按住选择时按确认键保存当前设定值）
+//   M - 输出各预设的设定值和保护阈值、调用次数和从调用到写入DAC的时间
+void handleSerialCommands() {
+    while (Serial.available() > 0) {
+        char cmd = (char)Serial.read();
+        switch (cmd) {
+            case 'p':
+                // 叠加标签属于LVGL对象，交给UI任务切换
+                perf.requestOverlayToggle();
+                break;
+            case 'r':
+                perf.setSerialReport(!perf.isSerialReportEnabled());
+                Serial.printf("周期性性能汇总: %s\n", perf.isSerialReportEnabled() ? "开" : "关");
+                break;
+            case 's':
+                perf.printSummary();
+                break;
+            case 'm':
+                sysMonitor.printStackReport();
+                sysMonitor.printHeapReport();
+                break;
+            case 't':
+                sysMonitor.setTrendLog(!sysMonitor.isTrendLogEnabled());
+                Serial.printf("内存趋势日志: %s\n", sysMonitor.isTrendLogEnabled() ? "开" : "关");
+                break;
+            case 'k':
+                taskTablePrint();
+                break;
+            case 'a':
+                protection.printReport();
+                break;
+            case 'e':
+                energy.printReport();
+                break;
+            case 'z':
+                energy.reset();
+                Serial.println("能量累计已清零");
+                break;
+            case 'w':
+                stats.printReport();
+                break;
+            case 'c': {
+                SystemState state;
+                systemState.snapshot(state);
+                CaptureConfig cfg = captureDefaultConfig();
+                cfg.level = state.iOut + 0.1f;
+                cfg.autoMs = 1000;
+                if (capture.arm(cfg)) {
+                    Serial.printf("波形捕获已开始，I_OUT上升到 %.3fA 时触发\n", cfg.level);
+                } else {
+                    Serial.println("波形捕获无法开始");
+                }
+                break;
+            }
+            case 'x': {
+                size_t n = capture.exportBinary(writeSerial, NULL);
+                Serial.printf("\n波形导出 %u字节\n", (unsigned)n);
+                break;
+            }
+            case 'o':
+                // 屏幕切换属于LVGL操作，交给UI任务
+                if (screens.isActive("scope")) {
+                    screens.requestHome();
+                } else {
+                    screens.request("scope");
+                }
+                break;
+            case 'g':
+                capture.printReport();
+                break;
+            case 'f':
+                if (!spectrum.request(spectrumDefaultConfig())) {
+                    Serial.println("频谱分析无法开始");
+                }
+                break;
+            case 'l':
+                if (transient.isRunning()) {
+                    transient.stop();
+                    Serial.println("负载瞬态监测: 关");
+                } else if (transient.start()) {
+                    Serial.println("负载瞬态监测: 开");
+                } else {
+                    Serial.println("负载瞬态监测无法开始");
+                }
+                break;
+            case 'h':
+                transient.printReport();
+                break;
+            case 'v':
+                // 屏幕切换属于LVGL操作，交给UI任务
+                if (screens.isActive("trend")) {
+                    screens.requestKey(SCREEN_KEY_STEP);
+                } else {
+                    screens.request("trend");
+                }
+                break;
+            case 'n':
+                screens.printReport();
+                break;
+            case 'j':
+                // 屏幕切换属于LVGL操作，交给UI任务
+                if (screens.isActive("touchcal")) {
+                    screens.requestKey(SCREEN_KEY_STEP);
+                } else {
+                    screens.request("touchcal");
+                }
+                break;
+            case 'u':
+                touch.printReport();
+                break;
+            case 'b':
+                backlight.printReport();
+                break;
+            case 'd': {
+                uint8_t percent = backlight.brightness() > 25 ? backlight.brightness() - 25 : 100;
+                backlight.setBrightness(percent);
+                backlight.activity();
+                Serial.printf("背光亮度: %u%%\n", percent);
+                break;
+            }
+            case 'i':
+                power.printReport();
+                break;
+            case 'y':
+                standby.printReport();
+                break;
+            case 'q':
+                settings.printReport();
+                break;
+            case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
+                // 预设调用会刷新设定值显示（LVGL操作），交给UI任务
+                presets.selectSlot(cmd - '0');
+                xEventGroupSetBits(systemEvents, HOLD_ROTATE_EVENT);
+                break;
+            case 'M':
+                presets.printReport();
+                break;
+            default:
+                break;
+        }
+    }
+}
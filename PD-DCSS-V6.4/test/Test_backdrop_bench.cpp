@@ -0,0 +1,85 @@
+/**
+ * 预合成背景层渲染耗时对比
+ * 分别测量启用背景层前后：整屏重绘、以及小标签（U_IN）和大字号标签（Uout）
+ * 数值变化时的重绘耗时。背景层启用后，脏区域的背景恢复由alpha混合变为memcpy。
+ */
+
+#include <Arduino.h>
+#include "myTFT.h"
+#include "myBackdrop.h"
+#include "esp_timer.h"
+
+#define BENCH_STEPS 100
+
+MyBackdrop backdrop;
+
+static int64_t benchFullScreen() {
+    int64_t total = 0;
+    for (int i = 0; i < BENCH_STEPS; i++) {
+        int64_t t0 = esp_timer_get_time();
+        lv_obj_invalidate(guider_ui.screen);
+        lv_refr_now(NULL);
+        total += esp_timer_get_time() - t0;
+    }
+    return total / BENCH_STEPS;
+}
+
+static int64_t benchLabel(lv_obj_t *label) {
+    char buf[16];
+    int64_t total = 0;
+    for (int i = 0; i < BENCH_STEPS; i++) {
+        snprintf(buf, sizeof(buf), "%.2f", 10.0f + 0.37f * (i % 17));
+        int64_t t0 = esp_timer_get_time();
+        lv_label_set_text(label, buf);
+        lv_refr_now(NULL);
+        total += esp_timer_get_time() - t0;
+    }
+    return total / BENCH_STEPS;
+}
+
+static void runBench(const char *name) {
+    int64_t full = benchFullScreen();
+    int64_t small = benchLabel(guider_ui.screen_U_IN);
+    int64_t large = benchLabel(guider_ui.screen_Uout);
+    Serial.printf("[%s] 整屏: %lld us, U_IN: %lld us, Uout: %lld us\n", name, full, small, large);
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    delay(1000);
+
+    tft_init();
+    lvgl_setup();
+    init_gui(&guider_ui);
+    lv_refr_now(NULL);
+
+    Serial.println("\n预合成背景层渲染耗时对比");
+    runBench("原始");
+
+    static lv_obj_t *staticObjs[] = {
+        guider_ui.screen_img_1,
+        guider_ui.screen_U_SET_label,
+        guider_ui.screen_PERCENT_label,
+        guider_ui.screen_Efficiency_label,
+        guider_ui.screen_W_label,
+        guider_ui.screen_A_label,
+        guider_ui.screen_V_label,
+        guider_ui.screen_V_label_IN,
+        guider_ui.screen_U_IN_label,
+        guider_ui.screen_I_IN_label,
+        guider_ui.screen_A_label_IN,
+        guider_ui.screen_Pin_W_label,
+        guider_ui.screen_P_IN_label,
+    };
+    if (!backdrop.begin(guider_ui.screen, staticObjs, sizeof(staticObjs) / sizeof(staticObjs[0]))) {
+        Serial.println("背景层创建失败");
+        return;
+    }
+    runBench("背景层");
+}
+
+void loop()
+{
+    handle_lvgl_tasks();
+}
@@ -0,0 +1,89 @@
+/**
+ * 大字号读数重绘性能对比
+ * 对比原始LVGL标签和MyReadout精灵图控件在每次数值变化时的重绘耗时。
+ * 两种方式使用相同的数值序列（模拟输出电压缓慢变化），每次设置后调用
+ * lv_refr_now() 立即完成渲染和刷屏，用 esp_timer_get_time() 计时。
+ */
+
+#include <Arduino.h>
+#include "myTFT.h"
+#include "myReadout.h"
+#include "esp_timer.h"
+
+#define BENCH_STEPS 200
+
+// 生成第i步的显示文本：在5V附近小幅波动，模拟真实测量值
+static void benchValue(int i, char *buf, size_t len) {
+    float v = 5.0f + 0.01f * (float)((i * 37) % 23) - 0.11f;
+    snprintf(buf, len, "%.2f", v);
+}
+
+static void runLabelBench(lv_obj_t *label) {
+    char buf[16];
+    int64_t total = 0;
+    int64_t worst = 0;
+
+    for (int i = 0; i < BENCH_STEPS; i++) {
+        benchValue(i, buf, sizeof(buf));
+        int64_t t0 = esp_timer_get_time();
+        lv_label_set_text(label, buf);
+        lv_refr_now(NULL);
+        int64_t dt = esp_timer_get_time() - t0;
+        total += dt;
+        if (dt > worst) worst = dt;
+    }
+
+    Serial.printf("[标签]   平均 %lld us/次, 最大 %lld us\n", total / BENCH_STEPS, worst);
+}
+
+static void runReadoutBench(MyReadout *readout) {
+    char buf[16];
+    int64_t total = 0;
+    int64_t worst = 0;
+    uint32_t dirty = 0;
+
+    for (int i = 0; i < BENCH_STEPS; i++) {
+        benchValue(i, buf, sizeof(buf));
+        int64_t t0 = esp_timer_get_time();
+        readout->setText(buf);
+        lv_refr_now(NULL);
+        int64_t dt = esp_timer_get_time() - t0;
+        total += dt;
+        dirty += readout->getLastDirtyPixels();
+        if (dt > worst) worst = dt;
+    }
+
+    Serial.printf("[读数控件] 平均 %lld us/次, 最大 %lld us, 平均脏像素 %u\n",
+                  total / BENCH_STEPS, worst, (unsigned)(dirty / BENCH_STEPS));
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    delay(1000);
+
+    tft_init();
+    lvgl_setup();
+    init_gui(&guider_ui);
+    lv_refr_now(NULL);
+
+    Serial.println("\n大字号读数重绘性能对比");
+
+    // 先测原始标签
+    runLabelBench(guider_ui.screen_Uout);
+
+    // 再用读数控件替换同一个标签
+    MyReadout *readout = new MyReadout(&lv_font_Alatsi_Regular_55, lv_color_hex(0xcfc300), lv_color_hex(0x000822), 5);
+    if (!readout->begin(guider_ui.screen_Uout)) {
+        Serial.println("读数控件创建失败");
+        return;
+    }
+    lv_refr_now(NULL);
+    Serial.printf("精灵图缓存: %u 字节\n", (unsigned)readout->getCacheBytes());
+    runReadoutBench(readout);
+}
+
+void loop()
+{
+    handle_lvgl_tasks();
+}
@@ -0,0 +1,114 @@
+/**
+ * 共享常量样式的内存和渲染耗时对比
+ * setup_scr_screen.c 经 tools/compact_styles.py 处理后，每个控件只引用一个共享的常量样式。
+ * 先测量这种情况下主屏幕占用的LVGL内存和重绘耗时；然后把每个控件的共享样式展开成局部样式，
+ * 并补上脚本去掉的默认值属性（与 GUI Guider 原来的输出相同），再测量一次。
+ */
+
+#include <Arduino.h>
+#include "myTFT.h"
+#include "esp_timer.h"
+
+#define BENCH_STEPS 100
+
+// 脚本去掉的默认值属性（与 tools/compact_styles.py 中的 DEFAULTS 相同），只用于标签
+static const lv_style_prop_t LABEL_DEFAULT_PROPS[] = {
+    LV_STYLE_BORDER_WIDTH, LV_STYLE_RADIUS, LV_STYLE_PAD_TOP, LV_STYLE_PAD_RIGHT, LV_STYLE_PAD_BOTTOM,
+    LV_STYLE_PAD_LEFT, LV_STYLE_SHADOW_WIDTH, LV_STYLE_BG_OPA, LV_STYLE_TEXT_OPA,
+    LV_STYLE_TEXT_LETTER_SPACE, LV_STYLE_TEXT_LINE_SPACE,
+};
+
+static uint32_t lvglUsed() {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+}
+
+static int64_t benchFullScreen() {
+    int64_t total = 0;
+    for (int i = 0; i < BENCH_STEPS; i++) {
+        int64_t t0 = esp_timer_get_time();
+        lv_obj_invalidate(guider_ui.screen);
+        lv_refr_now(NULL);
+        total += esp_timer_get_time() - t0;
+    }
+    return total / BENCH_STEPS;
+}
+
+static int64_t benchLabel(lv_obj_t *label) {
+    char buf[16];
+    int64_t total = 0;
+    for (int i = 0; i < BENCH_STEPS; i++) {
+        snprintf(buf, sizeof(buf), "%.2f", 10.0f + 0.37f * (i % 17));
+        int64_t t0 = esp_timer_get_time();
+        lv_label_set_text(label, buf);
+        lv_refr_now(NULL);
+        total += esp_timer_get_time() - t0;
+    }
+    return total / BENCH_STEPS;
+}
+
+static void runBench(const char *name, uint32_t bytes) {
+    int64_t full = benchFullScreen();
+    int64_t small = benchLabel(guider_ui.screen_U_IN);
+    int64_t large = benchLabel(guider_ui.screen_Uout);
+    Serial.printf("[%s] 主屏幕LVGL内存: %lu字节, 整屏: %lld us, U_IN: %lld us, Uout: %lld us\n",
+                  name, (unsigned long)bytes, full, small, large);
+}
+
+// 把控件的共享常量样式展开成局部样式，标签再补上默认值属性
+static void expandToLocal(lv_obj_t *obj) {
+    for (int32_t i = (int32_t)obj->style_cnt - 1; i >= 0; i--) {
+        lv_style_t *style = (lv_style_t *)obj->styles[i].style;
+        lv_style_selector_t selector = obj->styles[i].selector;
+        if (obj->styles[i].is_local || style->prop1 != LV_STYLE_PROP_ANY) {
+            continue;
+        }
+        for (uint32_t k = 0; k < style->prop_cnt; k++) {
+            const lv_style_const_prop_t *p = &style->v_p.const_props[k];
+            if (p->prop != LV_STYLE_PROP_INV) {
+                lv_obj_set_local_style_prop(obj, p->prop, p->value, selector);
+            }
+        }
+        lv_obj_remove_style(obj, style, selector);
+    }
+    if (lv_obj_check_type(obj, &lv_label_class)) {
+        for (size_t k = 0; k < sizeof(LABEL_DEFAULT_PROPS) / sizeof(LABEL_DEFAULT_PROPS[0]); k++) {
+            lv_style_value_t v;
+            if (lv_obj_get_local_style_prop(obj, LABEL_DEFAULT_PROPS[k], &v, LV_PART_MAIN) != LV_RES_OK) {
+                lv_obj_set_local_style_prop(obj, LABEL_DEFAULT_PROPS[k], lv_style_prop_get_default(LABEL_DEFAULT_PROPS[k]),
+                                            LV_PART_MAIN);
+            }
+        }
+    }
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    delay(1000);
+
+    tft_init();
+    lvgl_setup();
+    uint32_t before = lvglUsed();
+    int64_t t0 = esp_timer_get_time();
+    init_gui(&guider_ui);
+    int64_t buildUs = esp_timer_get_time() - t0;
+    lv_refr_now(NULL);
+
+    Serial.println("\n共享常量样式的内存和渲染耗时对比");
+    Serial.printf("init_gui: %lld us\n", buildUs);
+    runBench("共享样式", lvglUsed() - before);
+
+    expandToLocal(guider_ui.screen);
+    uint32_t childCount = lv_obj_get_child_cnt(guider_ui.screen);
+    for (uint32_t i = 0; i < childCount; i++) {
+        expandToLocal(lv_obj_get_child(guider_ui.screen, i));
+    }
+    runBench("局部样式", lvglUsed() - before);
+}
+
+void loop()
+{
+    handle_lvgl_tasks();
+}
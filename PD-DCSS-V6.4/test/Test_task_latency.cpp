@@ -0,0 +1,175 @@
+/**
+ * 任务表时限测试
+ * 按main.cpp的任务表布局创建两个探测任务，在满负荷UI刷新下测量：
+ * - 编码器路径：esp_timer模拟编码器中断，经事件组唤醒实时类任务，
+ *   测量从事件发出到任务运行的延迟；
+ * - 控制路径：控制类任务以10ms周期 vTaskDelayUntil 运行，测量唤醒抖动。
+ * 负载为核心0上每轮整屏重绘的UI任务，以及核心1上的日志类忙循环任务
+ * （模拟统计、串口输出等低优先级工作抢占控制核心）。
+ * 运行 TEST_DURATION_MS 后打印p99和最大值，超过时限判为失败。
+ */
+
+#include <Arduino.h>
+#include "myTFT.h"
+#include "myTaskTable.h"
+#include "esp_timer.h"
+#include "freertos/event_groups.h"
+
+#define TEST_DURATION_MS 20000
+#define ENCODER_DEADLINE_US 2000     // 编码器事件最迟2ms内得到处理
+#define CONTROL_JITTER_US 1000       // 控制回路唤醒抖动不超过1ms
+#define CONTROL_PERIOD_MS 10
+#define MAX_SAMPLES 4096
+
+#define PROBE_EVENT (1 << 0)
+
+static void encoderProbeTask(void *parameter);
+static void controlProbeTask(void *parameter);
+static void uiLoadTask(void *parameter);
+static void logLoadTask(void *parameter);
+
+// 探测任务与main.cpp中对应任务的类别和核心一致；Load_Log故意放在控制核心上，安装时会打印警告
+static const TaskSpec TEST_TASK_TABLE[] = {
+    {"Probe_Encoder", encoderProbeTask, 4096, TASK_CLASS_REALTIME, TASK_CORE_CONTROL, TASK_STACK_INTERNAL, NULL},
+    {"Probe_Control", controlProbeTask, 4096, TASK_CLASS_CONTROL,  TASK_CORE_CONTROL, TASK_STACK_INTERNAL, NULL},
+    {"Load_UI",       uiLoadTask,       4096, TASK_CLASS_UI,       TASK_CORE_SYSTEM,  TASK_STACK_INTERNAL, NULL},
+    {"Load_Log",      logLoadTask,      2048, TASK_CLASS_LOGGING,  TASK_CORE_CONTROL, TASK_STACK_INTERNAL, NULL},
+};
+
+struct LatencySamples {
+    uint32_t us[MAX_SAMPLES];
+    uint32_t count;
+    uint32_t maxUs;
+};
+
+static LatencySamples encoderLatency;
+static LatencySamples controlJitter;
+static EventGroupHandle_t probeEvents;
+static volatile int64_t eventFiredUs = 0;
+static volatile bool testDone = false;
+static esp_timer_handle_t encoderTimer;
+
+static void addSample(LatencySamples &s, uint32_t us) {
+    if (s.count < MAX_SAMPLES) {
+        s.us[s.count++] = us;
+    }
+    if (us > s.maxUs) {
+        s.maxUs = us;
+    }
+}
+
+static int compareU32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static bool report(const char *name, LatencySamples &s, uint32_t limitUs) {
+    if (s.count == 0) {
+        Serial.printf("[%s] 没有采到样本\n", name);
+        return false;
+    }
+    qsort(s.us, s.count, sizeof(uint32_t), compareU32);
+    uint32_t p50 = s.us[s.count / 2];
+    uint32_t p99 = s.us[(s.count * 99) / 100];
+    bool pass = s.maxUs <= limitUs;
+    Serial.printf("[%s] 样本 %u, p50 %u us, p99 %u us, 最大 %u us, 时限 %u us -> %s\n",
+                  name, (unsigned)s.count, (unsigned)p50, (unsigned)p99, (unsigned)s.maxUs,
+                  (unsigned)limitUs, pass ? "通过" : "失败");
+    return pass;
+}
+
+// 模拟编码器中断：记录时间戳并置位事件
+static void encoderTimerCallback(void *arg) {
+    eventFiredUs = esp_timer_get_time();
+    xEventGroupSetBits(probeEvents, PROBE_EVENT);
+}
+
+static void encoderProbeTask(void *parameter) {
+    while (!testDone) {
+        EventBits_t bits = xEventGroupWaitBits(probeEvents, PROBE_EVENT, pdTRUE, pdFALSE, pdMS_TO_TICKS(100));
+        if (bits & PROBE_EVENT) {
+            addSample(encoderLatency, (uint32_t)(esp_timer_get_time() - eventFiredUs));
+        }
+    }
+    vTaskDelete(NULL);
+}
+
+static void controlProbeTask(void *parameter) {
+    TickType_t lastWake = xTaskGetTickCount();
+    // 以第一次唤醒为基准，之后每次应恰好晚一个周期
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(CONTROL_PERIOD_MS));
+    int64_t expectedUs = esp_timer_get_time();
+    while (!testDone) {
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(CONTROL_PERIOD_MS));
+        expectedUs += CONTROL_PERIOD_MS * 1000;
+        int64_t diff = esp_timer_get_time() - expectedUs;
+        addSample(controlJitter, (uint32_t)(diff < 0 ? -diff : diff));
+    }
+    vTaskDelete(NULL);
+}
+
+// 满负荷UI：每轮整屏失效后立即渲染刷屏
+static void uiLoadTask(void *parameter) {
+    uint32_t frames = 0;
+    while (!testDone) {
+        lv_obj_invalidate(lv_scr_act());
+        lv_refr_now(NULL);
+        frames++;
+        vTaskDelay(1); // 让出CPU给空闲任务喂看门狗
+    }
+    Serial.printf("[负载] UI整屏刷新 %u 帧\n", (unsigned)frames);
+    vTaskDelete(NULL);
+}
+
+// 控制核心上的低优先级忙循环，每50ms让出一次
+static void logLoadTask(void *parameter) {
+    while (!testDone) {
+        int64_t start = esp_timer_get_time();
+        while (esp_timer_get_time() - start < 50000) {
+        }
+        vTaskDelay(1);
+    }
+    vTaskDelete(NULL);
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    delay(1000);
+    Serial.println("\n任务表时限测试");
+
+    tft_init();
+    lvgl_setup();
+    init_gui(&guider_ui);
+    lv_refr_now(NULL);
+
+    probeEvents = xEventGroupCreate();
+    taskTableInstall(TEST_TASK_TABLE, sizeof(TEST_TASK_TABLE) / sizeof(TEST_TASK_TABLE[0]));
+    taskTablePrint();
+
+    // 探测任务先于计时器启动，保证第一个事件就有人等待
+    taskTableStartAll();
+
+    // 间隔取质数，避免与10ms控制周期和tick对齐
+    esp_timer_create_args_t args = {};
+    args.callback = encoderTimerCallback;
+    args.name = "enc_sim";
+    esp_timer_create(&args, &encoderTimer);
+    esp_timer_start_periodic(encoderTimer, 7919);
+
+    delay(TEST_DURATION_MS);
+
+    esp_timer_stop(encoderTimer);
+    testDone = true;
+    delay(200);
+
+    bool ok = report("编码器延迟", encoderLatency, ENCODER_DEADLINE_US);
+    ok = report("控制抖动", controlJitter, CONTROL_JITTER_US) && ok;
+    Serial.println(ok ? "结果: 全部通过" : "结果: 未满足时限");
+}
+
+void loop()
+{
+    delay(1000);
+}
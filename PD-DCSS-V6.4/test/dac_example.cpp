@@ -62,8 +62,8 @@ void setup() {
   dac->begin();
   
   // 创建DAC控制任务(接收电压队列值并控制DAC)
-  // 使用核心1和优先级1
-  createDACTask(dac, 1, 1);
+  // 本例没有安装任务表，按默认参数创建
+  createDACTask(dac);
   
   // 创建DAC更新任务(周期性更新电压值)
   // 使用核心0和优先级1
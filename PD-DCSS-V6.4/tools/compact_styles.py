@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""
+compact_styles.py - 把 GUI Guider 生成的 setup_scr_*.c 中的局部样式改为共享的常量样式
+
+GUI Guider 为每个控件逐条调用 lv_obj_set_style_*()，一个标签十几条，其中大部分是
+与LVGL默认值相同的属性（边框0、圆角0、内边距0、阴影0、背景透明……）。每个控件因此
+在堆上分配一个局部样式和属性数组，绘制时每次查询属性都要遍历这个数组。
+
+本脚本在每次用 GUI Guider 重新生成代码后运行：
+- 去掉标签和图片上与LVGL默认值相同的属性（这两类控件的默认主题不加任何样式，
+  默认值就是实际生效的值；会继承的文字属性只在父对象没有设置时去掉；
+  屏幕等其他控件的属性全部保留）；
+- 属性完全相同的控件共用一个 LV_STYLE_CONST_INIT 常量样式（放在Flash中，不占堆），
+  样式以第一个使用它的控件命名，注释中列出所有使用者；
+- 每个 "Write style for" 块替换为一条 lv_obj_add_style()。
+运行时用 lv_obj_set_style_*() 修改颜色等属性照常有效（局部样式优先于共享样式）。
+
+用法：
+    python3 tools/compact_styles.py [lib/generated/setup_scr_screen.c ...]
+已处理过的文件会跳过。加 --dry-run 只输出统计，不写文件。
+"""
+
+import re
+import sys
+from collections import OrderedDict
+
+MARKER = "Shared const styles generated by tools/compact_styles.py"
+
+# 标签和图片上可以去掉的属性：LVGL 8.3 中这些属性的默认值
+DEFAULTS = {
+    "border_width": "0",
+    "border_opa": "255",
+    "border_side": "LV_BORDER_SIDE_FULL",
+    "radius": "0",
+    "pad_top": "0",
+    "pad_right": "0",
+    "pad_bottom": "0",
+    "pad_left": "0",
+    "shadow_width": "0",
+    "bg_opa": "0",
+    "bg_grad_dir": "LV_GRAD_DIR_NONE",
+    "text_opa": "255",
+    "text_letter_space": "0",
+    "text_line_space": "0",
+    "img_opa": "255",
+    "img_recolor_opa": "0",
+}
+DEFAULT_TYPES = ("label", "img")
+
+# 会从父对象继承的属性：父对象设置了同名属性时，去掉后会变成父对象的值
+INHERITED = ("text_opa", "text_letter_space", "text_line_space")
+
+CREATE_RE = re.compile(r"^\s*ui->(\w+) = lv_(\w+)_create\((?:ui->(\w+)|NULL)\)")
+HEADER_RE = re.compile(r"^(\s*)//Write style for (\w+), Part: (\w+), State: (\w+)\.\s*$")
+SET_RE = re.compile(r"^\s*lv_obj_set_style_(\w+)\(ui->(\w+), (.+), (LV_PART_\w+\|LV_STATE_\w+)\);\s*$")
+HEX_RE = re.compile(r"^lv_color_hex\(0x([0-9a-fA-F]{6})\)$")
+
+
+def const_value(value):
+    """lv_color_hex() 不能用在常量初始化中，换成 LV_COLOR_MAKE()"""
+    m = HEX_RE.match(value)
+    if m:
+        h = m.group(1)
+        return "LV_COLOR_MAKE(0x%s, 0x%s, 0x%s)" % (h[0:2], h[2:4], h[4:6])
+    return value
+
+
+def compact(text):
+    lines = text.split("\n")
+    types = {}
+    parents = {}
+    set_props = {}       # 控件 -> 生成代码中设置过的属性名
+    blocks = []          # (起始行, 结束行, 缩进, 控件, 选择器, 属性列表)
+    removed = 0
+    i = 0
+    while i < len(lines):
+        m = CREATE_RE.match(lines[i])
+        if m:
+            types[m.group(1)] = m.group(2)
+            parents[m.group(1)] = m.group(3)
+        s = SET_RE.match(lines[i])
+        if s:
+            set_props.setdefault(s.group(2), set()).add(s.group(1))
+        h = HEADER_RE.match(lines[i])
+        if not h:
+            i += 1
+            continue
+        indent, obj = h.group(1), h.group(2)
+        props = []
+        selector = None
+        j = i + 1
+        while j < len(lines):
+            s = SET_RE.match(lines[j])
+            if not s or s.group(2) != obj:
+                break
+            if selector is not None and s.group(4) != selector:
+                break
+            selector = s.group(4)
+            name, value = s.group(1), s.group(3)
+            set_props.setdefault(obj, set()).add(name)
+            inherited_from_parent = name in INHERITED and name in set_props.get(parents.get(obj), ())
+            if types.get(obj) in DEFAULT_TYPES and DEFAULTS.get(name) == value and not inherited_from_parent:
+                removed += 1
+            else:
+                props.append((name, value))
+            j += 1
+        if selector is not None:
+            blocks.append((i, j, indent, obj, selector, tuple(props)))
+        i = j
+
+    # 属性完全相同的块共用一个样式
+    styles = OrderedDict()     # 属性 -> [样式名, 使用者]
+    for _, _, _, obj, _, props in blocks:
+        if not props:
+            continue
+        if props not in styles:
+            styles[props] = ["style_" + obj, []]
+        styles[props][1].append(obj)
+
+    out = []
+    last = 0
+    for start, end, indent, obj, selector, props in blocks:
+        out.extend(lines[last:start + 1])
+        if props:
+            out.append("%slv_obj_add_style(ui->%s, (lv_style_t *)&%s, %s);"
+                       % (indent, obj, styles[props][0], selector))
+        last = end
+    out.extend(lines[last:])
+
+    defs = ["", "/* %s; do not edit by hand. */" % MARKER]
+    for props, (name, users) in styles.items():
+        defs.append("/* %s */" % ", ".join(users))
+        defs.append("static const lv_style_const_prop_t %s_props[] = {" % name)
+        for prop, value in props:
+            defs.append("    LV_STYLE_CONST_%s(%s)," % (prop.upper(), const_value(value)))
+        defs.append("    { .prop = LV_STYLE_PROP_INV, .value = { .num = 0 } },")
+        defs.append("};")
+        defs.append("static LV_STYLE_CONST_INIT(%s, %s_props);" % (name, name))
+    defs.append("")
+
+    # 样式定义放在最后一个 #include 之后
+    last_include = max(k for k, line in enumerate(out) if line.startswith("#include"))
+    out[last_include + 1:last_include + 1] = defs
+
+    set_calls = sum(end - start - 1 for start, end, _, _, _, _ in blocks)
+    stats = (set_calls, removed, len(blocks), len(styles))
+    return "\n".join(out), stats
+
+
+def main(argv):
+    dry_run = "--dry-run" in argv
+    paths = [a for a in argv if a != "--dry-run"] or ["lib/generated/setup_scr_screen.c"]
+    for path in paths:
+        with open(path, newline="") as f:
+            text = f.read()
+        if MARKER in text:
+            print("%s: 已处理过，跳过" % path)
+            continue
+        crlf = "\r\n" in text
+        result, (calls, removed, blocks, styles) = compact(text.replace("\r\n", "\n"))
+        print("%s: %d条 lv_obj_set_style_* -> %d条 lv_obj_add_style，去掉%d条默认值属性，共%d个共享样式"
+              % (path, calls, blocks, removed, styles))
+        if not dry_run:
+            with open(path, "w", newline="") as f:
+                f.write(result.replace("\n", "\r\n") if crlf else result)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))